@@ -0,0 +1,163 @@
+// Measures how many rows per second a stmt inserts when it binds whole columns of many subtables in each exec.
+// to compile: gcc -o stmt_bench stmt_bench.c -ltaos
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "taos.h"
+
+static int64_t getTimeUs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static void executeSql(TAOS *taos, const char *sql) {
+  TAOS_RES *result = taos_query(taos, sql);
+  int       code = taos_errno(result);
+  if (code != 0) {
+    printf("failed to execute %s, reason:%s\n", sql, taos_errstr(result));
+    taos_free_result(result);
+    exit(1);
+  }
+  taos_free_result(result);
+}
+
+static void checkStmt(TAOS_STMT *stmt, int code, const char *api) {
+  if (code != 0) {
+    printf("failed to %s, reason:%s\n", api, taos_stmt_errstr(stmt));
+    exit(1);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  const char *host = NULL;
+  int32_t     numOfTables = 100;
+  int32_t     numOfRows = 1000;
+  int32_t     numOfExecs = 100;
+  int32_t     nullEvery = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-h") == 0 && i < argc - 1) {
+      host = argv[++i];
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      numOfTables = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0 && i < argc - 1) {
+      numOfRows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfExecs = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-z") == 0 && i < argc - 1) {
+      nullEvery = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-h host]: server to connect, default is localhost\n");
+      printf("  [-t tables]: number of subtables bound in each exec, default is:%d\n", numOfTables);
+      printf("  [-r rows]: number of rows bound to each subtable in each exec, default is:%d\n", numOfRows);
+      printf("  [-n execs]: number of execs, default is:%d\n", numOfExecs);
+      printf("  [-z nulls]: bind a null every that many values of the columns, 0 for none, default is:%d\n",
+             nullEvery);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  TAOS *taos = taos_connect(host, "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to server, reason:%s\n", taos_errstr(NULL));
+    exit(1);
+  }
+
+  executeSql(taos, "drop database if exists stmt_bench");
+  executeSql(taos, "create database stmt_bench vgroups 4");
+  executeSql(taos, "use stmt_bench");
+  executeSql(taos, "create stable st (ts timestamp, c1 int, c2 bigint, c3 float, c4 double) tags (t1 int)");
+
+  char sql[128];
+  for (int32_t t = 0; t < numOfTables; ++t) {
+    snprintf(sql, sizeof(sql), "create table tb%d using st tags (%d)", t, t);
+    executeSql(taos, sql);
+  }
+
+  int64_t *ts = malloc(sizeof(int64_t) * numOfRows);
+  int32_t *c1 = malloc(sizeof(int32_t) * numOfRows);
+  int64_t *c2 = malloc(sizeof(int64_t) * numOfRows);
+  float   *c3 = malloc(sizeof(float) * numOfRows);
+  double  *c4 = malloc(sizeof(double) * numOfRows);
+  char    *isNull = calloc(numOfRows, sizeof(char));
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    c1[i] = i;
+    c2[i] = (int64_t)i * 1000;
+    c3[i] = i * 0.5f;
+    c4[i] = i * 0.25;
+    isNull[i] = (nullEvery > 0 && i % nullEvery == 0);
+  }
+
+  TAOS_MULTI_BIND params[5];
+  memset(params, 0, sizeof(params));
+  params[0].buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
+  params[0].buffer_length = sizeof(int64_t);
+  params[0].buffer = ts;
+  params[1].buffer_type = TSDB_DATA_TYPE_INT;
+  params[1].buffer_length = sizeof(int32_t);
+  params[1].buffer = c1;
+  params[2].buffer_type = TSDB_DATA_TYPE_BIGINT;
+  params[2].buffer_length = sizeof(int64_t);
+  params[2].buffer = c2;
+  params[3].buffer_type = TSDB_DATA_TYPE_FLOAT;
+  params[3].buffer_length = sizeof(float);
+  params[3].buffer = c3;
+  params[4].buffer_type = TSDB_DATA_TYPE_DOUBLE;
+  params[4].buffer_length = sizeof(double);
+  params[4].buffer = c4;
+  for (int32_t c = 0; c < 5; ++c) {
+    params[c].num = numOfRows;
+    params[c].is_null = c > 0 && nullEvery > 0 ? isNull : NULL;
+  }
+
+  TAOS_STMT  *stmt = taos_stmt_init(taos);
+  const char *insert = "insert into ? values(?,?,?,?,?)";
+  checkStmt(stmt, taos_stmt_prepare(stmt, insert, 0), "prepare");
+
+  int64_t bindUs = 0;
+  int64_t execUs = 0;
+  int64_t startTs = 1600000000000;
+  char    tbName[32];
+  for (int32_t e = 0; e < numOfExecs; ++e) {
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      ts[i] = startTs + (int64_t)e * numOfRows + i;
+    }
+
+    int64_t start = getTimeUs();
+    for (int32_t t = 0; t < numOfTables; ++t) {
+      snprintf(tbName, sizeof(tbName), "tb%d", t);
+      checkStmt(stmt, taos_stmt_set_tbname(stmt, tbName), "set tbname");
+      checkStmt(stmt, taos_stmt_bind_param_batch(stmt, params), "bind param batch");
+      checkStmt(stmt, taos_stmt_add_batch(stmt), "add batch");
+    }
+    int64_t bound = getTimeUs();
+    checkStmt(stmt, taos_stmt_execute(stmt), "execute");
+    bindUs += bound - start;
+    execUs += getTimeUs() - bound;
+  }
+
+  double  totalRows = (double)numOfTables * numOfRows * numOfExecs;
+  int32_t affectedRows = taos_stmt_affected_rows(stmt);
+  printf("tables:%d rows per table:%d execs:%d null every:%d affected rows:%d\n", numOfTables, numOfRows, numOfExecs,
+         nullEvery, affectedRows);
+  printf("bind used:%.3fs rows/sec:%.0f\n", bindUs / 1000000.0, totalRows * 1000000.0 / bindUs);
+  printf("total used:%.3fs rows/sec:%.0f\n", (bindUs + execUs) / 1000000.0,
+         totalRows * 1000000.0 / (bindUs + execUs));
+
+  taos_stmt_close(stmt);
+  free(ts);
+  free(c1);
+  free(c2);
+  free(c3);
+  free(c4);
+  free(isNull);
+  taos_close(taos);
+  taos_cleanup();
+  return 0;
+}
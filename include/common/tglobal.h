@@ -60,12 +60,19 @@ extern int32_t tsNumOfVnodeQueryThreads;
 extern float   tsRatioOfVnodeStreamThreads;
 extern int32_t tsNumOfVnodeFetchThreads;
 extern int32_t tsNumOfVnodeRsmaThreads;
+extern int32_t tsNumOfVnodeInsertThreads;
 extern int32_t tsNumOfQnodeQueryThreads;
 extern int32_t tsNumOfQnodeFetchThreads;
 extern int32_t tsNumOfSnodeStreamThreads;
 extern int32_t tsNumOfSnodeWriteThreads;
 extern int64_t tsRpcQueueMemoryAllowed;
 
+// tsdb
+extern int32_t tsTsdbPageCacheSize;
+
+// tq
+extern int32_t tsTqDecodeCacheSize;
+
 // sync raft
 extern int32_t tsElectInterval;
 extern int32_t tsHeartbeatInterval;
@@ -100,6 +107,7 @@ extern char    *tsSvrCrashReportUri;
 extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t tsQueryBufferSizeBytes;    // maximum allowed usage buffer size in byte for each data node
 extern int32_t tsCacheLazyLoadThreshold;  // cost threshold for last/last_row loading cache as much as possible
+extern int32_t tsQueryParallelSort;       // max number of sorted runs of one sort being generated in parallel
 
 // query client
 extern int32_t tsQueryPolicy;
@@ -110,6 +118,7 @@ extern int32_t tsQueryRsmaTolerance;
 extern bool    tsQueryPlannerTrace;
 extern int32_t tsQueryNodeChunkSize;
 extern bool    tsQueryUseNodeAllocator;
+extern int32_t tsQueryParallelScan;
 extern bool    tsKeepColumnName;
 extern bool    tsEnableQueryHb;
 extern bool    tsEnableScience;
@@ -123,6 +132,7 @@ extern bool    tsUseAdapter;
 extern int32_t tsMinSlidingTime;
 extern int32_t tsMinIntervalTime;
 extern int32_t tsMaxMemUsedByInsert;
+extern int32_t tsCsvParseThreads;
 
 // build info
 extern char version[];
@@ -150,11 +160,14 @@ extern char tsUdfdLdLibPath[];
 // schemaless
 extern char tsSmlChildTableName[];
 extern char tsSmlTagName[];
+extern int32_t tsSmlParseThreads;
 // extern bool    tsSmlDataFormat;
 // extern int32_t tsSmlBatchSize;
 
 // wal
 extern int64_t tsWalFsyncDataSizeLimit;
+extern int32_t tsWalGroupCommitWindow;
+extern int64_t tsWalGroupCommitSize;
 
 // internal
 extern int32_t tsTransPullupInterval;
@@ -1159,6 +1159,10 @@ typedef struct {
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
   int32_t numOfCachedTables;
+  int64_t pageCacheHit;
+  int64_t pageCacheMiss;
+  int64_t decodeCacheHit;
+  int64_t decodeCacheMiss;
 } SVnodeLoad;
 
 typedef struct {
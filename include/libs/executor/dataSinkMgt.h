@@ -113,6 +113,16 @@ void dsGetDataLength(DataSinkHandle handle, int64_t* pLen, bool* pQueryEnd);
  */
 int32_t dsGetDataBlock(DataSinkHandle handle, SOutputData* pOutput);
 
+/**
+ * Get data without copying, by taking over the buffer the data is encoded into. The buffer is allocated by
+ * rpcMallocCont and laid out as a SRetrieveTableRsp, so it is sent as the fetch rsp directly, and freed by rpcFreeCont.
+ * @param handle
+ * @param pOutput output
+ * @param ppRsp output, NULL if the sink does not support it or has no data, and nothing is taken then
+ * @return error code
+ */
+int32_t dsGetDataRsp(DataSinkHandle handle, SOutputData* pOutput, void** ppRsp);
+
 int32_t dsGetCacheSize(DataSinkHandle handle, uint64_t* pSize);
 
 /**
@@ -125,6 +125,15 @@ int32_t qSetSMAInput(qTaskInfo_t tinfo, const void* pBlocks, size_t numOfBlocks,
  */
 int32_t qUpdateTableListForStreamScanner(qTaskInfo_t tinfo, const SArray* tableIdList, bool isAdd);
 
+/**
+ * Create the workers shared by the exec tasks of the node: the readers of parallel scans, the sort of the runs of
+ * external sorts and the write of the evicted pages of paged buffers. Without them the tasks do all of it serially.
+ * @return
+ */
+int32_t qInitExecutorWorkers();
+
+void qCleanupExecutorWorkers();
+
 /**
  * Create the exec task object according to task json
  * @param readHandle
@@ -367,6 +367,7 @@ typedef struct STableScanPhysiNode {
   int8_t         igExpired;
   bool           assignBlockUid;
   int8_t         igCheckUpdate;
+  int8_t         parallelScan;  // max number of readers of a parallel scan, 0 or 1 to scan serially
 } STableScanPhysiNode;
 
 typedef STableScanPhysiNode STableSeqScanPhysiNode;
@@ -366,6 +366,7 @@ typedef struct SVgDataBlocks {
 
 typedef void (*FFreeTableBlockHash)(SHashObj*);
 typedef void (*FFreeVgourpBlockArray)(SArray*);
+typedef void (*FFreeCsvReader)(void*);
 
 typedef struct SVnodeModifyOpStmt {
   ENodeType             nodeType;
@@ -389,8 +390,10 @@ typedef struct SVnodeModifyOpStmt {
   SArray*               pVgDataBlocks;  // SArray<SVgroupDataCxt*>
   SVCreateTbReq*        pCreateTblReq;
   TdFilePtr             fp;
+  void*                 pCsvReader;  // reads and parses fp ahead of the batch being inserted
   FFreeTableBlockHash   freeHashFunc;
   FFreeVgourpBlockArray freeArrayFunc;
+  FFreeCsvReader        freeCsvReaderFunc;
   bool                  usingTableProcessing;
   bool                  fileProcessing;
 } SVnodeModifyOpStmt;
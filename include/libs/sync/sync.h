@@ -50,10 +50,11 @@ extern "C" {
 
 #define SYNC_VND_COMMIT_MIN_MS 3000
 
-#define SYNC_MAX_BATCH_SIZE 1
-#define SYNC_INDEX_BEGIN    0
-#define SYNC_INDEX_INVALID  -1
-#define SYNC_TERM_INVALID   -1
+#define SYNC_MAX_BATCH_SIZE  64
+#define SYNC_MAX_BATCH_BYTES (1024 * 1024)
+#define SYNC_INDEX_BEGIN     0
+#define SYNC_INDEX_INVALID   -1
+#define SYNC_TERM_INVALID    -1
 
 typedef enum {
   SYNC_STRATEGY_NO_SNAPSHOT = 0,
@@ -194,6 +195,10 @@ typedef struct SSyncLogStore {
   SyncTerm (*syncLogLastTerm)(struct SSyncLogStore* pLogStore);
 
   int32_t (*syncLogAppendEntry)(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, bool forcSync);
+  int32_t (*syncLogAppendEntries)(struct SSyncLogStore* pLogStore, SSyncRaftEntry** aEntry, int32_t nEntry,
+                                  bool forceSync);
+  int32_t (*syncLogFsync)(struct SSyncLogStore* pLogStore);
+  SyncIndex (*syncLogSyncedIndex)(struct SSyncLogStore* pLogStore);
   int32_t (*syncLogGetEntry)(struct SSyncLogStore* pLogStore, SyncIndex index, SSyncRaftEntry** ppEntry);
   int32_t (*syncLogTruncate)(struct SSyncLogStore* pLogStore, SyncIndex fromIndex);
 
@@ -237,6 +242,7 @@ void    syncPreStop(int64_t rid);
 void    syncPostStop(int64_t rid);
 int32_t syncPropose(int64_t rid, SRpcMsg* pMsg, bool isWeak, int64_t* seq);
 int32_t syncProcessMsg(int64_t rid, SRpcMsg* pMsg);
+int32_t syncFlushLog(int64_t rid);
 int32_t syncReconfig(int64_t rid, SSyncCfg* pCfg);
 int32_t syncBeginSnapshot(int64_t rid, int64_t lastApplyIndex);
 int32_t syncEndSnapshot(int64_t rid);
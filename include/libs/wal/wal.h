@@ -43,6 +43,7 @@ extern "C" {
 #define WAL_FILE_LEN      (WAL_PATH_LEN + 32)
 #define WAL_MAGIC         0xFAFBFCFDF4F3F2F1ULL
 #define WAL_SCAN_BUF_SIZE (1024 * 1024 * 3)
+#define WAL_READER_FILES  4
 
 typedef enum {
   TAOS_WAL_WRITE = 1,
@@ -57,6 +58,9 @@ typedef struct {
   int64_t  retentionSize;
   int64_t  segSize;
   EWalType level;  // wal level
+  // group commit, only effective when level is TAOS_WAL_FSYNC and fsyncPeriod is 0
+  int32_t groupCommitWindow;  // microsecond, 0 to fsync each append
+  int64_t groupCommitSize;    // bytes
 } SWalCfg;
 
 typedef struct {
@@ -98,6 +102,15 @@ typedef struct {
 } SWalCkHead;
 #pragma pack(pop)
 
+// one log of a batch appended by walAppendLogs
+typedef struct {
+  int64_t      index;
+  tmsg_t       msgType;
+  SWalSyncInfo syncMeta;
+  const void  *body;
+  int32_t      bodyLen;
+} SWalLogItem;
+
 typedef struct SWal {
   // cfg
   SWalCfg cfg;
@@ -120,6 +133,17 @@ typedef struct SWal {
   SHashObj *pRefHash;  // refId -> SWalRef
   // path
   char path[WAL_PATH_LEN];
+  // idx cache shared by readers
+  TdThreadMutex idxMutex;
+  SArray       *idxCache;  // SArray<SWalIdxCache>
+  int64_t       idxCacheSeq;
+  // group commit
+  int64_t syncedVer;
+  int64_t groupSize;
+  int64_t groupStartUs;
+  // reusable buffer to write head and body in one call
+  char   *writeBuf;
+  int32_t writeBufSize;
   // reusable write head
   SWalCkHead writeHead;
 } SWal;
@@ -138,12 +162,17 @@ typedef struct {
   int8_t enableRef;
 } SWalFilterCond;
 
+typedef struct {
+  int64_t   firstVer;
+  TdFilePtr pLogFile;
+} SWalReaderFile;
+
 // todo hide this struct
 typedef struct SWalReader {
   SWal          *pWal;
   int64_t        readerId;
   TdFilePtr      pLogFile;
-  TdFilePtr      pIdxFile;
+  SWalReaderFile files[WAL_READER_FILES];  // opened log files, most recently used first
   int64_t        curFileFirstVer;
   int64_t        curVersion;
   int64_t        capacity;
@@ -175,8 +204,13 @@ int32_t walWriteWithSyncInfo(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo
 // Assign version automatically and return to caller,
 // -1 will be returned for failed writes
 int64_t walAppendLog(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta, const void *body, int32_t bodyLen);
+// append logs of consecutive versions with one write to each of the idx and log files
+int64_t walAppendLogs(SWal *, const SWalLogItem *aItem, int32_t nItem);
 
 void walFsync(SWal *, bool force);
+// fsync appends deferred by group commit
+bool    walInGroupCommit(SWal *);
+int32_t walFsyncPending(SWal *);
 
 // apis for lifecycle management
 int32_t walCommit(SWal *, int64_t ver);
@@ -221,6 +255,7 @@ bool walIsEmpty(SWal *);
 int64_t walGetFirstVer(SWal *);
 int64_t walGetSnapshotVer(SWal *);
 int64_t walGetLastVer(SWal *);
+int64_t walGetSyncedVer(SWal *);
 int64_t walGetCommittedVer(SWal *);
 int64_t walGetAppliedVer(SWal *);
 
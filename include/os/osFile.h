@@ -84,6 +84,7 @@ bool    taosCheckExistFile(const char *pathname);
 int64_t taosLSeekFile(TdFilePtr pFile, int64_t offset, int32_t whence);
 int32_t taosFtruncateFile(TdFilePtr pFile, int64_t length);
 int32_t taosFsyncFile(TdFilePtr pFile);
+int32_t taosReadAheadFile(TdFilePtr pFile, int64_t offset, int64_t count);
 
 int64_t taosReadFile(TdFilePtr pFile, void *buf, int64_t count);
 int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset);
@@ -123,6 +123,15 @@ int32_t tsCompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32
 int32_t tsDecompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg, void *pBuf,
                            int32_t nBuf);
 
+/*************************************************************************
+ *                  FRAME OF REFERENCE COMPRESSION
+ *************************************************************************/
+#define FOR_BLOCK_ELES 128
+
+void    tsCompressFORSize(void *pIn, int32_t nEle, int32_t bytes, int32_t *szFOR, int32_t *szDeltaFOR);
+int32_t tsCompressFOR(void *pIn, int32_t nEle, int32_t bytes, bool delta, void *pOut, int32_t nOut);
+int32_t tsDecompressFOR(void *pIn, int32_t nIn, int32_t nEle, int32_t bytes, bool delta, void *pOut, int32_t nOut);
+
 /*************************************************************************
  *                  STREAM COMPRESSION
  *************************************************************************/
@@ -39,8 +39,19 @@ typedef struct SDiskbasedBufStatis {
   int32_t getPages;
   int32_t releasePages;
   int32_t flushPages;
+  int64_t rawFlushBytes;  // size of the flushed pages before compression
+  int64_t flushUs;        // time spent writing pages to disk
+  int64_t loadUs;         // time spent reading pages from disk
 } SDiskbasedBufStatis;
 
+/**
+ * create the workers writing the evicted pages of all buffers in background, without them pages are written at once
+ * @return
+ */
+int32_t initBufPageWritePool();
+
+void cleanupBufPageWritePool();
+
 /**
  * create disk-based result buffer
  * @param pBuf
@@ -72,18 +72,23 @@ struct STaosQnode {
   char        item[];
 };
 
+#define QUEUE_LATENCY_BUCKETS 20
+
 struct STaosQueue {
-  STaosQnode   *head;
+  STaosQnode   *head;     // items moved out of pending, in the order they were written
   STaosQnode   *tail;
+  STaosQnode   *pending;  // items pushed by writers without lock, the latest first
   STaosQueue   *next;     // for queue set
   STaosQset    *qset;     // for queue set
   void         *ahandle;  // for queue set
   FItem         itemFp;
   FItems        itemsFp;
-  TdThreadMutex mutex;
+  TdThreadMutex mutex;    // serializes readers, and writers while lock-free writes are blocked
+  int32_t       writers;  // lock-free writers in progress, and QUEUE_WRITERS_BLOCKED
   int64_t       memOfItems;
   int32_t       numOfItems;
   int64_t       threadId;
+  int64_t       latency[QUEUE_LATENCY_BUCKETS];  // read items by log2 of the microseconds they waited
 };
 
 struct STaosQset {
@@ -93,6 +98,10 @@ struct STaosQset {
   tsem_t        sem;
   int32_t       numOfQueues;
   int32_t       numOfItems;
+  int64_t       seq;           // bumped on each write, readers recheck it before parking
+  int32_t       numOfWaiters;  // readers parked on sem, writers post only when there are some
+  int32_t       numOfExits;    // readers asked to exit by taosQsetThreadResume
+  int32_t       spinLimit;     // rounds readers spin on seq before parking
 };
 
 struct STaosQall {
@@ -112,6 +121,7 @@ bool        taosQueueEmpty(STaosQueue *queue);
 void        taosUpdateItemSize(STaosQueue *queue, int32_t items);
 int32_t     taosQueueItemSize(STaosQueue *queue);
 int64_t     taosQueueMemorySize(STaosQueue *queue);
+void        taosQueueLatency(STaosQueue *queue, int64_t latency[QUEUE_LATENCY_BUCKETS]);
 
 STaosQall *taosAllocateQall();
 void       taosFreeQall(STaosQall *qall);
@@ -356,6 +356,11 @@ void       stopAllRequests(SHashObj* pRequests);
 int  hbRegisterConn(SAppHbMgr* pAppHbMgr, int64_t tscRefId, int64_t clusterId, int8_t connType);
 void hbDeregisterConn(SAppHbMgr* pAppHbMgr, SClientHbKey connKey);
 
+// --- schemaless
+// the sml-parse workers are only created if smlParseThreads is more than 1 when the client is initialized
+int32_t smlInitParsePool();
+void    smlCleanupParsePool();
+
 typedef struct SSqlCallbackWrapper {
   SParseContext* pParseCtx;
   SCatalogReq*   pCatalogReq;
@@ -71,6 +71,7 @@ extern "C" {
 
 #define OTD_JSON_FIELDS_NUM     4
 #define MAX_RETRY_TIMES 10
+#define SML_PARSE_CHUNK_MIN_LINES 1024  // min number of lines parsed by one sml-parse worker
 typedef TSDB_SML_PROTOCOL_TYPE SMLProtocolType;
 
 typedef enum {
@@ -220,6 +221,66 @@ typedef struct {
     }                                        \
   }
 
+// A line is classified 64 letters at a time into bitmasks of the letters that separate its elements, so that the end of
+// a measure, key or value is found from the bitmasks instead of checking the letters one by one.
+#define SML_SCAN_COMMA 0x01
+#define SML_SCAN_SPACE 0x02
+#define SML_SCAN_EQUAL 0x04
+#define SML_SCAN_QUOTE 0x08
+#define SML_SCAN_SLASH 0x10
+
+typedef struct {
+  const char *line;     // start of the line, the letter before it is never taken as a slash
+  const char *lineEnd;
+  const char *start;    // start of the classified block
+  uint64_t    comma;
+  uint64_t    space;
+  uint64_t    equal;
+  uint64_t    quote;
+  uint64_t    slash;
+  uint64_t    escaped;  // letters right after a slash
+} SSmlScanner;
+
+void smlScanBlock(SSmlScanner *s, const char *p);
+
+static FORCE_INLINE void smlScanInit(SSmlScanner *s, const char *line, const char *lineEnd) {
+  s->line = line;
+  s->lineEnd = lineEnd;
+  s->start = NULL;
+}
+
+static FORCE_INLINE uint64_t smlScanBits(SSmlScanner *s, int32_t kinds) {
+  return ((kinds & SML_SCAN_COMMA) ? s->comma : 0) | ((kinds & SML_SCAN_SPACE) ? s->space : 0) |
+         ((kinds & SML_SCAN_EQUAL) ? s->equal : 0) | ((kinds & SML_SCAN_QUOTE) ? s->quote : 0) |
+         ((kinds & SML_SCAN_SLASH) ? s->slash : 0);
+}
+
+// Find the first letter from p of the kinds in stop that is not right after a slash, or of the kinds in rawStop. The
+// letters of the kinds in esc right after a slash before it are added to pEscaped. Returns lineEnd if there is none.
+static FORCE_INLINE const char *smlScanFind(SSmlScanner *s, const char *p, int32_t stop, int32_t rawStop, int32_t esc,
+                                            size_t *pEscaped) {
+  while (p < s->lineEnd) {
+    if (s->start == NULL || p < s->start || p >= s->start + 64) {
+      smlScanBlock(s, p);
+    }
+
+    uint64_t from = ~(uint64_t)0 << (p - s->start);
+    uint64_t stopBits = ((smlScanBits(s, stop) & ~s->escaped) | smlScanBits(s, rawStop)) & from;
+    uint64_t escBits = esc ? (smlScanBits(s, esc) & s->escaped & from) : 0;
+    if (stopBits != 0) {
+      int32_t idx = BUILDIN_CTZL(stopBits);
+      escBits &= ~(~(uint64_t)0 << idx);
+      for (; escBits != 0; escBits &= escBits - 1) (*pEscaped)++;
+      return s->start + idx;
+    }
+
+    for (; escBits != 0; escBits &= escBits - 1) (*pEscaped)++;
+    p = s->start + 64;
+  }
+
+  return s->lineEnd;
+}
+
 extern int64_t smlFactorNS[3];
 extern int64_t smlFactorS[3];
 
@@ -255,6 +316,7 @@ void freeSSmlKv(void* data);
 int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLineInfo *elements);
 int32_t smlParseTelnetString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLineInfo *elements);
 int32_t smlParseJSON(SSmlHandle *info, char *payload);
+int32_t smlParseLine(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines);
 
 #ifdef __cplusplus
 }
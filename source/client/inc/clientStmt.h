@@ -73,7 +73,7 @@ typedef struct SStmtExecInfo {
   SRequestObj   *pRequest;
   SHashObj      *pBlockHash;
   STableDataCxt *pCurrBlock;
-  SSubmitTbData *pCurrTbData;
+  SHashObj      *pTbDataHash;  // SHash<SSubmitTbData*>, empty copies of the blocks sent by the running exec
 } SStmtExecInfo;
 
 typedef struct SStmtSQLInfo {
@@ -582,6 +582,8 @@ void taos_init_imp(void) {
 #endif
 
   initTaskQueue();
+  qInitCsvParsePool();
+  smlInitParsePool();
   fmFuncMgtInit();
   nodesInitAllocatorSet();
 
@@ -78,6 +78,8 @@ void taos_cleanup(void) {
   tscDebug("rpc cleanup");
 
   cleanupTaskQueue();
+  qCleanupCsvParsePool();
+  smlCleanupParsePool();
 
   taosConvDestroy();
 
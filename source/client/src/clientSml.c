@@ -19,6 +19,7 @@
 #include <string.h>
 
 #include "clientSml.h"
+#include "tworker.h"
 
 int64_t smlToMilli[3] = {3600000LL, 60000LL, 1000LL};
 int64_t smlFactorNS[3] = {NANOSECOND_PER_MSEC, NANOSECOND_PER_USEC, 1};
@@ -233,6 +234,63 @@ cleanup:
   return NULL;
 }
 
+void smlScanBlock(SSmlScanner *s, const char *p) {
+  int32_t  len = TMIN(64, s->lineEnd - p);
+  uint64_t comma = 0, space = 0, equal = 0, quote = 0, slash = 0;
+
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDBuiltins) {
+    char        buf[64];
+    const char *data = p;
+    if (len < 64) {  // the letters after the line end are taken as 0
+      memset(buf, 0, sizeof(buf));
+      memcpy(buf, p, len);
+      data = buf;
+    }
+
+    for (int32_t i = 0; i < 64; i += 32) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)(data + i));
+      comma |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(COMMA))) << i;
+      space |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(SPACE))) << i;
+      equal |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(EQUAL))) << i;
+      quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(QUOTE))) << i;
+      slash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(SLASH))) << i;
+    }
+  } else
+#endif
+  {
+    for (int32_t i = 0; i < len; i++) {
+      switch (p[i]) {
+        case COMMA:
+          comma |= (uint64_t)1 << i;
+          break;
+        case SPACE:
+          space |= (uint64_t)1 << i;
+          break;
+        case EQUAL:
+          equal |= (uint64_t)1 << i;
+          break;
+        case QUOTE:
+          quote |= (uint64_t)1 << i;
+          break;
+        case SLASH:
+          slash |= (uint64_t)1 << i;
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  s->start = p;
+  s->comma = comma;
+  s->space = space;
+  s->equal = equal;
+  s->quote = quote;
+  s->slash = slash;
+  s->escaped = (slash << 1) | (uint64_t)(p > s->line && p[-1] == SLASH);
+}
+
 // uint16_t smlCalTypeSum(char* endptr, int32_t left){
 //   uint16_t sum = 0;
 //   for(int i = 0; i < left; i++){
@@ -257,14 +315,17 @@ cleanup:
   kvVal->type = TSDB_DATA_TYPE_FLOAT;                                                          \
   kvVal->f = (float)result;
 
-#define SET_BIGINT                                                                                       \
-  errno = 0;                                                                                             \
-  int64_t tmp = taosStr2Int64(pVal, &endptr, 10);                                                        \
-  if (errno == ERANGE) {                                                                                 \
-    smlBuildInvalidDataMsg(msg, "big int out of range[-9223372036854775808,9223372036854775807]", pVal); \
-    return false;                                                                                        \
-  }                                                                                                      \
-  kvVal->type = TSDB_DATA_TYPE_BIGINT;                                                                   \
+#define SET_BIGINT                                                                                         \
+  int64_t tmp = iVal;                                                                                      \
+  if (!isInt) {                                                                                            \
+    errno = 0;                                                                                             \
+    tmp = taosStr2Int64(pVal, &endptr, 10);                                                                \
+    if (errno == ERANGE) {                                                                                 \
+      smlBuildInvalidDataMsg(msg, "big int out of range[-9223372036854775808,9223372036854775807]", pVal); \
+      return false;                                                                                        \
+    }                                                                                                      \
+  }                                                                                                        \
+  kvVal->type = TSDB_DATA_TYPE_BIGINT;                                                                     \
   kvVal->i = tmp;
 
 #define SET_INT                                                                    \
@@ -285,7 +346,7 @@ cleanup:
 
 #define SET_UBIGINT                                                                             \
   errno = 0;                                                                                    \
-  uint64_t tmp = taosStr2UInt64(pVal, &endptr, 10);                                             \
+  uint64_t tmp = isInt ? (uint64_t)iVal : taosStr2UInt64(pVal, &endptr, 10);                    \
   if (errno == ERANGE || result < 0) {                                                          \
     smlBuildInvalidDataMsg(msg, "unsigned big int out of range[0,18446744073709551615]", pVal); \
     return false;                                                                               \
@@ -325,13 +386,67 @@ cleanup:
   kvVal->type = TSDB_DATA_TYPE_UTINYINT;                                        \
   kvVal->u = result;
 
+static const double smlPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Parse a number written as [-]digits[.digits], the way nearly all values in lines are written, without strtod. The
+// result is the same as that of strtod, as the digits of a fraction fit in the 53 bits of a double and the power of ten
+// it is divided by is exact. Other forms, like exponents, hex or more digits, are left to strtod by returning false.
+static FORCE_INLINE bool smlParseDecimal(const char *pVal, int32_t len, double *pResult, int64_t *pInt, bool *pIsInt,
+                                         char **pEnd) {
+  const char *p = pVal;
+  const char *end = pVal + len;
+  bool        neg = false;
+  uint64_t    m = 0;
+  int32_t     digits = 0;
+  int32_t     scale = 0;
+
+  if (p < end && *p == '-') {
+    neg = true;
+    p++;
+  }
+  for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+    m = m * 10 + (*p - '0');
+  }
+
+  bool isInt = true;
+  if (p < end && *p == '.') {
+    isInt = false;
+    for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++, scale++) {
+      m = m * 10 + (*p - '0');
+    }
+  }
+
+  if (digits == 0 || digits > (isInt ? 18 : 15)) {
+    return false;
+  }
+  if (p < end && (*p == 'e' || *p == 'E' || *p == 'x' || *p == 'X')) {
+    return false;
+  }
+
+  double result = (double)m;
+  if (scale > 0) {
+    result /= smlPow10[scale];
+  }
+  *pResult = neg ? -result : result;
+  *pInt = neg ? -(int64_t)m : (int64_t)m;
+  *pIsInt = isInt;
+  *pEnd = (char *)p;
+  return true;
+}
+
 bool smlParseNumber(SSmlKv *kvVal, SSmlMsgBuf *msg) {
   const char *pVal = kvVal->value;
   int32_t     len = kvVal->length;
   char       *endptr = NULL;
-  double      result = taosStr2Double(pVal, &endptr);
-  if (pVal == endptr) {
-    RETURN_FALSE
+  double      result = 0;
+  int64_t     iVal = 0;
+  bool        isInt = false;
+  if (!smlParseDecimal(pVal, len, &result, &iVal, &isInt, &endptr)) {
+    result = taosStr2Double(pVal, &endptr);
+    if (pVal == endptr) {
+      RETURN_FALSE
+    }
   }
 
   int32_t left = len - (endptr - pVal);
@@ -1442,7 +1557,299 @@ int32_t smlClearForRerun(SSmlHandle *info) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseLine(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines) {
+static int32_t smlParseOneLine(SSmlHandle *info, char *tmp, int len, int32_t i) {
+  char cTmp = 0;  // for print tmp if is raw
+  if (info->isRawLine) {
+    cTmp = tmp[len];
+    tmp[len] = '\0';
+  }
+
+  uDebug("SML:0x%" PRIx64 " smlParseLine israw:%d, numLines:%d, protocol:%d, len:%d, sql:%s", info->id,
+         info->isRawLine, info->lineNum, info->protocol, len, tmp);
+  if (info->isRawLine) {
+    tmp[len] = cTmp;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (info->protocol == TSDB_SML_LINE_PROTOCOL) {
+    if (info->dataFormat) {
+      SSmlLineInfo element = {0};
+      code = smlParseInfluxString(info, tmp, tmp + len, &element);
+    } else {
+      code = smlParseInfluxString(info, tmp, tmp + len, info->lines + i);
+    }
+  } else if (info->protocol == TSDB_SML_TELNET_PROTOCOL) {
+    if (info->dataFormat) {
+      SSmlLineInfo element = {0};
+      code = smlParseTelnetString(info, (char *)tmp, (char *)tmp + len, &element);
+      if (element.measureTagsLen != 0) taosMemoryFree(element.measureTag);
+    } else {
+      code = smlParseTelnetString(info, (char *)tmp, (char *)tmp + len, info->lines + i);
+    }
+  } else {
+    code = TSDB_CODE_SML_INVALID_PROTOCOL_TYPE;
+  }
+
+  return code;
+}
+
+// The lines of a large request are split into chunks of consecutive lines, which are parsed at the same time by the
+// calling thread and the sml-parse workers. Each chunk is parsed into a handle of its own with its own child tables, and
+// the child tables of all chunks are merged into the request in chunk order before the schema is checked.
+typedef struct SSmlParseJob SSmlParseJob;
+
+typedef struct {
+  SSmlParseJob *pJob;
+  SSmlHandle   *info;  // handle the lines of the chunk are parsed into, its lines are those of the request
+  char        **lines;
+  char         *rawLine;
+  char         *rawLineEnd;
+  int32_t       start;  // index of the first line of the chunk in the request
+  int32_t       code;
+  char          msg[ERROR_MSG_BUF_DEFAULT_SIZE];
+} SSmlParseChunk;
+
+struct SSmlParseJob {
+  SSmlParseChunk *chunks;
+  int32_t         numOfChunks;
+  int32_t         numOfRunning;
+  TdThreadMutex   lock;
+  TdThreadCond    cond;
+};
+
+static SSingleWorker smlParseWorker = {0};
+
+static int32_t smlParseChunkLines(SSmlParseChunk *pChunk) {
+  SSmlHandle *info = pChunk->info;
+  char       *rawLine = pChunk->rawLine;
+  int32_t     i = 0;
+  while (i < info->lineNum) {
+    char *tmp = NULL;
+    int   len = 0;
+    if (pChunk->lines) {
+      tmp = pChunk->lines[i];
+      len = strlen(tmp);
+    } else {
+      tmp = rawLine;
+      while (rawLine < pChunk->rawLineEnd) {
+        if (*(rawLine++) == '\n') {
+          break;
+        }
+        len++;
+      }
+      if (info->protocol == TSDB_SML_LINE_PROTOCOL && tmp[0] == '#') {  // this line is comment
+        continue;
+      }
+    }
+
+    int32_t code = smlParseOneLine(info, tmp, len, i);
+    if (code != TSDB_CODE_SUCCESS) {
+      tmp[len] = '\0';
+      uError("SML:0x%" PRIx64 " smlParseLine failed. line %d : %s", info->id, pChunk->start + i, tmp);
+      return code;
+    }
+    i++;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void smlParseWorkerFp(SQueueInfo *pQInfo, void *pItem) {
+  SSmlParseChunk *pChunk = *(SSmlParseChunk **)pItem;
+  SSmlParseJob   *pJob = pChunk->pJob;
+  taosFreeQitem(pItem);
+
+  int32_t code = smlParseChunkLines(pChunk);
+
+  taosThreadMutexLock(&pJob->lock);
+  pChunk->code = code;
+  if (--pJob->numOfRunning == 0) {
+    taosThreadCondSignal(&pJob->cond);
+  }
+  taosThreadMutexUnlock(&pJob->lock);
+}
+
+int32_t smlInitParsePool() {
+  if (tsSmlParseThreads <= 1) return TSDB_CODE_SUCCESS;
+
+  SSingleWorkerCfg cfg = {.min = TMAX((int32_t)tsNumOfCores, 1),
+                          .max = TMAX((int32_t)tsNumOfCores, 1),
+                          .name = "sml-parse",
+                          .fp = smlParseWorkerFp};
+  if (tSingleWorkerInit(&smlParseWorker, &cfg) != 0) {
+    uError("failed to init sml parse pool since %s", terrstr());
+    return terrno;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+void smlCleanupParsePool() { tSingleWorkerCleanup(&smlParseWorker); }
+
+static int32_t smlGetNumOfParseChunks(SSmlHandle *info, int32_t numLines) {
+  int32_t numOfChunks = TMIN(tsSmlParseThreads, numLines / SML_PARSE_CHUNK_MIN_LINES);
+  if (numOfChunks <= 1 || info->protocol == TSDB_SML_JSON_PROTOCOL) {
+    return 1;
+  }
+
+  return (smlParseWorker.queue != NULL) ? numOfChunks : 1;
+}
+
+static SSmlHandle *smlBuildChunkInfo(SSmlHandle *info, SSmlParseChunk *pChunk, int32_t numLines) {
+  SSmlHandle *pInfo = (SSmlHandle *)taosMemoryCalloc(1, sizeof(SSmlHandle));
+  if (NULL == pInfo) {
+    return NULL;
+  }
+
+  pInfo->id = info->id;
+  pInfo->protocol = info->protocol;
+  pInfo->precision = info->precision;
+  pInfo->isRawLine = info->isRawLine;
+  pInfo->lineNum = numLines;
+  pInfo->lines = info->lines + pChunk->start;
+  pInfo->msgBuf.buf = pChunk->msg;
+  pInfo->msgBuf.len = ERROR_MSG_BUF_DEFAULT_SIZE;
+  pInfo->childTables = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  pInfo->preLineTagKV = taosArrayInit(8, sizeof(SSmlKv));
+  if (NULL == pInfo->childTables || NULL == pInfo->preLineTagKV) {
+    taosHashCleanup(pInfo->childTables);
+    taosArrayDestroy(pInfo->preLineTagKV);
+    taosMemoryFree(pInfo);
+    return NULL;
+  }
+
+  return pInfo;
+}
+
+static void smlDestroyChunkInfo(SSmlHandle *pInfo) {
+  if (!pInfo) return;
+
+  SSmlTableInfo **oneTable = (SSmlTableInfo **)taosHashIterate(pInfo->childTables, NULL);
+  while (oneTable) {
+    smlDestroyTableInfo(pInfo, *oneTable);
+    oneTable = (SSmlTableInfo **)taosHashIterate(pInfo->childTables, oneTable);
+  }
+  taosHashCleanup(pInfo->childTables);
+  taosArrayDestroyEx(pInfo->preLineTagKV, freeSSmlKv);
+  taosMemoryFree(pInfo);
+}
+
+// move the child tables first seen in the chunk into the request, and give them uids of the request
+static int32_t smlMergeChunkTables(SSmlHandle *info, SSmlHandle *pInfo) {
+  int32_t         code = TSDB_CODE_SUCCESS;
+  SSmlTableInfo **oneTable = (SSmlTableInfo **)taosHashIterate(pInfo->childTables, NULL);
+  while (oneTable) {
+    size_t keyLen = 0;
+    void  *key = taosHashGetKey(oneTable, &keyLen);
+    if (code != TSDB_CODE_SUCCESS || taosHashGet(info->childTables, key, keyLen) != NULL) {
+      smlDestroyTableInfo(pInfo, *oneTable);
+    } else {
+      (*oneTable)->uid = info->uid++;
+      if (taosHashPut(info->childTables, key, keyLen, oneTable, POINTER_BYTES) != 0) {
+        smlDestroyTableInfo(pInfo, *oneTable);
+        code = TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+    oneTable = (SSmlTableInfo **)taosHashIterate(pInfo->childTables, oneTable);
+  }
+
+  taosHashClear(pInfo->childTables);
+  return code;
+}
+
+static int32_t smlParseLineParallel(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines,
+                                    int32_t numOfChunks) {
+  int32_t      code = TSDB_CODE_SUCCESS;
+  SSmlParseJob job = {.numOfChunks = numOfChunks};
+  job.chunks = taosMemoryCalloc(numOfChunks, sizeof(SSmlParseChunk));
+  if (job.chunks == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosThreadMutexInit(&job.lock, NULL);
+  taosThreadCondInit(&job.cond, NULL);
+
+  // split the lines, the raw lines are only scanned for the line ends here
+  int32_t i = 0;
+  for (int32_t c = 0; c < numOfChunks; c++) {
+    SSmlParseChunk *pChunk = job.chunks + c;
+    int32_t         end = (int64_t)numLines * (c + 1) / numOfChunks;
+
+    pChunk->pJob = &job;
+    pChunk->start = i;
+    if (lines) {
+      pChunk->lines = lines + i;
+      i = end;
+    } else {
+      pChunk->rawLine = rawLine;
+      while (i < end && rawLine < rawLineEnd) {
+        char *lineEnd = memchr(rawLine, '\n', rawLineEnd - rawLine);
+        if (info->protocol != TSDB_SML_LINE_PROTOCOL || rawLine[0] != '#') {
+          i++;
+        }
+        rawLine = (lineEnd != NULL) ? lineEnd + 1 : rawLineEnd;
+      }
+      pChunk->rawLineEnd = rawLine;
+    }
+
+    pChunk->info = smlBuildChunkInfo(info, pChunk, i - pChunk->start);
+    if (pChunk->info == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _end;
+    }
+  }
+
+  // the first chunk is parsed by the calling thread
+  job.numOfRunning = numOfChunks - 1;
+  for (int32_t c = 1; c < numOfChunks; c++) {
+    SSmlParseChunk **pItem = taosAllocateQitem(sizeof(SSmlParseChunk *), DEF_QITEM, 0);
+    if (pItem == NULL) {
+      job.chunks[c].code = TSDB_CODE_OUT_OF_MEMORY;
+      taosThreadMutexLock(&job.lock);
+      job.numOfRunning--;
+      taosThreadMutexUnlock(&job.lock);
+      continue;
+    }
+    *pItem = job.chunks + c;
+    taosWriteQitem(smlParseWorker.queue, pItem);
+  }
+
+  job.chunks[0].code = smlParseChunkLines(job.chunks);
+
+  taosThreadMutexLock(&job.lock);
+  while (job.numOfRunning > 0) {
+    taosThreadCondWait(&job.cond, &job.lock);
+  }
+  taosThreadMutexUnlock(&job.lock);
+
+  // report the error of the first failed line, as the lines are parsed one by one
+  for (int32_t c = 0; c < numOfChunks; c++) {
+    SSmlParseChunk *pChunk = job.chunks + c;
+    if (pChunk->code != TSDB_CODE_SUCCESS) {
+      code = pChunk->code;
+      tstrncpy(info->msgBuf.buf, pChunk->msg, info->msgBuf.len);
+      goto _end;
+    }
+  }
+
+  for (int32_t c = 0; c < numOfChunks; c++) {
+    code = smlMergeChunkTables(info, job.chunks[c].info);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _end;
+    }
+  }
+
+_end:
+  for (int32_t c = 0; c < numOfChunks; c++) {
+    smlDestroyChunkInfo(job.chunks[c].info);
+  }
+  taosThreadMutexDestroy(&job.lock);
+  taosThreadCondDestroy(&job.cond);
+  taosMemoryFree(job.chunks);
+
+  uDebug("SML:0x%" PRIx64 " smlParseLine end, chunks:%d, code:%s", info->id, numOfChunks, tstrerror(code));
+  return code;
+}
+
+int32_t smlParseLine(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines) {
   uDebug("SML:0x%" PRIx64 " smlParseLine start", info->id);
   int32_t code = TSDB_CODE_SUCCESS;
   if (info->protocol == TSDB_SML_JSON_PROTOCOL) {
@@ -1458,6 +1865,19 @@ static int32_t smlParseLine(SSmlHandle *info, char *lines[], char *rawLine, char
     return code;
   }
 
+  // the rows of a large request are not bound while being parsed, so that the lines can be parsed in parallel
+  int32_t numOfChunks = smlGetNumOfParseChunks(info, numLines);
+  if (numOfChunks > 1) {
+    if (info->dataFormat) {
+      info->dataFormat = false;
+      code = smlClearForRerun(info);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+    return smlParseLineParallel(info, lines, rawLine, rawLineEnd, numLines, numOfChunks);
+  }
+
   char   *oldRaw = rawLine;
   int32_t i = 0;
   while (i < numLines) {
@@ -1479,36 +1899,7 @@ static int32_t smlParseLine(SSmlHandle *info, char *lines[], char *rawLine, char
       }
     }
 
-    char cTmp = 0;  // for print tmp if is raw
-    if (info->isRawLine) {
-      cTmp = tmp[len];
-      tmp[len] = '\0';
-    }
-
-    uDebug("SML:0x%" PRIx64 " smlParseLine israw:%d, numLines:%d, protocol:%d, len:%d, sql:%s", info->id,
-           info->isRawLine, numLines, info->protocol, len, tmp);
-    if (info->isRawLine) {
-      tmp[len] = cTmp;
-    }
-
-    if (info->protocol == TSDB_SML_LINE_PROTOCOL) {
-      if (info->dataFormat) {
-        SSmlLineInfo element = {0};
-        code = smlParseInfluxString(info, tmp, tmp + len, &element);
-      } else {
-        code = smlParseInfluxString(info, tmp, tmp + len, info->lines + i);
-      }
-    } else if (info->protocol == TSDB_SML_TELNET_PROTOCOL) {
-      if (info->dataFormat) {
-        SSmlLineInfo element = {0};
-        code = smlParseTelnetString(info, (char *)tmp, (char *)tmp + len, &element);
-        if (element.measureTagsLen != 0) taosMemoryFree(element.measureTag);
-      } else {
-        code = smlParseTelnetString(info, (char *)tmp, (char *)tmp + len, info->lines + i);
-      }
-    } else {
-      code = TSDB_CODE_SML_INVALID_PROTOCOL_TYPE;
-    }
+    code = smlParseOneLine(info, tmp, len, i);
     if (code != TSDB_CODE_SUCCESS) {
       tmp[len] = '\0';
       uError("SML:0x%" PRIx64 " smlParseLine failed. line %d : %s", info->id, i, tmp);
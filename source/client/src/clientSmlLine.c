@@ -35,6 +35,7 @@
 
 #define IS_SLASH_LETTER_IN_TAG_FIELD_KEY(sql)                                                         \
   (*((sql)-1) == SLASH && (*(sql) == COMMA || *(sql) == SPACE || *(sql) == EQUAL))
+#define SML_TAG_FIELD_KEY_ESCAPE (SML_SCAN_COMMA | SML_SCAN_SPACE | SML_SCAN_EQUAL)
 
 #define PROCESS_SLASH_IN_FIELD_VALUE(key, keyLen)           \
   for (int i = 1; i < keyLen; ++i) {                        \
@@ -137,8 +138,8 @@ int32_t smlParseValue(SSmlKv *pVal, SSmlMsgBuf *msg) {
   return TSDB_CODE_TSC_INVALID_VALUE;
 }
 
-static int32_t smlParseTagKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLineInfo *currElement, bool isSameMeasure,
-                             bool isSameCTable) {
+static int32_t smlParseTagKv(SSmlHandle *info, SSmlScanner *s, char **sql, char *sqlEnd, SSmlLineInfo *currElement,
+                             bool isSameMeasure, bool isSameCTable) {
   if (isSameCTable) {
     return TSDB_CODE_SUCCESS;
   }
@@ -192,24 +193,17 @@ static int32_t smlParseTagKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLin
     // parse key
     const char *key = *sql;
     size_t      keyLen = 0;
-    bool        keyEscaped = false;
     size_t      keyLenEscaped = 0;
-    while (*sql < sqlEnd) {
-      if (unlikely(IS_COMMA(*sql))) {
-        smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", *sql);
-        return TSDB_CODE_SML_INVALID_DATA;
-      }
-      if (unlikely(IS_EQUAL(*sql))) {
-        keyLen = *sql - key;
-        (*sql)++;
-        break;
-      }
-      if (IS_SLASH_LETTER_IN_TAG_FIELD_KEY(*sql)) {
-        keyLenEscaped++;
-        keyEscaped = true;
-      }
+    *sql = (char *)smlScanFind(s, *sql, SML_SCAN_COMMA | SML_SCAN_EQUAL, 0, SML_TAG_FIELD_KEY_ESCAPE, &keyLenEscaped);
+    if (unlikely(*sql < sqlEnd && **sql == COMMA)) {
+      smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", *sql);
+      return TSDB_CODE_SML_INVALID_DATA;
+    }
+    if (*sql < sqlEnd) {
+      keyLen = *sql - key;
       (*sql)++;
     }
+    bool keyEscaped = keyLenEscaped > 0;
 
     if (unlikely(IS_INVALID_COL_LEN(keyLen - keyLenEscaped))) {
       smlBuildInvalidDataMsg(&info->msgBuf, "invalid key or key is too long than 64", key);
@@ -219,25 +213,15 @@ static int32_t smlParseTagKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLin
     // parse value
     const char *value = *sql;
     size_t      valueLen = 0;
-    bool        valueEscaped = false;
     size_t      valueLenEscaped = 0;
-    while (*sql < sqlEnd) {
-      // parse value
-      if (unlikely(IS_SPACE(*sql) || IS_COMMA(*sql))) {
-        break;
-      } else if (unlikely(IS_EQUAL(*sql))) {
-        smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", *sql);
-        return TSDB_CODE_SML_INVALID_DATA;
-      }
-
-      if (IS_SLASH_LETTER_IN_TAG_FIELD_KEY(*sql)) {
-        valueLenEscaped++;
-        valueEscaped = true;
-      }
-
-      (*sql)++;
+    *sql = (char *)smlScanFind(s, *sql, SML_SCAN_SPACE | SML_SCAN_COMMA | SML_SCAN_EQUAL, 0, SML_TAG_FIELD_KEY_ESCAPE,
+                               &valueLenEscaped);
+    if (unlikely(*sql < sqlEnd && **sql == EQUAL)) {
+      smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", *sql);
+      return TSDB_CODE_SML_INVALID_DATA;
     }
     valueLen = *sql - value;
+    bool valueEscaped = valueLenEscaped > 0;
 
     if (unlikely(valueLen == 0)) {
       smlBuildInvalidDataMsg(&info->msgBuf, "invalid value", value);
@@ -328,8 +312,8 @@ static int32_t smlParseTagKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLin
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseColKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLineInfo *currElement, bool isSameMeasure,
-                             bool isSameCTable) {
+static int32_t smlParseColKv(SSmlHandle *info, SSmlScanner *s, char **sql, char *sqlEnd, SSmlLineInfo *currElement,
+                             bool isSameMeasure, bool isSameCTable) {
   int     cnt = 0;
   if (info->dataFormat) {
     if (unlikely(!isSameCTable)) {
@@ -390,24 +374,17 @@ static int32_t smlParseColKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLin
     // parse key
     const char *key = *sql;
     size_t      keyLen = 0;
-    bool        keyEscaped = false;
     size_t      keyLenEscaped = 0;
-    while (*sql < sqlEnd) {
-      if (unlikely(IS_COMMA(*sql))) {
-        smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", *sql);
-        return TSDB_CODE_SML_INVALID_DATA;
-      }
-      if (unlikely(IS_EQUAL(*sql))) {
-        keyLen = *sql - key;
-        (*sql)++;
-        break;
-      }
-      if (IS_SLASH_LETTER_IN_TAG_FIELD_KEY(*sql)) {
-        keyLenEscaped++;
-        keyEscaped = true;
-      }
+    *sql = (char *)smlScanFind(s, *sql, SML_SCAN_COMMA | SML_SCAN_EQUAL, 0, SML_TAG_FIELD_KEY_ESCAPE, &keyLenEscaped);
+    if (unlikely(*sql < sqlEnd && **sql == COMMA)) {
+      smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", *sql);
+      return TSDB_CODE_SML_INVALID_DATA;
+    }
+    if (*sql < sqlEnd) {
+      keyLen = *sql - key;
       (*sql)++;
     }
+    bool keyEscaped = keyLenEscaped > 0;
 
     if (unlikely(IS_INVALID_COL_LEN(keyLen - keyLenEscaped))) {
       smlBuildInvalidDataMsg(&info->msgBuf, "invalid key or key is too long than 64", key);
@@ -422,6 +399,13 @@ static int32_t smlParseColKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLin
     bool        isInQuote = false;
     const char *escapeChar = NULL;
     while (*sql < sqlEnd) {
+      // skip to the next letter that matters, quotes and slashes are checked one by one
+      *sql = (char *)smlScanFind(s, *sql, isInQuote ? 0 : (SML_SCAN_SPACE | SML_SCAN_COMMA),
+                                 SML_SCAN_QUOTE | SML_SCAN_SLASH, 0, NULL);
+      if (*sql >= sqlEnd) {
+        break;
+      }
+
       // parse value
       if (unlikely(*(*sql) == QUOTE && (*(*sql - 1) != SLASH || (*sql - 1) == escapeChar))) {
         isInQuote = !isInQuote;
@@ -540,23 +524,15 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
   if (unlikely(*sql == COMMA)) return TSDB_CODE_SML_INVALID_DATA;
   elements->measure = sql;
 
+  SSmlScanner scanner;
+  smlScanInit(&scanner, sql, sqlEnd);
+
   // parse measure
   size_t measureLenEscaped = 0;
-  while (sql < sqlEnd) {
-    if (unlikely((sql != elements->measure) && IS_SLASH_LETTER_IN_MEASUREMENT(sql))) {
-      elements->measureEscaped = true;
-      measureLenEscaped++;
-      sql++;
-      continue;
-    }
-    if (unlikely(IS_COMMA(sql))) {
-      break;
-    }
-
-    if (unlikely(IS_SPACE(sql))) {
-      break;
-    }
-    sql++;
+  sql = (char *)smlScanFind(&scanner, sql, SML_SCAN_COMMA | SML_SCAN_SPACE, 0, SML_SCAN_COMMA | SML_SCAN_SPACE,
+                            &measureLenEscaped);
+  if (unlikely(measureLenEscaped > 0)) {
+    elements->measureEscaped = true;
   }
   elements->measureLen = sql - elements->measure;
   if (unlikely(IS_INVALID_TABLE_LEN(elements->measureLen - measureLenEscaped))) {
@@ -565,13 +541,7 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
   }
 
   // to get measureTagsLen before
-  const char *tmp = sql;
-  while (tmp < sqlEnd) {
-    if (unlikely(IS_SPACE(tmp))) {
-      break;
-    }
-    tmp++;
-  }
+  const char *tmp = smlScanFind(&scanner, sql, SML_SCAN_SPACE, 0, 0, NULL);
   elements->measureTagsLen = tmp - elements->measure;
 
   bool isSameCTable = false;
@@ -586,7 +556,7 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
   if (*sql == COMMA) sql++;
   elements->tags = sql;
 
-  int ret = smlParseTagKv(info, &sql, sqlEnd, elements, isSameMeasure, isSameCTable);
+  int ret = smlParseTagKv(info, &scanner, &sql, sqlEnd, elements, isSameMeasure, isSameCTable);
   if (unlikely(ret != TSDB_CODE_SUCCESS)) {
     return ret;
   }
@@ -601,7 +571,7 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
   JUMP_SPACE(sql, sqlEnd)
   elements->cols = sql;
 
-  ret = smlParseColKv(info, &sql, sqlEnd, elements, isSameMeasure, isSameCTable);
+  ret = smlParseColKv(info, &scanner, &sql, sqlEnd, elements, isSameMeasure, isSameCTable);
   if (unlikely(ret != TSDB_CODE_SUCCESS)) {
     return ret;
   }
@@ -57,19 +57,23 @@ int64_t smlParseOpenTsdbTime(SSmlHandle *info, const char *data, int32_t len) {
   return ts;
 }
 
-static void smlParseTelnetElement(char **sql, char *sqlEnd, char **data, int32_t *len) {
-  while (*sql < sqlEnd) {
-    if (unlikely((**sql != SPACE && !(*data)))) {
-      *data = *sql;
-    } else if (unlikely(**sql == SPACE && *data)) {
-      *len = *sql - *data;
-      break;
-    }
+static void smlParseTelnetElement(SSmlScanner *s, char **sql, char *sqlEnd, char **data, int32_t *len) {
+  while (*sql < sqlEnd && **sql == SPACE) {
     (*sql)++;
   }
+  if (*sql >= sqlEnd) {
+    return;
+  }
+
+  *data = *sql;
+  *sql = (char *)smlScanFind(s, *sql, 0, SML_SCAN_SPACE, 0, NULL);
+  if (*sql < sqlEnd) {
+    *len = *sql - *data;
+  }
 }
 
-static int32_t smlParseTelnetTags(SSmlHandle *info, char *data, char *sqlEnd, SSmlLineInfo *elements, SSmlMsgBuf *msg) {
+static int32_t smlParseTelnetTags(SSmlHandle *info, SSmlScanner *s, char *data, char *sqlEnd, SSmlLineInfo *elements,
+                                  SSmlMsgBuf *msg) {
   if (is_same_child_table_telnet(elements, &info->preLine) == 0) {
     elements->measureTag = info->preLine.measureTag;
     return TSDB_CODE_SUCCESS;
@@ -115,16 +119,13 @@ static int32_t smlParseTelnetTags(SSmlHandle *info, char *data, char *sqlEnd, SS
     size_t      keyLen = 0;
 
     // parse key
-    while (sql < sqlEnd) {
-      if (unlikely(*sql == SPACE)) {
-        smlBuildInvalidDataMsg(msg, "invalid data", sql);
-        return TSDB_CODE_SML_INVALID_DATA;
-      }
-      if (unlikely(*sql == EQUAL)) {
-        keyLen = sql - key;
-        sql++;
-        break;
-      }
+    sql = smlScanFind(s, sql, 0, SML_SCAN_SPACE | SML_SCAN_EQUAL, 0, NULL);
+    if (unlikely(sql < sqlEnd && *sql == SPACE)) {
+      smlBuildInvalidDataMsg(msg, "invalid data", sql);
+      return TSDB_CODE_SML_INVALID_DATA;
+    }
+    if (sql < sqlEnd) {
+      keyLen = sql - key;
       sql++;
     }
 
@@ -140,16 +141,10 @@ static int32_t smlParseTelnetTags(SSmlHandle *info, char *data, char *sqlEnd, SS
     // parse value
     const char *value = sql;
     size_t      valueLen = 0;
-    while (sql < sqlEnd) {
-      // parse value
-      if (unlikely(*sql == SPACE)) {
-        break;
-      }
-      if (unlikely(*sql == EQUAL)) {
-        smlBuildInvalidDataMsg(msg, "invalid data", sql);
-        return TSDB_CODE_SML_INVALID_DATA;
-      }
-      sql++;
+    sql = smlScanFind(s, sql, 0, SML_SCAN_SPACE | SML_SCAN_EQUAL, 0, NULL);
+    if (unlikely(sql < sqlEnd && *sql == EQUAL)) {
+      smlBuildInvalidDataMsg(msg, "invalid data", sql);
+      return TSDB_CODE_SML_INVALID_DATA;
     }
     valueLen = sql - value;
 
@@ -233,15 +228,18 @@ static int32_t smlParseTelnetTags(SSmlHandle *info, char *data, char *sqlEnd, SS
 int32_t smlParseTelnetString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLineInfo *elements) {
   if (!sql) return TSDB_CODE_SML_INVALID_DATA;
 
+  SSmlScanner scanner;
+  smlScanInit(&scanner, sql, sqlEnd);
+
   // parse metric
-  smlParseTelnetElement(&sql, sqlEnd, &elements->measure, &elements->measureLen);
+  smlParseTelnetElement(&scanner, &sql, sqlEnd, &elements->measure, &elements->measureLen);
   if (unlikely((!(elements->measure) || IS_INVALID_TABLE_LEN(elements->measureLen)))) {
     smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", sql);
     return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
   }
 
   // parse timestamp
-  smlParseTelnetElement(&sql, sqlEnd, &elements->timestamp, &elements->timestampLen);
+  smlParseTelnetElement(&scanner, &sql, sqlEnd, &elements->timestamp, &elements->timestampLen);
   if (unlikely(!elements->timestamp || elements->timestampLen == 0)) {
     smlBuildInvalidDataMsg(&info->msgBuf, "invalid timestamp", sql);
     return TSDB_CODE_SML_INVALID_DATA;
@@ -263,7 +261,7 @@ int32_t smlParseTelnetString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
                  .length = (size_t)tDataTypes[TSDB_DATA_TYPE_TIMESTAMP].bytes};
 
   // parse value
-  smlParseTelnetElement(&sql, sqlEnd, &elements->cols, &elements->colsLen);
+  smlParseTelnetElement(&scanner, &sql, sqlEnd, &elements->cols, &elements->colsLen);
   if (unlikely(!elements->cols || elements->colsLen == 0)) {
     smlBuildInvalidDataMsg(&info->msgBuf, "invalid value", sql);
     return TSDB_CODE_TSC_INVALID_VALUE;
@@ -283,7 +281,7 @@ int32_t smlParseTelnetString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
     return TSDB_CODE_TSC_INVALID_VALUE;
   }
 
-  int ret = smlParseTelnetTags(info, sql, sqlEnd, elements, &info->msgBuf);
+  int ret = smlParseTelnetTags(info, &scanner, sql, sqlEnd, elements, &info->msgBuf);
   if (unlikely(ret != TSDB_CODE_SUCCESS)) {
     return ret;
   }
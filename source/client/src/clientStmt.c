@@ -291,6 +291,54 @@ int32_t stmtCleanBindInfo(STscStmt* pStmt) {
   return TSDB_CODE_SUCCESS;
 }
 
+static void stmtDestroyExecTbData(STscStmt* pStmt) {
+  void* pIter = taosHashIterate(pStmt->exec.pTbDataHash, NULL);
+  while (pIter) {
+    SSubmitTbData* pTbData = *(SSubmitTbData**)pIter;
+    tDestroySSubmitTbData(pTbData, TSDB_MSG_FLG_ENCODE);
+    taosMemoryFree(pTbData);
+
+    pIter = taosHashIterate(pStmt->exec.pTbDataHash, pIter);
+  }
+
+  taosHashClear(pStmt->exec.pTbDataHash);
+}
+
+// the submit req takes over the data of the blocks it sends, keep an empty copy of each of them to bind the next rows
+static int32_t stmtCloneExecTbData(STscStmt* pStmt) {
+  stmtDestroyExecTbData(pStmt);
+
+  if (NULL == pStmt->exec.pTbDataHash) {
+    pStmt->exec.pTbDataHash = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+    if (NULL == pStmt->exec.pTbDataHash) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  size_t keyLen = 0;
+  void*  pIter = taosHashIterate(pStmt->exec.pBlockHash, NULL);
+  while (pIter) {
+    STableDataCxt* pBlocks = *(STableDataCxt**)pIter;
+    char*          key = taosHashGetKey(pIter, &keyLen);
+    SSubmitTbData* pTbData = NULL;
+
+    int32_t code = qCloneCurrentTbData(pBlocks, &pTbData);
+    if (TSDB_CODE_SUCCESS == code && taosHashPut(pStmt->exec.pTbDataHash, key, keyLen, &pTbData, POINTER_BYTES)) {
+      tDestroySSubmitTbData(pTbData, TSDB_MSG_FLG_ENCODE);
+      taosMemoryFree(pTbData);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+    if (code) {
+      taosHashCancelIterate(pStmt->exec.pBlockHash, pIter);
+      return code;
+    }
+
+    pIter = taosHashIterate(pStmt->exec.pBlockHash, pIter);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t stmtCleanExecInfo(STscStmt* pStmt, bool keepTable, bool deepClean) {
   if (STMT_TYPE_QUERY != pStmt->sql.type || deepClean) {
     taos_free_result(pStmt->exec.pRequest);
@@ -300,12 +348,16 @@ int32_t stmtCleanExecInfo(STscStmt* pStmt, bool keepTable, bool deepClean) {
   size_t keyLen = 0;
   void*  pIter = taosHashIterate(pStmt->exec.pBlockHash, NULL);
   while (pIter) {
-    STableDataCxt* pBlocks = *(STableDataCxt**)pIter;
-    char*          key = taosHashGetKey(pIter, &keyLen);
-    STableMeta*    pMeta = qGetTableMetaInDataBlock(pBlocks);
-
-    if (keepTable && pBlocks == pStmt->exec.pCurrBlock) {
-      TSWAP(pBlocks->pData, pStmt->exec.pCurrTbData);
+    STableDataCxt*  pBlocks = *(STableDataCxt**)pIter;
+    char*           key = taosHashGetKey(pIter, &keyLen);
+    SSubmitTbData** ppTbData = taosHashGet(pStmt->exec.pTbDataHash, key, keyLen);
+    bool            sent = (NULL == pBlocks->pData);
+
+    // besides the current table, a multi-table insert keeps the blocks of all the tables it has just sent, so that
+    // binding them again in the next exec neither looks up the catalog nor rebuilds the blocks
+    if (keepTable && ppTbData &&
+        (pBlocks == pStmt->exec.pCurrBlock || (sent && STMT_TYPE_MULTI_INSERT == pStmt->sql.type))) {
+      TSWAP(pBlocks->pData, *ppTbData);
       STMT_ERR_RET(qResetStmtDataBlock(pBlocks, false));
 
       pIter = taosHashIterate(pStmt->exec.pBlockHash, pIter);
@@ -325,8 +377,9 @@ int32_t stmtCleanExecInfo(STscStmt* pStmt, bool keepTable, bool deepClean) {
   taosHashCleanup(pStmt->exec.pBlockHash);
   pStmt->exec.pBlockHash = NULL;
 
-  tDestroySSubmitTbData(pStmt->exec.pCurrTbData, TSDB_MSG_FLG_ENCODE);
-  taosMemoryFreeClear(pStmt->exec.pCurrTbData);
+  stmtDestroyExecTbData(pStmt);
+  taosHashCleanup(pStmt->exec.pTbDataHash);
+  pStmt->exec.pTbDataHash = NULL;
 
   STMT_ERR_RET(stmtCleanBindInfo(pStmt));
 
@@ -447,25 +500,36 @@ int32_t stmtGetFromCache(STscStmt* pStmt) {
     STMT_RET(stmtCleanBindInfo(pStmt));
   }
 
-  STableMeta*      pTableMeta = NULL;
-  SRequestConnInfo conn = {.pTrans = pStmt->taos->pAppInfo->pTransporter,
-                           .requestId = pStmt->exec.pRequest->requestId,
-                           .requestObjRefId = pStmt->exec.pRequest->self,
-                           .mgmtEps = getEpSet_s(&pStmt->taos->pAppInfo->mgmtEp)};
-  int32_t          code = catalogGetTableMeta(pStmt->pCatalog, &conn, &pStmt->bInfo.sname, &pTableMeta);
-  if (TSDB_CODE_PAR_TABLE_NOT_EXIST == code) {
-    tscDebug("tb %s not exist", pStmt->bInfo.tbFName);
-    stmtCleanBindInfo(pStmt);
+  uint64_t uid = 0;
+  uint64_t suid = 0;
+  int8_t   tableType = 0;
+  if (pStmt->bInfo.inExecCache) {
+    // the block kept from the last exec already has the meta of the table
+    STableMeta* pMeta = qGetTableMetaInDataBlock(pStmt->exec.pCurrBlock);
+    uid = pMeta->uid;
+    suid = pMeta->suid;
+    tableType = pMeta->tableType;
+  } else {
+    STableMeta*      pTableMeta = NULL;
+    SRequestConnInfo conn = {.pTrans = pStmt->taos->pAppInfo->pTransporter,
+                             .requestId = pStmt->exec.pRequest->requestId,
+                             .requestObjRefId = pStmt->exec.pRequest->self,
+                             .mgmtEps = getEpSet_s(&pStmt->taos->pAppInfo->mgmtEp)};
+    int32_t          code = catalogGetTableMeta(pStmt->pCatalog, &conn, &pStmt->bInfo.sname, &pTableMeta);
+    if (TSDB_CODE_PAR_TABLE_NOT_EXIST == code) {
+      tscDebug("tb %s not exist", pStmt->bInfo.tbFName);
+      stmtCleanBindInfo(pStmt);
 
-    STMT_ERR_RET(code);
-  }
+      STMT_ERR_RET(code);
+    }
 
-  STMT_ERR_RET(code);
+    STMT_ERR_RET(code);
 
-  uint64_t uid = pTableMeta->uid;
-  uint64_t suid = pTableMeta->suid;
-  int8_t   tableType = pTableMeta->tableType;
-  taosMemoryFree(pTableMeta);
+    uid = pTableMeta->uid;
+    suid = pTableMeta->suid;
+    tableType = pTableMeta->tableType;
+    taosMemoryFree(pTableMeta);
+  }
   uint64_t cacheUid = (TSDB_CHILD_TABLE == tableType) ? suid : uid;
 
   if (uid == pStmt->bInfo.tbUid) {
@@ -895,10 +959,7 @@ int stmtExec(TAOS_STMT* stmt) {
   if (STMT_TYPE_QUERY == pStmt->sql.type) {
     launchQueryImpl(pStmt->exec.pRequest, pStmt->sql.pQuery, true, NULL);
   } else {
-    tDestroySSubmitTbData(pStmt->exec.pCurrTbData, TSDB_MSG_FLG_ENCODE);
-    taosMemoryFreeClear(pStmt->exec.pCurrTbData);
-
-    STMT_ERR_RET(qCloneCurrentTbData(pStmt->exec.pCurrBlock, &pStmt->exec.pCurrTbData));
+    STMT_ERR_RET(stmtCloneExecTbData(pStmt));
 
     STMT_ERR_RET(qBuildStmtOutput(pStmt->sql.pQuery, pStmt->sql.pVgHash, pStmt->exec.pBlockHash));
     launchQueryImpl(pStmt->exec.pRequest, pStmt->sql.pQuery, true, NULL);
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures how fast the lines of one schemaless request are parsed into child tables, with a growing number of parse
+// threads, for a batch of influx lines as sent by telegraf and a batch of OpenTSDB telnet lines. No server is needed,
+// the lines are only parsed. It also compares the number parser with the strtod based one it replaced.
+
+#include "clientSml.h"
+
+static char *benchBuildInflux(int32_t nLine, int32_t nTable, int32_t *pLen) {
+  int32_t cap = nLine * 256;
+  char   *buf = taosMemoryMalloc(cap);
+  int32_t len = 0;
+  if (buf == NULL) return NULL;
+
+  for (int32_t i = 0; i < nLine; i++) {
+    int32_t t = i % nTable;
+    len += snprintf(buf + len, cap - len,
+                    "cpu,host=server%04d,region=region%d,cpu=cpu%d usage_user=%d.%02d,usage_system=%d.%02d,"
+                    "usage_idle=%di64,state=\"running\",online=true %" PRId64 "\n",
+                    t, t % 8, t % 16, i % 100, i % 97, i % 50, i % 89, i % 1000, (int64_t)1626006833639000000 + i);
+  }
+
+  *pLen = len;
+  return buf;
+}
+
+static char *benchBuildTelnet(int32_t nLine, int32_t nTable, int32_t *pLen) {
+  int32_t cap = nLine * 128;
+  char   *buf = taosMemoryMalloc(cap);
+  int32_t len = 0;
+  if (buf == NULL) return NULL;
+
+  for (int32_t i = 0; i < nLine; i++) {
+    int32_t t = i % nTable;
+    len += snprintf(buf + len, cap - len, "sys.cpu.usage %" PRId64 " %d.%02d host=web%04d dc=dc%d cpu=%d\n",
+                    (int64_t)1626006833639 + i, i % 100, i % 97, t, t % 4, t % 16);
+  }
+
+  *pLen = len;
+  return buf;
+}
+
+static int32_t benchRun(int32_t protocol, int32_t nThread, char *raw, int32_t len, int32_t nLine, int32_t nLoop) {
+  char    msg[ERROR_MSG_BUF_DEFAULT_SIZE] = {0};
+  int32_t code = 0;
+  int32_t nTable = 0;
+  int64_t usedUs = 0;
+
+  tsSmlParseThreads = nThread;
+  for (int32_t l = 0; l < nLoop && code == 0; l++) {
+    SSmlHandle *info = smlBuildSmlInfo(NULL);
+    if (info == NULL) return -1;
+
+    info->protocol = protocol;
+    info->precision = TSDB_SML_TIMESTAMP_NOT_CONFIGURED;
+    info->isRawLine = true;
+    info->lineNum = nLine;
+    info->msgBuf.buf = msg;
+    info->msgBuf.len = sizeof(msg);
+    info->dataFormat = false;
+    info->lines = taosMemoryCalloc(nLine, sizeof(SSmlLineInfo));
+
+    int64_t start = taosGetTimestampUs();
+    code = smlParseLine(info, NULL, raw, raw + len, nLine);
+    usedUs += taosGetTimestampUs() - start;
+
+    nTable = taosHashGetSize(info->childTables);
+    smlDestroyInfo(info);
+  }
+
+  double usedTime = usedUs / 1000000.0;
+  printf("%s threads:%d lines:%d tables:%d loops:%d used:%.3fs lines/sec:%.0f%s%s\n",
+         protocol == TSDB_SML_LINE_PROTOCOL ? "influx" : "telnet", nThread, nLine, nTable, nLoop, usedTime,
+         (double)nLine * nLoop / usedTime, code ? " failed:" : "", code ? msg : "");
+  return code;
+}
+
+static void benchNumber(int32_t nLine, int32_t nLoop) {
+  static const char *values[] = {"0.12", "-98.5", "123456i64", "37.0f64", "2147483647i32", "1.5e3", "99u8", "-0.001"};
+  int32_t     nValue = sizeof(values) / sizeof(values[0]);
+  char        msg[ERROR_MSG_BUF_DEFAULT_SIZE] = {0};
+  SSmlMsgBuf  msgBuf = {.buf = msg, .len = sizeof(msg)};
+
+  for (int32_t old = 0; old <= 1; old++) {
+    int64_t start = taosGetTimestampUs();
+    int64_t nFailed = 0;
+    for (int32_t l = 0; l < nLoop; l++) {
+      for (int32_t i = 0; i < nLine; i++) {
+        SSmlKv kv = {.value = values[i % nValue], .length = strlen(values[i % nValue])};
+        if (!(old ? smlParseNumberOld(&kv, &msgBuf) : smlParseNumber(&kv, &msgBuf))) nFailed++;
+      }
+    }
+    double usedTime = (taosGetTimestampUs() - start) / 1000000.0;
+    printf("number %s values:%" PRId64 " used:%.3fs values/sec:%.0f failed:%" PRId64 "\n", old ? "strtod" : "decimal",
+           (int64_t)nLine * nLoop, usedTime, (double)nLine * nLoop / usedTime, nFailed);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int32_t nLine = 100000;
+  int32_t nTable = 1000;
+  int32_t nLoop = 10;
+  int32_t maxThreads = 16;
+  int32_t simd = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      nLine = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0 && i < argc - 1) {
+      nTable = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0 && i < argc - 1) {
+      nLoop = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      maxThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-m") == 0 && i < argc - 1) {
+      simd = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-n lines]: number of lines in each request, default is:%d\n", nLine);
+      printf("  [-s tables]: number of child tables the lines are written to, default is:%d\n", nTable);
+      printf("  [-l loops]: number of times the lines are parsed, default is:%d\n", nLoop);
+      printf("  [-t threads]: max number of parse threads, default is:%d\n", maxThreads);
+      printf("  [-m simd]: classify the separators of lines with avx2 if supported, default is:%d\n", simd);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  osDefaultInit();
+  char sse42 = 0, avx = 0, fma = 0;
+  taosGetCpuInstructions(&sse42, &avx, &tsAVX2Enable, &fma);
+  tsSIMDBuiltins = simd;
+  printf("simd:%d avx2:%d\n", tsSIMDBuiltins, tsAVX2Enable);
+
+  int32_t influxLen = 0;
+  int32_t telnetLen = 0;
+  char   *influx = benchBuildInflux(nLine, nTable, &influxLen);
+  char   *telnet = benchBuildTelnet(nLine, nTable, &telnetLen);
+  if (influx == NULL || telnet == NULL) {
+    printf("failed to build lines\n");
+    goto _exit;
+  }
+
+  tsSmlParseThreads = maxThreads;
+  smlInitParsePool();
+  for (int32_t nThread = 1; nThread <= maxThreads; nThread <<= 1) {
+    if (benchRun(TSDB_SML_LINE_PROTOCOL, nThread, influx, influxLen, nLine, nLoop) != 0) break;
+    if (benchRun(TSDB_SML_TELNET_PROTOCOL, nThread, telnet, telnetLen, nLine, nLoop) != 0) break;
+  }
+  benchNumber(nLine, nLoop);
+
+_exit:
+  smlCleanupParsePool();
+  taosMemoryFree(influx);
+  taosMemoryFree(telnet);
+  return 0;
+}
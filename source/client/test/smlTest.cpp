@@ -17,7 +17,11 @@
 
 #include <taoserror.h>
 #include <tglobal.h>
+#include <cmath>
 #include <iostream>
+#include <random>
+#include <string>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -555,6 +559,304 @@ TEST(testCase, smlParseTelnetLine_Test) {
 //  smlDestroyInfo(info);
 //}
 
+// the kind of a letter, as smlScanBlock classifies it
+static int32_t smlScanKind(char c) {
+  switch (c) {
+    case COMMA:
+      return SML_SCAN_COMMA;
+    case SPACE:
+      return SML_SCAN_SPACE;
+    case EQUAL:
+      return SML_SCAN_EQUAL;
+    case QUOTE:
+      return SML_SCAN_QUOTE;
+    case SLASH:
+      return SML_SCAN_SLASH;
+    default:
+      return 0;
+  }
+}
+
+// smlScanFind checking the letters one by one
+static const char *smlScanFindSlow(const char *line, const char *lineEnd, const char *p, int32_t stop, int32_t rawStop,
+                                   int32_t esc, size_t *pEscaped) {
+  for (; p < lineEnd; p++) {
+    int32_t kind = smlScanKind(*p);
+    bool    escaped = p > line && p[-1] == SLASH;
+    if ((kind & rawStop) || ((kind & stop) && !escaped)) {
+      return p;
+    }
+    if ((kind & esc) && escaped) {
+      (*pEscaped)++;
+    }
+  }
+  return lineEnd;
+}
+
+// Find the letters of a line with the scanner as the parsers do, from letter to letter forward, and from every letter
+// backward, which classifies the blocks again. The letter before the line and the ones after its end are separators
+// and slashes, none of them may be taken.
+static void smlCheckScanFind(const std::string &line) {
+  const int32_t kinds[][3] = {{SML_SCAN_COMMA | SML_SCAN_EQUAL, 0, SML_SCAN_COMMA | SML_SCAN_EQUAL | SML_SCAN_SPACE},
+                              {SML_SCAN_SPACE | SML_SCAN_COMMA, 0, SML_SCAN_SPACE | SML_SCAN_COMMA},
+                              {0, SML_SCAN_SPACE | SML_SCAN_EQUAL, 0},
+                              {SML_SCAN_SPACE | SML_SCAN_COMMA, SML_SCAN_QUOTE, SML_SCAN_QUOTE | SML_SCAN_SLASH},
+                              {SML_SCAN_SLASH, 0, SML_SCAN_SLASH}};
+  std::string   buf = "\\" + line + ", =\"\\";
+  const char   *start = buf.c_str() + 1;
+  const char   *end = start + line.size();
+
+  for (auto &kind : kinds) {
+    SSmlScanner s;
+    smlScanInit(&s, start, end);
+    for (const char *p = start; p < end; p++) {
+      size_t      n = 0, nSlow = 0;
+      const char *q = smlScanFindSlow(start, end, p, kind[0], kind[1], kind[2], &nSlow);
+      p = smlScanFind(&s, p, kind[0], kind[1], kind[2], &n);
+      ASSERT_EQ(p - start, q - start) << "line:" << line << " from:" << (q - start);
+      ASSERT_EQ(n, nSlow) << "line:" << line;
+    }
+
+    smlScanInit(&s, start, end);
+    for (const char *p = end - 1; p >= start; p--) {
+      size_t n = 0, nSlow = 0;
+      ASSERT_EQ(smlScanFind(&s, p, kind[0], kind[1], kind[2], &n) - start,
+                smlScanFindSlow(start, end, p, kind[0], kind[1], kind[2], &nSlow) - start)
+          << "line:" << line << " from:" << (p - start);
+      ASSERT_EQ(n, nSlow) << "line:" << line;
+    }
+  }
+}
+
+// the lines are classified with the scalar code and, if the cpu supports it, avx2
+static void smlCheckScanFindAll(const std::vector<std::string> &lines) {
+  char avx2 = tsAVX2Enable;
+  char builtins = tsSIMDBuiltins;
+  char sse42 = 0, avx = 0, fma = 0;
+
+  for (int32_t simd = 0; simd < 2; ++simd) {
+    tsAVX2Enable = 0;
+    if (simd) taosGetCpuInstructions(&sse42, &avx, &tsAVX2Enable, &fma);
+    tsSIMDBuiltins = simd;
+    for (auto &line : lines) {
+      smlCheckScanFind(line);
+      if (testing::Test::HasFatalFailure()) break;
+    }
+  }
+
+  tsAVX2Enable = avx2;
+  tsSIMDBuiltins = builtins;
+}
+
+TEST(testCase, smlScanFind_boundary_Test) {
+  std::vector<std::string> lines;
+
+  // a separator and an escaped separator right before, on and right after each block boundary
+  for (int32_t len : {63, 64, 65, 127, 128, 129, 130, 200}) {
+    for (int32_t pos : {0, 1, 62, 63, 64, 65, 126, 127, 128, 129}) {
+      if (pos >= len) continue;
+      for (char c : {COMMA, SPACE, EQUAL, QUOTE, SLASH}) {
+        std::string line(len, 'a');
+        line[pos] = c;
+        lines.push_back(line);
+        if (pos > 0) {
+          line[pos - 1] = SLASH;
+          lines.push_back(line);
+        }
+        if (pos > 1) {
+          line[pos - 2] = SLASH;
+          lines.push_back(line);
+        }
+      }
+    }
+  }
+
+  // a slash at the end of a block escapes the first letter of the next one, unless it is escaped itself
+  for (int32_t end : {64, 128}) {
+    std::string line(end + 10, 'a');
+    line[end - 1] = SLASH;
+    line[end] = COMMA;
+    lines.push_back(line);
+    line[end - 2] = SLASH;
+    lines.push_back(line);
+    line[end - 3] = SLASH;
+    lines.push_back(line);
+  }
+
+  // the separator is the last letter of a trailing partial block, or there is none
+  for (int32_t len : {1, 2, 33, 63, 65, 96, 127, 129, 191}) {
+    std::string line(len, 'a');
+    lines.push_back(line);
+    line[len - 1] = COMMA;
+    lines.push_back(line);
+    line[len - 1] = SLASH;
+    lines.push_back(line);
+  }
+
+  smlCheckScanFindAll(lines);
+}
+
+TEST(testCase, smlScanFind_random_Test) {
+  const char               letters[] = {'a', 'b', '0', '.', COMMA, SPACE, EQUAL, QUOTE, SLASH};
+  std::mt19937             rng(2023);
+  std::vector<std::string> lines;
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    std::string line(1 + rng() % 300, 'a');
+    int32_t     density = 1 + rng() % 8;  // separators are rare in some lines and everywhere in others
+    for (auto &c : line) {
+      c = (rng() % density == 0) ? letters[4 + rng() % 5] : letters[rng() % 4];
+    }
+    lines.push_back(line);
+  }
+
+  smlCheckScanFindAll(lines);
+}
+
+// Parse a number with a suffix by smlParseNumber, the value must be the one strtod, strtoll or strtoull parses.
+static void smlCheckParseNumber(const std::string &num) {
+  char       buf[128] = {0};
+  SSmlMsgBuf msg = {0};
+  msg.buf = buf;
+  msg.len = sizeof(buf);
+
+  SSmlKv      kv = {0};
+  std::string str;
+  char       *endptr = NULL;
+  double      expect = taosStr2Double(num.c_str(), &endptr);
+  ASSERT_EQ(*endptr, 0) << num;
+
+  for (const char *suffix : {"", "f64", "F64"}) {
+    str = num + suffix;
+    kv.value = str.c_str();
+    kv.length = str.size();
+    ASSERT_TRUE(smlParseNumber(&kv, &msg)) << str;
+    ASSERT_EQ(kv.type, TSDB_DATA_TYPE_DOUBLE) << str;
+    ASSERT_EQ(memcmp(&kv.d, &expect, sizeof(double)), 0) << str << " " << kv.d << " " << expect;
+  }
+
+  str = num + "f32";
+  kv.value = str.c_str();
+  kv.length = str.size();
+  if (IS_VALID_FLOAT(expect)) {
+    ASSERT_TRUE(smlParseNumber(&kv, &msg)) << str;
+    ASSERT_EQ(kv.type, TSDB_DATA_TYPE_FLOAT) << str;
+    ASSERT_EQ(kv.f, (float)expect) << str;
+  } else {
+    ASSERT_FALSE(smlParseNumber(&kv, &msg)) << str;
+  }
+
+  if (num.find_first_of(".eE") != std::string::npos) return;
+
+  // integers, their range is checked on the parsed value
+  struct {
+    const char *suffix;
+    int8_t      type;
+    double      min;
+    double      max;
+  } ints[] = {{"i8", TSDB_DATA_TYPE_TINYINT, INT8_MIN, INT8_MAX},
+              {"i16", TSDB_DATA_TYPE_SMALLINT, INT16_MIN, INT16_MAX},
+              {"i32", TSDB_DATA_TYPE_INT, INT32_MIN, INT32_MAX},
+              {"u8", TSDB_DATA_TYPE_UTINYINT, 0, UINT8_MAX},
+              {"u16", TSDB_DATA_TYPE_USMALLINT, 0, UINT16_MAX},
+              {"u32", TSDB_DATA_TYPE_UINT, 0, UINT32_MAX}};
+  for (auto &t : ints) {
+    str = num + t.suffix;
+    kv.value = str.c_str();
+    kv.length = str.size();
+    if (expect >= t.min && expect <= t.max) {
+      ASSERT_TRUE(smlParseNumber(&kv, &msg)) << str;
+      ASSERT_EQ(kv.type, t.type) << str;
+      ASSERT_EQ(kv.i, (int64_t)expect) << str;
+    } else {
+      ASSERT_FALSE(smlParseNumber(&kv, &msg)) << str;
+    }
+  }
+
+  errno = 0;
+  int64_t i64 = taosStr2Int64(num.c_str(), NULL, 10);
+  bool    i64Valid = errno != ERANGE;
+  for (const char *suffix : {"i64", "I64", "i"}) {
+    str = num + suffix;
+    kv.value = str.c_str();
+    kv.length = str.size();
+    ASSERT_EQ(smlParseNumber(&kv, &msg), i64Valid) << str;
+    if (i64Valid) {
+      ASSERT_EQ(kv.type, TSDB_DATA_TYPE_BIGINT) << str;
+      ASSERT_EQ(kv.i, i64) << str;
+    }
+  }
+
+  errno = 0;
+  uint64_t u64 = taosStr2UInt64(num.c_str(), NULL, 10);
+  bool     u64Valid = errno != ERANGE && expect >= 0;
+  for (const char *suffix : {"u64", "U64", "u"}) {
+    str = num + suffix;
+    kv.value = str.c_str();
+    kv.length = str.size();
+    ASSERT_EQ(smlParseNumber(&kv, &msg), u64Valid) << str;
+    if (u64Valid) {
+      ASSERT_EQ(kv.type, TSDB_DATA_TYPE_UBIGINT) << str;
+      ASSERT_EQ(kv.u, u64) << str;
+    }
+  }
+}
+
+TEST(testCase, smlParseNumber_decimal_Test) {
+  const char *nums[] = {
+      // the plain decimals parsed without strtod, up to 15 significant digits of a fraction and 18 of an integer
+      "0", "-0", "7", "-7", "0.5", "-0.5", "1.", "-1.", ".25", "-.25", "3.14", "0.000000000000001",
+      "123456789012345", "0.123456789012345", "12345678.9012345", "-99999999999999.9", "123456789012345678",
+      // more significant digits than the fast path takes
+      "1234567890123456", "0.1234567890123456", "9007199254740993", "9007199254740993.0", "-999999999999999.99",
+      "3.141592653589793238462643", "1234567890123456789", "100000000000000000000000", "000000000000000000042",
+      "0.000000000000000000000001",
+      // exponents, in and out of the range of a double
+      "1e0", "1E5", "1e22", "1e23", "1e308", "1e309", "-1e400", "1.5e-20", "2.5E+10", "4.9e-324", "1e-400",
+      "123.456e7", "3.2e-900",
+      // integers on the limits of their types
+      "127", "128", "-128", "-129", "255", "256", "32767", "32768", "-32768", "-32769", "65535", "65536",
+      "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296", "9223372036854775807",
+      "9223372036854775808", "-9223372036854775808", "-9223372036854775809", "18446744073709551615",
+      "18446744073709551616"};
+  for (const char *num : nums) {
+    smlCheckParseNumber(num);
+    if (HasFatalFailure()) return;
+  }
+
+  // not numbers, or numbers with letters after them that are no suffix
+  char       buf[128] = {0};
+  SSmlMsgBuf msg = {0};
+  msg.buf = buf;
+  msg.len = sizeof(buf);
+  for (const char *str : {"", "-", ".", "-.", "e5", "1e", "1.2.3", "1-", "12a", "1f", "1f16", "1i128", "1u1", "0x"}) {
+    SSmlKv kv = {0};
+    kv.value = str;
+    kv.length = strlen(str);
+    ASSERT_FALSE(smlParseNumber(&kv, &msg)) << str;
+  }
+}
+
+TEST(testCase, smlParseNumber_random_Test) {
+  std::mt19937 rng(2023);
+
+  for (int32_t i = 0; i < 20000; ++i) {
+    std::string num = (rng() % 2) ? "-" : "";
+    int32_t     digits = 1 + rng() % 22;
+    int32_t     dot = rng() % (digits + 2);  // no dot if it is after the last digit
+    for (int32_t j = 0; j < digits; ++j) {
+      if (j == dot) num += '.';
+      num += (char)('0' + rng() % 10);
+    }
+    if (rng() % 4 == 0) {
+      num += 'e' + std::to_string((int32_t)(rng() % 700) - 350);
+    }
+
+    smlCheckParseNumber(num);
+    if (HasFatalFailure()) return;
+  }
+}
+
 TEST(testCase, smlParseNumber_performance_Test) {
   char       msg[256] = {0};
   SSmlMsgBuf msgBuf;
@@ -579,4 +881,53 @@ TEST(testCase, smlParseNumber_performance_Test) {
     printf("smlParseNumberOld:%s cost:%" PRId64, str[i], taosGetTimestampUs() - t2);
     printf("\n\n");
   }
-}
\ No newline at end of file
+}
+TEST(testCase, smlParseLine_parallel_Test) {
+  osDefaultInit();
+
+  int32_t numLines = 5000;
+  int32_t cap = numLines * 128;
+  char   *raw = (char *)taosMemoryMalloc(cap);
+  int32_t len = 0;
+  for (int32_t i = 0; i < numLines; i++) {
+    if (i % 7 == 0) len += snprintf(raw + len, cap - len, "# comment %d\n", i);
+    len += snprintf(raw + len, cap - len, "st%d,t1=a%d c1=%di64,c2=\"x\" %" PRId64 "\n", i % 3, i % 50, i,
+                    (int64_t)1626006833639000000 + i);
+  }
+
+  tsSmlParseThreads = 4;
+  ASSERT_EQ(smlInitParsePool(), 0);
+
+  int32_t tables = 0;
+  for (int32_t threads = 1; threads <= 4; threads++) {
+    char msg[ERROR_MSG_BUF_DEFAULT_SIZE] = {0};
+    tsSmlParseThreads = threads;
+
+    SSmlHandle *info = smlBuildSmlInfo(NULL);
+    ASSERT_NE(info, nullptr);
+    info->protocol = TSDB_SML_LINE_PROTOCOL;
+    info->isRawLine = true;
+    info->lineNum = numLines;
+    info->msgBuf.buf = msg;
+    info->msgBuf.len = sizeof(msg);
+    info->dataFormat = false;
+    info->lines = (SSmlLineInfo *)taosMemoryCalloc(numLines, sizeof(SSmlLineInfo));
+
+    ASSERT_EQ(smlParseLine(info, NULL, raw, raw + len, numLines), 0);
+    if (threads == 1) tables = taosHashGetSize(info->childTables);
+    ASSERT_EQ(taosHashGetSize(info->childTables), tables);
+
+    for (int32_t i = 0; i < numLines; i++) {
+      SSmlLineInfo *elements = info->lines + i;
+      ASSERT_NE(taosHashGet(info->childTables, elements->measure, elements->measureTagsLen), nullptr);
+      ASSERT_EQ(taosArrayGetSize(elements->colArray), 3);
+      ASSERT_EQ(((SSmlKv *)taosArrayGet(elements->colArray, 0))->i, (int64_t)1626006833639000000 + i);
+    }
+    smlDestroyInfo(info);
+  }
+  smlCleanupParsePool();
+  tsSmlParseThreads = 0;
+
+  ASSERT_EQ(tables, 150);
+  taosMemoryFree(raw);
+}
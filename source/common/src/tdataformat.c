@@ -2500,6 +2500,74 @@ _exit:
   return code;
 }
 
+// Appends all the values of a fixed-length bind at once: the values are copied with one memcpy and the is_null array
+// is translated into the bitmap. Returns TSDB_CODE_INVALID_PARA, before changing anything, if the column has or would
+// get NONE values, which are left to the value by value path.
+static int32_t tColDataPutFixedBind(SColData *pColData, TAOS_MULTI_BIND *pBind) {
+  int32_t code = 0;
+  int32_t nVal = pColData->nVal;
+  int32_t bytes = TYPE_BYTES[pColData->type];
+  int32_t numOfNull = 0;
+
+  if (pBind->is_null) {
+    for (int32_t i = 0; i < pBind->num; ++i) {
+      numOfNull += (pBind->is_null[i] != 0);
+    }
+  }
+
+  uint8_t flag = pColData->flag;
+  if (numOfNull) flag |= HAS_NULL;
+  if (numOfNull < pBind->num) flag |= HAS_VALUE;
+  if (flag & HAS_NONE) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  if (flag & HAS_VALUE) {
+    // the column had only nulls so far, which hold no data
+    if (!(pColData->flag & HAS_VALUE) && nVal) {
+      pColData->nData = bytes * nVal;
+      code = tRealloc(&pColData->pData, pColData->nData);
+      if (code) return code;
+      memset(pColData->pData, 0, pColData->nData);
+    }
+
+    code = tRealloc(&pColData->pData, pColData->nData + bytes * pBind->num);
+    if (code) return code;
+    if (numOfNull < pBind->num) {
+      memcpy(pColData->pData + pColData->nData, pBind->buffer, bytes * pBind->num);
+    } else {
+      memset(pColData->pData + pColData->nData, 0, bytes * pBind->num);
+    }
+  }
+
+  if (flag == (HAS_VALUE | HAS_NULL)) {
+    code = tRealloc(&pColData->pBitMap, BIT1_SIZE(nVal + pBind->num));
+    if (code) return code;
+    if (pColData->flag != flag && nVal) {
+      memset(pColData->pBitMap, (pColData->flag == HAS_VALUE) ? 255 : 0, BIT1_SIZE(nVal));
+    }
+
+    for (int32_t i = 0; i < pBind->num; ++i) {
+      if (pBind->is_null && pBind->is_null[i]) {
+        SET_BIT1(pColData->pBitMap, nVal + i, 0);
+        memset(pColData->pData + pColData->nData + bytes * i, 0, bytes);
+      } else {
+        SET_BIT1(pColData->pBitMap, nVal + i, 1);
+      }
+    }
+  }
+
+  if (flag & HAS_VALUE) {
+    pColData->nData += bytes * pBind->num;
+  }
+  pColData->flag = flag;
+  pColData->nVal += pBind->num;
+  pColData->numOfNull += numOfNull;
+  pColData->numOfValue += pBind->num - numOfNull;
+
+  return code;
+}
+
 int32_t tColDataAddValueByBind(SColData *pColData, TAOS_MULTI_BIND *pBind) {
   int32_t code = 0;
 
@@ -2518,38 +2586,17 @@ int32_t tColDataAddValueByBind(SColData *pColData, TAOS_MULTI_BIND *pBind) {
       }
     }
   } else {  // fixed-length data type
-    bool allValue;
-    bool allNull;
-    if (pBind->is_null) {
-      bool same = (memcmp(pBind->is_null, pBind->is_null + 1, pBind->num - 1) == 0);
-      allNull = (same && pBind->is_null[0] != 0);
-      allValue = (same && pBind->is_null[0] == 0);
-    } else {
-      allNull = false;
-      allValue = true;
-    }
+    code = tColDataPutFixedBind(pColData, pBind);
+    if (code != TSDB_CODE_INVALID_PARA) goto _exit;
+    code = 0;
 
-    if (allValue) {
-      // optimize (todo)
-      for (int32_t i = 0; i < pBind->num; ++i) {
-        code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_VALUE](
-            pColData, (uint8_t *)pBind->buffer + TYPE_BYTES[pColData->type] * i, pBind->buffer_length);
-      }
-    } else if (allNull) {
-      // optimize (todo)
-      for (int32_t i = 0; i < pBind->num; ++i) {
+    for (int32_t i = 0; i < pBind->num; ++i) {
+      if (pBind->is_null && pBind->is_null[i]) {
         code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_NULL](pColData, NULL, 0);
         if (code) goto _exit;
-      }
-    } else {
-      for (int32_t i = 0; i < pBind->num; ++i) {
-        if (pBind->is_null[i]) {
-          code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_NULL](pColData, NULL, 0);
-          if (code) goto _exit;
-        } else {
-          code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_VALUE](
-              pColData, (uint8_t *)pBind->buffer + TYPE_BYTES[pColData->type] * i, pBind->buffer_length);
-        }
+      } else {
+        code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_VALUE](
+            pColData, (uint8_t *)pBind->buffer + TYPE_BYTES[pColData->type] * i, pBind->buffer_length);
       }
     }
   }
@@ -56,11 +56,18 @@ int32_t tsNumOfVnodeQueryThreads = 4;
 float   tsRatioOfVnodeStreamThreads = 1.0;
 int32_t tsNumOfVnodeFetchThreads = 4;
 int32_t tsNumOfVnodeRsmaThreads = 2;
+int32_t tsNumOfVnodeInsertThreads = 1;
 int32_t tsNumOfQnodeQueryThreads = 4;
 int32_t tsNumOfQnodeFetchThreads = 1;
 int32_t tsNumOfSnodeStreamThreads = 4;
 int32_t tsNumOfSnodeWriteThreads = 1;
 
+// tsdb
+int32_t tsTsdbPageCacheSize = 16;  // MB, shared by the file readers of one vnode, 0 means disabled
+
+// tq
+int32_t tsTqDecodeCacheSize = 16;  // MB, decoded submit msgs shared by the subscriptions and streams of one vnode
+
 // sync raft
 int32_t tsElectInterval = 25 * 1000;
 int32_t tsHeartbeatInterval = 1000;
@@ -96,6 +103,8 @@ char *tsSvrCrashReportUri = "/dcrashreport";
 char tsSmlTagName[TSDB_COL_NAME_LEN] = "_tag_null";
 char tsSmlChildTableName[TSDB_TABLE_NAME_LEN] = "";  // user defined child table name can be specified in tag value.
                                                      // If set to empty system will generate table name using MD5 hash.
+// number of threads that parse the lines of one large request, 0 or 1 parses them on the calling thread
+int32_t tsSmlParseThreads = 0;
 // true means that the name and order of cols in each line are the same(only for influx protocol)
 // bool    tsSmlDataFormat = false;
 // int32_t tsSmlBatchSize = 10000;
@@ -111,6 +120,7 @@ int32_t tsQueryRsmaTolerance = 1000;  // the tolerance time (ms) to judge from w
 bool    tsQueryPlannerTrace = false;
 int32_t tsQueryNodeChunkSize = 32 * 1024;
 bool    tsQueryUseNodeAllocator = true;
+int32_t tsQueryParallelScan = 0;  // max number of readers scanning one vnode in parallel, 0 or 1 scans serially
 bool    tsKeepColumnName = false;
 int32_t tsRedirectPeriod = 10;
 int32_t tsRedirectFactor = 2;
@@ -148,9 +158,12 @@ int32_t tsMaxNumOfDistinctResults = 1000 * 10000;
 // 1 database precision unit for interval time range, changed accordingly
 int32_t tsMinIntervalTime = 1;
 
-// maximum memory allowed to be allocated for a single csv load (in MB)
+// megabytes of the csv file of INSERT ... FILE parsed into one submit, the rest of the file goes into later submits
 int32_t tsMaxMemUsedByInsert = 1024;
 
+// number of threads that parse the csv file of one INSERT ... FILE, 0 reads and parses it on the calling thread
+int32_t tsCsvParseThreads = 0;
+
 float   tsSelectivityRatio = 1.0;
 int32_t tsTagFilterResCacheSize = 1024 * 10;
 char    tsTagFilterCache = 0;
@@ -163,6 +176,9 @@ int32_t tsQueryBufferSize = -1;
 int64_t tsQueryBufferSizeBytes = -1;
 int32_t tsCacheLazyLoadThreshold = 500;
 
+// max number of sorted runs of one sort being generated in parallel, 0 or 1 generates them one by one
+int32_t tsQueryParallelSort = 0;
+
 int32_t  tsDiskCfgNum = 0;
 SDiskCfg tsDiskCfg[TFS_MAX_DISKS] = {0};
 
@@ -192,6 +208,8 @@ bool tsStartUdfd = true;
 
 // wal
 int64_t tsWalFsyncDataSizeLimit = (100 * 1024 * 1024L);
+int32_t tsWalGroupCommitWindow = 0;  // microsecond, 0 means disabled
+int64_t tsWalGroupCommitSize = (4 * 1024 * 1024L);
 
 // internal
 int32_t tsTransPullupInterval = 2;
@@ -335,12 +353,15 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddBool(pCfg, "queryPlannerTrace", tsQueryPlannerTrace, true) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryNodeChunkSize", tsQueryNodeChunkSize, 1024, 128 * 1024, true) != 0) return -1;
   if (cfgAddBool(pCfg, "queryUseNodeAllocator", tsQueryUseNodeAllocator, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryParallelScan", tsQueryParallelScan, 0, 64, true) != 0) return -1;
   if (cfgAddBool(pCfg, "keepColumnName", tsKeepColumnName, true) != 0) return -1;
   if (cfgAddString(pCfg, "smlChildTableName", "", 1) != 0) return -1;
   if (cfgAddString(pCfg, "smlTagName", tsSmlTagName, 1) != 0) return -1;
+  if (cfgAddInt32(pCfg, "smlParseThreads", tsSmlParseThreads, 0, 64, 1) != 0) return -1;
   //  if (cfgAddBool(pCfg, "smlDataFormat", tsSmlDataFormat, 1) != 0) return -1;
   //  if (cfgAddInt32(pCfg, "smlBatchSize", tsSmlBatchSize, 1, INT32_MAX, true) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxMemUsedByInsert", tsMaxMemUsedByInsert, 1, INT32_MAX, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "csvParseThreads", tsCsvParseThreads, 0, 64, true) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxRetryWaitTime", tsMaxRetryWaitTime, 0, 86400000, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "useAdapter", tsUseAdapter, true) != 0) return -1;
   if (cfgAddBool(pCfg, "crashReporting", tsEnableCrashReport, true) != 0) return -1;
@@ -417,6 +438,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "maxNumOfDistinctRes", tsMaxNumOfDistinctResults, 10 * 10000, 10000 * 10000, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "countAlwaysReturnValue", tsCountAlwaysReturnValue, 0, 1, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryParallelSort", tsQueryParallelSort, 0, 64, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "printAuth", tsPrintAuth, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, 0) != 0) return -1;
 
@@ -452,6 +474,8 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsNumOfVnodeRsmaThreads = TMAX(tsNumOfVnodeRsmaThreads, 4);
   if (cfgAddInt32(pCfg, "numOfVnodeRsmaThreads", tsNumOfVnodeRsmaThreads, 1, 1024, 0) != 0) return -1;
 
+  if (cfgAddInt32(pCfg, "numOfVnodeInsertThreads", tsNumOfVnodeInsertThreads, 1, 1024, 0) != 0) return -1;
+
   tsNumOfQnodeQueryThreads = tsNumOfCores * 2;
   tsNumOfQnodeQueryThreads = TMAX(tsNumOfQnodeQueryThreads, 4);
   if (cfgAddInt32(pCfg, "numOfQnodeQueryThreads", tsNumOfQnodeQueryThreads, 4, 1024, 0) != 0) return -1;
@@ -473,6 +497,9 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt64(pCfg, "rpcQueueMemoryAllowed", tsRpcQueueMemoryAllowed, TSDB_MAX_MSG_SIZE * 10L, INT64_MAX, 0) != 0)
     return -1;
 
+  if (cfgAddInt32(pCfg, "tsdbPageCacheSize", tsTsdbPageCacheSize, 0, 1024 * 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tqDecodeCacheSize", tsTqDecodeCacheSize, 0, 1024 * 1024, 0) != 0) return -1;
+
   if (cfgAddInt32(pCfg, "syncElectInterval", tsElectInterval, 10, 1000 * 60 * 24 * 2, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "syncHeartbeatInterval", tsHeartbeatInterval, 10, 1000 * 60 * 24 * 2, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "syncHeartbeatTimeout", tsHeartbeatTimeout, 10, 1000 * 60 * 24 * 2, 0) != 0) return -1;
@@ -504,6 +531,8 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
 
   if (cfgAddInt64(pCfg, "walFsyncDataSizeLimit", tsWalFsyncDataSizeLimit, 100 * 1024 * 1024, INT64_MAX, 0) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "walGroupCommitWindow", tsWalGroupCommitWindow, 0, 1000000, 0) != 0) return -1;
+  if (cfgAddInt64(pCfg, "walGroupCommitSize", tsWalGroupCommitSize, 0, INT64_MAX, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, 0) != 0) return -1;
   if (cfgAddString(pCfg, "udfdResFuncs", tsUdfdResFuncs, 0) != 0) return -1;
@@ -722,10 +751,12 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
 
   tstrncpy(tsSmlChildTableName, cfgGetItem(pCfg, "smlChildTableName")->str, TSDB_TABLE_NAME_LEN);
   tstrncpy(tsSmlTagName, cfgGetItem(pCfg, "smlTagName")->str, TSDB_COL_NAME_LEN);
+  tsSmlParseThreads = cfgGetItem(pCfg, "smlParseThreads")->i32;
   //  tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
 
   //  tsSmlBatchSize = cfgGetItem(pCfg, "smlBatchSize")->i32;
   tsMaxMemUsedByInsert = cfgGetItem(pCfg, "maxMemUsedByInsert")->i32;
+  tsCsvParseThreads = cfgGetItem(pCfg, "csvParseThreads")->i32;
 
   tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
   tsCompressMsgSize = cfgGetItem(pCfg, "compressMsgSize")->i32;
@@ -738,6 +769,7 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsQueryPlannerTrace = cfgGetItem(pCfg, "queryPlannerTrace")->bval;
   tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
   tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
+  tsQueryParallelScan = cfgGetItem(pCfg, "queryParallelScan")->i32;
   tsKeepColumnName = cfgGetItem(pCfg, "keepColumnName")->bval;
   tsUseAdapter = cfgGetItem(pCfg, "useAdapter")->bval;
   tsEnableCrashReport = cfgGetItem(pCfg, "crashReporting")->bval;
@@ -782,6 +814,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMaxNumOfDistinctResults = cfgGetItem(pCfg, "maxNumOfDistinctRes")->i32;
   tsCountAlwaysReturnValue = cfgGetItem(pCfg, "countAlwaysReturnValue")->i32;
   tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
+  tsQueryParallelSort = cfgGetItem(pCfg, "queryParallelSort")->i32;
   tsPrintAuth = cfgGetItem(pCfg, "printAuth")->bval;
 
   tsNumOfRpcThreads = cfgGetItem(pCfg, "numOfRpcThreads")->i32;
@@ -794,11 +827,14 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsRatioOfVnodeStreamThreads = cfgGetItem(pCfg, "ratioOfVnodeStreamThreads")->fval;
   tsNumOfVnodeFetchThreads = cfgGetItem(pCfg, "numOfVnodeFetchThreads")->i32;
   tsNumOfVnodeRsmaThreads = cfgGetItem(pCfg, "numOfVnodeRsmaThreads")->i32;
+  tsNumOfVnodeInsertThreads = cfgGetItem(pCfg, "numOfVnodeInsertThreads")->i32;
   tsNumOfQnodeQueryThreads = cfgGetItem(pCfg, "numOfQnodeQueryThreads")->i32;
   //  tsNumOfQnodeFetchThreads = cfgGetItem(pCfg, "numOfQnodeFetchTereads")->i32;
   tsNumOfSnodeStreamThreads = cfgGetItem(pCfg, "numOfSnodeSharedThreads")->i32;
   tsNumOfSnodeWriteThreads = cfgGetItem(pCfg, "numOfSnodeUniqueThreads")->i32;
   tsRpcQueueMemoryAllowed = cfgGetItem(pCfg, "rpcQueueMemoryAllowed")->i64;
+  tsTsdbPageCacheSize = cfgGetItem(pCfg, "tsdbPageCacheSize")->i32;
+  tsTqDecodeCacheSize = cfgGetItem(pCfg, "tqDecodeCacheSize")->i32;
 
   tsSIMDBuiltins = (bool)cfgGetItem(pCfg, "SIMD-builtins")->bval;
   tsTagFilterCache = (bool)cfgGetItem(pCfg, "tagFilterCache")->bval;
@@ -825,6 +861,8 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsQueryRsmaTolerance = cfgGetItem(pCfg, "queryRsmaTolerance")->i32;
 
   tsWalFsyncDataSizeLimit = cfgGetItem(pCfg, "walFsyncDataSizeLimit")->i64;
+  tsWalGroupCommitWindow = cfgGetItem(pCfg, "walGroupCommitWindow")->i32;
+  tsWalGroupCommitSize = cfgGetItem(pCfg, "walGroupCommitSize")->i64;
 
   tsElectInterval = cfgGetItem(pCfg, "syncElectInterval")->i32;
   tsHeartbeatInterval = cfgGetItem(pCfg, "syncHeartbeatInterval")->i32;
@@ -894,6 +932,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         cDebugFlag = cfgGetItem(pCfg, "cDebugFlag")->i32;
       } else if (strcasecmp("crashReporting", name) == 0) {
         tsEnableCrashReport = cfgGetItem(pCfg, "crashReporting")->bval;
+      } else if (strcasecmp("csvParseThreads", name) == 0) {
+        tsCsvParseThreads = cfgGetItem(pCfg, "csvParseThreads")->i32;
       }
       break;
     }
@@ -1097,6 +1137,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         if (tsQueryBufferSize >= 0) {
           tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
         }
+      } else if (strcasecmp("queryParallelSort", name) == 0) {
+        tsQueryParallelSort = cfgGetItem(pCfg, "queryParallelSort")->i32;
       } else if (strcasecmp("qDebugFlag", name) == 0) {
         qDebugFlag = cfgGetItem(pCfg, "qDebugFlag")->i32;
       } else if (strcasecmp("queryPlannerTrace", name) == 0) {
@@ -1105,6 +1147,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
       } else if (strcasecmp("queryUseNodeAllocator", name) == 0) {
         tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
+      } else if (strcasecmp("queryParallelScan", name) == 0) {
+        tsQueryParallelScan = cfgGetItem(pCfg, "queryParallelScan")->i32;
       } else if (strcasecmp("queryRsmaTolerance", name) == 0) {
         tsQueryRsmaTolerance = cfgGetItem(pCfg, "queryRsmaTolerance")->i32;
       }
@@ -1129,6 +1173,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tstrncpy(tsSmlChildTableName, cfgGetItem(pCfg, "smlChildTableName")->str, TSDB_TABLE_NAME_LEN);
       } else if (strcasecmp("smlTagName", name) == 0) {
         tstrncpy(tsSmlTagName, cfgGetItem(pCfg, "smlTagName")->str, TSDB_COL_NAME_LEN);
+      } else if (strcasecmp("smlParseThreads", name) == 0) {
+        tsSmlParseThreads = cfgGetItem(pCfg, "smlParseThreads")->i32;
         //      } else if (strcasecmp("smlDataFormat", name) == 0) {
         //        tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
         //      } else if (strcasecmp("smlBatchSize", name) == 0) {
@@ -478,4 +478,138 @@ TEST(testCase, NoneTest) {
   taosMemoryFree(pTSchema);
 }
 #endif
-#endif
\ No newline at end of file
+#endif
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "tdataformat.h"
+
+namespace {
+
+// the values of a fixed-length bind appended one by one, as tColDataAddValueByBind did before binding in bulk
+void appendBindByValue(SColData *pColData, TAOS_MULTI_BIND *pBind) {
+  int32_t bytes = TYPE_BYTES[pColData->type];
+  for (int32_t i = 0; i < pBind->num; ++i) {
+    SColVal cv;
+    if (pBind->is_null && pBind->is_null[i]) {
+      cv = COL_VAL_NULL(pColData->cid, pColData->type);
+    } else {
+      SValue value = {0};
+      memcpy(&value.val, (char *)pBind->buffer + bytes * i, bytes);
+      cv = COL_VAL_VALUE(pColData->cid, pColData->type, value);
+    }
+    ASSERT_EQ(tColDataAppendValue(pColData, &cv), 0);
+  }
+}
+
+void checkSameColData(SColData *pExpect, SColData *pColData) {
+  ASSERT_EQ(pColData->flag, pExpect->flag);
+  ASSERT_EQ(pColData->nVal, pExpect->nVal);
+  ASSERT_EQ(pColData->numOfNone, pExpect->numOfNone);
+  ASSERT_EQ(pColData->numOfNull, pExpect->numOfNull);
+  ASSERT_EQ(pColData->numOfValue, pExpect->numOfValue);
+  ASSERT_EQ(pColData->nData, pExpect->nData);
+  if (pExpect->nData > 0) {
+    ASSERT_EQ(memcmp(pColData->pData, pExpect->pData, pExpect->nData), 0);
+  }
+
+  // the bits past nVal in the last bitmap byte are undefined
+  uint8_t flag = pExpect->flag;
+  if (flag == (HAS_VALUE | HAS_NULL) || flag == (HAS_VALUE | HAS_NONE) || flag == (HAS_NULL | HAS_NONE)) {
+    for (int32_t i = 0; i < pExpect->nVal; ++i) {
+      ASSERT_EQ(GET_BIT1(pColData->pBitMap, i), GET_BIT1(pExpect->pBitMap, i)) << "row " << i;
+    }
+  }
+
+  for (int32_t i = 0; i < pExpect->nVal; ++i) {
+    SColVal expect, cv;
+    tColDataGetValue(pExpect, i, &expect);
+    tColDataGetValue(pColData, i, &cv);
+    ASSERT_EQ(cv.flag, expect.flag) << "row " << i;
+    if (COL_VAL_IS_VALUE(&expect)) {
+      ASSERT_EQ(memcmp(&cv.value.val, &expect.value.val, TYPE_BYTES[expect.type]), 0) << "row " << i;
+    }
+  }
+}
+
+}  // namespace
+
+// Appending a fixed-length bind in bulk gives the same column data as appending its values one by one, whatever the
+// column holds already: nothing, only nulls or values, both, or NONE, which makes the bulk path step aside. The binds
+// start at any row, so the bitmap is continued within a byte, and include empty and all-null binds.
+TEST(testCase, colDataAddValueByBind_Test) {
+  const int8_t types[] = {TSDB_DATA_TYPE_BOOL,   TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_SMALLINT,
+                          TSDB_DATA_TYPE_INT,    TSDB_DATA_TYPE_BIGINT,  TSDB_DATA_TYPE_FLOAT,
+                          TSDB_DATA_TYPE_DOUBLE, TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_UBIGINT};
+  const int32_t numOfSeqs = 3000;
+
+  std::mt19937 rng(20230615);
+  for (int32_t s = 0; s < numOfSeqs; ++s) {
+    int8_t   type = types[s % (sizeof(types) / sizeof(types[0]))];
+    int32_t  bytes = TYPE_BYTES[type];
+    SColData expect, colData;
+    tColDataInit(&expect, 2, type, 0);
+    tColDataInit(&colData, 2, type, 0);
+
+    int32_t numOfSteps = rng() % 8 + 1;
+    for (int32_t step = 0; step < numOfSteps; ++step) {
+      uint32_t op = rng() % 10;
+      if (op < 3) {
+        // a single value, null or none appended to both, to vary the flag the next bind starts from
+        SColVal cv;
+        uint32_t kind = rng() % 7;
+        if (kind == 0) {
+          cv = COL_VAL_NONE(2, type);
+        } else if (kind < 4) {
+          cv = COL_VAL_NULL(2, type);
+        } else {
+          SValue value = {0};
+          value.val = (int64_t)rng() << 16;
+          cv = COL_VAL_VALUE(2, type, value);
+        }
+        ASSERT_EQ(tColDataAppendValue(&expect, &cv), 0);
+        ASSERT_EQ(tColDataAppendValue(&colData, &cv), 0);
+        continue;
+      }
+
+      int32_t num = (op == 3) ? 0 : (int32_t)(rng() % 70);
+      std::vector<char> buffer(bytes * (num + 1));
+      std::vector<char> isNull(num + 1, 0);
+      for (auto &c : buffer) c = (char)rng();
+
+      TAOS_MULTI_BIND bind = {0};
+      bind.buffer_type = type;
+      bind.buffer = buffer.data();
+      bind.buffer_length = bytes;
+      bind.num = num;
+      switch (rng() % 4) {
+        case 0:  // no is_null
+          break;
+        case 1:  // no null in is_null
+          bind.is_null = isNull.data();
+          break;
+        case 2:  // all null
+          for (auto &c : isNull) c = 1;
+          bind.is_null = isNull.data();
+          break;
+        default:
+          for (auto &c : isNull) c = (rng() % 3 == 0);
+          bind.is_null = isNull.data();
+          break;
+      }
+
+      appendBindByValue(&expect, &bind);
+      ASSERT_EQ(tColDataAddValueByBind(&colData, &bind), 0);
+      checkSameColData(&expect, &colData);
+      if (HasFatalFailure()) {
+        FAIL() << "seq " << s << " step " << step << " type " << (int32_t)type << " num " << num;
+      }
+    }
+
+    tColDataDestroy(&expect);
+    tColDataDestroy(&colData);
+  }
+}
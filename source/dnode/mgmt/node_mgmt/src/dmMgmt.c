@@ -16,6 +16,7 @@
 #define _DEFAULT_SOURCE
 #include "dmMgmt.h"
 #include "dmNodes.h"
+#include "executor.h"
 #include "index.h"
 #include "qworker.h"
 
@@ -154,6 +155,11 @@ int32_t dmInitDnode(SDnode *pDnode) {
 
   indexInit(tsNumOfCommitThreads);
 
+  if (qInitExecutorWorkers() != 0) {
+    dError("failed to init executor workers since %s", terrstr());
+    goto _OVER;
+  }
+
   dmReportStartup("dnode-transport", "initialized");
   dDebug("dnode is created, ptr:%p", pDnode);
   code = 0;
@@ -176,6 +182,7 @@ void dmCleanupDnode(SDnode *pDnode) {
   dmClearVars(pDnode);
   rpcCleanup();
   indexCleanup();
+  qCleanupExecutorWorkers();
   taosConvDestroy();
   dDebug("dnode is closed, ptr:%p", pDnode);
 }
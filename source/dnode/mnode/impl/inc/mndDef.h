@@ -364,6 +364,10 @@ typedef struct {
   SVnodeGid vnodeGid[TSDB_MAX_REPLICA];
   void*     pTsma;
   int32_t   numOfCachedTables;
+  int64_t   pageCacheHit;
+  int64_t   pageCacheMiss;
+  int64_t   decodeCacheHit;
+  int64_t   decodeCacheMiss;
 } SVgObj;
 
 typedef struct {
@@ -422,6 +422,10 @@ static int32_t mndProcessStatusReq(SRpcMsg *pReq) {
       if (pVload->syncState == TAOS_SYNC_STATE_LEADER) {
         pVgroup->cacheUsage = pVload->cacheUsage;
         pVgroup->numOfCachedTables = pVload->numOfCachedTables;
+        pVgroup->pageCacheHit = pVload->pageCacheHit;
+        pVgroup->pageCacheMiss = pVload->pageCacheMiss;
+        pVgroup->decodeCacheHit = pVload->decodeCacheHit;
+        pVgroup->decodeCacheMiss = pVload->decodeCacheMiss;
         pVgroup->numOfTables = pVload->numOfTables;
         pVgroup->numOfTimeSeries = pVload->numOfTimeSeries;
         pVgroup->totalStorage = pVload->totalStorage;
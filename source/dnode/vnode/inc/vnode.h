@@ -185,12 +185,14 @@ SSDataBlock *tsdbRetrieveDataBlock(STsdbReader *pTsdbReadHandle, SArray *pColumn
 int32_t      tsdbReaderReset(STsdbReader *pReader, SQueryTableDataCond *pCond);
 int32_t      tsdbGetFileBlocksDistInfo(STsdbReader *pReader, STableBlockDistInfo *pTableBlockInfo);
 int64_t      tsdbGetNumOfRowsInMemTable(STsdbReader *pHandle);
+int32_t      tsdbGetFileSetWindows(STsdbReader *pReader, SArray *pWindows);
 void        *tsdbGetIdx(SMeta *pMeta);
 void        *tsdbGetIvtIdx(SMeta *pMeta);
 uint64_t     tsdbGetReaderMaxVersion(STsdbReader *pReader);
 int32_t      tsdbSetTableList(STsdbReader *pReader, const void *pTableList, int32_t num);
 void         tsdbReaderSetId(STsdbReader *pReader, const char *idstr);
 void         tsdbReaderSetCloseFlag(STsdbReader *pReader);
+int32_t      tsdbReaderSetFilter(STsdbReader *pReader, void *pFilterInfo, const SArray *pColIdList);
 
 int32_t tsdbCacherowsReaderOpen(void *pVnode, int32_t type, void *pTableIdList, int32_t numOfTables, int32_t numOfCols,
                                 uint64_t suid, void **pReader, const char *idstr);
@@ -202,6 +204,8 @@ void    tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity);
 size_t  tsdbCacheGetCapacity(SVnode *pVnode);
 size_t  tsdbCacheGetUsage(SVnode *pVnode);
 int32_t tsdbCacheGetElems(SVnode *pVnode);
+int64_t tsdbPageCacheGetHits(SVnode *pVnode);
+int64_t tsdbPageCacheGetMisses(SVnode *pVnode);
 
 // tq
 typedef struct SMetaTableInfo {
@@ -233,10 +237,12 @@ typedef struct SSnapContext {
 typedef struct STqReader {
   SPackedData     msg2;
   SSubmitReq2     submit;
+  void           *pCachedSubmit;  // the handle in the tq decode cache that submit is borrowed from, if any
   int32_t         nextBlk;
   int64_t         lastBlkUid;
   SWalReader     *pWalReader;
   SMeta          *pVnodeMeta;
+  SVnode         *pVnode;
   SHashObj       *tbIdHash;
   SArray         *pColIdList;  // SArray<int16_t>
   int32_t         cachedSchemaVer;
@@ -258,10 +264,13 @@ int32_t tqNextBlock(STqReader *pReader, SSDataBlock* pBlock);
 int32_t extractSubmitMsgFromWal(SWalReader *pReader, SPackedData *pPackedData);
 
 int32_t tqReaderSetSubmitMsg(STqReader *pReader, void *msgStr, int32_t msgLen, int64_t ver);
+int32_t tqReaderNextSubmitMsg(STqReader *pReader);
 bool    tqNextBlockImpl(STqReader *pReader);
 bool    tqNextDataBlockFilterOut(STqReader *pReader, SHashObj *filterOutUids);
 int32_t tqRetrieveDataBlock(SSDataBlock *pBlock, STqReader *pReader, SSubmitTbData **pSubmitTbDataRet);
 int32_t tqRetrieveTaosxBlock(STqReader *pReader, SArray *blocks, SArray *schemas, SSubmitTbData **pSubmitTbDataRet);
+int64_t tqDecodeCacheGetHits(SVnode *pVnode);
+int64_t tqDecodeCacheGetMisses(SVnode *pVnode);
 
 int32_t vnodeEnqueueStreamMsg(SVnode *pVnode, SRpcMsg *pMsg);
 
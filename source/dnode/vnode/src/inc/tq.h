@@ -121,6 +121,10 @@ struct STQ {
   TTB*            pExecStore;
   TTB*            pCheckStore;
   SStreamMeta*    pStreamMeta;
+  SLRUCache*      pDecodeCache;  // wal version -> STqDecodedSubmit
+  int32_t         numOfReaders;  // open tq readers, which share pDecodeCache
+  int64_t         decodeCacheHit;
+  int64_t         decodeCacheMiss;
 };
 
 typedef struct {
@@ -174,6 +178,13 @@ void    tqSinkToTablePipeline2(SStreamTask* pTask, void* vnode, int64_t ver, voi
 char*   tqOffsetBuildFName(const char* path, int32_t fVer);
 int32_t tqOffsetRestoreFromFile(STqOffsetStore* pStore, const char* fname);
 
+// tqDecodeCache
+int32_t tqDecodeCacheOpen(STQ* pTq);
+void    tqDecodeCacheClose(STQ* pTq);
+void*   tqDecodeCacheAcquire(STQ* pTq, void* msgStr, int32_t msgLen, int64_t ver, SSubmitReq2* pSubmit);
+void*   tqDecodeCacheLookup(STQ* pTq, int64_t ver, SPackedData* pMsg, SSubmitReq2* pSubmit);
+void    tqDecodeCacheRelease(STQ* pTq, void* pHandle);
+
 // tqStream
 int32_t tqExpandTask(STQ* pTq, SStreamTask* pTask, int64_t ver);
 int32_t tqStreamTasksScanWal(STQ* pTq);
@@ -80,6 +80,21 @@ typedef struct STsdbFilterInfo  STsdbFilterInfo;
 #define TSDB_MAX_SUBBLOCKS 8
 #define TSDB_FHDR_SIZE     512
 
+// SDiskDataHdr.fmtVer, SBlockCol.codec is saved since version 1
+#define TSDB_DISK_DATA_FMT_VER 1
+
+#define TSDB_COL_CODEC_DEFAULT   0  // compressed by the algorithm of the data type
+#define TSDB_COL_CODEC_FOR       1  // frame of reference bit packing
+#define TSDB_COL_CODEC_DELTA_FOR 2  // frame of reference bit packing of the deltas
+
+// version of the file system meta, SSttFile.fmtVer is saved since version 1. It is only written when an stt file has
+// zone maps, so file systems without them stay readable by older versions
+#define TSDB_FS_VER 1
+
+// SSttFile.fmtVer, SSttBlk.smaInfo (column zone maps of the stt block) is saved since version 1. Only stt files with
+// zone maps are written with it
+#define TSDB_STT_FMT_VER 1
+
 #define VERSION_MIN 0
 #define VERSION_MAX INT64_MAX
 
@@ -137,8 +152,8 @@ int32_t tTABLEIDCmprFn(const void *p1, const void *p2);
 #define MIN_TSDBKEY(KEY1, KEY2) ((tsdbKeyCmprFn(&(KEY1), &(KEY2)) < 0) ? (KEY1) : (KEY2))
 #define MAX_TSDBKEY(KEY1, KEY2) ((tsdbKeyCmprFn(&(KEY1), &(KEY2)) > 0) ? (KEY1) : (KEY2))
 // SBlockCol
-int32_t tPutBlockCol(uint8_t *p, void *ph);
-int32_t tGetBlockCol(uint8_t *p, void *ph);
+int32_t tPutBlockCol(uint8_t *p, void *ph, uint32_t fmtVer);
+int32_t tGetBlockCol(uint8_t *p, void *ph, uint32_t fmtVer);
 int32_t tBlockColCmprFn(const void *p1, const void *p2);
 // SDataBlk
 void    tDataBlkReset(SDataBlk *pBlock);
@@ -147,8 +162,8 @@ int32_t tGetDataBlk(uint8_t *p, void *ph);
 int32_t tDataBlkCmprFn(const void *p1, const void *p2);
 bool    tDataBlkHasSma(SDataBlk *pDataBlk);
 // SSttBlk
-int32_t tPutSttBlk(uint8_t *p, void *ph);
-int32_t tGetSttBlk(uint8_t *p, void *ph);
+int32_t tPutSttBlk(uint8_t *p, void *ph, int8_t fmtVer);
+int32_t tGetSttBlk(uint8_t *p, void *ph, int8_t fmtVer);
 // SBlockIdx
 int32_t tPutBlockIdx(uint8_t *p, void *ph);
 int32_t tGetBlockIdx(uint8_t *p, void *ph);
@@ -236,12 +251,12 @@ bool    tsdbDelFileIsSame(SDelFile *pDelFile1, SDelFile *pDelFile2);
 int32_t tsdbDFileRollback(STsdb *pTsdb, SDFileSet *pSet, EDataFileT ftype);
 int32_t tPutHeadFile(uint8_t *p, SHeadFile *pHeadFile);
 int32_t tPutDataFile(uint8_t *p, SDataFile *pDataFile);
-int32_t tPutSttFile(uint8_t *p, SSttFile *pSttFile);
+int32_t tPutSttFile(uint8_t *p, SSttFile *pSttFile, int8_t fsVer);
 int32_t tPutSmaFile(uint8_t *p, SSmaFile *pSmaFile);
 int32_t tPutDelFile(uint8_t *p, SDelFile *pDelFile);
 int32_t tGetDelFile(uint8_t *p, SDelFile *pDelFile);
-int32_t tPutDFileSet(uint8_t *p, SDFileSet *pSet);
-int32_t tGetDFileSet(uint8_t *p, SDFileSet *pSet);
+int32_t tPutDFileSet(uint8_t *p, SDFileSet *pSet, int8_t fsVer);
+int32_t tGetDFileSet(uint8_t *p, SDFileSet *pSet, int8_t fsVer);
 
 void tsdbHeadFileName(STsdb *pTsdb, SDiskID did, int32_t fid, SHeadFile *pHeadF, char fname[]);
 void tsdbDataFileName(STsdb *pTsdb, SDiskID did, int32_t fid, SDataFile *pDataF, char fname[]);
@@ -284,7 +299,9 @@ int32_t tsdbReadBlockIdx(SDataFReader *pReader, SArray *aBlockIdx);
 int32_t tsdbReadDataBlk(SDataFReader *pReader, SBlockIdx *pBlockIdx, SMapData *mDataBlk);
 int32_t tsdbReadSttBlk(SDataFReader *pReader, int32_t iStt, SArray *aSttBlk);
 int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pBlock, SArray *aColumnDataAgg);
+int32_t tsdbReadSttBlockSma(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SArray *aColumnDataAgg);
 int32_t tsdbReadDataBlock(SDataFReader *pReader, SDataBlk *pBlock, SBlockData *pBlockData);
+int32_t tsdbPrefetchDataBlock(SDataFReader *pReader, SDataBlk *pBlock);
 int32_t tsdbReadDataBlockEx(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData);
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
 int32_t tsdbReadSttBlockEx(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
@@ -357,6 +374,9 @@ struct STsdb {
   TdThreadMutex  lruMutex;
   SLRUCache     *biCache;
   TdThreadMutex  biMutex;
+  SLRUCache     *pgCache;
+  int64_t        pgCacheHit;
+  int64_t        pgCacheMiss;
 };
 
 struct TSDBKEY {
@@ -388,15 +408,36 @@ typedef struct SMemSkipList {
   SMemSkipListNode *pTail;
 } SMemSkipList;
 
+// in-order rows are appended to a list of chunks with columnar keys, only out-of-order rows go to the skiplist
+typedef struct SMemAppendChunk SMemAppendChunk;
+struct SMemAppendChunk {
+  SMemAppendChunk *pNext;
+  SMemAppendChunk *pPrev;
+  int32_t          nCap;
+  volatile int32_t nRow;
+  TSKEY           *aTSKEY;
+  int64_t         *aVersion;
+  void           **aData;  // SRow * for TSDBROW_ROW_FMT, SBlockData * for TSDBROW_COL_FMT
+  int32_t         *aIRow;
+  int8_t          *aFlag;
+};
+
+typedef struct SMemAppendList {
+  int64_t          size;
+  SMemAppendChunk *pHead;
+  SMemAppendChunk *pTail;
+} SMemAppendList;
+
 struct STbData {
-  tb_uid_t     suid;
-  tb_uid_t     uid;
-  TSKEY        minKey;
-  TSKEY        maxKey;
-  SDelData    *pHead;
-  SDelData    *pTail;
-  SMemSkipList sl;
-  STbData     *next;
+  tb_uid_t       suid;
+  tb_uid_t       uid;
+  TSKEY          minKey;
+  TSKEY          maxKey;
+  SDelData      *pHead;
+  SDelData      *pTail;
+  SMemSkipList   sl;
+  SMemAppendList al;
+  STbData       *next;
 };
 
 struct SMemTable {
@@ -450,6 +491,7 @@ struct SBlockCol {
   int8_t  type;
   int8_t  smaOn;
   int8_t  flag;      // HAS_NONE|HAS_NULL|HAS_VALUE
+  int8_t  codec;     // TSDB_COL_CODEC_*, codec of the column value
   int32_t szOrigin;  // original column value size (only save for variant data type)
   int32_t szBitmap;  // bitmap size, 0 only for flag == HAS_VAL
   int32_t szOffset;  // offset size, 0 only for non-variant-length type
@@ -501,6 +543,7 @@ struct SSttBlk {
   int64_t    maxVer;
   int32_t    nRow;
   SBlockInfo bInfo;
+  SSmaInfo   smaInfo;  // zone maps of the columns, saved in the stt file after the block data
 };
 
 // (SBlockData){.suid = 0, .uid = 0}: block data not initialized
@@ -526,7 +569,10 @@ struct TABLEID {
 struct STbDataIter {
   STbData          *pTbData;
   int8_t            backward;
+  int8_t            inChunk;  // current row comes from the append list
   SMemSkipListNode *pNode;
+  SMemAppendChunk  *pChunk;
+  int32_t           iChunkRow;
   TSDBROW          *pRow;
   TSDBROW           row;
 };
@@ -587,6 +633,7 @@ struct SSttFile {
   int64_t commitID;
   int64_t size;
   int64_t offset;
+  int8_t  fmtVer;
 };
 
 struct SSmaFile {
@@ -623,13 +670,18 @@ struct SRowMerger {
 };
 
 typedef struct {
-  char     *path;
-  int32_t   szPage;
-  int32_t   flag;
-  TdFilePtr pFD;
-  int64_t   pgno;
-  uint8_t  *pBuf;
-  int64_t   szFile;
+  char      *path;
+  int32_t    szPage;
+  int32_t    flag;
+  TdFilePtr  pFD;
+  int64_t    pgno;
+  uint8_t   *pBuf;
+  int64_t    szFile;
+  STsdb     *pTsdb;     // not NULL if pages are read through the vnode page cache
+  int64_t    lSize;     // logic size of the file in the reader's file set
+  int8_t     pgPri;     // LRUPriority of the pages in page cache
+  uint8_t   *pPage;     // content of page pgno, pBuf or the cached page held by pgHandle
+  LRUHandle *pgHandle;  // the cached page is kept referenced until the reader moves to another page
 } STsdbFD;
 
 struct SDelFWriter {
@@ -696,6 +748,14 @@ typedef struct SSttBlockLoadInfo {
   bool       sttBlockLoaded;
   int32_t    numOfStt;
 
+  // stt blocks whose zone maps rule out the filter are skipped, pFilterInfo is NULL if not applied. Since a skipped
+  // row may hide an older row of the same key, no block overlapping the key range of the table in the data file
+  // (dataWin) is skipped.
+  void       *pFilterInfo;
+  STimeWindow dataWin;
+  SArray     *aFilterOut;  // SArray<int8_t>, zone map check result of each stt block, 0 if not checked yet
+  SArray     *aColAgg;     // SArray<SColumnDataAgg>
+
   // keep the last access position, this position may be used to reduce the binary times for
   // starting last block data for a new table
   struct {
@@ -766,6 +826,7 @@ typedef struct SLDataIter {
   SVersionRange      verRange;
   SSttBlockLoadInfo *pBlockLoadInfo;
   bool               ignoreEarlierTs;
+  bool               filterBlock;  // skip the blocks ruled out by the zone maps
 } SLDataIter;
 
 #define tMergeTreeGetRow(_t) (&((_t)->pIter->rInfo.row))
@@ -823,6 +884,10 @@ int32_t tsdbCacheRelease(SLRUCache *pCache, LRUHandle *h);
 int32_t tsdbCacheGetBlockIdx(SLRUCache *pCache, SDataFReader *pFileReader, LRUHandle **handle);
 int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h);
 
+bool tsdbCacheGetPage(STsdbFD *pFD, int64_t pgno);
+void tsdbCachePutPage(STsdbFD *pFD, int64_t pgno);
+void tsdbCacheReleasePage(STsdbFD *pFD);
+
 int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
@@ -855,6 +920,29 @@ static FORCE_INLINE int32_t tsdbKeyCmprFn(const void *p1, const void *p2) {
 // #define SL_NODE_FORWARD(n, l)  ((n)->forwards[l])
 // #define SL_NODE_BACKWARD(n, l) ((n)->forwards[(n)->level + (l)])
 
+static FORCE_INLINE bool tsdbTbDataIterHasChunkRow(STbDataIter *pIter) {
+  SMemAppendChunk *pChunk = pIter->pChunk;
+
+  if (pChunk == NULL) return false;
+
+  if (pIter->backward) {
+    while (pIter->iChunkRow < 0) {
+      if ((pChunk = pChunk->pPrev) == NULL) return false;
+      pIter->pChunk = pChunk;
+      pIter->iChunkRow = pChunk->nRow - 1;
+    }
+  } else {
+    while (pIter->iChunkRow >= atomic_load_32(&pChunk->nRow)) {
+      if (pIter->iChunkRow < pChunk->nCap) return false;
+      if ((pChunk = (SMemAppendChunk *)atomic_load_ptr(&pChunk->pNext)) == NULL) return false;
+      pIter->pChunk = pChunk;
+      pIter->iChunkRow = 0;
+    }
+  }
+
+  return true;
+}
+
 static FORCE_INLINE TSDBROW *tsdbTbDataIterGet(STbDataIter *pIter) {
   if (pIter == NULL) return NULL;
 
@@ -862,21 +950,50 @@ static FORCE_INLINE TSDBROW *tsdbTbDataIterGet(STbDataIter *pIter) {
     return pIter->pRow;
   }
 
+  bool hasNode;
   if (pIter->backward) {
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return NULL;
-    }
+    hasNode = (pIter->pNode != pIter->pTbData->sl.pHead);
   } else {
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return NULL;
+    hasNode = (pIter->pNode != pIter->pTbData->sl.pTail);
+  }
+  bool hasChunkRow = tsdbTbDataIterHasChunkRow(pIter);
+
+  // merge the skiplist and the append list by key
+  if (hasNode && hasChunkRow) {
+    SMemSkipListNode *pNode = pIter->pNode;
+    TSDBKEY           nKey;
+    TSDBKEY           cKey = {.version = pIter->pChunk->aVersion[pIter->iChunkRow],
+                              .ts = pIter->pChunk->aTSKEY[pIter->iChunkRow]};
+    if (pNode->flag == TSDBROW_ROW_FMT) {
+      nKey.version = pNode->version;
+      nKey.ts = ((SRow *)pNode->pData)->ts;
+    } else {
+      nKey.version = ((SBlockData *)pNode->pData)->aVersion[pNode->iRow];
+      nKey.ts = ((SBlockData *)pNode->pData)->aTSKEY[pNode->iRow];
     }
+
+    int32_t c = tsdbKeyCmprFn(&cKey, &nKey);
+    pIter->inChunk = pIter->backward ? (c >= 0) : (c <= 0);
+  } else if (hasNode || hasChunkRow) {
+    pIter->inChunk = hasChunkRow;
+  } else {
+    return NULL;
   }
 
   pIter->pRow = &pIter->row;
-  if (pIter->pNode->flag == TSDBROW_ROW_FMT) {
-    pIter->row = tsdbRowFromTSRow(pIter->pNode->version, pIter->pNode->pData);
+  if (pIter->inChunk) {
+    SMemAppendChunk *pChunk = pIter->pChunk;
+    int32_t          iRow = pIter->iChunkRow;
+
+    if (pChunk->aFlag[iRow] == TSDBROW_ROW_FMT) {
+      pIter->row = tsdbRowFromTSRow(pChunk->aVersion[iRow], (SRow *)pChunk->aData[iRow]);
+    } else {
+      pIter->row = tsdbRowFromBlockData((SBlockData *)pChunk->aData[iRow], pChunk->aIRow[iRow]);
+    }
+  } else if (pIter->pNode->flag == TSDBROW_ROW_FMT) {
+    pIter->row = tsdbRowFromTSRow(pIter->pNode->version, (SRow *)pIter->pNode->pData);
   } else if (pIter->pNode->flag == TSDBROW_COL_FMT) {
-    pIter->row = tsdbRowFromBlockData(pIter->pNode->pData, pIter->pNode->iRow);
+    pIter->row = tsdbRowFromBlockData((SBlockData *)pIter->pNode->pData, pIter->pNode->iRow);
   } else {
     ASSERT(0);
   }
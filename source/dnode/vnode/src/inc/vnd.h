@@ -50,9 +50,11 @@ int32_t vnodeDecodeConfig(const SJson* pJson, void* pObj);
 
 // vnodeModule.c
 int32_t vnodeScheduleTask(int32_t (*execute)(void*), void* arg);
+int32_t vnodeScheduleInsertTask(int32_t (*execute)(void*), void* arg);
 
 // vnodeBufPool.c
 typedef struct SVBufPoolNode SVBufPoolNode;
+typedef struct SVBufPoolSlab SVBufPoolSlab;
 struct SVBufPoolNode {
   SVBufPoolNode*  prev;
   SVBufPoolNode** pnext;
@@ -74,6 +76,8 @@ struct SVBufPool {
   int32_t           id;
   volatile int32_t  nRef;
   TdThreadSpinlock* lock;
+  int32_t           nSlab;
+  SVBufPoolSlab*    aSlab;  // one per parallel insert task, so that small allocations do not contend on the lock
   int64_t           size;
   uint8_t*          ptr;
   SVBufPoolNode*    pTail;
@@ -85,6 +89,7 @@ int32_t vnodeCloseBufPool(SVnode* pVnode);
 void    vnodeBufPoolReset(SVBufPool* pPool);
 void    vnodeBufPoolAddToFreeList(SVBufPool* pPool);
 int32_t vnodeBufPoolRecycle(SVBufPool* pPool);
+void    vnodeBufPoolSetSlab(int32_t iSlab);
 
 // vnodeQuery.c
 int32_t vnodeQueryOpen(SVnode* pVnode);
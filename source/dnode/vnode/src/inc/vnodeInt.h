@@ -387,6 +387,7 @@ struct SVnode {
   tsem_t        syncSem;
   int32_t       blockSec;
   int64_t       blockSeq;
+  SArray*       aPendingRsp;  // SArray<SRpcMsg>, write responses held until the wal group commit is durable
   SQHandle*     pQuery;
 #if 0
   SRpcHandleInfo blockInfo;
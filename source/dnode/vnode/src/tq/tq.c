@@ -111,6 +111,9 @@ STQ* tqOpen(const char* path, SVnode* pVnode) {
   pTq->pCheckInfo = taosHashInit(64, MurmurHash3_32, true, HASH_ENTRY_LOCK);
   taosHashSetFreeFp(pTq->pCheckInfo, (FDelete)tDeleteSTqCheckInfo);
 
+  // the readers restored below already count for the decode cache of the vnode
+  pVnode->pTq = pTq;
+  tqDecodeCacheOpen(pTq);
   tqInitialize(pTq);
   return pTq;
 }
@@ -151,6 +154,7 @@ void tqClose(STQ* pTq) {
   taosMemoryFree(pTq->path);
   tqMetaClose(pTq);
   streamMetaClose(pTq->pStreamMeta);
+  tqDecodeCacheClose(pTq);
   taosMemoryFree(pTq);
 }
 
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tq.h"
+
+// Every subscription and stream task of a vnode reads the same submit msgs from the wal and decodes them on its own.
+// The decoded msgs are kept here, keyed by their wal version, so that the readers following each other closely
+// decode each msg once. Only applied versions are read by the readers, and the raft log never changes an applied
+// entry, so the version alone identifies a msg. The decoded columns and rows point into the msg, hence each entry
+// owns a copy of it. A vnode with a single reader has nobody to share with, so msgs are only inserted while several
+// readers are open.
+typedef struct {
+  int32_t     msgLen;
+  void*       msgStr;
+  SSubmitReq2 submit;
+} STqDecodedSubmit;
+
+// the msg copy and what the decoder allocated, the columns and rows themselves point into the msg
+static size_t tqDecodedSubmitSize(const STqDecodedSubmit* pEntry) {
+  int32_t nTbData = taosArrayGetSize(pEntry->submit.aSubmitTbData);
+  size_t  size = sizeof(STqDecodedSubmit) + pEntry->msgLen + sizeof(SArray) + nTbData * sizeof(SSubmitTbData);
+
+  for (int32_t i = 0; i < nTbData; i++) {
+    SSubmitTbData* pTbData = taosArrayGet(pEntry->submit.aSubmitTbData, i);
+    SVCreateTbReq* pCreateTbReq = pTbData->pCreateTbReq;
+    if (pCreateTbReq != NULL) {
+      size += sizeof(SVCreateTbReq) + pCreateTbReq->commentLen + 1;
+      if (pCreateTbReq->type == TSDB_CHILD_TABLE && pCreateTbReq->ctb.tagName != NULL) {
+        size += sizeof(SArray) + taosArrayGetSize(pCreateTbReq->ctb.tagName) * TSDB_COL_NAME_LEN;
+      }
+    }
+
+    if (pTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
+      size += sizeof(SArray) + taosArrayGetSize(pTbData->aCol) * sizeof(SColData);
+    } else {
+      size += sizeof(SArray) + taosArrayGetSize(pTbData->aRowP) * sizeof(SRow*);
+    }
+  }
+
+  return size;
+}
+
+static void tqDecodeCacheDelete(const void* key, size_t keyLen, void* value) {
+  STqDecodedSubmit* pEntry = value;
+
+  tDestroySSubmitReq(&pEntry->submit, TSDB_MSG_FLG_DECODE);
+  taosMemoryFree(pEntry->msgStr);
+  taosMemoryFree(pEntry);
+}
+
+int32_t tqDecodeCacheOpen(STQ* pTq) {
+  pTq->pDecodeCache = NULL;
+  if (tsTqDecodeCacheSize <= 0) {
+    return 0;
+  }
+
+  pTq->pDecodeCache = taosLRUCacheInit((size_t)tsTqDecodeCacheSize * 1024 * 1024, 2, .5);
+  if (pTq->pDecodeCache == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  taosLRUCacheSetStrictCapacity(pTq->pDecodeCache, false);
+  return 0;
+}
+
+void tqDecodeCacheClose(STQ* pTq) {
+  SLRUCache* pCache = pTq->pDecodeCache;
+  if (pCache == NULL) {
+    return;
+  }
+
+  tqDebug("vgId:%d, tq decode cache closed, elems:%d hit:%" PRId64 " miss:%" PRId64, TD_VID(pTq->pVnode),
+          taosLRUCacheGetElems(pCache), pTq->decodeCacheHit, pTq->decodeCacheMiss);
+  taosLRUCacheEraseUnrefEntries(pCache);
+  taosLRUCacheCleanup(pCache);
+  pTq->pDecodeCache = NULL;
+}
+
+void* tqDecodeCacheAcquire(STQ* pTq, void* msgStr, int32_t msgLen, int64_t ver, SSubmitReq2* pSubmit) {
+  SLRUCache* pCache = pTq->pDecodeCache;
+  if (pCache == NULL) {
+    return NULL;
+  }
+
+  if (atomic_load_32(&pTq->numOfReaders) <= 1) {
+    return NULL;
+  }
+
+  LRUHandle* h = taosLRUCacheLookup(pCache, &ver, sizeof(ver));
+  if (h != NULL) {
+    STqDecodedSubmit* pEntry = taosLRUCacheValue(pCache, h);
+    if (pEntry->msgLen == msgLen) {
+      *pSubmit = pEntry->submit;
+      atomic_add_fetch_64(&pTq->decodeCacheHit, 1);
+      return h;
+    }
+
+    taosLRUCacheRelease(pCache, h, false);
+    return NULL;
+  }
+
+  atomic_add_fetch_64(&pTq->decodeCacheMiss, 1);
+
+  STqDecodedSubmit* pEntry = taosMemoryCalloc(1, sizeof(STqDecodedSubmit));
+  if (pEntry == NULL) {
+    return NULL;
+  }
+
+  pEntry->msgLen = msgLen;
+  pEntry->msgStr = taosMemoryMalloc(msgLen);
+  if (pEntry->msgStr == NULL) {
+    taosMemoryFree(pEntry);
+    return NULL;
+  }
+  memcpy(pEntry->msgStr, msgStr, msgLen);
+
+  SDecoder decoder;
+  tDecoderInit(&decoder, pEntry->msgStr, msgLen);
+  if (tDecodeSSubmitReq2(&decoder, &pEntry->submit) < 0) {
+    tDecoderClear(&decoder);
+    tqDecodeCacheDelete(NULL, 0, pEntry);
+    return NULL;
+  }
+  tDecoderClear(&decoder);
+
+  // another reader may have inserted the same version meanwhile, the later insert replaces it
+  LRUStatus status = taosLRUCacheInsert(pCache, &ver, sizeof(ver), pEntry, tqDecodedSubmitSize(pEntry),
+                                        tqDecodeCacheDelete, &h, TAOS_LRU_PRIORITY_LOW);
+  if (status == TAOS_LRU_STATUS_FAIL) {
+    tqDecodeCacheDelete(NULL, 0, pEntry);
+    return NULL;
+  }
+
+  *pSubmit = pEntry->submit;
+  return h;
+}
+
+// Unlike tqDecodeCacheAcquire, a miss neither decodes nor inserts. If pSubmit is given, the decoded msg is taken and
+// counted as a hit, otherwise the caller passes the msg on to a reader, which counts it when acquiring it.
+void* tqDecodeCacheLookup(STQ* pTq, int64_t ver, SPackedData* pMsg, SSubmitReq2* pSubmit) {
+  SLRUCache* pCache = pTq->pDecodeCache;
+  if (pCache == NULL) {
+    return NULL;
+  }
+
+  // only serve the versions a wal reader could return
+  if (ver > walGetAppliedVer(pTq->pVnode->pWal)) {
+    return NULL;
+  }
+
+  LRUHandle* h = taosLRUCacheLookup(pCache, &ver, sizeof(ver));
+  if (h == NULL) {
+    return NULL;
+  }
+
+  STqDecodedSubmit* pEntry = taosLRUCacheValue(pCache, h);
+  *pMsg = (SPackedData){.msgStr = pEntry->msgStr, .msgLen = pEntry->msgLen, .ver = ver};
+  if (pSubmit != NULL) {
+    *pSubmit = pEntry->submit;
+    atomic_add_fetch_64(&pTq->decodeCacheHit, 1);
+  }
+  return h;
+}
+
+void tqDecodeCacheRelease(STQ* pTq, void* pHandle) {
+  if (pHandle != NULL) {
+    taosLRUCacheRelease(pTq->pDecodeCache, pHandle, false);
+  }
+}
+
+int64_t tqDecodeCacheGetHits(SVnode* pVnode) {
+  int64_t hits = 0;
+  if (pVnode->pTq != NULL) {
+    hits = atomic_load_64(&pVnode->pTq->decodeCacheHit);
+  }
+
+  return hits;
+}
+
+int64_t tqDecodeCacheGetMisses(SVnode* pVnode) {
+  int64_t misses = 0;
+  if (pVnode->pTq != NULL) {
+    misses = atomic_load_64(&pVnode->pTq->decodeCacheMiss);
+  }
+
+  return misses;
+}
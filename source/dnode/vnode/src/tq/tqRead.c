@@ -249,6 +249,16 @@ END:
   return code;
 }
 
+static void tqReaderClearSubmit(STqReader* pReader) {
+  if (pReader->pCachedSubmit != NULL) {
+    tqDecodeCacheRelease(pReader->pVnode->pTq, pReader->pCachedSubmit);
+    pReader->pCachedSubmit = NULL;
+    memset(&pReader->submit, 0, sizeof(pReader->submit));
+  } else {
+    tDestroySSubmitReq(&pReader->submit, TSDB_MSG_FLG_DECODE);
+  }
+}
+
 STqReader* tqReaderOpen(SVnode* pVnode) {
   STqReader* pReader = taosMemoryCalloc(1, sizeof(STqReader));
   if (pReader == NULL) {
@@ -262,6 +272,10 @@ STqReader* tqReaderOpen(SVnode* pVnode) {
   }
 
   pReader->pVnodeMeta = pVnode->pMeta;
+  pReader->pVnode = pVnode;
+  if (pVnode->pTq != NULL) {
+    atomic_add_fetch_32(&pVnode->pTq->numOfReaders, 1);
+  }
   pReader->pColIdList = NULL;
   pReader->cachedSchemaVer = 0;
   pReader->cachedSchemaSuid = 0;
@@ -288,7 +302,10 @@ void tqCloseReader(STqReader* pReader) {
   }
   // free hash
   taosHashCleanup(pReader->tbIdHash);
-  tDestroySSubmitReq(&pReader->submit, TSDB_MSG_FLG_DECODE);
+  tqReaderClearSubmit(pReader);
+  if (pReader->pVnode->pTq != NULL) {
+    atomic_sub_fetch_32(&pReader->pVnode->pTq->numOfReaders, 1);
+  }
   taosMemoryFree(pReader);
 }
 
@@ -322,18 +339,55 @@ int32_t extractSubmitMsgFromWal(SWalReader* pReader, SPackedData* pPackedData) {
   return 0;
 }
 
-int32_t tqNextBlock(STqReader* pReader, SSDataBlock* pBlock) {
-  while (1) {
-    if (pReader->msg2.msgStr == NULL) {
-      if (walNextValidMsg(pReader->pWalReader) < 0) {
-        return FETCH_TYPE__NONE;
-      }
+// If another reader has decoded the next submit msg, take it from the tq decode cache and move the wal reader past it
+// without reading it again. The last version is left to the wal reader, it could not be skipped by seeking.
+static int32_t tqReaderSetCachedSubmitMsg(STqReader* pReader) {
+  STQ*    pTq = pReader->pVnode->pTq;
+  int64_t ver = walReaderGetCurrentVer(pReader->pWalReader);
+  if (pTq == NULL || ver < 0 || ver >= walGetLastVer(pReader->pWalReader->pWal)) {
+    return -1;
+  }
+
+  SPackedData msg = {0};
+  SSubmitReq2 submit = {0};
+  void*       pHandle = tqDecodeCacheLookup(pTq, ver, &msg, &submit);
+  if (pHandle == NULL) {
+    return -1;
+  }
 
-      void*   pBody = POINTER_SHIFT(pReader->pWalReader->pHead->head.body, sizeof(SSubmitReq2Msg));
-      int32_t bodyLen = pReader->pWalReader->pHead->head.bodyLen - sizeof(SSubmitReq2Msg);
-      int64_t ver = pReader->pWalReader->pHead->head.version;
+  if (walReadSeekVer(pReader->pWalReader, ver + 1) < 0) {
+    tqDecodeCacheRelease(pTq, pHandle);
+    return -1;
+  }
 
-      tqReaderSetSubmitMsg(pReader, pBody, bodyLen, ver);
+  // the reader keeps the entry until it is done with the msg, which points into it
+  pReader->msg2 = msg;
+  pReader->submit = submit;
+  pReader->pCachedSubmit = pHandle;
+  return 0;
+}
+
+int32_t tqReaderNextSubmitMsg(STqReader* pReader) {
+  if (tqReaderSetCachedSubmitMsg(pReader) == 0) {
+    return 0;
+  }
+
+  if (walNextValidMsg(pReader->pWalReader) < 0) {
+    return -1;
+  }
+
+  void*   pBody = POINTER_SHIFT(pReader->pWalReader->pHead->head.body, sizeof(SSubmitReq2Msg));
+  int32_t bodyLen = pReader->pWalReader->pHead->head.bodyLen - sizeof(SSubmitReq2Msg);
+  int64_t ver = pReader->pWalReader->pHead->head.version;
+
+  tqReaderSetSubmitMsg(pReader, pBody, bodyLen, ver);
+  return 0;
+}
+
+int32_t tqNextBlock(STqReader* pReader, SSDataBlock* pBlock) {
+  while (1) {
+    if (pReader->msg2.msgStr == NULL && tqReaderNextSubmitMsg(pReader) < 0) {
+      return FETCH_TYPE__NONE;
     }
 
     while (tqNextBlockImpl(pReader)) {
@@ -354,6 +408,14 @@ int32_t tqReaderSetSubmitMsg(STqReader* pReader, void* msgStr, int32_t msgLen, i
   pReader->msg2.ver = ver;
 
   tqDebug("tq reader set msg %p %d", msgStr, msgLen);
+  STQ* pTq = pReader->pVnode != NULL ? pReader->pVnode->pTq : NULL;
+  if (pTq != NULL) {
+    pReader->pCachedSubmit = tqDecodeCacheAcquire(pTq, msgStr, msgLen, ver, &pReader->submit);
+    if (pReader->pCachedSubmit != NULL) {
+      return 0;
+    }
+  }
+
   SDecoder decoder;
   tDecoderInit(&decoder, pReader->msg2.msgStr, pReader->msg2.msgLen);
   if (tDecodeSSubmitReq2(&decoder, &pReader->submit) < 0) {
@@ -391,7 +453,7 @@ bool tqNextBlockImpl(STqReader* pReader) {
     pReader->nextBlk++;
   }
 
-  tDestroySSubmitReq(&pReader->submit, TSDB_MSG_FLG_DECODE);
+  tqReaderClearSubmit(pReader);
   pReader->nextBlk = 0;
   pReader->msg2.msgStr = NULL;
 
@@ -413,7 +475,7 @@ bool tqNextDataBlockFilterOut(STqReader* pReader, SHashObj* filterOutUids) {
     pReader->nextBlk++;
   }
 
-  tDestroySSubmitReq(&pReader->submit, TSDB_MSG_FLG_DECODE);
+  tqReaderClearSubmit(pReader);
   pReader->nextBlk = 0;
   pReader->msg2.msgStr = NULL;
 
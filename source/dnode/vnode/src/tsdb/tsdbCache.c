@@ -32,6 +32,36 @@ _err:
   return code;
 }
 
+static int32_t tsdbOpenPgCache(STsdb *pTsdb) {
+  int32_t    code = 0;
+  SLRUCache *pCache = NULL;
+
+  if (tsTsdbPageCacheSize <= 0) goto _err;
+
+  pCache = taosLRUCacheInit((size_t)tsTsdbPageCacheSize * 1024 * 1024, 2, .5);
+  if (pCache == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, true);
+
+_err:
+  pTsdb->pgCache = pCache;
+  return code;
+}
+
+static void tsdbClosePgCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->pgCache;
+  if (pCache) {
+    taosLRUCacheEraseUnrefEntries(pCache);
+
+    taosLRUCacheCleanup(pCache);
+
+    pTsdb->pgCache = NULL;
+  }
+}
+
 static void tsdbCloseBICache(STsdb *pTsdb) {
   SLRUCache *pCache = pTsdb->biCache;
   if (pCache) {
@@ -64,6 +94,12 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
     goto _err;
   }
 
+  code = tsdbOpenPgCache(pTsdb);
+  if (code != TSDB_CODE_SUCCESS) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
   taosLRUCacheSetStrictCapacity(pCache, false);
 
   taosThreadMutexInit(&pTsdb->lruMutex, NULL);
@@ -84,6 +120,7 @@ void tsdbCloseCache(STsdb *pTsdb) {
   }
 
   tsdbCloseBICache(pTsdb);
+  tsdbClosePgCache(pTsdb);
 }
 
 static void getTableCacheKey(tb_uid_t uid, int cacheType, char *key, int *len) {
@@ -1962,3 +1999,86 @@ int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h) {
 
   return code;
 }
+
+int64_t tsdbPageCacheGetHits(SVnode *pVnode) {
+  int64_t hits = 0;
+  if (pVnode->pTsdb != NULL) {
+    hits = atomic_load_64(&pVnode->pTsdb->pgCacheHit);
+  }
+
+  return hits;
+}
+
+int64_t tsdbPageCacheGetMisses(SVnode *pVnode) {
+  int64_t misses = 0;
+  if (pVnode->pTsdb != NULL) {
+    misses = atomic_load_64(&pVnode->pTsdb->pgCacheMiss);
+  }
+
+  return misses;
+}
+
+// files are never rewritten in place except that data/sma files may be appended to by later commits, which may fill
+// up their last page. So the logic file size of the reader is a part of the key of the last page only.
+static void getPgCacheKey(STsdbFD *pFD, int64_t pgno, char *key, int *len) {
+  int64_t lSize = 0;
+  if (pFD->lSize > 0 && pgno == OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(pFD->lSize - 1, pFD->szPage), pFD->szPage)) {
+    lSize = pFD->lSize;
+  }
+
+  int32_t pathLen = strlen(pFD->path);
+  memcpy(key, &pgno, sizeof(pgno));
+  memcpy(key + sizeof(pgno), &lSize, sizeof(lSize));
+  memcpy(key + sizeof(pgno) + sizeof(lSize), pFD->path, pathLen);
+
+  *len = sizeof(pgno) + sizeof(lSize) + pathLen;
+}
+
+static void deletePgCache(const void *key, size_t keyLen, void *value) { taosMemoryFree(value); }
+
+bool tsdbCacheGetPage(STsdbFD *pFD, int64_t pgno) {
+  SLRUCache *pCache = pFD->pTsdb->pgCache;
+  char       key[sizeof(int64_t) * 2 + TSDB_FILENAME_LEN];
+  int        keyLen = 0;
+
+  tsdbCacheReleasePage(pFD);
+
+  // the checksum of a page is verified when it is read from the file before it is cached, and not again on a hit:
+  // checking it here would cost a CRC of the whole page on every read, which is the work the cache saves
+  getPgCacheKey(pFD, pgno, key, &keyLen);
+  LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
+  if (h == NULL) {
+    atomic_add_fetch_64(&pFD->pTsdb->pgCacheMiss, 1);
+    return false;
+  }
+
+  // the page is read in place and kept referenced, so it is not freed if it is evicted while the reader is on it
+  pFD->pgHandle = h;
+  pFD->pPage = taosLRUCacheValue(pCache, h);
+
+  atomic_add_fetch_64(&pFD->pTsdb->pgCacheHit, 1);
+  return true;
+}
+
+void tsdbCacheReleasePage(STsdbFD *pFD) {
+  if (pFD->pgHandle == NULL) return;
+
+  taosLRUCacheRelease(pFD->pTsdb->pgCache, pFD->pgHandle, false);
+  pFD->pgHandle = NULL;
+  pFD->pPage = pFD->pBuf;
+  pFD->pgno = 0;
+}
+
+void tsdbCachePutPage(STsdbFD *pFD, int64_t pgno) {
+  SLRUCache *pCache = pFD->pTsdb->pgCache;
+  char       key[sizeof(int64_t) * 2 + TSDB_FILENAME_LEN];
+  int        keyLen = 0;
+
+  uint8_t *pPage = taosMemoryMalloc(pFD->szPage);
+  if (pPage == NULL) return;
+  memcpy(pPage, pFD->pBuf, pFD->szPage);
+
+  // the page is freed by the deleter if it can not be cached
+  getPgCacheKey(pFD, pgno, key, &keyLen);
+  taosLRUCacheInsert(pCache, key, keyLen, pPage, pFD->szPage, deletePgCache, NULL, pFD->pgPri);
+}
@@ -688,7 +688,7 @@ int32_t tGnrtDiskData(SDiskDataBuilder *pBuilder, const SDiskData **ppDiskData,
       return code;
     }
 
-    pDiskData->hdr.szBlkCol += tPutBlockCol(NULL, &dCol.bCol);
+    pDiskData->hdr.szBlkCol += tPutBlockCol(NULL, &dCol.bCol, pDiskData->hdr.fmtVer);
   }
 
   *ppDiskData = pDiskData;
@@ -16,13 +16,25 @@
 #include "tsdb.h"
 
 // =================================================================================================
+// the meta is written in the new version only if an stt file needs it, so older versions can still read the others
+static int8_t tsdbFSVer(STsdbFS *pFS) {
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(pFS->aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pFS->aDFileSet, iSet);
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      if (pSet->aSttF[iStt]->fmtVer >= 1) return TSDB_FS_VER;
+    }
+  }
+  return 0;
+}
+
 static int32_t tsdbFSToBinary(uint8_t *p, STsdbFS *pFS) {
   int32_t  n = 0;
   int8_t   hasDel = pFS->pDelFile ? 1 : 0;
   uint32_t nSet = taosArrayGetSize(pFS->aDFileSet);
+  int8_t   fsVer = tsdbFSVer(pFS);
 
   // version
-  n += tPutI8(p ? p + n : p, 0);
+  n += tPutI8(p ? p + n : p, fsVer);
 
   // SDelFile
   n += tPutI8(p ? p + n : p, hasDel);
@@ -33,7 +45,7 @@ static int32_t tsdbFSToBinary(uint8_t *p, STsdbFS *pFS) {
   // SArray<SDFileSet>
   n += tPutU32v(p ? p + n : p, nSet);
   for (uint32_t iSet = 0; iSet < nSet; iSet++) {
-    n += tPutDFileSet(p ? p + n : p, (SDFileSet *)taosArrayGet(pFS->aDFileSet, iSet));
+    n += tPutDFileSet(p ? p + n : p, (SDFileSet *)taosArrayGet(pFS->aDFileSet, iSet), fsVer);
   }
 
   return n;
@@ -44,7 +56,8 @@ static int32_t tsdbBinaryToFS(uint8_t *pData, int64_t nData, STsdbFS *pFS) {
   int32_t n = 0;
 
   // version
-  n += tGetI8(pData + n, NULL);
+  int8_t fsVer = 0;
+  n += tGetI8(pData + n, &fsVer);
 
   // SDelFile
   int8_t hasDel = 0;
@@ -69,7 +82,7 @@ static int32_t tsdbBinaryToFS(uint8_t *pData, int64_t nData, STsdbFS *pFS) {
   for (uint32_t iSet = 0; iSet < nSet; iSet++) {
     SDFileSet fSet = {0};
 
-    int32_t nt = tGetDFileSet(pData + n, &fSet);
+    int32_t nt = tGetDFileSet(pData + n, &fSet, fsVer);
     if (nt < 0) {
       code = TSDB_CODE_OUT_OF_MEMORY;
       goto _exit;
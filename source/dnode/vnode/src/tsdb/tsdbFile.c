@@ -53,22 +53,32 @@ static int32_t tGetDataFile(uint8_t *p, SDataFile *pDataFile) {
   return n;
 }
 
-int32_t tPutSttFile(uint8_t *p, SSttFile *pSttFile) {
+int32_t tPutSttFile(uint8_t *p, SSttFile *pSttFile, int8_t fsVer) {
   int32_t n = 0;
 
   n += tPutI64v(p ? p + n : p, pSttFile->commitID);
   n += tPutI64v(p ? p + n : p, pSttFile->size);
   n += tPutI64v(p ? p + n : p, pSttFile->offset);
+  if (fsVer >= 1) {
+    n += tPutI8(p ? p + n : p, pSttFile->fmtVer);
+  } else {
+    ASSERT(pSttFile->fmtVer == 0);
+  }
 
   return n;
 }
 
-static int32_t tGetSttFile(uint8_t *p, SSttFile *pSttFile) {
+static int32_t tGetSttFile(uint8_t *p, SSttFile *pSttFile, int8_t fsVer) {
   int32_t n = 0;
 
   n += tGetI64v(p + n, &pSttFile->commitID);
   n += tGetI64v(p + n, &pSttFile->size);
   n += tGetI64v(p + n, &pSttFile->offset);
+  if (fsVer >= 1) {
+    n += tGetI8(p + n, &pSttFile->fmtVer);
+  } else {
+    pSttFile->fmtVer = 0;
+  }
 
   return n;
 }
@@ -214,7 +224,7 @@ _err:
   return code;
 }
 
-int32_t tPutDFileSet(uint8_t *p, SDFileSet *pSet) {
+int32_t tPutDFileSet(uint8_t *p, SDFileSet *pSet, int8_t fsVer) {
   int32_t n = 0;
 
   n += tPutI32v(p ? p + n : p, pSet->diskId.level);
@@ -229,13 +239,13 @@ int32_t tPutDFileSet(uint8_t *p, SDFileSet *pSet) {
   // stt
   n += tPutU8(p ? p + n : p, pSet->nSttF);
   for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
-    n += tPutSttFile(p ? p + n : p, pSet->aSttF[iStt]);
+    n += tPutSttFile(p ? p + n : p, pSet->aSttF[iStt], fsVer);
   }
 
   return n;
 }
 
-int32_t tGetDFileSet(uint8_t *p, SDFileSet *pSet) {
+int32_t tGetDFileSet(uint8_t *p, SDFileSet *pSet, int8_t fsVer) {
   int32_t n = 0;
 
   n += tGetI32v(p + n, &pSet->diskId.level);
@@ -274,7 +284,7 @@ int32_t tGetDFileSet(uint8_t *p, SDFileSet *pSet) {
       return -1;
     }
     pSet->aSttF[iStt]->nRef = 1;
-    n += tGetSttFile(p + n, pSet->aSttF[iStt]);
+    n += tGetSttFile(p + n, pSet->aSttF[iStt], fsVer);
   }
 
   return n;
@@ -31,13 +31,41 @@
 #define SL_MOVE_BACKWARD 0x1
 #define SL_MOVE_FROM_POS 0x2
 
+#define AL_CHUNK_MIN_ROWS 16
+#define AL_CHUNK_MAX_ROWS 4096
+// aTSKEY + aVersion + aData + aIRow + aFlag
+#define AL_CHUNK_SIZE(n) (sizeof(SMemAppendChunk) + (n) * (sizeof(TSKEY) + sizeof(int64_t) + sizeof(void *) + 5))
+#define AL_CHUNK_KEY(c, i) ((TSDBKEY){.version = (c)->aVersion[i], .ts = (c)->aTSKEY[i]})
+
 static void    tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *pKey, int32_t flags);
+static void    tbDataMoveChunkTo(STbData *pTbData, TSDBKEY *pKey, int8_t backward, STbDataIter *pIter);
+static bool    tbDataCanAppend(STbData *pTbData, TSDBKEY *pKey);
+static int32_t tbDataAppend(SMemTable *pMemTable, STbData *pTbData, TSDBROW *pRow, TSDBKEY *pKey);
 static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid, STbData **ppTbData);
 static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
 
+// different tables of one memtable may be written by several threads, so the shared statistics are kept atomically
+static FORCE_INLINE void tsdbAtomicMin64(int64_t volatile *ptr, int64_t val) {
+  int64_t old = atomic_load_64(ptr);
+  while (val < old) {
+    int64_t cur = atomic_val_compare_exchange_64(ptr, old, val);
+    if (cur == old) break;
+    old = cur;
+  }
+}
+
+static FORCE_INLINE void tsdbAtomicMax64(int64_t volatile *ptr, int64_t val) {
+  int64_t old = atomic_load_64(ptr);
+  while (val > old) {
+    int64_t cur = atomic_val_compare_exchange_64(ptr, old, val);
+    if (cur == old) break;
+    old = cur;
+  }
+}
+
 int32_t tsdbMemTableCreate(STsdb *pTsdb, SMemTable **ppMemTable) {
   int32_t    code = 0;
   SMemTable *pMemTable = NULL;
@@ -126,8 +154,8 @@ int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitTbData *pSubmi
   if (code) goto _err;
 
   // update
-  pMemTable->minVer = TMIN(pMemTable->minVer, version);
-  pMemTable->maxVer = TMAX(pMemTable->maxVer, version);
+  tsdbAtomicMin64(&pMemTable->minVer, version);
+  tsdbAtomicMax64(&pMemTable->maxVer, version);
 
   return code;
 
@@ -234,13 +262,18 @@ void tsdbTbDataIterOpen(STbData *pTbData, TSDBKEY *pFrom, int8_t backward, STbDa
   pTail = pTbData->sl.pTail;
   pIter->pTbData = pTbData;
   pIter->backward = backward;
+  pIter->inChunk = 0;
   pIter->pRow = NULL;
   if (pFrom == NULL) {
     // create from head or tail
     if (backward) {
       pIter->pNode = SL_GET_NODE_BACKWARD(pTbData->sl.pTail, 0);
+      pIter->pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->al.pTail);
+      pIter->iChunkRow = pIter->pChunk ? atomic_load_32(&pIter->pChunk->nRow) - 1 : -1;
     } else {
       pIter->pNode = SL_GET_NODE_FORWARD(pTbData->sl.pHead, 0);
+      pIter->pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->al.pHead);
+      pIter->iChunkRow = 0;
     }
   } else {
     // create from a key
@@ -251,41 +284,31 @@ void tsdbTbDataIterOpen(STbData *pTbData, TSDBKEY *pFrom, int8_t backward, STbDa
       tbDataMovePosTo(pTbData, pos, pFrom, 0);
       pIter->pNode = SL_GET_NODE_FORWARD(pos[0], 0);
     }
+    tbDataMoveChunkTo(pTbData, pFrom, backward, pIter);
   }
 }
 
 bool tsdbTbDataIterNext(STbDataIter *pIter) {
-  pIter->pRow = NULL;
-  if (pIter->backward) {
-    ASSERT(pIter->pNode != pIter->pTbData->sl.pTail);
-
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return false;
-    }
+  // decide which of the skiplist and the append list holds the current row
+  if (tsdbTbDataIterGet(pIter) == NULL) {
+    return false;
+  }
 
+  pIter->pRow = NULL;
+  if (pIter->inChunk) {
+    pIter->iChunkRow += (pIter->backward ? -1 : 1);
+  } else if (pIter->backward) {
     pIter->pNode = SL_GET_NODE_BACKWARD(pIter->pNode, 0);
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return false;
-    }
   } else {
-    ASSERT(pIter->pNode != pIter->pTbData->sl.pHead);
-
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return false;
-    }
-
     pIter->pNode = SL_GET_NODE_FORWARD(pIter->pNode, 0);
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return false;
-    }
   }
 
-  return true;
+  return tsdbTbDataIterGet(pIter) != NULL;
 }
 
 int64_t tsdbCountTbDataRows(STbData *pTbData) {
   SMemSkipListNode *pNode = pTbData->sl.pHead;
-  int64_t rowsNum = 0;
+  int64_t rowsNum = atomic_load_64(&pTbData->al.size);
   
   while (NULL != pNode) {
     pNode = SL_GET_NODE_FORWARD(pNode, 0);
@@ -353,7 +376,9 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   int32_t code = 0;
 
   // get
+  taosRLockLatch(&pMemTable->latch);
   STbData *pTbData = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
+  taosRUnLockLatch(&pMemTable->latch);
   if (pTbData) goto _exit;
 
   // create
@@ -380,6 +405,9 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   pTbData->sl.pTail = (SMemSkipListNode *)POINTER_SHIFT(pTbData->sl.pHead, SL_NODE_SIZE(maxLevel));
   pTbData->sl.pHead->level = maxLevel;
   pTbData->sl.pTail->level = maxLevel;
+  pTbData->al.size = 0;
+  pTbData->al.pHead = NULL;
+  pTbData->al.pTail = NULL;
   for (int8_t iLevel = 0; iLevel < maxLevel; iLevel++) {
     SL_NODE_FORWARD(pTbData->sl.pHead, iLevel) = pTbData->sl.pTail;
     SL_NODE_BACKWARD(pTbData->sl.pTail, iLevel) = pTbData->sl.pHead;
@@ -388,22 +416,39 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
     SL_NODE_FORWARD(pTbData->sl.pTail, iLevel) = NULL;
   }
 
-  taosWLockLatch(&pMemTable->latch);
-
-  if (pMemTable->nTbData >= pMemTable->nBucket) {
-    code = tsdbMemTableRehash(pMemTable);
-    if (code) {
-      taosWUnLockLatch(&pMemTable->latch);
-      goto _err;
+  if (atomic_load_32(&pMemTable->nTbData) >= pMemTable->nBucket) {
+    taosWLockLatch(&pMemTable->latch);
+    if (pMemTable->nTbData >= pMemTable->nBucket) {
+      code = tsdbMemTableRehash(pMemTable);
     }
+    taosWUnLockLatch(&pMemTable->latch);
+    if (code) goto _err;
+  }
+
+  // publish to the bucket lock-free, the read latch only keeps the bucket array from being rehashed meanwhile
+  taosRLockLatch(&pMemTable->latch);
+
+  STbData **ppBucket = &pMemTable->aBucket[TABS(uid) % pMemTable->nBucket];
+  STbData  *pHead = NULL;
+  STbData  *pExist = NULL;
+  for (;;) {
+    pHead = (STbData *)atomic_load_ptr(ppBucket);
+    for (pExist = pHead; pExist && pExist->uid != uid; pExist = pExist->next)
+      ;
+    if (pExist) break;
+
+    pTbData->next = pHead;
+    if (atomic_val_compare_exchange_ptr(ppBucket, pHead, pTbData) == pHead) break;
   }
 
-  int32_t idx = TABS(uid) % pMemTable->nBucket;
-  pTbData->next = pMemTable->aBucket[idx];
-  pMemTable->aBucket[idx] = pTbData;
-  pMemTable->nTbData++;
+  if (pExist) {
+    // another writer created the same table first, the allocated one is left to the buffer pool
+    pTbData = pExist;
+  } else {
+    atomic_add_fetch_32(&pMemTable->nTbData, 1);
+  }
 
-  taosWUnLockLatch(&pMemTable->latch);
+  taosRUnLockLatch(&pMemTable->latch);
 
 _exit:
   *ppTbData = pTbData;
@@ -583,6 +628,153 @@ _exit:
   return code;
 }
 
+static void tbDataMoveChunkTo(STbData *pTbData, TSDBKEY *pKey, int8_t backward, STbDataIter *pIter) {
+  SMemAppendChunk *pChunk;
+  int32_t          nRow;
+  int32_t          lidx;
+  int32_t          ridx;
+
+  if (backward) {
+    // find the last row with key <= pKey
+    pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->al.pTail);
+    nRow = pChunk ? atomic_load_32(&pChunk->nRow) : 0;
+    while (pChunk && nRow > 0) {
+      TSDBKEY tKey = AL_CHUNK_KEY(pChunk, 0);
+      if (tsdbKeyCmprFn(&tKey, pKey) <= 0) break;
+
+      pChunk = pChunk->pPrev;
+      nRow = pChunk ? pChunk->nRow : 0;
+    }
+
+    pIter->pChunk = pChunk;
+    pIter->iChunkRow = -1;
+    if (pChunk == NULL || nRow == 0) return;
+
+    lidx = 0;
+    ridx = nRow - 1;
+    while (lidx <= ridx) {
+      int32_t mid = (lidx + ridx) >> 1;
+      TSDBKEY tKey = AL_CHUNK_KEY(pChunk, mid);
+      if (tsdbKeyCmprFn(&tKey, pKey) <= 0) {
+        pIter->iChunkRow = mid;
+        lidx = mid + 1;
+      } else {
+        ridx = mid - 1;
+      }
+    }
+  } else {
+    // find the first row with key >= pKey
+    pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->al.pHead);
+    pIter->pChunk = pChunk;
+    pIter->iChunkRow = 0;
+    while (pChunk) {
+      nRow = atomic_load_32(&pChunk->nRow);
+      pIter->pChunk = pChunk;
+      pIter->iChunkRow = nRow;
+      if (nRow > 0) {
+        TSDBKEY tKey = AL_CHUNK_KEY(pChunk, nRow - 1);
+        if (tsdbKeyCmprFn(&tKey, pKey) >= 0) break;
+      }
+
+      pChunk = (SMemAppendChunk *)atomic_load_ptr(&pChunk->pNext);
+    }
+    if (pChunk == NULL) return;
+
+    lidx = 0;
+    ridx = nRow - 1;
+    while (lidx <= ridx) {
+      int32_t mid = (lidx + ridx) >> 1;
+      TSDBKEY tKey = AL_CHUNK_KEY(pChunk, mid);
+      if (tsdbKeyCmprFn(&tKey, pKey) >= 0) {
+        pIter->iChunkRow = mid;
+        ridx = mid - 1;
+      } else {
+        lidx = mid + 1;
+      }
+    }
+  }
+}
+
+static FORCE_INLINE bool tbDataCanAppend(STbData *pTbData, TSDBKEY *pKey) {
+  SMemAppendChunk *pChunk = pTbData->al.pTail;
+
+  if (pChunk == NULL) return true;
+
+  TSDBKEY tKey = AL_CHUNK_KEY(pChunk, pChunk->nRow - 1);
+  return tsdbKeyCmprFn(pKey, &tKey) > 0;
+}
+
+static int32_t tbDataAppend(SMemTable *pMemTable, STbData *pTbData, TSDBROW *pRow, TSDBKEY *pKey) {
+  int32_t          code = 0;
+  SVBufPool       *pPool = pMemTable->pTsdb->pVnode->inUse;
+  SMemAppendChunk *pChunk = pTbData->al.pTail;
+  void            *pData = NULL;
+  int32_t          iRow = 0;
+
+  if (pRow->type == TSDBROW_ROW_FMT) {
+    pData = vnodeBufPoolMallocAligned(pPool, pRow->pTSRow->len);
+    if (pData == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    memcpy(pData, pRow->pTSRow, pRow->pTSRow->len);
+  } else if (pRow->type == TSDBROW_COL_FMT) {
+    pData = pRow->pBlockData;
+    iRow = pRow->iRow;
+  } else {
+    ASSERT(0);
+  }
+
+  // create chunk, the capacity grows geometrically so tables with few rows waste little memory
+  if (pChunk == NULL || pChunk->nRow >= pChunk->nCap) {
+    int32_t nCap = pChunk ? TMIN(pChunk->nCap << 1, AL_CHUNK_MAX_ROWS) : AL_CHUNK_MIN_ROWS;
+
+    SMemAppendChunk *pNew = (SMemAppendChunk *)vnodeBufPoolMallocAligned(pPool, AL_CHUNK_SIZE(nCap));
+    if (pNew == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+
+    pNew->pNext = NULL;
+    pNew->pPrev = pChunk;
+    pNew->nCap = nCap;
+    pNew->nRow = 0;
+    pNew->aTSKEY = (TSKEY *)&pNew[1];
+    pNew->aVersion = (int64_t *)&pNew->aTSKEY[nCap];
+    pNew->aData = (void **)&pNew->aVersion[nCap];
+    pNew->aIRow = (int32_t *)&pNew->aData[nCap];
+    pNew->aFlag = (int8_t *)&pNew->aIRow[nCap];
+
+    // set the row before publishing the chunk, readers may walk the list concurrently
+    pNew->aTSKEY[0] = pKey->ts;
+    pNew->aVersion[0] = pKey->version;
+    pNew->aData[0] = pData;
+    pNew->aIRow[0] = iRow;
+    pNew->aFlag[0] = pRow->type;
+    pNew->nRow = 1;
+
+    if (pChunk) {
+      atomic_store_ptr(&pChunk->pNext, pNew);
+    } else {
+      atomic_store_ptr(&pTbData->al.pHead, pNew);
+    }
+    atomic_store_ptr(&pTbData->al.pTail, pNew);
+  } else {
+    int32_t nRow = pChunk->nRow;
+
+    pChunk->aTSKEY[nRow] = pKey->ts;
+    pChunk->aVersion[nRow] = pKey->version;
+    pChunk->aData[nRow] = pData;
+    pChunk->aIRow[nRow] = iRow;
+    pChunk->aFlag[nRow] = pRow->type;
+    atomic_store_32(&pChunk->nRow, nRow + 1);
+  }
+  atomic_add_fetch_64(&pTbData->al.size, 1);
+
+_exit:
+  return code;
+}
+
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
   int32_t code = 0;
@@ -634,37 +826,47 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
     if (code) goto _exit;
   }
 
-  // loop to add each row to the skiplist
+  // rows are sorted in the block, so the leading rows not after the append list go to the skiplist and the
+  // rest are appended
   SMemSkipListNode *pos[SL_MAX_LEVEL];
   TSDBROW           tRow = tsdbRowFromBlockData(pBlockData, 0);
   TSDBKEY           key = {.version = version, .ts = pBlockData->aTSKEY[0]};
   TSDBROW           lRow;  // last row
 
-  // first row
-  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0))) goto _exit;
   pTbData->minKey = TMIN(pTbData->minKey, key.ts);
-  lRow = tRow;
 
-  // remain row
-  ++tRow.iRow;
-  if (tRow.iRow < pBlockData->nRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
-    }
+  while (tRow.iRow < pBlockData->nRow) {
+    key.ts = pBlockData->aTSKEY[tRow.iRow];
+    if (tbDataCanAppend(pTbData, &key)) break;
 
-    while (tRow.iRow < pBlockData->nRow) {
-      key.ts = pBlockData->aTSKEY[tRow.iRow];
+    if (tRow.iRow == 0) {
+      // first row
+      tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
+      if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0))) goto _exit;
 
+      for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+        pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
+      }
+    } else {
+      // remain row
       if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
         tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
       }
 
       if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1))) goto _exit;
-      lRow = tRow;
-
-      ++tRow.iRow;
     }
+    lRow = tRow;
+
+    ++tRow.iRow;
+  }
+
+  while (tRow.iRow < pBlockData->nRow) {
+    key.ts = pBlockData->aTSKEY[tRow.iRow];
+
+    if ((code = tbDataAppend(pMemTable, pTbData, &tRow, &key))) goto _exit;
+    lRow = tRow;
+
+    ++tRow.iRow;
   }
 
   if (key.ts >= pTbData->maxKey) {
@@ -680,9 +882,9 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
   }
 
   // SMemTable
-  pMemTable->minKey = TMIN(pMemTable->minKey, pTbData->minKey);
-  pMemTable->maxKey = TMAX(pMemTable->maxKey, pTbData->maxKey);
-  pMemTable->nRow += pBlockData->nRow;
+  tsdbAtomicMin64(&pMemTable->minKey, pTbData->minKey);
+  tsdbAtomicMax64(&pMemTable->maxKey, pTbData->maxKey);
+  atomic_add_fetch_64(&pMemTable->nRow, pBlockData->nRow);
 
   if (affectedRows) *affectedRows = pBlockData->nRow;
 
@@ -702,37 +904,47 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
   int32_t           iRow = 0;
   TSDBROW           lRow;
 
-  // backward put first data
-  tRow.pTSRow = aRow[iRow++];
-  key.ts = tRow.pTSRow->ts;
-  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0);
-  if (code) goto _exit;
-  lRow = tRow;
-
-  pTbData->minKey = TMIN(pTbData->minKey, key.ts);
+  pTbData->minKey = TMIN(pTbData->minKey, aRow[0]->ts);
 
-  // forward put rest data
-  if (iRow < nRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
-    }
+  // out-of-order rows go to the skiplist
+  while (iRow < nRow) {
+    tRow.pTSRow = aRow[iRow];
+    key.ts = tRow.pTSRow->ts;
+    if (tbDataCanAppend(pTbData, &key)) break;
 
-    while (iRow < nRow) {
-      tRow.pTSRow = aRow[iRow];
-      key.ts = tRow.pTSRow->ts;
+    if (iRow == 0) {
+      // backward put first data
+      tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
+      code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0);
+      if (code) goto _exit;
 
+      for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+        pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
+      }
+    } else {
+      // forward put rest data
       if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
         tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
       }
 
       code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1);
       if (code) goto _exit;
+    }
+    lRow = tRow;
 
-      lRow = tRow;
+    iRow++;
+  }
 
-      iRow++;
-    }
+  // in-order rows are appended
+  while (iRow < nRow) {
+    tRow.pTSRow = aRow[iRow];
+    key.ts = tRow.pTSRow->ts;
+
+    code = tbDataAppend(pMemTable, pTbData, &tRow, &key);
+    if (code) goto _exit;
+    lRow = tRow;
+
+    iRow++;
   }
 
   if (key.ts >= pTbData->maxKey) {
@@ -748,9 +960,9 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
   }
 
   // SMemTable
-  pMemTable->minKey = TMIN(pMemTable->minKey, pTbData->minKey);
-  pMemTable->maxKey = TMAX(pMemTable->maxKey, pTbData->maxKey);
-  pMemTable->nRow += nRow;
+  tsdbAtomicMin64(&pMemTable->minKey, pTbData->minKey);
+  tsdbAtomicMax64(&pMemTable->maxKey, pTbData->maxKey);
+  atomic_add_fetch_64(&pMemTable->nRow, nRow);
 
   if (affectedRows) *affectedRows = nRow;
 
@@ -758,7 +970,7 @@ _exit:
   return code;
 }
 
-int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size; }
+int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size + pTbData->al.size; }
 
 int32_t tsdbRefMemTable(SMemTable *pMemTable, SQueryNode *pQNode) {
   int32_t code = 0;
@@ -42,6 +42,8 @@ SSttBlockLoadInfo *tCreateLastBlockLoadInfo(STSchema *pSchema, int16_t *colList,
     }
 
     pLoadInfo[i].aSttBlk = taosArrayInit(4, sizeof(SSttBlk));
+    pLoadInfo[i].aFilterOut = taosArrayInit(4, sizeof(int8_t));
+    pLoadInfo[i].aColAgg = taosArrayInit(4, sizeof(SColumnDataAgg));
     pLoadInfo[i].pSchema = pSchema;
     pLoadInfo[i].colIds = colList;
     pLoadInfo[i].numOfCols = numOfCols;
@@ -57,6 +59,7 @@ void resetLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo) {
     pLoadInfo[i].blockIndex[1] = -1;
 
     taosArrayClear(pLoadInfo[i].aSttBlk);
+    taosArrayClear(pLoadInfo[i].aFilterOut);
 
     pLoadInfo[i].elapsedTime = 0;
     pLoadInfo[i].loadBlocks = 0;
@@ -85,6 +88,8 @@ void *destroyLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo) {
     tBlockDataDestroy(&pLoadInfo[i].blockData[1]);
 
     taosArrayDestroy(pLoadInfo[i].aSttBlk);
+    taosArrayDestroy(pLoadInfo[i].aFilterOut);
+    taosArrayDestroy(pLoadInfo[i].aColAgg);
   }
 
   taosMemoryFree(pLoadInfo);
@@ -316,6 +321,11 @@ int32_t tLDataIterOpen(struct SLDataIter *pIter, SDataFReader *pReader, int32_t
       }
     }
 
+    taosArrayClear(pBlockLoadInfo->aFilterOut);
+    if (taosArrayReserve(pBlockLoadInfo->aFilterOut, taosArrayGetSize(pBlockLoadInfo->aSttBlk)) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
     double el = (taosGetTimestampUs() - st) / 1000.0;
     tsdbDebug("load the last file info completed, elapsed time:%.2fms, %s", el, idStr);
   }
@@ -345,6 +355,59 @@ int32_t tLDataIterOpen(struct SLDataIter *pIter, SDataFReader *pReader, int32_t
 
 void tLDataIterClose(SLDataIter *pIter) { /*taosMemoryFree(pIter); */}
 
+// check the zone maps of the stt block against the filter, the result is kept for the other tables in the block
+static bool isSttBlockFilteredOut(SLDataIter *pIter, int32_t iSttBlk, const char *idStr) {
+  SSttBlockLoadInfo *pInfo = pIter->pBlockLoadInfo;
+  SSttBlk           *p = taosArrayGet(pInfo->aSttBlk, iSttBlk);
+  int8_t            *pRes = taosArrayGet(pInfo->aFilterOut, iSttBlk);
+
+  if (p->smaInfo.size <= 0 || pRes == NULL) {
+    return false;
+  }
+
+  // rows of the same key may also exist in the data file, the buffer, or the neighbor blocks of the same stt file
+  if (p->minKey <= pInfo->dataWin.ekey && p->maxKey >= pInfo->dataWin.skey) {
+    return false;
+  }
+
+  for (int32_t i = iSttBlk - 1; i <= iSttBlk + 1; i += 2) {
+    SSttBlk *q = taosArrayGet(pInfo->aSttBlk, i);
+    if (q != NULL && q->minUid <= pIter->uid && q->maxUid >= pIter->uid && q->minKey <= p->maxKey &&
+        q->maxKey >= p->minKey) {
+      return false;
+    }
+  }
+
+  if (*pRes == 0) {
+    *pRes = 1;
+
+    int32_t code = tsdbReadSttBlockSma(pIter->pReader, pIter->iStt, p, pInfo->aColAgg);
+    if (code != TSDB_CODE_SUCCESS) {
+      return false;
+    }
+
+    int32_t          numOfCols = taosArrayGetSize(pInfo->aColAgg);
+    SColumnDataAgg **pColsAgg = taosMemoryMalloc(POINTER_BYTES * numOfCols);
+    if (pColsAgg == NULL) {
+      return false;
+    }
+
+    for (int32_t i = 0; i < numOfCols; ++i) {
+      pColsAgg[i] = taosArrayGet(pInfo->aColAgg, i);
+    }
+
+    if (!filterRangeExecute(pInfo->pFilterInfo, pColsAgg, numOfCols, p->nRow)) {
+      *pRes = 2;
+      tsdbDebug("last block:%d ruled out by zone maps, rows:%d, file index:%d, %s", iSttBlk, p->nRow, pIter->iStt,
+                idStr);
+    }
+
+    taosMemoryFree(pColsAgg);
+  }
+
+  return *pRes == 2;
+}
+
 void tLDataIterNextBlock(SLDataIter *pIter, const char *idStr) {
   int32_t step = pIter->backward ? -1 : 1;
   int32_t oldIndex = pIter->iSttBlk;
@@ -384,6 +447,10 @@ void tLDataIterNextBlock(SLDataIter *pIter, const char *idStr) {
         }
 
         if (p->minVer <= pIter->verRange.maxVer && p->maxVer >= pIter->verRange.minVer) {
+          if (pIter->filterBlock && isSttBlockFilteredOut(pIter, i, idStr)) {
+            continue;
+          }
+
           index = i;
           break;
         }
@@ -587,6 +654,7 @@ int32_t tMergeTreeOpen(SMergeTree *pMTree, int8_t backward, SDataFReader *pFRead
   pMTree->destroyLoadInfo = destroyLoadInfo;
   pMTree->ignoreEarlierTs = false;
 
+  int32_t numOfIters = 0;
   for (int32_t i = 0; i < pFReader->pSet->nSttF; ++i) {  // open all last file
     memset(&pLDataIter[i], 0, sizeof(SLDataIter));
     code = tLDataIterOpen(&pLDataIter[i], pFReader, i, pMTree->backward, suid, uid, pTimeWindow, pVerRange,
@@ -595,12 +663,27 @@ int32_t tMergeTreeOpen(SMergeTree *pMTree, int8_t backward, SDataFReader *pFRead
       goto _end;
     }
 
-    bool hasVal = tLDataIterNextRow(&pLDataIter[i], pMTree->idStr);
+    numOfIters += (pLDataIter[i].pSttBlk != NULL) ? 1 : 0;
+  }
+
+  for (int32_t i = 0; i < pFReader->pSet->nSttF; ++i) {
+    SLDataIter *pIter = &pLDataIter[i];
+
+    // the rows of a table in multiple stt files may have the same keys, so no block is skipped in that case
+    pIter->filterBlock = (numOfIters == 1) && (pIter->pBlockLoadInfo->pFilterInfo != NULL);
+    if (pIter->filterBlock && pIter->pSttBlk != NULL && isSttBlockFilteredOut(pIter, pIter->iSttBlk, pMTree->idStr)) {
+      tLDataIterNextBlock(pIter, pMTree->idStr);
+      if (pIter->pSttBlk != NULL) {
+        pIter->iRow = (pIter->backward) ? pIter->pSttBlk->nRow : -1;
+      }
+    }
+
+    bool hasVal = tLDataIterNextRow(pIter, pMTree->idStr);
     if (hasVal) {
-      tMergeTreeAddIter(pMTree, &pLDataIter[i]);
+      tMergeTreeAddIter(pMTree, pIter);
     } else {
       if (!pMTree->ignoreEarlierTs) {
-        pMTree->ignoreEarlierTs = pLDataIter[i].ignoreEarlierTs;
+        pMTree->ignoreEarlierTs = pIter->ignoreEarlierTs;
       }
     }
   }
@@ -19,6 +19,8 @@
 
 #define ASCENDING_TRAVERSE(o) (o == TSDB_ORDER_ASC)
 #define getCurrentKeyInLastBlock(_r) ((_r)->currentKey)
+#define TSDB_READ_AHEAD_BLOCKS        4
+#define TSDB_FILTER_PROBE_BLOCKS      32
 
 typedef enum {
    READER_STATUS_SUSPEND = 0x1,
@@ -92,6 +94,8 @@ typedef struct SIOCostSummary {
   double  lastBlockLoadTime;
   int64_t composedBlocks;
   double  buildComposedBlockTime;
+  int64_t filterBlocks;
+  int64_t filterOutBlocks;
   double  createScanInfoList;
   //  double  getTbFromMemTime;
   //  double  getTbFromIMemTime;
@@ -106,6 +110,8 @@ typedef struct SBlockLoadSuppInfo {
   int32_t        numOfCols;
   char**         buildBuf;  // build string tmp buffer, todo remove it later after all string format being updated.
   bool           smaValid;  // the sma on all queried columns are activated
+  int16_t*       filterColId;  // the non-primary key columns referred by the pushed down filter, in ascending order
+  int32_t        numOfFilterCols;
 } SBlockLoadSuppInfo;
 
 typedef struct SLastBlockReader {
@@ -135,7 +141,8 @@ typedef struct SFileDataBlockInfo {
 typedef struct SDataBlockIter {
   int32_t    numOfBlocks;
   int32_t    index;
-  SArray*    blockList;  // SArray<SFileDataBlockInfo>
+  int32_t    prefetchIndex;  // the farthest block in access order whose read-ahead has been issued
+  SArray*    blockList;      // SArray<SFileDataBlockInfo>
   int32_t    order;
   SDataBlk   block;  // current SDataBlk data
   SSHashObj* pTableMap;
@@ -217,6 +224,8 @@ struct STsdbReader {
   SBlockInfoBuf      blockInfoBuf;
   EContentData       step;
   STsdbReader*       innerReader[2];
+  SFilterInfo*       pFilterInfo;  // filter pushed down by the table scan, owned by the caller
+  SFilterInfo*       pSttFilter;   // the same filter, checked against the zone maps of the stt blocks
 };
 
 static SFileDataBlockInfo* getCurrentBlockInfo(SDataBlockIter* pBlockIter);
@@ -638,6 +647,7 @@ _err:
 static void resetDataBlockIterator(SDataBlockIter* pIter, int32_t order) {
   pIter->order = order;
   pIter->index = -1;
+  pIter->prefetchIndex = -1;
   pIter->numOfBlocks = 0;
   if (pIter->blockList == NULL) {
     pIter->blockList = taosArrayInit(4, sizeof(SFileDataBlockInfo));
@@ -1392,8 +1402,39 @@ static FORCE_INLINE STSchema* getTableSchemaImpl(STsdbReader* pReader, uint64_t
   return pReader->pSchema;
 }
 
-static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
-                                   uint64_t uid) {
+// issue read-ahead for the next few blocks in the access order, so that their disk reads are in flight while the
+// current block is loaded and decoded.
+static void doPrefetchFileBlocks(STsdbReader* pReader, SDataBlockIter* pBlockIter) {
+  int32_t step = ASCENDING_TRAVERSE(pBlockIter->order) ? 1 : -1;
+  int32_t last = pBlockIter->index + step * TSDB_READ_AHEAD_BLOCKS;
+  int32_t index = pBlockIter->index + step;
+
+  if ((pBlockIter->prefetchIndex - pBlockIter->index) * step > 0) {
+    index = pBlockIter->prefetchIndex + step;
+  }
+
+  for (; (last - index) * step >= 0 && index >= 0 && index < pBlockIter->numOfBlocks; index += step) {
+    SFileDataBlockInfo*  pBlockInfo = taosArrayGet(pBlockIter->blockList, index);
+    STableBlockScanInfo* pScanInfo = getTableBlockScanInfo(pBlockIter->pTableMap, pBlockInfo->uid, pReader->idStr);
+    if (pScanInfo == NULL || pBlockInfo->tbBlockIdx >= taosArrayGetSize(pScanInfo->pBlockList)) {
+      break;
+    }
+
+    SDataBlk     block = {0};
+    SBlockIndex* pIndex = taosArrayGet(pScanInfo->pBlockList, pBlockInfo->tbBlockIdx);
+    tMapDataGetItemByIdx(&pScanInfo->mapData, pIndex->ordinalIndex, &block, tGetDataBlk);
+
+    // read-ahead is only a hint, the block is read synchronously later anyway
+    if (tsdbPrefetchDataBlock(pReader->pFileReader, &block) != TSDB_CODE_SUCCESS) {
+      break;
+    }
+
+    pBlockIter->prefetchIndex = index;
+  }
+}
+
+static int32_t doLoadFileBlockColumns(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
+                                      uint64_t uid, int16_t* aCid, int32_t nCid) {
   int32_t   code = 0;
   STSchema* pSchema = pReader->pSchema;
   int64_t   st = taosGetTimestampUs();
@@ -1408,9 +1449,8 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
     }
   }
 
-  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
-  TABLEID             tid = {.suid = pReader->suid, .uid = uid};
-  code = tBlockDataInit(pBlockData, &tid, pSchema, &pSup->colId[1], pSup->numOfCols - 1);
+  TABLEID tid = {.suid = pReader->suid, .uid = uid};
+  code = tBlockDataInit(pBlockData, &tid, pSchema, aCid, nCid);
   if (code != TSDB_CODE_SUCCESS) {
     return code;
   }
@@ -1419,6 +1459,8 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
 
   SDataBlk* pBlock = getCurrentBlock(pBlockIter);
+  doPrefetchFileBlocks(pReader, pBlockIter);
+
   code = tsdbReadDataBlock(pReader->pFileReader, pBlock, pBlockData);
   if (code != TSDB_CODE_SUCCESS) {
     tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
@@ -1441,6 +1483,12 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
+                                   uint64_t uid) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  return doLoadFileBlockColumns(pReader, pBlockIter, pBlockData, uid, &pSup->colId[1], pSup->numOfCols - 1);
+}
+
 static void cleanupBlockOrderSupporter(SBlockOrderSupporter* pSup) {
   taosMemoryFreeClear(pSup->numOfBlocksPerTable);
   taosMemoryFreeClear(pSup->indexPerTable);
@@ -1569,6 +1617,7 @@ static int32_t initBlockIterator(STsdbReader* pReader, SDataBlockIter* pBlockIte
               pReader, numOfBlocks, (et - st) / 1000.0, pReader->idStr);
 
     pBlockIter->index = asc ? 0 : (numOfBlocks - 1);
+    pBlockIter->prefetchIndex = pBlockIter->index;
     cleanupBlockOrderSupporter(&sup);
     doSetCurrentBlock(pBlockIter, pReader->idStr);
     return TSDB_CODE_SUCCESS;
@@ -1609,6 +1658,7 @@ static int32_t initBlockIterator(STsdbReader* pReader, SDataBlockIter* pBlockIte
   taosMemoryFree(pTree);
 
   pBlockIter->index = asc ? 0 : (numOfBlocks - 1);
+  pBlockIter->prefetchIndex = pBlockIter->index;
   doSetCurrentBlock(pBlockIter, pReader->idStr);
 
   return TSDB_CODE_SUCCESS;
@@ -2600,6 +2650,34 @@ static bool isValidFileBlockRow(SBlockData* pBlockData, SFileBlockDumpInfo* pDum
   return true;
 }
 
+// An stt block ruled out by its zone maps is skipped only if no row of the table in the data file or the buffer falls in
+// its key range, since the skipped rows may hide or be merged with those rows of the same key.
+static void setSttBlockFilter(SLastBlockReader* pLBlockReader, STableBlockScanInfo* pScanInfo, STsdbReader* pReader) {
+  STimeWindow w = {.skey = INT64_MAX, .ekey = INT64_MIN};
+
+  size_t num = taosArrayGetSize(pScanInfo->pBlockList);
+  for (int32_t i = 0; i < num; ++i) {
+    SBlockIndex* pIndex = taosArrayGet(pScanInfo->pBlockList, i);
+    w.skey = TMIN(w.skey, pIndex->window.skey);
+    w.ekey = TMAX(w.ekey, pIndex->window.ekey);
+  }
+
+  SMemTable* pMem[2] = {pReader->pReadSnap->pMem, pReader->pReadSnap->pIMem};
+  for (int32_t i = 0; i < tListLen(pMem); ++i) {
+    STbData* d = (pMem[i] != NULL) ? tsdbGetTbDataFromMemTable(pMem[i], pReader->suid, pScanInfo->uid) : NULL;
+    if (d != NULL) {
+      w.skey = TMIN(w.skey, d->minKey);
+      w.ekey = TMAX(w.ekey, d->maxKey);
+    }
+  }
+
+  int32_t numOfStt = pReader->pTsdb->pVnode->config.sttTrigger;
+  for (int32_t i = 0; i < numOfStt; ++i) {
+    pLBlockReader->pInfo[i].pFilterInfo = pReader->pSttFilter;
+    pLBlockReader->pInfo[i].dataWin = w;
+  }
+}
+
 static bool initLastBlockReader(SLastBlockReader* pLBlockReader, STableBlockScanInfo* pScanInfo, STsdbReader* pReader) {
   // the last block reader has been initialized for this table.
   if (pLBlockReader->uid == pScanInfo->uid) {
@@ -2620,6 +2698,8 @@ static bool initLastBlockReader(SLastBlockReader* pLBlockReader, STableBlockScan
     w.ekey = pScanInfo->lastKeyInStt;
   }
 
+  setSttBlockFilter(pLBlockReader, pScanInfo, pReader);
+
   tsdbDebug("init last block reader, window:%" PRId64 "-%" PRId64 ", uid:%" PRIu64 ", %s", w.skey, w.ekey,
             pScanInfo->uid, pReader->idStr);
   int32_t code = tMergeTreeOpen(&pLBlockReader->mergeTree, (pLBlockReader->order == TSDB_ORDER_DESC),
@@ -4520,6 +4600,7 @@ void tsdbReaderClose(STsdbReader* pReader) {
   }
 
   taosMemoryFree(pSupInfo->colId);
+  taosMemoryFree(pSupInfo->filterColId);
   tBlockDataDestroy(&pReader->status.fileBlockData);
   cleanupDataBlockIterator(&pReader->status.blockIter);
 
@@ -4570,11 +4651,11 @@ void tsdbReaderClose(STsdbReader* pReader) {
       " SMA-time:%.2f ms, fileBlocks:%" PRId64
       ", fileBlocks-load-time:%.2f ms, "
       "build in-memory-block-time:%.2f ms, lastBlocks:%" PRId64 ", lastBlocks-time:%.2f ms, composed-blocks:%" PRId64
-      ", composed-blocks-time:%.2fms, STableBlockScanInfo size:%.2f Kb, createTime:%.2f ms,initDelSkylineIterTime:%.2f "
-      "ms, %s",
+      ", composed-blocks-time:%.2fms, filter-blocks:%" PRId64 ", filter-out-blocks:%" PRId64
+      ", STableBlockScanInfo size:%.2f Kb, createTime:%.2f ms,initDelSkylineIterTime:%.2f ms, %s",
       pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime, pCost->numOfBlocks,
       pCost->blockLoadTime, pCost->buildmemBlock, pCost->lastBlockLoad, pCost->lastBlockLoadTime, pCost->composedBlocks,
-      pCost->buildComposedBlockTime, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
+      pCost->buildComposedBlockTime, pCost->filterBlocks, pCost->filterOutBlocks, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
       pCost->initDelSkylineIterTime, pReader->idStr);
 
   taosMemoryFree(pReader->idStr);
@@ -5062,6 +5143,61 @@ STableBlockScanInfo* getTableBlockScanInfo(SSHashObj* pTableMap, uint64_t uid, c
   return *p;
 }
 
+// Load only the columns referred by the pushed down filter, and evaluate the filter on them. If no row of the block
+// qualifies, the rows are consumed without decoding the other columns. Otherwise the dump position is restored, and the
+// block is loaded again with all columns.
+static int32_t doFilterFileBlock(STsdbReader* pReader, uint64_t uid, bool* filterOut) {
+  SReaderStatus*      pStatus = &pReader->status;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SFileBlockDumpInfo  dumpInfo = pStatus->fBlockDumpInfo;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  SIOCostSummary*     pCost = &pReader->cost;
+
+  *filterOut = false;
+
+  int32_t code = doLoadFileBlockColumns(pReader, &pStatus->blockIter, &pStatus->fileBlockData, uid, pSup->filterColId,
+                                        pSup->numOfFilterCols);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  code = copyBlockDataToSDataBlock(pReader);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (pStatus->fBlockDumpInfo.rowIndex != dumpInfo.rowIndex) {
+    SFilterColumnParam param = {.numOfCols = taosArrayGetSize(pResBlock->pDataBlock), .pDataBlock = pResBlock->pDataBlock};
+    SColumnInfoData*   p = NULL;
+    int32_t            status = 0;
+
+    filterSetDataFromSlotId(pReader->pFilterInfo, &param);
+    filterExecute(pReader->pFilterInfo, pResBlock, &p, NULL, param.numOfCols, &status);
+    colDataDestroy(p);
+    taosMemoryFree(p);
+
+    pCost->filterBlocks += 1;
+    if (status == FILTER_RESULT_NONE_QUALIFIED) {
+      pCost->filterOutBlocks += 1;
+      pResBlock->info.rows = 0;
+      *filterOut = true;
+    }
+
+    // stop the pushdown if the filter seldom rules out a whole block, since the filter columns are decoded twice
+    if (pCost->filterBlocks == TSDB_FILTER_PROBE_BLOCKS && pCost->filterOutBlocks * 4 < pCost->filterBlocks) {
+      tsdbDebug("%p stop filter pushdown, %" PRId64 " of %" PRId64 " blocks filtered out, %s", pReader,
+                pCost->filterOutBlocks, pCost->filterBlocks, pReader->idStr);
+      pReader->pFilterInfo = NULL;
+    }
+  }
+
+  if (!(*filterOut)) {
+    pStatus->fBlockDumpInfo = dumpInfo;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
   SReaderStatus*       pStatus = &pReader->status;
   int32_t              code = TSDB_CODE_SUCCESS;
@@ -5071,6 +5207,20 @@ static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
     return NULL;
   }
 
+  if (pReader->pFilterInfo != NULL) {
+    bool filterOut = false;
+    code = doFilterFileBlock(pReader, pBlockScanInfo->uid, &filterOut);
+    if (code != TSDB_CODE_SUCCESS) {
+      tBlockDataDestroy(&pStatus->fileBlockData);
+      terrno = code;
+      return NULL;
+    }
+
+    if (filterOut) {
+      return pReader->resBlockInfo.pResBlock;
+    }
+  }
+
   code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
   if (code != TSDB_CODE_SUCCESS) {
     tBlockDataDestroy(&pStatus->fileBlockData);
@@ -5304,6 +5454,55 @@ int64_t tsdbGetNumOfRowsInMemTable(STsdbReader* pReader) {
   return rows;
 }
 
+// Split the query window of the reader at the start key of each file set in its snapshot, so that each window covers
+// the keys of at most one file set. The windows are contiguous and in ascending order.
+int32_t tsdbGetFileSetWindows(STsdbReader* pReader, SArray* pWindows) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  tsdbAcquireReader(pReader);
+  if (pReader->flag == READER_STATUS_SUSPEND) {
+    code = tsdbReaderResume(pReader);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbReleaseReader(pReader);
+      return code;
+    }
+  }
+
+  STimeWindow win = pReader->window;
+  if (isEmptyQueryTimeWindow(&win) || pReader->pReadSnap == NULL) {
+    tsdbReleaseReader(pReader);
+    return code;
+  }
+
+  STsdbKeepCfg* pCfg = &pReader->pTsdb->keepCfg;
+  SArray*       aDFileSet = pReader->pReadSnap->fs.aDFileSet;
+  for (int32_t i = 0; i < taosArrayGetSize(aDFileSet); ++i) {
+    SDFileSet* pSet = taosArrayGet(aDFileSet, i);
+    TSKEY      minKey = 0, maxKey = 0;
+
+    tsdbFidKeyRange(pSet->fid, pCfg->days, pCfg->precision, &minKey, &maxKey);
+    if (minKey <= win.skey) {
+      continue;
+    } else if (minKey > win.ekey) {
+      break;
+    }
+
+    STimeWindow w = {.skey = win.skey, .ekey = minKey - 1};
+    if (taosArrayPush(pWindows, &w) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
+    }
+    win.skey = minKey;
+  }
+
+  if (code == TSDB_CODE_SUCCESS && taosArrayPush(pWindows, &win) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  tsdbReleaseReader(pReader);
+  return code;
+}
+
 int32_t tsdbGetTableSchema(SVnode* pVnode, int64_t uid, STSchema** pSchema, int64_t* suid) {
   SMetaReader mr = {0};
   metaReaderInit(&mr, pVnode->pMeta, 0);
@@ -5437,3 +5636,66 @@ void tsdbReaderSetId(STsdbReader* pReader, const char* idstr) {
 }
 
 void tsdbReaderSetCloseFlag(STsdbReader* pReader) { pReader->flag = READER_STATUS_SHOULD_STOP; }
+
+int32_t tsdbReaderSetFilter(STsdbReader* pReader, void* pFilterInfo, const SArray* pColIdList) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+
+  taosMemoryFreeClear(pSup->filterColId);
+  pSup->numOfFilterCols = 0;
+  pReader->pFilterInfo = NULL;
+  pReader->pSttFilter = NULL;
+
+  if (pFilterInfo == NULL || pSup->numOfCols <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pSup->filterColId = taosMemoryMalloc(sizeof(int16_t) * pSup->numOfCols);
+  if (pSup->filterColId == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t numOfFound = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pColIdList); ++i) {
+    int16_t colId = *(int16_t*)taosArrayGet(pColIdList, i);
+    if (colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+      numOfFound += 1;
+      continue;
+    }
+
+    for (int32_t j = 1; j < pSup->numOfCols; ++j) {
+      if (pSup->colId[j] == colId) {
+        numOfFound += 1;
+        break;
+      }
+    }
+  }
+
+  // keep the ascending order of the column ids, which is required to load the block data
+  for (int32_t j = 1; j < pSup->numOfCols; ++j) {
+    for (int32_t i = 0; i < taosArrayGetSize(pColIdList); ++i) {
+      if (pSup->colId[j] == *(int16_t*)taosArrayGet(pColIdList, i)) {
+        pSup->filterColId[pSup->numOfFilterCols++] = pSup->colId[j];
+        break;
+      }
+    }
+  }
+
+  // it can not be evaluated if any column is not loaded by the reader
+  if (numOfFound < taosArrayGetSize(pColIdList)) {
+    taosMemoryFreeClear(pSup->filterColId);
+    pSup->numOfFilterCols = 0;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pReader->pSttFilter = pFilterInfo;
+
+  // no gain to load the filter columns ahead if the filter refers to all columns
+  if (pSup->numOfFilterCols == pSup->numOfCols - 1) {
+    taosMemoryFreeClear(pSup->filterColId);
+    pSup->numOfFilterCols = 0;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pReader->pFilterInfo = pFilterInfo;
+  return TSDB_CODE_SUCCESS;
+}
@@ -47,6 +47,7 @@ static int32_t tsdbOpenFile(const char *path, int32_t szPage, int32_t flag, STsd
     taosMemoryFree(pFD);
     goto _exit;
   }
+  pFD->pPage = pFD->pBuf;
 
   // not check file size when reading data files.
   if (flag != TD_FILE_READ) {
@@ -71,6 +72,9 @@ _exit:
 static void tsdbCloseFile(STsdbFD **ppFD) {
   STsdbFD *pFD = *ppFD;
   if (pFD) {
+    if (pFD->pTsdb) {
+      tsdbCacheReleasePage(pFD);
+    }
     taosMemoryFree(pFD->pBuf);
     taosCloseFile(&pFD->pFD);
     taosMemoryFree(pFD);
@@ -111,6 +115,12 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno) {
 
   // ASSERT(pgno <= pFD->szFile);
 
+  // a hit moves the reader onto the cached page, a miss releases the cached page it was on before pBuf is reused
+  if (pFD->pTsdb && tsdbCacheGetPage(pFD, pgno)) {
+    pFD->pgno = pgno;
+    goto _exit;
+  }
+
   // seek
   int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
   int64_t n = taosLSeekFile(pFD->pFD, offset, SEEK_SET);
@@ -137,10 +147,24 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno) {
 
   pFD->pgno = pgno;
 
+  if (pFD->pTsdb) {
+    tsdbCachePutPage(pFD, pgno);
+  }
+
 _exit:
   return code;
 }
 
+// read the pages of a file of a committed file set through the vnode page cache, the pages of head and stt files are
+// kept with high priority since the block index of every query starts from them
+static void tsdbSetFilePageCache(STsdbFD *pFD, STsdb *pTsdb, int64_t lSize, LRUPriority priority) {
+  if (pTsdb->pgCache == NULL) return;
+
+  pFD->pTsdb = pTsdb;
+  pFD->lSize = lSize;
+  pFD->pgPri = priority;
+}
+
 static int32_t tsdbWriteFile(STsdbFD *pFD, int64_t offset, const uint8_t *pBuf, int64_t size) {
   int32_t code = 0;
   int64_t fOffset = LOGIC_TO_FILE_OFFSET(offset, pFD->szPage);
@@ -191,7 +215,7 @@ static int32_t tsdbReadFile(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t
     }
 
     int64_t nRead = TMIN(szPgCont - bOffset, size - n);
-    memcpy(pBuf + n, pFD->pBuf + bOffset, nRead);
+    memcpy(pBuf + n, pFD->pPage + bOffset, nRead);
 
     n += nRead;
     pgno++;
@@ -202,6 +226,26 @@ _exit:
   return code;
 }
 
+// hint the OS to start reading the pages of [offset, offset + size) in the background
+static int32_t tsdbReadAheadFile(STsdbFD *pFD, int64_t offset, int64_t size) {
+  int32_t code = 0;
+  int64_t fOffset = LOGIC_TO_FILE_OFFSET(offset, pFD->szPage);
+  int64_t sPgno = OFFSET_PGNO(fOffset, pFD->szPage);
+  int64_t ePgno = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset + size - 1, pFD->szPage), pFD->szPage);
+
+  // the page held in pFD->pPage is not read again
+  if (sPgno == pFD->pgno) sPgno++;
+  if (sPgno > ePgno) goto _exit;
+
+  if (taosReadAheadFile(pFD->pFD, PAGE_OFFSET(sPgno, pFD->szPage), (ePgno - sPgno + 1) * pFD->szPage) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+_exit:
+  return code;
+}
+
 static int32_t tsdbFsyncFile(STsdbFD *pFD) {
   int32_t code = 0;
 
@@ -291,6 +335,8 @@ int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pS
 
   // stt
   ASSERT(pWriter->fStt[pSet->nSttF - 1].size == 0);
+  // set once the stt blocks are known to have zone maps
+  pWriter->fStt[pSet->nSttF - 1].fmtVer = 0;
   flag = TD_FILE_READ | TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC;
   tsdbSttFileName(pTsdb, pWriter->wSet.diskId, pWriter->wSet.fid, &pWriter->fStt[pSet->nSttF - 1], fname);
   code = tsdbOpenFile(fname, szPage, flag, &pWriter->pSttFD);
@@ -371,8 +417,9 @@ int32_t tsdbUpdateDFileSetHeader(SDataFWriter *pWriter) {
   if (code) goto _err;
 
   // stt ==============
+  SSttFile *pSttFile = &pWriter->fStt[pWriter->wSet.nSttF - 1];
   memset(hdr, 0, TSDB_FHDR_SIZE);
-  tPutSttFile(hdr, &pWriter->fStt[pWriter->wSet.nSttF - 1]);
+  tPutSttFile(hdr, pSttFile, pSttFile->fmtVer ? TSDB_FS_VER : 0);
   code = tsdbWriteFile(pWriter->pSttFD, 0, hdr, TSDB_FHDR_SIZE);
   if (code) goto _err;
 
@@ -479,10 +526,19 @@ int32_t tsdbWriteSttBlk(SDataFWriter *pWriter, SArray *aSttBlk) {
     goto _exit;
   }
 
+  // the index of blocks with zone maps needs the new format, the other files stay readable by older versions
+  pSttFile->fmtVer = 0;
+  for (int32_t iBlockL = 0; iBlockL < taosArrayGetSize(aSttBlk); iBlockL++) {
+    if (((SSttBlk *)taosArrayGet(aSttBlk, iBlockL))->smaInfo.size > 0) {
+      pSttFile->fmtVer = TSDB_STT_FMT_VER;
+      break;
+    }
+  }
+
   // size
   size = 0;
   for (int32_t iBlockL = 0; iBlockL < taosArrayGetSize(aSttBlk); iBlockL++) {
-    size += tPutSttBlk(NULL, taosArrayGet(aSttBlk, iBlockL));
+    size += tPutSttBlk(NULL, taosArrayGet(aSttBlk, iBlockL), pSttFile->fmtVer);
   }
 
   // alloc
@@ -492,7 +548,7 @@ int32_t tsdbWriteSttBlk(SDataFWriter *pWriter, SArray *aSttBlk) {
   // encode
   n = 0;
   for (int32_t iBlockL = 0; iBlockL < taosArrayGetSize(aSttBlk); iBlockL++) {
-    n += tPutSttBlk(pWriter->aBuf[0] + n, taosArrayGet(aSttBlk, iBlockL));
+    n += tPutSttBlk(pWriter->aBuf[0] + n, taosArrayGet(aSttBlk, iBlockL), pSttFile->fmtVer);
   }
 
   // write
@@ -513,7 +569,7 @@ _err:
   return code;
 }
 
-static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData, SSmaInfo *pSmaInfo) {
+static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData, SSmaInfo *pSmaInfo, int8_t toLast) {
   int32_t code = 0;
 
   pSmaInfo->offset = 0;
@@ -533,13 +589,16 @@ static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData,
     pSmaInfo->size += tPutColumnDataAgg(pWriter->aBuf[0] + pSmaInfo->size, &sma);
   }
 
-  // write
+  // write, the zone maps of a stt block follow the block data in the stt file
   if (pSmaInfo->size) {
-    code = tsdbWriteFile(pWriter->pSmaFD, pWriter->fSma.size, pWriter->aBuf[0], pSmaInfo->size);
+    STsdbFD *pFD = toLast ? pWriter->pSttFD : pWriter->pSmaFD;
+    int64_t *pSize = toLast ? &pWriter->fStt[pWriter->wSet.nSttF - 1].size : &pWriter->fSma.size;
+
+    code = tsdbWriteFile(pFD, *pSize, pWriter->aBuf[0], pSmaInfo->size);
     if (code) goto _err;
 
-    pSmaInfo->offset = pWriter->fSma.size;
-    pWriter->fSma.size += pSmaInfo->size;
+    pSmaInfo->offset = *pSize;
+    *pSize += pSmaInfo->size;
   }
 
   return code;
@@ -602,7 +661,7 @@ int32_t tsdbWriteBlockData(SDataFWriter *pWriter, SBlockData *pBlockData, SBlock
 
   // ================= SMA ====================
   if (pSmaInfo) {
-    code = tsdbWriteBlockSma(pWriter, pBlockData, pSmaInfo);
+    code = tsdbWriteBlockSma(pWriter, pBlockData, pSmaInfo, toLast);
     if (code) goto _err;
   }
 
@@ -670,7 +729,7 @@ int32_t tsdbWriteDiskData(SDataFWriter *pWriter, const SDiskData *pDiskData, SBl
     n = 0;
     for (int32_t iDiskCol = 0; iDiskCol < taosArrayGetSize(pDiskData->aDiskCol); iDiskCol++) {
       SDiskCol *pDiskCol = (SDiskCol *)taosArrayGet(pDiskData->aDiskCol, iDiskCol);
-      n += tPutBlockCol(pWriter->aBuf[0] + n, pDiskCol);
+      n += tPutBlockCol(pWriter->aBuf[0] + n, pDiskCol, pDiskData->hdr.fmtVer);
     }
     ASSERT(n == pDiskData->hdr.szBlkCol);
 
@@ -867,22 +926,26 @@ int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pS
   tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pHeadFD);
   TSDB_CHECK_CODE(code, lino, _exit);
+  tsdbSetFilePageCache(pReader->pHeadFD, pTsdb, pSet->pHeadF->size, TAOS_LRU_PRIORITY_HIGH);
 
   // data
   tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pDataFD);
   TSDB_CHECK_CODE(code, lino, _exit);
+  tsdbSetFilePageCache(pReader->pDataFD, pTsdb, pSet->pDataF->size, TAOS_LRU_PRIORITY_LOW);
 
   // sma
   tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pSmaFD);
   TSDB_CHECK_CODE(code, lino, _exit);
+  tsdbSetFilePageCache(pReader->pSmaFD, pTsdb, pSet->pSmaF->size, TAOS_LRU_PRIORITY_LOW);
 
   // stt
   for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
     tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
     code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->aSttFD[iStt]);
     TSDB_CHECK_CODE(code, lino, _exit);
+    tsdbSetFilePageCache(pReader->aSttFD[iStt], pTsdb, pSet->aSttF[iStt]->size, TAOS_LRU_PRIORITY_HIGH);
   }
 
 _exit:
@@ -989,7 +1052,7 @@ int32_t tsdbReadSttBlk(SDataFReader *pReader, int32_t iStt, SArray *aSttBlk) {
   int64_t n = 0;
   while (n < size) {
     SSttBlk sttBlk;
-    n += tGetSttBlk(pReader->aBuf[0] + n, &sttBlk);
+    n += tGetSttBlk(pReader->aBuf[0] + n, &sttBlk, pSttFile->fmtVer);
 
     if (taosArrayPush(aSttBlk, &sttBlk) == NULL) {
       code = TSDB_CODE_OUT_OF_MEMORY;
@@ -1068,6 +1131,41 @@ _err:
   return code;
 }
 
+int32_t tsdbReadSttBlockSma(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SArray *aColumnDataAgg) {
+  int32_t   code = 0;
+  SSmaInfo *pSmaInfo = &pSttBlk->smaInfo;
+
+  ASSERT(pSmaInfo->size > 0);
+
+  taosArrayClear(aColumnDataAgg);
+
+  // alloc
+  code = tRealloc(&pReader->aBuf[0], pSmaInfo->size);
+  if (code) goto _err;
+
+  // read
+  code = tsdbReadFile(pReader->aSttFD[iStt], pSmaInfo->offset, pReader->aBuf[0], pSmaInfo->size);
+  if (code) goto _err;
+
+  // decode
+  int32_t n = 0;
+  while (n < pSmaInfo->size) {
+    SColumnDataAgg sma;
+    n += tGetColumnDataAgg(pReader->aBuf[0] + n, &sma);
+
+    if (taosArrayPush(aColumnDataAgg, &sma) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _err;
+    }
+  }
+  ASSERT(n == pSmaInfo->size);
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb read stt block sma failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  return code;
+}
+
 static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
                                      int32_t iStt) {
   int32_t code = 0;
@@ -1139,7 +1237,7 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
 
     while (pBlockCol && pBlockCol->cid < pColData->cid) {
       if (n < hdr.szBlkCol) {
-        n += tGetBlockCol(pReader->aBuf[0] + n, pBlockCol);
+        n += tGetBlockCol(pReader->aBuf[0] + n, pBlockCol, hdr.fmtVer);
       } else {
         ASSERT(n == hdr.szBlkCol);
         pBlockCol = NULL;
@@ -1225,6 +1323,23 @@ _err:
   return code;
 }
 
+int32_t tsdbPrefetchDataBlock(SDataFReader *pReader, SDataBlk *pDataBlk) {
+  int32_t code = 0;
+
+  for (int32_t iSubBlock = 0; iSubBlock < pDataBlk->nSubBlock; iSubBlock++) {
+    SBlockInfo *pBlockInfo = &pDataBlk->aSubBlock[iSubBlock];
+
+    code = tsdbReadAheadFile(pReader->pDataFD, pBlockInfo->offset, pBlockInfo->szBlock);
+    if (code) goto _err;
+  }
+
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb prefetch data block failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  return code;
+}
+
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -331,7 +331,7 @@ bool tDataBlkHasSma(SDataBlk *pDataBlk) {
 }
 
 // SSttBlk ======================================================
-int32_t tPutSttBlk(uint8_t *p, void *ph) {
+int32_t tPutSttBlk(uint8_t *p, void *ph, int8_t fmtVer) {
   int32_t  n = 0;
   SSttBlk *pSttBlk = (SSttBlk *)ph;
 
@@ -346,11 +346,15 @@ int32_t tPutSttBlk(uint8_t *p, void *ph) {
   n += tPutI64v(p ? p + n : p, pSttBlk->bInfo.offset);
   n += tPutI32v(p ? p + n : p, pSttBlk->bInfo.szBlock);
   n += tPutI32v(p ? p + n : p, pSttBlk->bInfo.szKey);
+  if (fmtVer >= 1) {
+    n += tPutI64v(p ? p + n : p, pSttBlk->smaInfo.offset);
+    n += tPutI32v(p ? p + n : p, pSttBlk->smaInfo.size);
+  }
 
   return n;
 }
 
-int32_t tGetSttBlk(uint8_t *p, void *ph) {
+int32_t tGetSttBlk(uint8_t *p, void *ph, int8_t fmtVer) {
   int32_t  n = 0;
   SSttBlk *pSttBlk = (SSttBlk *)ph;
 
@@ -365,12 +369,19 @@ int32_t tGetSttBlk(uint8_t *p, void *ph) {
   n += tGetI64v(p + n, &pSttBlk->bInfo.offset);
   n += tGetI32v(p + n, &pSttBlk->bInfo.szBlock);
   n += tGetI32v(p + n, &pSttBlk->bInfo.szKey);
+  if (fmtVer >= 1) {
+    n += tGetI64v(p + n, &pSttBlk->smaInfo.offset);
+    n += tGetI32v(p + n, &pSttBlk->smaInfo.size);
+  } else {
+    pSttBlk->smaInfo.offset = 0;
+    pSttBlk->smaInfo.size = 0;
+  }
 
   return n;
 }
 
 // SBlockCol ======================================================
-int32_t tPutBlockCol(uint8_t *p, void *ph) {
+int32_t tPutBlockCol(uint8_t *p, void *ph, uint32_t fmtVer) {
   int32_t    n = 0;
   SBlockCol *pBlockCol = (SBlockCol *)ph;
 
@@ -396,13 +407,17 @@ int32_t tPutBlockCol(uint8_t *p, void *ph) {
     }
 
     n += tPutI32v(p ? p + n : p, pBlockCol->offset);
+
+    if (fmtVer >= 1) {
+      n += tPutI8(p ? p + n : p, pBlockCol->codec);
+    }
   }
 
 _exit:
   return n;
 }
 
-int32_t tGetBlockCol(uint8_t *p, void *ph) {
+int32_t tGetBlockCol(uint8_t *p, void *ph, uint32_t fmtVer) {
   int32_t    n = 0;
   SBlockCol *pBlockCol = (SBlockCol *)ph;
 
@@ -418,6 +433,7 @@ int32_t tGetBlockCol(uint8_t *p, void *ph) {
   pBlockCol->szOffset = 0;
   pBlockCol->szValue = 0;
   pBlockCol->offset = 0;
+  pBlockCol->codec = TSDB_COL_CODEC_DEFAULT;
 
   if (pBlockCol->flag != HAS_NULL) {
     if (pBlockCol->flag != HAS_VALUE) {
@@ -433,6 +449,10 @@ int32_t tGetBlockCol(uint8_t *p, void *ph) {
     }
 
     n += tGetI32v(p + n, &pBlockCol->offset);
+
+    if (fmtVer >= 1) {
+      n += tGetI8(p + n, &pBlockCol->codec);
+    }
   }
 
   return n;
@@ -1319,8 +1339,9 @@ int32_t tCmprBlockData(SBlockData *pBlockData, int8_t cmprAlg, uint8_t **ppOut,
                       .cmprAlg = cmprAlg};
 
   // encode =================
-  // columns AND SBlockCol
+  // columns, the SBlockCol of which are kept in aBuf[3] until the format version is known
   aBufN[0] = 0;
+  int32_t nBlockCol = 0;
   for (int32_t iColData = 0; iColData < pBlockData->nColData; iColData++) {
     SColData *pColData = tBlockDataGetColDataByIdx(pBlockData, iColData);
 
@@ -1342,11 +1363,25 @@ int32_t tCmprBlockData(SBlockData *pBlockData, int8_t cmprAlg, uint8_t **ppOut,
       aBufN[0] = aBufN[0] + blockCol.szBitmap + blockCol.szOffset + blockCol.szValue;
     }
 
-    code = tRealloc(&aBuf[1], hdr.szBlkCol + tPutBlockCol(NULL, &blockCol));
+    // the codec is saved since version 1, a block without FOR columns is written as before and stays readable by
+    // older versions
+    if (blockCol.codec != TSDB_COL_CODEC_DEFAULT) {
+      hdr.fmtVer = TSDB_DISK_DATA_FMT_VER;
+    }
+
+    code = tRealloc(&aBuf[3], sizeof(SBlockCol) * (nBlockCol + 1));
     if (code) goto _exit;
-    hdr.szBlkCol += tPutBlockCol(aBuf[1] + hdr.szBlkCol, &blockCol);
+    ((SBlockCol *)aBuf[3])[nBlockCol++] = blockCol;
   }
 
+  // SBlockCol
+  for (int32_t iBlockCol = 0; iBlockCol < nBlockCol; iBlockCol++) {
+    SBlockCol *pBlockCol = &((SBlockCol *)aBuf[3])[iBlockCol];
+
+    code = tRealloc(&aBuf[1], hdr.szBlkCol + tPutBlockCol(NULL, pBlockCol, hdr.fmtVer));
+    if (code) goto _exit;
+    hdr.szBlkCol += tPutBlockCol(aBuf[1] + hdr.szBlkCol, pBlockCol, hdr.fmtVer);
+  }
   // SBlockCol
   aBufN[1] = hdr.szBlkCol;
 
@@ -1441,7 +1476,7 @@ int32_t tDecmprBlockData(uint8_t *pIn, int32_t szIn, SBlockData *pBlockData, uin
   int32_t nt = 0;
   while (nt < hdr.szBlkCol) {
     SBlockCol blockCol = {0};
-    nt += tGetBlockCol(pIn + n + nt, &blockCol);
+    nt += tGetBlockCol(pIn + n + nt, &blockCol, hdr.fmtVer);
     ++nColData;
   }
   ASSERT(nt == hdr.szBlkCol);
@@ -1453,7 +1488,7 @@ int32_t tDecmprBlockData(uint8_t *pIn, int32_t szIn, SBlockData *pBlockData, uin
   int32_t iColData = 0;
   while (nt < hdr.szBlkCol) {
     SBlockCol blockCol = {0};
-    nt += tGetBlockCol(pIn + n + nt, &blockCol);
+    nt += tGetBlockCol(pIn + n + nt, &blockCol, hdr.fmtVer);
 
     SColData *pColData = &pBlockData->aColData[iColData++];
 
@@ -1601,6 +1636,35 @@ _exit:
   return code;
 }
 
+// integer values are also tried with the frame of reference codecs, which replace the output of the default codec
+// if they take less space
+static int32_t tsdbCmprColValueFOR(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol, uint8_t *pOut) {
+  int32_t code = 0;
+
+  pBlockCol->codec = TSDB_COL_CODEC_DEFAULT;
+  if (cmprAlg == NO_COMPRESSION) goto _exit;
+  if (!IS_INTEGER_TYPE(pColData->type) && pColData->type != TSDB_DATA_TYPE_TIMESTAMP) goto _exit;
+
+  int32_t bytes = tDataTypes[pColData->type].bytes;
+  int32_t nEle = pColData->nData / bytes;
+  int32_t szFOR, szDeltaFOR;
+  tsCompressFORSize(pColData->pData, nEle, bytes, &szFOR, &szDeltaFOR);
+  bool    delta = (szDeltaFOR < szFOR);
+  int32_t size = delta ? szDeltaFOR : szFOR;
+
+  if (size >= pBlockCol->szValue) goto _exit;
+
+  if (tsCompressFOR(pColData->pData, nEle, bytes, delta, pOut, size) != size) {
+    code = TSDB_CODE_COMPRESS_ERROR;
+    goto _exit;
+  }
+  pBlockCol->codec = delta ? TSDB_COL_CODEC_DELTA_FOR : TSDB_COL_CODEC_FOR;
+  pBlockCol->szValue = size;
+
+_exit:
+  return code;
+}
+
 int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol, uint8_t **ppOut, int32_t nOut,
                         uint8_t **ppBuf) {
   int32_t code = 0;
@@ -1640,6 +1704,9 @@ int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol
     code = tsdbCmprData((uint8_t *)pColData->pData, pColData->nData, pColData->type, cmprAlg, ppOut, nOut + size,
                         &pBlockCol->szValue, ppBuf);
     if (code) goto _exit;
+
+    code = tsdbCmprColValueFOR(pColData, cmprAlg, pBlockCol, *ppOut + nOut + size);
+    if (code) goto _exit;
   }
   size += pBlockCol->szValue;
 
@@ -1683,8 +1750,21 @@ int32_t tsdbDecmprColData(uint8_t *pIn, SBlockCol *pBlockCol, int8_t cmprAlg, in
 
   // value
   if (pBlockCol->szValue) {
-    code = tsdbDecmprData(p, pBlockCol->szValue, pColData->type, cmprAlg, &pColData->pData, pColData->nData, ppBuf);
-    if (code) goto _exit;
+    if (pBlockCol->codec == TSDB_COL_CODEC_DEFAULT) {
+      code = tsdbDecmprData(p, pBlockCol->szValue, pColData->type, cmprAlg, &pColData->pData, pColData->nData, ppBuf);
+      if (code) goto _exit;
+    } else {
+      code = tRealloc(&pColData->pData, pColData->nData);
+      if (code) goto _exit;
+
+      int32_t bytes = tDataTypes[pColData->type].bytes;
+      if (tsDecompressFOR(p, pBlockCol->szValue, pColData->nData / bytes, bytes,
+                          pBlockCol->codec == TSDB_COL_CODEC_DELTA_FOR, pColData->pData,
+                          pColData->nData) != pColData->nData) {
+        code = TSDB_CODE_COMPRESS_ERROR;
+        goto _exit;
+      }
+    }
   }
   p += pBlockCol->szValue;
 
@@ -15,6 +15,20 @@
 
 #include "vnd.h"
 
+#define VNODE_BUFPOOL_SLAB_SIZE (64 * 1024)
+
+struct SVBufPoolSlab {
+  uint8_t *ptr;
+  uint8_t *end;
+};
+
+// the slab of the pools the calling thread allocates from, set by the parallel insert tasks of a submit request.
+// the tasks of one request have different slabs, and a vnode processes one request at a time.
+static threadlocal int32_t vnodeBufPoolSlabId = -1;
+
+static void *vnodeBufPoolMallocAlignedImpl(SVBufPool *pPool, int size);
+static void *vnodeBufPoolSlabMalloc(SVBufPool *pPool, int size);
+
 /* ------------------------ STRUCTURES ------------------------ */
 static int vnodeBufPoolCreate(SVnode *pVnode, int32_t id, int64_t size, SVBufPool **ppPool) {
   SVBufPool *pPool;
@@ -40,15 +54,27 @@ static int vnodeBufPoolCreate(SVnode *pVnode, int32_t id, int64_t size, SVBufPoo
   pPool->node.pnext = &pPool->pTail;
   pPool->node.size = size;
 
-  if (VND_IS_RSMA(pVnode)) {
+  if (tsNumOfVnodeInsertThreads > 1) {
+    pPool->aSlab = taosMemoryCalloc(tsNumOfVnodeInsertThreads, sizeof(SVBufPoolSlab));
+    if (pPool->aSlab == NULL) {
+      taosMemoryFree(pPool);
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    pPool->nSlab = tsNumOfVnodeInsertThreads;
+  }
+
+  if (VND_IS_RSMA(pVnode) || pPool->aSlab) {
     pPool->lock = taosMemoryMalloc(sizeof(TdThreadSpinlock));
     if (!pPool->lock) {
+      taosMemoryFree(pPool->aSlab);
       taosMemoryFree(pPool);
       terrno = TSDB_CODE_OUT_OF_MEMORY;
       return -1;
     }
     if (taosThreadSpinInit(pPool->lock, 0) != 0) {
       taosMemoryFree((void *)pPool->lock);
+      taosMemoryFree(pPool->aSlab);
       taosMemoryFree(pPool);
       terrno = TAOS_SYSTEM_ERROR(errno);
       return -1;
@@ -67,6 +93,7 @@ static int vnodeBufPoolDestroy(SVBufPool *pPool) {
     taosThreadSpinDestroy(pPool->lock);
     taosMemoryFree((void *)pPool->lock);
   }
+  taosMemoryFree(pPool->aSlab);
   taosThreadMutexDestroy(&pPool->mutex);
   taosMemoryFree(pPool);
   return 0;
@@ -118,9 +145,16 @@ void vnodeBufPoolReset(SVBufPool *pPool) {
 
   pPool->size = 0;
   pPool->ptr = pPool->node.data;
+  if (pPool->aSlab) memset(pPool->aSlab, 0, sizeof(SVBufPoolSlab) * pPool->nSlab);
 }
 
 void *vnodeBufPoolMallocAligned(SVBufPool *pPool, int size) {
+  ASSERT(pPool != NULL);
+  if (pPool->aSlab && vnodeBufPoolSlabId >= 0) return vnodeBufPoolSlabMalloc(pPool, size);
+  return vnodeBufPoolMallocAlignedImpl(pPool, size);
+}
+
+static void *vnodeBufPoolMallocAlignedImpl(SVBufPool *pPool, int size) {
   SVBufPoolNode *pNode;
   void          *p = NULL;
   uint8_t       *ptr = NULL;
@@ -165,6 +199,8 @@ void *vnodeBufPoolMalloc(SVBufPool *pPool, int size) {
   void          *p = NULL;
   ASSERT(pPool != NULL);
 
+  if (pPool->aSlab && vnodeBufPoolSlabId >= 0) return vnodeBufPoolSlabMalloc(pPool, size);
+
   if (pPool->lock) taosThreadSpinLock(pPool->lock);
   if (pPool->node.size >= pPool->ptr - pPool->node.data + size) {
     // allocate from the anchor node
@@ -193,6 +229,31 @@ void *vnodeBufPoolMalloc(SVBufPool *pPool, int size) {
   return p;
 }
 
+// Each parallel insert task carves small allocations out of its own slab of the pool, so only slab refills contend on
+// the pool lock. The slabs stay with the pool until it is reset, so no slab is dropped half used when the thread of a
+// task moves on to another vnode.
+static void *vnodeBufPoolSlabMalloc(SVBufPool *pPool, int size) {
+  SVBufPoolSlab *pSlab = &pPool->aSlab[vnodeBufPoolSlabId % pPool->nSlab];
+  uint8_t       *p = NULL;
+
+  if (size > (VNODE_BUFPOOL_SLAB_SIZE >> 2)) {
+    return vnodeBufPoolMallocAlignedImpl(pPool, size);
+  }
+
+  p = (uint8_t *)(((long)pSlab->ptr + 7) & ~7);
+  if (pSlab->ptr == NULL || p + size > pSlab->end) {
+    p = vnodeBufPoolMallocAlignedImpl(pPool, VNODE_BUFPOOL_SLAB_SIZE);
+    if (p == NULL) return NULL;
+
+    pSlab->end = p + VNODE_BUFPOOL_SLAB_SIZE;
+  }
+
+  pSlab->ptr = p + size;
+  return p;
+}
+
+void vnodeBufPoolSetSlab(int32_t iSlab) { vnodeBufPoolSlabId = iSlab; }
+
 void vnodeBufPoolFree(SVBufPool *pPool, void *p) {
   // uint8_t       *ptr = (uint8_t *)p;
   // SVBufPoolNode *pNode;
@@ -34,8 +34,12 @@ struct SVnodeGlobal {
 };
 
 struct SVnodeGlobal vnodeGlobal;
+struct SVnodeGlobal vnodeInsertGlobal;  // only the task queue and threads are used
 
 static void* loop(void* arg);
+static int   vnodeOpenTaskPool(struct SVnodeGlobal* pGlobal, int nthreads);
+static void  vnodeCloseTaskPool(struct SVnodeGlobal* pGlobal);
+static int   vnodeScheduleTaskImpl(struct SVnodeGlobal* pGlobal, int (*execute)(void*), void* arg);
 
 static tsem_t canCommit = {0};
 
@@ -52,27 +56,14 @@ int vnodeInit(int nthreads) {
     return 0;
   }
 
-  taosThreadMutexInit(&vnodeGlobal.mutex, NULL);
-  taosThreadCondInit(&vnodeGlobal.hasTask, NULL);
-
-  taosThreadMutexLock(&vnodeGlobal.mutex);
-
-  vnodeGlobal.stop = 0;
-  vnodeGlobal.queue.next = &vnodeGlobal.queue;
-  vnodeGlobal.queue.prev = &vnodeGlobal.queue;
-
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
-
-  vnodeGlobal.nthreads = nthreads;
-  vnodeGlobal.threads = taosMemoryCalloc(nthreads, sizeof(TdThread));
-  if (vnodeGlobal.threads == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
+  if (vnodeOpenTaskPool(&vnodeGlobal, nthreads) < 0) {
     vError("failed to init vnode module since:%s", tstrerror(terrno));
     return -1;
   }
 
-  for (int i = 0; i < nthreads; i++) {
-    taosThreadCreate(&(vnodeGlobal.threads[i]), NULL, loop, NULL);
+  if (tsNumOfVnodeInsertThreads > 1 && vnodeOpenTaskPool(&vnodeInsertGlobal, tsNumOfVnodeInsertThreads) < 0) {
+    vError("failed to init vnode module since:%s", tstrerror(terrno));
+    return -1;
   }
 
   if (walInit() < 0) {
@@ -91,31 +82,71 @@ void vnodeCleanup() {
   init = atomic_val_compare_exchange_8(&(vnodeGlobal.init), 1, 0);
   if (init == 0) return;
 
+  vnodeCloseTaskPool(&vnodeGlobal);
+  if (vnodeInsertGlobal.threads) {
+    vnodeCloseTaskPool(&vnodeInsertGlobal);
+  }
+
+  walCleanUp();
+  tqCleanUp();
+  smaCleanUp();
+}
+
+int vnodeScheduleTask(int (*execute)(void*), void* arg) { return vnodeScheduleTaskImpl(&vnodeGlobal, execute, arg); }
+
+int vnodeScheduleInsertTask(int (*execute)(void*), void* arg) {
+  return vnodeScheduleTaskImpl(&vnodeInsertGlobal, execute, arg);
+}
+
+/* ------------------------ STATIC METHODS ------------------------ */
+static int vnodeOpenTaskPool(struct SVnodeGlobal* pGlobal, int nthreads) {
+  taosThreadMutexInit(&pGlobal->mutex, NULL);
+  taosThreadCondInit(&pGlobal->hasTask, NULL);
+
+  taosThreadMutexLock(&pGlobal->mutex);
+
+  pGlobal->stop = 0;
+  pGlobal->queue.next = &pGlobal->queue;
+  pGlobal->queue.prev = &pGlobal->queue;
+
+  taosThreadMutexUnlock(&(pGlobal->mutex));
+
+  pGlobal->nthreads = nthreads;
+  pGlobal->threads = taosMemoryCalloc(nthreads, sizeof(TdThread));
+  if (pGlobal->threads == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int i = 0; i < nthreads; i++) {
+    taosThreadCreate(&(pGlobal->threads[i]), NULL, loop, pGlobal);
+  }
+
+  return 0;
+}
+
+static void vnodeCloseTaskPool(struct SVnodeGlobal* pGlobal) {
   // set stop
-  taosThreadMutexLock(&(vnodeGlobal.mutex));
-  vnodeGlobal.stop = 1;
-  taosThreadCondBroadcast(&(vnodeGlobal.hasTask));
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+  taosThreadMutexLock(&(pGlobal->mutex));
+  pGlobal->stop = 1;
+  taosThreadCondBroadcast(&(pGlobal->hasTask));
+  taosThreadMutexUnlock(&(pGlobal->mutex));
 
   // wait for threads
-  for (int i = 0; i < vnodeGlobal.nthreads; i++) {
-    taosThreadJoin(vnodeGlobal.threads[i], NULL);
+  for (int i = 0; i < pGlobal->nthreads; i++) {
+    taosThreadJoin(pGlobal->threads[i], NULL);
   }
 
   // clear source
-  taosMemoryFreeClear(vnodeGlobal.threads);
-  taosThreadCondDestroy(&(vnodeGlobal.hasTask));
-  taosThreadMutexDestroy(&(vnodeGlobal.mutex));
-
-  walCleanUp();
-  tqCleanUp();
-  smaCleanUp();
+  taosMemoryFreeClear(pGlobal->threads);
+  taosThreadCondDestroy(&(pGlobal->hasTask));
+  taosThreadMutexDestroy(&(pGlobal->mutex));
 }
 
-int vnodeScheduleTask(int (*execute)(void*), void* arg) {
+static int vnodeScheduleTaskImpl(struct SVnodeGlobal* pGlobal, int (*execute)(void*), void* arg) {
   SVnodeTask* pTask;
 
-  ASSERT(!vnodeGlobal.stop);
+  ASSERT(!pGlobal->stop);
 
   pTask = taosMemoryMalloc(sizeof(*pTask));
   if (pTask == NULL) {
@@ -126,35 +157,35 @@ int vnodeScheduleTask(int (*execute)(void*), void* arg) {
   pTask->execute = execute;
   pTask->arg = arg;
 
-  taosThreadMutexLock(&(vnodeGlobal.mutex));
-  pTask->next = &vnodeGlobal.queue;
-  pTask->prev = vnodeGlobal.queue.prev;
-  vnodeGlobal.queue.prev->next = pTask;
-  vnodeGlobal.queue.prev = pTask;
-  taosThreadCondSignal(&(vnodeGlobal.hasTask));
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+  taosThreadMutexLock(&(pGlobal->mutex));
+  pTask->next = &pGlobal->queue;
+  pTask->prev = pGlobal->queue.prev;
+  pGlobal->queue.prev->next = pTask;
+  pGlobal->queue.prev = pTask;
+  taosThreadCondSignal(&(pGlobal->hasTask));
+  taosThreadMutexUnlock(&(pGlobal->mutex));
 
   return 0;
 }
 
-/* ------------------------ STATIC METHODS ------------------------ */
 static void* loop(void* arg) {
-  SVnodeTask* pTask;
-  int         ret;
+  struct SVnodeGlobal* pGlobal = (struct SVnodeGlobal*)arg;
+  SVnodeTask*          pTask;
+  int                  ret;
 
-  setThreadName("vnode-commit");
+  setThreadName(pGlobal == &vnodeGlobal ? "vnode-commit" : "vnode-insert");
 
   for (;;) {
-    taosThreadMutexLock(&(vnodeGlobal.mutex));
+    taosThreadMutexLock(&(pGlobal->mutex));
     for (;;) {
-      pTask = vnodeGlobal.queue.next;
-      if (pTask == &vnodeGlobal.queue) {
+      pTask = pGlobal->queue.next;
+      if (pTask == &pGlobal->queue) {
         // no task
-        if (vnodeGlobal.stop) {
-          taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+        if (pGlobal->stop) {
+          taosThreadMutexUnlock(&(pGlobal->mutex));
           return NULL;
         } else {
-          taosThreadCondWait(&(vnodeGlobal.hasTask), &(vnodeGlobal.mutex));
+          taosThreadCondWait(&(pGlobal->hasTask), &(pGlobal->mutex));
         }
       } else {
         // has task
@@ -164,7 +195,7 @@ static void* loop(void* arg) {
       }
     }
 
-    taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+    taosThreadMutexUnlock(&(pGlobal->mutex));
 
     pTask->execute(pTask->arg);
     taosMemoryFree(pTask);
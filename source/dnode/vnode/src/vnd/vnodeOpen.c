@@ -283,6 +283,11 @@ SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
 
   tsem_init(&pVnode->syncSem, 0, 0);
   tsem_init(&(pVnode->canCommit), 0, 1);
+  pVnode->aPendingRsp = taosArrayInit(16, sizeof(SRpcMsg));
+  if (pVnode->aPendingRsp == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
   taosThreadMutexInit(&pVnode->mutex, NULL);
   taosThreadCondInit(&pVnode->poolNotEmpty, NULL);
 
@@ -318,6 +323,8 @@ SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
   sprintf(tdir, "%s%s%s", dir, TD_DIRSEP, VNODE_WAL_DIR);
   taosRealPath(tdir, NULL, sizeof(tdir));
 
+  pVnode->config.walCfg.groupCommitWindow = tsWalGroupCommitWindow;
+  pVnode->config.walCfg.groupCommitSize = tsWalGroupCommitSize;
   pVnode->pWal = walOpen(tdir, &(pVnode->config.walCfg));
   if (pVnode->pWal == NULL) {
     vError("vgId:%d, failed to open vnode wal since %s. wal:%s", TD_VID(pVnode), tstrerror(terrno), tdir);
@@ -369,6 +376,7 @@ _err:
   if (pVnode->freeList) vnodeCloseBufPool(pVnode);
 
   tsem_destroy(&(pVnode->canCommit));
+  taosArrayDestroy(pVnode->aPendingRsp);
   taosMemoryFree(pVnode);
   return NULL;
 }
@@ -396,6 +404,7 @@ void vnodeClose(SVnode *pVnode) {
     // destroy handle
     tsem_destroy(&(pVnode->canCommit));
     tsem_destroy(&pVnode->syncSem);
+    taosArrayDestroy(pVnode->aPendingRsp);
     taosThreadCondDestroy(&pVnode->poolNotEmpty);
     taosThreadMutexDestroy(&pVnode->mutex);
     taosThreadMutexDestroy(&pVnode->lock);
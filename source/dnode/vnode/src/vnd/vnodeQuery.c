@@ -383,6 +383,10 @@ int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   pLoad->syncCanRead = state.canRead;
   pLoad->cacheUsage = tsdbCacheGetUsage(pVnode);
   pLoad->numOfCachedTables = tsdbCacheGetElems(pVnode);
+  pLoad->pageCacheHit = tsdbPageCacheGetHits(pVnode);
+  pLoad->pageCacheMiss = tsdbPageCacheGetMisses(pVnode);
+  pLoad->decodeCacheHit = tqDecodeCacheGetHits(pVnode);
+  pLoad->decodeCacheMiss = tqDecodeCacheGetMisses(pVnode);
   pLoad->numOfTables = metaGetTbNum(pVnode->pMeta);
   pLoad->numOfTimeSeries = metaGetTimeSeriesNum(pVnode->pMeta);
   pLoad->totalStorage = (int64_t)3 * 1073741824;
@@ -1168,6 +1168,90 @@ static int32_t vnodeRebuildSubmitReqMsg(SSubmitReq2 *pSubmitReq, void **ppMsg) {
   return code;
 }
 
+typedef struct {
+  SVnode      *pVnode;
+  int64_t      version;
+  SSubmitReq2 *pSubmitReq;
+  int32_t      iTask;
+  int32_t      nTask;
+  int32_t      affectedRows;
+  int32_t      code;
+  tsem_t      *pDone;
+} SVInsertTask;
+
+static int32_t vnodeInsertTableDataTask(void *arg) {
+  SVInsertTask *pTask = (SVInsertTask *)arg;
+
+  vnodeBufPoolSetSlab(pTask->iTask);
+
+  for (int32_t i = 0; i < TARRAY_SIZE(pTask->pSubmitReq->aSubmitTbData); ++i) {
+    SSubmitTbData *pSubmitTbData = taosArrayGet(pTask->pSubmitReq->aSubmitTbData, i);
+
+    // rows of a table always go to the same task, so they are inserted in order
+    if (TABS(pSubmitTbData->uid) % pTask->nTask != pTask->iTask) continue;
+
+    int32_t affectedRows = 0;
+    pTask->code = tsdbInsertTableData(pTask->pVnode->pTsdb, pTask->version, pSubmitTbData, &affectedRows);
+    if (pTask->code) break;
+
+    pTask->affectedRows += affectedRows;
+  }
+
+  vnodeBufPoolSetSlab(-1);
+  if (pTask->pDone) tsem_post(pTask->pDone);
+  return pTask->code;
+}
+
+static int32_t vnodeParallelInsertTableData(SVnode *pVnode, int64_t version, SSubmitReq2 *pSubmitReq,
+                                            int32_t *affectedRows) {
+  int32_t       code = 0;
+  int32_t       nTask = TMIN(tsNumOfVnodeInsertThreads, TARRAY_SIZE(pSubmitReq->aSubmitTbData));
+  int32_t       nWait = 0;
+  SVInsertTask *aTask = NULL;
+  tsem_t        done;
+
+  if (nTask <= 0) return code;
+
+  aTask = taosMemoryCalloc(nTask, sizeof(SVInsertTask));
+  if (aTask == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  tsem_init(&done, 0, 0);
+
+  for (int32_t iTask = 0; iTask < nTask; iTask++) {
+    aTask[iTask].pVnode = pVnode;
+    aTask[iTask].version = version;
+    aTask[iTask].pSubmitReq = pSubmitReq;
+    aTask[iTask].iTask = iTask;
+    aTask[iTask].nTask = nTask;
+  }
+
+  // the write thread takes the first share itself
+  for (int32_t iTask = 1; iTask < nTask; iTask++) {
+    aTask[iTask].pDone = &done;
+    if (vnodeScheduleInsertTask(vnodeInsertTableDataTask, &aTask[iTask]) < 0) {
+      aTask[iTask].pDone = NULL;
+      vnodeInsertTableDataTask(&aTask[iTask]);
+    } else {
+      nWait++;
+    }
+  }
+  vnodeInsertTableDataTask(&aTask[0]);
+
+  while (nWait-- > 0) {
+    tsem_wait(&done);
+  }
+
+  for (int32_t iTask = 0; iTask < nTask; iTask++) {
+    *affectedRows += aTask[iTask].affectedRows;
+    if (code == 0) code = aTask[iTask].code;
+  }
+
+  tsem_destroy(&done);
+  taosMemoryFree(aTask);
+  return code;
+}
+
 static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp) {
   int32_t code = 0;
   terrno = 0;
@@ -1353,7 +1437,9 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t version, void *pReq
       }
     }
 
-    // insert data
+    // insert data, in parallel insert mode all tables are inserted after the loop
+    if (tsNumOfVnodeInsertThreads > 1) continue;
+
     int32_t affectedRows;
     code = tsdbInsertTableData(pVnode->pTsdb, version, pSubmitTbData, &affectedRows);
     if (code) goto _exit;
@@ -1361,6 +1447,13 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t version, void *pReq
     pSubmitRsp->affectedRows += affectedRows;
   }
 
+  if (tsNumOfVnodeInsertThreads > 1) {
+    int32_t affectedRows = 0;
+    code = vnodeParallelInsertTableData(pVnode, version, pSubmitReq, &affectedRows);
+    pSubmitRsp->affectedRows += affectedRows;
+    if (code) goto _exit;
+  }
+
   // update the affected table uid list
   if (taosArrayGetSize(newTbUids) > 0) {
     vDebug("vgId:%d, add %d table into query table list in handling submit", TD_VID(pVnode),
@@ -20,7 +20,34 @@
 
 static inline bool vnodeIsMsgWeak(tmsg_t type) { return false; }
 
+// with wal group commit, a write is acknowledged after the group it belongs to is durable
+static void vnodeFlushWriteRsp(SVnode *pVnode) {
+  int32_t nRsp = taosArrayGetSize(pVnode->aPendingRsp);
+  int32_t code = 0;
+  if (nRsp == 0 && !walInGroupCommit(pVnode->pWal)) return;
+
+  if (syncFlushLog(pVnode->sync) < 0) {
+    code = terrno;
+    vError("vgId:%d, failed to flush wal since %s, %d write rsp fail", pVnode->config.vgId, tstrerror(code), nRsp);
+  }
+
+  for (int32_t i = 0; i < nRsp; i++) {
+    SRpcMsg *pRsp = taosArrayGet(pVnode->aPendingRsp, i);
+    if (code != 0 && pRsp->code == 0) {
+      rpcFreeCont(pRsp->pCont);
+      pRsp->pCont = NULL;
+      pRsp->contLen = 0;
+      pRsp->code = code;
+    }
+    tmsgSendRsp(pRsp);
+  }
+  taosArrayClear(pVnode->aPendingRsp);
+}
+
 static inline void vnodeWaitBlockMsg(SVnode *pVnode, const SRpcMsg *pMsg) {
+  // the blocking msg may wait for the pending ones to be committed
+  vnodeFlushWriteRsp(pVnode);
+
   const STraceId *trace = &pMsg->info.traceId;
   vGTrace("vgId:%d, msg:%p wait block, type:%s sec:%d seq:%" PRId64, pVnode->config.vgId, pMsg,
           TMSG_INFO(pMsg->msgType), pVnode->blockSec, pVnode->blockSeq);
@@ -80,7 +107,9 @@ static void inline vnodeHandleWriteMsg(SVnode *pVnode, SRpcMsg *pMsg) {
     vGError("vgId:%d, msg:%p failed to apply right now since %s", pVnode->config.vgId, pMsg, terrstr());
   }
   if (rsp.info.handle != NULL) {
-    tmsgSendRsp(&rsp);
+    if (!walInGroupCommit(pVnode->pWal) || taosArrayPush(pVnode->aPendingRsp, &rsp) == NULL) {
+      tmsgSendRsp(&rsp);
+    }
   } else {
     if (rsp.pCont) {
       rpcFreeCont(rsp.pCont);
@@ -310,6 +339,8 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
     rpcFreeCont(pMsg->pCont);
     taosFreeQitem(pMsg);
   }
+
+  vnodeFlushWriteRsp(pVnode);
 }
 
 #endif
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "tq.h"
+
+namespace {
+
+const int32_t NUM_OF_VERS = 64;
+
+// version ver holds ver % 3 + 1 tables, each with a ts and a bigint column of 4000 + ver rows
+int32_t numOfTables(int64_t ver) { return ver % 3 + 1; }
+int32_t numOfRows(int64_t ver) { return 4000 + ver; }
+int64_t valueOf(int64_t ver, int32_t iTb, int32_t iRow) { return ver * 1000000 + iTb * 10000 + iRow; }
+
+void* buildSubmitMsg(int64_t ver, int32_t* pLen) {
+  SSubmitReq2 req = {0};
+  req.aSubmitTbData = taosArrayInit(numOfTables(ver), sizeof(SSubmitTbData));
+
+  for (int32_t iTb = 0; iTb < numOfTables(ver); iTb++) {
+    SSubmitTbData tbData = {0};
+    tbData.flags = SUBMIT_REQ_COLUMN_DATA_FORMAT;
+    tbData.suid = 100;
+    tbData.uid = 1000 + iTb;
+    tbData.sver = 1;
+    tbData.aCol = taosArrayInit(2, sizeof(SColData));
+
+    SColData* pTs = (SColData*)taosArrayReserve(tbData.aCol, 1);
+    SColData* pVal = (SColData*)taosArrayReserve(tbData.aCol, 1);
+    tColDataInit(pTs, PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, 0);
+    tColDataInit(pVal, PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_BIGINT, 0);
+    for (int32_t iRow = 0; iRow < numOfRows(ver); iRow++) {
+      SValue  ts = {.val = 1600000000000 + iRow};
+      SValue  val = {.val = valueOf(ver, iTb, iRow)};
+      SColVal cv = COL_VAL_VALUE(pTs->cid, pTs->type, ts);
+      tColDataAppendValue(pTs, &cv);
+      cv = COL_VAL_VALUE(pVal->cid, pVal->type, val);
+      tColDataAppendValue(pVal, &cv);
+    }
+
+    taosArrayPush(req.aSubmitTbData, &tbData);
+  }
+
+  int32_t len = 0;
+  int32_t code = 0;
+  tEncodeSize(tEncodeSSubmitReq2, &req, len, code);
+
+  int32_t         msgLen = sizeof(SSubmitReq2Msg) + len;
+  SSubmitReq2Msg* pMsg = (SSubmitReq2Msg*)taosMemoryCalloc(1, msgLen);
+  pMsg->version = ver;
+
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, (uint8_t*)pMsg->data, len);
+  tEncodeSSubmitReq2(&encoder, &req);
+  tEncoderClear(&encoder);
+
+  tDestroySSubmitReq(&req, TSDB_MSG_FLG_ENCODE);
+  *pLen = msgLen;
+  return pMsg;
+}
+
+// the submit the reader is on must be exactly the one written at its version
+void checkSubmit(STqReader* pReader) {
+  int64_t ver = pReader->msg2.ver;
+  ASSERT_EQ(taosArrayGetSize(pReader->submit.aSubmitTbData), numOfTables(ver));
+
+  for (int32_t iTb = 0; iTb < numOfTables(ver); iTb++) {
+    SSubmitTbData* pTbData = (SSubmitTbData*)taosArrayGet(pReader->submit.aSubmitTbData, iTb);
+    ASSERT_EQ(pTbData->uid, 1000 + iTb);
+    ASSERT_EQ(taosArrayGetSize(pTbData->aCol), 2);
+
+    SColData* pVal = (SColData*)taosArrayGet(pTbData->aCol, 1);
+    ASSERT_EQ(pVal->nVal, numOfRows(ver));
+    for (int32_t iRow = 0; iRow < pVal->nVal; iRow++) {
+      SColVal cv;
+      tColDataGetValue(pVal, iRow, &cv);
+      ASSERT_EQ(cv.value.val, valueOf(ver, iTb, iRow));
+    }
+  }
+}
+
+// done with the msg, as a scan is once it has gone through all its blocks
+void finishSubmit(STqReader* pReader) {
+  while (tqNextBlockImpl(pReader)) {
+    pReader->nextBlk++;
+  }
+}
+
+}  // namespace
+
+class TqDecodeCacheEnv : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() { ASSERT_EQ(walInit(), 0); }
+
+  static void TearDownTestCase() { walCleanUp(); }
+
+  void SetUp() override {
+    taosRemoveDir(pathName);
+
+    SWalCfg cfg = {0};
+    cfg.rollPeriod = -1;
+    cfg.segSize = -1;
+    cfg.level = TAOS_WAL_WRITE;
+    pVnode = (SVnode*)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->pWal = walOpen(pathName, &cfg);
+    ASSERT_NE(pVnode->pWal, nullptr);
+
+    for (int64_t ver = 0; ver < NUM_OF_VERS; ver++) {
+      int32_t len = 0;
+      void*   pMsg = buildSubmitMsg(ver, &len);
+      ASSERT_EQ(walAppendLog(pVnode->pWal, ver, TDMT_VND_SUBMIT, SWalSyncInfo{0}, pMsg, len), ver);
+      taosMemoryFree(pMsg);
+    }
+    walCommit(pVnode->pWal, NUM_OF_VERS - 1);
+    walApplyVer(pVnode->pWal, NUM_OF_VERS - 1);
+  }
+
+  void TearDown() override {
+    closeTq();
+    walClose(pVnode->pWal);
+    taosMemoryFree(pVnode);
+    tsTqDecodeCacheSize = 16;
+  }
+
+  void openTq(int32_t cacheSize) {
+    tsTqDecodeCacheSize = cacheSize;
+    pTq = (STQ*)taosMemoryCalloc(1, sizeof(STQ));
+    pTq->pVnode = pVnode;
+    pVnode->pTq = pTq;
+    ASSERT_EQ(tqDecodeCacheOpen(pTq), 0);
+  }
+
+  void closeTq() {
+    if (pTq != NULL) {
+      tqDecodeCacheClose(pTq);
+      taosMemoryFree(pTq);
+      pVnode->pTq = pTq = NULL;
+    }
+  }
+
+  // the readers start at the given versions and take turns reading one msg each until all reach the end
+  void readInTurns(const std::vector<int64_t>& startVers) {
+    std::vector<STqReader*> readers;
+    for (int64_t ver : startVers) {
+      STqReader* pReader = tqReaderOpen(pVnode);
+      ASSERT_EQ(tqSeekVer(pReader, ver, ""), 0);
+      readers.push_back(pReader);
+    }
+
+    std::vector<int64_t> nextVers(startVers);
+    for (bool more = true; more;) {
+      more = false;
+      for (int32_t i = 0; i < readers.size(); i++) {
+        if (tqReaderNextSubmitMsg(readers[i]) < 0) {
+          ASSERT_EQ(nextVers[i], NUM_OF_VERS);
+          continue;
+        }
+
+        ASSERT_EQ(readers[i]->msg2.ver, nextVers[i]++);
+        checkSubmit(readers[i]);
+        finishSubmit(readers[i]);
+        more = true;
+      }
+    }
+
+    for (STqReader* pReader : readers) {
+      tqCloseReader(pReader);
+    }
+  }
+
+  SVnode*     pVnode = NULL;
+  STQ*        pTq = NULL;
+  const char* pathName = TD_TMP_DIR_PATH "tq_decode_cache_test";
+};
+
+TEST_F(TqDecodeCacheEnv, readersAtDifferentPositions) {
+  openTq(16);
+  readInTurns({0, 5, 20, 40});
+
+  // the readers behind take what the first reader on a version has decoded
+  EXPECT_GT(pTq->decodeCacheHit, 0);
+  EXPECT_EQ(pTq->decodeCacheMiss, NUM_OF_VERS);
+  EXPECT_EQ(pTq->decodeCacheHit, (NUM_OF_VERS - 0) + (NUM_OF_VERS - 5) + (NUM_OF_VERS - 20) + (NUM_OF_VERS - 40) -
+                                     NUM_OF_VERS);
+}
+
+TEST_F(TqDecodeCacheEnv, sameMsgsWithoutCache) {
+  openTq(0);
+  ASSERT_EQ(pTq->pDecodeCache, nullptr);
+  readInTurns({0, 5, 20, 40});
+
+  EXPECT_EQ(pTq->decodeCacheHit, 0);
+  EXPECT_EQ(pTq->decodeCacheMiss, 0);
+}
+
+TEST_F(TqDecodeCacheEnv, singleReaderDoesNotInsert) {
+  openTq(16);
+  readInTurns({0});
+
+  EXPECT_EQ(taosLRUCacheGetElems(pTq->pDecodeCache), 0);
+  EXPECT_EQ(pTq->decodeCacheHit, 0);
+  EXPECT_EQ(pTq->decodeCacheMiss, 0);
+}
+
+TEST_F(TqDecodeCacheEnv, evictionWhileInUse) {
+  // every decoded msg is larger than its shard of the cache, so an entry is dropped as soon as nobody uses it
+  openTq(1);
+  taosLRUCacheSetCapacity(pTq->pDecodeCache, 64 * 1024);
+
+  STqReader* pHolder = tqReaderOpen(pVnode);
+  STqReader* pAhead = tqReaderOpen(pVnode);
+  STqReader* pBehind = tqReaderOpen(pVnode);
+  ASSERT_EQ(tqSeekVer(pHolder, 3, ""), 0);
+  ASSERT_EQ(tqSeekVer(pAhead, 3, ""), 0);
+  ASSERT_EQ(tqSeekVer(pBehind, 3, ""), 0);
+
+  // the holder decodes version 3 and keeps it, another reader takes it from the cache
+  ASSERT_EQ(tqReaderNextSubmitMsg(pHolder), 0);
+  ASSERT_EQ(tqReaderNextSubmitMsg(pAhead), 0);
+  ASSERT_NE(pHolder->pCachedSubmit, nullptr);
+  ASSERT_NE(pAhead->pCachedSubmit, nullptr);
+  EXPECT_EQ(pTq->decodeCacheHit, 1);
+  EXPECT_EQ(pTq->decodeCacheMiss, 1);
+
+  // the other reader reads on, which evicts every entry but the one still in use
+  finishSubmit(pAhead);
+  while (tqReaderNextSubmitMsg(pAhead) == 0) {
+    checkSubmit(pAhead);
+    finishSubmit(pAhead);
+  }
+  EXPECT_EQ(pTq->decodeCacheMiss, NUM_OF_VERS - 3);
+  EXPECT_EQ(taosLRUCacheGetElems(pTq->pDecodeCache), 1);
+
+  SPackedData msg = {0};
+  void*       pHandle = tqDecodeCacheLookup(pTq, 3, &msg, NULL);
+  ASSERT_NE(pHandle, nullptr);
+  tqDecodeCacheRelease(pTq, pHandle);
+  checkSubmit(pHolder);
+
+  // once the holder is done, the entry goes and a reader coming later decodes the version again
+  finishSubmit(pHolder);
+  EXPECT_EQ(pHolder->pCachedSubmit, nullptr);
+  EXPECT_EQ(taosLRUCacheGetElems(pTq->pDecodeCache), 0);
+  EXPECT_EQ(tqDecodeCacheLookup(pTq, 3, &msg, NULL), nullptr);
+
+  ASSERT_EQ(tqReaderNextSubmitMsg(pBehind), 0);
+  EXPECT_EQ(pBehind->msg2.ver, 3);
+  EXPECT_EQ(pTq->decodeCacheMiss, NUM_OF_VERS - 3 + 1);
+  checkSubmit(pBehind);
+
+  tqCloseReader(pHolder);
+  tqCloseReader(pAhead);
+  tqCloseReader(pBehind);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "tsdb.h"
+
+namespace {
+
+const uint64_t SUID = 100;
+const uint64_t UID = 1;
+const int32_t  NUM_OF_BLOCKS = 32;
+const int32_t  READ_AHEAD_BLOCKS = 4;  // as many blocks as the tsdb reader reads ahead
+
+// the blocks are of different sizes, so that they start and end anywhere in a page
+int32_t numOfRows(int32_t iBlk) { return 100 + 97 * iBlk; }
+TSKEY   keyOf(int32_t iBlk, int32_t iRow) { return (TSKEY)iBlk * 100000 + iRow; }
+int64_t valueOf(int32_t iBlk, int32_t iRow) { return (int64_t)iBlk * 1000003 + (int64_t)iRow * 7919; }
+
+}  // namespace
+
+// A data file of NUM_OF_BLOCKS blocks of one table is written through SDataFWriter as a commit writes it. The blocks
+// are read back as a whole, which leaves their raw bytes in the reader's buffer, and compared with the same block read
+// by a reader that never reads ahead and reads no page through the page cache.
+class TsdbDataFileEnv : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(pathName);
+    char dir[TSDB_FILENAME_LEN];
+    snprintf(dir, sizeof(dir), "%s%s%s", pathName, TD_DIRSEP, "tsdb");
+    ASSERT_EQ(taosMulMkDir(dir), 0);
+
+    SDiskCfg dCfg = {0};
+    tstrncpy(dCfg.dir, pathName, TSDB_FILENAME_LEN);
+    dCfg.level = 0;
+    dCfg.primary = 1;
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->config.vgId = 2;
+    pVnode->config.tsdbPageSize = 4096;
+    pVnode->pTfs = tfsOpen(&dCfg, 1);
+    ASSERT_NE(pVnode->pTfs, nullptr);
+
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pTsdb->path = (char *)"tsdb";
+    pTsdb->pVnode = pVnode;
+    pVnode->pTsdb = pTsdb;
+
+    fHead = (SHeadFile){.commitID = 1};
+    fData = (SDataFile){.commitID = 1};
+    fSma = (SSmaFile){.commitID = 1};
+    fStt = (SSttFile){.commitID = 1};
+    fSet = (SDFileSet){.fid = 1700, .pHeadF = &fHead, .pDataF = &fData, .pSmaF = &fSma, .nSttF = 1};
+    fSet.aSttF[0] = &fStt;
+
+    writeDataFile();
+    ASSERT_EQ(tBlockDataCreate(&bData), 0);
+    ASSERT_EQ(tBlockDataCreate(&bDataPlain), 0);
+    ASSERT_EQ(tsdbDataFReaderOpen(&pPlainReader, pTsdb, &fSet), 0);
+  }
+
+  void TearDown() override {
+    tsdbDataFReaderClose(&pPlainReader);
+    if (pTsdb != NULL && pTsdb->pgCache != NULL) {
+      taosLRUCacheEraseUnrefEntries(pTsdb->pgCache);
+      taosLRUCacheCleanup(pTsdb->pgCache);
+      pTsdb->pgCache = NULL;
+    }
+    tBlockDataDestroy(&bDataPlain);
+    tBlockDataDestroy(&bData);
+    if (pVnode != NULL) {
+      tfsClose(pVnode->pTfs);
+      taosMemoryFree(pTsdb);
+      taosMemoryFree(pVnode);
+    }
+    taosRemoveDir(pathName);
+  }
+
+  void writeDataFile() {
+    SSchema aSchema[] = {
+        {.type = TSDB_DATA_TYPE_TIMESTAMP, .flags = COL_SMA_ON, .colId = PRIMARYKEY_TIMESTAMP_COL_ID, .bytes = 8},
+        {.type = TSDB_DATA_TYPE_BIGINT, .flags = COL_SMA_ON, .colId = PRIMARYKEY_TIMESTAMP_COL_ID + 1, .bytes = 8}};
+    STSchema *pTSchema = tBuildTSchema(aSchema, 2, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    SDataFWriter *pWriter = NULL;
+    ASSERT_EQ(tsdbDataFWriterOpen(&pWriter, pTsdb, &fSet), 0);
+
+    SBlockData data;
+    TABLEID    id = {.suid = SUID, .uid = UID};
+    SArray    *aColVal = taosArrayInit(2, sizeof(SColVal));
+    ASSERT_EQ(tBlockDataCreate(&data), 0);
+    ASSERT_EQ(tBlockDataInit(&data, &id, pTSchema, NULL, 0), 0);
+
+    for (int32_t iBlk = 0; iBlk < NUM_OF_BLOCKS; ++iBlk) {
+      for (int32_t iRow = 0; iRow < numOfRows(iBlk); ++iRow) {
+        SColVal cv[2] = {
+            COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, (SValue){.val = keyOf(iBlk, iRow)}),
+            COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_BIGINT, (SValue){.val = valueOf(iBlk, iRow)})};
+        SRow *pRow = NULL;
+        taosArrayClear(aColVal);
+        taosArrayPush(aColVal, &cv[0]);
+        taosArrayPush(aColVal, &cv[1]);
+        ASSERT_EQ(tRowBuild(aColVal, pTSchema, &pRow), 0);
+
+        TSDBROW row = tsdbRowFromTSRow(iBlk + 1, pRow);
+        ASSERT_EQ(tBlockDataAppendRow(&data, &row, pTSchema, UID), 0);
+        taosMemoryFree(pRow);
+      }
+
+      SDataBlk blk = {0};
+      blk.nRow = data.nRow;
+      blk.nSubBlock = 1;
+      ASSERT_EQ(tsdbWriteBlockData(pWriter, &data, &blk.aSubBlock[0], &blk.smaInfo, NO_COMPRESSION, 0), 0);
+      aDataBlk.push_back(blk);
+      tBlockDataClear(&data);
+    }
+
+    SArray *aSttBlk = taosArrayInit(0, sizeof(SSttBlk));
+    SArray *aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx));
+    ASSERT_EQ(tsdbWriteSttBlk(pWriter, aSttBlk), 0);
+    ASSERT_EQ(tsdbWriteBlockIdx(pWriter, aBlockIdx), 0);
+    ASSERT_EQ(tsdbUpdateDFileSetHeader(pWriter), 0);
+
+    // the file set as the commit updates it in the file system
+    fHead = pWriter->fHead;
+    fData = pWriter->fData;
+    fSma = pWriter->fSma;
+    fStt = pWriter->fStt[0];
+    ASSERT_EQ(tsdbDataFWriterClose(&pWriter, 1), 0);
+
+    taosArrayDestroy(aBlockIdx);
+    taosArrayDestroy(aSttBlk);
+    taosArrayDestroy(aColVal);
+    tBlockDataDestroy(&data);
+    tDestroyTSchema(pTSchema);
+  }
+
+  // the page cache as the vnode opens it, only the readers opened after it read through it
+  void openPageCache(size_t capacity) {
+    pTsdb->pgCache = taosLRUCacheInit(capacity, 2, .5);
+    ASSERT_NE(pTsdb->pgCache, nullptr);
+    taosLRUCacheSetStrictCapacity(pTsdb->pgCache, true);
+  }
+
+  // the number of pages of the data file the blocks of [sBlk, eBlk] are in
+  int64_t numOfPages(int32_t sBlk, int32_t eBlk) {
+    int32_t szPage = pVnode->config.tsdbPageSize;
+    int64_t sOffset = aDataBlk[sBlk].aSubBlock[0].offset;
+    int64_t eOffset = aDataBlk[eBlk].aSubBlock[0].offset + aDataBlk[eBlk].aSubBlock[0].szBlock - 1;
+    return OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(eOffset, szPage), szPage) -
+           OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(sOffset, szPage), szPage) + 1;
+  }
+
+  // read ahead the blocks of [sBlk, eBlk] as one range of the file
+  void readAhead(SDataFReader *pReader, int32_t sBlk, int32_t eBlk, int64_t extraSize = 0) {
+    SDataBlk blk = aDataBlk[sBlk];
+    blk.aSubBlock[0].szBlock =
+        aDataBlk[eBlk].aSubBlock[0].offset + aDataBlk[eBlk].aSubBlock[0].szBlock - blk.aSubBlock[0].offset + extraSize;
+    EXPECT_EQ(tsdbPrefetchDataBlock(pReader, &blk), 0);
+  }
+
+  // the raw bytes of the block must be the ones a plain read gets, and decode to the rows written
+  void checkBlock(SDataFReader *pReader, int32_t iBlk) {
+    SBlockInfo *pBlkInfo = &aDataBlk[iBlk].aSubBlock[0];
+    ASSERT_EQ(tsdbReadDataBlockEx(pReader, &aDataBlk[iBlk], &bData), 0);
+    ASSERT_EQ(tsdbReadDataBlockEx(pPlainReader, &aDataBlk[iBlk], &bDataPlain), 0);
+    ASSERT_EQ(memcmp(pReader->aBuf[0], pPlainReader->aBuf[0], pBlkInfo->szBlock), 0) << "block " << iBlk;
+
+    ASSERT_EQ(bData.nRow, numOfRows(iBlk));
+    ASSERT_EQ(bData.nColData, 1);
+    SColData *pColData = tBlockDataGetColDataByIdx(&bData, 0);
+    for (int32_t iRow = 0; iRow < bData.nRow; ++iRow) {
+      SColVal cv;
+      tColDataGetValue(pColData, iRow, &cv);
+      ASSERT_EQ(bData.aTSKEY[iRow], keyOf(iBlk, iRow));
+      ASSERT_EQ(bData.aVersion[iRow], iBlk + 1);
+      ASSERT_EQ(cv.value.val, valueOf(iBlk, iRow));
+    }
+  }
+
+  SVnode               *pVnode = NULL;
+  STsdb                *pTsdb = NULL;
+  SHeadFile             fHead;
+  SDataFile             fData;
+  SSmaFile              fSma;
+  SSttFile              fStt;
+  SDFileSet             fSet;
+  std::vector<SDataBlk> aDataBlk;
+  SBlockData            bData;
+  SBlockData            bDataPlain;
+  SDataFReader         *pPlainReader = NULL;
+  const char           *pathName = TD_TMP_DIR_PATH "tsdb_data_file_test";
+};
+
+TEST_F(TsdbDataFileEnv, sequentialReadAhead) {
+  SDataFReader *pReader = NULL;
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+
+  // as the tsdb reader does, each block is read ahead once, READ_AHEAD_BLOCKS blocks before it is read
+  int32_t prefetched = 0;
+  for (int32_t iBlk = 0; iBlk < NUM_OF_BLOCKS; ++iBlk) {
+    for (; prefetched < NUM_OF_BLOCKS && prefetched <= iBlk + READ_AHEAD_BLOCKS; ++prefetched) {
+      ASSERT_EQ(tsdbPrefetchDataBlock(pReader, &aDataBlk[prefetched]), 0);
+    }
+    checkBlock(pReader, iBlk);
+  }
+
+  tsdbDataFReaderClose(&pReader);
+}
+
+TEST_F(TsdbDataFileEnv, randomReadAhead) {
+  SDataFReader *pReader = NULL;
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+
+  std::vector<int32_t> order;
+  for (int32_t iBlk = 0; iBlk < NUM_OF_BLOCKS; ++iBlk) order.push_back(iBlk);
+
+  std::mt19937 rng(NUM_OF_BLOCKS);
+  for (int32_t round = 0; round < 4; ++round) {
+    std::shuffle(order.begin(), order.end(), rng);
+    for (int32_t i = 0; i < NUM_OF_BLOCKS; ++i) {
+      for (int32_t j = i + 1; j < NUM_OF_BLOCKS && j <= i + READ_AHEAD_BLOCKS; ++j) {
+        ASSERT_EQ(tsdbPrefetchDataBlock(pReader, &aDataBlk[order[j]]), 0);
+      }
+      checkBlock(pReader, order[i]);
+    }
+  }
+
+  tsdbDataFReaderClose(&pReader);
+}
+
+TEST_F(TsdbDataFileEnv, readAheadWindowAcrossBlocks) {
+  SDataFReader *pReader = NULL;
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+
+  // the window starts in the page the reader is on, and the blocks are read from its end backward
+  checkBlock(pReader, 2);
+  readAhead(pReader, 3, 10);
+  for (int32_t iBlk = 10; iBlk >= 3; --iBlk) {
+    checkBlock(pReader, iBlk);
+  }
+
+  // a window over blocks already read, and one inside a single block
+  readAhead(pReader, 0, 10);
+  checkBlock(pReader, 5);
+  readAhead(pReader, 20, 20);
+  checkBlock(pReader, 20);
+  checkBlock(pReader, 0);
+
+  tsdbDataFReaderClose(&pReader);
+}
+
+TEST_F(TsdbDataFileEnv, readAheadAtEndOfFile) {
+  SDataFReader *pReader = NULL;
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+
+  int32_t lastBlk = NUM_OF_BLOCKS - 1;
+  int32_t szPage = pVnode->config.tsdbPageSize;
+  ASSERT_EQ(aDataBlk[lastBlk].aSubBlock[0].offset + aDataBlk[lastBlk].aSubBlock[0].szBlock, fData.size);
+
+  // the last block up to the end of the file, and windows going past it
+  readAhead(pReader, lastBlk, lastBlk);
+  checkBlock(pReader, lastBlk);
+  readAhead(pReader, lastBlk - 2, lastBlk, 1);
+  readAhead(pReader, lastBlk - 2, lastBlk, 100 * szPage);
+  checkBlock(pReader, lastBlk - 2);
+  checkBlock(pReader, lastBlk - 1);
+  checkBlock(pReader, lastBlk);
+
+  // a window entirely behind the end of the file is only a hint as well
+  SDataBlk blk = aDataBlk[lastBlk];
+  blk.aSubBlock[0].offset = fData.size + 10 * szPage;
+  EXPECT_EQ(tsdbPrefetchDataBlock(pReader, &blk), 0);
+  checkBlock(pReader, lastBlk);
+  checkBlock(pReader, 0);
+
+  tsdbDataFReaderClose(&pReader);
+}
+
+TEST_F(TsdbDataFileEnv, pageCacheHitsAndMisses) {
+  openPageCache(16 * 1024 * 1024);
+
+  // the first reader reads every page once from the file, and the second one finds them all in the cache
+  SDataFReader *pReader = NULL;
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+  for (int32_t iBlk = 0; iBlk < NUM_OF_BLOCKS; ++iBlk) {
+    checkBlock(pReader, iBlk);
+  }
+  tsdbDataFReaderClose(&pReader);
+
+  int64_t nPage = numOfPages(0, NUM_OF_BLOCKS - 1);
+  ASSERT_EQ(tsdbPageCacheGetHits(pVnode), 0);
+  ASSERT_EQ(tsdbPageCacheGetMisses(pVnode), nPage);
+  ASSERT_EQ(taosLRUCacheGetElems(pTsdb->pgCache), nPage);
+
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+  for (int32_t iBlk = 0; iBlk < NUM_OF_BLOCKS; ++iBlk) {
+    checkBlock(pReader, iBlk);
+  }
+
+  // the page the reader is on stays referenced until the reader is closed
+  ASSERT_GT(taosLRUCacheGetPinnedUsage(pTsdb->pgCache), 0);
+  tsdbDataFReaderClose(&pReader);
+  ASSERT_EQ(taosLRUCacheGetPinnedUsage(pTsdb->pgCache), 0);
+
+  ASSERT_EQ(tsdbPageCacheGetHits(pVnode), nPage);
+  ASSERT_EQ(tsdbPageCacheGetMisses(pVnode), nPage);
+}
+
+TEST_F(TsdbDataFileEnv, pageCacheEviction) {
+  int32_t szPage = pVnode->config.tsdbPageSize;
+  openPageCache(8 * szPage);
+
+  SDataFReader *pReader = NULL;
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+  for (int32_t iBlk = 0; iBlk < NUM_OF_BLOCKS; ++iBlk) {
+    checkBlock(pReader, iBlk);
+  }
+  tsdbDataFReaderClose(&pReader);
+
+  int64_t nPage = numOfPages(0, NUM_OF_BLOCKS - 1);
+  ASSERT_EQ(tsdbPageCacheGetMisses(pVnode), nPage);
+  ASSERT_LE(taosLRUCacheGetUsage(pTsdb->pgCache), 8 * szPage);
+  ASSERT_LT(taosLRUCacheGetElems(pTsdb->pgCache), nPage);
+
+  // the pages of the first blocks have been evicted by the ones read after them, and are read from the file again
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+  checkBlock(pReader, 0);
+  checkBlock(pReader, 1);
+  tsdbDataFReaderClose(&pReader);
+
+  ASSERT_EQ(tsdbPageCacheGetHits(pVnode), 0);
+  ASSERT_EQ(tsdbPageCacheGetMisses(pVnode), nPage + numOfPages(0, 1));
+  ASSERT_LE(taosLRUCacheGetUsage(pTsdb->pgCache), 8 * szPage);
+}
+
+TEST_F(TsdbDataFileEnv, pageCacheKeepsReadPage) {
+  openPageCache(16 * 1024 * 1024);
+
+  SDataFReader *pReader = NULL;
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+  for (int32_t iBlk = 0; iBlk < NUM_OF_BLOCKS; ++iBlk) {
+    checkBlock(pReader, iBlk);
+  }
+  tsdbDataFReaderClose(&pReader);
+
+  // the reader stops on the last page of block 10 it found in the cache, which is the first page of block 11
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+  checkBlock(pReader, 10);
+  ASSERT_EQ(tsdbPageCacheGetHits(pVnode), numOfPages(10, 10));
+
+  // evicting everything from the cache leaves only the page the reader is on, which it keeps reading in place
+  taosLRUCacheSetCapacity(pTsdb->pgCache, 0);
+  ASSERT_EQ(taosLRUCacheGetElems(pTsdb->pgCache), 1);
+  checkBlock(pReader, 11);
+  checkBlock(pReader, 10);
+
+  // the page is freed once the reader has moved off it, and nothing else fits into the cache
+  ASSERT_EQ(taosLRUCacheGetElems(pTsdb->pgCache), 0);
+  ASSERT_EQ(taosLRUCacheGetUsage(pTsdb->pgCache), 0);
+  tsdbDataFReaderClose(&pReader);
+}
+
+#pragma GCC diagnostic pop
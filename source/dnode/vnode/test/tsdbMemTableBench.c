@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures memtable insert throughput of one vnode with a growing number of write threads, each thread writing its
+// own subset of child tables.
+
+#include "tglobal.h"
+#include "tsdb.h"
+#include "vnd.h"
+
+typedef struct {
+  int32_t  index;
+  int32_t  nThread;
+  int32_t  nTable;
+  int32_t  nBatch;
+  int32_t  nRowPerBatch;
+  int32_t  code;
+  STsdb   *pTsdb;
+  TdThread thread;
+} SBenchInfo;
+
+static volatile int64_t benchVersion = 0;
+
+static void *benchInsertFp(void *param) {
+  SBenchInfo *pInfo = (SBenchInfo *)param;
+  SArray     *aRowP = taosArrayInit(pInfo->nRowPerBatch, sizeof(SRow *));
+  int32_t     rowLen = sizeof(SRow) + 32;
+
+  // each thread allocates from its own slab of the buffer pool, as the parallel insert tasks do
+  vnodeBufPoolSetSlab(pInfo->index);
+
+  for (int32_t iRow = 0; iRow < pInfo->nRowPerBatch; iRow++) {
+    SRow *pRow = taosMemoryCalloc(1, rowLen);
+    pRow->len = rowLen;
+    taosArrayPush(aRowP, &pRow);
+  }
+
+  for (int32_t iBatch = 0; iBatch < pInfo->nBatch; iBatch++) {
+    for (int32_t iTable = pInfo->index; iTable < pInfo->nTable; iTable += pInfo->nThread) {
+      SSubmitTbData tbData = {.suid = 1, .uid = iTable + 100, .aRowP = aRowP};
+
+      for (int32_t iRow = 0; iRow < pInfo->nRowPerBatch; iRow++) {
+        ((SRow *)taosArrayGetP(aRowP, iRow))->ts = (int64_t)iBatch * pInfo->nRowPerBatch + iRow;
+      }
+
+      int32_t affectedRows = 0;
+      int64_t version = atomic_add_fetch_64(&benchVersion, 1);
+      pInfo->code = tsdbInsertTableData(pInfo->pTsdb, version, &tbData, &affectedRows);
+      if (pInfo->code) goto _exit;
+    }
+  }
+
+_exit:
+  for (int32_t iRow = 0; iRow < pInfo->nRowPerBatch; iRow++) {
+    taosMemoryFree(taosArrayGetP(aRowP, iRow));
+  }
+  taosArrayDestroy(aRowP);
+  vnodeBufPoolSetSlab(-1);
+  return NULL;
+}
+
+static int32_t benchRun(SVnode *pVnode, int32_t nThread, int32_t nTable, int32_t nBatch, int32_t nRowPerBatch) {
+  SVBufPool *pPool = pVnode->freeList;
+  SMemTable *pMemTable = NULL;
+
+  pVnode->inUse = pPool;
+  pPool->nRef = 1;
+  if (tsdbMemTableCreate(pVnode->pTsdb, &pMemTable) < 0) return -1;
+  pVnode->pTsdb->mem = pMemTable;
+
+  SBenchInfo *aInfo = taosMemoryCalloc(nThread, sizeof(SBenchInfo));
+  int64_t     start = taosGetTimestampUs();
+
+  for (int32_t i = 0; i < nThread; i++) {
+    aInfo[i].index = i;
+    aInfo[i].nThread = nThread;
+    aInfo[i].nTable = nTable;
+    aInfo[i].nBatch = nBatch;
+    aInfo[i].nRowPerBatch = nRowPerBatch;
+    aInfo[i].pTsdb = pVnode->pTsdb;
+    taosThreadCreate(&aInfo[i].thread, NULL, benchInsertFp, &aInfo[i]);
+  }
+
+  int32_t code = 0;
+  for (int32_t i = 0; i < nThread; i++) {
+    taosThreadJoin(aInfo[i].thread, NULL);
+    if (aInfo[i].code) code = aInfo[i].code;
+  }
+
+  double usedTime = (taosGetTimestampUs() - start) / 1000000.0;
+  printf("threads:%d tables:%d rows:%" PRId64 " used:%.3fs rows/sec:%.0f pool size:%" PRId64 "%s\n", nThread, nTable,
+         pMemTable->nRow, usedTime, pMemTable->nRow / usedTime, pPool->size, code ? " failed" : "");
+
+  pVnode->pTsdb->mem = NULL;
+  tsdbMemTableDestroy(pMemTable, false);
+  vnodeBufPoolReset(pPool);
+  taosMemoryFree(aInfo);
+  return code;
+}
+
+int main(int argc, char *argv[]) {
+  int32_t maxThreads = 8;
+  int32_t nTable = 10000;
+  int32_t nBatch = 10;
+  int32_t nRowPerBatch = 100;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      maxThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      nTable = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-b") == 0 && i < argc - 1) {
+      nBatch = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0 && i < argc - 1) {
+      nRowPerBatch = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-t threads]: max number of write threads, default is:%d\n", maxThreads);
+      printf("  [-n tables]: number of child tables, default is:%d\n", nTable);
+      printf("  [-b batches]: number of batches per table, default is:%d\n", nBatch);
+      printf("  [-r rows]: number of rows per batch, default is:%d\n", nRowPerBatch);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  // the buffer pool has a slab for each thread
+  tsNumOfVnodeInsertThreads = maxThreads;
+
+  SVnode *pVnode = taosMemoryCalloc(1, sizeof(SVnode));
+  pVnode->config.szBuf = 256 * 1024 * 1024;
+  pVnode->config.tsdbCfg.slLevel = 5;
+  pVnode->config.cacheLast = 0;
+  pVnode->pTsdb = taosMemoryCalloc(1, sizeof(STsdb));
+  pVnode->pTsdb->pVnode = pVnode;
+  if (vnodeOpenBufPool(pVnode) < 0) {
+    printf("failed to open buffer pool since %s\n", tstrerror(terrno));
+    return -1;
+  }
+
+  for (int32_t nThread = 1; nThread <= maxThreads; nThread <<= 1) {
+    if (benchRun(pVnode, nThread, nTable, nBatch, nRowPerBatch) < 0) break;
+  }
+
+  vnodeCloseBufPool(pVnode);
+  taosMemoryFree(pVnode->pTsdb);
+  taosMemoryFree(pVnode);
+  return 0;
+}
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "tsdb.h"
+#include "vnd.h"
+
+namespace {
+
+const tb_uid_t SUID = 1;
+const tb_uid_t UID = 100;
+
+// (ts, version), in the order of tsdbKeyCmprFn
+typedef std::pair<TSKEY, int64_t> Key;
+
+TSDBKEY makeKey(TSKEY ts, int64_t version) {
+  TSDBKEY key;
+  key.version = version;
+  key.ts = ts;
+  return key;
+}
+
+// the payload of a row tells the key it was written with
+int64_t rowTag(TSKEY ts, int64_t version) { return ts * 1000 + version; }
+
+std::vector<TSKEY> tsRange(TSKEY start, TSKEY end, TSKEY step = 1) {
+  std::vector<TSKEY> aTs;
+  for (TSKEY ts = start; ts < end; ts += step) aTs.push_back(ts);
+  return aTs;
+}
+
+}  // namespace
+
+// Rows are written through tsdbInsertTableData, so the in-order ones go to the append list and the others to the
+// skiplist, and the iterators are checked against the keys written, merged and sorted here.
+class TsdbMemTableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->config.szBuf = 64 * 1024 * 1024;
+    pVnode->config.tsdbCfg.slLevel = 5;
+    pVnode->config.cacheLast = 0;
+    pVnode->pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pVnode->pTsdb->pVnode = pVnode;
+    ASSERT_EQ(vnodeOpenBufPool(pVnode), 0);
+
+    pVnode->inUse = pVnode->freeList;
+    pVnode->inUse->nRef = 1;
+    ASSERT_EQ(tsdbMemTableCreate(pVnode->pTsdb, &pMemTable), 0);
+    pVnode->pTsdb->mem = pMemTable;
+  }
+
+  void TearDown() override {
+    pVnode->pTsdb->mem = NULL;
+    tsdbMemTableDestroy(pMemTable, false);
+    vnodeBufPoolReset(pVnode->inUse);
+    vnodeCloseBufPool(pVnode);
+    taosMemoryFree(pVnode->pTsdb);
+    taosMemoryFree(pVnode);
+  }
+
+  // one submit of rows in row format, the timestamps sorted as in a submit request
+  void insertRows(int64_t version, const std::vector<TSKEY> &aTs) {
+    SArray *aRowP = taosArrayInit(aTs.size(), sizeof(SRow *));
+    for (TSKEY ts : aTs) {
+      SRow *pRow = (SRow *)taosMemoryCalloc(1, sizeof(SRow) + sizeof(int64_t));
+      pRow->len = sizeof(SRow) + sizeof(int64_t);
+      pRow->ts = ts;
+      *(int64_t *)pRow->data = rowTag(ts, version);
+      taosArrayPush(aRowP, &pRow);
+    }
+
+    SSubmitTbData tbData = {0};
+    tbData.suid = SUID;
+    tbData.uid = UID;
+    tbData.aRowP = aRowP;
+
+    int32_t affectedRows = 0;
+    EXPECT_EQ(tsdbInsertTableData(pVnode->pTsdb, version, &tbData, &affectedRows), 0);
+    EXPECT_EQ(affectedRows, (int32_t)aTs.size());
+
+    for (int32_t i = 0; i < taosArrayGetSize(aRowP); i++) {
+      taosMemoryFree(taosArrayGetP(aRowP, i));
+    }
+    taosArrayDestroy(aRowP);
+    for (TSKEY ts : aTs) written.push_back(Key(ts, version));
+  }
+
+  // one submit of rows in column format, only the primary key column
+  void insertCols(int64_t version, const std::vector<TSKEY> &aTs) {
+    SColData colData;
+    memset(&colData, 0, sizeof(colData));
+    colData.cid = PRIMARYKEY_TIMESTAMP_COL_ID;
+    colData.type = TSDB_DATA_TYPE_TIMESTAMP;
+    colData.flag = HAS_VALUE;
+    colData.nVal = aTs.size();
+    colData.numOfValue = aTs.size();
+    colData.nData = aTs.size() * sizeof(TSKEY);
+    colData.pData = (uint8_t *)aTs.data();
+
+    SArray *aCol = taosArrayInit(1, sizeof(SColData));
+    taosArrayPush(aCol, &colData);
+
+    SSubmitTbData tbData = {0};
+    tbData.flags = SUBMIT_REQ_COLUMN_DATA_FORMAT;
+    tbData.suid = SUID;
+    tbData.uid = UID;
+    tbData.aCol = aCol;
+
+    int32_t affectedRows = 0;
+    EXPECT_EQ(tsdbInsertTableData(pVnode->pTsdb, version, &tbData, &affectedRows), 0);
+    EXPECT_EQ(affectedRows, (int32_t)aTs.size());
+
+    taosArrayDestroy(aCol);
+    for (TSKEY ts : aTs) written.push_back(Key(ts, version));
+  }
+
+  STbData *tbData() { return tsdbGetTbDataFromMemTable(pMemTable, SUID, UID); }
+
+  // the keys an iterator from pFrom should return
+  std::vector<Key> expected(const TSDBKEY *pFrom, int8_t backward) {
+    std::vector<Key> aKey;
+    for (const Key &key : written) {
+      if (pFrom) {
+        Key from(pFrom->ts, pFrom->version);
+        if (backward ? (key > from) : (key < from)) continue;
+      }
+      aKey.push_back(key);
+    }
+    std::sort(aKey.begin(), aKey.end());
+    if (backward) std::reverse(aKey.begin(), aKey.end());
+    return aKey;
+  }
+
+  // the keys returned by an iterator from pFrom, the way the readers go through them
+  std::vector<Key> scan(TSDBKEY *pFrom, int8_t backward) {
+    STbDataIter iter;
+    memset(&iter, 0, sizeof(iter));
+    tsdbTbDataIterOpen(tbData(), pFrom, backward, &iter);
+
+    std::vector<Key> aKey;
+    for (TSDBROW *pRow = tsdbTbDataIterGet(&iter); pRow; pRow = tsdbTbDataIterGet(&iter)) {
+      Key key(TSDBROW_TS(pRow), TSDBROW_VERSION(pRow));
+      if (pRow->type == TSDBROW_ROW_FMT) {
+        EXPECT_EQ(*(int64_t *)pRow->pTSRow->data, rowTag(key.first, key.second));
+      } else {
+        EXPECT_EQ(pRow->pBlockData->uid, UID);
+        EXPECT_LT(pRow->iRow, pRow->pBlockData->nRow);
+      }
+      // the current row is kept until the iterator moves
+      EXPECT_EQ(tsdbTbDataIterGet(&iter), pRow);
+      aKey.push_back(key);
+
+      bool hasNext = tsdbTbDataIterNext(&iter);
+      EXPECT_EQ(hasNext, tsdbTbDataIterGet(&iter) != NULL);
+      if ((int64_t)aKey.size() > (int64_t)written.size()) break;
+    }
+    return aKey;
+  }
+
+  void checkScan(TSDBKEY *pFrom, int8_t backward) {
+    std::vector<Key> res = scan(pFrom, backward);
+    std::vector<Key> exp = expected(pFrom, backward);
+    ASSERT_EQ(res.size(), exp.size()) << "from " << (pFrom ? pFrom->ts : -1) << "/" << (pFrom ? pFrom->version : -1)
+                                      << (backward ? " backward" : " forward");
+    for (size_t i = 0; i < exp.size(); i++) {
+      ASSERT_EQ(res[i], exp[i]) << "row " << i << " from " << (pFrom ? pFrom->ts : -1) << "/"
+                                << (pFrom ? pFrom->version : -1) << (backward ? " backward" : " forward");
+    }
+  }
+
+  void checkScans() {
+    checkScan(NULL, 0);
+    checkScan(NULL, 1);
+  }
+
+  // start from each key written, between the versions of a timestamp, and before and after all of them
+  void checkScansFromKeys(size_t step = 1) {
+    std::vector<Key> aKey = expected(NULL, 0);
+    for (size_t i = 0; i < aKey.size(); i += step) {
+      for (int64_t dVer = -1; dVer <= 1; dVer++) {
+        TSDBKEY from = makeKey(aKey[i].first, aKey[i].second + dVer);
+        checkScan(&from, 0);
+        checkScan(&from, 1);
+        if (HasFatalFailure()) return;
+      }
+    }
+
+    TSDBKEY from = makeKey(aKey.front().first - 1, 0);
+    checkScan(&from, 0);
+    checkScan(&from, 1);
+    from = makeKey(aKey.back().first + 1, 0);
+    checkScan(&from, 0);
+    checkScan(&from, 1);
+  }
+
+  SVnode          *pVnode = NULL;
+  SMemTable       *pMemTable = NULL;
+  std::vector<Key> written;
+};
+
+TEST_F(TsdbMemTableTest, inOrderAppends) {
+  // chunks of 16, 32, ... 4096 rows and then more of 4096 rows, batches ending in the middle of a chunk
+  int64_t version = 1;
+  for (TSKEY ts = 0; ts < 20000; ts += 333) {
+    insertRows(version++, tsRange(ts, TMIN(ts + 333, 20000)));
+  }
+
+  EXPECT_EQ(tbData()->sl.size, 0);
+  EXPECT_EQ(tbData()->al.size, 20000);
+  EXPECT_EQ(tsdbGetNRowsInTbData(tbData()), 20000);
+  checkScans();
+}
+
+TEST_F(TsdbMemTableTest, iteratorsFromTheMiddleOfAppendList) {
+  int64_t version = 1;
+  for (TSKEY ts = 0; ts < 600; ts += 50) {
+    insertRows(version++, tsRange(ts * 10, (ts + 50) * 10, 10));
+  }
+  ASSERT_EQ(tbData()->sl.size, 0);
+
+  // every row, the first and last rows of each chunk among them
+  checkScansFromKeys();
+
+  // between the rows
+  for (TSKEY ts = 5; ts < 6000; ts += 10) {
+    TSDBKEY from = makeKey(ts, 0);
+    checkScan(&from, 0);
+    checkScan(&from, 1);
+    if (HasFatalFailure()) return;
+  }
+}
+
+TEST_F(TsdbMemTableTest, outOfOrderAppends) {
+  insertRows(1, tsRange(10000, 11000));
+
+  // before the append list, the skiplist only
+  insertRows(2, tsRange(9000, 10000));
+  insertRows(3, tsRange(0, 500, 3));
+  insertRows(4, tsRange(1, 500, 3));
+  EXPECT_EQ(tbData()->al.size, 1000);
+  EXPECT_EQ(tbData()->sl.size, 1000 + 167 + 167);
+
+  // the leading rows of a batch in the skiplist, the rest appended
+  insertRows(5, tsRange(10500, 12000, 7));
+  insertRows(6, tsRange(11001, 12500, 2));
+  EXPECT_EQ(tsdbGetNRowsInTbData(tbData()), (int64_t)written.size());
+
+  checkScans();
+  checkScansFromKeys(7);
+}
+
+TEST_F(TsdbMemTableTest, interleavedAppends) {
+  // each batch goes a little past the last appended row, so the skiplist rows fall between rows of the append list
+  int64_t version = 1;
+  for (int32_t round = 0; round < 10; round++) {
+    insertRows(version++, tsRange(round, 1000 * (round + 2), 10));
+  }
+  EXPECT_GT(tbData()->sl.size, 1000);
+  EXPECT_GT(tbData()->al.size, 1000);
+  EXPECT_EQ(tsdbGetNRowsInTbData(tbData()), (int64_t)written.size());
+
+  checkScans();
+  checkScansFromKeys(29);
+}
+
+TEST_F(TsdbMemTableTest, duplicateKeysWithDifferentVersions) {
+  insertRows(1, tsRange(0, 1000));
+  // the same timestamps again, in the skiplist but the last one, which sorts after (999, 1) and is appended
+  insertRows(2, tsRange(0, 1000));
+  EXPECT_EQ(tbData()->sl.size, 999);
+  EXPECT_EQ(tbData()->al.size, 1001);
+
+  // some in the skiplist twice, and newer versions of appended rows appended again
+  insertRows(3, tsRange(500, 1500, 2));
+  insertRows(4, tsRange(999, 1600));
+  insertRows(5, tsRange(1599, 1601));
+
+  checkScans();
+  checkScansFromKeys(5);
+
+  // every version of a timestamp is returned, oldest first forward and newest first backward
+  TSDBKEY from = makeKey(999, 0);
+  std::vector<Key> res = scan(&from, 0);
+  ASSERT_GE(res.size(), 4);
+  EXPECT_EQ(res[0], Key(999, 1));
+  EXPECT_EQ(res[1], Key(999, 2));
+  EXPECT_EQ(res[2], Key(999, 4));
+  EXPECT_EQ(res[3], Key(1000, 3));
+
+  from = makeKey(999, VERSION_MAX);
+  res = scan(&from, 1);
+  ASSERT_GE(res.size(), 4);
+  EXPECT_EQ(res[0], Key(999, 4));
+  EXPECT_EQ(res[1], Key(999, 2));
+  EXPECT_EQ(res[2], Key(999, 1));
+  EXPECT_EQ(res[3], Key(998, 3));
+}
+
+TEST_F(TsdbMemTableTest, rowAndColumnFormats) {
+  int64_t version = 1;
+  insertCols(version++, tsRange(100, 200));
+  insertRows(version++, tsRange(200, 300));
+  // before, across and after the rows in both formats
+  insertCols(version++, tsRange(50, 250, 3));
+  insertRows(version++, tsRange(150, 400, 5));
+  insertCols(version++, tsRange(390, 500, 2));
+  insertCols(version++, tsRange(0, 600, 11));
+
+  checkScans();
+  checkScansFromKeys(3);
+}
+
+TEST_F(TsdbMemTableTest, rowsAppendedAfterOpen) {
+  insertRows(1, tsRange(0, 10));
+
+  STbDataIter *pIter = NULL;
+  TSDBKEY      from = makeKey(5, 0);
+  ASSERT_EQ(tsdbTbDataIterCreate(tbData(), &from, 0, &pIter), 0);
+  ASSERT_NE(tsdbTbDataIterGet(pIter), nullptr);
+  EXPECT_EQ(TSDBROW_TS(tsdbTbDataIterGet(pIter)), 5);
+
+  // a forward iterator goes on with the rows appended after it is opened, into chunks created since
+  insertRows(2, tsRange(10, 100));
+  std::vector<TSKEY> aTs;
+  for (TSDBROW *pRow = tsdbTbDataIterGet(pIter); pRow; pRow = tsdbTbDataIterGet(pIter)) {
+    aTs.push_back(TSDBROW_TS(pRow));
+    tsdbTbDataIterNext(pIter);
+  }
+  EXPECT_EQ(aTs, tsRange(5, 100));
+  pIter = (STbDataIter *)tsdbTbDataIterDestroy(pIter);
+  EXPECT_EQ(pIter, nullptr);
+}
+
+TEST_F(TsdbMemTableTest, oneRowInEachList) {
+  // iterators from before, between and after the two rows
+  insertRows(1, tsRange(5, 6));
+  insertRows(2, tsRange(0, 1));
+  EXPECT_EQ(tbData()->al.size, 1);
+  EXPECT_EQ(tbData()->sl.size, 1);
+
+  TSDBKEY from = makeKey(3, 0);
+  checkScan(&from, 0);
+  checkScan(&from, 1);
+  from = makeKey(6, 0);
+  checkScan(&from, 0);
+  from = makeKey(-1, 0);
+  checkScan(&from, 1);
+  checkScans();
+}
+
+#pragma GCC diagnostic pop
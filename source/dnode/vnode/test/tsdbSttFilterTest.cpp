@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "querynodes.h"
+#include "tsdb.h"
+
+extern "C" int32_t tsdbWriteSttBlock(SDataFWriter *pWriter, SBlockData *pBlockData, SArray *aSttBlk, int8_t cmprAlg);
+
+namespace {
+
+const uint64_t SUID = 100;
+const int16_t  VAL_CID = PRIMARYKEY_TIMESTAMP_COL_ID + 1;
+
+// the rows of the tables of uids with keys [skey, ekey], column v of key ts is val + ts - skey. All rows of a block
+// are written with the version ver, which tells the block a row read back comes from.
+struct SttBlockDesc {
+  int64_t               ver;
+  std::vector<uint64_t> uids;
+  TSKEY                 skey;
+  TSKEY                 ekey;
+  int64_t               val;
+};
+
+SSttBlk makeSttBlk(uint64_t minUid, uint64_t maxUid, TSKEY minKey, TSKEY maxKey) {
+  SSttBlk blk = {0};
+  blk.suid = SUID;
+  blk.minUid = minUid;
+  blk.maxUid = maxUid;
+  blk.minKey = minKey;
+  blk.maxKey = maxKey;
+  blk.minVer = 1;
+  blk.maxVer = 100;
+  blk.nRow = 100;
+  blk.bInfo.offset = 4096;
+  blk.bInfo.szBlock = 1024;
+  blk.bInfo.szKey = 256;
+  blk.smaInfo.offset = 5120;
+  blk.smaInfo.size = 64;
+  return blk;
+}
+
+void checkSttBlk(const SSttBlk &res, const SSttBlk &blk) {
+  EXPECT_EQ(res.suid, blk.suid);
+  EXPECT_EQ(res.minUid, blk.minUid);
+  EXPECT_EQ(res.maxUid, blk.maxUid);
+  EXPECT_EQ(res.minKey, blk.minKey);
+  EXPECT_EQ(res.maxKey, blk.maxKey);
+  EXPECT_EQ(res.minVer, blk.minVer);
+  EXPECT_EQ(res.maxVer, blk.maxVer);
+  EXPECT_EQ(res.nRow, blk.nRow);
+  EXPECT_EQ(res.bInfo.offset, blk.bInfo.offset);
+  EXPECT_EQ(res.bInfo.szBlock, blk.bInfo.szBlock);
+  EXPECT_EQ(res.bInfo.szKey, blk.bInfo.szKey);
+}
+
+}  // namespace
+
+// The stt files are written through SDataFWriter as a commit writes them, and read back through the merge tree of
+// a table with a filter of "v > val" on the zone maps. Which blocks are skipped is told by the versions of the rows
+// the merge tree returns.
+class SttFilterEnv : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(pathName);
+    char dir[TSDB_FILENAME_LEN];
+    snprintf(dir, sizeof(dir), "%s%s%s", pathName, TD_DIRSEP, "tsdb");
+    ASSERT_EQ(taosMulMkDir(dir), 0);
+
+    SDiskCfg dCfg = {0};
+    tstrncpy(dCfg.dir, pathName, TSDB_FILENAME_LEN);
+    dCfg.level = 0;
+    dCfg.primary = 1;
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->config.vgId = 2;
+    pVnode->config.tsdbPageSize = 4096;
+    pVnode->pTfs = tfsOpen(&dCfg, 1);
+    ASSERT_NE(pVnode->pTfs, nullptr);
+
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pTsdb->path = (char *)"tsdb";
+    pTsdb->pVnode = pVnode;
+    pVnode->pTsdb = pTsdb;
+
+    memset(aSttF, 0, sizeof(aSttF));
+    fData = (SDataFile){.commitID = 1};
+    fSma = (SSmaFile){.commitID = 1};
+    fSet = (SDFileSet){.fid = 1700, .pHeadF = &fHead, .pDataF = &fData, .pSmaF = &fSma};
+  }
+
+  void TearDown() override {
+    for (SNode *pNode : conds) nodesDestroyNode(pNode);
+    for (SFilterInfo *pInfo : filters) filterFreeInfo(pInfo);
+    if (pVnode != NULL) {
+      tfsClose(pVnode->pTfs);
+      taosMemoryFree(pTsdb);
+      taosMemoryFree(pVnode);
+    }
+    taosRemoveDir(pathName);
+  }
+
+  // write a new stt file to the file set, without smaOn the blocks have no zone maps of column v
+  void writeSttFile(const std::vector<SttBlockDesc> &blocks, bool smaOn) {
+    SSchema aSchema[] = {
+        {.type = TSDB_DATA_TYPE_TIMESTAMP, .flags = COL_SMA_ON, .colId = PRIMARYKEY_TIMESTAMP_COL_ID, .bytes = 8},
+        {.type = TSDB_DATA_TYPE_BIGINT, .flags = (int8_t)(smaOn ? COL_SMA_ON : 0), .colId = VAL_CID, .bytes = 8}};
+    STSchema *pTSchema = tBuildTSchema(aSchema, 2, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    int32_t iStt = fSet.nSttF++;
+    aSttF[iStt] = (SSttFile){.commitID = iStt + 1};
+    fSet.aSttF[iStt] = &aSttF[iStt];
+    fHead = (SHeadFile){.commitID = iStt + 1};
+
+    SDataFWriter *pWriter = NULL;
+    ASSERT_EQ(tsdbDataFWriterOpen(&pWriter, pTsdb, &fSet), 0);
+
+    SBlockData bData;
+    TABLEID    id = {.suid = SUID, .uid = 0};
+    SArray    *aSttBlk = taosArrayInit(blocks.size(), sizeof(SSttBlk));
+    SArray    *aColVal = taosArrayInit(2, sizeof(SColVal));
+    ASSERT_EQ(tBlockDataCreate(&bData), 0);
+    ASSERT_EQ(tBlockDataInit(&bData, &id, pTSchema, NULL, 0), 0);
+
+    for (const SttBlockDesc &blk : blocks) {
+      for (uint64_t uid : blk.uids) {
+        for (TSKEY ts = blk.skey; ts <= blk.ekey; ++ts) {
+          SColVal cv[2] = {COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, (SValue){.val = ts}),
+                           COL_VAL_VALUE(VAL_CID, TSDB_DATA_TYPE_BIGINT, (SValue){.val = blk.val + ts - blk.skey})};
+          SRow   *pRow = NULL;
+          taosArrayClear(aColVal);
+          taosArrayPush(aColVal, &cv[0]);
+          taosArrayPush(aColVal, &cv[1]);
+          ASSERT_EQ(tRowBuild(aColVal, pTSchema, &pRow), 0);
+
+          TSDBROW row = tsdbRowFromTSRow(blk.ver, pRow);
+          ASSERT_EQ(tBlockDataAppendRow(&bData, &row, pTSchema, uid), 0);
+          taosMemoryFree(pRow);
+        }
+      }
+      ASSERT_EQ(tsdbWriteSttBlock(pWriter, &bData, aSttBlk, NO_COMPRESSION), 0);
+    }
+
+    SArray *aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx));
+    ASSERT_EQ(tsdbWriteSttBlk(pWriter, aSttBlk), 0);
+    ASSERT_EQ(tsdbWriteBlockIdx(pWriter, aBlockIdx), 0);
+    ASSERT_EQ(tsdbUpdateDFileSetHeader(pWriter), 0);
+
+    // the file set as the commit updates it in the file system
+    fHead = pWriter->fHead;
+    fData = pWriter->fData;
+    fSma = pWriter->fSma;
+    aSttF[iStt] = pWriter->fStt[iStt];
+    ASSERT_EQ(tsdbDataFWriterClose(&pWriter, 1), 0);
+
+    taosArrayDestroy(aBlockIdx);
+    taosArrayDestroy(aColVal);
+    taosArrayDestroy(aSttBlk);
+    tBlockDataDestroy(&bData);
+    tDestroyTSchema(pTSchema);
+  }
+
+  // the filter of "v > val" as the table scan pushes it down to the reader
+  SFilterInfo *makeFilter(int64_t val) {
+    SColumnNode *pCol = (SColumnNode *)nodesMakeNode(QUERY_NODE_COLUMN);
+    pCol->node.resType.type = TSDB_DATA_TYPE_BIGINT;
+    pCol->node.resType.bytes = sizeof(int64_t);
+    pCol->colId = VAL_CID;
+    pCol->slotId = 1;
+
+    SValueNode *pVal = (SValueNode *)nodesMakeNode(QUERY_NODE_VALUE);
+    pVal->node.resType.type = TSDB_DATA_TYPE_BIGINT;
+    pVal->node.resType.bytes = sizeof(int64_t);
+    nodesSetValueNodeValue(pVal, &val);
+
+    SOperatorNode *pOp = (SOperatorNode *)nodesMakeNode(QUERY_NODE_OPERATOR);
+    pOp->node.resType.type = TSDB_DATA_TYPE_BOOL;
+    pOp->node.resType.bytes = sizeof(bool);
+    pOp->opType = OP_TYPE_GREATER_THAN;
+    pOp->pLeft = (SNode *)pCol;
+    pOp->pRight = (SNode *)pVal;
+    conds.push_back((SNode *)pOp);
+
+    SFilterInfo *pInfo = NULL;
+    EXPECT_EQ(filterInitFromNode((SNode *)pOp, &pInfo, 0), 0);
+    filters.push_back(pInfo);
+    return pInfo;
+  }
+
+  // the versions of the blocks the rows of the table are read from, in the order of the scan. The data window is the
+  // key range of the table in the data file and the buffer.
+  std::vector<int64_t> scan(uint64_t uid, bool backward, SFilterInfo *pFilterInfo,
+                            STimeWindow dataWin = {.skey = INT64_MAX, .ekey = INT64_MIN}) {
+    std::vector<int64_t> vers;
+    SDataFReader        *pReader = NULL;
+    EXPECT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+    if (pReader == NULL) {
+      return vers;
+    }
+
+    SSchema aSchema[] = {{.type = TSDB_DATA_TYPE_TIMESTAMP, .flags = 0, .colId = PRIMARYKEY_TIMESTAMP_COL_ID, .bytes = 8},
+                         {.type = TSDB_DATA_TYPE_BIGINT, .flags = 0, .colId = VAL_CID, .bytes = 8}};
+    STSchema          *pTSchema = tBuildTSchema(aSchema, 2, 1);
+    int16_t            colId = VAL_CID;
+    SSttBlockLoadInfo *pInfo = tCreateLastBlockLoadInfo(pTSchema, &colId, 1, fSet.nSttF);
+    for (int32_t iStt = 0; iStt < fSet.nSttF; ++iStt) {
+      pInfo[iStt].pFilterInfo = pFilterInfo;
+      pInfo[iStt].dataWin = dataWin;
+    }
+
+    SMergeTree    mTree;
+    SLDataIter    aIter[TSDB_MAX_STT_TRIGGER];
+    STimeWindow   w = {.skey = INT64_MIN, .ekey = INT64_MAX};
+    SVersionRange verRange = {.minVer = 0, .maxVer = INT64_MAX};
+    EXPECT_EQ(tMergeTreeOpen(&mTree, backward, pReader, SUID, uid, &w, &verRange, pInfo, false, "stt-filter-test", false,
+                             aIter),
+              0);
+    while (tMergeTreeNext(&mTree)) {
+      int64_t ver = TSDBROW_VERSION(tMergeTreeGetRow(&mTree));
+      if (vers.empty() || vers.back() != ver) {
+        vers.push_back(ver);
+      }
+    }
+    tMergeTreeClose(&mTree);
+
+    destroyLastBlockLoadInfo(pInfo);
+    tDestroyTSchema(pTSchema);
+    tsdbDataFReaderClose(&pReader);
+    return vers;
+  }
+
+  SVnode                    *pVnode = NULL;
+  STsdb                     *pTsdb = NULL;
+  SHeadFile                  fHead;
+  SDataFile                  fData;
+  SSmaFile                   fSma;
+  SSttFile                   aSttF[TSDB_MAX_STT_TRIGGER];
+  SDFileSet                  fSet;
+  std::vector<SNode *>       conds;
+  std::vector<SFilterInfo *> filters;
+  const char                *pathName = TD_TMP_DIR_PATH "tsdb_stt_filter_test";
+};
+
+TEST_F(SttFilterEnv, ruledOutBlocksSkipped) {
+  writeSttFile({{1, {1}, 0, 99, 0}, {2, {1}, 100, 199, 2000}, {3, {1}, 200, 299, 0}, {4, {1}, 300, 399, 5000},
+                {5, {1}, 400, 499, 0}},
+               true);
+  ASSERT_EQ(aSttF[0].fmtVer, TSDB_STT_FMT_VER);
+
+  SFilterInfo *pFilter = makeFilter(1000);
+  EXPECT_EQ(scan(1, false, pFilter), std::vector<int64_t>({2, 4}));
+  EXPECT_EQ(scan(1, true, pFilter), std::vector<int64_t>({4, 2}));
+
+  // a block is kept if any of its rows may pass the filter
+  pFilter = makeFilter(5098);
+  EXPECT_EQ(scan(1, false, pFilter), std::vector<int64_t>({4}));
+  pFilter = makeFilter(5099);
+  EXPECT_TRUE(scan(1, false, pFilter).empty());
+
+  EXPECT_EQ(scan(1, false, NULL), std::vector<int64_t>({1, 2, 3, 4, 5}));
+  EXPECT_EQ(scan(1, true, NULL), std::vector<int64_t>({5, 4, 3, 2, 1}));
+}
+
+TEST_F(SttFilterEnv, blocksOfSeveralTables) {
+  // the result of a block holding several tables is shared by them
+  writeSttFile({{1, {1, 2}, 0, 499, 2000}, {2, {2, 3}, 0, 499, 0}, {3, {3}, 500, 599, 2000}, {4, {4, 5}, 0, 99, 0}},
+               true);
+
+  SFilterInfo *pFilter = makeFilter(1000);
+  EXPECT_EQ(scan(1, false, pFilter), std::vector<int64_t>({1}));
+  EXPECT_EQ(scan(3, false, pFilter), std::vector<int64_t>({3}));
+  EXPECT_EQ(scan(3, true, pFilter), std::vector<int64_t>({3}));
+  EXPECT_TRUE(scan(5, false, pFilter).empty());
+}
+
+TEST_F(SttFilterEnv, duplicateKeysInNeighbourBlocks) {
+  // the versions of key 99 and 300 are split over two blocks each
+  writeSttFile({{1, {1}, 0, 99, 2000}, {2, {1}, 99, 150, 0}, {3, {1}, 151, 200, 0}, {4, {1}, 201, 300, 0},
+                {5, {1}, 300, 300, 0}, {6, {1}, 301, 400, 0}},
+               true);
+
+  // a skipped version could hide an older one of the same key, or be merged with it
+  SFilterInfo *pFilter = makeFilter(1000);
+  EXPECT_EQ(scan(1, false, pFilter), std::vector<int64_t>({1, 2, 4, 5}));
+  EXPECT_EQ(scan(1, true, pFilter), std::vector<int64_t>({5, 4, 2, 1}));
+}
+
+TEST_F(SttFilterEnv, keysInDataFileOrMemTable) {
+  writeSttFile({{1, {1}, 0, 99, 0}, {2, {1}, 1000, 1099, 0}, {3, {1}, 2000, 2099, 0}, {4, {1}, 3000, 3099, 0}}, true);
+
+  // the table has rows in the data file or the buffer over this key range, the same keys as block 2 and 3
+  SFilterInfo *pFilter = makeFilter(1000);
+  EXPECT_EQ(scan(1, false, pFilter, {.skey = 1099, .ekey = 2000}), std::vector<int64_t>({2, 3}));
+  EXPECT_EQ(scan(1, true, pFilter, {.skey = 1099, .ekey = 2000}), std::vector<int64_t>({3, 2}));
+  EXPECT_TRUE(scan(1, false, pFilter, {.skey = 100, .ekey = 999}).empty());
+  EXPECT_EQ(scan(1, false, pFilter, {.skey = INT64_MIN, .ekey = INT64_MAX}), std::vector<int64_t>({1, 2, 3, 4}));
+}
+
+TEST_F(SttFilterEnv, tableInSeveralSttFiles) {
+  writeSttFile({{1, {1}, 0, 99, 0}, {2, {1}, 100, 199, 2000}}, true);
+  writeSttFile({{3, {1}, 200, 299, 0}, {4, {2}, 0, 99, 0}}, true);
+
+  // rows of the table in another stt file may have the same keys
+  SFilterInfo *pFilter = makeFilter(1000);
+  EXPECT_EQ(scan(1, false, pFilter), std::vector<int64_t>({1, 2, 3}));
+
+  // only one file has rows of table 2
+  EXPECT_TRUE(scan(2, false, pFilter).empty());
+}
+
+TEST_F(SttFilterEnv, oldFormatBlocksNotSkipped) {
+  // no zone maps of the blocks if v is not sma'd, so the stt file is written in format version 0
+  writeSttFile({{1, {1}, 0, 99, 0}, {2, {1}, 100, 199, 2000}, {3, {1}, 200, 299, 0}}, false);
+  ASSERT_EQ(aSttF[0].fmtVer, 0);
+
+  SFilterInfo *pFilter = makeFilter(1000);
+  EXPECT_EQ(scan(1, false, pFilter), std::vector<int64_t>({1, 2, 3}));
+  EXPECT_EQ(scan(1, true, pFilter), std::vector<int64_t>({3, 2, 1}));
+}
+
+TEST(SttFormatTest, sttBlk) {
+  SSttBlk blk = makeSttBlk(7, 9, -5, 1 << 20);
+  uint8_t buf[256] = {0};
+
+  int32_t n1 = tPutSttBlk(NULL, &blk, TSDB_STT_FMT_VER);
+  ASSERT_EQ(tPutSttBlk(buf, &blk, TSDB_STT_FMT_VER), n1);
+
+  SSttBlk res = {0};
+  ASSERT_EQ(tGetSttBlk(buf, &res, TSDB_STT_FMT_VER), n1);
+  checkSttBlk(res, blk);
+  EXPECT_EQ(res.smaInfo.offset, blk.smaInfo.offset);
+  EXPECT_EQ(res.smaInfo.size, blk.smaInfo.size);
+
+  // format version 0, the block index before the zone maps
+  int32_t n0 = tPutSttBlk(NULL, &blk, 0);
+  ASSERT_LT(n0, n1);
+  ASSERT_EQ(tPutSttBlk(buf, &blk, 0), n0);
+  ASSERT_EQ(tPutSttBlk(buf + n0, &blk, 0), n0);
+
+  for (int32_t i = 0; i < 2; ++i) {
+    memset(&res, 0xff, sizeof(SSttBlk));
+    ASSERT_EQ(tGetSttBlk(buf + i * n0, &res, 0), n0);
+    checkSttBlk(res, blk);
+    EXPECT_EQ(res.smaInfo.offset, 0);
+    EXPECT_EQ(res.smaInfo.size, 0);
+  }
+}
+
+TEST(SttFormatTest, fileSet) {
+  SHeadFile fHead = {.commitID = 3, .size = 4096, .offset = 2048};
+  SDataFile fData = {.commitID = 3, .size = 8192};
+  SSmaFile  fSma = {.commitID = 3, .size = 1024};
+  SSttFile  fStt[2] = {{.commitID = 2, .size = 9000, .offset = 8000, .fmtVer = 0},
+                       {.commitID = 3, .size = 7000, .offset = 6000, .fmtVer = TSDB_STT_FMT_VER}};
+  SDFileSet set = {.fid = 1700, .pHeadF = &fHead, .pDataF = &fData, .pSmaF = &fSma, .nSttF = 2};
+  set.aSttF[0] = &fStt[0];
+  set.aSttF[1] = &fStt[1];
+
+  uint8_t buf[256] = {0};
+  int32_t n = tPutDFileSet(buf, &set, TSDB_FS_VER);
+  ASSERT_EQ(n, tPutDFileSet(NULL, &set, TSDB_FS_VER));
+
+  SDFileSet res = {0};
+  ASSERT_EQ(tGetDFileSet(buf, &res, TSDB_FS_VER), n);
+  EXPECT_EQ(res.fid, set.fid);
+  EXPECT_EQ(res.pDataF->size, fData.size);
+  ASSERT_EQ(res.nSttF, 2);
+  for (int32_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(res.aSttF[i]->commitID, fStt[i].commitID);
+    EXPECT_EQ(res.aSttF[i]->size, fStt[i].size);
+    EXPECT_EQ(res.aSttF[i]->offset, fStt[i].offset);
+    EXPECT_EQ(res.aSttF[i]->fmtVer, fStt[i].fmtVer);
+    taosMemoryFree(res.aSttF[i]);
+  }
+  taosMemoryFree(res.pHeadF);
+  taosMemoryFree(res.pDataF);
+  taosMemoryFree(res.pSmaF);
+}
+
+TEST(SttFormatTest, oldFileSet) {
+  // the file set as the file system meta of version 0 keeps it, no format version of the stt files
+  uint8_t buf[256] = {0};
+  int32_t n = 0;
+  n += tPutI32v(buf + n, 0);
+  n += tPutI32v(buf + n, 0);
+  n += tPutI32v(buf + n, 1700);
+  n += tPutI64v(buf + n, 3);  // head file
+  n += tPutI64v(buf + n, 4096);
+  n += tPutI64v(buf + n, 2048);
+  n += tPutI64v(buf + n, 3);  // data file
+  n += tPutI64v(buf + n, 8192);
+  n += tPutI64v(buf + n, 3);  // sma file
+  n += tPutI64v(buf + n, 1024);
+  n += tPutU8(buf + n, 2);
+  for (int64_t commitID = 1; commitID <= 2; ++commitID) {
+    n += tPutI64v(buf + n, commitID);
+    n += tPutI64v(buf + n, 9000 + commitID);
+    n += tPutI64v(buf + n, 8000 + commitID);
+  }
+  // the next file set follows
+  buf[n] = 0x7f;
+
+  SDFileSet res = {0};
+  ASSERT_EQ(tGetDFileSet(buf, &res, 0), n);
+  EXPECT_EQ(res.fid, 1700);
+  EXPECT_EQ(res.pHeadF->offset, 2048);
+  EXPECT_EQ(res.pSmaF->size, 1024);
+  ASSERT_EQ(res.nSttF, 2);
+  for (int32_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(res.aSttF[i]->commitID, i + 1);
+    EXPECT_EQ(res.aSttF[i]->size, 9000 + i + 1);
+    EXPECT_EQ(res.aSttF[i]->offset, 8000 + i + 1);
+    EXPECT_EQ(res.aSttF[i]->fmtVer, 0);
+    taosMemoryFree(res.aSttF[i]);
+  }
+  taosMemoryFree(res.pHeadF);
+  taosMemoryFree(res.pDataF);
+  taosMemoryFree(res.pSmaF);
+
+  // a file set without stt zone maps is still written that way
+  SHeadFile fHead = {.commitID = 3, .size = 4096, .offset = 2048};
+  SDataFile fData = {.commitID = 3, .size = 8192};
+  SSmaFile  fSma = {.commitID = 3, .size = 1024};
+  SSttFile  fStt[2] = {{.commitID = 1, .size = 9001, .offset = 8001, .fmtVer = 0},
+                       {.commitID = 2, .size = 9002, .offset = 8002, .fmtVer = 0}};
+  SDFileSet set = {.fid = 1700, .pHeadF = &fHead, .pDataF = &fData, .pSmaF = &fSma, .nSttF = 2};
+  set.aSttF[0] = &fStt[0];
+  set.aSttF[1] = &fStt[1];
+
+  uint8_t out[256] = {0};
+  ASSERT_EQ(tPutDFileSet(out, &set, 0), n);
+  EXPECT_EQ(memcmp(out, buf, n), 0);
+}
+
+#pragma GCC diagnostic pop
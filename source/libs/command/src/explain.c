@@ -533,9 +533,14 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
       }
       break;
     }
-    case QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN: {
+    case QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN:
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN: {
       SSortMergeJoinPhysiNode *pJoinNode = (SSortMergeJoinPhysiNode *)pNode;
-      EXPLAIN_ROW_NEW(level, EXPLAIN_JOIN_FORMAT, EXPLAIN_JOIN_STRING(pJoinNode->joinType));
+      if (QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN == nodeType(pNode)) {
+        EXPLAIN_ROW_NEW(level, EXPLAIN_HASH_JOIN_FORMAT, EXPLAIN_JOIN_STRING(pJoinNode->joinType));
+      } else {
+        EXPLAIN_ROW_NEW(level, EXPLAIN_JOIN_FORMAT, EXPLAIN_JOIN_STRING(pJoinNode->joinType));
+      }
       EXPLAIN_ROW_APPEND(EXPLAIN_LEFT_PARENTHESIS_FORMAT);
       if (pResNode->pExecInfo) {
         QRY_ERR_RET(qExplainBufAppendExecInfo(pResNode->pExecInfo, tbuf, &tlen));
@@ -35,6 +35,7 @@ typedef int32_t (*FPutDataBlock)(struct SDataSinkHandle* pHandle, const SInputDa
 typedef void (*FEndPut)(struct SDataSinkHandle* pHandle, uint64_t useconds);
 typedef void (*FGetDataLength)(struct SDataSinkHandle* pHandle, int64_t* pLen, bool* pQueryEnd);
 typedef int32_t (*FGetDataBlock)(struct SDataSinkHandle* pHandle, SOutputData* pOutput);
+typedef int32_t (*FGetDataRsp)(struct SDataSinkHandle* pHandle, SOutputData* pOutput, void** ppRsp);
 typedef int32_t (*FDestroyDataSinker)(struct SDataSinkHandle* pHandle);
 typedef int32_t (*FGetCacheSize)(struct SDataSinkHandle* pHandle, uint64_t* size);
 
@@ -43,6 +44,7 @@ typedef struct SDataSinkHandle {
   FEndPut            fEndPut;
   FGetDataLength     fGetLen;
   FGetDataBlock      fGetData;
+  FGetDataRsp        fGetDataRsp;
   FDestroyDataSinker fDestroy;
   FGetCacheSize      fGetCacheSize;
 } SDataSinkHandle;
@@ -209,17 +209,21 @@ typedef struct STableScanBase {
 } STableScanBase;
 
 typedef struct STableScanInfo {
-  STableScanBase  base;
-  SScanInfo       scanInfo;
-  int32_t         scanTimes;
-  SSDataBlock*    pResBlock;
-  SSampleExecInfo sample;  // sample execution info
-  int32_t         currentGroupId;
-  int32_t         currentTable;
-  int8_t          scanMode;
-  int8_t          assignBlockUid;
-  bool            hasGroupByTag;
-  bool            countOnly;
+  STableScanBase        base;
+  SScanInfo             scanInfo;
+  int32_t               scanTimes;
+  SSDataBlock*          pResBlock;
+  SSampleExecInfo       sample;  // sample execution info
+  int32_t               currentGroupId;
+  int32_t               currentTable;
+  int8_t                scanMode;
+  int8_t                assignBlockUid;
+  bool                  hasGroupByTag;
+  bool                  countOnly;
+  SArray*               pFilterColIds;     // column ids of the filter pushed down to the tsdb reader, or NULL
+  int32_t               numOfParaReaders;  // number of readers of a parallel scan, 0 to scan serially
+  SNode*                pParaCond;         // filter condition, to build the filter of each reader of a parallel scan
+  struct SParaScanInfo* pParaScan;
 } STableScanInfo;
 
 typedef struct STableMergeScanInfo {
@@ -243,6 +247,7 @@ typedef struct STableMergeScanInfo {
   SSDataBlock*    pResBlock;
   SSampleExecInfo sample;  // sample execution info
   SSortExecInfo   sortExecInfo;
+  SArray*         pFilterColIds;  // column ids of the filter pushed down to the tsdb readers, NULL if not pushed down
 } STableMergeScanInfo;
 
 typedef struct STagScanInfo {
@@ -601,6 +606,8 @@ extern void doDestroyExchangeOperatorInfo(void* param);
 void    doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo);
 int32_t addTagPseudoColumnData(SReadHandle* pHandle, const SExprInfo* pExpr, int32_t numOfExpr, SSDataBlock* pBlock,
                                int32_t rows, const char* idStr, STableMetaCacheInfo* pCache);
+void    setTableScanParallel(struct SOperatorInfo* pOperator, STableScanPhysiNode* pScanNode, SAggPhysiNode* pAggNode);
+void    stopParallelTableScan(STableScanInfo* pInfo);
 
 void appendOneRowToDataBlock(SSDataBlock* pBlock, STupleHandle* pTupleHandle);
 void setTbNameColData(const SSDataBlock* pBlock, SColumnInfoData* pColInfoData, int32_t functionId, const char* name);
@@ -666,6 +673,9 @@ void doClearBufferedBlocks(SStreamScanInfo* pInfo);
 
 uint64_t calcGroupId(char* pData, int32_t len);
 
+int32_t initParaScanPool();
+void    cleanupParaScanPool();
+
 #ifdef __cplusplus
 }
 #endif
@@ -46,6 +46,8 @@ typedef struct SSortSource {
   };
   int64_t fetchUs;
   int64_t fetchNum;
+  char*   pKeys;  // normalized keys of the rows in src.pBlock
+  int32_t keyCapacity;
 } SSortSource;
 
 typedef struct SMsortComparParam {
@@ -53,6 +55,7 @@ typedef struct SMsortComparParam {
   int32_t numOfSources;
   SArray* orderInfo;  // SArray<SBlockOrderInfo>
   bool    cmpGroupId;
+  int32_t keyLen;  // length of the normalized key of a row, 0 if the rows are compared column by column
 } SMsortComparParam;
 
 typedef struct SSortHandle  SSortHandle;
@@ -162,6 +165,14 @@ SSDataBlock* tsortGetSortedDataBlock(const SSortHandle* pSortHandle);
  */
 SSortExecInfo tsortGetSortExecInfo(SSortHandle* pHandle);
 
+/**
+ * create the workers sorting the runs of all sort handles, without them each run is sorted by the query thread
+ * @return
+ */
+int32_t tsortInitPool();
+
+void tsortCleanupPool();
+
 /**
  * get proper sort buffer pages according to the row size
  * @param rowSize
@@ -38,6 +38,12 @@ typedef struct SDataCacheEntry {
   char    data[];
 } SDataCacheEntry;
 
+// The buffer of a data block is allocated by rpcMallocCont, and the entry is placed in it so that the encoded block
+// is where the data of a SRetrieveTableRsp lies. The buffer is then sent as the fetch rsp without copy, with the header
+// of the rsp written over the entry.
+#define DATA_CACHE_ENTRY_OFFSET (offsetof(SRetrieveTableRsp, data) - offsetof(SDataCacheEntry, data))
+#define DATA_CACHE_ENTRY(_buf)  ((SDataCacheEntry*)((_buf) + DATA_CACHE_ENTRY_OFFSET))
+
 typedef struct SDataDispatchHandle {
   SDataSinkHandle     sink;
   SDataSinkManager*   pManager;
@@ -69,13 +75,13 @@ static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pIn
       ++numOfCols;
     }
   }
-  SDataCacheEntry* pEntry = (SDataCacheEntry*)pBuf->pData;
+  SDataCacheEntry* pEntry = DATA_CACHE_ENTRY(pBuf->pData);
   pEntry->compressed = 0;
   pEntry->numOfRows = pInput->pData->info.rows;
   pEntry->numOfCols = numOfCols;
   pEntry->dataLen = 0;
 
-  pBuf->useSize = sizeof(SDataCacheEntry);
+  pBuf->useSize = DATA_CACHE_ENTRY_OFFSET + sizeof(SDataCacheEntry);
   pEntry->dataLen = blockEncode(pInput->pData, pEntry->data, numOfCols);
   //  ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
   //  ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
@@ -96,9 +102,9 @@ static bool allocBuf(SDataDispatchHandle* pDispatcher, const SInputData* pInput,
     }
   */
 
-  pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData);
+  pBuf->allocSize = DATA_CACHE_ENTRY_OFFSET + sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData);
 
-  pBuf->pData = taosMemoryMalloc(pBuf->allocSize);
+  pBuf->pData = rpcMallocCont(pBuf->allocSize);
   if (pBuf->pData == NULL) {
     qError("SinkNode failed to malloc memory, size:%d, code:%d", pBuf->allocSize, TAOS_SYSTEM_ERROR(errno));
   }
@@ -167,29 +173,18 @@ static void getDataLength(SDataSinkHandle* pHandle, int64_t* pLen, bool* pQueryE
     taosFreeQitem(pBuf);
   }
 
-  SDataCacheEntry* pEntry = (SDataCacheEntry*)pDispatcher->nextOutput.pData;
+  SDataCacheEntry* pEntry = DATA_CACHE_ENTRY(pDispatcher->nextOutput.pData);
   *pLen = pEntry->dataLen;
 
   //  ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
   //  ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
 
   *pQueryEnd = pDispatcher->queryEnd;
-  qDebug("got data len %" PRId64 ", row num %d in sink", *pLen,
-         ((SDataCacheEntry*)(pDispatcher->nextOutput.pData))->numOfRows);
+  qDebug("got data len %" PRId64 ", row num %d in sink", *pLen, pEntry->numOfRows);
 }
 
-static int32_t getDataBlock(SDataSinkHandle* pHandle, SOutputData* pOutput) {
-  SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
-  if (NULL == pDispatcher->nextOutput.pData) {
-    ASSERT(pDispatcher->queryEnd);
-    pOutput->useconds = pDispatcher->useconds;
-    pOutput->precision = pDispatcher->pSchema->precision;
-    pOutput->bufStatus = DS_BUF_EMPTY;
-    pOutput->queryEnd = pDispatcher->queryEnd;
-    return TSDB_CODE_SUCCESS;
-  }
-  SDataCacheEntry* pEntry = (SDataCacheEntry*)(pDispatcher->nextOutput.pData);
-  memcpy(pOutput->pData, pEntry->data, pEntry->dataLen);
+static void takeDataCacheEntry(SDataDispatchHandle* pDispatcher, SOutputData* pOutput) {
+  SDataCacheEntry* pEntry = DATA_CACHE_ENTRY(pDispatcher->nextOutput.pData);
   pOutput->numOfRows = pEntry->numOfRows;
   pOutput->numOfCols = pEntry->numOfCols;
   pOutput->compressed = pEntry->compressed;
@@ -200,13 +195,48 @@ static int32_t getDataBlock(SDataSinkHandle* pHandle, SOutputData* pOutput) {
   atomic_sub_fetch_64(&pDispatcher->cachedSize, pEntry->dataLen);
   atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pEntry->dataLen);
 
-  taosMemoryFreeClear(pDispatcher->nextOutput.pData);  // todo persistent
+  pDispatcher->nextOutput.pData = NULL;
   pOutput->bufStatus = updateStatus(pDispatcher);
   taosThreadMutexLock(&pDispatcher->mutex);
   pOutput->queryEnd = pDispatcher->queryEnd;
   pOutput->useconds = pDispatcher->useconds;
   pOutput->precision = pDispatcher->pSchema->precision;
   taosThreadMutexUnlock(&pDispatcher->mutex);
+}
+
+static int32_t getDataBlock(SDataSinkHandle* pHandle, SOutputData* pOutput) {
+  SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
+  if (NULL == pDispatcher->nextOutput.pData) {
+    ASSERT(pDispatcher->queryEnd);
+    pOutput->useconds = pDispatcher->useconds;
+    pOutput->precision = pDispatcher->pSchema->precision;
+    pOutput->bufStatus = DS_BUF_EMPTY;
+    pOutput->queryEnd = pDispatcher->queryEnd;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  char*            pBuf = pDispatcher->nextOutput.pData;
+  SDataCacheEntry* pEntry = DATA_CACHE_ENTRY(pBuf);
+  memcpy(pOutput->pData, pEntry->data, pEntry->dataLen);
+  takeDataCacheEntry(pDispatcher, pOutput);
+  rpcFreeCont(pBuf);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t getDataRsp(SDataSinkHandle* pHandle, SOutputData* pOutput, void** ppRsp) {
+  SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
+  if (NULL == pDispatcher->nextOutput.pData) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SRetrieveTableRsp* pRsp = (SRetrieveTableRsp*)pDispatcher->nextOutput.pData;
+  takeDataCacheEntry(pDispatcher, pOutput);
+  pOutput->pData = pRsp->data;
+
+  // the entry is useless now, the header of the rsp is filled by the caller
+  memset(pRsp, 0, offsetof(SRetrieveTableRsp, data));
+  *ppRsp = pRsp;
 
   return TSDB_CODE_SUCCESS;
 }
@@ -214,12 +244,13 @@ static int32_t getDataBlock(SDataSinkHandle* pHandle, SOutputData* pOutput) {
 static int32_t destroyDataSinker(SDataSinkHandle* pHandle) {
   SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
   atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pDispatcher->cachedSize);
-  taosMemoryFreeClear(pDispatcher->nextOutput.pData);
+  rpcFreeCont(pDispatcher->nextOutput.pData);
+  pDispatcher->nextOutput.pData = NULL;
   while (!taosQueueEmpty(pDispatcher->pDataBlocks)) {
     SDataDispatchBuf* pBuf = NULL;
     taosReadQitem(pDispatcher->pDataBlocks, (void**)&pBuf);
     if (pBuf != NULL) {
-      taosMemoryFreeClear(pBuf->pData);
+      rpcFreeCont(pBuf->pData);
       taosFreeQitem(pBuf);
     }
   }
@@ -245,6 +276,7 @@ int32_t createDataDispatcher(SDataSinkManager* pManager, const SDataSinkNode* pD
   dispatcher->sink.fEndPut = endPut;
   dispatcher->sink.fGetLen = getDataLength;
   dispatcher->sink.fGetData = getDataBlock;
+  dispatcher->sink.fGetDataRsp = getDataRsp;
   dispatcher->sink.fDestroy = destroyDataSinker;
   dispatcher->sink.fGetCacheSize = getCacheSize;
   dispatcher->pManager = pManager;
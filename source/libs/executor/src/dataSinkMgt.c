@@ -68,6 +68,15 @@ int32_t dsGetDataBlock(DataSinkHandle handle, SOutputData* pOutput) {
   return pHandleImpl->fGetData(pHandleImpl, pOutput);
 }
 
+int32_t dsGetDataRsp(DataSinkHandle handle, SOutputData* pOutput, void** ppRsp) {
+  SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
+  *ppRsp = NULL;
+  if (pHandleImpl->fGetDataRsp == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+  return pHandleImpl->fGetDataRsp(pHandleImpl, pOutput, ppRsp);
+}
+
 int32_t dsGetCacheSize(DataSinkHandle handle, uint64_t* pSize) {
   SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
   return pHandleImpl->fGetCacheSize(pHandleImpl, pSize);
@@ -19,7 +19,9 @@
 #include "planner.h"
 #include "querytask.h"
 #include "tdatablock.h"
+#include "tpagedbuf.h"
 #include "tref.h"
+#include "tsort.h"
 #include "tudf.h"
 #include "vnode.h"
 
@@ -490,6 +492,26 @@ int32_t qGetQueryTableSchemaVersion(qTaskInfo_t tinfo, char* dbName, char* table
   return 0;
 }
 
+int32_t qInitExecutorWorkers() {
+  int32_t code = initParaScanPool();
+  if (code == TSDB_CODE_SUCCESS) {
+    code = tsortInitPool();
+  }
+  if (code == TSDB_CODE_SUCCESS) {
+    code = initBufPageWritePool();
+  }
+  if (code != TSDB_CODE_SUCCESS) {
+    qCleanupExecutorWorkers();
+  }
+  return code;
+}
+
+void qCleanupExecutorWorkers() {
+  cleanupBufPageWritePool();
+  tsortCleanupPool();
+  cleanupParaScanPool();
+}
+
 int32_t qCreateExecTask(SReadHandle* readHandle, int32_t vgId, uint64_t taskId, SSubplan* pSubplan,
                         qTaskInfo_t* pTaskInfo, DataSinkHandle* handle, char* sql, EOPTR_EXEC_MODEL model) {
   SExecTaskInfo** pTask = (SExecTaskInfo**)pTaskInfo;
@@ -1176,6 +1198,15 @@ int32_t qStreamPrepareScan(qTaskInfo_t tinfo, STqOffsetVal* pOffset, int8_t subT
           return -1;
         }
 
+        if (pScanInfo->pFilterColIds != NULL) {
+          code = tsdbReaderSetFilter(pScanBaseInfo->dataReader, pInfo->pTableScanOp->exprSupp.pFilterInfo,
+                                     pScanInfo->pFilterColIds);
+          if (code != TSDB_CODE_SUCCESS) {
+            terrno = code;
+            return -1;
+          }
+        }
+
         qDebug("tsdb reader created with offset(snapshot) uid:%" PRId64 " ts:%" PRId64 " table index:%d, total:%d, %s",
                uid, pScanBaseInfo->cond.twindows.skey, pScanInfo->currentTable, numOfTables, id);
       } else {
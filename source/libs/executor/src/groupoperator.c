@@ -28,16 +28,30 @@
 #include "thash.h"
 #include "ttypes.h"
 
+// per block state of the hash group by, the rows of a block are resolved to their groups in one pass
+typedef struct SGroupbyBlockSup {
+  int32_t      capacity;      // number of rows the buffers below are able to hold
+  int32_t      numOfSlots;    // size of the open addressing table, power of 2
+  uint32_t*    pHash;         // group key hash of each row
+  int32_t*     pRowGroup;     // group index of each row
+  int32_t*     pSlots;        // open addressing table, group index + 1 of each slot, 0 for an empty one
+  int32_t*     pGroupRow;     // first row of each group
+  int32_t*     pGroupNum;     // number of rows of each group
+  int32_t*     pGroupOffset;  // start of each group in pSelected
+  int32_t*     pSelected;     // selection vector, the rows of the block ordered by group
+  SSDataBlock* pGatherBlock;  // the rows of the block copied in the order of pSelected
+} SGroupbyBlockSup;
+
 typedef struct SGroupbyOperatorInfo {
-  SOptrBasicInfo binfo;
-  SAggSupporter  aggSup;
-  SArray*        pGroupCols;     // group by columns, SArray<SColumn>
-  SArray*        pGroupColVals;  // current group column values, SArray<SGroupKeys>
-  bool           isInit;         // denote if current val is initialized or not
-  char*          keyBuf;         // group by keys for hash
-  int32_t        groupKeyLen;    // total group by column width
-  SGroupResInfo  groupResInfo;
-  SExprSupp      scalarSup;
+  SOptrBasicInfo   binfo;
+  SAggSupporter    aggSup;
+  SArray*          pGroupCols;     // group by columns, SArray<SColumn>
+  SArray*          pGroupColVals;  // current group column values, SArray<SGroupKeys>
+  char*            keyBuf;         // group by keys for hash
+  int32_t          groupKeyLen;    // total group by column width
+  SGroupResInfo    groupResInfo;
+  SExprSupp        scalarSup;
+  SGroupbyBlockSup blockSup;
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -69,6 +83,18 @@ static void freeGroupKey(void* param) {
   taosMemoryFree(pKey->pData);
 }
 
+static void destroyGroupbyBlockSup(SGroupbyBlockSup* pSup) {
+  taosMemoryFreeClear(pSup->pHash);
+  taosMemoryFreeClear(pSup->pRowGroup);
+  taosMemoryFreeClear(pSup->pSlots);
+  taosMemoryFreeClear(pSup->pGroupRow);
+  taosMemoryFreeClear(pSup->pGroupNum);
+  taosMemoryFreeClear(pSup->pGroupOffset);
+  taosMemoryFreeClear(pSup->pSelected);
+  pSup->pGatherBlock = blockDataDestroy(pSup->pGatherBlock);
+  pSup->capacity = 0;
+}
+
 static void destroyGroupOperatorInfo(void* param) {
   SGroupbyOperatorInfo* pInfo = (SGroupbyOperatorInfo*)param;
   if (pInfo == NULL) {
@@ -83,6 +109,7 @@ static void destroyGroupOperatorInfo(void* param) {
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   cleanupAggSup(&pInfo->aggSup);
+  destroyGroupbyBlockSup(&pInfo->blockSup);
   taosMemoryFreeClear(param);
 }
 
@@ -120,54 +147,6 @@ static int32_t initGroupOptrInfo(SArray** pGroupColVals, int32_t* keyLen, char**
   return TSDB_CODE_SUCCESS;
 }
 
-static bool groupKeyCompare(SArray* pGroupCols, SArray* pGroupColVals, SSDataBlock* pBlock, int32_t rowIndex,
-                            int32_t numOfGroupCols) {
-  SColumnDataAgg* pColAgg = NULL;
-  for (int32_t i = 0; i < numOfGroupCols; ++i) {
-    SColumn*         pCol = taosArrayGet(pGroupCols, i);
-    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
-    if (pBlock->pBlockAgg != NULL) {
-      pColAgg = pBlock->pBlockAgg[pCol->slotId];  // TODO is agg data matched?
-    }
-
-    bool isNull = colDataIsNull(pColInfoData, pBlock->info.rows, rowIndex, pColAgg);
-
-    SGroupKeys* pkey = taosArrayGet(pGroupColVals, i);
-    if (pkey->isNull && isNull) {
-      continue;
-    }
-
-    if (isNull || pkey->isNull) {
-      return false;
-    }
-
-    char* val = colDataGetData(pColInfoData, rowIndex);
-
-    if (pkey->type == TSDB_DATA_TYPE_JSON) {
-      int32_t dataLen = getJsonValueLen(val);
-
-      if (memcmp(pkey->pData, val, dataLen) == 0) {
-        continue;
-      } else {
-        return false;
-      }
-    } else if (IS_VAR_DATA_TYPE(pkey->type)) {
-      int32_t len = varDataLen(val);
-      if (len == varDataLen(pkey->pData) && memcmp(varDataVal(pkey->pData), varDataVal(val), len) == 0) {
-        continue;
-      } else {
-        return false;
-      }
-    } else {
-      if (memcmp(pkey->pData, val, pkey->bytes) != 0) {
-        return false;
-      }
-    }
-  }
-
-  return true;
-}
-
 static void recordNewGroupKeys(SArray* pGroupCols, SArray* pGroupColVals, SSDataBlock* pBlock, int32_t rowIndex) {
   SColumnDataAgg* pColAgg = NULL;
 
@@ -268,80 +247,332 @@ static void doAssignGroupKeys(SqlFunctionCtx* pCtx, int32_t numOfOutput, int32_t
   }
 }
 
-static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
-  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
-  SGroupbyOperatorInfo* pInfo = pOperator->info;
+static int32_t ensureGroupbyBlockSup(SGroupbyBlockSup* pSup, int32_t numOfRows) {
+  if (numOfRows <= pSup->capacity) {
+    return TSDB_CODE_SUCCESS;
+  }
 
-  SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
-  int32_t         numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
-  //  if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
-  // qError("QInfo:0x%"PRIx64" group by not supported on double/float columns, abort", GET_TASKID(pRuntimeEnv));
-  //    return;
-  //  }
+  int32_t capacity = TMAX(numOfRows, 4096);
+  int32_t numOfSlots = 1;
+  while (numOfSlots < capacity * 2) {
+    numOfSlots <<= 1;
+  }
 
-  int32_t len = 0;
-  terrno = TSDB_CODE_SUCCESS;
+  destroyGroupbyBlockSup(pSup);
+  pSup->pHash = taosMemoryMalloc(capacity * sizeof(uint32_t));
+  pSup->pRowGroup = taosMemoryMalloc(capacity * sizeof(int32_t));
+  pSup->pSlots = taosMemoryMalloc(numOfSlots * sizeof(int32_t));
+  pSup->pGroupRow = taosMemoryMalloc(capacity * sizeof(int32_t));
+  pSup->pGroupNum = taosMemoryMalloc(capacity * sizeof(int32_t));
+  pSup->pGroupOffset = taosMemoryMalloc((capacity + 1) * sizeof(int32_t));
+  pSup->pSelected = taosMemoryMalloc(capacity * sizeof(int32_t));
+  if (pSup->pHash == NULL || pSup->pRowGroup == NULL || pSup->pSlots == NULL || pSup->pGroupRow == NULL ||
+      pSup->pGroupNum == NULL || pSup->pGroupOffset == NULL || pSup->pSelected == NULL) {
+    destroyGroupbyBlockSup(pSup);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
 
-  int32_t num = 0;
-  uint64_t groupId = 0;
-  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
-    // Compare with the previous row of this column, and do not set the output buffer again if they are identical.
-    if (!pInfo->isInit) {
-      recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-      if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
-        T_LONG_JMP(pTaskInfo->env, terrno);
+  pSup->capacity = capacity;
+  pSup->numOfSlots = numOfSlots;
+  return TSDB_CODE_SUCCESS;
+}
+
+static FORCE_INLINE uint32_t groupKeyHashMix(uint32_t h, uint64_t v) {
+  v ^= v >> 33;
+  v *= 0xff51afd7ed558ccdULL;
+  v ^= v >> 33;
+  return (h ^ (uint32_t)v ^ (uint32_t)(v >> 32)) * 0x9E3779B1u;
+}
+
+// fold one group by column into the key hash of every row of the block, one column at a time
+static void hashGroupKeyColumn(SColumnInfoData* pColInfoData, SColumnDataAgg* pColAgg, int32_t numOfRows,
+                               uint32_t* pHash) {
+  const uint64_t nullHash = 0x5bd1e995;
+  int32_t        type = pColInfoData->info.type;
+  bool           hasNull = pColInfoData->hasNull;
+
+  if (IS_VAR_DATA_TYPE(type)) {
+    for (int32_t j = 0; j < numOfRows; ++j) {
+      if (hasNull && colDataIsNull(pColInfoData, numOfRows, j, pColAgg)) {
+        pHash[j] = groupKeyHashMix(pHash[j], nullHash);
+        continue;
       }
-      pInfo->isInit = true;
-      num++;
-      continue;
+
+      char* val = colDataGetVarData(pColInfoData, j);
+      if (type == TSDB_DATA_TYPE_JSON) {
+        pHash[j] = groupKeyHashMix(pHash[j], MurmurHash3_32(val, getJsonValueLen(val)));
+      } else {
+        pHash[j] = groupKeyHashMix(pHash[j], MurmurHash3_32(varDataVal(val), varDataLen(val)));
+      }
+    }
+    return;
+  }
+
+  int32_t bytes = pColInfoData->info.bytes;
+  char*   pData = pColInfoData->pData;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    uint64_t v = 0;
+    if (hasNull && colDataIsNull(pColInfoData, numOfRows, j, pColAgg)) {
+      v = nullHash;
+    } else if (bytes == sizeof(int64_t)) {
+      v = *(uint64_t*)(pData + j * sizeof(int64_t));
+    } else if (bytes == sizeof(int32_t)) {
+      v = *(uint32_t*)(pData + j * sizeof(int32_t));
+    } else if (bytes == sizeof(int16_t)) {
+      v = *(uint16_t*)(pData + j * sizeof(int16_t));
+    } else if (bytes == sizeof(int8_t)) {
+      v = *(uint8_t*)(pData + j);
+    } else if (bytes > 0) {
+      v = MurmurHash3_32(pData + j * bytes, bytes);
+    }
+    pHash[j] = groupKeyHashMix(pHash[j], v);
+  }
+}
+
+static bool groupRowKeyEqual(SArray* pGroupCols, SSDataBlock* pBlock, int32_t row1, int32_t row2) {
+  SColumnDataAgg* pColAgg = NULL;
+  int32_t         numOfGroupCols = taosArrayGetSize(pGroupCols);
+
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    if (pBlock->pBlockAgg != NULL) {
+      pColAgg = pBlock->pBlockAgg[pCol->slotId];
+    }
+
+    bool isNull1 = colDataIsNull(pColInfoData, pBlock->info.rows, row1, pColAgg);
+    bool isNull2 = colDataIsNull(pColInfoData, pBlock->info.rows, row2, pColAgg);
+    if (isNull1 || isNull2) {
+      if (isNull1 && isNull2) {
+        continue;
+      }
+      return false;
     }
 
-    bool equal = groupKeyCompare(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j, numOfGroupCols);
-    if (equal) {
-      num++;
+    char* val1 = colDataGetData(pColInfoData, row1);
+    char* val2 = colDataGetData(pColInfoData, row2);
+    if (pColInfoData->info.type == TSDB_DATA_TYPE_JSON) {
+      int32_t dataLen = getJsonValueLen(val1);
+      if (dataLen != getJsonValueLen(val2) || memcmp(val1, val2, dataLen) != 0) {
+        return false;
+      }
+    } else if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
+      if (varDataLen(val1) != varDataLen(val2) || memcmp(varDataVal(val1), varDataVal(val2), varDataLen(val1)) != 0) {
+        return false;
+      }
+    } else if (memcmp(val1, val2, pColInfoData->info.bytes) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Resolve the group of every row of the block with an open addressing table keyed by the row hash, and return the
+// number of groups. The runs of consecutive rows of the same group are counted into *numOfRuns.
+static int32_t resolveBlockGroups(SGroupbyOperatorInfo* pInfo, SSDataBlock* pBlock, int32_t* numOfRuns) {
+  SGroupbyBlockSup* pSup = &pInfo->blockSup;
+  int32_t           numOfRows = pBlock->info.rows;
+  int32_t           numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
+  uint32_t          mask = pSup->numOfSlots - 1;
+
+  memset(pSup->pHash, 0, numOfRows * sizeof(uint32_t));
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pInfo->pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    SColumnDataAgg*  pColAgg = (pBlock->pBlockAgg != NULL) ? pBlock->pBlockAgg[pCol->slotId] : NULL;
+    hashGroupKeyColumn(pColInfoData, pColAgg, numOfRows, pSup->pHash);
+  }
+
+  memset(pSup->pSlots, 0, pSup->numOfSlots * sizeof(int32_t));
+
+  int32_t numOfGroups = 0;
+  *numOfRuns = 0;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    // the same group as the previous row, no need to probe
+    if (j > 0 && pSup->pHash[j] == pSup->pHash[j - 1] && groupRowKeyEqual(pInfo->pGroupCols, pBlock, j, j - 1)) {
+      int32_t groupIndex = pSup->pRowGroup[j - 1];
+      pSup->pRowGroup[j] = groupIndex;
+      pSup->pGroupNum[groupIndex] += 1;
       continue;
     }
 
-    // The first row of a new block does not belongs to the previous existed group
-    if (j == 0) {
-      num++;
-      recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-      if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
-        T_LONG_JMP(pTaskInfo->env, terrno);
+    uint32_t slot = pSup->pHash[j] & mask;
+    while (1) {
+      int32_t groupIndex = pSup->pSlots[slot] - 1;
+      if (groupIndex < 0) {
+        groupIndex = numOfGroups++;
+        pSup->pSlots[slot] = groupIndex + 1;
+        pSup->pGroupRow[groupIndex] = j;
+        pSup->pGroupNum[groupIndex] = 0;
+      } else {
+        int32_t row = pSup->pGroupRow[groupIndex];
+        if (pSup->pHash[row] != pSup->pHash[j] || !groupRowKeyEqual(pInfo->pGroupCols, pBlock, row, j)) {
+          slot = (slot + 1) & mask;
+          continue;
+        }
+      }
+
+      pSup->pRowGroup[j] = groupIndex;
+      pSup->pGroupNum[groupIndex] += 1;
+      break;
+    }
+
+    *numOfRuns += 1;
+  }
+
+  return numOfGroups;
+}
+
+// copy the rows of the source block into the destination block in the order of the selection vector
+static int32_t gatherGroupRows(SSDataBlock* pDest, const SSDataBlock* pSrc, const int32_t* pSelected) {
+  int32_t numOfRows = pSrc->info.rows;
+
+  blockDataCleanup(pDest);
+  int32_t code = blockDataEnsureCapacity(pDest, numOfRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  size_t numOfCols = taosArrayGetSize(pSrc->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pDst = taosArrayGet(pDest->pDataBlock, i);
+    SColumnInfoData* pCol = taosArrayGet(pSrc->pDataBlock, i);
+
+    if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      for (int32_t j = 0; j < numOfRows; ++j) {
+        int32_t row = pSelected[j];
+        if (colDataIsNull_var(pCol, row)) {
+          colDataSetNULL(pDst, j);
+        } else {
+          code = colDataSetVal(pDst, j, colDataGetVarData(pCol, row), false);
+          if (code != TSDB_CODE_SUCCESS) {
+            return code;
+          }
+        }
       }
       continue;
     }
 
-    len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
-    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
-                                          len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
-    if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+    int32_t bytes = pCol->info.bytes;
+    if (bytes > 0) {
+      for (int32_t j = 0; j < numOfRows; ++j) {
+        memcpy(pDst->pData + j * bytes, pCol->pData + pSelected[j] * bytes, bytes);
+      }
+    }
+
+    if (pCol->hasNull && pCol->nullbitmap != NULL) {
+      for (int32_t j = 0; j < numOfRows; ++j) {
+        if (colDataIsNull_f(pCol->nullbitmap, pSelected[j])) {
+          colDataSetNull_f(pDst->nullbitmap, j);
+        }
+      }
+    }
+    pDst->hasNull = pCol->hasNull;
+  }
+
+  pDest->info.rows = numOfRows;
+  pDest->info.id = pSrc->info.id;
+  pDest->info.window = pSrc->info.window;
+  pDest->info.dataLoad = pSrc->info.dataLoad;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void setGroupRowResultOutputBuf(SOperatorInfo* pOperator, SSDataBlock* pBlock, int32_t rowIndex) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+
+  recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, rowIndex);
+  if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
+    T_LONG_JMP(pTaskInfo->env, terrno);
+  }
+
+  int32_t len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
+  int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf, len,
+                                        pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+  if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
+    T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+  }
+}
+
+// The rows of the block are resolved to their groups in one pass. If the rows of each group are mostly consecutive,
+// the aggregate functions are applied on each run of rows directly. Otherwise the rows are ordered by group through a
+// selection vector and gathered into a scratch block, so that each group is looked up in the result row hash table
+// only once and its aggregate functions are applied on all its rows at a time.
+static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock, int32_t order, int32_t scanFlag) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupbyBlockSup*     pSup = &pInfo->blockSup;
+
+  SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
+  int32_t         numOfExprs = pOperator->exprSupp.numOfExprs;
+  int32_t         numOfRows = pBlock->info.rows;
+  if (numOfRows == 0) {
+    return;
+  }
+
+  terrno = TSDB_CODE_SUCCESS;
+
+  int32_t code = ensureGroupbyBlockSup(pSup, numOfRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  int32_t numOfRuns = 0;
+  int32_t numOfGroups = resolveBlockGroups(pInfo, pBlock, &numOfRuns);
+
+  // the sma of the block can not be gathered, and it is not worth it for the mostly sorted input
+  if (pBlock->pBlockAgg != NULL || numOfRuns <= numOfGroups * 2) {
+    int32_t start = 0;
+    for (int32_t j = 1; j <= numOfRows; ++j) {
+      if (j < numOfRows && pSup->pRowGroup[j] == pSup->pRowGroup[start]) {
+        continue;
+      }
+
+      setGroupRowResultOutputBuf(pOperator, pBlock, start);
+      applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, start, j - start, numOfRows, numOfExprs);
+
+      // assign the group keys or user input constant values if required
+      doAssignGroupKeys(pCtx, numOfExprs, numOfRows, start);
+      start = j;
     }
+    return;
+  }
 
-    int32_t rowIndex = j - num;
-    applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows,
-                                    pOperator->exprSupp.numOfExprs);
+  // counting sort of the rows by group, which keeps the order of the rows within a group
+  pSup->pGroupOffset[0] = 0;
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    pSup->pGroupOffset[i + 1] = pSup->pGroupOffset[i] + pSup->pGroupNum[i];
+    pSup->pGroupNum[i] = 0;
+  }
 
-    // assign the group keys or user input constant values if required
-    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
-    recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-    num = 1;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    int32_t groupIndex = pSup->pRowGroup[j];
+    pSup->pSelected[pSup->pGroupOffset[groupIndex] + pSup->pGroupNum[groupIndex]++] = j;
   }
 
-  if (num > 0) {
-    len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
-    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
-                                          len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
-    if (ret != TSDB_CODE_SUCCESS) {
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+  if (pSup->pGatherBlock == NULL ||
+      taosArrayGetSize(pSup->pGatherBlock->pDataBlock) != taosArrayGetSize(pBlock->pDataBlock)) {
+    blockDataDestroy(pSup->pGatherBlock);
+    pSup->pGatherBlock = createOneDataBlock(pBlock, false);
+    if (pSup->pGatherBlock == NULL) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
     }
+  }
+
+  code = gatherGroupRows(pSup->pGatherBlock, pBlock, pSup->pSelected);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
 
-    int32_t rowIndex = pBlock->info.rows - num;
-    applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows,
-                                    pOperator->exprSupp.numOfExprs);
-    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
+  setInputDataBlock(&pOperator->exprSupp, pSup->pGatherBlock, order, scanFlag, true);
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    int32_t rowIndex = pSup->pGroupOffset[i];
+    setGroupRowResultOutputBuf(pOperator, pBlock, pSup->pGroupRow[i]);
+    applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, pSup->pGroupNum[i], numOfRows, numOfExprs);
+    doAssignGroupKeys(pCtx, numOfExprs, numOfRows, rowIndex);
   }
+  setInputDataBlock(&pOperator->exprSupp, pBlock, order, scanFlag, true);
 }
 
 static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
@@ -407,7 +638,7 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
       }
     }
 
-    doHashGroupbyAgg(pOperator, pBlock);
+    doHashGroupbyAgg(pOperator, pBlock, order, scanFlag);
   }
 
   pOperator->status = OP_RES_TO_RETURN;
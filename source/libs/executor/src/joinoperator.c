@@ -22,6 +22,7 @@
 #include "querytask.h"
 #include "tcompare.h"
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "thash.h"
 #include "tmsg.h"
 #include "ttypes.h"
@@ -54,14 +55,47 @@ typedef struct SJoinOperatorInfo {
   SJoinRowCtx  rowCtx;
 } SJoinOperatorInfo;
 
+typedef struct SHJoinRowId {
+  int32_t pageId;
+  int32_t offset;
+} SHJoinRowId;
+
+// a row of the build side in the paged buffer, each column is a null flag followed by the value if not null
+typedef struct SHJoinRow {
+  SHJoinRowId next;
+  char        data[];
+} SHJoinRow;
+
+typedef struct SHashJoinOperatorInfo {
+  SSDataBlock*   pRes;
+  SColumnInfo    probeCol;
+  SColumnInfo    buildCol;
+  SNode*         pCondAfterJoin;
+  SHashObj*      pKeyHash;  // key value -> id of the last build row with this key
+  SDiskbasedBuf* pBuildBuf;
+  SFilePage*     pBuildPage;
+  int32_t        buildPageId;
+  int32_t        numOfBuildCols;
+  SColumnInfo*   pBuildCols;
+  char**         pBuildVals;  // values of the current build row, NULL for null
+  SSDataBlock*   pProbe;
+  int32_t        probePos;
+  SHJoinRowId    nextRow;  // next build row to join with the current probe row, pageId is -1 if none
+} SHashJoinOperatorInfo;
+
 static void         setJoinColumnInfo(SColumnInfo* pColumn, const SColumnNode* pColumnNode);
 static SSDataBlock* doMergeJoin(struct SOperatorInfo* pOperator);
 static void         destroyMergeJoinOperator(void* param);
-static void         extractTimeCondition(SJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream, int32_t num,
-                                         SSortMergeJoinPhysiNode* pJoinNode, const char* idStr);
-
-static void extractTimeCondition(SJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream,  int32_t num,
-                                 SSortMergeJoinPhysiNode* pJoinNode, const char* idStr) {
+static void         extractTimeCondition(SColumnInfo* pLeftCol, SColumnInfo* pRightCol, SOperatorInfo** pDownstream,
+                                         int32_t num, SSortMergeJoinPhysiNode* pJoinNode, const char* idStr);
+static int32_t      createJoinCondAfterMerge(SSortMergeJoinPhysiNode* pJoinNode, SNode** ppCond);
+static int32_t      doOpenHashJoin(SOperatorInfo* pOperator);
+static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator);
+static void         destroyHashJoinOperator(void* param);
+
+// the merge condition is the timestamp equality of a merge join, or the key equality of a hash join
+static void extractTimeCondition(SColumnInfo* pLeftCol, SColumnInfo* pRightCol, SOperatorInfo** pDownstream,
+                                 int32_t num, SSortMergeJoinPhysiNode* pJoinNode, const char* idStr) {
   SNode* pMergeCondition = pJoinNode->pMergeCondition;
   if (nodeType(pMergeCondition) != QUERY_NODE_OPERATOR) {
     qError("not support this in join operator, %s", idStr);
@@ -88,8 +122,34 @@ static void extractTimeCondition(SJoinOperatorInfo* pInfo, SOperatorInfo** pDown
       rightTsCol = col1;
     }
   }
-  setJoinColumnInfo(&pInfo->leftCol, leftTsCol);
-  setJoinColumnInfo(&pInfo->rightCol, rightTsCol);
+  setJoinColumnInfo(pLeftCol, leftTsCol);
+  setJoinColumnInfo(pRightCol, rightTsCol);
+}
+
+static int32_t createJoinCondAfterMerge(SSortMergeJoinPhysiNode* pJoinNode, SNode** ppCond) {
+  if (pJoinNode->pOnConditions != NULL && pJoinNode->node.pConditions != NULL) {
+    *ppCond = nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+    if (*ppCond == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)(*ppCond);
+    pLogicCond->pParameterList = nodesMakeList();
+    if (pLogicCond->pParameterList == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->pOnConditions));
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->node.pConditions));
+    pLogicCond->condType = LOGIC_COND_TYPE_AND;
+  } else if (pJoinNode->pOnConditions != NULL) {
+    *ppCond = nodesCloneNode(pJoinNode->pOnConditions);
+  } else if (pJoinNode->node.pConditions != NULL) {
+    *ppCond = nodesCloneNode(pJoinNode->node.pConditions);
+  } else {
+    *ppCond = NULL;
+  }
+  return TSDB_CODE_SUCCESS;
 }
 
 SOperatorInfo* createMergeJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
@@ -114,31 +174,12 @@ SOperatorInfo* createMergeJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t
   pOperator->exprSupp.pExprInfo = pExprInfo;
   pOperator->exprSupp.numOfExprs = numOfCols;
 
-  extractTimeCondition(pInfo, pDownstream, numOfDownstream, pJoinNode, GET_TASKID(pTaskInfo));
-
-  if (pJoinNode->pOnConditions != NULL && pJoinNode->node.pConditions != NULL) {
-    pInfo->pCondAfterMerge = nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
-    if (pInfo->pCondAfterMerge == NULL) {
-      code = TSDB_CODE_OUT_OF_MEMORY;
-      goto _error;
-    }
-
-    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)(pInfo->pCondAfterMerge);
-    pLogicCond->pParameterList = nodesMakeList();
-    if (pLogicCond->pParameterList == NULL) {
-      code = TSDB_CODE_OUT_OF_MEMORY;
-      goto _error;
-    }
+  extractTimeCondition(&pInfo->leftCol, &pInfo->rightCol, pDownstream, numOfDownstream, pJoinNode,
+                       GET_TASKID(pTaskInfo));
 
-    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->pOnConditions));
-    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->node.pConditions));
-    pLogicCond->condType = LOGIC_COND_TYPE_AND;
-  } else if (pJoinNode->pOnConditions != NULL) {
-    pInfo->pCondAfterMerge = nodesCloneNode(pJoinNode->pOnConditions);
-  } else if (pJoinNode->node.pConditions != NULL) {
-    pInfo->pCondAfterMerge = nodesCloneNode(pJoinNode->node.pConditions);
-  } else {
-    pInfo->pCondAfterMerge = NULL;
+  code = createJoinCondAfterMerge(pJoinNode, &pInfo->pCondAfterMerge);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
   }
 
   code = filterInitFromNode(pInfo->pCondAfterMerge, &pOperator->exprSupp.pFilterInfo, 0);
@@ -508,3 +549,380 @@ SSDataBlock* doMergeJoin(struct SOperatorInfo* pOperator) {
   }
   return (pRes->info.rows > 0) ? pRes : NULL;
 }
+
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SSortMergeJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
+  SHashJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SHashJoinOperatorInfo));
+  SOperatorInfo*         pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pOperator == NULL || pInfo == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  int32_t numOfCols = 0;
+  pInfo->pRes = createDataBlockFromDescNode(pJoinNode->node.pOutputDataBlockDesc);
+
+  SExprInfo* pExprInfo = createExprInfo(pJoinNode->pTargets, NULL, &numOfCols);
+  initResultSizeInfo(&pOperator->resultInfo, 4096);
+  blockDataEnsureCapacity(pInfo->pRes, pOperator->resultInfo.capacity);
+
+  setOperatorInfo(pOperator, "HashJoinOperator", QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, false, OP_NOT_OPENED, pInfo,
+                  pTaskInfo);
+  pOperator->exprSupp.pExprInfo = pExprInfo;
+  pOperator->exprSupp.numOfExprs = numOfCols;
+
+  // the left child is probed against a hash table built from the right child
+  extractTimeCondition(&pInfo->probeCol, &pInfo->buildCol, pDownstream, numOfDownstream, pJoinNode,
+                       GET_TASKID(pTaskInfo));
+
+  pInfo->pKeyHash = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (pInfo->pKeyHash == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+  pInfo->buildPageId = -1;
+  pInfo->nextRow.pageId = -1;
+
+  code = createJoinCondAfterMerge(pJoinNode, &pInfo->pCondAfterJoin);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  code = filterInitFromNode(pInfo->pCondAfterJoin, &pOperator->exprSupp.pFilterInfo, 0);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pOperator->fpSet =
+      createOperatorFpSet(doOpenHashJoin, doHashJoin, NULL, destroyHashJoinOperator, optrDefaultBufFn, NULL);
+  code = appendDownstream(pOperator, pDownstream, numOfDownstream);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pOperator;
+
+_error:
+  if (pInfo != NULL) {
+    destroyHashJoinOperator(pInfo);
+  }
+
+  taosMemoryFree(pOperator);
+  pTaskInfo->code = code;
+  return NULL;
+}
+
+void destroyHashJoinOperator(void* param) {
+  SHashJoinOperatorInfo* pInfo = (SHashJoinOperatorInfo*)param;
+  nodesDestroyNode(pInfo->pCondAfterJoin);
+
+  taosHashCleanup(pInfo->pKeyHash);
+  destroyDiskbasedBuf(pInfo->pBuildBuf);
+  taosMemoryFree(pInfo->pBuildCols);
+  taosMemoryFree(pInfo->pBuildVals);
+
+  pInfo->pRes = blockDataDestroy(pInfo->pRes);
+  taosMemoryFreeClear(param);
+}
+
+static char* hashJoinGetKey(SColumnInfoData* pCol, int32_t row, int32_t* pLen) {
+  char* p = colDataGetData(pCol, row);
+  if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+    *pLen = varDataLen(p);
+    return varDataVal(p);
+  }
+
+  *pLen = pCol->info.bytes;
+  return p;
+}
+
+static int32_t hashJoinGetValLen(const SColumnInfo* pCol, const char* p) {
+  return IS_VAR_DATA_TYPE(pCol->type) ? varDataTLen(p) : pCol->bytes;
+}
+
+static int32_t hashJoinInitBuildBuf(SHashJoinOperatorInfo* pInfo, SSDataBlock* pBlock, const char* idStr) {
+  pInfo->numOfBuildCols = taosArrayGetSize(pBlock->pDataBlock);
+  pInfo->pBuildCols = taosMemoryCalloc(pInfo->numOfBuildCols, sizeof(SColumnInfo));
+  pInfo->pBuildVals = taosMemoryCalloc(pInfo->numOfBuildCols, POINTER_BYTES);
+  if (pInfo->pBuildCols == NULL || pInfo->pBuildVals == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t rowSize = sizeof(SHJoinRow);
+  for (int32_t i = 0; i < pInfo->numOfBuildCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    pInfo->pBuildCols[i] = pCol->info;
+    rowSize += sizeof(int8_t) + pCol->info.bytes;
+  }
+
+  // rows beyond the in-memory pages of the buffer are flushed to disk
+  uint32_t defaultPgsz = 0;
+  uint32_t defaultBufsz = 0;
+  getBufferPgSize(rowSize, &defaultPgsz, &defaultBufsz);
+  return createDiskbasedBuf(&pInfo->pBuildBuf, defaultPgsz, defaultBufsz, idStr, tsTempDir);
+}
+
+static int32_t hashJoinAddBuildRow(SHashJoinOperatorInfo* pInfo, SSDataBlock* pBlock, int32_t row, SHJoinRowId next,
+                                   SHJoinRowId* pId) {
+  int32_t len = sizeof(SHJoinRow);
+  for (int32_t i = 0; i < pInfo->numOfBuildCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    len += sizeof(int8_t);
+    if (!colDataIsNull_s(pCol, row)) {
+      len += hashJoinGetValLen(&pCol->info, colDataGetData(pCol, row));
+    }
+  }
+
+  if (pInfo->pBuildPage == NULL || pInfo->pBuildPage->num + len > getBufPageSize(pInfo->pBuildBuf)) {
+    if (pInfo->pBuildPage != NULL) {
+      releaseBufPage(pInfo->pBuildBuf, pInfo->pBuildPage);
+    }
+
+    pInfo->pBuildPage = getNewBufPage(pInfo->pBuildBuf, &pInfo->buildPageId);
+    if (pInfo->pBuildPage == NULL) {
+      return terrno;
+    }
+    pInfo->pBuildPage->num = sizeof(SFilePage);
+  }
+
+  SHJoinRow* pRow = (SHJoinRow*)((char*)pInfo->pBuildPage + pInfo->pBuildPage->num);
+  pRow->next = next;
+
+  char* p = pRow->data;
+  for (int32_t i = 0; i < pInfo->numOfBuildCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    if (colDataIsNull_s(pCol, row)) {
+      *(int8_t*)p = 1;
+      p += sizeof(int8_t);
+    } else {
+      char*   pVal = colDataGetData(pCol, row);
+      int32_t valLen = hashJoinGetValLen(&pCol->info, pVal);
+      *(int8_t*)p = 0;
+      p += sizeof(int8_t);
+      memcpy(p, pVal, valLen);
+      p += valLen;
+    }
+  }
+
+  pId->pageId = pInfo->buildPageId;
+  pId->offset = pInfo->pBuildPage->num;
+  pInfo->pBuildPage->num += len;
+  setBufPageDirty(pInfo->pBuildPage, true);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hashJoinBuildBlock(SHashJoinOperatorInfo* pInfo, SSDataBlock* pBlock) {
+  SColumnInfoData* pKeyCol = taosArrayGet(pBlock->pDataBlock, pInfo->buildCol.slotId);
+
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    // a null key never equals to any key
+    if (colDataIsNull_s(pKeyCol, i)) {
+      continue;
+    }
+
+    int32_t      keyLen = 0;
+    char*        pKey = hashJoinGetKey(pKeyCol, i, &keyLen);
+    SHJoinRowId* pHead = taosHashGet(pInfo->pKeyHash, pKey, keyLen);
+    SHJoinRowId  next = {.pageId = -1};
+    if (pHead != NULL) {
+      next = *pHead;
+    }
+
+    SHJoinRowId id = {0};
+    int32_t     code = hashJoinAddBuildRow(pInfo, pBlock, i, next, &id);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    // rows of the same key are chained from the last one
+    if (pHead != NULL) {
+      *pHead = id;
+    } else if (taosHashPut(pInfo->pKeyHash, pKey, keyLen, &id, sizeof(SHJoinRowId)) != 0) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the right child is consumed to build the hash table before any row is produced
+static int32_t doOpenHashJoin(SOperatorInfo* pOperator) {
+  if (OPTR_IS_OPENED(pOperator)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+  SOperatorInfo*         pBuild = pOperator->pDownstream[1];
+
+  int64_t st = taosGetTimestampUs();
+
+  while (1) {
+    SSDataBlock* pBlock = pBuild->fpSet.getNextFn(pBuild);
+    if (pBlock == NULL) {
+      break;
+    }
+
+    int32_t code = TSDB_CODE_SUCCESS;
+    if (pInfo->pBuildBuf == NULL) {
+      code = hashJoinInitBuildBuf(pInfo, pBlock, GET_TASKID(pTaskInfo));
+    }
+    if (code == TSDB_CODE_SUCCESS) {
+      code = hashJoinBuildBlock(pInfo, pBlock);
+    }
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+  }
+
+  if (pInfo->pBuildPage != NULL) {
+    releaseBufPage(pInfo->pBuildBuf, pInfo->pBuildPage);
+    pInfo->pBuildPage = NULL;
+  }
+
+  // the downstream operator may return with error code, so let's check the code before probing.
+  if (pTaskInfo->code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, pTaskInfo->code);
+  }
+
+  OPTR_SET_OPENED(pOperator);
+  pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
+  return pTaskInfo->code;
+}
+
+static void hashJoinDecodeBuildRow(SHashJoinOperatorInfo* pInfo, SHJoinRow* pRow) {
+  char* p = pRow->data;
+  for (int32_t i = 0; i < pInfo->numOfBuildCols; ++i) {
+    bool isNull = *(int8_t*)p;
+    p += sizeof(int8_t);
+    if (isNull) {
+      pInfo->pBuildVals[i] = NULL;
+    } else {
+      pInfo->pBuildVals[i] = p;
+      p += hashJoinGetValLen(&pInfo->pBuildCols[i], p);
+    }
+  }
+}
+
+static void hashJoinJoinProbeBuild(SOperatorInfo* pOperator, SSDataBlock* pRes, SSDataBlock* pProbe,
+                                   int32_t probePos) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  int32_t                currRow = pRes->info.rows;
+
+  for (int32_t i = 0; i < pOperator->exprSupp.numOfExprs; ++i) {
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, i);
+    SExprInfo*       pExprInfo = &pOperator->exprSupp.pExprInfo[i];
+
+    int32_t blockId = pExprInfo->base.pParam[0].pCol->dataBlockId;
+    int32_t slotId = pExprInfo->base.pParam[0].pCol->slotId;
+
+    char* p = NULL;
+    if (pProbe->info.id.blockId == blockId) {
+      SColumnInfoData* pSrc = taosArrayGet(pProbe->pDataBlock, slotId);
+      if (!colDataIsNull_s(pSrc, probePos)) {
+        p = colDataGetData(pSrc, probePos);
+      }
+    } else {
+      p = pInfo->pBuildVals[slotId];
+    }
+
+    if (p == NULL) {
+      colDataSetNULL(pDst, currRow);
+    } else {
+      colDataSetVal(pDst, currRow, p, false);
+    }
+  }
+
+  pRes->info.rows += 1;
+}
+
+static void doHashJoinImpl(SOperatorInfo* pOperator, SSDataBlock* pRes) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+  SOperatorInfo*         pProbeOp = pOperator->pDownstream[0];
+
+  while (pRes->info.rows < pOperator->resultInfo.threshold) {
+    // continue with the remaining build rows of the current probe row
+    if (pInfo->nextRow.pageId != -1) {
+      SFilePage* pPage = getBufPage(pInfo->pBuildBuf, pInfo->nextRow.pageId);
+      if (pPage == NULL) {
+        T_LONG_JMP(pTaskInfo->env, terrno);
+      }
+
+      SHJoinRow* pRow = (SHJoinRow*)((char*)pPage + pInfo->nextRow.offset);
+      hashJoinDecodeBuildRow(pInfo, pRow);
+      hashJoinJoinProbeBuild(pOperator, pRes, pInfo->pProbe, pInfo->probePos);
+
+      pInfo->nextRow = pRow->next;
+      releaseBufPage(pInfo->pBuildBuf, pPage);
+      if (pInfo->nextRow.pageId == -1) {
+        pInfo->probePos += 1;
+      }
+      continue;
+    }
+
+    if (pInfo->pProbe == NULL || pInfo->probePos >= pInfo->pProbe->info.rows) {
+      pInfo->pProbe = pProbeOp->fpSet.getNextFn(pProbeOp);
+      pInfo->probePos = 0;
+      if (pInfo->pProbe == NULL) {
+        setOperatorCompleted(pOperator);
+        break;
+      }
+      continue;
+    }
+
+    SColumnInfoData* pKeyCol = taosArrayGet(pInfo->pProbe->pDataBlock, pInfo->probeCol.slotId);
+    SHJoinRowId*     pHead = NULL;
+    if (!colDataIsNull_s(pKeyCol, pInfo->probePos)) {
+      int32_t keyLen = 0;
+      char*   pKey = hashJoinGetKey(pKeyCol, pInfo->probePos, &keyLen);
+      pHead = taosHashGet(pInfo->pKeyHash, pKey, keyLen);
+    }
+
+    if (pHead != NULL) {
+      pInfo->nextRow = *pHead;
+    } else {
+      pInfo->probePos += 1;
+    }
+  }
+}
+
+SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  pTaskInfo->code = pOperator->fpSet._openFn(pOperator);
+  if (pTaskInfo->code != TSDB_CODE_SUCCESS) {
+    setOperatorCompleted(pOperator);
+    return NULL;
+  }
+
+  // nothing to join with an empty build side
+  if (pInfo->pBuildBuf == NULL) {
+    setOperatorCompleted(pOperator);
+    return NULL;
+  }
+
+  SSDataBlock* pRes = pInfo->pRes;
+  blockDataCleanup(pRes);
+
+  while (pOperator->status != OP_EXEC_DONE) {
+    doHashJoinImpl(pOperator, pRes);
+    pRes->info.dataLoad = 1;
+    if (pOperator->exprSupp.pFilterInfo != NULL) {
+      doFilter(pRes, pOperator->exprSupp.pFilterInfo, NULL);
+    }
+    if (pRes->info.rows >= pOperator->resultInfo.threshold) {
+      break;
+    }
+  }
+
+  pOperator->resultInfo.totalRows += pRes->info.rows;
+  return (pRes->info.rows > 0) ? pRes : NULL;
+}
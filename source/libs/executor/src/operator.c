@@ -239,6 +239,7 @@ static ERetType doStopDataReader(SOperatorInfo* pOperator, STraverParam* pParam,
     if (pInfo->base.dataReader != NULL) {
       tsdbReaderSetCloseFlag(pInfo->base.dataReader);
     }
+    stopParallelTableScan(pInfo);
     return OPTR_FN_RET_ABORT;
   } else if (pOperator->operatorType == QUERY_NODE_PHYSICAL_PLAN_STREAM_SCAN) {
     SStreamScanInfo* pInfo = pOperator->info;
@@ -449,6 +450,12 @@ SOperatorInfo* createOperator(SPhysiNode* pPhyNode, SExecTaskInfo* pTaskInfo, SR
     pOptr = createProjectOperatorInfo(ops[0], (SProjectPhysiNode*)pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_HASH_AGG == type) {
     SAggPhysiNode* pAggNode = (SAggPhysiNode*)pPhyNode;
+    SNode*         pChildNode = nodesListGetNode(pPhyNode->pChildren, 0);
+    if (QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN == nodeType(pChildNode) &&
+        ops[0]->operatorType == QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN) {
+      setTableScanParallel(ops[0], (STableScanPhysiNode*)pChildNode, pAggNode);
+    }
+
     if (pAggNode->pGroupKeys != NULL) {
       pOptr = createGroupOperatorInfo(ops[0], pAggNode, pTaskInfo);
     } else {
@@ -500,6 +507,8 @@ SOperatorInfo* createOperator(SPhysiNode* pPhyNode, SExecTaskInfo* pTaskInfo, SR
     pOptr = createStreamStateAggOperatorInfo(ops[0], pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN == type) {
     pOptr = createMergeJoinOperatorInfo(ops, size, (SSortMergeJoinPhysiNode*)pPhyNode, pTaskInfo);
+  } else if (QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN == type) {
+    pOptr = createHashJoinOperatorInfo(ops, size, (SSortMergeJoinPhysiNode*)pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_FILL == type) {
     pOptr = createFillOperatorInfo(ops[0], (SFillPhysiNode*)pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_STREAM_FILL == type) {
@@ -32,6 +32,8 @@
 #include "ttypes.h"
 #include "operator.h"
 #include "querytask.h"
+#include "tglobal.h"
+#include "tworker.h"
 
 int32_t scanDebug = 0;
 
@@ -777,10 +779,775 @@ static SSDataBlock* doGroupedTableScan(SOperatorInfo* pOperator) {
   return NULL;
 }
 
+// A parallel scan splits the time range of the query at the boundaries of the data file sets, and the table list into
+// chunks, and scans the units of one window and one chunk by a few readers. The query thread is one of the readers and
+// the others run in the scan worker pool, handing over copies of their blocks. Each reader takes the units of its own
+// range from the front and steals the units of the others from the back, once its own range is done. All the readers
+// read the data of the same version, and the order of blocks is not kept, so it serves the aggregates only.
+#define PARA_SCAN_UNITS_PER_READER 8
+#define PARA_SCAN_RANGE(_b, _e)    (((int64_t)(_b) << 32) | (uint32_t)(_e))
+#define PARA_SCAN_RANGE_BEGIN(_r)  ((int32_t)((_r) >> 32))
+#define PARA_SCAN_RANGE_END(_r)    ((int32_t)((_r)&0xFFFFFFFF))
+
+typedef struct SParaScanUnit {
+  STimeWindow    window;
+  STableKeyInfo* pList;
+  int32_t        num;
+} SParaScanUnit;
+
+typedef struct SParaScanReader {
+  int32_t                index;
+  int64_t                range;  // units not claimed yet, begin << 32 | end
+  struct SParaScanInfo*  pScan;
+  STsdbReader*           dataReader;
+  SFilterInfo*           pFilterInfo;
+  SSDataBlock*           pResBlock;
+  SFileBlockLoadRecorder readRecorder;
+  STableMetaCacheInfo    metaCache;
+} SParaScanReader;
+
+typedef struct SParaScanInfo {
+  SOperatorInfo*   pOperator;
+  SArray*          pUnits;  // SParaScanUnit
+  int32_t          numOfReaders;
+  SParaScanReader* pReaders;  // the first one is the query thread, reading with the reader of the operator
+  bool             scanning;  // the query thread has a unit being scanned
+  TdThreadMutex    lock;
+  TdThreadCond     hasBlock;
+  TdThreadCond     hasRoom;
+  SArray*          pReady;  // blocks copied by the workers, not returned yet
+  SArray*          pFree;   // blocks returned and recycled
+  int32_t          maxReady;
+  SSDataBlock*     pOutput;  // block being returned to the upstream
+  int32_t          numOfRunning;
+  int32_t          nRef;
+  int8_t           stop;
+  int32_t          code;
+} SParaScanInfo;
+
+static SSingleWorker paraScanWorker = {0};
+
+static void paraScanWorkerFp(SQueueInfo* pQInfo, void* pItem);
+
+int32_t initParaScanPool() {
+  SSingleWorkerCfg cfg = {.min = TMAX(tsNumOfVnodeQueryThreads, 1),
+                          .max = TMAX(tsNumOfVnodeQueryThreads, 1),
+                          .name = "query-scan",
+                          .fp = paraScanWorkerFp};
+  if (tSingleWorkerInit(&paraScanWorker, &cfg) != 0) {
+    qError("failed to init parallel scan pool since %s", terrstr());
+    return terrno;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+void cleanupParaScanPool() { tSingleWorkerCleanup(&paraScanWorker); }
+
+static void destroyParaScanBlock(void* param) { blockDataDestroy(*(SSDataBlock**)param); }
+
+static void releaseParaScan(SParaScanInfo* p) {
+  if (atomic_sub_fetch_32(&p->nRef, 1) > 0) {
+    return;
+  }
+
+  taosArrayDestroyEx(p->pReady, destroyParaScanBlock);
+  taosArrayDestroyEx(p->pFree, destroyParaScanBlock);
+  blockDataDestroy(p->pOutput);
+  taosArrayDestroy(p->pUnits);
+  taosMemoryFree(p->pReaders);
+  taosThreadCondDestroy(&p->hasBlock);
+  taosThreadCondDestroy(&p->hasRoom);
+  taosThreadMutexDestroy(&p->lock);
+  taosMemoryFree(p);
+}
+
+// take a unit from the front of its own range, or steal one from the back of the largest range of the others
+static int32_t claimParaScanUnit(SParaScanInfo* p, int32_t index) {
+  int64_t* pRange = &p->pReaders[index].range;
+  while (true) {
+    int64_t range = atomic_load_64(pRange);
+    int32_t begin = PARA_SCAN_RANGE_BEGIN(range);
+    int32_t end = PARA_SCAN_RANGE_END(range);
+    if (begin >= end) {
+      break;
+    }
+    if (atomic_val_compare_exchange_64(pRange, range, PARA_SCAN_RANGE(begin + 1, end)) == range) {
+      return begin;
+    }
+  }
+
+  while (true) {
+    int32_t victim = -1;
+    int32_t most = 0;
+    int64_t range = 0;
+    for (int32_t i = 0; i < p->numOfReaders; ++i) {
+      int64_t r = atomic_load_64(&p->pReaders[i].range);
+      int32_t n = PARA_SCAN_RANGE_END(r) - PARA_SCAN_RANGE_BEGIN(r);
+      if (n > most) {
+        victim = i;
+        most = n;
+        range = r;
+      }
+    }
+
+    if (victim < 0) {
+      return -1;
+    }
+
+    int32_t begin = PARA_SCAN_RANGE_BEGIN(range);
+    int32_t end = PARA_SCAN_RANGE_END(range);
+    if (atomic_val_compare_exchange_64(&p->pReaders[victim].range, range, PARA_SCAN_RANGE(begin, end - 1)) == range) {
+      return end - 1;
+    }
+  }
+}
+
+static int32_t setParaScanUnit(SParaScanInfo* p, STsdbReader** ppReader, SSDataBlock* pResBlock,
+                               SFilterInfo* pFilterInfo, int32_t unit) {
+  STableScanInfo* pInfo = p->pOperator->info;
+  SParaScanUnit*  pUnit = taosArrayGet(p->pUnits, unit);
+  int32_t         code = TSDB_CODE_SUCCESS;
+
+  if (*ppReader == NULL) {
+    // open with the whole time range, so that all the readers read the same level of the retention
+    code = tsdbReaderOpen(pInfo->base.readHandle.vnode, &pInfo->base.cond, pUnit->pList, pUnit->num, pResBlock,
+                          ppReader, GET_TASKID(p->pOperator->pTaskInfo), false);
+    if (code == TSDB_CODE_SUCCESS && pInfo->pFilterColIds != NULL) {
+      code = tsdbReaderSetFilter(*ppReader, pFilterInfo, pInfo->pFilterColIds);
+    }
+  } else {
+    code = tsdbSetTableList(*ppReader, pUnit->pList, pUnit->num);
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    SQueryTableDataCond cond = pInfo->base.cond;
+    cond.twindows = pUnit->window;
+    code = tsdbReaderReset(*ppReader, &cond);
+  }
+
+  return code;
+}
+
+static int32_t setParaScanTagColumnData(SParaScanReader* pReader, SSDataBlock* pBlock, int32_t rows) {
+  STableScanBase* pBase = &((STableScanInfo*)pReader->pScan->pOperator->info)->base;
+  if (pBase->pseudoSup.numOfExprs > 0) {
+    SExprSupp* pSup = &pBase->pseudoSup;
+
+    int32_t code = addTagPseudoColumnData(&pBase->readHandle, pSup->pExprInfo, pSup->numOfExprs, pBlock, rows,
+                                          GET_TASKID(pReader->pScan->pOperator->pTaskInfo), &pReader->metaCache);
+    // ignore the table not exists error, since this table may have been dropped during the scan procedure.
+    if (code != TSDB_CODE_SUCCESS && code != TSDB_CODE_PAR_TABLE_NOT_EXIST) {
+      return code;
+    }
+
+    // reset the error code.
+    terrno = 0;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the same as loadDataBlock, except that the blocks are not pruned by the results of the aggregate, which is
+// accessed only by the query thread
+static int32_t loadParaScanBlock(SParaScanReader* pReader, uint32_t* status) {
+  STableScanBase*         pBase = &((STableScanInfo*)pReader->pScan->pOperator->info)->base;
+  SSDataBlock*            pBlock = pReader->pResBlock;
+  SFileBlockLoadRecorder* pCost = &pReader->readRecorder;
+  int32_t                 code = TSDB_CODE_SUCCESS;
+
+  pCost->totalBlocks += 1;
+  pCost->totalRows += pBlock->info.rows;
+
+  *status = pBase->dataBlockLoadFlag;
+  if (pReader->pFilterInfo != NULL || overlapWithTimeWindow(&pBase->pdInfo.interval, &pBlock->info, pBase->cond.order)) {
+    *status = FUNC_DATA_REQUIRED_DATA_LOAD;
+  }
+
+  taosMemoryFreeClear(pBlock->pBlockAgg);
+
+  if (*status == FUNC_DATA_REQUIRED_FILTEROUT) {
+    pCost->filterOutBlocks += 1;
+    tsdbReleaseDataBlock(pReader->dataReader);
+    return TSDB_CODE_SUCCESS;
+  } else if (*status == FUNC_DATA_REQUIRED_NOT_LOAD) {
+    code = setParaScanTagColumnData(pReader, pBlock, pBlock->info.rows);
+    pCost->skipBlocks += 1;
+    tsdbReleaseDataBlock(pReader->dataReader);
+    return code;
+  } else if (*status == FUNC_DATA_REQUIRED_SMA_LOAD) {
+    bool allColumnsHaveAgg = true;
+    pCost->loadBlockStatis += 1;
+    code = tsdbRetrieveDatablockSMA(pReader->dataReader, pBlock, &allColumnsHaveAgg);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbReleaseDataBlock(pReader->dataReader);
+      return code;
+    }
+
+    if (allColumnsHaveAgg) {
+      code = setParaScanTagColumnData(pReader, pBlock, pBlock->info.rows);
+      tsdbReleaseDataBlock(pReader->dataReader);
+      return code;
+    }
+
+    *status = FUNC_DATA_REQUIRED_DATA_LOAD;
+  } else if (pReader->pFilterInfo != NULL) {
+    // try to filter data block according to sma info
+    bool allColumnsHaveAgg = true;
+    code = tsdbRetrieveDatablockSMA(pReader->dataReader, pBlock, &allColumnsHaveAgg);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbReleaseDataBlock(pReader->dataReader);
+      return code;
+    }
+
+    size_t size = taosArrayGetSize(pBlock->pDataBlock);
+    if (allColumnsHaveAgg && !doFilterByBlockSMA(pReader->pFilterInfo, pBlock->pBlockAgg, size, pBlock->info.rows)) {
+      pCost->filterOutBlocks += 1;
+      *status = FUNC_DATA_REQUIRED_FILTEROUT;
+      tsdbReleaseDataBlock(pReader->dataReader);
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
+  taosMemoryFreeClear(pBlock->pBlockAgg);
+
+  pCost->totalCheckedRows += pBlock->info.rows;
+  pCost->loadBlocks += 1;
+
+  SSDataBlock* p = tsdbRetrieveDataBlock(pReader->dataReader, NULL);
+  if (p == NULL) {
+    return terrno;
+  }
+
+  code = setParaScanTagColumnData(pReader, pBlock, pBlock->info.rows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // restore the previous value
+  pCost->totalRows -= pBlock->info.rows;
+
+  if (pReader->pFilterInfo != NULL) {
+    int64_t st = taosGetTimestampUs();
+    doFilter(pBlock, pReader->pFilterInfo, &pBase->matchInfo);
+    pCost->filterTime += (taosGetTimestampUs() - st) / 1000.0;
+
+    if (pBlock->info.rows == 0) {
+      pCost->filterOutBlocks += 1;
+    }
+  }
+
+  pCost->totalRows += pBlock->info.rows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t copyParaScanBlock(SParaScanInfo* p, SSDataBlock* pDst, const SSDataBlock* pSrc, bool dataLoaded) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  if (dataLoaded) {
+    code = copyDataBlock(pDst, pSrc);
+  } else {
+    // only the sma and the tags of the block are available
+    STableScanBase* pBase = &((STableScanInfo*)p->pOperator->info)->base;
+    blockDataCleanup(pDst);
+    code = blockDataEnsureCapacity(pDst, pSrc->info.rows);
+    for (int32_t i = 0; code == TSDB_CODE_SUCCESS && i < pBase->pseudoSup.numOfExprs; ++i) {
+      int32_t slotId = pBase->pseudoSup.pExprInfo[i].base.resSchema.slotId;
+      code = colDataAssign(taosArrayGet(pDst->pDataBlock, slotId), taosArrayGet(pSrc->pDataBlock, slotId),
+                           pSrc->info.rows, &pSrc->info);
+    }
+
+    uint32_t cap = pDst->info.capacity;
+    pDst->info = pSrc->info;
+    pDst->info.capacity = cap;
+  }
+
+  taosMemoryFreeClear(pDst->pBlockAgg);
+  if (code == TSDB_CODE_SUCCESS && pSrc->pBlockAgg != NULL) {
+    // the sma is kept by the tsdb reader, so copy it together with the pointers to it in one buffer
+    size_t numOfCols = taosArrayGetSize(pSrc->pDataBlock);
+    pDst->pBlockAgg = taosMemoryCalloc(numOfCols, POINTER_BYTES + sizeof(SColumnDataAgg));
+    if (pDst->pBlockAgg == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    SColumnDataAgg* pAgg = (SColumnDataAgg*)((char*)pDst->pBlockAgg + numOfCols * POINTER_BYTES);
+    for (int32_t i = 0; i < numOfCols; ++i) {
+      if (pSrc->pBlockAgg[i] != NULL) {
+        pAgg[i] = *pSrc->pBlockAgg[i];
+        pDst->pBlockAgg[i] = &pAgg[i];
+      }
+    }
+  }
+
+  return code;
+}
+
+static int32_t pushParaScanBlock(SParaScanInfo* p, const SSDataBlock* pSrc, bool dataLoaded) {
+  SSDataBlock* pDst = NULL;
+
+  taosThreadMutexLock(&p->lock);
+  if (taosArrayGetSize(p->pFree) > 0) {
+    pDst = *(SSDataBlock**)taosArrayPop(p->pFree);
+  }
+  taosThreadMutexUnlock(&p->lock);
+
+  if (pDst == NULL) {
+    pDst = createOneDataBlock(((STableScanInfo*)p->pOperator->info)->pResBlock, false);
+    if (pDst == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  int32_t code = copyParaScanBlock(p, pDst, pSrc, dataLoaded);
+  if (code != TSDB_CODE_SUCCESS) {
+    blockDataDestroy(pDst);
+    return code;
+  }
+
+  taosThreadMutexLock(&p->lock);
+  while (!p->stop && taosArrayGetSize(p->pReady) >= p->maxReady) {
+    taosThreadCondWait(&p->hasRoom, &p->lock);
+  }
+
+  if (p->stop || taosArrayPush(p->pReady, &pDst) == NULL) {
+    blockDataDestroy(pDst);
+  } else {
+    taosThreadCondSignal(&p->hasBlock);
+  }
+  taosThreadMutexUnlock(&p->lock);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t doParaScanWorker(SParaScanReader* pReader) {
+  SParaScanInfo*  p = pReader->pScan;
+  STableScanInfo* pInfo = p->pOperator->info;
+  int32_t         code = TSDB_CODE_SUCCESS;
+  int32_t         unit = -1;
+
+  while (!atomic_load_8(&p->stop) && (unit = claimParaScanUnit(p, pReader->index)) >= 0) {
+    if (pReader->pResBlock == NULL) {
+      code = filterInitFromNode(pInfo->pParaCond, &pReader->pFilterInfo, 0);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+
+      pReader->pResBlock = createOneDataBlock(pInfo->pResBlock, false);
+      if (pReader->pResBlock == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+
+    code = setParaScanUnit(p, &pReader->dataReader, pReader->pResBlock, pReader->pFilterInfo, unit);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    SSDataBlock* pBlock = pReader->pResBlock;
+    bool         hasNext = false;
+    while (!atomic_load_8(&p->stop)) {
+      code = tsdbNextDataBlock(pReader->dataReader, &hasNext);
+      if (code != TSDB_CODE_SUCCESS) {
+        tsdbReleaseDataBlock(pReader->dataReader);
+        return code;
+      }
+
+      if (!hasNext) {
+        break;
+      }
+
+      if (pBlock->info.id.uid) {
+        pBlock->info.id.groupId = getTableGroupId(pInfo->base.pTableListInfo, pBlock->info.id.uid);
+      }
+
+      uint32_t status = 0;
+      code = loadParaScanBlock(pReader, &status);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+
+      if (status == FUNC_DATA_REQUIRED_FILTEROUT || pBlock->info.rows == 0) {
+        continue;
+      }
+
+      code = pushParaScanBlock(p, pBlock, status == FUNC_DATA_REQUIRED_DATA_LOAD);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+  }
+
+  return code;
+}
+
+static void paraScanWorkerFp(SQueueInfo* pQInfo, void* pItem) {
+  SParaScanReader* pReader = *(SParaScanReader**)pItem;
+  SParaScanInfo*   p = pReader->pScan;
+  taosFreeQitem(pItem);
+
+  taosThreadMutexLock(&p->lock);
+  if (p->stop) {
+    taosThreadMutexUnlock(&p->lock);
+    releaseParaScan(p);
+    return;
+  }
+  p->numOfRunning += 1;
+  taosThreadMutexUnlock(&p->lock);
+
+  int32_t code = doParaScanWorker(pReader);
+
+  tsdbReaderClose(pReader->dataReader);
+  pReader->dataReader = NULL;
+  filterFreeInfo(pReader->pFilterInfo);
+  pReader->pFilterInfo = NULL;
+  blockDataDestroy(pReader->pResBlock);
+  pReader->pResBlock = NULL;
+
+  taosThreadMutexLock(&p->lock);
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s parallel scan reader:%d failed since %s", GET_TASKID(p->pOperator->pTaskInfo), pReader->index,
+           tstrerror(code));
+    if (p->code == TSDB_CODE_SUCCESS) {
+      p->code = code;
+    }
+    p->stop = 1;
+    taosThreadCondBroadcast(&p->hasRoom);
+  }
+  p->numOfRunning -= 1;
+  taosThreadCondBroadcast(&p->hasBlock);
+  taosThreadMutexUnlock(&p->lock);
+
+  releaseParaScan(p);
+}
+
+static int32_t buildParaScanUnits(SParaScanInfo* p, SArray* pWindows) {
+  STableScanInfo* pInfo = p->pOperator->info;
+  int32_t         numOfTables = tableListGetSize(pInfo->base.pTableListInfo);
+  STableKeyInfo*  pList = tableListGetInfo(pInfo->base.pTableListInfo, 0);
+  int32_t         target = p->numOfReaders * PARA_SCAN_UNITS_PER_READER;
+  int32_t         numOfWindows = taosArrayGetSize(pWindows);
+
+  // merge the adjacent windows if there are too many file sets, or split the tables into chunks if too few
+  int32_t step = (numOfWindows + target - 1) / target;
+  int32_t numOfChunks = TMIN(TMAX(target / ((numOfWindows + step - 1) / step), 1), numOfTables);
+  int32_t chunkSize = (numOfTables + numOfChunks - 1) / numOfChunks;
+
+  for (int32_t i = 0; i < numOfWindows; i += step) {
+    STimeWindow w = {.skey = ((STimeWindow*)taosArrayGet(pWindows, i))->skey,
+                     .ekey = ((STimeWindow*)taosArrayGet(pWindows, TMIN(i + step, numOfWindows) - 1))->ekey};
+    for (int32_t j = 0; j < numOfTables; j += chunkSize) {
+      SParaScanUnit unit = {.window = w, .pList = pList + j, .num = TMIN(chunkSize, numOfTables - j)};
+      if (taosArrayPush(p->pUnits, &unit) == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+  }
+
+  // the readers start from the successive ranges of units, so that each one moves forward in time
+  int32_t numOfUnits = taosArrayGetSize(p->pUnits);
+  for (int32_t i = 0; i < p->numOfReaders; ++i) {
+    p->pReaders[i].range = PARA_SCAN_RANGE((int64_t)numOfUnits * i / p->numOfReaders,
+                                           (int64_t)numOfUnits * (i + 1) / p->numOfReaders);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t startParallelTableScan(SOperatorInfo* pOperator) {
+  STableScanInfo* pInfo = pOperator->info;
+  SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
+  SArray*         pWindows = NULL;
+  int32_t         code = TSDB_CODE_SUCCESS;
+
+  int32_t numOfTables = tableListGetSize(pInfo->base.pTableListInfo);
+  if (numOfTables == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  STableKeyInfo* pList = tableListGetInfo(pInfo->base.pTableListInfo, 0);
+  code = tsdbReaderOpen(pInfo->base.readHandle.vnode, &pInfo->base.cond, pList, numOfTables, pInfo->pResBlock,
+                        (STsdbReader**)&pInfo->base.dataReader, GET_TASKID(pTaskInfo), false);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (pInfo->pFilterColIds != NULL) {
+    code = tsdbReaderSetFilter(pInfo->base.dataReader, pOperator->exprSupp.pFilterInfo, pInfo->pFilterColIds);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  if (pInfo->pResBlock->info.capacity > pOperator->resultInfo.capacity) {
+    pOperator->resultInfo.capacity = pInfo->pResBlock->info.capacity;
+  }
+
+  // the other readers are opened later, do not let them see the data written after this one
+  pInfo->base.cond.endVersion = tsdbGetReaderMaxVersion(pInfo->base.dataReader);
+
+  pWindows = taosArrayInit(8, sizeof(STimeWindow));
+  if (pWindows == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  code = tsdbGetFileSetWindows(pInfo->base.dataReader, pWindows);
+  if (code != TSDB_CODE_SUCCESS || taosArrayGetSize(pWindows) == 0) {
+    taosArrayDestroy(pWindows);
+    return code;
+  }
+
+  SParaScanInfo* p = taosMemoryCalloc(1, sizeof(SParaScanInfo));
+  if (p == NULL) {
+    taosArrayDestroy(pWindows);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  p->pOperator = pOperator;
+  p->numOfReaders = (paraScanWorker.queue != NULL) ? TMIN(pInfo->numOfParaReaders, paraScanWorker.pool.max + 1) : 1;
+  p->maxReady = p->numOfReaders * 2;
+  p->nRef = 1;
+  p->pUnits = taosArrayInit(p->numOfReaders * PARA_SCAN_UNITS_PER_READER, sizeof(SParaScanUnit));
+  p->pReady = taosArrayInit(p->maxReady, POINTER_BYTES);
+  p->pFree = taosArrayInit(p->maxReady, POINTER_BYTES);
+  p->pReaders = taosMemoryCalloc(p->numOfReaders, sizeof(SParaScanReader));
+  taosThreadMutexInit(&p->lock, NULL);
+  taosThreadCondInit(&p->hasBlock, NULL);
+  taosThreadCondInit(&p->hasRoom, NULL);
+  pInfo->pParaScan = p;
+
+  if (p->pUnits == NULL || p->pReady == NULL || p->pFree == NULL || p->pReaders == NULL) {
+    taosArrayDestroy(pWindows);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < p->numOfReaders; ++i) {
+    p->pReaders[i].index = i;
+    p->pReaders[i].pScan = p;
+    p->pReaders[i].metaCache.pTableMetaEntryCache = pInfo->base.metaCache.pTableMetaEntryCache;
+  }
+
+  code = buildParaScanUnits(p, pWindows);
+  taosArrayDestroy(pWindows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // the units of a reader failed to be dispatched are stolen by the others
+  for (int32_t i = 1; i < p->numOfReaders; ++i) {
+    SParaScanReader** pItem = taosAllocateQitem(sizeof(SParaScanReader*), DEF_QITEM, 0);
+    if (pItem == NULL) {
+      break;
+    }
+
+    *pItem = &p->pReaders[i];
+    atomic_add_fetch_32(&p->nRef, 1);
+    taosWriteQitem(paraScanWorker.queue, pItem);
+  }
+
+  qDebug("%s start parallel scan, readers:%d, units:%d, tables:%d, version:%" PRId64, GET_TASKID(pTaskInfo),
+         p->numOfReaders, (int32_t)taosArrayGetSize(p->pUnits), numOfTables, pInfo->base.cond.endVersion);
+  return TSDB_CODE_SUCCESS;
+}
+
+static void finishParallelTableScan(SOperatorInfo* pOperator) {
+  STableScanInfo*         pInfo = pOperator->info;
+  SParaScanInfo*          p = pInfo->pParaScan;
+  SFileBlockLoadRecorder* pCost = &pInfo->base.readRecorder;
+
+  for (int32_t i = 1; i < p->numOfReaders; ++i) {
+    SFileBlockLoadRecorder* pRecorder = &p->pReaders[i].readRecorder;
+    pCost->totalBlocks += pRecorder->totalBlocks;
+    pCost->loadBlocks += pRecorder->loadBlocks;
+    pCost->loadBlockStatis += pRecorder->loadBlockStatis;
+    pCost->skipBlocks += pRecorder->skipBlocks;
+    pCost->filterOutBlocks += pRecorder->filterOutBlocks;
+    pCost->totalRows += pRecorder->totalRows;
+    pCost->totalCheckedRows += pRecorder->totalCheckedRows;
+    pCost->filterTime += pRecorder->filterTime;
+  }
+
+  pOperator->resultInfo.totalRows = pCost->totalRows;
+  setOperatorCompleted(pOperator);
+}
+
+static SSDataBlock* doParallelTableScan(SOperatorInfo* pOperator) {
+  STableScanInfo* pInfo = pOperator->info;
+  SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
+
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  if (pInfo->pParaScan == NULL) {
+    int32_t code = startParallelTableScan(pOperator);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    // no qualified tables or no data in the time range
+    if (pInfo->pParaScan == NULL) {
+      setOperatorCompleted(pOperator);
+      return NULL;
+    }
+  }
+
+  SParaScanInfo* p = pInfo->pParaScan;
+  if (p->pOutput != NULL) {
+    taosThreadMutexLock(&p->lock);
+    if (taosArrayPush(p->pFree, &p->pOutput) == NULL) {
+      blockDataDestroy(p->pOutput);
+    }
+    taosThreadMutexUnlock(&p->lock);
+    p->pOutput = NULL;
+  }
+
+  while (true) {
+    if (isTaskKilled(pTaskInfo)) {
+      T_LONG_JMP(pTaskInfo->env, pTaskInfo->code);
+    }
+
+    // take the blocks of the workers in the first place, so that they are not blocked
+    taosThreadMutexLock(&p->lock);
+    int32_t code = p->code;
+    if (code == TSDB_CODE_SUCCESS && taosArrayGetSize(p->pReady) > 0) {
+      p->pOutput = *(SSDataBlock**)taosArrayPop(p->pReady);
+      taosThreadCondSignal(&p->hasRoom);
+    }
+    taosThreadMutexUnlock(&p->lock);
+
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    if (p->pOutput != NULL) {
+      return p->pOutput;
+    }
+
+    if (p->scanning) {
+      SSDataBlock* pBlock = doTableScanImpl(pOperator);
+      if (pBlock != NULL) {
+        return pBlock;
+      }
+      p->scanning = false;
+    }
+
+    int32_t unit = claimParaScanUnit(p, 0);
+    if (unit >= 0) {
+      code = setParaScanUnit(p, (STsdbReader**)&pInfo->base.dataReader, pInfo->pResBlock,
+                             pOperator->exprSupp.pFilterInfo, unit);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+      p->scanning = true;
+      continue;
+    }
+
+    // all the units are taken, wait for the workers
+    taosThreadMutexLock(&p->lock);
+    while (p->code == TSDB_CODE_SUCCESS && taosArrayGetSize(p->pReady) == 0 && p->numOfRunning > 0) {
+      taosThreadCondWait(&p->hasBlock, &p->lock);
+    }
+    bool done = (p->code == TSDB_CODE_SUCCESS && taosArrayGetSize(p->pReady) == 0 && p->numOfRunning == 0);
+    taosThreadMutexUnlock(&p->lock);
+
+    if (done) {
+      break;
+    }
+  }
+
+  finishParallelTableScan(pOperator);
+  return NULL;
+}
+
+static void destroyParallelTableScan(STableScanInfo* pInfo) {
+  SParaScanInfo* p = pInfo->pParaScan;
+  if (p == NULL) {
+    return;
+  }
+
+  // the workers running refer to the operator, wait for them to quit
+  taosThreadMutexLock(&p->lock);
+  p->stop = 1;
+  taosThreadCondBroadcast(&p->hasRoom);
+  while (p->numOfRunning > 0) {
+    taosThreadCondWait(&p->hasBlock, &p->lock);
+  }
+  taosThreadMutexUnlock(&p->lock);
+
+  pInfo->pParaScan = NULL;
+  releaseParaScan(p);
+}
+
+void stopParallelTableScan(STableScanInfo* pInfo) {
+  if (pInfo->pParaScan != NULL) {
+    atomic_store_8(&pInfo->pParaScan->stop, 1);
+  }
+}
+
+static bool isParallelScanAggFunc(SNode* pNode) {
+  if (QUERY_NODE_TARGET == nodeType(pNode)) {
+    pNode = ((STargetNode*)pNode)->pExpr;
+  }
+
+  if (QUERY_NODE_FUNCTION != nodeType(pNode)) {
+    return false;
+  }
+
+  switch (((SFunctionNode*)pNode)->funcType) {
+    case FUNCTION_TYPE_COUNT:
+    case FUNCTION_TYPE_SUM:
+    case FUNCTION_TYPE_MIN:
+    case FUNCTION_TYPE_MAX:
+    case FUNCTION_TYPE_AVG:
+    case FUNCTION_TYPE_AVG_PARTIAL:
+    case FUNCTION_TYPE_AVG_MERGE:
+    case FUNCTION_TYPE_SPREAD:
+    case FUNCTION_TYPE_SPREAD_PARTIAL:
+    case FUNCTION_TYPE_SPREAD_MERGE:
+    case FUNCTION_TYPE_STDDEV:
+    case FUNCTION_TYPE_STDDEV_PARTIAL:
+    case FUNCTION_TYPE_STDDEV_MERGE:
+    case FUNCTION_TYPE_HYPERLOGLOG:
+    case FUNCTION_TYPE_HYPERLOGLOG_PARTIAL:
+    case FUNCTION_TYPE_HYPERLOGLOG_MERGE:
+    case FUNCTION_TYPE_GROUP_KEY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The blocks of a parallel scan arrive out of order, so it is enabled only if the aggregate above the scan takes the
+// blocks in any order, with the results of all the functions independent of the order of rows.
+void setTableScanParallel(SOperatorInfo* pOperator, STableScanPhysiNode* pScanNode, SAggPhysiNode* pAggNode) {
+  STableScanInfo* pInfo = pOperator->info;
+
+  if (pScanNode->parallelScan <= 1 || pInfo->scanMode == TABLE_SCAN__TABLE_ORDER || pInfo->countOnly ||
+      pInfo->scanInfo.numOfAsc != 1 || pInfo->scanInfo.numOfDesc != 0 || pScanNode->groupSort ||
+      pScanNode->pDynamicScanFuncs != NULL || pScanNode->scan.node.pLimit != NULL ||
+      pScanNode->scan.node.pSlimit != NULL) {
+    return;
+  }
+
+  SNode* pNode = NULL;
+  FOREACH(pNode, pAggNode->pAggFuncs) {
+    if (!isParallelScanAggFunc(pNode)) {
+      return;
+    }
+  }
+
+  pInfo->numOfParaReaders = pScanNode->parallelScan;
+  pInfo->pParaCond = pScanNode->scan.node.pConditions;
+  qDebug("%s table scan in parallel, max readers:%d", GET_TASKID(pOperator->pTaskInfo), pInfo->numOfParaReaders);
+}
+
 static SSDataBlock* doTableScan(SOperatorInfo* pOperator) {
   STableScanInfo* pInfo = pOperator->info;
   SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
 
+  if (pInfo->numOfParaReaders > 1) {
+    return doParallelTableScan(pOperator);
+  }
+
   // scan table one by one sequentially
   if (pInfo->scanMode == TABLE_SCAN__TABLE_ORDER) {
     int32_t       numOfTables = 0;  // tableListGetSize(pTaskInfo->pTableListInfo);
@@ -832,6 +1599,13 @@ static SSDataBlock* doTableScan(SOperatorInfo* pOperator) {
         T_LONG_JMP(pTaskInfo->env, code);
       }
 
+      if (pInfo->pFilterColIds != NULL && !pInfo->countOnly) {
+        code = tsdbReaderSetFilter(pInfo->base.dataReader, pOperator->exprSupp.pFilterInfo, pInfo->pFilterColIds);
+        if (code != TSDB_CODE_SUCCESS) {
+          T_LONG_JMP(pTaskInfo->env, code);
+        }
+      }
+
       if (pInfo->pResBlock->info.capacity > pOperator->resultInfo.capacity) {
         pOperator->resultInfo.capacity = pInfo->pResBlock->info.capacity;
       }
@@ -895,11 +1669,56 @@ static void destroyTableScanBase(STableScanBase* pBase) {
 
 static void destroyTableScanOperatorInfo(void* param) {
   STableScanInfo* pTableScanInfo = (STableScanInfo*)param;
+  destroyParallelTableScan(pTableScanInfo);
   blockDataDestroy(pTableScanInfo->pResBlock);
+  taosArrayDestroy(pTableScanInfo->pFilterColIds);
   destroyTableScanBase(&pTableScanInfo->base);
   taosMemoryFreeClear(param);
 }
 
+static EDealRes collectFilterColIds(SNode* pNode, void* pContext) {
+  SArray** ppColIds = pContext;
+
+  if (QUERY_NODE_COLUMN == nodeType(pNode)) {
+    SColumnNode* pCol = (SColumnNode*)pNode;
+    if (pCol->colType != COLUMN_TYPE_COLUMN) {
+      taosArrayDestroy(*ppColIds);
+      *ppColIds = NULL;
+      return DEAL_RES_END;
+    }
+
+    for (int32_t i = 0; i < taosArrayGetSize(*ppColIds); ++i) {
+      if (*(int16_t*)taosArrayGet(*ppColIds, i) == pCol->colId) {
+        return DEAL_RES_CONTINUE;
+      }
+    }
+    taosArrayPush(*ppColIds, &pCol->colId);
+  } else if (QUERY_NODE_FUNCTION == nodeType(pNode) && fmIsScanPseudoColumnFunc(((SFunctionNode*)pNode)->funcId)) {
+    taosArrayDestroy(*ppColIds);
+    *ppColIds = NULL;
+    return DEAL_RES_END;
+  }
+
+  return DEAL_RES_CONTINUE;
+}
+
+// The filter is pushed down to the tsdb reader, so that the reader decodes the other columns of a file block only if
+// some rows qualify. It is possible only if all the columns of the filter are loaded by the reader, not the tags or
+// pseudo columns filled after the block is retrieved.
+static SArray* getPushdownFilterColIds(SNode* pCondition) {
+  if (pCondition == NULL) {
+    return NULL;
+  }
+
+  SArray* pColIds = taosArrayInit(4, sizeof(int16_t));
+  if (pColIds == NULL) {
+    return NULL;
+  }
+
+  nodesWalkExpr(pCondition, collectFilterColIds, &pColIds);
+  return pColIds;
+}
+
 SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode, SReadHandle* readHandle,
                                            STableListInfo* pTableListInfo, SExecTaskInfo* pTaskInfo) {
   int32_t         code = 0;
@@ -951,6 +1770,10 @@ SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode,
     goto _error;
   }
 
+  if (pOperator->exprSupp.pFilterInfo != NULL) {
+    pInfo->pFilterColIds = getPushdownFilterColIds(pTableScanNode->scan.node.pConditions);
+  }
+
   pInfo->currentGroupId = -1;
   pInfo->assignBlockUid = pTableScanNode->assignBlockUid;
   pInfo->hasGroupByTag = pTableScanNode->pGroupTags ? true : false;
@@ -2667,6 +3490,13 @@ static SSDataBlock* getTableDataBlockImpl(void* param) {
     if (code != 0) {
       T_LONG_JMP(pTaskInfo->env, code);
     }
+
+    if (pInfo->pFilterColIds != NULL) {
+      code = tsdbReaderSetFilter(source->dataReader, pOperator->exprSupp.pFilterInfo, pInfo->pFilterColIds);
+      if (code != 0) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+    }
   }
 
   pInfo->base.dataReader = source->dataReader;
@@ -2984,6 +3814,7 @@ void destroyTableMergeScanOperatorInfo(void* param) {
   pTableScanInfo->pSortInputBlock = blockDataDestroy(pTableScanInfo->pSortInputBlock);
 
   taosArrayDestroy(pTableScanInfo->pSortInfo);
+  taosArrayDestroy(pTableScanInfo->pFilterColIds);
   taosMemoryFreeClear(param);
 }
 
@@ -3054,6 +3885,10 @@ SOperatorInfo* createTableMergeScanOperatorInfo(STableScanPhysiNode* pTableScanN
     goto _error;
   }
 
+  if (pOperator->exprSupp.pFilterInfo != NULL) {
+    pInfo->pFilterColIds = getPushdownFilterColIds(pTableScanNode->scan.node.pConditions);
+  }
+
   initResultSizeInfo(&pOperator->resultInfo, 1024);
   pInfo->pResBlock = createDataBlockFromDescNode(pDescNode);
   blockDataEnsureCapacity(pInfo->pResBlock, pOperator->resultInfo.capacity);
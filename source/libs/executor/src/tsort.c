@@ -19,10 +19,12 @@
 #include "tcompare.h"
 #include "tdatablock.h"
 #include "tdef.h"
+#include "tglobal.h"
 #include "tlosertree.h"
 #include "tpagedbuf.h"
 #include "tsort.h"
 #include "tutil.h"
+#include "tworker.h"
 
 struct STupleHandle {
   SSDataBlock* pBlock;
@@ -56,9 +58,27 @@ struct SSortHandle {
   _sort_fetch_block_fn_t  fetchfp;
   _sort_merge_compar_fn_t comparFn;
   SMultiwayMergeTreeInfo* pMergeTree;
+
+  int32_t numOfParaRuns;  // max number of runs being sorted in parallel
+  SArray* pRuns;          // SSortRun*, runs being sorted by the sort workers, in the order they are generated
 };
 
+// A run is sorted by a sort worker while the query thread collects the data of the next one. The sorted runs are added
+// to the buffer by the query thread, in the order they are generated.
+typedef struct SSortRun {
+  SSDataBlock*  pBlock;
+  SArray*       pSortInfo;
+  int64_t       elapsed;
+  int32_t       code;
+  bool          done;
+  TdThreadMutex lock;
+  TdThreadCond  cond;
+} SSortRun;
+
+static SSingleWorker sortWorker = {0};
+
 static int32_t msortComparFn(const void* pLeft, const void* pRight, void* param);
+static int32_t msortNormalizedComparFn(const void* pLeft, const void* pRight, void* param);
 
 SSDataBlock* tsortGetSortedDataBlock(const SSortHandle* pSortHandle) {
   return createOneDataBlock(pSortHandle->pDataBlock, false);
@@ -101,6 +121,7 @@ static int32_t sortComparCleanup(SMsortComparParam* cmpParam) {
   for (int32_t i = 0; i < cmpParam->numOfSources; ++i) {
     SSortSource* pSource = cmpParam->pSources[i];
     blockDataDestroy(pSource->src.pBlock);
+    taosMemoryFreeClear(pSource->pKeys);
     taosMemoryFreeClear(pSource);
   }
 
@@ -133,6 +154,7 @@ void tsortClearOrderdSource(SArray* pOrderedSource, int64_t *fetchUs, int64_t *f
       (*pSource)->src.pBlock = NULL;
     }
 
+    taosMemoryFreeClear((*pSource)->pKeys);
     taosMemoryFreeClear(*pSource);
   }
 
@@ -158,6 +180,7 @@ void tsortDestroySortHandle(SSortHandle* pSortHandle) {
   qDebug("all source fetch time: %" PRId64 "us num:%" PRId64 " %s", fetchUs, fetchNum, pSortHandle->idStr);
   
   taosArrayDestroy(pSortHandle->pOrderedSource);
+  taosArrayDestroy(pSortHandle->pRuns);
   taosMemoryFreeClear(pSortHandle);
 }
 
@@ -206,6 +229,8 @@ static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle) {
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
+
+    setBufPageCompressOnDisk(pHandle->pBuf, true);
   }
 
   SArray* pPageIdList = taosArrayInit(4, sizeof(int32_t));
@@ -246,6 +271,153 @@ static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle) {
   return doAddNewExternalMemSource(pHandle->pBuf, pHandle->pOrderedSource, pBlock, &pHandle->sourceId, pPageIdList);
 }
 
+// A normalized key of a row concatenates the group id and the order columns, each column as a null flag followed by the
+// value in big endian with the sign bit flipped, and inverted if descending, so that memcmp of the keys orders the rows
+// the same as msortComparFn. Only the integer types are normalized, for the others the rows are compared column by
+// column.
+static int32_t getNormalizedKeyLen(SSortHandle* pHandle) {
+  if (pHandle->pDataBlock == NULL) {
+    return 0;
+  }
+
+  int32_t len = pHandle->cmpParam.cmpGroupId ? sizeof(uint64_t) : 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pHandle->pSortInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pHandle->pSortInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pHandle->pDataBlock->pDataBlock, pOrder->slotId);
+
+    switch (pCol->info.type) {
+      case TSDB_DATA_TYPE_BOOL:
+      case TSDB_DATA_TYPE_TINYINT:
+      case TSDB_DATA_TYPE_SMALLINT:
+      case TSDB_DATA_TYPE_INT:
+      case TSDB_DATA_TYPE_BIGINT:
+      case TSDB_DATA_TYPE_TIMESTAMP:
+      case TSDB_DATA_TYPE_UTINYINT:
+      case TSDB_DATA_TYPE_USMALLINT:
+      case TSDB_DATA_TYPE_UINT:
+      case TSDB_DATA_TYPE_UBIGINT:
+        len += 1 + pCol->info.bytes;
+        break;
+      default:
+        return 0;
+    }
+  }
+
+  return len;
+}
+
+static void setNormalizedSortKey(SSortHandle* pHandle) {
+  if (pHandle->comparFn != msortComparFn) {
+    return;
+  }
+
+  pHandle->cmpParam.keyLen = getNormalizedKeyLen(pHandle);
+  if (pHandle->cmpParam.keyLen > 0) {
+    pHandle->comparFn = msortNormalizedComparFn;
+  }
+}
+
+static FORCE_INLINE void putKeyValue(char* pKey, uint64_t val, int32_t bytes) {
+  for (int32_t i = bytes - 1; i >= 0; --i) {
+    pKey[i] = (char)(val & 0xFF);
+    val >>= 8;
+  }
+}
+
+static int32_t buildNormalizedKeys(SMsortComparParam* pParam, SSortSource* pSource) {
+  SSDataBlock* pBlock = pSource->src.pBlock;
+  int32_t      keyLen = pParam->keyLen;
+  int32_t      rows = pBlock->info.rows;
+
+  if (pSource->keyCapacity < rows) {
+    char* p = taosMemoryRealloc(pSource->pKeys, (int64_t)rows * keyLen);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pSource->pKeys = p;
+    pSource->keyCapacity = rows;
+  }
+
+  int32_t offset = 0;
+  if (pParam->cmpGroupId) {
+    for (int32_t j = 0; j < rows; ++j) {
+      putKeyValue(pSource->pKeys + (int64_t)j * keyLen, pBlock->info.id.groupId, sizeof(uint64_t));
+    }
+    offset += sizeof(uint64_t);
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pParam->orderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pParam->orderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    int32_t          bytes = pCol->info.bytes;
+    bool             isSigned = !IS_UNSIGNED_NUMERIC_TYPE(pCol->info.type);
+    uint64_t         signBit = 1ULL << (bytes * 8 - 1);
+
+    for (int32_t j = 0; j < rows; ++j) {
+      char* pKey = pSource->pKeys + (int64_t)j * keyLen + offset;
+
+      if (pCol->hasNull && colDataIsNull_s(pCol, j)) {
+        pKey[0] = pOrder->nullFirst ? 0 : 2;
+        memset(pKey + 1, 0, bytes);
+        continue;
+      }
+
+      char*    pData = colDataGetData(pCol, j);
+      uint64_t val = 0;
+      switch (bytes) {
+        case sizeof(uint8_t):
+          val = *(uint8_t*)pData;
+          break;
+        case sizeof(uint16_t):
+          val = *(uint16_t*)pData;
+          break;
+        case sizeof(uint32_t):
+          val = *(uint32_t*)pData;
+          break;
+        default:
+          val = *(uint64_t*)pData;
+          break;
+      }
+
+      if (isSigned) {
+        val ^= signBit;
+      }
+      if (pOrder->order == TSDB_ORDER_DESC) {
+        val = ~val;
+      }
+
+      pKey[0] = 1;
+      putKeyValue(pKey + 1, val, bytes);
+    }
+
+    offset += 1 + bytes;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t loadSortSourcePage(SSortHandle* pHandle, SSortSource* pSource) {
+  int32_t* pPgId = taosArrayGet(pSource->pageIdList, pSource->pageIndex);
+
+  void* pPage = getBufPage(pHandle->pBuf, *pPgId);
+  if (pPage == NULL) {
+    return terrno;
+  }
+
+  int32_t code = blockDataFromBuf(pSource->src.pBlock, pPage);
+  releaseBufPage(pHandle->pBuf, pPage);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (pHandle->cmpParam.keyLen > 0) {
+    code = buildNormalizedKeys(&pHandle->cmpParam, pSource);
+  }
+
+  return code;
+}
+
 static void setCurrentSourceDone(SSortSource* pSource, SSortHandle* pHandle) {
   pSource->src.rowIndex = -1;
   ++pHandle->numOfCompletedSources;
@@ -274,6 +446,8 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
       terrno = code;
       return code;
     }
+
+    setBufPageCompressOnDisk(pHandle->pBuf, true);
   }
 
   if (pHandle->type == SORT_SINGLESOURCE_SORT) {
@@ -286,20 +460,11 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
         continue;
       }
 
-      int32_t* pPgId = taosArrayGet(pSource->pageIdList, pSource->pageIndex);
-
-      void* pPage = getBufPage(pHandle->pBuf, *pPgId);
-      if (NULL == pPage) {
-        return terrno;
-      }
-      
-      code = blockDataFromBuf(pSource->src.pBlock, pPage);
+      code = loadSortSourcePage(pHandle, pSource);
       if (code != TSDB_CODE_SUCCESS) {
         terrno = code;
         return code;
       }
-
-      releaseBufPage(pHandle->pBuf, pPage);
     }
   } else {
     qDebug("start init for the multiway merge sort, %s", pHandle->idStr);
@@ -357,21 +522,14 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
         pSource->src.rowIndex = -1;
         pSource->pageIndex = -1;
         pSource->src.pBlock = blockDataDestroy(pSource->src.pBlock);
+        taosMemoryFreeClear(pSource->pKeys);
+        pSource->keyCapacity = 0;
       } else {
-        int32_t* pPgId = taosArrayGet(pSource->pageIdList, pSource->pageIndex);
-
-        void*   pPage = getBufPage(pHandle->pBuf, *pPgId);
-        if (pPage == NULL) {
-          qError("failed to get buffer, code:%s", tstrerror(terrno));
-          return terrno;
-        }
-
-        int32_t code = blockDataFromBuf(pSource->src.pBlock, pPage);
+        int32_t code = loadSortSourcePage(pHandle, pSource);
         if (code != TSDB_CODE_SUCCESS) {
+          qError("failed to load sort source page, code:%s, %s", tstrerror(code), pHandle->idStr);
           return code;
         }
-
-        releaseBufPage(pHandle->pBuf, pPage);
       }
     } else {
       int64_t st = taosGetTimestampUs();      
@@ -513,12 +671,39 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
   return 0;
 }
 
+static int32_t msortNormalizedComparFn(const void* pLeft, const void* pRight, void* param) {
+  int32_t pLeftIdx = *(int32_t*)pLeft;
+  int32_t pRightIdx = *(int32_t*)pRight;
+
+  SMsortComparParam* pParam = (SMsortComparParam*)param;
+
+  SSortSource* pLeftSource = pParam->pSources[pLeftIdx];
+  SSortSource* pRightSource = pParam->pSources[pRightIdx];
+
+  // this input is exhausted, set the special value to denote this
+  if (pLeftSource->src.rowIndex == -1) {
+    return 1;
+  }
+
+  if (pRightSource->src.rowIndex == -1) {
+    return -1;
+  }
+
+  int32_t keyLen = pParam->keyLen;
+  return memcmp(pLeftSource->pKeys + (int64_t)pLeftSource->src.rowIndex * keyLen,
+                pRightSource->pKeys + (int64_t)pRightSource->src.rowIndex * keyLen, keyLen);
+}
+
 static int32_t doInternalMergeSort(SSortHandle* pHandle) {
   size_t numOfSources = taosArrayGetSize(pHandle->pOrderedSource);
   if (numOfSources == 0) {
     return 0;
   }
 
+  if (pHandle->type == SORT_SINGLESOURCE_SORT) {
+    setNormalizedSortKey(pHandle);
+  }
+
   // Calculate the I/O counts to complete the data sort.
   double sortPass = floorl(log2(numOfSources) / log2(pHandle->numOfPages));
 
@@ -630,6 +815,7 @@ static int32_t doInternalMergeSort(SSortHandle* pHandle) {
     if (pHandle->type == SORT_MULTISOURCE_MERGE) {
       pHandle->type = SORT_SINGLESOURCE_SORT;
       pHandle->comparFn = msortComparFn;
+      setNormalizedSortKey(pHandle);
     }
   }
 
@@ -647,6 +833,140 @@ int32_t getProperSortPageSize(size_t rowSize, uint32_t numOfCols) {
   return pgSize;
 }
 
+static void sortRunWorkerFp(SQueueInfo* pQInfo, void* pItem) {
+  SSortRun* pRun = *(SSortRun**)pItem;
+  taosFreeQitem(pItem);
+
+  int64_t st = taosGetTimestampUs();
+  int32_t code = blockDataSort(pRun->pBlock, pRun->pSortInfo);
+
+  taosThreadMutexLock(&pRun->lock);
+  pRun->code = code;
+  pRun->elapsed = taosGetTimestampUs() - st;
+  pRun->done = true;
+  taosThreadCondSignal(&pRun->cond);
+  taosThreadMutexUnlock(&pRun->lock);
+}
+
+int32_t tsortInitPool() {
+  SSingleWorkerCfg cfg = {.min = TMAX(tsNumOfVnodeQueryThreads, 1),
+                          .max = TMAX(tsNumOfVnodeQueryThreads, 1),
+                          .name = "query-sort",
+                          .fp = sortRunWorkerFp};
+  if (tSingleWorkerInit(&sortWorker, &cfg) != 0) {
+    qError("failed to init sort pool since %s", terrstr());
+    return terrno;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+void tsortCleanupPool() { tSingleWorkerCleanup(&sortWorker); }
+
+static int32_t getNumOfParaRuns() {
+  int32_t numOfParaRuns = tsQueryParallelSort;
+  if (numOfParaRuns <= 1) {
+    return 1;
+  }
+
+  return (sortWorker.queue != NULL) ? numOfParaRuns : 1;
+}
+
+static SSortRun* waitSortRun(SSortHandle* pHandle) {
+  SSortRun* pRun = taosArrayGetP(pHandle->pRuns, 0);
+  taosArrayRemove(pHandle->pRuns, 0);
+
+  taosThreadMutexLock(&pRun->lock);
+  while (!pRun->done) {
+    taosThreadCondWait(&pRun->cond, &pRun->lock);
+  }
+  taosThreadMutexUnlock(&pRun->lock);
+
+  return pRun;
+}
+
+static void destroySortRun(SSortRun* pRun) {
+  blockDataDestroy(pRun->pBlock);
+  taosArrayDestroy(pRun->pSortInfo);
+  taosThreadMutexDestroy(&pRun->lock);
+  taosThreadCondDestroy(&pRun->cond);
+  taosMemoryFree(pRun);
+}
+
+static void discardSortRuns(SSortHandle* pHandle) {
+  while (taosArrayGetSize(pHandle->pRuns) > 0) {
+    destroySortRun(waitSortRun(pHandle));
+  }
+}
+
+// add the oldest sorted runs to the buffer, until no more than maxRuns are left being sorted
+static int32_t flushSortRuns(SSortHandle* pHandle, int32_t maxRuns) {
+  while (taosArrayGetSize(pHandle->pRuns) > maxRuns) {
+    SSortRun* pRun = waitSortRun(pHandle);
+    pHandle->sortElapsed += pRun->elapsed;
+
+    int32_t code = pRun->code;
+    if (code == TSDB_CODE_SUCCESS) {
+      code = doAddToBuf(pRun->pBlock, pHandle);
+    }
+
+    destroySortRun(pRun);
+    if (code != TSDB_CODE_SUCCESS) {
+      discardSortRuns(pHandle);
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// Sort the data collected in the data block as a run, and add it to the buffer. If runs are sorted in parallel, the run
+// is handed over to the sort workers, and the data block is replaced by an empty one to collect the next run.
+static int32_t addSortRun(SSortHandle* pHandle) {
+  if (pHandle->numOfParaRuns <= 1) {
+    int64_t p = taosGetTimestampUs();
+    int32_t code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    pHandle->sortElapsed += taosGetTimestampUs() - p;
+    return doAddToBuf(pHandle->pDataBlock, pHandle);
+  }
+
+  if (pHandle->pRuns == NULL) {
+    pHandle->pRuns = taosArrayInit(pHandle->numOfParaRuns, POINTER_BYTES);
+    if (pHandle->pRuns == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  SSortRun*    pRun = taosMemoryCalloc(1, sizeof(SSortRun));
+  SSDataBlock* pBlock = createOneDataBlock(pHandle->pDataBlock, false);
+  SArray*      pSortInfo = taosArrayDup(pHandle->pSortInfo, NULL);
+  SSortRun**   pItem = taosAllocateQitem(sizeof(SSortRun*), DEF_QITEM, 0);
+  if (pRun == NULL || pBlock == NULL || pSortInfo == NULL || pItem == NULL) {
+    taosMemoryFree(pRun);
+    taosArrayDestroy(pSortInfo);
+    blockDataDestroy(pBlock);
+    taosFreeQitem(pItem);
+    discardSortRuns(pHandle);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pRun->pBlock = pHandle->pDataBlock;
+  // blockDataSort keeps the columns of the block being sorted in the order info, so each run needs its own copy
+  pRun->pSortInfo = pSortInfo;
+  taosThreadMutexInit(&pRun->lock, NULL);
+  taosThreadCondInit(&pRun->cond, NULL);
+  taosArrayPush(pHandle->pRuns, &pRun);
+  pHandle->pDataBlock = pBlock;
+
+  *pItem = pRun;
+  taosWriteQitem(sortWorker.queue, pItem);
+
+  return flushSortRuns(pHandle, pHandle->numOfParaRuns - 1);
+}
+
 static int32_t createInitialSources(SSortHandle* pHandle) {
   size_t sortBufSize = pHandle->numOfPages * pHandle->pageSize;
   int32_t code = 0;
@@ -657,6 +977,7 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
     *pSource = NULL;
 
     tsortClearOrderdSource(pHandle->pOrderedSource, NULL, NULL);
+    pHandle->numOfParaRuns = getNumOfParaRuns();
 
     while (1) {
       SSDataBlock* pBlock = pHandle->fetchfp(source->param);
@@ -680,41 +1001,15 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
 
       code = blockDataMerge(pHandle->pDataBlock, pBlock);
       if (code != TSDB_CODE_SUCCESS) {
-        if (source->param && !source->onlyRef) {
-          taosMemoryFree(source->param);
-        }
-        if (!source->onlyRef && source->src.pBlock) {
-          blockDataDestroy(source->src.pBlock);
-          source->src.pBlock = NULL;
-        }
-        taosMemoryFree(source);
-        return code;
+        break;
       }
 
       size_t size = blockDataGetSize(pHandle->pDataBlock);
       if (size > sortBufSize) {
         // Perform the in-memory sort and then flush data in the buffer into disk.
-        int64_t p = taosGetTimestampUs();
-        code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
-        if (code != 0) {
-          if (source->param && !source->onlyRef) {
-            taosMemoryFree(source->param);
-          }
-          if (!source->onlyRef && source->src.pBlock) {
-            blockDataDestroy(source->src.pBlock);
-            source->src.pBlock = NULL;
-          }
-
-          taosMemoryFree(source);
-          return code;
-        }
-
-        int64_t el = taosGetTimestampUs() - p;
-        pHandle->sortElapsed += el;
-
-        code = doAddToBuf(pHandle->pDataBlock, pHandle);
+        code = addSortRun(pHandle);
         if (code != TSDB_CODE_SUCCESS) {
-          return code;
+          break;
         }
       }
     }
@@ -722,25 +1017,33 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
     if (source->param && !source->onlyRef) {
       taosMemoryFree(source->param);
     }
+    if (!source->onlyRef && source->src.pBlock) {
+      blockDataDestroy(source->src.pBlock);
+      source->src.pBlock = NULL;
+    }
 
     taosMemoryFree(source);
 
+    if (code != TSDB_CODE_SUCCESS) {
+      discardSortRuns(pHandle);
+      return code;
+    }
+
     if (pHandle->pDataBlock != NULL && pHandle->pDataBlock->info.rows > 0) {
       size_t size = blockDataGetSize(pHandle->pDataBlock);
 
-      // Perform the in-memory sort and then flush data in the buffer into disk.
-      int64_t p = taosGetTimestampUs();
+      // All sorted data can fit in memory, external memory sort is not needed. Return to directly
+      if (size <= sortBufSize && pHandle->pBuf == NULL && taosArrayGetSize(pHandle->pRuns) == 0) {
+        int64_t p = taosGetTimestampUs();
 
-      code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
-      if (code != 0) {
-        return code;
-      }
+        code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+        if (code != 0) {
+          return code;
+        }
 
-      int64_t el = taosGetTimestampUs() - p;
-      pHandle->sortElapsed += el;
+        int64_t el = taosGetTimestampUs() - p;
+        pHandle->sortElapsed += el;
 
-      // All sorted data can fit in memory, external memory sort is not needed. Return to directly
-      if (size <= sortBufSize && pHandle->pBuf == NULL) {
         pHandle->cmpParam.numOfSources = 1;
         pHandle->inMemSort = true;
 
@@ -749,9 +1052,15 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
         pHandle->tupleHandle.pBlock = pHandle->pDataBlock;
         return 0;
       } else {
-        code = doAddToBuf(pHandle->pDataBlock, pHandle);
+        code = addSortRun(pHandle);
       }
     }
+
+    if (code == TSDB_CODE_SUCCESS) {
+      code = flushSortRuns(pHandle, 0);
+    } else {
+      discardSortRuns(pHandle);
+    }
   }
 
   return code;
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorInt.h"
+#include "operator.h"
+#include "querynodes.h"
+#include "querytask.h"
+#include "tdatablock.h"
+
+namespace {
+
+const int16_t LEFT_BLOCK_ID = 1;
+const int16_t RIGHT_BLOCK_ID = 2;
+const int16_t OUTPUT_BLOCK_ID = 3;
+
+// two columns: a timestamp increasing by one per row, and an int of the row index modulo valMod
+typedef struct SJoinInputInfo {
+  int32_t      numOfBlocks;
+  int32_t      current;
+  int32_t      rowsPerBlock;
+  int32_t      valMod;
+  int64_t      index;
+  SSDataBlock* pBlock;
+} SJoinInputInfo;
+
+SSDataBlock* getJoinInputBlock(SOperatorInfo* pOperator) {
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(pOperator->info);
+  if (pInfo->current >= pInfo->numOfBlocks) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInfo->pBlock;
+  blockDataCleanup(pBlock);
+
+  SColumnInfoData* pTsCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+  SColumnInfoData* pValCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+  for (int32_t i = 0; i < pInfo->rowsPerBlock; ++i, ++pInfo->index) {
+    int64_t ts = 1620000000000 + pInfo->index;
+    int32_t v = pInfo->index % pInfo->valMod;
+    colDataSetVal(pTsCol, i, reinterpret_cast<const char*>(&ts), false);
+    colDataSetVal(pValCol, i, reinterpret_cast<const char*>(&v), false);
+  }
+
+  pBlock->info.rows = pInfo->rowsPerBlock;
+  pBlock->info.dataLoad = 1;
+  pInfo->current += 1;
+  return pBlock;
+}
+
+void destroyJoinInputInfo(void* param) {
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(param);
+  blockDataDestroy(pInfo->pBlock);
+  taosMemoryFree(pInfo);
+}
+
+SOperatorInfo* createJoinInputOperator(int16_t blockId, int32_t numOfBlocks, int32_t rowsPerBlock, int32_t valMod) {
+  SOperatorInfo*  pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(taosMemoryCalloc(1, sizeof(SJoinInputInfo)));
+
+  pInfo->numOfBlocks = numOfBlocks;
+  pInfo->rowsPerBlock = rowsPerBlock;
+  pInfo->valMod = valMod;
+  pInfo->pBlock = createDataBlock();
+  pInfo->pBlock->info.id.blockId = blockId;
+
+  SColumnInfoData tsCol = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t), 1);
+  blockDataAppendColInfo(pInfo->pBlock, &tsCol);
+  SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 2);
+  blockDataAppendColInfo(pInfo->pBlock, &valCol);
+  blockDataEnsureCapacity(pInfo->pBlock, rowsPerBlock);
+
+  pOperator->name = "joinInputOperator4Test";
+  pOperator->resultDataBlockId = blockId;
+  pOperator->info = pInfo;
+  pOperator->fpSet.getNextFn = getJoinInputBlock;
+  pOperator->fpSet.closeFn = destroyJoinInputInfo;
+  return pOperator;
+}
+
+SNode* createJoinColumn(int16_t blockId, int16_t slotId, uint8_t type) {
+  SColumnNode* pCol = reinterpret_cast<SColumnNode*>(nodesMakeNode(QUERY_NODE_COLUMN));
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = tDataTypes[type].bytes;
+  pCol->dataBlockId = blockId;
+  pCol->slotId = slotId;
+  return reinterpret_cast<SNode*>(pCol);
+}
+
+// select left.ts, left.val, right.val from left join right on left.<keySlot> = right.<keySlot>
+SSortMergeJoinPhysiNode* createJoinNode(ENodeType type, int16_t keySlot, uint8_t keyType) {
+  SSortMergeJoinPhysiNode* pNode = reinterpret_cast<SSortMergeJoinPhysiNode*>(nodesMakeNode(type));
+  pNode->joinType = JOIN_TYPE_INNER;
+  pNode->inputTsOrder = ORDER_ASC;
+
+  SOperatorNode* pCond = reinterpret_cast<SOperatorNode*>(nodesMakeNode(QUERY_NODE_OPERATOR));
+  pCond->opType = OP_TYPE_EQUAL;
+  pCond->pLeft = createJoinColumn(LEFT_BLOCK_ID, keySlot, keyType);
+  pCond->pRight = createJoinColumn(RIGHT_BLOCK_ID, keySlot, keyType);
+  pNode->pMergeCondition = reinterpret_cast<SNode*>(pCond);
+
+  SDataBlockDescNode* pDesc = reinterpret_cast<SDataBlockDescNode*>(nodesMakeNode(QUERY_NODE_DATABLOCK_DESC));
+  pDesc->dataBlockId = OUTPUT_BLOCK_ID;
+
+  const struct {
+    int16_t blockId;
+    int16_t slotId;
+    uint8_t type;
+  } outputs[] = {{LEFT_BLOCK_ID, 0, TSDB_DATA_TYPE_TIMESTAMP},
+                 {LEFT_BLOCK_ID, 1, TSDB_DATA_TYPE_INT},
+                 {RIGHT_BLOCK_ID, 1, TSDB_DATA_TYPE_INT}};
+
+  for (int16_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); ++i) {
+    SSlotDescNode* pSlot = reinterpret_cast<SSlotDescNode*>(nodesMakeNode(QUERY_NODE_SLOT_DESC));
+    pSlot->slotId = i;
+    pSlot->dataType.type = outputs[i].type;
+    pSlot->dataType.bytes = tDataTypes[outputs[i].type].bytes;
+    pSlot->output = true;
+    nodesListMakeAppend(&pDesc->pSlots, reinterpret_cast<SNode*>(pSlot));
+
+    STargetNode* pTarget = reinterpret_cast<STargetNode*>(nodesMakeNode(QUERY_NODE_TARGET));
+    pTarget->dataBlockId = OUTPUT_BLOCK_ID;
+    pTarget->slotId = i;
+    pTarget->pExpr = createJoinColumn(outputs[i].blockId, outputs[i].slotId, outputs[i].type);
+    nodesListMakeAppend(&pNode->pTargets, reinterpret_cast<SNode*>(pTarget));
+  }
+
+  pNode->node.pOutputDataBlockDesc = pDesc;
+  return pNode;
+}
+
+int64_t runJoin(ENodeType type, int16_t keySlot, uint8_t keyType, int32_t numOfLeftBlocks, int32_t numOfRightBlocks,
+                int32_t rightValMod, int64_t* pSum) {
+  const int32_t rowsPerBlock = 4096;
+
+  SExecTaskInfo* pTaskInfo = static_cast<SExecTaskInfo*>(taosMemoryCalloc(1, sizeof(SExecTaskInfo)));
+  pTaskInfo->id.str = taosStrdup("join-test");
+
+  SOperatorInfo* pDownstream[2] = {
+      createJoinInputOperator(LEFT_BLOCK_ID, numOfLeftBlocks, rowsPerBlock, 1000),
+      createJoinInputOperator(RIGHT_BLOCK_ID, numOfRightBlocks, rowsPerBlock, rightValMod)};
+
+  SSortMergeJoinPhysiNode* pNode = createJoinNode(type, keySlot, keyType);
+  SOperatorInfo*           pJoin = NULL;
+  if (type == QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN) {
+    pJoin = createMergeJoinOperatorInfo(pDownstream, 2, pNode, pTaskInfo);
+  } else {
+    pJoin = createHashJoinOperatorInfo(pDownstream, 2, pNode, pTaskInfo);
+  }
+  EXPECT_NE(pJoin, nullptr);
+
+  int64_t rows = 0;
+  *pSum = 0;
+  while (1) {
+    SSDataBlock* pRes = pJoin->fpSet.getNextFn(pJoin);
+    if (pRes == NULL) {
+      break;
+    }
+
+    SColumnInfoData* pLeftVal = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+    SColumnInfoData* pRightVal = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 2));
+    for (int32_t i = 0; i < pRes->info.rows; ++i) {
+      *pSum += *(int32_t*)colDataGetData(pLeftVal, i) + *(int32_t*)colDataGetData(pRightVal, i);
+    }
+    rows += pRes->info.rows;
+  }
+
+  destroyOperator(pJoin);
+  nodesDestroyNode(reinterpret_cast<SNode*>(pNode));
+  taosMemoryFree(pTaskInfo->id.str);
+  taosMemoryFree(pTaskInfo);
+  return rows;
+}
+
+}  // namespace
+
+TEST(joinTest, hash_vs_merge_join_on_ts) {
+  int64_t mergeSum = 0;
+  int64_t hashSum = 0;
+
+  int64_t mergeRows = runJoin(QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN, 0, TSDB_DATA_TYPE_TIMESTAMP, 256, 64, 1000, &mergeSum);
+  int64_t hashRows = runJoin(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, 0, TSDB_DATA_TYPE_TIMESTAMP, 256, 64, 1000, &hashSum);
+
+  ASSERT_EQ(mergeRows, 64 * 4096);
+  ASSERT_EQ(hashRows, mergeRows);
+  ASSERT_EQ(hashSum, mergeSum);
+}
+
+TEST(joinTest, hash_join_on_value) {
+  int64_t sum = 0;
+
+  // the values of the left side are below 1000, each matches one of the distinct values of the right side
+  int64_t rows = runJoin(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, 1, TSDB_DATA_TYPE_INT, 64, 1, 4096, &sum);
+  ASSERT_EQ(rows, 64 * 4096);
+
+  int64_t expect = 0;
+  for (int64_t i = 0; i < 64 * 4096; ++i) {
+    expect += 2 * (i % 1000);
+  }
+  ASSERT_EQ(sum, expect);
+}
+
+TEST(joinTest, hash_join_spill_build_side) {
+  int64_t sum = 0;
+
+  // the build side of about 30MB does not fit in the in-memory pages of the buffer
+  int64_t rows = runJoin(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, 0, TSDB_DATA_TYPE_TIMESTAMP, 256, 256, 1000, &sum);
+  ASSERT_EQ(rows, 256 * 4096);
+}
+
+// Not run by default, the elapsed times are recorded as properties of the test in the xml output:
+// executorTest --gtest_also_run_disabled_tests --gtest_filter=joinTest.DISABLED_* --gtest_output=xml
+TEST(joinTest, DISABLED_hash_vs_merge_join_bench) {
+  int64_t sum = 0;
+
+  int64_t st = taosGetTimestampUs();
+  runJoin(QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN, 0, TSDB_DATA_TYPE_TIMESTAMP, 1024, 256, 1000, &sum);
+  ::testing::Test::RecordProperty("mergeJoinUs", std::to_string(taosGetTimestampUs() - st));
+
+  st = taosGetTimestampUs();
+  runJoin(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, 0, TSDB_DATA_TYPE_TIMESTAMP, 1024, 256, 1000, &sum);
+  ::testing::Test::RecordProperty("hashJoinUs", std::to_string(taosGetTimestampUs() - st));
+
+  st = taosGetTimestampUs();
+  runJoin(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, 1, TSDB_DATA_TYPE_INT, 1024, 1, 4096, &sum);
+  ::testing::Test::RecordProperty("hashJoinOnValueUs", std::to_string(taosGetTimestampUs() - st));
+}
+
+#pragma GCC diagnostic pop
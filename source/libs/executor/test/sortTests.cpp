@@ -393,4 +393,213 @@ TEST(testCase, ordered_merge_sort_Test) {
 
 #endif
 
+namespace {
+typedef struct {
+  int32_t      numOfBlocks;
+  int32_t      rows;
+  SSDataBlock* pBlock;
+} _randInfo;
+
+// blocks of random bigint values with a few nulls, the block is reused since the sort does not take it over
+SSDataBlock* getRandBigintBlock(void* param) {
+  _randInfo* pInfo = (_randInfo*)param;
+  if (--pInfo->numOfBlocks < 0) {
+    return NULL;
+  }
+
+  if (pInfo->pBlock == NULL) {
+    pInfo->pBlock = createDataBlock();
+    SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+    blockDataAppendColInfo(pInfo->pBlock, &colInfo);
+    blockDataEnsureCapacity(pInfo->pBlock, pInfo->rows);
+  }
+
+  blockDataCleanup(pInfo->pBlock);
+  SColumnInfoData* pColInfo = static_cast<SColumnInfoData*>(taosArrayGet(pInfo->pBlock->pDataBlock, 0));
+  for (int32_t i = 0; i < pInfo->rows; ++i) {
+    int64_t v = ((int64_t)taosRand() << 32) - taosRand();
+    colDataSetVal(pColInfo, i, reinterpret_cast<const char*>(&v), (i % 1000) == 0);
+  }
+
+  pInfo->pBlock->info.rows = pInfo->rows;
+  return pInfo->pBlock;
+}
+}  // namespace
+
+TEST(testCase, parallel_external_sort_Test) {
+  osDefaultInit();
+  osUpdate();
+
+  int32_t parallelSort = tsQueryParallelSort;
+  tsQueryParallelSort = 4;
+  ASSERT_EQ(tsortInitPool(), TSDB_CODE_SUCCESS);
+
+  SBlockOrderInfo oi = {0};
+  oi.order = TSDB_ORDER_DESC;
+  oi.slotId = 0;
+  oi.nullFirst = true;
+  SArray* orderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  taosArrayPush(orderInfo, &oi);
+
+  // about 32mb of data, spilled into several runs of the default sort buffer
+  _randInfo info = {0};
+  info.numOfBlocks = 1000;
+  info.rows = 4096;
+
+  SSortHandle* phandle = tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, 0, 0, NULL, "test_parallel_sort");
+  tsortSetFetchRawDataFp(phandle, getRandBigintBlock, NULL, NULL);
+
+  SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+  ps->param = &info;
+  ps->onlyRef = true;
+  tsortAddSource(phandle, ps);
+
+  ASSERT_EQ(tsortOpen(phandle), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(tsortGetSortExecInfo(phandle).sortMethod, SORT_SPILLED_MERGE_SORT_T);
+
+  int64_t numOfRows = 0;
+  int64_t numOfNulls = 0;
+  int64_t prev = INT64_MAX;
+  while (1) {
+    STupleHandle* pTupleHandle = tsortNextTuple(phandle);
+    if (pTupleHandle == NULL) {
+      break;
+    }
+
+    numOfRows += 1;
+    if (tsortIsNullVal(pTupleHandle, 0)) {
+      ASSERT_EQ(numOfNulls++, numOfRows - 1);
+      continue;
+    }
+
+    int64_t v = *(int64_t*)tsortGetValue(pTupleHandle, 0);
+    ASSERT_LE(v, prev);
+    prev = v;
+  }
+
+  ASSERT_EQ(numOfRows, 1000 * 4096);
+  ASSERT_EQ(numOfNulls, 1000 * 5);
+
+  tsortDestroySortHandle(phandle);
+  blockDataDestroy(info.pBlock);
+  taosArrayDestroy(orderInfo);
+  tsortCleanupPool();
+  tsQueryParallelSort = parallelSort;
+}
+
+namespace {
+typedef struct {
+  int32_t      numOfBlocks;
+  int32_t      maxRows;
+  int64_t      totalRows;
+  SSDataBlock* pBlock;
+} _multiKeyInfo;
+
+int64_t multiKeyChecksum(int32_t k1, int64_t k2) { return ((int64_t)k1 * 1000003) ^ k2; }
+
+// blocks of varying size with two sort keys, a small range int and a random bigint, and a checksum of both keys
+SSDataBlock* getMultiKeyBlock(void* param) {
+  _multiKeyInfo* pInfo = (_multiKeyInfo*)param;
+  if (--pInfo->numOfBlocks < 0) {
+    return NULL;
+  }
+
+  if (pInfo->pBlock == NULL) {
+    pInfo->pBlock = createDataBlock();
+    SColumnInfoData k1 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+    SColumnInfoData k2 = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+    SColumnInfoData sum = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 3);
+    blockDataAppendColInfo(pInfo->pBlock, &k1);
+    blockDataAppendColInfo(pInfo->pBlock, &k2);
+    blockDataAppendColInfo(pInfo->pBlock, &sum);
+    blockDataEnsureCapacity(pInfo->pBlock, pInfo->maxRows);
+  }
+
+  blockDataCleanup(pInfo->pBlock);
+  int32_t          rows = pInfo->maxRows / 2 + taosRand() % (pInfo->maxRows / 2);
+  SColumnInfoData* pK1 = static_cast<SColumnInfoData*>(taosArrayGet(pInfo->pBlock->pDataBlock, 0));
+  SColumnInfoData* pK2 = static_cast<SColumnInfoData*>(taosArrayGet(pInfo->pBlock->pDataBlock, 1));
+  SColumnInfoData* pSum = static_cast<SColumnInfoData*>(taosArrayGet(pInfo->pBlock->pDataBlock, 2));
+  for (int32_t i = 0; i < rows; ++i) {
+    int32_t k1 = taosRand() % 16;
+    int64_t k2 = ((int64_t)taosRand() << 32) - taosRand();
+    int64_t sum = multiKeyChecksum(k1, k2);
+    colDataSetVal(pK1, i, reinterpret_cast<const char*>(&k1), false);
+    colDataSetVal(pK2, i, reinterpret_cast<const char*>(&k2), false);
+    colDataSetVal(pSum, i, reinterpret_cast<const char*>(&sum), false);
+  }
+
+  pInfo->pBlock->info.rows = rows;
+  pInfo->totalRows += rows;
+  return pInfo->pBlock;
+}
+}  // namespace
+
+// many runs of different sizes sorted at the same time on two keys, the rows must come out in order and intact
+TEST(testCase, parallel_multi_run_sort_Test) {
+  osDefaultInit();
+  osUpdate();
+
+  int32_t parallelSort = tsQueryParallelSort;
+  tsQueryParallelSort = 8;
+  ASSERT_EQ(tsortInitPool(), TSDB_CODE_SUCCESS);
+
+  SBlockOrderInfo oi[2] = {0};
+  oi[0].order = TSDB_ORDER_ASC;
+  oi[0].slotId = 0;
+  oi[1].order = TSDB_ORDER_DESC;
+  oi[1].slotId = 1;
+  SArray* orderInfo = taosArrayInit(2, sizeof(SBlockOrderInfo));
+  taosArrayPush(orderInfo, &oi[0]);
+  taosArrayPush(orderInfo, &oi[1]);
+
+  _multiKeyInfo info = {0};
+  info.numOfBlocks = 400;
+  info.maxRows = 8192;
+
+  // a small sort buffer, so that every few blocks make a run
+  SSortHandle* phandle =
+      tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, 64 * 1024, 32, NULL, "test_parallel_multi_run_sort");
+  tsortSetFetchRawDataFp(phandle, getMultiKeyBlock, NULL, NULL);
+
+  SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+  ps->param = &info;
+  ps->onlyRef = true;
+  tsortAddSource(phandle, ps);
+
+  ASSERT_EQ(tsortOpen(phandle), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(tsortGetSortExecInfo(phandle).sortMethod, SORT_SPILLED_MERGE_SORT_T);
+
+  int64_t numOfRows = 0;
+  int32_t prevK1 = INT32_MIN;
+  int64_t prevK2 = INT64_MAX;
+  while (1) {
+    STupleHandle* pTupleHandle = tsortNextTuple(phandle);
+    if (pTupleHandle == NULL) {
+      break;
+    }
+
+    numOfRows += 1;
+    int32_t k1 = *(int32_t*)tsortGetValue(pTupleHandle, 0);
+    int64_t k2 = *(int64_t*)tsortGetValue(pTupleHandle, 1);
+    int64_t sum = *(int64_t*)tsortGetValue(pTupleHandle, 2);
+    ASSERT_EQ(sum, multiKeyChecksum(k1, k2));
+    ASSERT_GE(k1, prevK1);
+    if (k1 == prevK1) {
+      ASSERT_LE(k2, prevK2);
+    }
+
+    prevK1 = k1;
+    prevK2 = k2;
+  }
+
+  ASSERT_EQ(numOfRows, info.totalRows);
+
+  tsortDestroySortHandle(phandle);
+  blockDataDestroy(info.pBlock);
+  taosArrayDestroy(orderInfo);
+  tsortCleanupPool();
+  tsQueryParallelSort = parallelSort;
+}
+
 #pragma GCC diagnostic pop
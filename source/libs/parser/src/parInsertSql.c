@@ -18,6 +18,7 @@
 #include "scalar.h"
 #include "tglobal.h"
 #include "ttime.h"
+#include "tworker.h"
 
 #define NEXT_TOKEN_WITH_PREV(pSql, token)           \
   do {                                              \
@@ -1516,50 +1517,437 @@ static int32_t parseValuesClause(SInsertParseContext* pCxt, SVnodeModifyOpStmt*
   return code;
 }
 
-static int32_t parseCsvFile(SInsertParseContext* pCxt, SVnodeModifyOpStmt* pStmt, STableDataCxt* pTableCxt,
-                            int32_t* pNumOfRows) {
+// The csv file of INSERT ... FILE is read in batches of whole lines. With csvParseThreads > 0, the csv-parse workers read
+// and parse the next batch while the current one is inserted, and each batch is split into chunks of consecutive lines
+// parsed at the same time, each into rows of its own. The rows of the chunks are moved into the table in chunk order.
+// The workers are created by taos_init if csvParseThreads is set then. After maxMemUsedByInsert megabytes of the file
+// the rows are submitted, and the parse goes on from the reader kept in the statement.
+#define CSV_BATCH_SIZE     (16 * 1024 * 1024)
+#define CSV_CHUNK_MIN_SIZE (256 * 1024)
+#define CSV_ERROR_MSG_SIZE 512
+
+typedef struct SCsvReader SCsvReader;
+typedef struct SCsvBatch  SCsvBatch;
+
+typedef struct {
+  SCsvBatch*          pBatch;
+  char*               pLine;
+  char*               pEnd;
+  bool                firstLine;  // the chunk starts with the first line of the file, which may be a header
+  STableDataCxt       tableCxt;   // only pValues and pData are owned by the chunk
+  SSubmitTbData       data;
+  int32_t             numOfRows;
+  int32_t             code;
+  SInsertParseContext cxt;
+  char                msg[CSV_ERROR_MSG_SIZE];
+} SCsvChunk;
+
+struct SCsvBatch {
+  SCsvReader* pReader;
+  int64_t     offset;  // offset of the batch in the file
+  char*       buf;
+  int64_t     len;  // length of the whole lines in buf
+  bool        eof;
+  bool        done;
+  int32_t     code;
+  SCsvChunk*  chunks;
+  int32_t     numOfChunks;
+  int32_t     numOfRunning;
+};
+
+struct SCsvReader {
+  TdFilePtr     fp;
+  SParseContext comCxt;
+  STableDataCxt tableCxt;  // meta, schema and bound columns all batches are parsed with
+  int64_t       offset;    // offset in the file of the next batch
+  SCsvBatch*    pAhead;    // batch being read and parsed in background
+  TdThreadMutex lock;
+  TdThreadCond  cond;
+};
+
+typedef struct {
+  SCsvBatch* pBatch;
+  int32_t    chunk;  // -1 means reading and splitting the batch
+} SCsvParseItem;
+
+static SSingleWorker csvParseWorker = {0};
+
+static void csvParseChunk(SCsvChunk* pChunk) {
+  char*   pLine = pChunk->pLine;
+  bool    firstLine = pChunk->firstLine;
   int32_t code = TSDB_CODE_SUCCESS;
-  (*pNumOfRows) = 0;
-  char*   pLine = NULL;
-  int64_t readLen = 0;
-  bool    firstLine = (pStmt->fileProcessing == false);
-  pStmt->fileProcessing = false;
-  while (TSDB_CODE_SUCCESS == code && (readLen = taosGetLineFile(pStmt->fp, &pLine)) != -1) {
-    if (('\r' == pLine[readLen - 1]) || ('\n' == pLine[readLen - 1])) {
-      pLine[--readLen] = '\0';
+
+  while (TSDB_CODE_SUCCESS == code && pLine < pChunk->pEnd) {
+    char* pLineEnd = memchr(pLine, '\n', pChunk->pEnd - pLine);
+    if (NULL == pLineEnd) {
+      pLineEnd = pChunk->pEnd;
     }
+    *pLineEnd = '\0';
 
-    if (readLen == 0) {
-      firstLine = false;
-      continue;
+    int64_t len = pLineEnd - pLine;
+    if (len > 0 && '\r' == pLine[len - 1]) {
+      pLine[--len] = '\0';
     }
 
-    bool gotRow = false;
-    if (TSDB_CODE_SUCCESS == code) {
-      SToken token;
-      strtolower(pLine, pLine);
-      const char* pRow = pLine;
+    if (len > 0) {
+      SToken      token;
+      bool        gotRow = false;
+      const char* pRow = strtolower(pLine, pLine);
 
-      code = parseOneRow(pCxt, (const char**)&pRow, pTableCxt, &gotRow, &token);
+      code = parseOneRow(&pChunk->cxt, &pRow, &pChunk->tableCxt, &gotRow, &token);
       if (code && firstLine) {
-        firstLine = false;
-        code = 0;
-        continue;
+        code = TSDB_CODE_SUCCESS;
+      } else if (TSDB_CODE_SUCCESS == code && gotRow) {
+        pChunk->numOfRows++;
       }
     }
 
-    if (TSDB_CODE_SUCCESS == code && gotRow) {
-      (*pNumOfRows)++;
+    firstLine = false;
+    pLine = pLineEnd + 1;
+  }
+
+  pChunk->code = code;
+}
+
+static int32_t csvInitChunk(SCsvReader* pReader, SCsvChunk* pChunk) {
+  pChunk->cxt.pComCxt = &pReader->comCxt;
+  pChunk->cxt.msg.buf = pChunk->msg;
+  pChunk->cxt.msg.len = CSV_ERROR_MSG_SIZE;
+
+  pChunk->tableCxt = pReader->tableCxt;
+  pChunk->tableCxt.pData = &pChunk->data;
+  pChunk->tableCxt.pValues = taosArrayDup(pReader->tableCxt.pValues, NULL);
+  pChunk->data.aRowP = taosArrayInit(1024, POINTER_BYTES);
+  if (NULL == pChunk->tableCxt.pValues || NULL == pChunk->data.aRowP) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static void csvDestroyBatch(SCsvBatch* pBatch) {
+  if (NULL == pBatch) {
+    return;
+  }
+
+  for (int32_t i = 0; i < pBatch->numOfChunks; ++i) {
+    SCsvChunk* pChunk = pBatch->chunks + i;
+    taosArrayDestroy(pChunk->tableCxt.pValues);
+    taosArrayDestroyP(pChunk->data.aRowP, (FDelete)tRowDestroy);
+  }
+  taosMemoryFree(pBatch->chunks);
+  taosMemoryFree(pBatch->buf);
+  taosMemoryFree(pBatch);
+}
+
+// read the whole lines from the offset of the batch, a line longer than the batch makes it grow
+static int32_t csvReadBatch(SCsvBatch* pBatch) {
+  int64_t size = TMIN(CSV_BATCH_SIZE, (int64_t)tsMaxMemUsedByInsert * 1024 * 1024);
+  int64_t readLen = 0;
+
+  while (1) {
+    char* buf = taosMemoryRealloc(pBatch->buf, size + 1);
+    if (NULL == buf) {
+      return TSDB_CODE_OUT_OF_MEMORY;
     }
+    pBatch->buf = buf;
 
-    if (TSDB_CODE_SUCCESS == code && (*pNumOfRows) > tsMaxMemUsedByInsert * 1024 * 1024) {
-      pStmt->fileProcessing = true;
+    int64_t ret = taosPReadFile(pBatch->pReader->fp, buf + readLen, size - readLen, pBatch->offset + readLen);
+    if (ret < 0) {
+      return TAOS_SYSTEM_ERROR(errno);
+    }
+    readLen += ret;
+
+    if (readLen < size) {
+      pBatch->eof = true;
+      pBatch->len = readLen;
+      return TSDB_CODE_SUCCESS;
+    }
+
+    for (int64_t i = readLen - 1; i >= 0; --i) {
+      if ('\n' == buf[i]) {
+        pBatch->len = i + 1;
+        return TSDB_CODE_SUCCESS;
+      }
+    }
+    size *= 2;
+  }
+}
+
+// split the batch at line ends into chunks of about the same size
+static int32_t csvSplitBatch(SCsvBatch* pBatch, int32_t numOfChunks) {
+  SCsvReader* pReader = pBatch->pReader;
+
+  pBatch->chunks = taosMemoryCalloc(numOfChunks, sizeof(SCsvChunk));
+  if (NULL == pBatch->chunks) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pBatch->numOfChunks = numOfChunks;
+
+  char* pEnd = pBatch->buf + pBatch->len;
+  char* pLine = pBatch->buf;
+  for (int32_t i = 0; i < numOfChunks; ++i) {
+    SCsvChunk* pChunk = pBatch->chunks + i;
+    int32_t    code = csvInitChunk(pReader, pChunk);
+    if (TSDB_CODE_SUCCESS != code) {
+      return code;
+    }
+
+    pChunk->pBatch = pBatch;
+    pChunk->pLine = pLine;
+    pChunk->firstLine = (0 == pBatch->offset && 0 == i);
+    if (i < numOfChunks - 1) {
+      char* pSplit = TMAX(pBatch->buf + pBatch->len * (i + 1) / numOfChunks, pLine + 1);
+      char* pLineEnd = (pSplit <= pEnd) ? memchr(pSplit - 1, '\n', pEnd - pSplit + 1) : NULL;
+      pLine = (NULL != pLineEnd) ? pLineEnd + 1 : pEnd;
+    } else {
+      pLine = pEnd;
+    }
+    pChunk->pEnd = pLine;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t csvGetNumOfChunks(int64_t len) {
+  int32_t numOfChunks = TMIN(tsCsvParseThreads, len / CSV_CHUNK_MIN_SIZE);
+  return TMAX(numOfChunks, 1);
+}
+
+static void csvFinishBatchPart(SCsvBatch* pBatch) {
+  SCsvReader* pReader = pBatch->pReader;
+  taosThreadMutexLock(&pReader->lock);
+  if (--pBatch->numOfRunning == 0) {
+    pBatch->done = true;
+    taosThreadCondBroadcast(&pReader->cond);
+  }
+  taosThreadMutexUnlock(&pReader->lock);
+}
+
+static void csvDispatch(SCsvBatch* pBatch, int32_t chunk) {
+  SCsvParseItem* pItem = taosAllocateQitem(sizeof(SCsvParseItem), DEF_QITEM, 0);
+  if (NULL == pItem) {
+    if (chunk < 0) {
+      pBatch->code = TSDB_CODE_OUT_OF_MEMORY;
+    } else {
+      pBatch->chunks[chunk].code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+    csvFinishBatchPart(pBatch);
+    return;
+  }
+
+  pItem->pBatch = pBatch;
+  pItem->chunk = chunk;
+  taosWriteQitem(csvParseWorker.queue, pItem);
+}
+
+// read the batch, then parse its first chunk on this thread and the others by the workers
+static void csvReadAndParseBatch(SCsvBatch* pBatch, bool async) {
+  pBatch->code = csvReadBatch(pBatch);
+  if (TSDB_CODE_SUCCESS == pBatch->code && pBatch->len > 0) {
+    pBatch->code = csvSplitBatch(pBatch, async ? csvGetNumOfChunks(pBatch->len) : 1);
+  }
+  if (TSDB_CODE_SUCCESS != pBatch->code || 0 == pBatch->len) {
+    return;
+  }
+
+  if (async) {
+    taosThreadMutexLock(&pBatch->pReader->lock);
+    pBatch->numOfRunning += pBatch->numOfChunks - 1;
+    taosThreadMutexUnlock(&pBatch->pReader->lock);
+    for (int32_t i = 1; i < pBatch->numOfChunks; ++i) {
+      csvDispatch(pBatch, i);
+    }
+  }
+
+  csvParseChunk(pBatch->chunks);
+}
+
+static void csvParseWorkerFp(SQueueInfo* pInfo, void* pItem) {
+  SCsvBatch* pBatch = ((SCsvParseItem*)pItem)->pBatch;
+  int32_t    chunk = ((SCsvParseItem*)pItem)->chunk;
+  taosFreeQitem(pItem);
+
+  if (chunk < 0) {
+    csvReadAndParseBatch(pBatch, true);
+  } else {
+    csvParseChunk(pBatch->chunks + chunk);
+  }
+  csvFinishBatchPart(pBatch);
+}
+
+int32_t qInitCsvParsePool() {
+  if (tsCsvParseThreads <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SSingleWorkerCfg cfg = {
+      .min = TMAX((int32_t)tsNumOfCores, 1),
+      .max = TMAX((int32_t)tsNumOfCores, 1),
+      .name = "csv-parse",
+      .fp = csvParseWorkerFp,
+  };
+  if (tSingleWorkerInit(&csvParseWorker, &cfg) != 0) {
+    parserError("failed to init csv parse pool since %s", terrstr());
+    return terrno;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+void qCleanupCsvParsePool() { tSingleWorkerCleanup(&csvParseWorker); }
+
+static bool csvParseInBackground() { return tsCsvParseThreads > 0 && NULL != csvParseWorker.queue; }
+
+// start reading and parsing the next batch in background, or do it now without parse threads
+static SCsvBatch* csvStartBatch(SCsvReader* pReader) {
+  SCsvBatch* pBatch = taosMemoryCalloc(1, sizeof(SCsvBatch));
+  if (NULL == pBatch) {
+    return NULL;
+  }
+  pBatch->pReader = pReader;
+  pBatch->offset = pReader->offset;
+
+  if (!csvParseInBackground()) {
+    csvReadAndParseBatch(pBatch, false);
+    pBatch->done = true;
+    return pBatch;
+  }
+
+  pBatch->numOfRunning = 1;
+  csvDispatch(pBatch, -1);
+  return pBatch;
+}
+
+static void csvWaitBatch(SCsvReader* pReader, SCsvBatch* pBatch) {
+  taosThreadMutexLock(&pReader->lock);
+  while (!pBatch->done) {
+    taosThreadCondWait(&pReader->cond, &pReader->lock);
+  }
+  taosThreadMutexUnlock(&pReader->lock);
+}
+
+static void csvDestroyReader(void* p) {
+  SCsvReader* pReader = p;
+  if (NULL == pReader) {
+    return;
+  }
+
+  if (NULL != pReader->pAhead) {
+    csvWaitBatch(pReader, pReader->pAhead);
+    csvDestroyBatch(pReader->pAhead);
+  }
+  taosMemoryFree(pReader->tableCxt.pMeta);
+  taosMemoryFree(pReader->tableCxt.pSchema);
+  insDestroyBoundColInfo(&pReader->tableCxt.boundColsInfo);
+  taosArrayDestroy(pReader->tableCxt.pValues);
+  taosThreadMutexDestroy(&pReader->lock);
+  taosThreadCondDestroy(&pReader->cond);
+  taosMemoryFree(pReader);
+}
+
+static int32_t csvCreateReader(SInsertParseContext* pCxt, SVnodeModifyOpStmt* pStmt, STableDataCxt* pTableCxt,
+                               SCsvReader** ppReader) {
+  SCsvReader* pReader = taosMemoryCalloc(1, sizeof(SCsvReader));
+  if (NULL == pReader) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosThreadMutexInit(&pReader->lock, NULL);
+  taosThreadCondInit(&pReader->cond, NULL);
+  pReader->fp = pStmt->fp;
+  pReader->comCxt = *pCxt->pComCxt;
+
+  STableDataCxt* pCxtTmpl = &pReader->tableCxt;
+  STableMeta*    pMeta = pTableCxt->pMeta;
+  SBoundColInfo* pCols = &pTableCxt->boundColsInfo;
+  pCxtTmpl->pMeta = tableMetaDup(pMeta);
+  pCxtTmpl->pSchema = tBuildTSchema(getTableColumnSchema(pMeta), pMeta->tableInfo.numOfColumns, pMeta->sversion);
+  pCxtTmpl->boundColsInfo = *pCols;
+  pCxtTmpl->boundColsInfo.pColIndex = taosMemoryMalloc(sizeof(int16_t) * pCols->numOfCols);
+  pCxtTmpl->pValues = taosArrayDup(pTableCxt->pValues, NULL);
+  pCxtTmpl->ordered = true;
+  if (NULL == pCxtTmpl->pMeta || NULL == pCxtTmpl->pSchema || NULL == pCxtTmpl->boundColsInfo.pColIndex ||
+      NULL == pCxtTmpl->pValues) {
+    csvDestroyReader(pReader);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  memcpy(pCxtTmpl->boundColsInfo.pColIndex, pCols->pColIndex, sizeof(int16_t) * pCols->numOfCols);
+
+  *ppReader = pReader;
+  return TSDB_CODE_SUCCESS;
+}
+
+// move the rows of the batch into the table, or report the error of the first failed line
+static int32_t csvMergeBatch(SInsertParseContext* pCxt, SCsvBatch* pBatch, STableDataCxt* pTableCxt,
+                             int32_t* pNumOfRows) {
+  if (TSDB_CODE_SUCCESS != pBatch->code) {
+    return pBatch->code;
+  }
+
+  for (int32_t i = 0; i < pBatch->numOfChunks; ++i) {
+    SCsvChunk* pChunk = pBatch->chunks + i;
+    if (TSDB_CODE_SUCCESS != pChunk->code) {
+      tstrncpy(pCxt->msg.buf, pChunk->msg, pCxt->msg.len);
+      return pChunk->code;
+    }
+  }
+
+  for (int32_t i = 0; i < pBatch->numOfChunks; ++i) {
+    SCsvChunk* pChunk = pBatch->chunks + i;
+    int32_t    numOfRows = taosArrayGetSize(pChunk->data.aRowP);
+    if (NULL == taosArrayAddBatch(pTableCxt->pData->aRowP, TARRAY_DATA(pChunk->data.aRowP), numOfRows)) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    for (int32_t j = 0; j < numOfRows; ++j) {
+      insCheckTableDataOrder(pTableCxt, TD_ROW_KEY(*(SRow**)taosArrayGet(pChunk->data.aRowP, j)));
+    }
+    taosArrayClear(pChunk->data.aRowP);
+    (*pNumOfRows) += pChunk->numOfRows;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t parseCsvFile(SInsertParseContext* pCxt, SVnodeModifyOpStmt* pStmt, STableDataCxt* pTableCxt,
+                            int32_t* pNumOfRows) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  (*pNumOfRows) = 0;
+  pStmt->fileProcessing = false;
+
+  if (NULL == pStmt->pCsvReader) {
+    code = csvCreateReader(pCxt, pStmt, pTableCxt, (SCsvReader**)&pStmt->pCsvReader);
+  }
+
+  SCsvReader* pReader = pStmt->pCsvReader;
+  int64_t     readLen = 0;
+  while (TSDB_CODE_SUCCESS == code) {
+    SCsvBatch* pBatch = pReader->pAhead;
+    pReader->pAhead = NULL;
+    if (NULL == pBatch && NULL == (pBatch = csvStartBatch(pReader))) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
       break;
     }
+    csvWaitBatch(pReader, pBatch);
 
-    firstLine = false;
+    bool eof = pBatch->eof;
+    if (TSDB_CODE_SUCCESS == pBatch->code) {
+      pReader->offset += pBatch->len;
+      readLen += pBatch->len;
+      // without parse threads the next batch would be read here and only wait for the submit of this one
+      if (!eof && csvParseInBackground() && NULL == (pReader->pAhead = csvStartBatch(pReader))) {
+        pBatch->code = TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+
+    code = csvMergeBatch(pCxt, pBatch, pTableCxt, pNumOfRows);
+    csvDestroyBatch(pBatch);
+
+    if (TSDB_CODE_SUCCESS != code || eof) {
+      break;
+    }
+    if (readLen >= (int64_t)tsMaxMemUsedByInsert * 1024 * 1024) {
+      pStmt->fileProcessing = true;
+      break;
+    }
   }
-  taosMemoryFree(pLine);
 
   if (TSDB_CODE_SUCCESS == code && 0 == (*pNumOfRows) &&
       (!TSDB_QUERY_HAS_TYPE(pStmt->insertType, TSDB_QUERY_TYPE_STMT_INSERT)) && !pStmt->fileProcessing) {
@@ -1576,6 +1964,8 @@ static int32_t parseDataFromFileImpl(SInsertParseContext* pCxt, SVnodeModifyOpSt
     pStmt->totalTbNum += 1;
     TSDB_QUERY_SET_TYPE(pStmt->insertType, TSDB_QUERY_TYPE_FILE_INSERT);
     if (!pStmt->fileProcessing) {
+      csvDestroyReader(pStmt->pCsvReader);
+      pStmt->pCsvReader = NULL;
       taosCloseFile(&pStmt->fp);
     } else {
       parserDebug("0x%" PRIx64 " insert from csv. File is too large, do it in batches.", pCxt->pComCxt->requestId);
@@ -1592,7 +1982,7 @@ static int32_t parseDataFromFile(SInsertParseContext* pCxt, SVnodeModifyOpStmt*
   } else {
     strncpy(filePathStr, pFilePath->z, pFilePath->n);
   }
-  pStmt->fp = taosOpenFile(filePathStr, TD_FILE_READ | TD_FILE_STREAM);
+  pStmt->fp = taosOpenFile(filePathStr, TD_FILE_READ);
   if (NULL == pStmt->fp) {
     return TAOS_SYSTEM_ERROR(errno);
   }
@@ -1779,6 +2169,7 @@ static int32_t createVnodeModifOpStmt(SInsertParseContext* pCxt, bool reentry, S
   pStmt->pSql = pCxt->pComCxt->pSql;
   pStmt->freeHashFunc = insDestroyTableDataCxtHashMap;
   pStmt->freeArrayFunc = insDestroyVgroupDataCxtList;
+  pStmt->freeCsvReaderFunc = csvDestroyReader;
 
   if (!reentry) {
     pStmt->pVgroupsHashObj = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, HASH_NO_LOCK);
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "parInt.h"
+#include "parTestUtil.h"
+#include "parser.h"
+
+using namespace std;
+
+namespace ParserTest {
+
+// INSERT INTO t1 FILE csv_file_path, the file parsed serially and by the csv-parse workers gives the same rows
+class ParserInsertCsvTest : public testing::Test {
+ protected:
+  static const int32_t PARSE_THREADS = 4;
+  static const int64_t START_TS = 1640966400000;
+
+  struct SCsvResult {
+    int32_t         code = TSDB_CODE_SUCCESS;
+    string          msg;
+    int32_t         numOfParses = 0;
+    vector<int64_t> ts;
+  };
+
+  static void SetUpTestSuite() {
+    tsCsvParseThreads = PARSE_THREADS;
+    ASSERT_EQ(qInitCsvParsePool(), TSDB_CODE_SUCCESS);
+  }
+
+  static void TearDownTestSuite() {
+    qCleanupCsvParsePool();
+    tsCsvParseThreads = 0;
+  }
+
+  void TearDown() override {
+    tsMaxMemUsedByInsert = 1024;
+    taosRemoveFile(path_.c_str());
+  }
+
+  // ts, c1, c2, c3, c4, c5 of t1
+  static string row(int64_t i, const char* pEol = "\n") {
+    return to_string(START_TS + i) + "," + to_string(i) + ",'s" + to_string(i % 1000) + "'," + to_string(i * 3) +
+           ",4.5,5.5" + pEol;
+  }
+
+  static vector<int64_t> rowsTs(int64_t begin, int64_t end) {
+    vector<int64_t> ts;
+    for (int64_t i = begin; i < end; ++i) {
+      ts.push_back(START_TS + i);
+    }
+    return ts;
+  }
+
+  void writeFile(const string& content) {
+    TdFilePtr fp = taosOpenFile(path_.c_str(), TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+    ASSERT_NE(fp, nullptr);
+    ASSERT_EQ(taosWriteFile(fp, content.data(), content.size()), content.size());
+    taosCloseFile(&fp);
+  }
+
+  static void collectRows(SArray* pDataBlocks, vector<int64_t>* pTs) {
+    for (int32_t i = 0; i < taosArrayGetSize(pDataBlocks); ++i) {
+      SVgDataBlocks* pVg = (SVgDataBlocks*)taosArrayGetP(pDataBlocks, i);
+      SSubmitReq2    req = {0};
+      SDecoder       decoder;
+      tDecoderInit(&decoder, (uint8_t*)POINTER_SHIFT(pVg->pData, sizeof(SSubmitReq2Msg)),
+                   pVg->size - sizeof(SSubmitReq2Msg));
+      ASSERT_EQ(tDecodeSSubmitReq2(&decoder, &req), 0);
+      tDecoderClear(&decoder);
+
+      for (int32_t j = 0; j < taosArrayGetSize(req.aSubmitTbData); ++j) {
+        SSubmitTbData* pTbData = (SSubmitTbData*)taosArrayGet(req.aSubmitTbData, j);
+        ASSERT_FALSE(pTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT);
+        for (int32_t k = 0; k < taosArrayGetSize(pTbData->aRowP); ++k) {
+          pTs->push_back((*(SRow**)taosArrayGet(pTbData->aRowP, k))->ts);
+        }
+      }
+      tDestroySSubmitReq(&req, TSDB_MSG_FLG_DECODE);
+      taosMemoryFree(pVg->pData);
+      taosMemoryFree(pVg);
+    }
+    taosArrayDestroy(pDataBlocks);
+  }
+
+  // parse the file, and parse again as the client does as long as the statement says the file is not done
+  SCsvResult insertFile(int32_t parseThreads) {
+    tsCsvParseThreads = parseThreads;
+
+    string        sql = "insert into t1 file '" + path_ + "'";
+    char          msgBuf[1024] = {0};
+    SParseContext cxt = {0};
+    cxt.acctId = 0;
+    cxt.db = "test";
+    cxt.pUser = "root";
+    cxt.isSuperUser = true;
+    cxt.enableSysInfo = true;
+    cxt.pSql = sql.c_str();
+    cxt.sqlLen = sql.length();
+    cxt.pMsg = msgBuf;
+    cxt.msgLen = sizeof(msgBuf);
+    cxt.svrVer = "3.0.0.0";
+
+    SCsvResult res;
+    SQuery*    pQuery = nullptr;
+    while (1) {
+      res.numOfParses++;
+      res.code = parseInsertSql(&cxt, &pQuery, nullptr, nullptr);
+      if (TSDB_CODE_SUCCESS != res.code) {
+        res.msg = msgBuf;
+        break;
+      }
+
+      SVnodeModifyOpStmt* pStmt = (SVnodeModifyOpStmt*)pQuery->pRoot;
+      SArray*             pDataBlocks = nullptr;
+      TSWAP(pDataBlocks, pStmt->pDataBlocks);
+      collectRows(pDataBlocks, &res.ts);
+      if (!pStmt->fileProcessing) {
+        break;
+      }
+    }
+
+    qDestroyQuery(pQuery);
+    sort(res.ts.begin(), res.ts.end());
+    return res;
+  }
+
+  // the serial and the parallel parse agree, and return the rows or the error
+  SCsvResult checkFile(const string& content) {
+    writeFile(content);
+    SCsvResult serial = insertFile(0);
+    SCsvResult parallel = insertFile(PARSE_THREADS);
+    EXPECT_EQ(serial.code, parallel.code);
+    EXPECT_EQ(serial.msg, parallel.msg);
+    EXPECT_EQ(serial.numOfParses, parallel.numOfParses);
+    EXPECT_EQ(serial.ts, parallel.ts);
+    return serial;
+  }
+
+  string path_ = TD_TMP_DIR_PATH "parInsertCsvTest.csv";
+};
+
+TEST_F(ParserInsertCsvTest, headerAtFileStart) {
+  string content = "ts,c1,c2,c3,c4,c5\n";
+  for (int64_t i = 0; i < 1000; ++i) {
+    content += row(i);
+  }
+
+  SCsvResult res = checkFile(content);
+  ASSERT_EQ(res.code, TSDB_CODE_SUCCESS);
+  ASSERT_EQ(res.ts, rowsTs(0, 1000));
+}
+
+// the first line of a later batch is data like any other line, a header there is an error
+TEST_F(ParserInsertCsvTest, headerOnlyAtOffsetZero) {
+  tsMaxMemUsedByInsert = 1;
+  const int64_t batchSize = 1024 * 1024;
+  const string  header = "ts,c1,c2,c3,c4,c5," + string(64, 'h') + "\n";
+
+  string  content = "ts,c1,c2,c3,c4,c5\n";
+  int64_t i = 0;
+  while ((int64_t)(content.size() + row(i).size()) <= batchSize) {
+    content += row(i++);
+  }
+  content += header;
+  for (int64_t j = 0; j < 100; ++j) {
+    content += row(i++);
+  }
+
+  SCsvResult res = checkFile(content);
+  ASSERT_NE(res.code, TSDB_CODE_SUCCESS);
+}
+
+TEST_F(ParserInsertCsvTest, crlf) {
+  string content = "ts,c1,c2,c3,c4,c5\r\n";
+  for (int64_t i = 0; i < 1000; ++i) {
+    content += row(i, "\r\n");
+  }
+
+  SCsvResult res = checkFile(content);
+  ASSERT_EQ(res.code, TSDB_CODE_SUCCESS);
+  ASSERT_EQ(res.ts, rowsTs(0, 1000));
+}
+
+TEST_F(ParserInsertCsvTest, lastLineWithoutNewline) {
+  string content;
+  for (int64_t i = 0; i < 1000; ++i) {
+    content += row(i, i < 999 ? "\n" : "");
+  }
+
+  SCsvResult res = checkFile(content);
+  ASSERT_EQ(res.code, TSDB_CODE_SUCCESS);
+  ASSERT_EQ(res.ts, rowsTs(0, 1000));
+
+  content += "\r";
+  res = checkFile(content);
+  ASSERT_EQ(res.code, TSDB_CODE_SUCCESS);
+  ASSERT_EQ(res.ts, rowsTs(0, 1000));
+}
+
+// a batch is at most maxMemUsedByInsert megabytes, and grows for a line that does not fit
+TEST_F(ParserInsertCsvTest, lineLongerThanBatch) {
+  tsMaxMemUsedByInsert = 1;
+  const int64_t numOfRows = 30000;
+  string        content = "ts" + string(3 * 1024 * 1024 / 2, 'x') + "\n";
+  for (int64_t i = 0; i < numOfRows; ++i) {
+    content += row(i);
+  }
+
+  SCsvResult res = checkFile(content);
+  ASSERT_EQ(res.code, TSDB_CODE_SUCCESS);
+  ASSERT_GT(res.numOfParses, 1);
+  ASSERT_EQ(res.ts, rowsTs(0, numOfRows));
+}
+
+// the batch is split into PARSE_THREADS chunks, the error of the first failed line wins over the later ones
+TEST_F(ParserInsertCsvTest, errorInLaterChunk) {
+  const int64_t numOfRows = 60000;
+  string        content;
+  for (int64_t i = 0; i < numOfRows; ++i) {
+    if (i == numOfRows / 2) {
+      content += to_string(START_TS + i) + ",bad1x,'s',1,4.5,5.5\n";
+    } else if (i == numOfRows * 9 / 10) {
+      content += to_string(START_TS + i) + ",bad2x,'s',1,4.5,5.5\n";
+    } else {
+      content += row(i);
+    }
+  }
+  ASSERT_GT(content.size(), 4 * 256 * 1024);
+
+  SCsvResult res = checkFile(content);
+  ASSERT_NE(res.code, TSDB_CODE_SUCCESS);
+  ASSERT_NE(res.msg.find("bad1x"), string::npos);
+  ASSERT_EQ(res.msg.find("bad2x"), string::npos);
+}
+
+// every maxMemUsedByInsert megabytes the rows are submitted, and the next parse goes on from the next line
+TEST_F(ParserInsertCsvTest, reentryAcrossMaxMem) {
+  tsMaxMemUsedByInsert = 1;
+  const int64_t numOfRows = 120000;
+  string        content = "ts,c1,c2,c3,c4,c5\n";
+  for (int64_t i = 0; i < numOfRows; ++i) {
+    content += row(i);
+  }
+  ASSERT_GT(content.size(), 3 * 1024 * 1024);
+
+  SCsvResult res = checkFile(content);
+  ASSERT_EQ(res.code, TSDB_CODE_SUCCESS);
+  ASSERT_GT(res.numOfParses, 1);
+  ASSERT_EQ(res.ts, rowsTs(0, numOfRows));
+}
+
+}  // namespace ParserTest
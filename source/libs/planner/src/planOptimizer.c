@@ -645,23 +645,60 @@ static bool pushDownCondOptIsPriKeyEqualCond(SJoinLogicNode* pJoin, SNode* pCond
   return false;
 }
 
-static bool pushDownCondOptContainPriKeyEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+static bool pushDownCondOptIsHashKey(SNode* pNode, SNodeList* pTableCols) {
+  if (QUERY_NODE_COLUMN != nodeType(pNode)) {
+    return false;
+  }
+  SColumnNode* pCol = (SColumnNode*)pNode;
+  uint8_t      type = pCol->node.resType.type;
+  if (TSDB_SYSTEM_TABLE == pCol->tableType || IS_FLOAT_TYPE(type) || TSDB_DATA_TYPE_JSON == type) {
+    return false;
+  }
+  return pushDownCondOptBelongThisTable(pNode, pTableCols);
+}
+
+// equality between a tag or value column of each side, which is joined by hash instead of by timestamp merge
+static bool pushDownCondOptIsHashKeyEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond)) {
+    return false;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (OP_TYPE_EQUAL != pOper->opType || QUERY_NODE_COLUMN != nodeType(pOper->pLeft) ||
+      QUERY_NODE_COLUMN != nodeType(pOper->pRight) ||
+      ((SExprNode*)pOper->pLeft)->resType.type != ((SExprNode*)pOper->pRight)->resType.type) {
+    return false;
+  }
+
+  SNodeList* pLeftCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 0))->pTargets;
+  SNodeList* pRightCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 1))->pTargets;
+  if (pushDownCondOptIsHashKey(pOper->pLeft, pLeftCols)) {
+    return pushDownCondOptIsHashKey(pOper->pRight, pRightCols);
+  } else if (pushDownCondOptIsHashKey(pOper->pLeft, pRightCols)) {
+    return pushDownCondOptIsHashKey(pOper->pRight, pLeftCols);
+  }
+  return false;
+}
+
+typedef bool (*FJoinKeyEqualCond)(SJoinLogicNode* pJoin, SNode* pCond);
+
+static bool pushDownCondOptContainKeyEqualCond(SJoinLogicNode* pJoin, SNode* pCond, FJoinKeyEqualCond isKeyEqualCond) {
   if (QUERY_NODE_LOGIC_CONDITION == nodeType(pCond)) {
     SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pCond;
     if (LOGIC_COND_TYPE_AND != pLogicCond->condType) {
       return false;
     }
-    bool   hasPrimaryKeyEqualCond = false;
+    bool   hasKeyEqualCond = false;
     SNode* pCond = NULL;
     FOREACH(pCond, pLogicCond->pParameterList) {
-      if (pushDownCondOptContainPriKeyEqualCond(pJoin, pCond)) {
-        hasPrimaryKeyEqualCond = true;
+      if (pushDownCondOptContainKeyEqualCond(pJoin, pCond, isKeyEqualCond)) {
+        hasKeyEqualCond = true;
         break;
       }
     }
-    return hasPrimaryKeyEqualCond;
+    return hasKeyEqualCond;
   } else {
-    return pushDownCondOptIsPriKeyEqualCond(pJoin, pCond);
+    return isKeyEqualCond(pJoin, pCond);
   }
 }
 
@@ -669,20 +706,22 @@ static int32_t pushDownCondOptCheckJoinOnCond(SOptimizeContext* pCxt, SJoinLogic
   if (NULL == pJoin->pOnConditions) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_NOT_SUPPORT_CROSS_JOIN);
   }
-  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+  if (!pushDownCondOptContainKeyEqualCond(pJoin, pJoin->pOnConditions, pushDownCondOptIsPriKeyEqualCond) &&
+      !pushDownCondOptContainKeyEqualCond(pJoin, pJoin->pOnConditions, pushDownCondOptIsHashKeyEqualCond)) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_EXPECTED_TS_EQUAL);
   }
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t pushDownCondOptPartJoinOnCondLogicCond(SJoinLogicNode* pJoin, SNode** ppMergeCond, SNode** ppOnCond) {
+static int32_t pushDownCondOptPartJoinOnCondLogicCond(SJoinLogicNode* pJoin, FJoinKeyEqualCond isKeyEqualCond,
+                                                      SNode** ppMergeCond, SNode** ppOnCond) {
   SLogicConditionNode* pLogicCond = (SLogicConditionNode*)(pJoin->pOnConditions);
 
   int32_t    code = TSDB_CODE_SUCCESS;
   SNodeList* pOnConds = NULL;
   SNode*     pCond = NULL;
   FOREACH(pCond, pLogicCond->pParameterList) {
-    if (pushDownCondOptIsPriKeyEqualCond(pJoin, pCond)) {
+    if (NULL == *ppMergeCond && isKeyEqualCond(pJoin, pCond)) {
       *ppMergeCond = nodesCloneNode(pCond);
     } else {
       code = nodesListMakeAppend(&pOnConds, nodesCloneNode(pCond));
@@ -707,12 +746,18 @@ static int32_t pushDownCondOptPartJoinOnCondLogicCond(SJoinLogicNode* pJoin, SNo
 }
 
 static int32_t pushDownCondOptPartJoinOnCond(SJoinLogicNode* pJoin, SNode** ppMergeCond, SNode** ppOnCond) {
+  // the primary key equality keeps the timestamp merge join, otherwise a tag or value equality becomes the hash key
+  FJoinKeyEqualCond isKeyEqualCond = pushDownCondOptIsPriKeyEqualCond;
+  if (!pushDownCondOptContainKeyEqualCond(pJoin, pJoin->pOnConditions, pushDownCondOptIsPriKeyEqualCond)) {
+    isKeyEqualCond = pushDownCondOptIsHashKeyEqualCond;
+  }
+
   if (QUERY_NODE_LOGIC_CONDITION == nodeType(pJoin->pOnConditions) &&
       LOGIC_COND_TYPE_AND == ((SLogicConditionNode*)(pJoin->pOnConditions))->condType) {
-    return pushDownCondOptPartJoinOnCondLogicCond(pJoin, ppMergeCond, ppOnCond);
+    return pushDownCondOptPartJoinOnCondLogicCond(pJoin, isKeyEqualCond, ppMergeCond, ppOnCond);
   }
 
-  if (pushDownCondOptIsPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+  if (isKeyEqualCond(pJoin, pJoin->pOnConditions)) {
     *ppMergeCond = nodesCloneNode(pJoin->pOnConditions);
     *ppOnCond = NULL;
     nodesDestroyNode(pJoin->pOnConditions);
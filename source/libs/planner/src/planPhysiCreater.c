@@ -584,6 +584,9 @@ static int32_t createTableScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubp
   pTableScan->igExpired = pScanLogicNode->igExpired;
   pTableScan->igCheckUpdate = pScanLogicNode->igCheckUpdate;
   pTableScan->assignBlockUid = pCxt->pPlanCxt->rSmaQuery ? true : false;
+  if (!pCxt->pPlanCxt->streamQuery && !pCxt->pPlanCxt->topicQuery) {
+    pTableScan->parallelScan = tsQueryParallelScan;
+  }
 
   int32_t code = createScanPhysiNodeFinalize(pCxt, pSubplan, pScanLogicNode, (SScanPhysiNode*)pTableScan, pPhyNode);
   if (TSDB_CODE_SUCCESS == code) {
@@ -663,10 +666,22 @@ static int32_t createScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubplan,
   return TSDB_CODE_FAILED;
 }
 
+static bool isPrimaryKeyJoinCond(SNode* pMergeCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pMergeCond)) {
+    return false;
+  }
+  SOperatorNode* pOper = (SOperatorNode*)pMergeCond;
+  return QUERY_NODE_COLUMN == nodeType(pOper->pLeft) && QUERY_NODE_COLUMN == nodeType(pOper->pRight) &&
+         PRIMARYKEY_TIMESTAMP_COL_ID == ((SColumnNode*)pOper->pLeft)->colId &&
+         PRIMARYKEY_TIMESTAMP_COL_ID == ((SColumnNode*)pOper->pRight)->colId;
+}
+
 static int32_t createJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
                                    SPhysiNode** pPhyNode) {
-  SSortMergeJoinPhysiNode* pJoin =
-      (SSortMergeJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN);
+  // joins keyed on a tag or value column build a hash table of the right child instead of merging on timestamp
+  ENodeType type = isPrimaryKeyJoinCond(pJoinLogicNode->pMergeCondition) ? QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN
+                                                                           : QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN;
+  SSortMergeJoinPhysiNode* pJoin = (SSortMergeJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, type);
   if (NULL == pJoin) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
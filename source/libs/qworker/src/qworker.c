@@ -354,14 +354,26 @@ int32_t qwGetQueryResFromSink(QW_FPARAMS_DEF, SQWTaskCtx *ctx, int32_t *dataLen,
 
     *dataLen += len;
 
-    QW_ERR_RET(qwMallocFetchRsp(!ctx->localExec, *dataLen, &rsp));
+    // take over the buffer of the first block as the rsp, which is sent without copy
+    if (NULL == rsp && !ctx->localExec) {
+      code = dsGetDataRsp(ctx->sinkHandle, &output, (void **)&rsp);
+      if (code) {
+        QW_TASK_ELOG("dsGetDataRsp failed, code:%x - %s", code, tstrerror(code));
+        QW_ERR_RET(code);
+      }
+    }
 
-    output.pData = rsp->data + *dataLen - len;
-    code = dsGetDataBlock(ctx->sinkHandle, &output);
-    if (code) {
-      QW_TASK_ELOG("dsGetDataBlock failed, code:%x - %s", code, tstrerror(code));
-      QW_ERR_RET(code);
+    if (NULL == output.pData) {
+      QW_ERR_RET(qwMallocFetchRsp(!ctx->localExec, *dataLen, &rsp));
+
+      output.pData = rsp->data + *dataLen - len;
+      code = dsGetDataBlock(ctx->sinkHandle, &output);
+      if (code) {
+        QW_TASK_ELOG("dsGetDataBlock failed, code:%x - %s", code, tstrerror(code));
+        QW_ERR_RET(code);
+      }
     }
+    output.pData = NULL;
 
     pOutput->queryEnd = output.queryEnd;
     pOutput->precision = output.precision;
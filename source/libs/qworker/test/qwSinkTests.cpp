@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The fetch rsp is built from a real data dispatcher, without the stubs of qworkerTests.cpp: the buffer the first
+// block is encoded into is taken over as the rsp, and the following blocks of the same fetch extend it.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "os.h"
+
+#include "dataSinkMgt.h"
+#include "qwInt.h"
+#include "qwMsg.h"
+#include "tdatablock.h"
+#include "trpc.h"
+
+namespace {
+
+const uint64_t qwstSId = 1;
+const uint64_t qwstQId = 2;
+const uint64_t qwstTId = 3;
+const int64_t  qwstRId = 4;
+const int32_t  qwstEId = 5;
+
+const int64_t qwstStartTs = 1640966400000;
+const int32_t qwstBinaryLen = 32;
+
+SDataSinkNode *qwstCreateSinkNode() {
+  SDataBlockDescNode *pDesc = (SDataBlockDescNode *)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->pSlots = nodesMakeList();
+  pDesc->precision = TSDB_TIME_PRECISION_MILLI;
+
+  const int8_t  types[] = {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_VARCHAR};
+  const int32_t bytes[] = {sizeof(int64_t), sizeof(int32_t), qwstBinaryLen + VARSTR_HEADER_SIZE};
+  for (int32_t i = 0; i < 3; ++i) {
+    SSlotDescNode *pSlot = (SSlotDescNode *)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+    pSlot->slotId = i;
+    pSlot->dataType.type = types[i];
+    pSlot->dataType.bytes = bytes[i];
+    pSlot->output = true;
+    nodesListAppend(pDesc->pSlots, (SNode *)pSlot);
+  }
+
+  SDataDispatcherNode *pSink = (SDataDispatcherNode *)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_DISPATCH);
+  pSink->sink.pInputDataBlockDesc = pDesc;
+  return (SDataSinkNode *)pSink;
+}
+
+SSDataBlock *qwstCreateBlock() {
+  SSDataBlock *pBlock = createDataBlock();
+
+  SColumnInfoData ts = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t), 1);
+  SColumnInfoData val = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 2);
+  SColumnInfoData str = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, qwstBinaryLen + VARSTR_HEADER_SIZE, 3);
+  blockDataAppendColInfo(pBlock, &ts);
+  blockDataAppendColInfo(pBlock, &val);
+  blockDataAppendColInfo(pBlock, &str);
+
+  return pBlock;
+}
+
+// row i of the result: ts, i * 3 or NULL every 7 rows, and a string of a length varying with i
+SSDataBlock *qwstMakeBlock(int64_t start, int32_t rows) {
+  SSDataBlock *pBlock = qwstCreateBlock();
+  blockDataEnsureCapacity(pBlock, rows);
+
+  SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+  SColumnInfoData *pVal = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+  SColumnInfoData *pStr = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2);
+  for (int32_t i = 0; i < rows; ++i) {
+    int64_t row = start + i;
+    int64_t ts = qwstStartTs + row;
+    int32_t val = (int32_t)row * 3;
+    char    str[qwstBinaryLen + VARSTR_HEADER_SIZE] = {0};
+    varDataSetLen(str, snprintf(varDataVal(str), qwstBinaryLen, "r%" PRId64 "%.*s", row, (int32_t)(row % 17),
+                                "xxxxxxxxxxxxxxxxx"));
+
+    colDataSetVal(pTs, i, (const char *)&ts, false);
+    colDataSetVal(pVal, i, (const char *)&val, (row % 7) == 0);
+    colDataSetVal(pStr, i, str, false);
+  }
+
+  pBlock->info.rows = rows;
+  return pBlock;
+}
+
+// decode the blocks of a fetch rsp the way the exchange operator does, and check the rows from start on
+int64_t qwstCheckRsp(SRetrieveTableRsp *pRsp, int32_t dataLen, int64_t start) {
+  int32_t numOfBlocks = ntohl(pRsp->numOfBlocks);
+  int64_t numOfRows = 0;
+
+  EXPECT_EQ(ntohl(pRsp->compLen), dataLen);
+
+  const char *pStart = pRsp->data;
+  for (int32_t b = 0; b < numOfBlocks; ++b) {
+    SSDataBlock *pBlock = qwstCreateBlock();
+    pStart = blockDecode(pBlock, pStart);
+
+    SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+    SColumnInfoData *pVal = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+    SColumnInfoData *pStr = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2);
+    for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+      int64_t row = start + numOfRows + i;
+      char    str[qwstBinaryLen + VARSTR_HEADER_SIZE] = {0};
+      snprintf(str, qwstBinaryLen, "r%" PRId64 "%.*s", row, (int32_t)(row % 17), "xxxxxxxxxxxxxxxxx");
+
+      EXPECT_EQ(*(int64_t *)colDataGetData(pTs, i), qwstStartTs + row);
+      EXPECT_EQ(colDataIsNull_s(pVal, i), (row % 7) == 0);
+      if (!colDataIsNull_s(pVal, i)) {
+        EXPECT_EQ(*(int32_t *)colDataGetData(pVal, i), (int32_t)row * 3);
+      }
+      char *pData = colDataGetData(pStr, i);
+      EXPECT_EQ(std::string(varDataVal(pData), varDataLen(pData)), std::string(str));
+    }
+
+    numOfRows += pBlock->info.rows;
+    blockDataDestroy(pBlock);
+  }
+
+  EXPECT_EQ(pStart - pRsp->data, dataLen);
+  EXPECT_EQ(be64toh(pRsp->numOfRows), numOfRows);
+  return numOfRows;
+}
+
+class QwSinkTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SDataSinkMgtCfg cfg = {0};
+    cfg.maxDataBlockNum = 10000;
+    cfg.maxDataBlockNumPerQuery = 10000;
+    dsDataSinkMgtInit(&cfg);
+
+    memset(&mgmt, 0, sizeof(mgmt));
+    mgmt.cfg.maxSchTaskNum = 10;
+    mgmt.schHash = taosHashInit(10, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UBIGINT), false, HASH_ENTRY_LOCK);
+    ASSERT_EQ(qwAddTaskStatus(&mgmt, qwstSId, qwstQId, qwstTId, qwstRId, qwstEId, JOB_TASK_STATUS_EXEC), 0);
+
+    pSinkNode = qwstCreateSinkNode();
+    memset(&ctx, 0, sizeof(ctx));
+    ASSERT_EQ(dsCreateDataSinker(pSinkNode, &ctx.sinkHandle, NULL, "qwSinkTest"), 0);
+  }
+
+  void TearDown() override {
+    dsDestroyDataSinker(ctx.sinkHandle);
+    nodesDestroyNode((SNode *)pSinkNode);
+
+    SQWSchStatus *sch = (SQWSchStatus *)taosHashGet(mgmt.schHash, &qwstSId, sizeof(qwstSId));
+    if (sch != NULL) {
+      taosHashCleanup(sch->tasksHash);
+    }
+    taosHashCleanup(mgmt.schHash);
+  }
+
+  // put blocks of the given sizes into the sink, the rows numbered on from those put before
+  void put(const std::vector<int32_t> &blockRows, bool end) {
+    for (int32_t rows : blockRows) {
+      SSDataBlock *pBlock = qwstMakeBlock(numOfPut, rows);
+      SInputData   input = {pBlock};
+      bool         cont = false;
+      ASSERT_EQ(dsPutDataBlock(ctx.sinkHandle, &input, &cont), 0);
+      blockDataDestroy(pBlock);
+      numOfPut += rows;
+    }
+
+    if (end) {
+      dsEndPut(ctx.sinkHandle, 10);
+    }
+  }
+
+  // fetch once and check the rows in the rsp, return the number of blocks in it
+  int32_t fetch() {
+    SOutputData output = {0};
+    void       *rsp = NULL;
+    int32_t     dataLen = 0;
+    EXPECT_EQ(qwGetQueryResFromSink(&mgmt, qwstSId, qwstQId, qwstTId, qwstRId, qwstEId, &ctx, &dataLen, &rsp, &output),
+              0);
+    if (rsp == NULL) {
+      return 0;
+    }
+
+    bool qComplete = (DS_BUF_EMPTY == output.bufStatus && output.queryEnd);
+    qwBuildFetchRsp(rsp, &output, dataLen, qComplete);
+    queryEnd = qComplete;
+
+    SRetrieveTableRsp *pRsp = (SRetrieveTableRsp *)rsp;
+    EXPECT_EQ(ntohl(pRsp->numOfBlocks), output.numOfBlocks);
+    numOfFetched += qwstCheckRsp(pRsp, dataLen, numOfFetched);
+
+    if (ctx.localExec) {
+      taosMemoryFree(rsp);
+    } else {
+      rpcFreeCont(rsp);
+    }
+
+    return output.numOfBlocks;
+  }
+
+  SQWorker       mgmt;
+  SQWTaskCtx     ctx;
+  SDataSinkNode *pSinkNode = NULL;
+  int64_t        numOfPut = 0;
+  int64_t        numOfFetched = 0;
+  bool           queryEnd = false;
+};
+
+}  // namespace
+
+TEST_F(QwSinkTest, singleBlockRsp) {
+  // a level 0 task returns one block per fetch, each sent in the buffer it was encoded into
+  ctx.level = 0;
+  put({10, 1, 300, 2000}, true);
+
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_TRUE(queryEnd);
+  EXPECT_EQ(numOfFetched, numOfPut);
+}
+
+TEST_F(QwSinkTest, multiBlockRsp) {
+  // the first block is taken over, the next ones grow the rsp until it holds QW_MIN_RES_ROWS rows
+  ctx.level = 1;
+  put({1000, 5, 1000, 1000, 1500, 700, 3000, 3}, true);
+
+  EXPECT_EQ(fetch(), 5);
+  EXPECT_EQ(numOfFetched, 4505);
+  EXPECT_FALSE(queryEnd);
+
+  EXPECT_EQ(fetch(), 3);
+  EXPECT_TRUE(queryEnd);
+  EXPECT_EQ(numOfFetched, numOfPut);
+}
+
+TEST_F(QwSinkTest, partialFetch) {
+  // the sink runs dry before the query ends, then the rest of the blocks come in
+  ctx.level = 1;
+  put({100, 200}, false);
+
+  EXPECT_EQ(fetch(), 2);
+  EXPECT_FALSE(queryEnd);
+  EXPECT_EQ(fetch(), 0);
+
+  put({4096, 50}, true);
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_TRUE(queryEnd);
+  EXPECT_EQ(numOfFetched, numOfPut);
+}
+
+TEST_F(QwSinkTest, localExecRsp) {
+  // the local rsp is not sent by rpc, the blocks are copied into a buffer of its own
+  ctx.level = 1;
+  ctx.localExec = true;
+  put({1000, 5, 3100, 1000}, true);
+
+  EXPECT_EQ(fetch(), 3);
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_TRUE(queryEnd);
+  EXPECT_EQ(numOfFetched, numOfPut);
+}
+
+#pragma GCC diagnostic pop
@@ -400,6 +400,12 @@ int32_t qwtGetDataBlock(DataSinkHandle handle, SOutputData *pOutput) {
   return 0;
 }
 
+int32_t qwtGetDataRsp(DataSinkHandle handle, SOutputData *pOutput, void **ppRsp) {
+  // always copy the data by qwtGetDataBlock
+  *ppRsp = NULL;
+  return 0;
+}
+
 void qwtDestroyDataSinker(DataSinkHandle handle) {}
 
 void stubSetStringToPlan() {
@@ -605,6 +611,7 @@ void stubSetRpcSendResponse() {
 void stubSetGetDataBlock() {
   static Stub stub;
   stub.set(dsGetDataBlock, qwtGetDataBlock);
+  stub.set(dsGetDataRsp, qwtGetDataRsp);
   {
 #ifdef WINDOWS
     AddrAny                       any;
@@ -214,6 +214,26 @@ typedef struct SFilterComUnit {
   int8_t   rfunc;
 } SFilterComUnit;
 
+typedef void (*filter_kernel_func)(SFilterComUnit *, int32_t, int8_t *);
+
+// a unit of a compiled filter program, evaluated over the whole block into the selection of its group
+typedef struct SFilterProgUnit {
+  uint32_t           uidx;
+  filter_kernel_func kernel;  // typed kernel, NULL to compare the selected rows one by one
+  int8_t             rank;    // estimated selectivity, lower is more selective
+} SFilterProgUnit;
+
+typedef struct SFilterProgGroup {
+  uint32_t         unitNum;
+  SFilterProgUnit *units;
+} SFilterProgGroup;
+
+// read only once compiled, the filter info may be executed by several operators at the same time
+typedef struct SFilterProgram {
+  uint32_t          groupNum;
+  SFilterProgGroup *groups;
+} SFilterProgram;
+
 typedef struct SFilterPCtx {
   SHashObj *valHash;
   SHashObj *unitHash;
@@ -260,6 +280,7 @@ struct SFilterInfo {
   int8_t           *blkUnitRes;
   void             *pTable;
   SArray           *blkList;
+  SFilterProgram   *program;
 
   SFilterPCtx pctx;
 };
@@ -489,6 +510,12 @@ extern bool          filterDoCompare(__compar_fn_t func, uint8_t optr, void *lef
 extern __compar_fn_t filterGetCompFunc(int32_t type, int32_t optr);
 extern __compar_fn_t filterGetCompFuncEx(int32_t lType, int32_t rType, int32_t optr);
 
+// filters of several units are evaluated by their compiled program, or row by row if it could not be compiled
+bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis, int16_t numOfCols,
+                       int32_t *numOfQualified);
+bool filterExecuteImplProgram(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                              int16_t numOfCols, int32_t *numOfQualified);
+
 #ifdef __cplusplus
 }
 #endif
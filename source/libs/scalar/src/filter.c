@@ -1835,11 +1835,26 @@ void filterFreePCtx(SFilterPCtx *pctx) {
   taosHashCleanup(pctx->unitHash);
 }
 
+static void filterFreeProgram(SFilterProgram *prog) {
+  if (prog == NULL) {
+    return;
+  }
+
+  for (uint32_t g = 0; g < prog->groupNum; ++g) {
+    taosMemoryFree(prog->groups[g].units);
+  }
+  taosMemoryFree(prog->groups);
+  taosMemoryFree(prog);
+}
+
 void filterFreeInfo(SFilterInfo *info) {
   if (info == NULL) {
     return;
   }
 
+  filterFreeProgram(info->program);
+  info->program = NULL;
+
   taosMemoryFreeClear(info->cunits);
   taosMemoryFreeClear(info->blkUnitRes);
   taosMemoryFreeClear(info->blkUnits);
@@ -3207,6 +3222,46 @@ bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes
   return all;
 }
 
+static bool filterExecuteUnitRow(SFilterComUnit *cunit, int32_t i) {
+  void *colData = NULL;
+  bool  isNull = colDataIsNull((SColumnInfoData *)(cunit->colData), 0, i, NULL);
+  bool  res = false;
+
+  uint8_t optr = cunit->optr;
+
+  if (!isNull) {
+    colData = colDataGetData((SColumnInfoData *)(cunit->colData), i);
+  }
+
+  if (colData == NULL || isNull) {
+    res = optr == OP_TYPE_IS_NULL ? true : false;
+  } else {
+    if (optr == OP_TYPE_IS_NOT_NULL) {
+      res = true;
+    } else if (optr == OP_TYPE_IS_NULL) {
+      res = false;
+    } else if (cunit->rfunc >= 0) {
+      res = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
+    } else {
+      if (cunit->dataType == TSDB_DATA_TYPE_NCHAR && (cunit->optr == OP_TYPE_MATCH || cunit->optr == OP_TYPE_NMATCH)) {
+        char   *newColData = taosMemoryCalloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
+        int32_t len = taosUcs4ToMbs((TdUcs4 *)varDataVal(colData), varDataLen(colData), varDataVal(newColData));
+        if (len < 0) {
+          qError("castConvert1 taosUcs4ToMbs error");
+        } else {
+          varDataSetLen(newColData, len);
+          res = filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
+        }
+        taosMemoryFreeClear(newColData);
+      } else {
+        res = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
+      }
+    }
+  }
+
+  return res;
+}
+
 bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis, int16_t numOfCols,
                        int32_t *numOfQualified) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
@@ -3219,55 +3274,10 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
   int8_t *p = (int8_t *)pRes->pData;
 
   for (int32_t i = 0; i < numOfRows; ++i) {
-    // FILTER_UNIT_CLR_F(info);
-
     for (uint32_t g = 0; g < info->groupNum; ++g) {
       SFilterGroup *group = &info->groups[g];
       for (uint32_t u = 0; u < group->unitNum; ++u) {
-        uint32_t        uidx = group->unitIdxs[u];
-        SFilterComUnit *cunit = &info->cunits[uidx];
-        void           *colData = NULL;
-        bool            isNull = colDataIsNull((SColumnInfoData *)(cunit->colData), 0, i, NULL);
-        // if (FILTER_UNIT_GET_F(info, uidx)) {
-        //   p[i] = FILTER_UNIT_GET_R(info, uidx);
-        // } else {
-        uint8_t optr = cunit->optr;
-
-        if (!isNull) {
-          colData = colDataGetData((SColumnInfoData *)(cunit->colData), i);
-        }
-
-        if (colData == NULL || isNull) {
-          p[i] = optr == OP_TYPE_IS_NULL ? true : false;
-        } else {
-          if (optr == OP_TYPE_IS_NOT_NULL) {
-            p[i] = 1;
-          } else if (optr == OP_TYPE_IS_NULL) {
-            p[i] = 0;
-          } else if (cunit->rfunc >= 0) {
-            p[i] = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2,
-                                                  gDataCompare[cunit->func]);
-          } else {
-            if (cunit->dataType == TSDB_DATA_TYPE_NCHAR &&
-                (cunit->optr == OP_TYPE_MATCH || cunit->optr == OP_TYPE_NMATCH)) {
-              char   *newColData = taosMemoryCalloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
-              int32_t len = taosUcs4ToMbs((TdUcs4 *)varDataVal(colData), varDataLen(colData), varDataVal(newColData));
-              if (len < 0) {
-                qError("castConvert1 taosUcs4ToMbs error");
-              } else {
-                varDataSetLen(newColData, len);
-                p[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
-              }
-              taosMemoryFreeClear(newColData);
-            } else {
-              p[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
-            }
-          }
-
-          // FILTER_UNIT_SET_R(info, uidx, p[i]);
-          // FILTER_UNIT_SET_F(info, uidx);
-        }
-
+        p[i] = filterExecuteUnitRow(&info->cunits[group->unitIdxs[u]], i);
         if (p[i] == 0) {
           break;
         }
@@ -3288,6 +3298,244 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
   return all;
 }
 
+// The unit groups of the filter are compiled into a program that is executed a unit at a time over the whole block.
+// Each unit narrows the selection of its group, one byte per row. The units on integer columns compared with constants
+// are evaluated by typed kernels the compiler is able to vectorize, the other ones compare the selected rows one by one.
+// The evaluation of a group stops as soon as its selection is empty, and the units of a group are ordered by their
+// estimated selectivity when the program is compiled.
+#define FLT_SEL_LOOP(_cond)                    \
+  do {                                         \
+    for (int32_t i = 0; i < numOfRows; ++i) {  \
+      sel[i] &= (int8_t)(_cond);               \
+    }                                          \
+  } while (0)
+
+#define FLT_DEFINE_KERNEL(_name, _type)                                              \
+  static void _name(SFilterComUnit *cunit, int32_t numOfRows, int8_t *sel) {          \
+    const _type *v = (const _type *)((SColumnInfoData *)cunit->colData)->pData;      \
+    _type        lo = *(const _type *)cunit->valData;                                \
+    _type        hi = *(const _type *)cunit->valData2;                               \
+    switch (cunit->rfunc) {                                                          \
+      case 0:                                                                        \
+        FLT_SEL_LOOP((v[i] > lo) & (v[i] < hi));                                     \
+        break;                                                                       \
+      case 1:                                                                        \
+        FLT_SEL_LOOP((v[i] > lo) & (v[i] <= hi));                                    \
+        break;                                                                       \
+      case 2:                                                                        \
+        FLT_SEL_LOOP((v[i] >= lo) & (v[i] < hi));                                    \
+        break;                                                                       \
+      case 3:                                                                        \
+        FLT_SEL_LOOP((v[i] >= lo) & (v[i] <= hi));                                   \
+        break;                                                                       \
+      case 4:                                                                        \
+        FLT_SEL_LOOP(v[i] > lo);                                                     \
+        break;                                                                       \
+      case 5:                                                                        \
+        FLT_SEL_LOOP(v[i] >= lo);                                                    \
+        break;                                                                       \
+      case 6:                                                                        \
+        FLT_SEL_LOOP(v[i] < hi);                                                     \
+        break;                                                                       \
+      case 7:                                                                        \
+        FLT_SEL_LOOP(v[i] <= hi);                                                    \
+        break;                                                                       \
+      default:                                                                       \
+        if (cunit->optr == OP_TYPE_EQUAL) {                                          \
+          FLT_SEL_LOOP(v[i] == lo);                                                  \
+        } else {                                                                     \
+          FLT_SEL_LOOP(v[i] != lo);                                                  \
+        }                                                                            \
+        break;                                                                       \
+    }                                                                                \
+  }
+
+FLT_DEFINE_KERNEL(filterKernelInt8, int8_t)
+FLT_DEFINE_KERNEL(filterKernelInt16, int16_t)
+FLT_DEFINE_KERNEL(filterKernelInt32, int32_t)
+FLT_DEFINE_KERNEL(filterKernelInt64, int64_t)
+FLT_DEFINE_KERNEL(filterKernelUint8, uint8_t)
+FLT_DEFINE_KERNEL(filterKernelUint16, uint16_t)
+FLT_DEFINE_KERNEL(filterKernelUint32, uint32_t)
+FLT_DEFINE_KERNEL(filterKernelUint64, uint64_t)
+
+// the float types are left to the compare functions, which treat the values within a tolerance as equal
+static filter_kernel_func filterGetKernel(SFilterComUnit *cunit, int8_t *rank) {
+  if (cunit->optr == OP_TYPE_IS_NULL || cunit->optr == OP_TYPE_IS_NOT_NULL) {
+    *rank = (cunit->optr == OP_TYPE_IS_NULL) ? 1 : 3;
+    return NULL;
+  }
+
+  if (cunit->rfunc < 0 && cunit->optr != OP_TYPE_EQUAL && cunit->optr != OP_TYPE_NOT_EQUAL) {
+    *rank = 4;
+    return NULL;
+  }
+
+  if (cunit->rfunc >= 4) {
+    *rank = 2;
+  } else if (cunit->rfunc >= 0) {
+    *rank = 1;
+  } else {
+    *rank = (cunit->optr == OP_TYPE_EQUAL) ? 0 : 3;
+  }
+
+  switch (cunit->dataType) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      return filterKernelInt8;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return filterKernelInt16;
+    case TSDB_DATA_TYPE_INT:
+      return filterKernelInt32;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return filterKernelInt64;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return filterKernelUint8;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return filterKernelUint16;
+    case TSDB_DATA_TYPE_UINT:
+      return filterKernelUint32;
+    case TSDB_DATA_TYPE_UBIGINT:
+      return filterKernelUint64;
+    default:
+      *rank += 4;
+      return NULL;
+  }
+}
+
+static SFilterProgram *filterCompileProgram(SFilterInfo *info) {
+  SFilterProgram *prog = taosMemoryCalloc(1, sizeof(SFilterProgram));
+  if (prog == NULL) {
+    return NULL;
+  }
+
+  prog->groups = taosMemoryCalloc(info->groupNum, sizeof(SFilterProgGroup));
+  if (prog->groups == NULL) {
+    taosMemoryFree(prog);
+    return NULL;
+  }
+  prog->groupNum = info->groupNum;
+
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup     *group = &info->groups[g];
+    SFilterProgGroup *pg = &prog->groups[g];
+
+    pg->units = taosMemoryCalloc(group->unitNum, sizeof(SFilterProgUnit));
+    if (pg->units == NULL) {
+      filterFreeProgram(prog);
+      return NULL;
+    }
+
+    for (uint32_t u = 0; u < group->unitNum; ++u) {
+      SFilterProgUnit *pu = &pg->units[pg->unitNum++];
+      pu->uidx = group->unitIdxs[u];
+      pu->kernel = filterGetKernel(&info->cunits[pu->uidx], &pu->rank);
+
+      // insertion by the estimated selectivity
+      for (int32_t k = pg->unitNum - 1; k > 0 && pg->units[k].rank < pg->units[k - 1].rank; --k) {
+        SFilterProgUnit t = pg->units[k];
+        pg->units[k] = pg->units[k - 1];
+        pg->units[k - 1] = t;
+      }
+    }
+  }
+
+  return prog;
+}
+
+// evaluate the unit into the selection and return the number of rows still selected
+static int32_t filterExecuteProgUnit(SFilterComUnit *cunit, const SFilterProgUnit *pu, int32_t numOfRows, int8_t *sel) {
+  SColumnInfoData *pCol = (SColumnInfoData *)cunit->colData;
+
+  if (pu->kernel != NULL) {
+    (*pu->kernel)(cunit, numOfRows, sel);
+    if (pCol->hasNull) {
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        if (sel[i] && colDataIsNull(pCol, 0, i, NULL)) {
+          sel[i] = 0;
+        }
+      }
+    }
+  } else {
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      if (sel[i]) {
+        sel[i] = filterExecuteUnitRow(cunit, i);
+      }
+    }
+  }
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    num += sel[i];
+  }
+
+  return num;
+}
+
+bool filterExecuteImplProgram(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                              int16_t numOfCols, int32_t *numOfQualified) {
+  SFilterInfo    *info = (SFilterInfo *)pinfo;
+  SFilterProgram *prog = info->program;
+  bool            all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  // with a single group the result is the selection, otherwise the groups are or-ed into the result
+  int8_t *groupSel = NULL;
+  if (prog->groupNum > 1) {
+    groupSel = taosMemoryMalloc(numOfRows);
+    if (groupSel == NULL) {
+      return filterExecuteImpl(pinfo, numOfRows, pRes, statis, numOfCols, numOfQualified);
+    }
+  }
+
+  int8_t *p = (int8_t *)pRes->pData;
+  int32_t num = 0;
+
+  // the groups are or-ed, the units in a group are and-ed
+  if (prog->groupNum > 1) {
+    memset(p, 0, numOfRows);
+  }
+
+  for (uint32_t g = 0; g < prog->groupNum; ++g) {
+    SFilterProgGroup *pg = &prog->groups[g];
+    int8_t           *sel = (groupSel != NULL) ? groupSel : p;
+    int32_t           numOfSel = numOfRows;
+
+    memset(sel, 1, numOfRows);
+    for (uint32_t u = 0; u < pg->unitNum && numOfSel > 0; ++u) {
+      const SFilterProgUnit *pu = &pg->units[u];
+      numOfSel = filterExecuteProgUnit(&info->cunits[pu->uidx], pu, numOfRows, sel);
+    }
+
+    if (prog->groupNum == 1) {
+      num = numOfSel;
+      break;
+    }
+
+    if (numOfSel > 0) {
+      num = 0;
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        p[i] |= sel[i];
+        num += p[i];
+      }
+    }
+
+    if (num == numOfRows) {
+      break;
+    }
+  }
+
+  taosMemoryFree(groupSel);
+
+  *numOfQualified += num;
+  all = (num == numOfRows);
+  return all;
+}
+
 int32_t filterSetExecFunc(SFilterInfo *info) {
   if (FILTER_ALL_RES(info)) {
     info->func = filterExecuteImplAll;
@@ -3300,7 +3548,9 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
   }
 
   if (info->unitNum > 1) {
-    info->func = filterExecuteImpl;
+    filterFreeProgram(info->program);
+    info->program = filterCompileProgram(info);
+    info->func = (info->program != NULL) ? filterExecuteImplProgram : filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
   }
 
@@ -999,6 +999,312 @@ enum {
   VECTOR_UN_CONVERT = 0x2,
 };
 
+// Type specialized kernels of the arithmetic and comparison operators on numeric columns. The operands are widened a
+// chunk at a time by loops on the native type, which the compiler is able to vectorize, instead of a function pointer
+// call per element. They only handle the ascending order, and return false to fall back to the generic loops.
+#define VECTOR_KERNEL_CHUNK 1024
+
+#define VECTOR_LOAD(_srcType, _dstType, _pCol, _start, _n, _pDst)     \
+  do {                                                                \
+    const _srcType *_p = (const _srcType *)(_pCol)->pData + (_start); \
+    for (int32_t _k = 0; _k < (_n); ++_k) {                           \
+      (_pDst)[_k] = (_dstType)_p[_k];                                 \
+    }                                                                 \
+  } while (0)
+
+#define VECTOR_LOAD_NUMERIC(_dstType, _pCol, _start, _n, _pDst)                         \
+  do {                                                                                  \
+    switch ((_pCol)->info.type) {                                                       \
+      case TSDB_DATA_TYPE_BOOL:                                                         \
+        VECTOR_LOAD(bool, _dstType, _pCol, _start, _n, _pDst);                          \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_TINYINT:                                                      \
+        VECTOR_LOAD(int8_t, _dstType, _pCol, _start, _n, _pDst);                        \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_UTINYINT:                                                     \
+        VECTOR_LOAD(uint8_t, _dstType, _pCol, _start, _n, _pDst);                       \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_SMALLINT:                                                     \
+        VECTOR_LOAD(int16_t, _dstType, _pCol, _start, _n, _pDst);                       \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_USMALLINT:                                                    \
+        VECTOR_LOAD(uint16_t, _dstType, _pCol, _start, _n, _pDst);                      \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_INT:                                                          \
+        VECTOR_LOAD(int32_t, _dstType, _pCol, _start, _n, _pDst);                       \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_UINT:                                                         \
+        VECTOR_LOAD(uint32_t, _dstType, _pCol, _start, _n, _pDst);                      \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_BIGINT:                                                       \
+      case TSDB_DATA_TYPE_TIMESTAMP:                                                    \
+        VECTOR_LOAD(int64_t, _dstType, _pCol, _start, _n, _pDst);                       \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_UBIGINT:                                                      \
+        VECTOR_LOAD(uint64_t, _dstType, _pCol, _start, _n, _pDst);                      \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_FLOAT:                                                        \
+        VECTOR_LOAD(float, _dstType, _pCol, _start, _n, _pDst);                         \
+        break;                                                                          \
+      case TSDB_DATA_TYPE_DOUBLE:                                                       \
+        VECTOR_LOAD(double, _dstType, _pCol, _start, _n, _pDst);                        \
+        break;                                                                          \
+      default:                                                                          \
+        ASSERT(0);                                                                      \
+    }                                                                                   \
+  } while (0)
+
+static void vectorLoadDouble(const SColumnInfoData *pCol, int32_t start, int32_t n, double *pDst) {
+  VECTOR_LOAD_NUMERIC(double, pCol, start, n, pDst);
+}
+
+static void vectorLoadBigint(const SColumnInfoData *pCol, int32_t start, int32_t n, int64_t *pDst) {
+  VECTOR_LOAD_NUMERIC(int64_t, pCol, start, n, pDst);
+}
+
+// merge the null bitmap of the source column into the output column, a byte at a time
+static void vectorMergeNullBitmap(SColumnInfoData *pOutputCol, const SColumnInfoData *pCol, int32_t numOfRows) {
+  if (!pCol->hasNull || pCol->nullbitmap == NULL) {
+    return;
+  }
+
+  for (int32_t k = 0; k < BitmapLen(numOfRows); ++k) {
+    pOutputCol->nullbitmap[k] |= pCol->nullbitmap[k];
+  }
+  pOutputCol->hasNull = true;
+}
+
+static bool vectorMathDoubleKernel(SColumnInfoData *pLeftCol, int32_t leftRows, SColumnInfoData *pRightCol,
+                                   int32_t rightRows, SColumnInfoData *pOutputCol, int32_t _ord, int32_t optr) {
+  if (_ord != TSDB_ORDER_ASC || pOutputCol->info.type != TSDB_DATA_TYPE_DOUBLE ||
+      !IS_MATHABLE_TYPE(pLeftCol->info.type) || !IS_MATHABLE_TYPE(pRightCol->info.type)) {
+    return false;
+  }
+
+  if (leftRows != rightRows && leftRows != 1 && rightRows != 1) {
+    return false;
+  }
+
+  int32_t numOfRows = TMAX(leftRows, rightRows);
+  bool    leftScalar = (leftRows == 1 && numOfRows > 1);
+  bool    rightScalar = (rightRows == 1 && numOfRows > 1);
+  double  lv = 0, rv = 0;
+
+  if ((leftScalar && colDataIsNull_s(pLeftCol, 0)) || (rightScalar && colDataIsNull_s(pRightCol, 0))) {
+    colDataSetNNULL(pOutputCol, 0, numOfRows);
+    return true;
+  }
+
+  if (leftScalar) {
+    vectorLoadDouble(pLeftCol, 0, 1, &lv);
+  }
+  if (rightScalar) {
+    vectorLoadDouble(pRightCol, 0, 1, &rv);
+    if ((optr == OP_TYPE_DIV && rv == 0) || (optr == OP_TYPE_REM && FLT_EQUAL(rv, 0))) {  // divide by 0 check
+      colDataSetNNULL(pOutputCol, 0, numOfRows);
+      return true;
+    }
+  }
+
+  double *output = (double *)pOutputCol->pData;
+  double  rBuf[VECTOR_KERNEL_CHUNK];
+
+  for (int32_t start = 0; start < numOfRows; start += VECTOR_KERNEL_CHUNK) {
+    int32_t n = TMIN(VECTOR_KERNEL_CHUNK, numOfRows - start);
+    double *pOut = output + start;
+
+    if (leftScalar) {
+      for (int32_t k = 0; k < n; ++k) {
+        pOut[k] = lv;
+      }
+    } else {
+      vectorLoadDouble(pLeftCol, start, n, pOut);
+    }
+
+    if (rightScalar) {
+      for (int32_t k = 0; k < n; ++k) {
+        rBuf[k] = rv;
+      }
+    } else {
+      vectorLoadDouble(pRightCol, start, n, rBuf);
+    }
+
+    switch (optr) {
+      case OP_TYPE_ADD:
+        for (int32_t k = 0; k < n; ++k) {
+          pOut[k] += rBuf[k];
+        }
+        break;
+      case OP_TYPE_SUB:
+        for (int32_t k = 0; k < n; ++k) {
+          pOut[k] -= rBuf[k];
+        }
+        break;
+      case OP_TYPE_MULTI:
+        for (int32_t k = 0; k < n; ++k) {
+          pOut[k] *= rBuf[k];
+        }
+        break;
+      case OP_TYPE_DIV:
+        for (int32_t k = 0; k < n; ++k) {
+          if (rBuf[k] == 0) {  // divide by 0 check
+            colDataSetNULL(pOutputCol, start + k);
+          } else {
+            pOut[k] /= rBuf[k];
+          }
+        }
+        break;
+      case OP_TYPE_REM:
+        for (int32_t k = 0; k < n; ++k) {
+          double lx = pOut[k];
+          double rx = rBuf[k];
+          if (isnan(lx) || isinf(lx) || isnan(rx) || isinf(rx) || FLT_EQUAL(rx, 0)) {
+            colDataSetNULL(pOutputCol, start + k);
+          } else {
+            pOut[k] = lx - ((int64_t)(lx / rx)) * rx;
+          }
+        }
+        break;
+      default:
+        ASSERT(0);
+    }
+  }
+
+  if (!leftScalar) {
+    vectorMergeNullBitmap(pOutputCol, pLeftCol, numOfRows);
+  }
+  if (!rightScalar) {
+    vectorMergeNullBitmap(pOutputCol, pRightCol, numOfRows);
+  }
+
+  if (pOutputCol->hasNull) {
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      if (colDataIsNull_f(pOutputCol->nullbitmap, i)) {
+        output[i] = 0;
+      }
+    }
+  }
+
+  return true;
+}
+
+#define VECTOR_COMPARE_LOOP(_type, _l, _r, _res, _n, _optr) \
+  do {                                                     \
+    const _type *_pl = (const _type *)(_l);                \
+    const _type *_pr = (const _type *)(_r);                \
+    switch (_optr) {                                       \
+      case OP_TYPE_GREATER_THAN:                           \
+        for (int32_t _k = 0; _k < (_n); ++_k) (_res)[_k] = (_pl[_k] > _pr[_k]);  \
+        break;                                             \
+      case OP_TYPE_GREATER_EQUAL:                          \
+        for (int32_t _k = 0; _k < (_n); ++_k) (_res)[_k] = (_pl[_k] >= _pr[_k]); \
+        break;                                             \
+      case OP_TYPE_LOWER_THAN:                             \
+        for (int32_t _k = 0; _k < (_n); ++_k) (_res)[_k] = (_pl[_k] < _pr[_k]);  \
+        break;                                             \
+      case OP_TYPE_LOWER_EQUAL:                            \
+        for (int32_t _k = 0; _k < (_n); ++_k) (_res)[_k] = (_pl[_k] <= _pr[_k]); \
+        break;                                             \
+      case OP_TYPE_EQUAL:                                  \
+        for (int32_t _k = 0; _k < (_n); ++_k) (_res)[_k] = (_pl[_k] == _pr[_k]); \
+        break;                                             \
+      default:                                             \
+        for (int32_t _k = 0; _k < (_n); ++_k) (_res)[_k] = (_pl[_k] != _pr[_k]); \
+        break;                                             \
+    }                                                      \
+  } while (0)
+
+#define IS_SIGNED_COMPARE_TYPE(_t) (IS_SIGNED_NUMERIC_TYPE(_t) || (_t) == TSDB_DATA_TYPE_TIMESTAMP)
+
+// Compare two integer columns of the same signedness, widened to 64 bits. The float types are left to the compare
+// functions, which treat the values within a tolerance as equal.
+static bool vectorCompareIntKernel(SScalarParam *pLeft, SScalarParam *pRight, bool *pRes, int32_t startIndex,
+                                   int32_t numOfRows, int32_t step, int32_t optr, int32_t *num) {
+  int32_t          lType = GET_PARAM_TYPE(pLeft);
+  int32_t          rType = GET_PARAM_TYPE(pRight);
+  SColumnInfoData *pLeftCol = pLeft->columnData;
+  SColumnInfoData *pRightCol = pRight->columnData;
+
+  if (step != 1 || startIndex < 0 || optr < OP_TYPE_GREATER_THAN || optr > OP_TYPE_NOT_EQUAL) {
+    return false;
+  }
+
+  bool isSigned = IS_SIGNED_COMPARE_TYPE(lType) && IS_SIGNED_COMPARE_TYPE(rType);
+  if (!isSigned && !(IS_UNSIGNED_NUMERIC_TYPE(lType) && IS_UNSIGNED_NUMERIC_TYPE(rType))) {
+    return false;
+  }
+
+  bool leftScalar = (pLeft->numOfRows == 1);
+  bool rightScalar = (pRight->numOfRows == 1);
+  if ((!leftScalar && pLeft->numOfRows < numOfRows) || (!rightScalar && pRight->numOfRows < numOfRows)) {
+    return false;
+  }
+
+  if ((leftScalar && colDataIsNull_s(pLeftCol, 0)) || (rightScalar && colDataIsNull_s(pRightCol, 0))) {
+    memset(pRes + startIndex, 0, numOfRows - startIndex);
+    *num = 0;
+    return true;
+  }
+
+  int64_t lv = 0, rv = 0;
+  int64_t lBuf[VECTOR_KERNEL_CHUNK];
+  int64_t rBuf[VECTOR_KERNEL_CHUNK];
+  if (leftScalar) {
+    vectorLoadBigint(pLeftCol, 0, 1, &lv);
+  }
+  if (rightScalar) {
+    vectorLoadBigint(pRightCol, 0, 1, &rv);
+  }
+
+  for (int32_t start = startIndex; start < numOfRows; start += VECTOR_KERNEL_CHUNK) {
+    int32_t n = TMIN(VECTOR_KERNEL_CHUNK, numOfRows - start);
+
+    if (leftScalar) {
+      for (int32_t k = 0; k < n; ++k) {
+        lBuf[k] = lv;
+      }
+    } else {
+      vectorLoadBigint(pLeftCol, start, n, lBuf);
+    }
+
+    if (rightScalar) {
+      for (int32_t k = 0; k < n; ++k) {
+        rBuf[k] = rv;
+      }
+    } else {
+      vectorLoadBigint(pRightCol, start, n, rBuf);
+    }
+
+    if (isSigned) {
+      VECTOR_COMPARE_LOOP(int64_t, lBuf, rBuf, pRes + start, n, optr);
+    } else {
+      VECTOR_COMPARE_LOOP(uint64_t, lBuf, rBuf, pRes + start, n, optr);
+    }
+  }
+
+  if (!leftScalar && pLeftCol->hasNull && pLeftCol->nullbitmap != NULL) {
+    for (int32_t i = startIndex; i < numOfRows; ++i) {
+      if (colDataIsNull_f(pLeftCol->nullbitmap, i)) {
+        pRes[i] = false;
+      }
+    }
+  }
+  if (!rightScalar && pRightCol->hasNull && pRightCol->nullbitmap != NULL) {
+    for (int32_t i = startIndex; i < numOfRows; ++i) {
+      if (colDataIsNull_f(pRightCol->nullbitmap, i)) {
+        pRes[i] = false;
+      }
+    }
+  }
+
+  int32_t count = 0;
+  for (int32_t i = startIndex; i < numOfRows; ++i) {
+    count += pRes[i];
+  }
+  *num = count;
+  return true;
+}
+
 // TODO not correct for descending order scan
 static void vectorMathAddHelper(SColumnInfoData *pLeftCol, SColumnInfoData *pRightCol, SColumnInfoData *pOutputCol,
                                 int32_t numOfRows, int32_t step, int32_t i) {
@@ -1110,7 +1416,8 @@ void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) + getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     }
-  } else {
+  } else if (!vectorMathDoubleKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, _ord,
+                                     OP_TYPE_ADD)) {
     double              *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1211,7 +1518,8 @@ void vectorMathSub(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) - getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     }
-  } else {
+  } else if (!vectorMathDoubleKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, _ord,
+                                     OP_TYPE_SUB)) {
     double              *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1267,6 +1575,12 @@ void vectorMathMultiply(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam
   SColumnInfoData *pLeftCol = vectorConvertVarToDouble(pLeft, &leftConvert);
   SColumnInfoData *pRightCol = vectorConvertVarToDouble(pRight, &rightConvert);
 
+  if (vectorMathDoubleKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, _ord, OP_TYPE_MULTI)) {
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1300,6 +1614,12 @@ void vectorMathDivide(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *p
   SColumnInfoData *pLeftCol = vectorConvertVarToDouble(pLeft, &leftConvert);
   SColumnInfoData *pRightCol = vectorConvertVarToDouble(pRight, &rightConvert);
 
+  if (vectorMathDoubleKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, _ord, OP_TYPE_DIV)) {
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1354,6 +1674,12 @@ void vectorMathRemainder(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam
   SColumnInfoData *pLeftCol = vectorConvertVarToDouble(pLeft, &leftConvert);
   SColumnInfoData *pRightCol = vectorConvertVarToDouble(pRight, &rightConvert);
 
+  if (vectorMathDoubleKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, _ord, OP_TYPE_REM)) {
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1576,6 +1902,10 @@ int32_t doVectorCompareImpl(SScalarParam *pLeft, SScalarParam *pRight, SScalarPa
   int32_t num = 0;
   bool   *pRes = (bool *)pOut->columnData->pData;
 
+  if (vectorCompareIntKernel(pLeft, pRight, pRes, startIndex, numOfRows, step, optr, &num)) {
+    return num;
+  }
+
   if (IS_MATHABLE_TYPE(GET_PARAM_TYPE(pLeft)) && IS_MATHABLE_TYPE(GET_PARAM_TYPE(pRight))) {
     if (!(pLeft->columnData->hasNull || pRight->columnData->hasNull)) {
       for (int32_t i = startIndex; i < numOfRows && i >= 0; i += step) {
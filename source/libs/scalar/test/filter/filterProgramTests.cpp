@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The filters of several units are compiled into a program. Each case evaluates a filter by its program and row by
+// row over random blocks with nulls, and checks that both give the same rows.
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "filter.h"
+#include "filterInt.h"
+#include "nodes.h"
+#include "tdatablock.h"
+
+namespace {
+
+enum {
+  FLTT_SLOT_TS = 0,
+  FLTT_SLOT_I8,
+  FLTT_SLOT_I16,
+  FLTT_SLOT_I32,
+  FLTT_SLOT_I64,
+  FLTT_SLOT_U8,
+  FLTT_SLOT_U16,
+  FLTT_SLOT_U32,
+  FLTT_SLOT_U64,
+  FLTT_SLOT_DOUBLE,
+  FLTT_SLOT_BINARY,
+  FLTT_SLOT_BOOL,
+  FLTT_SLOT_NUM,
+};
+
+const int32_t flttTypes[FLTT_SLOT_NUM] = {
+    TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+    TSDB_DATA_TYPE_BIGINT,    TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_UINT,
+    TSDB_DATA_TYPE_UBIGINT,   TSDB_DATA_TYPE_DOUBLE,   TSDB_DATA_TYPE_BINARY,   TSDB_DATA_TYPE_BOOL,
+};
+
+const int32_t FLTT_BINARY_LEN = 16;
+const int64_t FLTT_START_TS = 1640966400000;
+
+int32_t flttBytes(int32_t slot) {
+  if (slot == FLTT_SLOT_BINARY) return FLTT_BINARY_LEN + VARSTR_HEADER_SIZE;
+  return tDataTypes[flttTypes[slot]].bytes;
+}
+
+// values spread over a few hundred around the constants the cases compare with, the unsigned ones next to the max
+// of their type, so that they do not fit the signed type of the same size
+SSDataBlock *flttMakeRandBlock(int32_t rows, int32_t nullRate) {
+  SSDataBlock *pBlock = createDataBlock();
+  for (int32_t slot = 0; slot < FLTT_SLOT_NUM; ++slot) {
+    SColumnInfoData col = createColumnInfoData(flttTypes[slot], flttBytes(slot), slot + 1);
+    blockDataAppendColInfo(pBlock, &col);
+  }
+  blockDataEnsureCapacity(pBlock, rows);
+
+  for (int32_t slot = 0; slot < FLTT_SLOT_NUM; ++slot) {
+    SColumnInfoData *pCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, slot);
+    for (int32_t i = 0; i < rows; ++i) {
+      char    buf[FLTT_BINARY_LEN + VARSTR_HEADER_SIZE] = {0};
+      int32_t r = taosRand() % 200 - 100;
+      bool    isNull = slot != FLTT_SLOT_TS && nullRate > 0 && taosRand() % 100 < nullRate;
+
+      switch (slot) {
+        case FLTT_SLOT_TS:
+          *(int64_t *)buf = FLTT_START_TS + i;
+          break;
+        case FLTT_SLOT_I8:
+          *(int8_t *)buf = (int8_t)(r / 10);
+          break;
+        case FLTT_SLOT_I16:
+          *(int16_t *)buf = (int16_t)r;
+          break;
+        case FLTT_SLOT_I32:
+          *(int32_t *)buf = r;
+          break;
+        case FLTT_SLOT_I64:
+          *(int64_t *)buf = (int64_t)r * 1000000000;
+          break;
+        case FLTT_SLOT_U8:
+          *(uint8_t *)buf = (uint8_t)(r + 100);
+          break;
+        case FLTT_SLOT_U16:
+          *(uint16_t *)buf = (uint16_t)(UINT16_MAX - 100 - r);
+          break;
+        case FLTT_SLOT_U32:
+          *(uint32_t *)buf = (uint32_t)(UINT32_MAX - 100 - r);
+          break;
+        case FLTT_SLOT_U64:
+          *(uint64_t *)buf = UINT64_MAX - 100 - r;
+          break;
+        case FLTT_SLOT_DOUBLE:
+          *(double *)buf = r / 4.0;
+          break;
+        case FLTT_SLOT_BINARY:
+          varDataSetLen(buf, sprintf(varDataVal(buf), "v%d", (r + 100) % 20));
+          break;
+        case FLTT_SLOT_BOOL:
+          *(int8_t *)buf = (r & 1);
+          break;
+      }
+
+      colDataSetVal(pCol, i, buf, isNull);
+    }
+  }
+
+  pBlock->info.rows = rows;
+  return pBlock;
+}
+
+SNode *flttCol(int32_t slot) {
+  SColumnNode *pCol = (SColumnNode *)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = flttTypes[slot];
+  pCol->node.resType.bytes = flttBytes(slot);
+  pCol->dataBlockId = 0;
+  pCol->slotId = slot;
+  pCol->colId = slot + 1;
+  sprintf(pCol->colName, "c%d", slot);
+  return (SNode *)pCol;
+}
+
+SNode *flttVal(int32_t type, const void *value) {
+  SValueNode *pVal = (SValueNode *)nodesMakeNode(QUERY_NODE_VALUE);
+  pVal->node.resType.type = type;
+
+  if (IS_VAR_DATA_TYPE(type)) {
+    pVal->datum.p = (char *)taosMemoryMalloc(varDataTLen(value));
+    varDataCopy(pVal->datum.p, value);
+    pVal->node.resType.bytes = varDataLen(value);
+  } else {
+    pVal->node.resType.bytes = tDataTypes[type].bytes;
+    assignVal((char *)nodesGetValueFromNode(pVal), (const char *)value, 0, type);
+  }
+
+  return (SNode *)pVal;
+}
+
+template <typename T>
+SNode *flttOp(EOperatorType opType, int32_t slot, T value) {
+  SOperatorNode *pOp = (SOperatorNode *)nodesMakeNode(QUERY_NODE_OPERATOR);
+  pOp->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pOp->node.resType.bytes = sizeof(bool);
+  pOp->opType = opType;
+  pOp->pLeft = flttCol(slot);
+  pOp->pRight = flttVal(flttTypes[slot], &value);
+  return (SNode *)pOp;
+}
+
+SNode *flttStrOp(EOperatorType opType, int32_t slot, const char *str) {
+  char buf[FLTT_BINARY_LEN + VARSTR_HEADER_SIZE] = {0};
+  varDataSetLen(buf, sprintf(varDataVal(buf), "%s", str));
+
+  SOperatorNode *pOp = (SOperatorNode *)nodesMakeNode(QUERY_NODE_OPERATOR);
+  pOp->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pOp->node.resType.bytes = sizeof(bool);
+  pOp->opType = opType;
+  pOp->pLeft = flttCol(slot);
+  pOp->pRight = flttVal(TSDB_DATA_TYPE_BINARY, buf);
+  return (SNode *)pOp;
+}
+
+SNode *flttNullOp(EOperatorType opType, int32_t slot) {
+  SOperatorNode *pOp = (SOperatorNode *)nodesMakeNode(QUERY_NODE_OPERATOR);
+  pOp->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pOp->node.resType.bytes = sizeof(bool);
+  pOp->opType = opType;
+  pOp->pLeft = flttCol(slot);
+  return (SNode *)pOp;
+}
+
+SNode *flttLogic(ELogicConditionType condType, std::vector<SNode *> nodes) {
+  SLogicConditionNode *pLogic = (SLogicConditionNode *)nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+  pLogic->condType = condType;
+  pLogic->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pLogic->node.resType.bytes = sizeof(bool);
+  pLogic->pParameterList = nodesMakeList();
+  for (SNode *pNode : nodes) {
+    nodesListAppend(pLogic->pParameterList, pNode);
+  }
+  return (SNode *)pLogic;
+}
+
+SNode *flttAnd(std::vector<SNode *> nodes) { return flttLogic(LOGIC_COND_TYPE_AND, nodes); }
+SNode *flttOr(std::vector<SNode *> nodes) { return flttLogic(LOGIC_COND_TYPE_OR, nodes); }
+
+std::vector<int8_t> flttExecute(SFilterInfo *filter, SSDataBlock *pBlock, filter_exec_func func, int32_t *pStatus) {
+  SFilterColumnParam param = {(int32_t)taosArrayGetSize(pBlock->pDataBlock), pBlock->pDataBlock};
+  EXPECT_EQ(filterSetDataFromSlotId(filter, &param), 0);
+
+  filter_exec_func prev = filter->func;
+  filter->func = func;
+
+  SColumnInfoData *pRes = NULL;
+  filterExecute(filter, pBlock, &pRes, NULL, FLTT_SLOT_NUM, pStatus);
+  filter->func = prev;
+
+  std::vector<int8_t> res;
+  if (pRes != NULL) {
+    res.assign((int8_t *)pRes->pData, (int8_t *)pRes->pData + pBlock->info.rows);
+    colDataDestroy(pRes);
+    taosMemoryFree(pRes);
+  }
+  return res;
+}
+
+std::vector<uint32_t> flttProgramOrder(SFilterProgram *prog) {
+  std::vector<uint32_t> order;
+  for (uint32_t g = 0; g < prog->groupNum; ++g) {
+    for (uint32_t u = 0; u < prog->groups[g].unitNum; ++u) {
+      order.push_back(prog->groups[g].units[u].uidx);
+    }
+  }
+  return order;
+}
+
+// evaluate the filter over blocks of different sizes and null rates, by its program and row by row
+void flttCheckProgram(SNode *pCond) {
+  SFilterInfo *filter = NULL;
+  ASSERT_EQ(filterInitFromNode(pCond, &filter, 0), 0);
+  ASSERT_FALSE(filter->scalarMode);
+  ASSERT_NE(filter->program, nullptr);
+  ASSERT_EQ(filter->func, (filter_exec_func)filterExecuteImplProgram);
+
+  std::vector<uint32_t> order = flttProgramOrder(filter->program);
+  const int32_t         rows[] = {1, 7, 64, 1000, 4096};
+  const int32_t         nullRates[] = {0, 10, 50, 100};
+  int64_t               numOfQualified = 0;
+
+  for (int32_t r : rows) {
+    for (int32_t nullRate : nullRates) {
+      SSDataBlock *pBlock = flttMakeRandBlock(r, nullRate);
+
+      int32_t             progStatus = 0, rowStatus = 0;
+      std::vector<int8_t> progRes = flttExecute(filter, pBlock, filterExecuteImplProgram, &progStatus);
+      std::vector<int8_t> rowRes = flttExecute(filter, pBlock, filterExecuteImpl, &rowStatus);
+      ASSERT_EQ(progRes.size(), (size_t)r);
+      ASSERT_EQ(progStatus, rowStatus) << "rows:" << r << " null rate:" << nullRate;
+      for (int32_t i = 0; i < r; ++i) {
+        ASSERT_EQ(progRes[i], rowRes[i]) << "row:" << i << " of " << r << " null rate:" << nullRate;
+        numOfQualified += progRes[i];
+      }
+
+      blockDataDestroy(pBlock);
+    }
+  }
+
+  // the program is not changed by executing it
+  ASSERT_EQ(flttProgramOrder(filter->program), order);
+
+  filterFreeInfo(filter);
+  nodesDestroyNode(pCond);
+}
+
+}  // namespace
+
+TEST(filterProgramTest, unsigned_columns) {
+  flttCheckProgram(flttAnd({flttOp<uint8_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_U8, 100),
+                            flttOp<uint16_t>(OP_TYPE_LOWER_EQUAL, FLTT_SLOT_U16, UINT16_MAX - 80),
+                            flttOp<uint32_t>(OP_TYPE_LOWER_THAN, FLTT_SLOT_U32, UINT32_MAX - 20),
+                            flttOp<uint64_t>(OP_TYPE_GREATER_EQUAL, FLTT_SLOT_U64, UINT64_MAX - 150)}));
+
+  flttCheckProgram(flttOr({flttOp<uint64_t>(OP_TYPE_LOWER_THAN, FLTT_SLOT_U64, UINT64_MAX - 190),
+                           flttOp<uint32_t>(OP_TYPE_EQUAL, FLTT_SLOT_U32, UINT32_MAX - 3),
+                           flttOp<uint16_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_U16, UINT16_MAX - 10)}));
+}
+
+TEST(filterProgramTest, ranges) {
+  // both bounds of a column merge into a range unit
+  flttCheckProgram(flttAnd({flttOp<int32_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_I32, -20),
+                            flttOp<int32_t>(OP_TYPE_LOWER_EQUAL, FLTT_SLOT_I32, 30),
+                            flttOp<int64_t>(OP_TYPE_GREATER_EQUAL, FLTT_SLOT_I64, -50000000000LL),
+                            flttOp<int64_t>(OP_TYPE_LOWER_THAN, FLTT_SLOT_I64, 50000000000LL),
+                            flttOp<int64_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_TS, FLTT_START_TS + 3)}));
+
+  flttCheckProgram(flttAnd({flttOp<int16_t>(OP_TYPE_GREATER_EQUAL, FLTT_SLOT_I16, -60),
+                            flttOp<int16_t>(OP_TYPE_LOWER_EQUAL, FLTT_SLOT_I16, -10),
+                            flttOp<int8_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_I8, -5),
+                            flttOp<int8_t>(OP_TYPE_LOWER_THAN, FLTT_SLOT_I8, 5),
+                            flttOp<double>(OP_TYPE_GREATER_THAN, FLTT_SLOT_DOUBLE, -10.25),
+                            flttOp<double>(OP_TYPE_LOWER_EQUAL, FLTT_SLOT_DOUBLE, 12.5)}));
+}
+
+TEST(filterProgramTest, nulls) {
+  flttCheckProgram(flttAnd({flttNullOp(OP_TYPE_IS_NOT_NULL, FLTT_SLOT_I16),
+                            flttOp<int32_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_I32, 0),
+                            flttOp<int8_t>(OP_TYPE_EQUAL, FLTT_SLOT_BOOL, 1)}));
+
+  flttCheckProgram(flttOr({flttAnd({flttNullOp(OP_TYPE_IS_NULL, FLTT_SLOT_I64),
+                                    flttOp<double>(OP_TYPE_LOWER_THAN, FLTT_SLOT_DOUBLE, 0.5)}),
+                           flttAnd({flttNullOp(OP_TYPE_IS_NULL, FLTT_SLOT_BINARY),
+                                    flttNullOp(OP_TYPE_IS_NOT_NULL, FLTT_SLOT_U64)}),
+                           flttOp<int32_t>(OP_TYPE_GREATER_EQUAL, FLTT_SLOT_I32, 5)}));
+}
+
+TEST(filterProgramTest, or_groups) {
+  flttCheckProgram(flttOr({flttAnd({flttOp<int8_t>(OP_TYPE_EQUAL, FLTT_SLOT_I8, 3),
+                                    flttOp<int32_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_I32, 0)}),
+                           flttOp<int16_t>(OP_TYPE_LOWER_THAN, FLTT_SLOT_I16, -50),
+                           flttAnd({flttStrOp(OP_TYPE_EQUAL, FLTT_SLOT_BINARY, "v3"),
+                                    flttOp<double>(OP_TYPE_GREATER_THAN, FLTT_SLOT_DOUBLE, 10.0)}),
+                           flttAnd({flttStrOp(OP_TYPE_LIKE, FLTT_SLOT_BINARY, "v1%"),
+                                    flttOp<uint8_t>(OP_TYPE_LOWER_EQUAL, FLTT_SLOT_U8, 20)})}));
+
+  // groups that select every row, and groups that select none
+  flttCheckProgram(flttOr({flttOp<int64_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_TS, FLTT_START_TS - 1),
+                           flttAnd({flttOp<int32_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_I32, 1000),
+                                    flttOp<int16_t>(OP_TYPE_EQUAL, FLTT_SLOT_I16, 3)})}));
+}
+
+TEST(filterProgramTest, reordering) {
+  // the units start in the order of their estimated selectivity, which here is the opposite of the one in the filter
+  SNode *pCond = flttAnd({flttStrOp(OP_TYPE_LIKE, FLTT_SLOT_BINARY, "v1%"),
+                          flttOp<double>(OP_TYPE_GREATER_THAN, FLTT_SLOT_DOUBLE, -20.0),
+                          flttNullOp(OP_TYPE_IS_NOT_NULL, FLTT_SLOT_I8),
+                          flttOp<int32_t>(OP_TYPE_LOWER_THAN, FLTT_SLOT_I32, 70),
+                          flttOp<int64_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_I64, -20000000000LL),
+                          flttOp<int16_t>(OP_TYPE_EQUAL, FLTT_SLOT_I16, 3)});
+
+  SFilterInfo *filter = NULL;
+  ASSERT_EQ(filterInitFromNode(pCond, &filter, 0), 0);
+  ASSERT_FALSE(filter->scalarMode);
+  ASSERT_NE(filter->program, nullptr);
+  ASSERT_EQ(filter->program->groupNum, 1);
+
+  // the equal ahead of the range ones, the like last
+  SFilterProgGroup *pg = &filter->program->groups[0];
+  for (uint32_t u = 1; u < pg->unitNum; ++u) {
+    ASSERT_LE(pg->units[u - 1].rank, pg->units[u].rank);
+  }
+  ASSERT_EQ(filter->cunits[pg->units[0].uidx].optr, OP_TYPE_EQUAL);
+
+  filterFreeInfo(filter);
+  flttCheckProgram(pCond);
+}
+
+TEST(filterProgramTest, concurrent_execute) {
+  // a filter info executed by several operators on the same block at the same time
+  SNode *pCond = flttOr({flttAnd({flttOp<int32_t>(OP_TYPE_GREATER_THAN, FLTT_SLOT_I32, -30),
+                                  flttOp<uint64_t>(OP_TYPE_LOWER_EQUAL, FLTT_SLOT_U64, UINT64_MAX - 20),
+                                  flttStrOp(OP_TYPE_LIKE, FLTT_SLOT_BINARY, "v1%")}),
+                         flttAnd({flttNullOp(OP_TYPE_IS_NULL, FLTT_SLOT_I16),
+                                  flttOp<double>(OP_TYPE_GREATER_EQUAL, FLTT_SLOT_DOUBLE, 0.0)})});
+
+  SFilterInfo *filter = NULL;
+  ASSERT_EQ(filterInitFromNode(pCond, &filter, 0), 0);
+  ASSERT_FALSE(filter->scalarMode);
+  ASSERT_NE(filter->program, nullptr);
+
+  SSDataBlock       *pBlock = flttMakeRandBlock(4096, 20);
+  int32_t            status = 0;
+  std::vector<int8_t> expected = flttExecute(filter, pBlock, filterExecuteImpl, &status);
+
+  std::vector<std::thread> threads;
+  std::vector<int32_t>     numOfDiffs(4, 0);
+  for (int32_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int32_t l = 0; l < 200; ++l) {
+        SColumnInfoData *pRes = NULL;
+        int32_t          resStatus = 0;
+        filterExecute(filter, pBlock, &pRes, NULL, FLTT_SLOT_NUM, &resStatus);
+        if (pRes == NULL || memcmp(pRes->pData, expected.data(), expected.size()) != 0) {
+          numOfDiffs[t]++;
+        }
+        if (pRes != NULL) {
+          colDataDestroy(pRes);
+          taosMemoryFree(pRes);
+        }
+      }
+    });
+  }
+  for (auto &t : threads) t.join();
+
+  for (int32_t t = 0; t < 4; ++t) {
+    ASSERT_EQ(numOfDiffs[t], 0);
+  }
+
+  blockDataDestroy(pBlock);
+  filterFreeInfo(filter);
+  nodesDestroyNode(pCond);
+}
+
+#pragma GCC diagnostic pop
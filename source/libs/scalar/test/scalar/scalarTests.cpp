@@ -1679,6 +1679,75 @@ TEST(columnTest, smallint_column_greater_double_value) {
   nodesDestroyNode(opNode);
 }
 
+TEST(columnTest, bigint_column_divide_int_column) {
+  SNode       *pLeft = NULL, *pRight = NULL, *opNode = NULL;
+  int64_t      leftv[5] = {10, 9, -8, 7, 6000000000};
+  int32_t      rightv[5] = {2, 0, 4, -7, 3};
+  double       eRes[5] = {5, 0, -2, -1, 2000000000};
+  bool         eNull[5] = {false, true, false, false, false};
+  SSDataBlock *src = NULL;
+  int32_t      rowNum = sizeof(leftv) / sizeof(leftv[0]);
+  scltMakeColumnNode(&pLeft, &src, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), rowNum, leftv);
+  scltMakeColumnNode(&pRight, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, rightv);
+  scltMakeOpNode(&opNode, OP_TYPE_DIV, TSDB_DATA_TYPE_DOUBLE, pLeft, pRight);
+
+  SArray *blockList = taosArrayInit(1, POINTER_BYTES);
+  taosArrayPush(blockList, &src);
+
+  SColumnInfo colInfo = createColumnInfo(1, TSDB_DATA_TYPE_DOUBLE, sizeof(double));
+  int16_t     dataBlockId = 0, slotId = 0;
+  scltAppendReservedSlot(blockList, &dataBlockId, &slotId, false, rowNum, &colInfo);
+  scltMakeTargetNode(&opNode, dataBlockId, slotId, opNode);
+
+  int32_t code = scalarCalculate(opNode, blockList, NULL);
+  ASSERT_EQ(code, 0);
+
+  SSDataBlock *res = *(SSDataBlock **)taosArrayGetLast(blockList);
+  ASSERT_EQ(res->info.rows, rowNum);
+  SColumnInfoData *column = (SColumnInfoData *)taosArrayGetLast(res->pDataBlock);
+  ASSERT_EQ(column->info.type, TSDB_DATA_TYPE_DOUBLE);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(colDataIsNull_s(column, i), eNull[i]);
+    if (!eNull[i]) {
+      ASSERT_EQ(*((double *)colDataGetData(column, i)), eRes[i]);
+    }
+  }
+  taosArrayDestroyEx(blockList, scltFreeDataBlock);
+  nodesDestroyNode(opNode);
+}
+
+TEST(columnTest, bigint_column_greater_int_value) {
+  SNode       *pLeft = NULL, *pRight = NULL, *opNode = NULL;
+  int64_t      leftv[5] = {1, 2, 3, 4, 5};
+  int32_t      rightv = 3;
+  bool         eRes[5] = {false, false, false, true, true};
+  SSDataBlock *src = NULL;
+  int32_t      rowNum = sizeof(leftv) / sizeof(leftv[0]);
+  scltMakeColumnNode(&pLeft, &src, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), rowNum, leftv);
+  scltMakeValueNode(&pRight, TSDB_DATA_TYPE_INT, &rightv);
+  scltMakeOpNode(&opNode, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+
+  SArray *blockList = taosArrayInit(1, POINTER_BYTES);
+  taosArrayPush(blockList, &src);
+  SColumnInfo colInfo = createColumnInfo(1, TSDB_DATA_TYPE_BOOL, sizeof(bool));
+  int16_t     dataBlockId = 0, slotId = 0;
+  scltAppendReservedSlot(blockList, &dataBlockId, &slotId, true, rowNum, &colInfo);
+  scltMakeTargetNode(&opNode, dataBlockId, slotId, opNode);
+
+  int32_t code = scalarCalculate(opNode, blockList, NULL);
+  ASSERT_EQ(code, 0);
+
+  SSDataBlock *res = *(SSDataBlock **)taosArrayGetLast(blockList);
+  ASSERT_EQ(res->info.rows, rowNum);
+  SColumnInfoData *column = (SColumnInfoData *)taosArrayGetLast(res->pDataBlock);
+  ASSERT_EQ(column->info.type, TSDB_DATA_TYPE_BOOL);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(*((bool *)colDataGetData(column, i)), eRes[i]);
+  }
+  taosArrayDestroyEx(blockList, scltFreeDataBlock);
+  nodesDestroyNode(opNode);
+}
+
 TEST(columnTest, int_column_in_double_list) {
   SNode       *pLeft = NULL, *pRight = NULL, *listNode = NULL, *opNode = NULL;
   int32_t      leftv[5] = {1, 2, 3, 4, 5};
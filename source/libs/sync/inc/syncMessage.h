@@ -98,7 +98,10 @@ typedef struct SyncAppendEntries {
   SyncTerm  prevLogTerm;
   SyncIndex commitIndex;
   SyncTerm  privateTerm;
-  int16_t   reserved;
+  // raft entries packed back to back in data, 0 from older senders means one. in the reserved field of older
+  // versions, which take the msg for a single entry, so more than one is only sent to peers whose replies carry
+  // numOfEntries
+  int16_t   numOfEntries;
   uint32_t  dataLen;
   char      data[];
 } SyncAppendEntries;
@@ -116,7 +119,7 @@ typedef struct SyncAppendEntriesReply {
   SyncIndex matchIndex;
   SyncIndex lastSendIndex;
   int64_t   startTime;
-  int16_t   reserved;
+  int16_t   numOfEntries;  // entries of the request acked, ending at lastSendIndex. 0 from older versions
 } SyncAppendEntriesReply;
 
 typedef struct SyncHeartbeat {
@@ -258,8 +261,8 @@ int32_t syncBuildRequestVote(SRpcMsg* pMsg, int32_t vgId);
 int32_t syncBuildRequestVoteReply(SRpcMsg* pMsg, int32_t vgId);
 int32_t syncBuildAppendEntries(SRpcMsg* pMsg, int32_t dataLen, int32_t vgId);
 int32_t syncBuildAppendEntriesReply(SRpcMsg* pMsg, int32_t vgId);
-int32_t syncBuildAppendEntriesFromRaftEntry(SSyncNode* pNode, SSyncRaftEntry* pEntry, SyncTerm prevLogTerm,
-                                            SRpcMsg* pRpcMsg);
+int32_t syncBuildAppendEntriesFromRaftEntries(SSyncNode* pNode, SSyncRaftEntry** aEntry, int32_t nEntry,
+                                              SyncTerm prevLogTerm, SRpcMsg* pRpcMsg);
 int32_t syncBuildHeartbeat(SRpcMsg* pMsg, int32_t vgId);
 int32_t syncBuildHeartbeatReply(SRpcMsg* pMsg, int32_t vgId);
 int32_t syncBuildPreSnapshot(SRpcMsg* pMsg, int32_t vgId);
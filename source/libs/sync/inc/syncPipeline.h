@@ -37,6 +37,7 @@ typedef struct SSyncLogReplMgr {
   int64_t       size;
   bool          restored;
   int64_t       peerStartTime;
+  bool          peerBatch;  // the peer acks the number of entries, so it accepts batches of them
   int32_t       retryBackoff;
   int32_t       peerId;
 } SSyncLogReplMgr;
@@ -82,8 +83,8 @@ int32_t syncLogReplAttempt(SSyncLogReplMgr* pMgr, SSyncNode* pNode);
 int32_t syncLogReplProbe(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex index);
 
 int32_t syncLogReplRetryOnNeed(SSyncLogReplMgr* pMgr, SSyncNode* pNode);
-int32_t syncLogReplSendTo(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex index, SyncTerm* pTerm, SRaftId* pDestId,
-                          bool* pBarrier);
+int32_t syncLogReplSendTo(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex index, int32_t nMax, SyncTerm* aTerm,
+                          int32_t* pCount, SRaftId* pDestId, bool* pBarrier);
 
 int32_t syncLogReplProcessReply(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncAppendEntriesReply* pMsg);
 int32_t syncLogReplProcessReplyAsRecovery(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncAppendEntriesReply* pMsg);
@@ -103,8 +104,10 @@ SyncTerm syncLogBufferGetLastMatchTerm(SSyncLogBuffer* pBuf);
 bool     syncLogBufferIsEmpty(SSyncLogBuffer* pBuf);
 
 int32_t syncLogBufferAppend(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry* pEntry);
-int32_t syncLogBufferAccept(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry* pEntry, SyncTerm prevTerm);
+int32_t syncLogBufferAcceptBatch(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry** aEntry, int32_t nEntry,
+                                 SyncTerm prevTerm);
 int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* pMatchTerm);
+int64_t syncLogBufferSyncMatchIndex(SSyncLogBuffer* pBuf, SSyncNode* pNode);
 int32_t syncLogBufferCommit(SSyncLogBuffer* pBuf, SSyncNode* pNode, int64_t commitIndex);
 int32_t syncLogBufferReset(SSyncLogBuffer* pBuf, SSyncNode* pNode);
 
@@ -93,7 +93,9 @@ int32_t syncNodeOnAppendEntries(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
   SyncAppendEntries* pMsg = pRpcMsg->pCont;
   SRpcMsg            rpcRsp = {0};
   bool               accepted = false;
-  SSyncRaftEntry*    pEntry = NULL;
+  SSyncRaftEntry**   aEntry = NULL;
+  int32_t            nEntry = TMAX(1, pMsg->numOfEntries);
+  int32_t            nBuilt = 0;
   bool               resetElect = false;
 
   // if already drop replica, do not process
@@ -115,7 +117,8 @@ int32_t syncNodeOnAppendEntries(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
   pReply->term = raftStoreGetTerm(ths);
   pReply->success = false;
   pReply->matchIndex = SYNC_INDEX_INVALID;
-  pReply->lastSendIndex = pMsg->prevLogIndex + 1;
+  pReply->lastSendIndex = pMsg->prevLogIndex + nEntry;
+  pReply->numOfEntries = nEntry;
   pReply->startTime = ths->startTime;
 
   if (pMsg->term < raftStoreGetTerm(ths)) {
@@ -135,31 +138,45 @@ int32_t syncNodeOnAppendEntries(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
     goto _IGNORE;
   }
 
-  pEntry = syncEntryBuildFromAppendEntries(pMsg);
-  if (pEntry == NULL) {
-    sError("vgId:%d, failed to get raft entry from append entries since %s", ths->vgId, terrstr());
+  aEntry = taosMemoryCalloc(nEntry, sizeof(SSyncRaftEntry*));
+  if (aEntry == NULL) {
+    sError("vgId:%d, failed to get raft entries from append entries since %s", ths->vgId, tstrerror(terrno));
     goto _IGNORE;
   }
 
-  if (pMsg->prevLogIndex + 1 != pEntry->index || pEntry->term < 0) {
-    sError("vgId:%d, invalid previous log index in msg. index:%" PRId64 ",  term:%" PRId64 ", prevLogIndex:%" PRId64
-           ", prevLogTerm:%" PRId64,
-           ths->vgId, pEntry->index, pEntry->term, pMsg->prevLogIndex, pMsg->prevLogTerm);
-    goto _IGNORE;
+  uint32_t offset = 0;
+  for (; nBuilt < nEntry; nBuilt++) {
+    SSyncRaftEntry* pEntry = syncEntryBuildFromAppendEntries(pMsg, offset);
+    if (pEntry == NULL) {
+      sError("vgId:%d, failed to get raft entry from append entries since %s", ths->vgId, terrstr());
+      goto _IGNORE;
+    }
+    aEntry[nBuilt] = pEntry;
+    offset += pEntry->bytes;
+
+    if (pMsg->prevLogIndex + 1 + nBuilt != pEntry->index || pEntry->term < 0) {
+      sError("vgId:%d, invalid previous log index in msg. index:%" PRId64 ",  term:%" PRId64 ", prevLogIndex:%" PRId64
+             ", prevLogTerm:%" PRId64 ", num:%d",
+             ths->vgId, pEntry->index, pEntry->term, pMsg->prevLogIndex, pMsg->prevLogTerm, nEntry);
+      nBuilt++;
+      goto _IGNORE;
+    }
   }
 
-  sTrace("vgId:%d, recv append entries msg. index:%" PRId64 ", term:%" PRId64 ", preLogIndex:%" PRId64
+  sTrace("vgId:%d, recv append entries msg. index:%" PRId64 ", num:%d, term:%" PRId64 ", preLogIndex:%" PRId64
          ", prevLogTerm:%" PRId64 " commitIndex:%" PRId64 "",
-         pMsg->vgId, pMsg->prevLogIndex + 1, pMsg->term, pMsg->prevLogIndex, pMsg->prevLogTerm, pMsg->commitIndex);
+         pMsg->vgId, pMsg->prevLogIndex + 1, nEntry, pMsg->term, pMsg->prevLogIndex, pMsg->prevLogTerm,
+         pMsg->commitIndex);
 
   // accept
-  if (syncLogBufferAccept(ths->pLogBuf, ths, pEntry, pMsg->prevLogTerm) < 0) {
+  nBuilt = 0;
+  if (syncLogBufferAcceptBatch(ths->pLogBuf, ths, aEntry, nEntry, pMsg->prevLogTerm) < 0) {
     goto _SEND_RESPONSE;
   }
   accepted = true;
 
 _SEND_RESPONSE:
-  pEntry = NULL;
+  taosMemoryFree(aEntry);
   pReply->matchIndex = syncLogBufferProceed(ths->pLogBuf, ths, &pReply->lastMatchTerm);
   bool matched = (pReply->matchIndex >= pReply->lastSendIndex);
   if (accepted && matched) {
@@ -181,6 +198,9 @@ _SEND_RESPONSE:
 
 _IGNORE:
   rpcFreeCont(rpcRsp.pCont);
-  syncEntryDestroy(pEntry);
+  for (int32_t i = 0; i < nBuilt; i++) {
+    syncEntryDestroy(aEntry[i]);
+  }
+  taosMemoryFree(aEntry);
   return 0;
 }
@@ -564,6 +564,18 @@ int32_t syncPropose(int64_t rid, SRpcMsg* pMsg, bool isWeak, int64_t* seq) {
   return ret;
 }
 
+int32_t syncFlushLog(int64_t rid) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) {
+    sError("sync flush log error");
+    return -1;
+  }
+
+  int32_t ret = syncNodeFlushLog(pSyncNode);
+  syncNodeRelease(pSyncNode);
+  return ret;
+}
+
 int32_t syncNodePropose(SSyncNode* pSyncNode, SRpcMsg* pMsg, bool isWeak, int64_t* seq) {
   if (pSyncNode->state != TAOS_SYNC_STATE_LEADER) {
     terrno = TSDB_CODE_SYN_NOT_LEADER;
@@ -2200,7 +2212,40 @@ int32_t syncNodeAppend(SSyncNode* ths, SSyncRaftEntry* pEntry) {
     return 0;
   }
 
-  // single replica
+  // single replica, only user writes are followed by a syncFlushLog
+  if (!syncUtilUserCommit(pEntry->originalRpcType)) {
+    if (ths->pLogStore->syncLogFsync(ths->pLogStore) < 0) {
+      sError("vgId:%d, failed to fsync sync log store since %s", ths->vgId, terrstr());
+    }
+    matchIndex = syncLogBufferSyncMatchIndex(ths->pLogBuf, ths);
+  }
+
+  (void)syncNodeUpdateCommitIndex(ths, matchIndex);
+
+  if (syncLogBufferCommit(ths->pLogBuf, ths, ths->commitIndex) < 0) {
+    sError("vgId:%d, failed to commit until commitIndex:%" PRId64 "", ths->vgId, ths->commitIndex);
+    return -1;
+  }
+
+  return 0;
+}
+
+int32_t syncNodeFlushLog(SSyncNode* ths) {
+  // appends of multi replicas are flushed as they proceed
+  if (ths->replicaNum > 1) {
+    return 0;
+  }
+
+  if (ths->pLogStore->syncLogFsync(ths->pLogStore) < 0) {
+    sError("vgId:%d, failed to fsync sync log store since %s", ths->vgId, terrstr());
+    return -1;
+  }
+
+  SyncIndex matchIndex = syncLogBufferSyncMatchIndex(ths->pLogBuf, ths);
+  if (ths->state != TAOS_SYNC_STATE_LEADER) {
+    return 0;
+  }
+
   (void)syncNodeUpdateCommitIndex(ths, matchIndex);
 
   if (syncLogBufferCommit(ths->pLogBuf, ths, ths->commitIndex) < 0) {
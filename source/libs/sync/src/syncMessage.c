@@ -154,9 +154,12 @@ int32_t syncBuildAppendEntriesReply(SRpcMsg* pMsg, int32_t vgId) {
   return 0;
 }
 
-int32_t syncBuildAppendEntriesFromRaftEntry(SSyncNode* pNode, SSyncRaftEntry* pEntry, SyncTerm prevLogTerm,
-                                            SRpcMsg* pRpcMsg) {
-  uint32_t dataLen = pEntry->bytes;
+int32_t syncBuildAppendEntriesFromRaftEntries(SSyncNode* pNode, SSyncRaftEntry** aEntry, int32_t nEntry,
+                                              SyncTerm prevLogTerm, SRpcMsg* pRpcMsg) {
+  uint32_t dataLen = 0;
+  for (int32_t i = 0; i < nEntry; i++) {
+    dataLen += aEntry[i]->bytes;
+  }
   uint32_t bytes = sizeof(SyncAppendEntries) + dataLen;
   pRpcMsg->contLen = bytes;
   pRpcMsg->pCont = rpcMallocCont(pRpcMsg->contLen);
@@ -168,11 +171,16 @@ int32_t syncBuildAppendEntriesFromRaftEntry(SSyncNode* pNode, SSyncRaftEntry* pE
   SyncAppendEntries* pMsg = pRpcMsg->pCont;
   pMsg->bytes = pRpcMsg->contLen;
   pMsg->msgType = pRpcMsg->msgType = TDMT_SYNC_APPEND_ENTRIES;
+  pMsg->numOfEntries = nEntry;
   pMsg->dataLen = dataLen;
 
-  (void)memcpy(pMsg->data, pEntry, dataLen);
+  char* pData = pMsg->data;
+  for (int32_t i = 0; i < nEntry; i++) {
+    (void)memcpy(pData, aEntry[i], aEntry[i]->bytes);
+    pData += aEntry[i]->bytes;
+  }
 
-  pMsg->prevLogIndex = pEntry->index - 1;
+  pMsg->prevLogIndex = aEntry[0]->index - 1;
   pMsg->prevLogTerm = prevLogTerm;
   pMsg->vgId = pNode->vgId;
   pMsg->srcId = pNode->myRaftId;
@@ -301,9 +301,9 @@ bool syncLogBufferIsEmpty(SSyncLogBuffer* pBuf) {
   return empty;
 }
 
-int32_t syncLogBufferAccept(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry* pEntry, SyncTerm prevTerm) {
-  taosThreadMutexLock(&pBuf->mutex);
-  syncLogBufferValidate(pBuf);
+// entries after the first one of a batch chain to their predecessors in the same msg, which get checked on proceeding
+static int32_t syncLogBufferAcceptWithoutLock(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry* pEntry,
+                                              SyncTerm prevTerm, bool chained) {
   int32_t         ret = -1;
   SyncIndex       index = pEntry->index;
   SyncIndex       prevIndex = pEntry->index - 1;
@@ -332,7 +332,7 @@ int32_t syncLogBufferAccept(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEnt
     goto _out;
   }
 
-  if (index > pBuf->matchIndex && lastMatchTerm != prevTerm) {
+  if (!chained && index > pBuf->matchIndex && lastMatchTerm != prevTerm) {
     sWarn("vgId:%d, not ready to accept. index:%" PRId64 ", term:%" PRId64 ": prevterm:%" PRId64
           " != lastmatch:%" PRId64 ". log buffer: [%" PRId64 " %" PRId64 " %" PRId64 ", %" PRId64 ")",
           pNode->vgId, pEntry->index, pEntry->term, prevTerm, lastMatchTerm, pBuf->startIndex, pBuf->commitIndex,
@@ -378,8 +378,32 @@ _out:
     syncEntryDestroy(pExist);
     pExist = NULL;
   }
+  return ret;
+}
+
+// accept consecutive entries in order and stop at the first one refused. the entries are all taken over.
+int32_t syncLogBufferAcceptBatch(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry** aEntry, int32_t nEntry,
+                                 SyncTerm prevTerm) {
+  int32_t ret = 0;
+  int32_t i = 0;
+
+  taosThreadMutexLock(&pBuf->mutex);
+  syncLogBufferValidate(pBuf);
+  for (; i < nEntry; i++) {
+    SyncTerm term = aEntry[i]->term;
+    if (syncLogBufferAcceptWithoutLock(pBuf, pNode, aEntry[i], prevTerm, i > 0) < 0) {
+      ret = -1;
+      i++;
+      break;
+    }
+    prevTerm = term;
+  }
   syncLogBufferValidate(pBuf);
   taosThreadMutexUnlock(&pBuf->mutex);
+
+  for (; i < nEntry; i++) {
+    syncEntryDestroy(aEntry[i]);
+  }
   return ret;
 }
 
@@ -387,28 +411,59 @@ static inline bool syncLogStoreNeedFlush(SSyncRaftEntry* pEntry, int32_t replica
   return (replicaNum > 1) && (pEntry->originalRpcType == TDMT_VND_COMMIT);
 }
 
-int32_t syncLogStorePersist(SSyncLogStore* pLogStore, SSyncNode* pNode, SSyncRaftEntry* pEntry) {
-  ASSERT(pEntry->index >= 0);
+// persist a run of consecutive entries with one write to the log store
+static int32_t syncLogStorePersist(SSyncLogStore* pLogStore, SSyncNode* pNode, SSyncRaftEntry** aEntry, int32_t nEntry) {
+  SSyncRaftEntry* pFirst = aEntry[0];
+  SSyncRaftEntry* pLast = aEntry[nEntry - 1];
+  ASSERT(pFirst->index >= 0);
   SyncIndex lastVer = pLogStore->syncLogLastIndex(pLogStore);
-  if (lastVer >= pEntry->index && pLogStore->syncLogTruncate(pLogStore, pEntry->index) < 0) {
-    sError("failed to truncate log store since %s. from index:%" PRId64 "", terrstr(), pEntry->index);
+  if (lastVer >= pFirst->index && pLogStore->syncLogTruncate(pLogStore, pFirst->index) < 0) {
+    sError("failed to truncate log store since %s. from index:%" PRId64 "", terrstr(), pFirst->index);
     return -1;
   }
   lastVer = pLogStore->syncLogLastIndex(pLogStore);
-  ASSERT(pEntry->index == lastVer + 1);
+  ASSERT(pFirst->index == lastVer + 1);
+
+  bool doFsync = false;
+  for (int32_t i = 0; i < nEntry; i++) {
+    doFsync = doFsync || syncLogStoreNeedFlush(aEntry[i], pNode->replicaNum);
+  }
 
-  bool doFsync = syncLogStoreNeedFlush(pEntry, pNode->replicaNum);
-  if (pLogStore->syncLogAppendEntry(pLogStore, pEntry, doFsync) < 0) {
-    sError("failed to append sync log entry since %s. index:%" PRId64 ", term:%" PRId64 "", terrstr(), pEntry->index,
-           pEntry->term);
+  if (pLogStore->syncLogAppendEntries(pLogStore, aEntry, nEntry, doFsync) < 0) {
+    sError("failed to append sync log entries since %s. index:%" PRId64 " to %" PRId64 ", term:%" PRId64 "", terrstr(),
+           pFirst->index, pLast->index, pLast->term);
     return -1;
   }
 
   lastVer = pLogStore->syncLogLastIndex(pLogStore);
-  ASSERT(pEntry->index == lastVer);
+  ASSERT(pLast->index == lastVer);
   return 0;
 }
 
+// the leader of a single replica vnode leaves the fsync of user writes to syncFlushLog
+static inline bool syncLogStoreDeferFsync(SSyncNode* pNode) {
+  return (pNode->replicaNum == 1) && (pNode->vgId != 1) && (pNode->state == TAOS_SYNC_STATE_LEADER);
+}
+
+static int64_t syncLogBufferUpdateMatchIndex(SSyncLogBuffer* pBuf, SSyncNode* pNode, bool doFsync) {
+  SSyncLogStore* pLogStore = pNode->pLogStore;
+  if (doFsync && pLogStore->syncLogFsync(pLogStore) < 0) {
+    sError("vgId:%d, failed to fsync sync log store since %s", pNode->vgId, terrstr());
+  }
+
+  // only entries made durable count for my match index
+  int64_t matchIndex = TMIN(pBuf->matchIndex, pLogStore->syncLogSyncedIndex(pLogStore));
+  syncIndexMgrSetIndex(pNode->pMatchIndex, &pNode->myRaftId, matchIndex);
+  return matchIndex;
+}
+
+int64_t syncLogBufferSyncMatchIndex(SSyncLogBuffer* pBuf, SSyncNode* pNode) {
+  taosThreadMutexLock(&pBuf->mutex);
+  int64_t matchIndex = syncLogBufferUpdateMatchIndex(pBuf, pNode, false);
+  taosThreadMutexUnlock(&pBuf->mutex);
+  return matchIndex;
+}
+
 int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* pMatchTerm) {
   taosThreadMutexLock(&pBuf->mutex);
   syncLogBufferValidate(pBuf);
@@ -416,43 +471,58 @@ int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* p
   SSyncLogStore* pLogStore = pNode->pLogStore;
   int64_t        matchIndex = pBuf->matchIndex;
 
-  while (pBuf->matchIndex + 1 < pBuf->endIndex) {
-    int64_t index = pBuf->matchIndex + 1;
-    ASSERT(index >= 0);
+  SSyncRaftEntry* aEntry[SYNC_MAX_BATCH_SIZE];
+  bool            stop = false;
+
+  while (!stop && pBuf->matchIndex + 1 < pBuf->endIndex) {
+    int32_t nEntry = 0;
+
+    // collect a run of entries matching their previous ones
+    while (nEntry < SYNC_MAX_BATCH_SIZE && pBuf->matchIndex + 1 < pBuf->endIndex) {
+      int64_t index = pBuf->matchIndex + 1;
+      ASSERT(index >= 0);
+
+      // try to proceed
+      SSyncLogBufEntry* pBufEntry = &pBuf->entries[index % pBuf->size];
+      SyncIndex         prevLogIndex = pBufEntry->prevLogIndex;
+      SyncTerm          prevLogTerm = pBufEntry->prevLogTerm;
+      SSyncRaftEntry*   pEntry = pBufEntry->pItem;
+      if (pEntry == NULL) {
+        sTrace("vgId:%d, cannot proceed match index in log buffer. no raft entry at next pos of matchIndex:%" PRId64,
+               pNode->vgId, pBuf->matchIndex);
+        stop = true;
+        break;
+      }
 
-    // try to proceed
-    SSyncLogBufEntry* pBufEntry = &pBuf->entries[index % pBuf->size];
-    SyncIndex         prevLogIndex = pBufEntry->prevLogIndex;
-    SyncTerm          prevLogTerm = pBufEntry->prevLogTerm;
-    SSyncRaftEntry*   pEntry = pBufEntry->pItem;
-    if (pEntry == NULL) {
-      sTrace("vgId:%d, cannot proceed match index in log buffer. no raft entry at next pos of matchIndex:%" PRId64,
-             pNode->vgId, pBuf->matchIndex);
-      goto _out;
+      ASSERT(index == pEntry->index);
+
+      // match
+      SSyncRaftEntry* pMatch = pBuf->entries[(pBuf->matchIndex + pBuf->size) % pBuf->size].pItem;
+      ASSERT(pMatch != NULL);
+      ASSERT(pMatch->index == pBuf->matchIndex);
+      ASSERT(pMatch->index + 1 == pEntry->index);
+      ASSERT(prevLogIndex == pMatch->index);
+
+      if (pMatch->term != prevLogTerm) {
+        sInfo(
+            "vgId:%d, mismatching sync log entries encountered. "
+            "{ index:%" PRId64 ", term:%" PRId64
+            " } "
+            "{ index:%" PRId64 ", term:%" PRId64 ", prevLogIndex:%" PRId64 ", prevLogTerm:%" PRId64 " } ",
+            pNode->vgId, pMatch->index, pMatch->term, pEntry->index, pEntry->term, prevLogIndex, prevLogTerm);
+        stop = true;
+        break;
+      }
+
+      // increase match index
+      pBuf->matchIndex = index;
+      aEntry[nEntry++] = pEntry;
     }
 
-    ASSERT(index == pEntry->index);
-
-    // match
-    SSyncRaftEntry* pMatch = pBuf->entries[(pBuf->matchIndex + pBuf->size) % pBuf->size].pItem;
-    ASSERT(pMatch != NULL);
-    ASSERT(pMatch->index == pBuf->matchIndex);
-    ASSERT(pMatch->index + 1 == pEntry->index);
-    ASSERT(prevLogIndex == pMatch->index);
-
-    if (pMatch->term != prevLogTerm) {
-      sInfo(
-          "vgId:%d, mismatching sync log entries encountered. "
-          "{ index:%" PRId64 ", term:%" PRId64
-          " } "
-          "{ index:%" PRId64 ", term:%" PRId64 ", prevLogIndex:%" PRId64 ", prevLogTerm:%" PRId64 " } ",
-          pNode->vgId, pMatch->index, pMatch->term, pEntry->index, pEntry->term, prevLogIndex, prevLogTerm);
+    if (nEntry == 0) {
       goto _out;
     }
 
-    // increase match index
-    pBuf->matchIndex = index;
-
     sTrace("vgId:%d, log buffer proceed. start index:%" PRId64 ", match index:%" PRId64 ", end index:%" PRId64,
            pNode->vgId, pBuf->startIndex, pBuf->matchIndex, pBuf->endIndex);
 
@@ -460,16 +530,14 @@ int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* p
     (void)syncNodeReplicateWithoutLock(pNode);
 
     // persist
-    if (syncLogStorePersist(pLogStore, pNode, pEntry) < 0) {
-      sError("vgId:%d, failed to persist sync log entry from buffer since %s. index:%" PRId64, pNode->vgId, terrstr(),
-             pEntry->index);
+    if (syncLogStorePersist(pLogStore, pNode, aEntry, nEntry) < 0) {
+      sError("vgId:%d, failed to persist sync log entries from buffer since %s. index:%" PRId64 " to %" PRId64,
+             pNode->vgId, terrstr(), aEntry[0]->index, aEntry[nEntry - 1]->index);
       goto _out;
     }
-    ASSERT(pEntry->index == pBuf->matchIndex);
+    ASSERT(aEntry[nEntry - 1]->index == pBuf->matchIndex);
 
-    // update my match index
     matchIndex = pBuf->matchIndex;
-    syncIndexMgrSetIndex(pNode->pMatchIndex, &pNode->myRaftId, pBuf->matchIndex);
   }  // end of while
 
 _out:
@@ -477,6 +545,9 @@ _out:
   if (pMatchTerm) {
     *pMatchTerm = pBuf->entries[(matchIndex + pBuf->size) % pBuf->size].pItem->term;
   }
+
+  // update my match index
+  matchIndex = syncLogBufferUpdateMatchIndex(pBuf, pNode, !syncLogStoreDeferFsync(pNode));
   syncLogBufferValidate(pBuf);
   taosThreadMutexUnlock(&pBuf->mutex);
   return matchIndex;
@@ -665,8 +736,9 @@ int32_t syncLogReplRetryOnNeed(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
       continue;
     }
 
-    bool barrier = false;
-    if (syncLogReplSendTo(pMgr, pNode, index, &term, pDestId, &barrier) < 0) {
+    bool    barrier = false;
+    int32_t nSent = 0;
+    if (syncLogReplSendTo(pMgr, pNode, index, 1, &term, &nSent, pDestId, &barrier) < 0) {
       sError("vgId:%d, failed to replicate sync log entry since %s. index:%" PRId64 ", dest:%" PRIx64 "", pNode->vgId,
              terrstr(), index, pDestId->addr);
       goto _out;
@@ -785,6 +857,7 @@ int32_t syncLogReplProcessHeartbeatReply(SSyncLogReplMgr* pMgr, SSyncNode* pNode
           pNode->vgId, pMsg->srcId.addr, pMsg->startTime, pMgr->peerStartTime);
     syncLogReplReset(pMgr);
     pMgr->peerStartTime = pMsg->startTime;
+    pMgr->peerBatch = false;
   }
   taosThreadMutexUnlock(&pBuf->mutex);
   return 0;
@@ -798,6 +871,13 @@ int32_t syncLogReplProcessReply(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncApp
           pNode->vgId, pMsg->srcId.addr, pMsg->startTime, pMgr->peerStartTime);
     syncLogReplReset(pMgr);
     pMgr->peerStartTime = pMsg->startTime;
+    pMgr->peerBatch = false;
+  }
+
+  // older versions leave the field zero, and fail on an append entries msg of more than one entry
+  if (pMsg->numOfEntries > 0 && !pMgr->peerBatch) {
+    sInfo("vgId:%d, peer:%" PRIx64 " accepts batched append entries", pNode->vgId, pMsg->srcId.addr);
+    pMgr->peerBatch = true;
   }
 
   if (pMgr->restored) {
@@ -833,7 +913,8 @@ int32_t syncLogReplProbe(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex inde
   SRaftId* pDestId = &pNode->replicasId[pMgr->peerId];
   bool     barrier = false;
   SyncTerm term = -1;
-  if (syncLogReplSendTo(pMgr, pNode, index, &term, pDestId, &barrier) < 0) {
+  int32_t  nSent = 0;
+  if (syncLogReplSendTo(pMgr, pNode, index, 1, &term, &nSent, pDestId, &barrier) < 0) {
     sError("vgId:%d, failed to replicate log entry since %s. index:%" PRId64 ", dest: 0x%016" PRIx64 "", pNode->vgId,
            terrstr(), index, pDestId->addr);
     return -1;
@@ -867,35 +948,40 @@ int32_t syncLogReplAttempt(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
   SyncTerm  term = -1;
   SyncIndex firstIndex = -1;
 
-  for (SyncIndex index = pMgr->endIndex; index <= pNode->pLogBuf->matchIndex; index++) {
+  for (SyncIndex index = pMgr->endIndex; index <= pNode->pLogBuf->matchIndex; index = pMgr->endIndex) {
     if (batchSize < count || limit <= index - pMgr->startIndex) {
       break;
     }
     if (pMgr->startIndex + 1 < index && pMgr->states[(index - 1) % pMgr->size].barrier) {
       break;
     }
-    int64_t  pos = index % pMgr->size;
-    SRaftId* pDestId = &pNode->replicasId[pMgr->peerId];
+    int64_t  nMax = TMIN(pNode->pLogBuf->matchIndex + 1, pMgr->startIndex + limit) - index;
+    SyncTerm aTerm[SYNC_MAX_BATCH_SIZE];
+    int32_t  nSent = 0;
     bool     barrier = false;
-    SyncTerm term = -1;
-    if (syncLogReplSendTo(pMgr, pNode, index, &term, pDestId, &barrier) < 0) {
+    nMax = TMIN(nMax, pMgr->peerBatch ? SYNC_MAX_BATCH_SIZE : 1);
+    if (syncLogReplSendTo(pMgr, pNode, index, nMax, aTerm, &nSent, pDestId, &barrier) < 0) {
       sError("vgId:%d, failed to replicate log entry since %s. index:%" PRId64 ", dest: 0x%016" PRIx64 "", pNode->vgId,
              terrstr(), index, pDestId->addr);
       return -1;
     }
-    pMgr->states[pos].barrier = barrier;
-    pMgr->states[pos].timeMs = nowMs;
-    pMgr->states[pos].term = term;
-    pMgr->states[pos].acked = false;
+    for (int32_t i = 0; i < nSent; i++) {
+      int64_t pos = (index + i) % pMgr->size;
+      pMgr->states[pos].barrier = barrier && (i + 1 == nSent);
+      pMgr->states[pos].timeMs = nowMs;
+      pMgr->states[pos].term = aTerm[i];
+      pMgr->states[pos].acked = false;
+    }
 
     if (firstIndex == -1) firstIndex = index;
-    count++;
+    term = aTerm[nSent - 1];
+    count += nSent;
 
-    pMgr->endIndex = index + 1;
+    pMgr->endIndex = index + nSent;
     if (barrier) {
       sInfo("vgId:%d, replicated sync barrier to dest:%" PRIx64 ". index:%" PRId64 ", term:%" PRId64
             ", repl mgr: rs(%d) [%" PRId64 " %" PRId64 ", %" PRId64 ")",
-            pNode->vgId, pDestId->addr, index, term, pMgr->restored, pMgr->startIndex, pMgr->matchIndex,
+            pNode->vgId, pDestId->addr, pMgr->endIndex - 1, term, pMgr->restored, pMgr->startIndex, pMgr->matchIndex,
             pMgr->endIndex);
       break;
     }
@@ -923,7 +1009,10 @@ int32_t syncLogReplProcessReplyAsNormal(SSyncLogReplMgr* pMgr, SSyncNode* pNode,
         pMgr->retryBackoff -= 1;
       }
     }
-    pMgr->states[pMsg->lastSendIndex % pMgr->size].acked = true;
+    SyncIndex firstAcked = TMAX(pMgr->startIndex, pMsg->lastSendIndex - TMAX(1, pMsg->numOfEntries) + 1);
+    for (SyncIndex index = firstAcked; index <= pMsg->lastSendIndex; index++) {
+      pMgr->states[index % pMgr->size].acked = true;
+    }
     pMgr->matchIndex = TMAX(pMgr->matchIndex, pMsg->matchIndex);
     for (SyncIndex index = pMgr->startIndex; index < pMgr->matchIndex; index++) {
       memset(&pMgr->states[index % pMgr->size], 0, sizeof(pMgr->states[0]));
@@ -1126,37 +1215,60 @@ SSyncRaftEntry* syncLogBufferGetOneEntry(SSyncLogBuffer* pBuf, SSyncNode* pNode,
   return pEntry;
 }
 
-int32_t syncLogReplSendTo(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex index, SyncTerm* pTerm, SRaftId* pDestId,
-                          bool* pBarrier) {
-  SSyncRaftEntry* pEntry = NULL;
+// pack up to nMax consecutive entries from index into one msg, bounded by SYNC_MAX_BATCH_BYTES. a barrier ends a batch.
+int32_t syncLogReplSendTo(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex index, int32_t nMax, SyncTerm* aTerm,
+                          int32_t* pCount, SRaftId* pDestId, bool* pBarrier) {
+  SSyncRaftEntry* aEntry[SYNC_MAX_BATCH_SIZE] = {0};
+  bool            aInBuf[SYNC_MAX_BATCH_SIZE] = {0};
+  int32_t         nEntry = 0;
+  int64_t         bytes = 0;
   SRpcMsg         msgOut = {0};
-  bool            inBuf = false;
   SyncTerm        prevLogTerm = -1;
   SSyncLogBuffer* pBuf = pNode->pLogBuf;
 
-  pEntry = syncLogBufferGetOneEntry(pBuf, pNode, index, &inBuf);
-  if (pEntry == NULL) {
-    sError("vgId:%d, failed to get raft entry for index:%" PRId64 "", pNode->vgId, index);
-    if (terrno == TSDB_CODE_WAL_LOG_NOT_EXIST) {
-      SSyncLogReplMgr* pMgr = syncNodeGetLogReplMgr(pNode, pDestId);
-      if (pMgr) {
-        sInfo("vgId:%d, reset sync log repl of peer:%" PRIx64 " since %s. index:%" PRId64, pNode->vgId, pDestId->addr,
-              terrstr(), index);
-        (void)syncLogReplReset(pMgr);
+  ASSERT(nMax > 0);
+  nMax = TMIN(nMax, SYNC_MAX_BATCH_SIZE);
+  *pBarrier = false;
+
+  while (nEntry < nMax) {
+    SSyncRaftEntry* pEntry = syncLogBufferGetOneEntry(pBuf, pNode, index + nEntry, &aInBuf[nEntry]);
+    if (pEntry == NULL) {
+      if (nEntry > 0) break;
+      sError("vgId:%d, failed to get raft entry for index:%" PRId64 "", pNode->vgId, index);
+      if (terrno == TSDB_CODE_WAL_LOG_NOT_EXIST) {
+        SSyncLogReplMgr* pMgr = syncNodeGetLogReplMgr(pNode, pDestId);
+        if (pMgr) {
+          sInfo("vgId:%d, reset sync log repl of peer:%" PRIx64 " since %s. index:%" PRId64, pNode->vgId,
+                pDestId->addr, terrstr(), index);
+          (void)syncLogReplReset(pMgr);
+        }
       }
+      goto _err;
+    }
+
+    if (nEntry > 0 && bytes + pEntry->bytes > SYNC_MAX_BATCH_BYTES) {
+      if (!aInBuf[nEntry]) syncEntryDestroy(pEntry);
+      break;
+    }
+
+    aEntry[nEntry] = pEntry;
+    aTerm[nEntry] = pEntry->term;
+    bytes += pEntry->bytes;
+    nEntry++;
+
+    if (syncLogReplBarrier(pEntry)) {
+      *pBarrier = true;
+      break;
     }
-    goto _err;
   }
-  *pBarrier = syncLogReplBarrier(pEntry);
 
   prevLogTerm = syncLogReplGetPrevLogTerm(pMgr, pNode, index);
   if (prevLogTerm < 0) {
     sError("vgId:%d, failed to get prev log term since %s. index:%" PRId64 "", pNode->vgId, terrstr(), index);
     goto _err;
   }
-  if (pTerm) *pTerm = pEntry->term;
 
-  int32_t code = syncBuildAppendEntriesFromRaftEntry(pNode, pEntry, prevLogTerm, &msgOut);
+  int32_t code = syncBuildAppendEntriesFromRaftEntries(pNode, aEntry, nEntry, prevLogTerm, &msgOut);
   if (code < 0) {
     sError("vgId:%d, failed to get append entries for index:%" PRId64 "", pNode->vgId, index);
     goto _err;
@@ -1164,21 +1276,20 @@ int32_t syncLogReplSendTo(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex ind
 
   (void)syncNodeSendAppendEntries(pNode, pDestId, &msgOut);
 
-  sTrace("vgId:%d, replicate one msg index:%" PRId64 " term:%" PRId64 " prevterm:%" PRId64 " to dest: 0x%016" PRIx64,
-         pNode->vgId, pEntry->index, pEntry->term, prevLogTerm, pDestId->addr);
+  sTrace("vgId:%d, replicate %d msgs index:%" PRId64 " term:%" PRId64 " prevterm:%" PRId64 " to dest: 0x%016" PRIx64,
+         pNode->vgId, nEntry, index, aTerm[nEntry - 1], prevLogTerm, pDestId->addr);
 
-  if (!inBuf) {
-    syncEntryDestroy(pEntry);
-    pEntry = NULL;
+  *pCount = nEntry;
+  for (int32_t i = 0; i < nEntry; i++) {
+    if (!aInBuf[i]) syncEntryDestroy(aEntry[i]);
   }
   return 0;
 
 _err:
   rpcFreeCont(msgOut.pCont);
   msgOut.pCont = NULL;
-  if (!inBuf) {
-    syncEntryDestroy(pEntry);
-    pEntry = NULL;
+  for (int32_t i = 0; i < nEntry; i++) {
+    if (!aInBuf[i]) syncEntryDestroy(aEntry[i]);
   }
   return -1;
 }
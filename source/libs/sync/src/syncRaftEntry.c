@@ -63,14 +63,21 @@ SSyncRaftEntry* syncEntryBuildFromRpcMsg(const SRpcMsg* pMsg, SyncTerm term, Syn
   return pEntry;
 }
 
-SSyncRaftEntry* syncEntryBuildFromAppendEntries(const SyncAppendEntries* pMsg) {
-  SSyncRaftEntry* pEntry = taosMemoryMalloc(pMsg->dataLen);
+// build the entry at offset of the entries packed in the msg
+SSyncRaftEntry* syncEntryBuildFromAppendEntries(const SyncAppendEntries* pMsg, uint32_t offset) {
+  const SSyncRaftEntry* pSrc = (const SSyncRaftEntry*)(pMsg->data + offset);
+  if (offset + sizeof(SSyncRaftEntry) > pMsg->dataLen || pSrc->bytes < sizeof(SSyncRaftEntry) ||
+      pSrc->bytes > pMsg->dataLen - offset) {
+    terrno = TSDB_CODE_INVALID_MSG;
+    return NULL;
+  }
+
+  SSyncRaftEntry* pEntry = taosMemoryMalloc(pSrc->bytes);
   if (pEntry == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
   }
-  memcpy(pEntry, pMsg->data, pMsg->dataLen);
-  ASSERT(pEntry->bytes == pMsg->dataLen);
+  memcpy(pEntry, pSrc, pSrc->bytes);
   return pEntry;
 }
 
@@ -24,6 +24,10 @@
 // public function
 static int32_t   raftLogRestoreFromSnapshot(struct SSyncLogStore* pLogStore, SyncIndex snapshotIndex);
 static int32_t   raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, bool forceSync);
+static int32_t   raftLogAppendEntries(struct SSyncLogStore* pLogStore, SSyncRaftEntry** aEntry, int32_t nEntry,
+                                      bool forceSync);
+static int32_t   raftLogFsync(struct SSyncLogStore* pLogStore);
+static SyncIndex raftLogSyncedIndex(struct SSyncLogStore* pLogStore);
 static int32_t   raftLogTruncate(struct SSyncLogStore* pLogStore, SyncIndex fromIndex);
 static bool      raftLogExist(struct SSyncLogStore* pLogStore, SyncIndex index);
 static int32_t   raftLogUpdateCommitIndex(SSyncLogStore* pLogStore, SyncIndex index);
@@ -72,6 +76,9 @@ SSyncLogStore* logStoreCreate(SSyncNode* pSyncNode) {
   pLogStore->syncLogLastIndex = raftLogLastIndex;
   pLogStore->syncLogLastTerm = raftLogLastTerm;
   pLogStore->syncLogAppendEntry = raftLogAppendEntry;
+  pLogStore->syncLogAppendEntries = raftLogAppendEntries;
+  pLogStore->syncLogFsync = raftLogFsync;
+  pLogStore->syncLogSyncedIndex = raftLogSyncedIndex;
   pLogStore->syncLogGetEntry = raftLogGetEntry;
   pLogStore->syncLogTruncate = raftLogTruncate;
   pLogStore->syncLogWriteIndex = raftLogWriteIndex;
@@ -226,6 +233,64 @@ static int32_t raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntr
   return 0;
 }
 
+static int32_t raftLogAppendEntries(struct SSyncLogStore* pLogStore, SSyncRaftEntry** aEntry, int32_t nEntry,
+                                    bool forceSync) {
+  SSyncLogStoreData* pData = pLogStore->data;
+  SWal*              pWal = pData->pWal;
+
+  SWalLogItem* aItem = taosMemoryMalloc(nEntry * sizeof(SWalLogItem));
+  if (aItem == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < nEntry; i++) {
+    SSyncRaftEntry* pEntry = aEntry[i];
+    aItem[i].index = pEntry->index;
+    aItem[i].msgType = pEntry->originalRpcType;
+    aItem[i].syncMeta.isWeek = pEntry->isWeak;
+    aItem[i].syncMeta.seqNum = pEntry->seqNum;
+    aItem[i].syncMeta.term = pEntry->term;
+    aItem[i].body = pEntry->data;
+    aItem[i].bodyLen = pEntry->dataLen;
+  }
+
+  int64_t   tsWriteBegin = taosGetTimestampNs();
+  SyncIndex index = walAppendLogs(pWal, aItem, nEntry);
+  int64_t   tsElapsed = taosGetTimestampNs() - tsWriteBegin;
+  taosMemoryFree(aItem);
+
+  if (index < 0) {
+    int32_t     err = terrno;
+    const char* errStr = tstrerror(err);
+    int32_t     sysErr = errno;
+    const char* sysErrStr = strerror(errno);
+
+    sNError(pData->pSyncNode, "wal write error, index:%" PRId64 ", num:%d, err:0x%x, msg:%s, syserr:%d, sysmsg:%s",
+            aEntry[0]->index, nEntry, err, errStr, sysErr, sysErrStr);
+    return -1;
+  }
+
+  ASSERT(aEntry[nEntry - 1]->index == index);
+
+  walFsync(pWal, forceSync);
+
+  sNTrace(pData->pSyncNode, "write index:%" PRId64 " to %" PRId64 ", elapsed:%" PRId64, aEntry[0]->index, index,
+          tsElapsed);
+  return 0;
+}
+
+static int32_t raftLogFsync(struct SSyncLogStore* pLogStore) {
+  SSyncLogStoreData* pData = pLogStore->data;
+  return walFsyncPending(pData->pWal);
+}
+
+// entries deferred by wal group commit are not durable yet
+static SyncIndex raftLogSyncedIndex(struct SSyncLogStore* pLogStore) {
+  SSyncLogStoreData* pData = pLogStore->data;
+  return walGetSyncedVer(pData->pWal);
+}
+
 // entry found, return 0
 // entry not found, return -1, terrno = TSDB_CODE_WAL_LOG_NOT_EXIST
 // other error, return -1
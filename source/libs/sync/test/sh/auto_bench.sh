@@ -1,7 +1,9 @@
 #!/bin/bash
 
-if [ $# != 7 ] ; then
-	echo "Uasge: $0 instances vgroups replica ctables rows weak drop(yes/no)"
+if [ $# != 7 ] && [ $# != 8 ] ; then
+	echo "Uasge: $0 instances vgroups replica ctables rows weak drop(yes/no) [rows_per_req]"
+  echo ""
+  echo "e.g. 3-replica throughput of small writes: $0 4 4 3 1000 10000 0 yes 1"
   echo ""
   exit 1
 fi
@@ -13,12 +15,13 @@ ctables=$4
 rows=$5
 weak=$6
 drop=$7
+rpr=${8:-100000}
 
 
-echo "params: instances:${instances}, vgroups:${vgroups}, replica:${replica}, ctables:${ctables}, rows:${rows}, weak:${weak}, drop:${drop}"
+echo "params: instances:${instances}, vgroups:${vgroups}, replica:${replica}, ctables:${ctables}, rows:${rows}, weak:${weak}, drop:${drop}, rows_per_req:${rpr}"
 
 dt=`date "+%Y-%m-%d-%H-%M-%S"`
-casedir=instances_${instances}_vgroups_${vgroups}_replica_${replica}_ctables_${ctables}_rows_${rows}_weak_${weak}_drop_${drop}_${dt}
+casedir=instances_${instances}_vgroups_${vgroups}_replica_${replica}_ctables_${ctables}_rows_${rows}_weak_${weak}_drop_${drop}_rpr_${rpr}_${dt}
 mkdir ${casedir}
 cp ./insert.tpl.json ${casedir}
 cd ${casedir}
@@ -34,6 +37,7 @@ for i in `seq 1 ${instances}`;do
 	sed -i 's/tpl_ctables_tpl/'${ctables}'/g' ${cfg_file}
 	sed -i 's/tpl_stid_tpl/'${i}'/g' ${cfg_file}
 	sed -i 's/tpl_rows_tpl/'${rows}'/g' ${cfg_file}
+	sed -i 's/tpl_rpr_tpl/'${rpr}'/g' ${cfg_file}
 	sed -i 's/tpl_insert_result_tpl/'${rstfile}'/g' ${cfg_file}
 done
 
@@ -42,6 +42,20 @@ typedef struct WalIdxEntry {
   int64_t offset;
 } SWalIdxEntry;
 
+#define WAL_IDX_CACHE_FILES        4
+#define WAL_IDX_CACHE_ENTRIES      (64 * 1024)
+#define WAL_IDX_CACHE_LOAD_ENTRIES 4096
+
+// log offsets of versions [firstVer + start, firstVer + start + nEntry) of a wal file
+typedef struct {
+  int64_t   firstVer;
+  int64_t   start;
+  int64_t   nEntry;
+  int64_t  *offsets;
+  int64_t   lastUse;
+  TdFilePtr pIdxFile;
+} SWalIdxCache;
+
 static inline int tSerializeWalIdxEntry(void** buf, SWalIdxEntry* pIdxEntry) {
   int tlen = 0;
   tlen += taosEncodeFixedI64(buf, pIdxEntry->ver);
@@ -162,9 +176,18 @@ int64_t walChangeWrite(SWal* pWal, int64_t ver);
 int     walInitWriteFile(SWal* pWal);
 // seek section end
 
+// idx cache section
+int32_t walIdxCacheGetOffset(SWal* pWal, int64_t fileFirstVer, int64_t ver, int64_t* pOffset);
+void    walIdxCacheAppend(SWal* pWal, int64_t fileFirstVer, int64_t ver, int64_t offset);
+void    walIdxCacheTruncate(SWal* pWal, int64_t ver);
+void    walIdxCacheRemove(SWal* pWal, int64_t fileFirstVer);
+void    walIdxCacheClear(SWal* pWal);
+// idx cache section end
+
 int64_t walGetSeq();
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
+int32_t walFsyncGroup(SWal* pWal);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "taoserror.h"
+#include "walInt.h"
+
+// The idx cache keeps a window of the log offsets of each recently read wal file in memory, so that readers seek a
+// version without touching the idx file. The writer extends the window of the file being written as it appends, and
+// readers load it from the idx file in chunks when they move past it.
+
+static void walIdxCacheDestroyEntry(SWalIdxCache *pCache) {
+  taosCloseFile(&pCache->pIdxFile);
+  taosMemoryFreeClear(pCache->offsets);
+}
+
+static SWalIdxCache *walIdxCacheGet(SWal *pWal, int64_t fileFirstVer) {
+  for (int32_t i = 0; i < taosArrayGetSize(pWal->idxCache); i++) {
+    SWalIdxCache *pCache = taosArrayGet(pWal->idxCache, i);
+    if (pCache->firstVer == fileFirstVer) return pCache;
+  }
+  return NULL;
+}
+
+static SWalIdxCache *walIdxCacheAdd(SWal *pWal, int64_t fileFirstVer) {
+  SWalIdxCache *pCache = NULL;
+
+  if (taosArrayGetSize(pWal->idxCache) < WAL_IDX_CACHE_FILES) {
+    SWalIdxCache cache = {0};
+    pCache = taosArrayPush(pWal->idxCache, &cache);
+    if (pCache == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return NULL;
+    }
+  } else {
+    // evict the least recently used one
+    for (int32_t i = 0; i < taosArrayGetSize(pWal->idxCache); i++) {
+      SWalIdxCache *pIter = taosArrayGet(pWal->idxCache, i);
+      if (pCache == NULL || pIter->lastUse < pCache->lastUse) pCache = pIter;
+    }
+    walIdxCacheDestroyEntry(pCache);
+  }
+
+  memset(pCache, 0, sizeof(*pCache));
+  pCache->firstVer = fileFirstVer;
+  pCache->offsets = taosMemoryMalloc(WAL_IDX_CACHE_ENTRIES * sizeof(int64_t));
+  if (pCache->offsets == NULL) {
+    taosArrayRemove(pWal->idxCache, TARRAY_ELEM_IDX(pWal->idxCache, pCache));
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  return pCache;
+}
+
+// make room for n more entries by sliding the window forward
+static void walIdxCacheMakeRoom(SWalIdxCache *pCache, int64_t n) {
+  if (pCache->nEntry + n <= WAL_IDX_CACHE_ENTRIES) return;
+
+  int64_t shift = TMAX(pCache->nEntry + n - WAL_IDX_CACHE_ENTRIES, WAL_IDX_CACHE_ENTRIES / 4);
+  shift = TMIN(shift, pCache->nEntry);
+  memmove(pCache->offsets, pCache->offsets + shift, (pCache->nEntry - shift) * sizeof(int64_t));
+  pCache->start += shift;
+  pCache->nEntry -= shift;
+}
+
+static int32_t walIdxCacheLoad(SWal *pWal, SWalIdxCache *pCache, int64_t idx) {
+  char fnameStr[WAL_FILE_LEN];
+
+  if (pCache->pIdxFile == NULL) {
+    walBuildIdxName(pWal, pCache->firstVer, fnameStr);
+    pCache->pIdxFile = taosOpenFile(fnameStr, TD_FILE_READ);
+    if (pCache->pIdxFile == NULL) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      wError("vgId:%d, cannot open file %s, since %s", pWal->cfg.vgId, fnameStr, terrstr());
+      return -1;
+    }
+  }
+
+  int64_t fileSize = 0;
+  if (taosFStatFile(pCache->pIdxFile, &fileSize, NULL) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, failed to stat idx file of %" PRId64 " since %s", pWal->cfg.vgId, pCache->firstVer, terrstr());
+    return -1;
+  }
+
+  int64_t nFileEntry = fileSize / sizeof(SWalIdxEntry);
+  if (idx >= nFileEntry) {
+    terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+    wError("vgId:%d, read idx file incompletely, index:%" PRId64 ", idx entries:%" PRId64, pWal->cfg.vgId,
+           pCache->firstVer + idx, nFileEntry);
+    return -1;
+  }
+
+  // not following the window, restart it from idx
+  if (idx < pCache->start || idx >= pCache->start + pCache->nEntry + WAL_IDX_CACHE_LOAD_ENTRIES) {
+    pCache->start = idx;
+    pCache->nEntry = 0;
+  }
+
+  int64_t from = pCache->start + pCache->nEntry;
+  int64_t to = TMIN(nFileEntry, from + WAL_IDX_CACHE_LOAD_ENTRIES);
+  walIdxCacheMakeRoom(pCache, to - from);
+
+  SWalIdxEntry *aEntry = taosMemoryMalloc((to - from) * sizeof(SWalIdxEntry));
+  if (aEntry == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int64_t size = (to - from) * sizeof(SWalIdxEntry);
+  int64_t ret = taosPReadFile(pCache->pIdxFile, aEntry, size, from * sizeof(SWalIdxEntry));
+  if (ret != size) {
+    if (ret < 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      wError("vgId:%d, failed to read idx file, since %s", pWal->cfg.vgId, terrstr());
+    } else {
+      terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+      wError("vgId:%d, read idx file incompletely, read bytes %" PRId64 ", bytes should be %" PRId64, pWal->cfg.vgId,
+             ret, size);
+    }
+    taosMemoryFree(aEntry);
+    return -1;
+  }
+
+  for (int64_t i = 0; i < to - from; i++) {
+    if (aEntry[i].ver != pCache->firstVer + from + i) {
+      terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+      wError("vgId:%d, idx entry mismatch, index:%" PRId64 ", entry ver:%" PRId64, pWal->cfg.vgId,
+             pCache->firstVer + from + i, aEntry[i].ver);
+      taosMemoryFree(aEntry);
+      return -1;
+    }
+    pCache->offsets[pCache->nEntry++] = aEntry[i].offset;
+  }
+
+  taosMemoryFree(aEntry);
+  return 0;
+}
+
+int32_t walIdxCacheGetOffset(SWal *pWal, int64_t fileFirstVer, int64_t ver, int64_t *pOffset) {
+  int32_t code = 0;
+  int64_t idx = ver - fileFirstVer;
+
+  taosThreadMutexLock(&pWal->idxMutex);
+
+  SWalIdxCache *pCache = walIdxCacheGet(pWal, fileFirstVer);
+  if (pCache == NULL && (pCache = walIdxCacheAdd(pWal, fileFirstVer)) == NULL) {
+    code = -1;
+    goto _exit;
+  }
+  pCache->lastUse = ++pWal->idxCacheSeq;
+
+  if (idx < pCache->start || idx >= pCache->start + pCache->nEntry) {
+    if (walIdxCacheLoad(pWal, pCache, idx) < 0) {
+      code = -1;
+      goto _exit;
+    }
+  }
+
+  *pOffset = pCache->offsets[idx - pCache->start];
+
+_exit:
+  taosThreadMutexUnlock(&pWal->idxMutex);
+  return code;
+}
+
+void walIdxCacheAppend(SWal *pWal, int64_t fileFirstVer, int64_t ver, int64_t offset) {
+  taosThreadMutexLock(&pWal->idxMutex);
+
+  SWalIdxCache *pCache = walIdxCacheGet(pWal, fileFirstVer);
+  if (pCache != NULL && pCache->start + pCache->nEntry == ver - fileFirstVer) {
+    walIdxCacheMakeRoom(pCache, 1);
+    pCache->offsets[pCache->nEntry++] = offset;
+  }
+
+  taosThreadMutexUnlock(&pWal->idxMutex);
+}
+
+void walIdxCacheTruncate(SWal *pWal, int64_t ver) {
+  taosThreadMutexLock(&pWal->idxMutex);
+
+  for (int32_t i = taosArrayGetSize(pWal->idxCache) - 1; i >= 0; i--) {
+    SWalIdxCache *pCache = taosArrayGet(pWal->idxCache, i);
+    if (pCache->firstVer >= ver) {
+      walIdxCacheDestroyEntry(pCache);
+      taosArrayRemove(pWal->idxCache, i);
+    } else {
+      int64_t nEntry = ver - pCache->firstVer - pCache->start;
+      pCache->nEntry = TMAX(0, TMIN(pCache->nEntry, nEntry));
+    }
+  }
+
+  taosThreadMutexUnlock(&pWal->idxMutex);
+}
+
+void walIdxCacheRemove(SWal *pWal, int64_t fileFirstVer) {
+  taosThreadMutexLock(&pWal->idxMutex);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pWal->idxCache); i++) {
+    SWalIdxCache *pCache = taosArrayGet(pWal->idxCache, i);
+    if (pCache->firstVer == fileFirstVer) {
+      walIdxCacheDestroyEntry(pCache);
+      taosArrayRemove(pWal->idxCache, i);
+      break;
+    }
+  }
+
+  taosThreadMutexUnlock(&pWal->idxMutex);
+}
+
+void walIdxCacheClear(SWal *pWal) {
+  taosThreadMutexLock(&pWal->idxMutex);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pWal->idxCache); i++) {
+    walIdxCacheDestroyEntry(taosArrayGet(pWal->idxCache, i));
+  }
+  taosArrayClear(pWal->idxCache);
+
+  taosThreadMutexUnlock(&pWal->idxMutex);
+}
@@ -87,6 +87,13 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     return NULL;
   }
 
+  if (taosThreadMutexInit(&pWal->idxMutex, NULL) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    taosThreadMutexDestroy(&pWal->mutex);
+    taosMemoryFree(pWal);
+    return NULL;
+  }
+
   // set config
   memcpy(&pWal->cfg, pCfg, sizeof(SWalCfg));
 
@@ -126,6 +133,14 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     goto _err;
   }
 
+  // init idx cache
+  pWal->idxCache = taosArrayInit(WAL_IDX_CACHE_FILES, sizeof(SWalIdxCache));
+  if (pWal->idxCache == NULL) {
+    wError("vgId:%d, failed to init taosArray of idxCache due to %s. path:%s", pWal->cfg.vgId, strerror(errno),
+           pWal->path);
+    goto _err;
+  }
+
   // init gc
   pWal->toDeleteFiles = taosArrayInit(8, sizeof(SWalFileInfo));
   if (pWal->toDeleteFiles == NULL) {
@@ -156,6 +171,9 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     goto _err;
   }
 
+  pWal->syncedVer = pWal->vers.lastVer;
+  pWal->groupSize = 0;
+
   // add ref
   pWal->refId = taosAddRef(tsWal.refSetId, pWal);
   if (pWal->refId < 0) {
@@ -169,7 +187,9 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
 
 _err:
   taosArrayDestroy(pWal->fileInfoSet);
+  taosArrayDestroy(pWal->idxCache);
   taosHashCleanup(pWal->pRefHash);
+  taosThreadMutexDestroy(&pWal->idxMutex);
   taosThreadMutexDestroy(&pWal->mutex);
   taosMemoryFree(pWal);
   pWal = NULL;
@@ -179,6 +199,12 @@ _err:
 int32_t walAlter(SWal *pWal, SWalCfg *pCfg) {
   if (pWal == NULL) return TSDB_CODE_APP_ERROR;
 
+  taosThreadMutexLock(&pWal->mutex);
+  bool inGroupCommit = walInGroupCommit(pWal);
+  pWal->cfg.groupCommitWindow = pCfg->groupCommitWindow;
+  pWal->cfg.groupCommitSize = pCfg->groupCommitSize;
+  taosThreadMutexUnlock(&pWal->mutex);
+
   if (pWal->cfg.level == pCfg->level && pWal->cfg.fsyncPeriod == pCfg->fsyncPeriod &&
       pWal->cfg.retentionPeriod == pCfg->retentionPeriod && pWal->cfg.retentionSize == pCfg->retentionSize) {
     wDebug("vgId:%d, walLevel:%d fsync:%d walRetentionPeriod:%d walRetentionSize:%" PRId64 " not change",
@@ -191,10 +217,20 @@ int32_t walAlter(SWal *pWal, SWalCfg *pCfg) {
         pWal->cfg.vgId, pWal->cfg.level, pWal->cfg.fsyncPeriod, pWal->cfg.retentionPeriod, pWal->cfg.retentionSize,
         pCfg->level, pCfg->fsyncPeriod, pCfg->retentionPeriod, pCfg->retentionSize);
 
+  taosThreadMutexLock(&pWal->mutex);
+  // leaving group commit mode, make the deferred appends durable
+  if (inGroupCommit) {
+    (void)walFsyncGroup(pWal);
+  }
   pWal->cfg.level = pCfg->level;
   pWal->cfg.fsyncPeriod = pCfg->fsyncPeriod;
   pWal->cfg.retentionPeriod = pCfg->retentionPeriod;
   pWal->cfg.retentionSize = pCfg->retentionSize;
+  if (!inGroupCommit && walInGroupCommit(pWal)) {
+    pWal->syncedVer = pWal->vers.lastVer;
+    pWal->groupSize = 0;
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
 
   pWal->fsyncSeq = pCfg->fsyncPeriod / 1000;
   if (pWal->fsyncSeq <= 0) pWal->fsyncSeq = 1;
@@ -211,6 +247,7 @@ int32_t walPersist(SWal *pWal) {
 
 void walClose(SWal *pWal) {
   taosThreadMutexLock(&pWal->mutex);
+  (void)walFsyncGroup(pWal);
   (void)walSaveMeta(pWal);
   taosCloseFile(&pWal->pLogFile);
   pWal->pLogFile = NULL;
@@ -220,6 +257,9 @@ void walClose(SWal *pWal) {
   pWal->fileInfoSet = NULL;
   taosArrayDestroy(pWal->toDeleteFiles);
   pWal->toDeleteFiles = NULL;
+  walIdxCacheClear(pWal);
+  taosArrayDestroy(pWal->idxCache);
+  pWal->idxCache = NULL;
 
   void *pIter = NULL;
   while (1) {
@@ -240,6 +280,8 @@ static void walFreeObj(void *wal) {
   wDebug("vgId:%d, wal:%p is freed", pWal->cfg.vgId, pWal);
 
   taosThreadMutexDestroy(&pWal->mutex);
+  taosThreadMutexDestroy(&pWal->idxMutex);
+  taosMemoryFreeClear(pWal->writeBuf);
   taosMemoryFreeClear(pWal);
 }
 
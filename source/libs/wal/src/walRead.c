@@ -29,7 +29,6 @@ SWalReader *walOpenReader(SWal *pWal, SWalFilterCond *cond) {
 
   pReader->pWal = pWal;
   pReader->readerId = tGenIdPI64();
-  pReader->pIdxFile = NULL;
   pReader->pLogFile = NULL;
   pReader->curVersion = -1;
   pReader->curFileFirstVer = -1;
@@ -59,9 +58,16 @@ SWalReader *walOpenReader(SWal *pWal, SWalFilterCond *cond) {
   return pReader;
 }
 
+static void walReadCloseFiles(SWalReader *pReader) {
+  for (int32_t i = 0; i < WAL_READER_FILES; i++) {
+    taosCloseFile(&pReader->files[i].pLogFile);
+  }
+  memset(pReader->files, 0, sizeof(pReader->files));
+  pReader->pLogFile = NULL;
+}
+
 void walCloseReader(SWalReader *pReader) {
-  taosCloseFile(&pReader->pIdxFile);
-  taosCloseFile(&pReader->pLogFile);
+  walReadCloseFiles(pReader);
   /*if (pReader->cond.enableRef) {*/
   /*taosHashRemove(pReader->pWal->pRefHash, &pReader->readerId, sizeof(int64_t));*/
   /*}*/
@@ -104,68 +110,64 @@ int64_t walReaderGetCurrentVer(const SWalReader *pReader) { return pReader->curV
 
 static int64_t walReadSeekFilePos(SWalReader *pReader, int64_t fileFirstVer, int64_t ver) {
   int64_t ret = 0;
+  int64_t offset = 0;
 
-  TdFilePtr pIdxTFile = pReader->pIdxFile;
-  TdFilePtr pLogTFile = pReader->pLogFile;
-
-  // seek position
-  int64_t offset = (ver - fileFirstVer) * sizeof(SWalIdxEntry);
-  ret = taosLSeekFile(pIdxTFile, offset, SEEK_SET);
-  if (ret < 0) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, failed to seek idx file, index:%" PRId64 ", pos:%" PRId64 ", since %s", pReader->pWal->cfg.vgId,
-           ver, offset, terrstr());
-    return -1;
-  }
-  SWalIdxEntry entry = {0};
-  if ((ret = taosReadFile(pIdxTFile, &entry, sizeof(SWalIdxEntry))) != sizeof(SWalIdxEntry)) {
-    if (ret < 0) {
-      terrno = TAOS_SYSTEM_ERROR(errno);
-      wError("vgId:%d, failed to read idx file, since %s", pReader->pWal->cfg.vgId, terrstr());
-    } else {
-      terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
-      wError("vgId:%d, read idx file incompletely, read bytes %" PRId64 ", bytes should be %ld",
-             pReader->pWal->cfg.vgId, ret, sizeof(SWalIdxEntry));
-    }
+  // error code was set inner
+  if (walIdxCacheGetOffset(pReader->pWal, fileFirstVer, ver, &offset) < 0) {
     return -1;
   }
 
-  ret = taosLSeekFile(pLogTFile, entry.offset, SEEK_SET);
+  ret = taosLSeekFile(pReader->pLogFile, offset, SEEK_SET);
   if (ret < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     wError("vgId:%d, failed to seek log file, index:%" PRId64 ", pos:%" PRId64 ", since %s", pReader->pWal->cfg.vgId,
-           ver, entry.offset, terrstr());
+           ver, offset, terrstr());
     return -1;
   }
   return ret;
 }
 
 static int32_t walReadChangeFile(SWalReader *pReader, int64_t fileFirstVer) {
-  char fnameStr[WAL_FILE_LEN] = {0};
-
-  taosCloseFile(&pReader->pIdxFile);
-  taosCloseFile(&pReader->pLogFile);
-
-  walBuildLogName(pReader->pWal, fileFirstVer, fnameStr);
-  TdFilePtr pLogFile = taosOpenFile(fnameStr, TD_FILE_READ);
-  if (pLogFile == NULL) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, cannot open file %s, since %s", pReader->pWal->cfg.vgId, fnameStr, terrstr());
-    return -1;
+  char           fnameStr[WAL_FILE_LEN] = {0};
+  SWalReaderFile file = {.firstVer = fileFirstVer};
+  int32_t        i = 0;
+
+  // release files removed from the wal since
+  for (int32_t j = WAL_READER_FILES - 1; j >= 0; j--) {
+    if (pReader->files[j].pLogFile != NULL && pReader->files[j].firstVer < pReader->pWal->vers.firstVer) {
+      if (pReader->pLogFile == pReader->files[j].pLogFile) {
+        pReader->pLogFile = NULL;
+        pReader->curFileFirstVer = -1;
+      }
+      taosCloseFile(&pReader->files[j].pLogFile);
+      memmove(&pReader->files[j], &pReader->files[j + 1], (WAL_READER_FILES - j - 1) * sizeof(SWalReaderFile));
+      memset(&pReader->files[WAL_READER_FILES - 1], 0, sizeof(SWalReaderFile));
+    }
   }
 
-  pReader->pLogFile = pLogFile;
+  // keep the files opened by the reader, so that moving across a roll boundary does not reopen them
+  for (; i < WAL_READER_FILES - 1; i++) {
+    if (pReader->files[i].pLogFile == NULL || pReader->files[i].firstVer == fileFirstVer) break;
+  }
 
-  walBuildIdxName(pReader->pWal, fileFirstVer, fnameStr);
-  TdFilePtr pIdxFile = taosOpenFile(fnameStr, TD_FILE_READ);
-  if (pIdxFile == NULL) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, cannot open file %s, since %s", pReader->pWal->cfg.vgId, fnameStr, terrstr());
-    return -1;
+  if (pReader->files[i].pLogFile != NULL && pReader->files[i].firstVer == fileFirstVer) {
+    file = pReader->files[i];
+  } else {
+    walBuildLogName(pReader->pWal, fileFirstVer, fnameStr);
+    file.pLogFile = taosOpenFile(fnameStr, TD_FILE_READ);
+    if (file.pLogFile == NULL) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      wError("vgId:%d, cannot open file %s, since %s", pReader->pWal->cfg.vgId, fnameStr, terrstr());
+      return -1;
+    }
+    // evict the least recently used one
+    taosCloseFile(&pReader->files[i].pLogFile);
   }
 
-  pReader->pIdxFile = pIdxFile;
+  memmove(&pReader->files[1], &pReader->files[0], i * sizeof(SWalReaderFile));
+  pReader->files[0] = file;
 
+  pReader->pLogFile = file.pLogFile;
   pReader->curFileFirstVer = fileFirstVer;
 
   return 0;
@@ -563,8 +565,7 @@ int32_t walReadVer(SWalReader *pReader, int64_t ver) {
 
 void walReadReset(SWalReader *pReader) {
   taosThreadMutexLock(&pReader->mutex);
-  taosCloseFile(&pReader->pIdxFile);
-  taosCloseFile(&pReader->pLogFile);
+  walReadCloseFiles(pReader);
   pReader->curFileFirstVer = -1;
   pReader->curVersion = -1;
   taosThreadMutexUnlock(&pReader->mutex);
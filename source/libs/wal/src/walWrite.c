@@ -19,6 +19,8 @@
 #include "tglobal.h"
 #include "walInt.h"
 
+#define WAL_WRITE_COALESCE_SIZE (64 * 1024)
+
 int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
   taosThreadMutexLock(&pWal->mutex);
 
@@ -75,6 +77,9 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
   pWal->vers.commitVer = ver;
   pWal->vers.snapshotVer = ver;
   pWal->vers.verInSnapshotting = -1;
+  pWal->syncedVer = ver;
+  pWal->groupSize = 0;
+  walIdxCacheClear(pWal);
 
   taosThreadMutexUnlock(&pWal->mutex);
   return 0;
@@ -202,6 +207,8 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
   pWal->vers.lastVer = ver - 1;
+  pWal->syncedVer = TMIN(pWal->syncedVer, pWal->vers.lastVer);
+  walIdxCacheTruncate(pWal, ver);
   ((SWalFileInfo *)taosArrayGetLast(pWal->fileInfoSet))->lastVer = ver - 1;
   ((SWalFileInfo *)taosArrayGetLast(pWal->fileInfoSet))->fileSize = entry.offset;
   taosCloseFile(&pIdxFile);
@@ -373,6 +380,7 @@ int32_t walEndSnapshot(SWal *pWal) {
   char fnameStr[WAL_FILE_LEN];
   for (int i = 0; i < deleteCnt; i++) {
     pInfo = taosArrayGet(pWal->toDeleteFiles, i);
+    walIdxCacheRemove(pWal, pInfo->firstVer);
     walBuildLogName(pWal, pInfo->firstVer, fnameStr);
     wDebug("vgId:%d, wal remove file %s", pWal->cfg.vgId, fnameStr);
     if (taosRemoveFile(fnameStr) < 0 && errno != ENOENT) {
@@ -415,6 +423,8 @@ int32_t walRollImpl(SWal *pWal) {
       terrno = TAOS_SYSTEM_ERROR(errno);
       goto END;
     }
+    pWal->syncedVer = pWal->vers.lastVer;
+    pWal->groupSize = 0;
     code = taosCloseFile(&pWal->pLogFile);
     if (code != 0) {
       terrno = TAOS_SYSTEM_ERROR(errno);
@@ -479,11 +489,43 @@ static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
     return -1;
   }
 
-  // check alignment of idx entries
-  int64_t endOffset = taosLSeekFile(pWal->pIdxFile, 0, SEEK_END);
-  if (endOffset < 0) {
-    wFatal("vgId:%d, failed to seek end of idxfile due to %s. ver:%" PRId64 "", pWal->cfg.vgId, strerror(errno), ver);
+  return 0;
+}
+
+static int32_t walWriteLog(SWal *pWal, const void *body, int32_t bodyLen) {
+  int64_t size = sizeof(SWalCkHead) + bodyLen;
+
+  // write head and body in one call for small entries
+  if (size <= WAL_WRITE_COALESCE_SIZE) {
+    if (pWal->writeBufSize < size) {
+      char *pBuf = taosMemoryRealloc(pWal->writeBuf, size);
+      if (pBuf != NULL) {
+        pWal->writeBuf = pBuf;
+        pWal->writeBufSize = size;
+      }
+    }
+
+    if (pWal->writeBufSize >= size) {
+      memcpy(pWal->writeBuf, &pWal->writeHead, sizeof(SWalCkHead));
+      memcpy(pWal->writeBuf + sizeof(SWalCkHead), body, bodyLen);
+      if (taosWriteFile(pWal->pLogFile, pWal->writeBuf, size) != size) {
+        terrno = TAOS_SYSTEM_ERROR(errno);
+        return -1;
+      }
+      return 0;
+    }
+  }
+
+  if (taosWriteFile(pWal->pLogFile, &pWal->writeHead, sizeof(SWalCkHead)) != sizeof(SWalCkHead)) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
   }
+
+  if (taosWriteFile(pWal->pLogFile, (char *)body, bodyLen) != bodyLen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
   return 0;
 }
 
@@ -512,16 +554,7 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
     goto END;
   }
 
-  if (taosWriteFile(pWal->pLogFile, &pWal->writeHead, sizeof(SWalCkHead)) != sizeof(SWalCkHead)) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
-           strerror(errno));
-    code = -1;
-    goto END;
-  }
-
-  if (taosWriteFile(pWal->pLogFile, (char *)body, bodyLen) != bodyLen) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
+  if (walWriteLog(pWal, body, bodyLen) < 0) {
     wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
            strerror(errno));
     code = -1;
@@ -536,6 +569,12 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   pWal->totSize += sizeof(SWalCkHead) + bodyLen;
   pFileInfo->lastVer = index;
   pFileInfo->fileSize += sizeof(SWalCkHead) + bodyLen;
+  walIdxCacheAppend(pWal, pFileInfo->firstVer, index, offset);
+
+  if (walInGroupCommit(pWal)) {
+    if (pWal->groupSize == 0) pWal->groupStartUs = taosGetTimestampUs();
+    pWal->groupSize += sizeof(SWalCkHead) + bodyLen;
+  }
 
   return 0;
 
@@ -587,6 +626,136 @@ int64_t walAppendLog(SWal *pWal, int64_t index, tmsg_t msgType, SWalSyncInfo syn
   return index;
 }
 
+static int32_t walWriteBatchImpl(SWal *pWal, const SWalLogItem *aItem, int32_t nItem) {
+  int64_t       offset = walGetCurFileOffset(pWal);
+  SWalFileInfo *pFileInfo = walGetCurFileInfo(pWal);
+  int64_t       firstVer = aItem[0].index;
+  int64_t       lastVer = aItem[nItem - 1].index;
+
+  int64_t logSize = 0;
+  for (int32_t i = 0; i < nItem; i++) {
+    logSize += sizeof(SWalCkHead) + aItem[i].bodyLen;
+  }
+  int64_t idxSize = nItem * sizeof(SWalIdxEntry);
+
+  char *pBuf = taosMemoryMalloc(logSize + idxSize);
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  // lay out the log records followed by their idx entries
+  SWalIdxEntry *aIdx = (SWalIdxEntry *)(pBuf + logSize);
+  int64_t       pos = 0;
+  for (int32_t i = 0; i < nItem; i++) {
+    const SWalLogItem *pItem = &aItem[i];
+
+    pWal->writeHead.head.version = pItem->index;
+    pWal->writeHead.head.bodyLen = pItem->bodyLen;
+    pWal->writeHead.head.msgType = pItem->msgType;
+    pWal->writeHead.head.ingestTs = 0;
+    pWal->writeHead.head.syncMeta = pItem->syncMeta;
+    pWal->writeHead.cksumHead = walCalcHeadCksum(&pWal->writeHead);
+    pWal->writeHead.cksumBody = walCalcBodyCksum(pItem->body, pItem->bodyLen);
+
+    aIdx[i].ver = pItem->index;
+    aIdx[i].offset = offset + pos;
+
+    memcpy(pBuf + pos, &pWal->writeHead, sizeof(SWalCkHead));
+    memcpy(pBuf + pos + sizeof(SWalCkHead), pItem->body, pItem->bodyLen);
+    pos += sizeof(SWalCkHead) + pItem->bodyLen;
+  }
+
+  wDebug("vgId:%d, wal write logs from %" PRId64 " to %" PRId64 ", size:%" PRId64, pWal->cfg.vgId, firstVer, lastVer,
+         logSize);
+
+  if (taosWriteFile(pWal->pIdxFile, aIdx, idxSize) != idxSize) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, failed to write idx entries due to %s. ver:%" PRId64, pWal->cfg.vgId, strerror(errno), firstVer);
+    goto _err;
+  }
+
+  if (taosWriteFile(pWal->pLogFile, pBuf, logSize) != logSize) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
+           strerror(errno));
+    goto _err;
+  }
+
+  // set status
+  if (pWal->vers.firstVer == -1) {
+    pWal->vers.firstVer = 0;
+  }
+  pWal->vers.lastVer = lastVer;
+  pWal->totSize += logSize;
+  pFileInfo->lastVer = lastVer;
+  pFileInfo->fileSize += logSize;
+  for (int32_t i = 0; i < nItem; i++) {
+    walIdxCacheAppend(pWal, pFileInfo->firstVer, aIdx[i].ver, aIdx[i].offset);
+  }
+
+  if (walInGroupCommit(pWal)) {
+    if (pWal->groupSize == 0) pWal->groupStartUs = taosGetTimestampUs();
+    pWal->groupSize += logSize;
+  }
+
+  taosMemoryFree(pBuf);
+  return 0;
+
+_err:
+  // recover in a reverse order
+  if (taosFtruncateFile(pWal->pLogFile, offset) < 0) {
+    wFatal("vgId:%d, failed to ftruncate logfile to offset:%" PRId64 " during recovery due to %s", pWal->cfg.vgId,
+           offset, strerror(errno));
+  }
+
+  int64_t idxOffset = (firstVer - pFileInfo->firstVer) * sizeof(SWalIdxEntry);
+  if (taosFtruncateFile(pWal->pIdxFile, idxOffset) < 0) {
+    wFatal("vgId:%d, failed to ftruncate idxfile to offset:%" PRId64 "during recovery due to %s", pWal->cfg.vgId,
+           idxOffset, strerror(errno));
+  }
+
+  taosMemoryFree(pBuf);
+  return -1;
+}
+
+int64_t walAppendLogs(SWal *pWal, const SWalLogItem *aItem, int32_t nItem) {
+  if (nItem == 1) {
+    return walAppendLog(pWal, aItem[0].index, aItem[0].msgType, aItem[0].syncMeta, aItem[0].body, aItem[0].bodyLen);
+  }
+
+  taosThreadMutexLock(&pWal->mutex);
+
+  for (int32_t i = 0; i < nItem; i++) {
+    if (aItem[i].index != pWal->vers.lastVer + 1 + i) {
+      terrno = TSDB_CODE_WAL_INVALID_VER;
+      taosThreadMutexUnlock(&pWal->mutex);
+      return -1;
+    }
+  }
+
+  // the batch goes to one file, which may end a little beyond the configured segment size
+  if (walCheckAndRoll(pWal) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
+  if (pWal->pLogFile == NULL || pWal->pIdxFile == NULL || pWal->writeCur < 0) {
+    if (walInitWriteFile(pWal) < 0) {
+      taosThreadMutexUnlock(&pWal->mutex);
+      return -1;
+    }
+  }
+
+  if (walWriteBatchImpl(pWal, aItem, nItem) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
+  taosThreadMutexUnlock(&pWal->mutex);
+  return aItem[nItem - 1].index;
+}
+
 int32_t walWriteWithSyncInfo(SWal *pWal, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta, const void *body,
                              int32_t bodyLen) {
   int32_t code = 0;
@@ -632,14 +801,66 @@ int32_t walWrite(SWal *pWal, int64_t index, tmsg_t msgType, const void *body, in
   return walWriteWithSyncInfo(pWal, index, msgType, syncMeta, body, bodyLen);
 }
 
+bool walInGroupCommit(SWal *pWal) {
+  return pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0 && pWal->cfg.groupCommitWindow > 0;
+}
+
+static bool walGroupCommitDue(SWal *pWal) {
+  if (pWal->cfg.groupCommitSize > 0 && pWal->groupSize >= pWal->cfg.groupCommitSize) return true;
+  return taosGetTimestampUs() - pWal->groupStartUs >= pWal->cfg.groupCommitWindow;
+}
+
 void walFsync(SWal *pWal, bool forceFsync) {
   taosThreadMutexLock(&pWal->mutex);
   if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
+    // in group commit mode, appends share one fsync until the group is full or the window elapses
+    if (!forceFsync && walInGroupCommit(pWal) && !walGroupCommitDue(pWal)) {
+      taosThreadMutexUnlock(&pWal->mutex);
+      return;
+    }
+
     wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
     if (taosFsyncFile(pWal->pLogFile) < 0) {
       wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
              strerror(errno));
+    } else {
+      pWal->syncedVer = pWal->vers.lastVer;
+      pWal->groupSize = 0;
     }
   }
   taosThreadMutexUnlock(&pWal->mutex);
 }
+
+int32_t walFsyncGroup(SWal *pWal) {
+  if (pWal->groupSize == 0 || pWal->pLogFile == NULL) return 0;
+
+  wTrace("vgId:%d, fileId:%" PRId64 ".log, do group fsync, size:%" PRId64, pWal->cfg.vgId,
+         walGetCurFileFirstVer(pWal), pWal->groupSize);
+  if (taosFsyncFile(pWal->pLogFile) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
+           strerror(errno));
+    return -1;
+  }
+
+  pWal->syncedVer = pWal->vers.lastVer;
+  pWal->groupSize = 0;
+  return 0;
+}
+
+int32_t walFsyncPending(SWal *pWal) {
+  taosThreadMutexLock(&pWal->mutex);
+  int32_t code = walFsyncGroup(pWal);
+  taosThreadMutexUnlock(&pWal->mutex);
+  return code;
+}
+
+int64_t walGetSyncedVer(SWal *pWal) {
+  taosThreadMutexLock(&pWal->mutex);
+  int64_t ver = pWal->vers.lastVer;
+  if (walInGroupCommit(pWal)) {
+    ver = TMIN(pWal->syncedVer, ver);
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
+  return ver;
+}
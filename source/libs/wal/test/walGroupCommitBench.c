@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures append throughput of a wal with fsync on every append, compared with group commit windows of growing
+// size. Appends arrive in batches as they do from the vnode write queue, and each batch ends with a flush.
+
+#include "walInt.h"
+
+static int32_t benchRun(const char *path, int32_t window, int64_t groupSize, int32_t nMsg, int32_t nBatch,
+                        int32_t msgLen) {
+  taosRemoveDir(path);
+
+  SWalCfg cfg = {0};
+  cfg.rollPeriod = -1;
+  cfg.segSize = -1;
+  cfg.level = TAOS_WAL_FSYNC;
+  cfg.groupCommitWindow = window;
+  cfg.groupCommitSize = groupSize;
+
+  SWal *pWal = walOpen(path, &cfg);
+  if (pWal == NULL) {
+    printf("failed to open wal since %s\n", tstrerror(terrno));
+    return -1;
+  }
+
+  char        *body = taosMemoryCalloc(1, msgLen);
+  SWalSyncInfo syncMeta = {0};
+  int32_t      code = 0;
+  int64_t      start = taosGetTimestampUs();
+
+  for (int32_t i = 0; i < nMsg; i++) {
+    if (walAppendLog(pWal, i, TDMT_VND_SUBMIT, syncMeta, body, msgLen) < 0) {
+      code = -1;
+      break;
+    }
+    walFsync(pWal, false);
+    if ((i + 1) % nBatch == 0 && walFsyncPending(pWal) < 0) {
+      code = -1;
+      break;
+    }
+  }
+  if (code == 0) code = walFsyncPending(pWal);
+
+  double usedTime = (taosGetTimestampUs() - start) / 1000000.0;
+  printf("window:%dus size:%" PRId64 " msgs:%d batch:%d len:%d used:%.3fs msgs/sec:%.0f%s\n", window, groupSize, nMsg,
+         nBatch, msgLen, usedTime, nMsg / usedTime, code ? " failed" : "");
+
+  taosMemoryFree(body);
+  walClose(pWal);
+  taosRemoveDir(path);
+  return code;
+}
+
+int main(int argc, char *argv[]) {
+  int32_t nMsg = 10000;
+  int32_t nBatch = 64;
+  int32_t msgLen = 1024;
+  int32_t maxWindow = 8000;
+  char    path[PATH_MAX] = TD_TMP_DIR_PATH "wal_bench";
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      nMsg = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-b") == 0 && i < argc - 1) {
+      nBatch = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0 && i < argc - 1) {
+      msgLen = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-w") == 0 && i < argc - 1) {
+      maxWindow = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-d") == 0 && i < argc - 1) {
+      tstrncpy(path, argv[++i], sizeof(path));
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-n msgs]: number of appended msgs, default is:%d\n", nMsg);
+      printf("  [-b batch]: number of msgs between two flushes, default is:%d\n", nBatch);
+      printf("  [-l len]: length of each msg, default is:%d\n", msgLen);
+      printf("  [-w window]: max group commit window in microseconds, default is:%d\n", maxWindow);
+      printf("  [-d dir]: wal directory, default is:%s\n", path);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  if (walInit() < 0) {
+    printf("failed to init wal since %s\n", tstrerror(terrno));
+    return -1;
+  }
+
+  // fsync on every append
+  if (benchRun(path, 0, 0, nMsg, nBatch, msgLen) < 0) goto _exit;
+
+  for (int32_t window = 500; window <= maxWindow; window <<= 1) {
+    if (benchRun(path, window, 4 * 1024 * 1024L, nMsg, nBatch, msgLen) < 0) break;
+  }
+
+_exit:
+  walCleanUp();
+  return 0;
+}
@@ -257,6 +257,80 @@ TEST_F(WalCleanEnv, rollback) {
   ASSERT_EQ(code, 0);
 }
 
+TEST_F(WalCleanEnv, groupCommit) {
+  int code;
+  pWal->cfg.groupCommitWindow = 1000000000;
+  pWal->cfg.groupCommitSize = 10 * (sizeof(SWalCkHead) + ranStrLen);
+  ASSERT_TRUE(walInGroupCommit(pWal));
+
+  for (int i = 0; i < 9; i++) {
+    code = walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+    walFsync(pWal, false);
+    ASSERT_EQ(walGetSyncedVer(pWal), -1);
+  }
+  code = walWrite(pWal, 9, 10, (void*)ranStr, ranStrLen);
+  ASSERT_EQ(code, 0);
+  walFsync(pWal, false);
+  ASSERT_EQ(walGetSyncedVer(pWal), 9);
+
+  for (int i = 10; i < 15; i++) {
+    code = walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+    walFsync(pWal, false);
+  }
+  ASSERT_EQ(walGetSyncedVer(pWal), 9);
+  code = walFsyncPending(pWal);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(walGetSyncedVer(pWal), 14);
+
+  code = walRollback(pWal, 12);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(walGetSyncedVer(pWal), 11);
+}
+
+TEST_F(WalCleanEnv, appendLogs) {
+  int         code;
+  char        bodies[20][100];
+  SWalLogItem items[20];
+  for (int i = 0; i < 20; i++) {
+    sprintf(bodies[i], "%s-%d", ranStr, i);
+    items[i].index = i;
+    items[i].msgType = i + 1;
+    items[i].syncMeta.isWeek = 0;
+    items[i].syncMeta.seqNum = i;
+    items[i].syncMeta.term = 1;
+    items[i].body = bodies[i];
+    items[i].bodyLen = strlen(bodies[i]);
+  }
+
+  ASSERT_EQ(walAppendLogs(pWal, items, 1), 0);
+  ASSERT_EQ(walAppendLogs(pWal, items + 1, 9), 9);
+  ASSERT_EQ(pWal->vers.lastVer, 9);
+
+  // versions must follow the last one
+  ASSERT_EQ(walAppendLogs(pWal, items + 11, 9), -1);
+  ASSERT_EQ(pWal->vers.lastVer, 9);
+  ASSERT_EQ(walAppendLogs(pWal, items + 10, 10), 19);
+  ASSERT_EQ(pWal->vers.lastVer, 19);
+
+  SWalReader* pRead = walOpenReader(pWal, NULL);
+  ASSERT(pRead != NULL);
+  for (int ver = 19; ver >= 0; ver--) {
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+    ASSERT_EQ(pRead->pHead->head.msgType, ver + 1);
+    ASSERT_EQ(pRead->pHead->head.bodyLen, items[ver].bodyLen);
+    EXPECT_EQ(memcmp(pRead->pHead->head.body, bodies[ver], items[ver].bodyLen), 0);
+  }
+  walCloseReader(pRead);
+
+  code = walRollback(pWal, 5);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->vers.lastVer, 4);
+}
+
 TEST_F(WalCleanEnv, rollbackMultiFile) {
   int code;
   for (int i = 0; i < 10; i++) {
@@ -361,6 +435,47 @@ TEST_F(WalKeepEnv, readHandleRead) {
   walCloseReader(pRead);
 }
 
+TEST_F(WalCleanEnv, readAfterRollback) {
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL);
+  ASSERT(pRead != NULL);
+
+  for (int i = 0; i < 10; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+  code = walReadVer(pRead, 7);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pRead->pHead->head.version, 7);
+
+  // versions from 5 are written again with longer bodies, so their offsets change
+  code = walRollback(pWal, 5);
+  ASSERT_EQ(code, 0);
+  for (int i = 5; i < 10; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%s-%d", ranStr, ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+
+  for (int ver = 9; ver >= 0; ver--) {
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+    char newStr[100];
+    if (ver < 5) {
+      sprintf(newStr, "%s-%d", ranStr, ver);
+    } else {
+      sprintf(newStr, "%s-%s-%d", ranStr, ranStr, ver);
+    }
+    ASSERT_EQ(pRead->pHead->head.bodyLen, strlen(newStr));
+    ASSERT_EQ(memcmp(newStr, pRead->pHead->head.body, strlen(newStr)), 0);
+  }
+  walCloseReader(pRead);
+}
+
 TEST_F(WalRetentionEnv, repairMeta1) {
   walResetEnv();
   int code;
@@ -683,6 +683,26 @@ int32_t taosFsyncFile(TdFilePtr pFile) {
   return 0;
 }
 
+int32_t taosReadAheadFile(TdFilePtr pFile, int64_t offset, int64_t count) {
+  if (pFile == NULL || pFile->fd < 0 || count <= 0) {
+    return 0;
+  }
+
+#if defined(WINDOWS)
+  return 0;
+#elif defined(_TD_DARWIN_64)
+  struct radvisory ra = {.ra_offset = offset, .ra_count = (int)TMIN(count, INT32_MAX)};
+  return fcntl(pFile->fd, F_RDADVISE, &ra);
+#else
+  int32_t ret = posix_fadvise(pFile->fd, offset, count, POSIX_FADV_WILLNEED);
+  if (ret != 0) {
+    errno = ret;
+    return -1;
+  }
+  return 0;
+#endif
+}
+
 int64_t taosFSendFile(TdFilePtr pFileOut, TdFilePtr pFileIn, int64_t *offset, int64_t size) {
   if (pFileOut == NULL || pFileIn == NULL) {
     return 0;
@@ -227,6 +227,28 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
   return opos;
 }
 
+#if __AVX2__
+// decode the four zigzag values of w selected by shiftBits, and return the prefix sum of them based on prev_value
+static FORCE_INLINE __m256i tsDecodeSimple8bX4(__m256i base, __m256i shiftBits, __m256i maskVal, int64_t prev_value) {
+  __m256i zigzagVal = _mm256_and_si256(_mm256_srlv_epi64(base, shiftBits), maskVal);
+
+  // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
+  __m256i signmask = _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(_mm256_set1_epi64x(1), zigzagVal));
+  __m256i delta = _mm256_xor_si256(_mm256_srli_epi64(zigzagVal, 1), signmask);
+
+  // calculate the cumulative sum in registers
+  //  d0, d1,    d2,       d3
+  //+ 0,  d0,    d1,       d2
+  //+ 0,  0,     d0,       d0 + d1
+  //= d0, d0+d1, d0+d1+d2, d0+d1+d2+d3
+  __m256i zero = _mm256_setzero_si256();
+  delta = _mm256_add_epi64(delta, _mm256_blend_epi32(_mm256_permute4x64_epi64(delta, 0x90), zero, 0x03));
+  delta = _mm256_add_epi64(delta, _mm256_blend_epi32(_mm256_permute4x64_epi64(delta, 0x40), zero, 0x0F));
+
+  return _mm256_add_epi64(delta, _mm256_set1_epi64x(prev_value));
+}
+#endif
+
 int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
 
   int32_t word_length = 0;
@@ -315,48 +337,11 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
             __m256i inc = _mm256_set1_epi64x(bit << 2);
 
             for (int32_t i = 0; i < batch; ++i) {
-              __m256i after = _mm256_srlv_epi64(base, shiftBits);
-              __m256i zigzagVal = _mm256_and_si256(after, maskVal);
-
-              // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
-              __m256i signmask = _mm256_and_si256(_mm256_set1_epi64x(1), zigzagVal);
-              signmask = _mm256_sub_epi64(_mm256_setzero_si256(), signmask);
-              // get the four zigzag values here
-              __m256i delta = _mm256_xor_si256(_mm256_srli_epi64(zigzagVal, 1), signmask);
-
-              // calculate the cumulative sum (prefix sum) for each number
-              // decode[0] = prev_value + final[0]
-              // decode[1] = decode[0] + final[1]   -----> prev_value + final[0] + final[1]
-              // decode[2] = decode[1] + final[2]   -----> prev_value + final[0] + final[1] + final[2]
-              // decode[3] = decode[2] + final[3]   -----> prev_value + final[0] + final[1] + final[2] + final[3]
-
-              //  1, 2, 3, 4
-              //+ 0, 1, 0, 3
-              //  1, 3, 3, 7
-              // shift and add for the first round
-              __m128i prev = _mm_set1_epi64x(prev_value);
-              __m256i x =  _mm256_slli_si256(delta, 8);
-
-              delta = _mm256_add_epi64(delta, x);
-              _mm256_storeu_si256((__m256i *)&p[_pos], delta);
-
-              //  1, 3, 3, 7
-              //+ 0, 0, 3, 3
-              //  1, 3, 6, 10
-              // shift and add operation for the second round
-              __m128i firstPart = _mm_loadu_si128((__m128i *)&p[_pos]);
-              __m128i secondItem = _mm_set1_epi64x(p[_pos + 1]);
-              __m128i secPart = _mm_add_epi64(_mm_loadu_si128((__m128i *)&p[_pos + 2]), secondItem);
-              firstPart = _mm_add_epi64(firstPart, prev);
-              secPart = _mm_add_epi64(secPart, prev);
-
-              // save it in the memory
-              _mm_storeu_si128((__m128i *)&p[_pos], firstPart);
-              _mm_storeu_si128((__m128i *)&p[_pos + 2], secPart);
+              __m256i decoded = tsDecodeSimple8bX4(base, shiftBits, maskVal, prev_value);
+              _mm256_storeu_si256((__m256i *)&p[_pos], decoded);
 
               shiftBits = _mm256_add_epi64(shiftBits, inc);
               prev_value = p[_pos + 3];
-//              uDebug("_pos:%d %"PRId64", %"PRId64", %"PRId64", %"PRId64, _pos, p[_pos], p[_pos+1], p[_pos+2], p[_pos+3]);
               _pos += 4;
             }
 
@@ -391,12 +376,46 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
             p[_pos++] = (int32_t)prev_value;
           }
         } else {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            zigzag_value = ((w >> v) & mask);
-            prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+          if (tsAVX2Enable && tsSIMDBuiltins) {
+            int32_t num = TMIN(elems, nelements - _pos);
+            int32_t batch = num >> 2;
+            int32_t remain = num & 0x03;
 
-            p[_pos++] = (int32_t)prev_value;
-            v += bit;
+            __m256i base = _mm256_set1_epi64x(w);
+            __m256i maskVal = _mm256_set1_epi64x(mask);
+            __m256i shiftBits = _mm256_set_epi64x(bit * 3 + 4, bit * 2 + 4, bit + 4, 4);
+            __m256i inc = _mm256_set1_epi64x(bit << 2);
+
+            for (int32_t i = 0; i < batch; ++i) {
+              __m256i decoded = tsDecodeSimple8bX4(base, shiftBits, maskVal, prev_value);
+              // keep the low 32 bits of each lane
+              __m256i narrowed = _mm256_permutevar8x32_epi32(decoded, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+              _mm_storeu_si128((__m128i *)&p[_pos], _mm256_castsi256_si128(narrowed));
+
+              shiftBits = _mm256_add_epi64(shiftBits, inc);
+              prev_value = _mm256_extract_epi64(decoded, 3);
+              _pos += 4;
+            }
+
+            v += batch * bit * 4;
+            for (int32_t i = 0; i < remain; i++) {
+              zigzag_value = ((w >> v) & mask);
+              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+
+              p[_pos++] = (int32_t)prev_value;
+              v += bit;
+            }
+
+            // the scalar branch of selector 0 and 1 is bounded by count
+            count = _pos;
+          } else {
+            for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
+              zigzag_value = ((w >> v) & mask);
+              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+
+              p[_pos++] = (int32_t)prev_value;
+              v += bit;
+            }
           }
         }
       } break;
@@ -408,12 +427,46 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
             p[_pos++] = (int16_t)prev_value;
           }
         } else {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            zigzag_value = ((w >> v) & mask);
-            prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+          if (tsAVX2Enable && tsSIMDBuiltins) {
+            int32_t num = TMIN(elems, nelements - _pos);
+            int32_t batch = num >> 2;
+            int32_t remain = num & 0x03;
 
-            p[_pos++] = (int16_t)prev_value;
-            v += bit;
+            __m256i base = _mm256_set1_epi64x(w);
+            __m256i maskVal = _mm256_set1_epi64x(mask);
+            __m256i shiftBits = _mm256_set_epi64x(bit * 3 + 4, bit * 2 + 4, bit + 4, 4);
+            __m256i inc = _mm256_set1_epi64x(bit << 2);
+
+            for (int32_t i = 0; i < batch; ++i) {
+              __m256i decoded = tsDecodeSimple8bX4(base, shiftBits, maskVal, prev_value);
+              int64_t val[4];
+              _mm256_storeu_si256((__m256i *)val, decoded);
+              for (int32_t j = 0; j < 4; j++) p[_pos + j] = (int16_t)val[j];
+
+              shiftBits = _mm256_add_epi64(shiftBits, inc);
+              prev_value = _mm256_extract_epi64(decoded, 3);
+              _pos += 4;
+            }
+
+            v += batch * bit * 4;
+            for (int32_t i = 0; i < remain; i++) {
+              zigzag_value = ((w >> v) & mask);
+              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+
+              p[_pos++] = (int16_t)prev_value;
+              v += bit;
+            }
+
+            // the scalar branch of selector 0 and 1 is bounded by count
+            count = _pos;
+          } else {
+            for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
+              zigzag_value = ((w >> v) & mask);
+              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+
+              p[_pos++] = (int16_t)prev_value;
+              v += bit;
+            }
           }
         }
       } break;
@@ -426,12 +479,46 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
             p[_pos++] = (int8_t)prev_value;
           }
         } else {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            zigzag_value = ((w >> v) & mask);
-            prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+          if (tsAVX2Enable && tsSIMDBuiltins) {
+            int32_t num = TMIN(elems, nelements - _pos);
+            int32_t batch = num >> 2;
+            int32_t remain = num & 0x03;
 
-            p[_pos++] = (int8_t)prev_value;
-            v += bit;
+            __m256i base = _mm256_set1_epi64x(w);
+            __m256i maskVal = _mm256_set1_epi64x(mask);
+            __m256i shiftBits = _mm256_set_epi64x(bit * 3 + 4, bit * 2 + 4, bit + 4, 4);
+            __m256i inc = _mm256_set1_epi64x(bit << 2);
+
+            for (int32_t i = 0; i < batch; ++i) {
+              __m256i decoded = tsDecodeSimple8bX4(base, shiftBits, maskVal, prev_value);
+              int64_t val[4];
+              _mm256_storeu_si256((__m256i *)val, decoded);
+              for (int32_t j = 0; j < 4; j++) p[_pos + j] = (int8_t)val[j];
+
+              shiftBits = _mm256_add_epi64(shiftBits, inc);
+              prev_value = _mm256_extract_epi64(decoded, 3);
+              _pos += 4;
+            }
+
+            v += batch * bit * 4;
+            for (int32_t i = 0; i < remain; i++) {
+              zigzag_value = ((w >> v) & mask);
+              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+
+              p[_pos++] = (int8_t)prev_value;
+              v += bit;
+            }
+
+            // the scalar branch of selector 0 and 1 is bounded by count
+            count = _pos;
+          } else {
+            for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
+              zigzag_value = ((w >> v) & mask);
+              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+
+              p[_pos++] = (int8_t)prev_value;
+              v += bit;
+            }
           }
         }
       } break;
@@ -533,8 +620,33 @@ int32_t tsCompressBoolImp(const char *const input, const int32_t nelements, char
 int32_t tsDecompressBoolImp(const char *const input, const int32_t nelements, char *const output) {
   int32_t ipos = -1, opos = 0;
   int32_t ele_per_byte = BITS_PER_BYTE / 2;
+  int32_t i = 0;
 
-  for (int32_t i = 0; i < nelements; i++) {
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDBuiltins) {
+    // spread each of the 8 input bytes to 4 output bytes, and pick the 2-bit value of each output byte
+    __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6,
+                                      7, 7, 7, 7);
+    __m256i mask = _mm256_set1_epi32(0xC0300C03);
+    __m256i one = _mm256_set1_epi32(0x40100401);
+    __m256i two = _mm256_set1_epi32(0x80200802);
+
+    for (; i + 32 <= nelements; i += 32) {
+      int64_t in = 0;
+      memcpy(&in, input + i / ele_per_byte, sizeof(in));
+
+      __m256i ele = _mm256_and_si256(_mm256_shuffle_epi8(_mm256_set1_epi64x(in), spread), mask);
+      __m256i res = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi8(ele, one), _mm256_set1_epi8(1)),
+                                    _mm256_and_si256(_mm256_cmpeq_epi8(ele, two), _mm256_set1_epi8(TSDB_DATA_BOOL_NULL)));
+      _mm256_storeu_si256((__m256i *)(output + opos), res);
+      opos += 32;
+    }
+
+    ipos = i / ele_per_byte - 1;
+  }
+#endif
+
+  for (; i < nelements; i++) {
     if (i % ele_per_byte == 0) {
       ipos++;
     }
@@ -2587,3 +2699,278 @@ int32_t tsDecompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int
     return -1;
   }
 }
+
+/*************************************************************************
+ *                  FRAME OF REFERENCE COMPRESSION
+ *************************************************************************/
+// Values (or the differences of adjacent values in delta mode) are cut into blocks of FOR_BLOCK_ELES elements. Each
+// block is saved as [width: 1 byte][min: 8 bytes][packed (value - min)]. A full block whose width is no more than 32
+// bits is packed into 4 lanes of 32-bit words, the i-th value going to lane i % 4, so that one vector of 4 words
+// decodes 4 consecutive values. A partial block is packed bit by bit, and a block wider than 32 bits is not packed.
+#define FOR_LANES     4
+#define FOR_HDR_BYTES (sizeof(uint8_t) + sizeof(int64_t))
+
+static FORCE_INLINE int64_t tsFORGetValue(const char *pIn, int32_t bytes, int32_t i) {
+  switch (bytes) {
+    case CHAR_BYTES:
+      return ((int8_t *)pIn)[i];
+    case SHORT_BYTES:
+      return ((int16_t *)pIn)[i];
+    case INT_BYTES:
+      return ((int32_t *)pIn)[i];
+    default:
+      return ((int64_t *)pIn)[i];
+  }
+}
+
+static FORCE_INLINE void tsFORPutValue(char *pOut, int32_t bytes, int32_t i, int64_t v) {
+  switch (bytes) {
+    case CHAR_BYTES:
+      ((int8_t *)pOut)[i] = (int8_t)v;
+      break;
+    case SHORT_BYTES:
+      ((int16_t *)pOut)[i] = (int16_t)v;
+      break;
+    case INT_BYTES:
+      ((int32_t *)pOut)[i] = (int32_t)v;
+      break;
+    default:
+      ((int64_t *)pOut)[i] = v;
+      break;
+  }
+}
+
+// the i-th element to pack, which is the value itself or its difference to the previous value in delta mode
+static FORCE_INLINE int64_t tsFORGetElement(const char *pIn, int32_t bytes, bool delta, int32_t i) {
+  if (delta) {
+    return (int64_t)((uint64_t)tsFORGetValue(pIn, bytes, i + 1) - (uint64_t)tsFORGetValue(pIn, bytes, i));
+  } else {
+    return tsFORGetValue(pIn, bytes, i);
+  }
+}
+
+static FORCE_INLINE int32_t tsFORRangeWidth(int64_t minV, int64_t maxV) {
+  uint64_t range = (uint64_t)maxV - (uint64_t)minV;
+  return range ? (64 - BUILDIN_CLZL(range)) : 0;
+}
+
+static int32_t tsFORBlockWidth(const char *pIn, int32_t bytes, bool delta, int32_t start, int32_t nEle, int64_t *min) {
+  int64_t minV = INT64_MAX;
+  int64_t maxV = INT64_MIN;
+  for (int32_t i = start; i < start + nEle; i++) {
+    int64_t v = tsFORGetElement(pIn, bytes, delta, i);
+    if (v < minV) minV = v;
+    if (v > maxV) maxV = v;
+  }
+
+  *min = minV;
+  return tsFORRangeWidth(minV, maxV);
+}
+
+static FORCE_INLINE int32_t tsFORBlockSize(int32_t width, int32_t nEle) {
+  if (width > 32) {
+    return FOR_HDR_BYTES + nEle * LONG_BYTES;
+  } else if (nEle == FOR_BLOCK_ELES) {
+    return FOR_HDR_BYTES + FOR_BLOCK_ELES / BITS_PER_BYTE * width;
+  } else {
+    return FOR_HDR_BYTES + (nEle * width + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+  }
+}
+
+// The sizes of both modes in one pass over the values. The deltas of a block are those of its values and the next
+// value, which is the first one of the next block.
+void tsCompressFORSize(void *pIn, int32_t nEle, int32_t bytes, int32_t *szFOR, int32_t *szDeltaFOR) {
+  *szFOR = 0;
+  *szDeltaFOR = nEle ? LONG_BYTES : 0;
+
+  for (int32_t start = 0; start < nEle; start += FOR_BLOCK_ELES) {
+    int32_t n = TMIN(FOR_BLOCK_ELES, nEle - start);
+    int32_t nDelta = TMIN(FOR_BLOCK_ELES, nEle - 1 - start);
+    int64_t minV = INT64_MAX, maxV = INT64_MIN;
+    int64_t minD = INT64_MAX, maxD = INT64_MIN;
+    int64_t prev = tsFORGetValue(pIn, bytes, start);
+
+    for (int32_t i = start; i < start + nDelta + 1; i++) {
+      int64_t v = tsFORGetValue(pIn, bytes, i);
+      if (i < start + n) {
+        if (v < minV) minV = v;
+        if (v > maxV) maxV = v;
+      }
+      if (i > start) {
+        int64_t d = (int64_t)((uint64_t)v - (uint64_t)prev);
+        if (d < minD) minD = d;
+        if (d > maxD) maxD = d;
+      }
+      prev = v;
+    }
+
+    *szFOR += tsFORBlockSize(tsFORRangeWidth(minV, maxV), n);
+    if (nDelta > 0) {
+      *szDeltaFOR += tsFORBlockSize(tsFORRangeWidth(minD, maxD), nDelta);
+    }
+  }
+}
+
+int32_t tsCompressFOR(void *pIn, int32_t nEle, int32_t bytes, bool delta, void *pOut, int32_t nOut) {
+  char   *output = (char *)pOut;
+  int32_t opos = 0;
+
+  if (delta) {
+    if (nEle == 0) return 0;
+
+    int64_t first = tsFORGetValue(pIn, bytes, 0);
+    if (opos + LONG_BYTES > nOut) return -1;
+    memcpy(output + opos, &first, LONG_BYTES);
+    opos += LONG_BYTES;
+    nEle--;
+  }
+
+  for (int32_t start = 0; start < nEle; start += FOR_BLOCK_ELES) {
+    int32_t n = TMIN(FOR_BLOCK_ELES, nEle - start);
+    int64_t min;
+    int32_t width = tsFORBlockWidth(pIn, bytes, delta, start, n, &min);
+    int32_t size = tsFORBlockSize(width, n);
+
+    if (opos + size > nOut) return -1;
+
+    output[opos] = (char)width;
+    memcpy(output + opos + 1, &min, LONG_BYTES);
+    char *p = output + opos + FOR_HDR_BYTES;
+    memset(p, 0, size - FOR_HDR_BYTES);
+
+    if (width > 32) {
+      for (int32_t i = 0; i < n; i++) {
+        uint64_t r = (uint64_t)tsFORGetElement(pIn, bytes, delta, start + i) - (uint64_t)min;
+        memcpy(p + i * LONG_BYTES, &r, LONG_BYTES);
+      }
+    } else if (width > 0 && n == FOR_BLOCK_ELES) {
+      uint32_t words[FOR_LANES * 32] = {0};
+      for (int32_t i = 0; i < n; i++) {
+        uint32_t r = (uint32_t)((uint64_t)tsFORGetElement(pIn, bytes, delta, start + i) - (uint64_t)min);
+        int32_t  lane = i % FOR_LANES;
+        int32_t  bit = (i / FOR_LANES) * width;
+
+        words[(bit >> 5) * FOR_LANES + lane] |= r << (bit & 31);
+        if ((bit & 31) + width > 32) {
+          words[((bit >> 5) + 1) * FOR_LANES + lane] |= r >> (32 - (bit & 31));
+        }
+      }
+      memcpy(p, words, FOR_BLOCK_ELES / BITS_PER_BYTE * width);
+    } else if (width > 0) {
+      for (int32_t i = 0; i < n; i++) {
+        uint64_t r = (uint64_t)tsFORGetElement(pIn, bytes, delta, start + i) - (uint64_t)min;
+        int32_t  bit = i * width;
+
+        for (int32_t b = 0; b < width; b += BITS_PER_BYTE - ((bit + b) % BITS_PER_BYTE)) {
+          p[(bit + b) / BITS_PER_BYTE] |= (char)((r >> b) << ((bit + b) % BITS_PER_BYTE));
+        }
+      }
+    }
+
+    opos += size;
+  }
+
+  return opos;
+}
+
+static void tsFORUnpackBlock(const char *p, int32_t width, uint32_t *r) {
+  uint32_t mask = (width == 32) ? UINT32_MAX : INT32MASK(width);
+
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDBuiltins) {
+    __m128i vmask = _mm_set1_epi32(mask);
+    __m128i cur = _mm_loadu_si128((__m128i *)p);
+    int32_t bit = 0;
+
+    for (int32_t j = 0; j < FOR_BLOCK_ELES / FOR_LANES; j++) {
+      __m128i res = _mm_srl_epi32(cur, _mm_cvtsi32_si128(bit));
+      bit += width;
+      // the last row of a block ends exactly at the end of the last word
+      if (bit >= 32 && j + 1 < FOR_BLOCK_ELES / FOR_LANES) {
+        bit -= 32;
+        p += sizeof(__m128i);
+        cur = _mm_loadu_si128((__m128i *)p);
+        if (bit > 0) res = _mm_or_si128(res, _mm_sll_epi32(cur, _mm_cvtsi32_si128(width - bit)));
+      }
+      _mm_storeu_si128((__m128i *)(r + j * FOR_LANES), _mm_and_si128(res, vmask));
+    }
+    return;
+  }
+#endif
+
+  uint32_t words[FOR_LANES * 32];
+  memcpy(words, p, FOR_BLOCK_ELES / BITS_PER_BYTE * width);
+  for (int32_t i = 0; i < FOR_BLOCK_ELES; i++) {
+    int32_t  lane = i % FOR_LANES;
+    int32_t  bit = (i / FOR_LANES) * width;
+    uint32_t v = words[(bit >> 5) * FOR_LANES + lane] >> (bit & 31);
+
+    if ((bit & 31) + width > 32) {
+      v |= words[((bit >> 5) + 1) * FOR_LANES + lane] << (32 - (bit & 31));
+    }
+    r[i] = v & mask;
+  }
+}
+
+int32_t tsDecompressFOR(void *pIn, int32_t nIn, int32_t nEle, int32_t bytes, bool delta, void *pOut, int32_t nOut) {
+  const char *input = (const char *)pIn;
+  int32_t     ipos = 0;
+  int32_t     opos = 0;
+  uint64_t    prev = 0;
+
+  if (nEle * bytes > nOut) return -1;
+  if (nEle == 0) return 0;
+
+  if (delta) {
+    if (ipos + LONG_BYTES > nIn) return -1;
+    memcpy(&prev, input, LONG_BYTES);
+    ipos += LONG_BYTES;
+    tsFORPutValue(pOut, bytes, opos++, (int64_t)prev);
+  }
+
+  while (opos < nEle) {
+    int32_t n = TMIN(FOR_BLOCK_ELES, nEle - opos);
+    int64_t min;
+
+    if (ipos + FOR_HDR_BYTES > nIn) return -1;
+    int32_t width = (uint8_t)input[ipos];
+    memcpy(&min, input + ipos + 1, LONG_BYTES);
+    if (width > 64 || ipos + tsFORBlockSize(width, n) > nIn) return -1;
+
+    const char *p = input + ipos + FOR_HDR_BYTES;
+    uint64_t    r[FOR_BLOCK_ELES];
+
+    if (width > 32) {
+      memcpy(r, p, n * LONG_BYTES);
+    } else if (width > 0 && n == FOR_BLOCK_ELES) {
+      uint32_t r32[FOR_BLOCK_ELES];
+      tsFORUnpackBlock(p, width, r32);
+      for (int32_t i = 0; i < n; i++) r[i] = r32[i];
+    } else if (width > 0) {
+      for (int32_t i = 0; i < n; i++) {
+        int32_t  bit = i * width;
+        uint64_t v = 0;
+        memcpy(&v, p + bit / BITS_PER_BYTE, (bit % BITS_PER_BYTE + width + BITS_PER_BYTE - 1) / BITS_PER_BYTE);
+        r[i] = (v >> (bit % BITS_PER_BYTE)) & INT64MASK(width);
+      }
+    } else {
+      memset(r, 0, n * sizeof(uint64_t));
+    }
+
+    if (delta) {
+      for (int32_t i = 0; i < n; i++) {
+        prev += (uint64_t)min + r[i];
+        tsFORPutValue(pOut, bytes, opos + i, (int64_t)prev);
+      }
+    } else {
+      for (int32_t i = 0; i < n; i++) {
+        tsFORPutValue(pOut, bytes, opos + i, (int64_t)((uint64_t)min + r[i]));
+      }
+    }
+
+    ipos += tsFORBlockSize(width, n);
+    opos += n;
+  }
+
+  return nEle * bytes;
+}
@@ -1,9 +1,11 @@
 #define _DEFAULT_SOURCE
 #include "tpagedbuf.h"
+#include "lz4.h"
 #include "taoserror.h"
 #include "tcompression.h"
 #include "tsimplehash.h"
 #include "tlog.h"
+#include "tworker.h"
 
 #define GET_PAYLOAD_DATA(_p)           ((char*)(_p)->pData + POINTER_BYTES)
 #define BUF_PAGE_IN_MEM(_p)            ((_p)->pData != NULL)
@@ -11,6 +13,9 @@
 #define HAS_DATA_IN_DISK(_p)           ((_p)->offset >= 0)
 #define NO_IN_MEM_AVAILABLE_PAGES(_b)  (listNEles((_b)->lruList) >= (_b)->inMemPages)
 
+#define BUF_PAGE_WRITE_THREADS 2
+#define BUF_PAGE_MAX_WRITES    32  // max number of page writes of one buffer in background
+
 typedef struct SPageDiskInfo {
   int64_t offset;
   int32_t length;
@@ -24,8 +29,21 @@ struct SPageInfo {
   int32_t    length : 29;
   bool       used : 1;   // set current page is in used
   bool       dirty : 1;  // set current buffer page is dirty or not
+  bool       comp : 1;   // the page is compressed on disk
+
+  struct SPageWrite* pWrite;  // the write of this page in background, protected by the lock of the buffer
 };
 
+// An evicted page is compressed into a write, which is done by the write workers in background, so that the buffer of
+// the page is reused at once. A page loaded before its write is done is decoded from the write.
+typedef struct SPageWrite {
+  SDiskbasedBuf* pBuf;
+  SPageInfo*     pg;
+  int64_t        offset;
+  int32_t        size;
+  char           data[];
+} SPageWrite;
+
 struct SDiskbasedBuf {
   int32_t   numOfPages;
   int64_t   totalBufSize;
@@ -46,6 +64,11 @@ struct SDiskbasedBuf {
   bool      comp;              // compressed before flushed to disk
   uint64_t  nextPos;           // next page flush position
 
+  TdThreadMutex lock;         // protects the page writes in background
+  TdThreadCond  writeDone;
+  int32_t       numOfWrites;  // number of page writes in background
+  int32_t       writeCode;    // the first error of the page writes in background
+
   char*               id;           // for debug purpose
   bool                printStatis;  // Print statistics info when closing this buffer.
   SDiskbasedBufStatis statis;
@@ -70,52 +93,73 @@ static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+static SSingleWorker bufWriteWorker = {0};
+
+static void bufPageWriteFp(SQueueInfo* pInfo, void* pItem) {
+  SPageWrite*    pWrite = pItem;
+  SDiskbasedBuf* pBuf = pWrite->pBuf;
+  int32_t        code = TSDB_CODE_SUCCESS;
+
+  int64_t st = taosGetTimestampUs();
+  if (taosPWriteFile(pBuf->pFile, pWrite->data, pWrite->size, pWrite->offset) != pWrite->size) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    uError("failed to write buf page:%d to disk since %s, %s", pWrite->pg->pageId, tstrerror(code), pBuf->id);
   }
+  int64_t el = taosGetTimestampUs() - st;
 
-  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, srcSize, ONE_STAGE_COMP, NULL, 0);
+  taosThreadMutexLock(&pBuf->lock);
+  if (code != TSDB_CODE_SUCCESS && pBuf->writeCode == TSDB_CODE_SUCCESS) {
+    pBuf->writeCode = code;
+  }
+  if (pWrite->pg->pWrite == pWrite) {
+    pWrite->pg->pWrite = NULL;
+  }
+  pBuf->statis.flushUs += el;
+  pBuf->numOfWrites -= 1;
+  taosThreadCondBroadcast(&pBuf->writeDone);
+  taosThreadMutexUnlock(&pBuf->lock);
 
-  memcpy(data, pBuf->assistBuf, *dst);
-  return data;
+  taosFreeQitem(pItem);
 }
 
-static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+int32_t initBufPageWritePool() {
+  SSingleWorkerCfg cfg = {
+      .min = BUF_PAGE_WRITE_THREADS, .max = BUF_PAGE_WRITE_THREADS, .name = "buf-write", .fp = bufPageWriteFp};
+  if (tSingleWorkerInit(&bufWriteWorker, &cfg) != 0) {
+    uError("failed to init buf write pool since %s", terrstr());
+    return terrno;
   }
+  return TSDB_CODE_SUCCESS;
+}
 
-  *dst = tsDecompressString(data, srcSize, 1, pBuf->assistBuf, pBuf->pageSize, ONE_STAGE_COMP, NULL, 0);
-  if (*dst > 0) {
-    memcpy(data, pBuf->assistBuf, *dst);
+void cleanupBufPageWritePool() { tSingleWorkerCleanup(&bufWriteWorker); }
+
+// wait until no more than maxWrites writes are in background, and the page, if any, is not being written
+static void waitBufPageWrites(SDiskbasedBuf* pBuf, SPageInfo* pg, int32_t maxWrites) {
+  taosThreadMutexLock(&pBuf->lock);
+  while (pBuf->numOfWrites > maxWrites || (pg != NULL && pg->pWrite != NULL)) {
+    taosThreadCondWait(&pBuf->writeDone, &pBuf->lock);
   }
-  return data;
+  taosThreadMutexUnlock(&pBuf->lock);
 }
 
 static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
-  if (pBuf->pFree == NULL) {
-    return pBuf->nextPos;
-  } else {
-    int32_t offset = -1;
-
-    size_t num = taosArrayGetSize(pBuf->pFree);
-    for (int32_t i = 0; i < num; ++i) {
-      SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
-      if (pi->length >= size) {
-        offset = pi->offset;
-        pi->offset += (int32_t)size;
-        pi->length -= (int32_t)size;
-
-        return offset;
-      }
+  size_t num = taosArrayGetSize(pBuf->pFree);
+  for (int32_t i = 0; i < num; ++i) {
+    SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
+    if (pi->length >= size) {
+      int64_t offset = pi->offset;
+      pi->offset += (int32_t)size;
+      pi->length -= (int32_t)size;
+
+      return offset;
     }
-
-    // no available recycle space, allocate new area in file
-    return pBuf->nextPos;
   }
+
+  // no available recycle space, allocate new area in file
+  uint64_t offset = pBuf->nextPos;
+  pBuf->nextPos += size;
+  return offset;
 }
 
 /**
@@ -130,16 +174,64 @@ static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
 static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize + POINTER_BYTES + sizeof(SFilePage); }
 
 static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, int64_t offset, const char* pData, int32_t size) {
-  int32_t ret = taosLSeekFile(pBuf->pFile, offset, SEEK_SET);
-  if (ret == -1) {
+  int64_t st = taosGetTimestampUs();
+  int64_t ret = taosPWriteFile(pBuf->pFile, pData, size, offset);
+  if (ret != size) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return terrno;
   }
 
-  ret = (int32_t)taosWriteFile(pBuf->pFile, pData, size);
-  if (ret != size) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    return terrno;
+  // the writes in background add to the same statistics
+  int64_t el = taosGetTimestampUs() - st;
+  taosThreadMutexLock(&pBuf->lock);
+  pBuf->statis.flushUs += el;
+  taosThreadMutexUnlock(&pBuf->lock);
+  return TSDB_CODE_SUCCESS;
+}
+
+// Compress the page and write it into the place of the page in file, or a new one if it does not fit any more. The
+// write is done in background if possible.
+static int32_t doWriteBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
+  char*       payload = GET_PAYLOAD_DATA(pg);
+  SPageWrite* pWrite = NULL;
+
+  if (bufWriteWorker.queue != NULL) {
+    // the last write of the page must be done before it is written again, and the writes in background are limited
+    waitBufPageWrites(pBuf, pg, BUF_PAGE_MAX_WRITES - 1);
+    pWrite = taosAllocateQitem(sizeof(SPageWrite) + pBuf->pageSize, DEF_QITEM, 0);
+  }
+
+  char*   pData = payload;
+  int32_t size = pBuf->pageSize;
+  bool    comp = false;
+
+  char* pDst = (pWrite != NULL) ? pWrite->data : pBuf->assistBuf;
+  if (pBuf->comp && pDst != NULL) {
+    // a page that is not compressed into less than its size is kept as it is
+    int32_t len = LZ4_compress_default(payload, pDst, pBuf->pageSize, pBuf->pageSize - 1);
+    if (len > 0) {
+      pData = pDst;
+      size = len;
+      comp = true;
+    }
+  }
+
+  if (pWrite != NULL && !comp) {
+    memcpy(pWrite->data, payload, size);
+    pData = pWrite->data;
+  }
+
+  int64_t offset = pg->offset;
+  if (!HAS_DATA_IN_DISK(pg)) {  // this page is flushed to disk for the first time
+    offset = allocateNewPositionInFile(pBuf, size);
+  } else if (pg->length < size) {
+    // length becomes greater, current space is not enough, add it to free list and allocate new place
+    SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
+    taosArrayPush(pBuf->pFree, &dinfo);
+    offset = allocateNewPositionInFile(pBuf, size);
+  } else if (pg->length > size) {
+    SPageDiskInfo dinfo = {.length = pg->length - size, .offset = offset + size};
+    taosArrayPush(pBuf->pFree, &dinfo);
   }
 
   // extend the file
@@ -147,9 +239,29 @@ static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, int64_t offset, const cha
     pBuf->fileSize = offset + size;
   }
 
+  pg->offset = offset;
+  pg->length = size;  // on disk size
+  pg->comp = comp;
+
+  pBuf->statis.rawFlushBytes += pBuf->pageSize;
   pBuf->statis.flushBytes += size;
   pBuf->statis.flushPages += 1;
 
+  if (pWrite == NULL) {
+    return doFlushBufPageImpl(pBuf, offset, pData, size);
+  }
+
+  pWrite->pBuf = pBuf;
+  pWrite->pg = pg;
+  pWrite->offset = offset;
+  pWrite->size = size;
+
+  taosThreadMutexLock(&pBuf->lock);
+  pg->pWrite = pWrite;
+  pBuf->numOfWrites += 1;
+  taosThreadMutexUnlock(&pBuf->lock);
+
+  taosWriteQitem(bufWriteWorker.queue, pWrite);
   return TSDB_CODE_SUCCESS;
 }
 
@@ -160,60 +272,23 @@ static char* doFlushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     return NULL;
   }
 
-  int32_t size = pBuf->pageSize;
-  int64_t offset = pg->offset;
-
-  char* t = NULL;
-  if ((!HAS_DATA_IN_DISK(pg)) || pg->dirty) {
-    void* payload = GET_PAYLOAD_DATA(pg);
-    t = doCompressData(payload, pBuf->pageSize, &size, pBuf);
-    if (size < 0) {
-      uError("failed to compress data when flushing data to disk, %s", pBuf->id);
-      terrno = TSDB_CODE_INVALID_PARA;
-      return NULL;
-    }
-  }
-
-  // this page is flushed to disk for the first time
+  // NOTE: a page not dirty is not written, its data on disk, if any, is still valid.
   if (pg->dirty) {
-    if (!HAS_DATA_IN_DISK(pg)) {
-      offset = allocateNewPositionInFile(pBuf, size);
-      pBuf->nextPos += size;
-
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
-    } else {
-      // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
-      if (pg->length < size) {
-        // 1. add current space to free list
-        SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
-        taosArrayPush(pBuf->pFree, &dinfo);
-
-        // 2. allocate new position, and update the info
-        offset = allocateNewPositionInFile(pBuf, size);
-        pBuf->nextPos += size;
-      }
-
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
+    int32_t code = doWriteBufPage(pBuf, pg);
+    if (code != TSDB_CODE_SUCCESS) {
+      uError("failed to flush buf page:%d to disk since %s, %s", pg->pageId, tstrerror(code), pBuf->id);
+      terrno = code;
+      return NULL;
     }
-  } else {  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
-    size = pg->length;
   }
 
   char* pDataBuf = pg->pData;
   memset(pDataBuf, 0, getAllocPageSize(pBuf->pageSize));
 
 #ifdef BUF_PAGE_DEBUG
-  uDebug("page_flush %p, pageId:%d, offset:%d", pDataBuf, pg->pageId, offset);
+  uDebug("page_flush %p, pageId:%d, offset:%d", pDataBuf, pg->pageId, pg->offset);
 #endif
 
-  pg->offset = offset;
-  pg->length = size;  // on disk size
   return pDataBuf;
 }
 
@@ -234,6 +309,24 @@ static char* flushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   return p;
 }
 
+static int32_t doDecodeBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg, const char* pData, char* pPage) {
+  if (!pg->comp) {
+    if (pData != pPage) {
+      memcpy(pPage, pData, pg->length);
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t size = LZ4_decompress_safe(pData, pPage, pg->length, pBuf->pageSize);
+  if (size != pBuf->pageSize) {
+    uError("failed to decompress buf page:%d, length:%d, decompressed:%d, %s", pg->pageId, pg->length, size,
+           pBuf->id);
+    return TSDB_CODE_FILE_CORRUPTED;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 // load file block data in disk
 static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   if (pg->offset < 0 || pg->length <= 0) {
@@ -241,25 +334,36 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     return TSDB_CODE_INVALID_PARA;
   }
 
-  int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-  if (ret == -1) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
+  char* pPage = GET_PAYLOAD_DATA(pg);
+
+  // the page is still being written, decode it from the write
+  taosThreadMutexLock(&pBuf->lock);
+  if (pg->pWrite != NULL) {
+    int32_t code = doDecodeBufPage(pBuf, pg, pg->pWrite->data, pPage);
+    taosThreadMutexUnlock(&pBuf->lock);
+    return code;
   }
+  taosThreadMutexUnlock(&pBuf->lock);
 
-  void* pPage = (void*)GET_PAYLOAD_DATA(pg);
-  ret = (int32_t)taosReadFile(pBuf->pFile, pPage, pg->length);
+  char* pData = pPage;
+  if (pg->comp) {
+    if (pBuf->assistBuf == NULL && (pBuf->assistBuf = taosMemoryMalloc(pBuf->pageSize)) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pData = pBuf->assistBuf;
+  }
+
+  int64_t st = taosGetTimestampUs();
+  int64_t ret = taosPReadFile(pBuf->pFile, pData, pg->length, pg->offset);
   if (ret != pg->length) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
+    return TAOS_SYSTEM_ERROR(errno);
   }
 
+  pBuf->statis.loadUs += taosGetTimestampUs() - st;
   pBuf->statis.loadBytes += pg->length;
   pBuf->statis.loadPages += 1;
 
-  int32_t fullSize = 0;
-  doDecompressData(pPage, pg->length, &fullSize, pBuf);
-  return 0;
+  return doDecodeBufPage(pBuf, pg, pData, pPage);
 }
 
 static SPageInfo* registerNewPageInfo(SDiskbasedBuf* pBuf, int32_t pageId) {
@@ -278,6 +382,8 @@ static SPageInfo* registerNewPageInfo(SDiskbasedBuf* pBuf, int32_t pageId) {
   ppi->used = true;
   ppi->pn = NULL;
   ppi->dirty = false;
+  ppi->comp = false;
+  ppi->pWrite = NULL;
 
   return *(SPageInfo**)taosArrayPush(pBuf->pIdList, &ppi);
 }
@@ -346,6 +452,9 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
     goto _error;
   }
 
+  taosThreadMutexInit(&pPBuf->lock, NULL);
+  taosThreadCondInit(&pPBuf->writeDone, NULL);
+
   pPBuf->pageSize = pagesize;
   pPBuf->numOfPages = 0;  // all pages are in buffer in the first place
   pPBuf->totalBufSize = 0;
@@ -414,6 +523,12 @@ static char* doExtractPage(SDiskbasedBuf* pBuf, bool* newPage) {
 void* getNewBufPage(SDiskbasedBuf* pBuf, int32_t* pageId) {
   pBuf->statis.getPages += 1;
 
+  int32_t code = atomic_load_32(&pBuf->writeCode);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    return NULL;
+  }
+
   bool newPage = false;
   char* availablePage = doExtractPage(pBuf, &newPage);
   if (availablePage == NULL) {
@@ -466,6 +581,12 @@ void* getBufPage(SDiskbasedBuf* pBuf, int32_t id) {
 
   pBuf->statis.getPages += 1;
 
+  int32_t code = atomic_load_32(&pBuf->writeCode);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    return NULL;
+  }
+
   SPageInfo** pi = tSimpleHashGet(pBuf->all, &id, sizeof(int32_t));
   if (pi == NULL || *pi == NULL) {
     uError("failed to locate the buffer page:%d, %s", id, pBuf->id);
@@ -566,6 +687,7 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
     return;
   }
 
+  waitBufPageWrites(pBuf, NULL, 0);
   dBufPrintStatis(pBuf);
 
   bool needRemoveFile = false;
@@ -594,6 +716,12 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
           ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
           ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
     }
+
+    if (ps->flushPages > 0) {
+      uDebug("compression saved:%.2f Kb of %.2f Kb, flush elapsed:%.2f ms, load elapsed:%.2f ms, %s",
+             (ps->rawFlushBytes - ps->flushBytes) / 1024.0, ps->rawFlushBytes / 1024.0, ps->flushUs / 1000.0,
+             ps->loadUs / 1000.0, pBuf->id);
+    }
   }
 
   if (needRemoveFile) {
@@ -624,6 +752,8 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
 
   taosMemoryFreeClear(pBuf->id);
   taosMemoryFreeClear(pBuf->assistBuf);
+  taosThreadMutexDestroy(&pBuf->lock);
+  taosThreadCondDestroy(&pBuf->writeDone);
   taosMemoryFreeClear(pBuf);
 }
 
@@ -647,10 +777,12 @@ void setBufPageDirty(void* pPage, bool dirty) {
 }
 
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) {
-  pBuf->comp = comp;
-  if (comp  && (pBuf->assistBuf == NULL)) {
-    pBuf->assistBuf = taosMemoryMalloc(pBuf->pageSize + 2);  // EXTRA BYTES
+  if (comp && (pBuf->assistBuf == NULL)) {
+    pBuf->assistBuf = taosMemoryMalloc(pBuf->pageSize);
   }
+
+  // no compression if the assistant buffer is not available
+  pBuf->comp = comp && (pBuf->assistBuf != NULL);
 }
 
 void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
@@ -670,7 +802,13 @@ void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
 
 void dBufSetPrintInfo(SDiskbasedBuf* pBuf) { pBuf->printStatis = true; }
 
-SDiskbasedBufStatis getDBufStatis(const SDiskbasedBuf* pBuf) { return pBuf->statis; }
+SDiskbasedBufStatis getDBufStatis(const SDiskbasedBuf* pBuf) {
+  // the flush time is updated by the write workers
+  taosThreadMutexLock((TdThreadMutex*)&pBuf->lock);
+  SDiskbasedBufStatis statis = pBuf->statis;
+  taosThreadMutexUnlock((TdThreadMutex*)&pBuf->lock);
+  return statis;
+}
 
 void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
   if (!pBuf->printStatis) {
@@ -690,15 +828,18 @@ void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
   if (ps->loadPages > 0) {
     printf(
         "Get/Release pages:%d/%d, flushToDisk:%.2f Kb (%d Pages), loadFromDisk:%.2f Kb (%d Pages), avgPageSize:%.2f "
-        "Kb\n",
+        "Kb, compression saved:%.2f Kb, flush elapsed:%.2f ms, load elapsed:%.2f ms\n",
         ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
-        ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
+        ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages), (ps->rawFlushBytes - ps->flushBytes) / 1024.0,
+        ps->flushUs / 1000.0, ps->loadUs / 1000.0);
   } else {
     // printf("no page loaded\n");
   }
 }
 
 void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
+  waitBufPageWrites(pBuf, NULL, 0);
+
   size_t n = taosArrayGetSize(pBuf->pIdList);
   for (int32_t i = 0; i < n; ++i) {
     SPageInfo* pi = taosArrayGetP(pBuf->pIdList, i);
@@ -21,6 +21,45 @@
 int64_t tsRpcQueueMemoryAllowed = 0;
 int64_t tsRpcQueueMemoryUsed = 0;
 
+#define QSET_MIN_SPIN 64
+#define QSET_MAX_SPIN (16 * 1024)
+
+#define QUEUE_WRITERS_BLOCKED ((int32_t)0x40000000)
+
+// Writers push items onto the pending list of a queue with CAS and never take a lock. Readers are serialized by the
+// queue mutex, and move the whole pending list to the head/tail list in one exchange, reversing it back to the
+// order the items were written.
+//
+// A writer counts the item in the qset the queue is in. To keep the item counters of the queue and of its qset in
+// step, joining or leaving a qset blocks the lock-free writes: it waits for the writers in progress to finish, and
+// the writers coming meanwhile fall back to the queue mutex, which is held until the queue has changed qset.
+//
+// Writers only wake the readers parked on the qset sem, the others see the write sequence change.
+
+// tell the core the loop is a spin-wait, so it yields to the sibling hyper-thread and exits the loop without a
+// memory order violation
+static FORCE_INLINE void taosQsetSpinPause() {
+#if defined(WINDOWS)
+  YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+// with queue mutex locked, wait for the lock-free writers in progress and make the next ones take the mutex
+static void taosQueueBlockWriters(STaosQueue *queue) {
+  atomic_fetch_or_32(&queue->writers, QUEUE_WRITERS_BLOCKED);
+  while ((atomic_load_32(&queue->writers) & ~QUEUE_WRITERS_BLOCKED) != 0) {
+    taosQsetSpinPause();
+  }
+}
+
+static void taosQueueUnblockWriters(STaosQueue *queue) {
+  atomic_fetch_and_32(&queue->writers, ~QUEUE_WRITERS_BLOCKED);
+}
+
 STaosQueue *taosOpenQueue() {
   STaosQueue *queue = taosMemoryCalloc(1, sizeof(STaosQueue));
   if (queue == NULL) {
@@ -43,14 +82,36 @@ void taosSetQueueFp(STaosQueue *queue, FItem itemFp, FItems itemsFp) {
   queue->itemsFp = itemsFp;
 }
 
+static void taosFreeQnodes(STaosQnode *pNode) {
+  while (pNode) {
+    STaosQnode *pTemp = pNode;
+    pNode = pNode->next;
+    taosMemoryFree(pTemp);
+  }
+}
+
+// upper bound in microseconds of the bucket holding the given percentile of read items
+static int64_t taosQueueLatencyPercentile(const int64_t latency[QUEUE_LATENCY_BUCKETS], int32_t percent) {
+  int64_t total = 0;
+  for (int32_t i = 0; i < QUEUE_LATENCY_BUCKETS; ++i) total += latency[i];
+
+  int64_t sum = 0;
+  for (int32_t i = 0; i < QUEUE_LATENCY_BUCKETS; ++i) {
+    sum += latency[i];
+    if (sum * 100 >= total * percent) return 1LL << i;
+  }
+  return 1LL << (QUEUE_LATENCY_BUCKETS - 1);
+}
+
 void taosCloseQueue(STaosQueue *queue) {
   if (queue == NULL) return;
-  STaosQnode *pTemp;
-  STaosQset  *qset;
+  STaosQset *qset;
 
   taosThreadMutexLock(&queue->mutex);
   STaosQnode *pNode = queue->head;
+  STaosQnode *pPending = atomic_exchange_ptr(&queue->pending, NULL);
   queue->head = NULL;
+  queue->tail = NULL;
   qset = queue->qset;
   taosThreadMutexUnlock(&queue->mutex);
 
@@ -58,11 +119,11 @@ void taosCloseQueue(STaosQueue *queue) {
     taosRemoveFromQset(qset, queue);
   }
 
-  while (pNode) {
-    pTemp = pNode;
-    pNode = pNode->next;
-    taosMemoryFree(pTemp);
-  }
+  taosFreeQnodes(pNode);
+  taosFreeQnodes(pPending);
+
+  uDebug("queue:%p, read latency p50:<%" PRId64 "us p99:<%" PRId64 "us", queue,
+         taosQueueLatencyPercentile(queue->latency, 50), taosQueueLatencyPercentile(queue->latency, 99));
 
   taosThreadMutexDestroy(&queue->mutex);
   taosMemoryFree(queue);
@@ -75,7 +136,8 @@ bool taosQueueEmpty(STaosQueue *queue) {
 
   bool empty = false;
   taosThreadMutexLock(&queue->mutex);
-  if (queue->head == NULL && queue->tail == NULL && queue->numOfItems == 0 && queue->memOfItems == 0) {
+  if (queue->head == NULL && queue->tail == NULL && atomic_load_ptr(&queue->pending) == NULL &&
+      atomic_load_32(&queue->numOfItems) == 0 && atomic_load_64(&queue->memOfItems) == 0) {
     empty = true;
   }
   taosThreadMutexUnlock(&queue->mutex);
@@ -85,28 +147,23 @@ bool taosQueueEmpty(STaosQueue *queue) {
 
 void taosUpdateItemSize(STaosQueue *queue, int32_t items) {
   if (queue == NULL) return;
-
-  taosThreadMutexLock(&queue->mutex);
-  queue->numOfItems -= items;
-  taosThreadMutexUnlock(&queue->mutex);
+  atomic_sub_fetch_32(&queue->numOfItems, items);
 }
 
 int32_t taosQueueItemSize(STaosQueue *queue) {
   if (queue == NULL) return 0;
 
-  taosThreadMutexLock(&queue->mutex);
-  int32_t numOfItems = queue->numOfItems;
-  taosThreadMutexUnlock(&queue->mutex);
-
-  uTrace("queue:%p, numOfItems:%d memOfItems:%" PRId64, queue, queue->numOfItems, queue->memOfItems);
+  int32_t numOfItems = atomic_load_32(&queue->numOfItems);
+  uTrace("queue:%p, numOfItems:%d memOfItems:%" PRId64, queue, numOfItems, atomic_load_64(&queue->memOfItems));
   return numOfItems;
 }
 
-int64_t taosQueueMemorySize(STaosQueue *queue) {
+int64_t taosQueueMemorySize(STaosQueue *queue) { return atomic_load_64(&queue->memOfItems); }
+
+void taosQueueLatency(STaosQueue *queue, int64_t latency[QUEUE_LATENCY_BUCKETS]) {
   taosThreadMutexLock(&queue->mutex);
-  int64_t memOfItems = queue->memOfItems;
+  memcpy(latency, queue->latency, sizeof(queue->latency));
   taosThreadMutexUnlock(&queue->mutex);
-  return memOfItems;
 }
 
 void *taosAllocateQitem(int32_t size, EQItype itype, int64_t dataSize) {
@@ -153,47 +210,136 @@ void taosFreeQitem(void *pItem) {
   taosMemoryFree(pNode);
 }
 
+// count the item in the queue and its qset, and push it onto the pending list. the qset of the queue does not change
+// meanwhile, as the caller is either a lock-free writer in progress or holds the queue mutex.
+static STaosQset *taosQueuePush(STaosQueue *queue, STaosQnode *pNode) {
+  int32_t    numOfItems = atomic_add_fetch_32(&queue->numOfItems, 1);
+  int64_t    memOfItems = atomic_add_fetch_64(&queue->memOfItems, pNode->size);
+  STaosQset *qset = atomic_load_ptr(&queue->qset);
+  if (qset) atomic_add_fetch_32(&qset->numOfItems, 1);
+
+  STaosQnode *pHead = atomic_load_ptr(&queue->pending);
+  while (1) {
+    pNode->next = pHead;
+    STaosQnode *pOld = atomic_val_compare_exchange_ptr(&queue->pending, pHead, pNode);
+    if (pOld == pHead) break;
+    pHead = pOld;
+  }
+  uTrace("item:%p is put into queue:%p, items:%d mem:%" PRId64, pNode->item, queue, numOfItems, memOfItems);
+
+  return qset;
+}
+
 void taosWriteQitem(STaosQueue *queue, void *pItem) {
   STaosQnode *pNode = (STaosQnode *)(((char *)pItem) - sizeof(STaosQnode));
-  pNode->next = NULL;
+  STaosQset  *qset = NULL;
 
-  taosThreadMutexLock(&queue->mutex);
+  if (atomic_add_fetch_32(&queue->writers, 1) & QUEUE_WRITERS_BLOCKED) {
+    // the queue is joining or leaving a qset
+    atomic_sub_fetch_32(&queue->writers, 1);
+    taosThreadMutexLock(&queue->mutex);
+    qset = taosQueuePush(queue, pNode);
+    taosThreadMutexUnlock(&queue->mutex);
+  } else {
+    qset = taosQueuePush(queue, pNode);
+    atomic_sub_fetch_32(&queue->writers, 1);
+  }
+
+  if (qset) {
+    // only wake readers parked on sem, the spinning and busy ones see seq change
+    atomic_add_fetch_64(&qset->seq, 1);
+    if (atomic_load_32(&qset->numOfWaiters) > 0) tsem_post(&qset->sem);
+  }
+}
+
+// move the pending items to the tail of head list, with queue mutex locked
+static void taosQueueDrainPending(STaosQueue *queue) {
+  STaosQnode *pNode = atomic_exchange_ptr(&queue->pending, NULL);
+  if (pNode == NULL) return;
+
+  STaosQnode *pFirst = NULL;
+  STaosQnode *pLast = pNode;
+  while (pNode) {
+    STaosQnode *pNext = pNode->next;
+    pNode->next = pFirst;
+    pFirst = pNode;
+    pNode = pNext;
+  }
 
   if (queue->tail) {
-    queue->tail->next = pNode;
-    queue->tail = pNode;
+    queue->tail->next = pFirst;
   } else {
-    queue->head = pNode;
-    queue->tail = pNode;
+    queue->head = pFirst;
+  }
+  queue->tail = pLast;
+}
+
+// checked without the queue mutex, only to skip the queues that are surely empty
+static FORCE_INLINE bool taosQueueMayHaveItems(STaosQueue *queue) {
+  return atomic_load_ptr(&queue->head) != NULL || atomic_load_ptr(&queue->pending) != NULL;
+}
+
+static FORCE_INLINE void taosQueueAddLatency(STaosQueue *queue, int64_t nowUs, STaosQnode *pNode) {
+  int64_t waitUs = nowUs - pNode->timestamp;
+  int32_t bucket = 0;
+  while (waitUs > 0 && bucket < QUEUE_LATENCY_BUCKETS - 1) {
+    waitUs >>= 1;
+    bucket++;
   }
+  queue->latency[bucket]++;
+}
 
-  queue->numOfItems++;
-  queue->memOfItems += pNode->size;
-  if (queue->qset) atomic_add_fetch_32(&queue->qset->numOfItems, 1);
-  uTrace("item:%p is put into queue:%p, items:%d mem:%" PRId64, pItem, queue, queue->numOfItems, queue->memOfItems);
+// take the first item, with queue mutex locked
+static STaosQnode *taosQueuePop(STaosQueue *queue) {
+  if (queue->head == NULL) taosQueueDrainPending(queue);
 
-  taosThreadMutexUnlock(&queue->mutex);
+  STaosQnode *pNode = queue->head;
+  if (pNode == NULL) return NULL;
 
-  if (queue->qset) tsem_post(&queue->qset->sem);
+  queue->head = pNode->next;
+  if (queue->head == NULL) queue->tail = NULL;
+  atomic_sub_fetch_64(&queue->memOfItems, pNode->size);
+  taosQueueAddLatency(queue, taosGetTimestampUs(), pNode);
+  return pNode;
+}
+
+// take all the items, with queue mutex locked
+static int32_t taosQueuePopAll(STaosQueue *queue, STaosQall *qall) {
+  taosQueueDrainPending(queue);
+  if (queue->head == NULL) return 0;
+
+  int32_t numOfItems = 0;
+  int64_t memOfItems = 0;
+  int64_t nowUs = taosGetTimestampUs();
+  for (STaosQnode *pNode = queue->head; pNode != NULL; pNode = pNode->next) {
+    numOfItems++;
+    memOfItems += pNode->size;
+    taosQueueAddLatency(queue, nowUs, pNode);
+  }
+
+  qall->current = queue->head;
+  qall->start = queue->head;
+  qall->numOfItems = numOfItems;
+
+  queue->head = NULL;
+  queue->tail = NULL;
+  atomic_sub_fetch_64(&queue->memOfItems, memOfItems);
+  return numOfItems;
 }
 
 int32_t taosReadQitem(STaosQueue *queue, void **ppItem) {
-  STaosQnode *pNode = NULL;
-  int32_t     code = 0;
+  int32_t code = 0;
 
   taosThreadMutexLock(&queue->mutex);
 
-  if (queue->head) {
-    pNode = queue->head;
+  STaosQnode *pNode = taosQueuePop(queue);
+  if (pNode) {
     *ppItem = pNode->item;
-    queue->head = pNode->next;
-    if (queue->head == NULL) queue->tail = NULL;
-    queue->numOfItems--;
-    queue->memOfItems -= pNode->size;
+    int32_t numOfItems = atomic_sub_fetch_32(&queue->numOfItems, 1);
     if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, 1);
     code = 1;
-    uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, queue->numOfItems,
-           queue->memOfItems);
+    uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, numOfItems,
+           atomic_load_64(&queue->memOfItems));
   }
 
   taosThreadMutexUnlock(&queue->mutex);
@@ -212,32 +358,20 @@ STaosQall *taosAllocateQall() {
 void taosFreeQall(STaosQall *qall) { taosMemoryFree(qall); }
 
 int32_t taosReadAllQitems(STaosQueue *queue, STaosQall *qall) {
-  int32_t numOfItems = 0;
-  bool    empty;
-
   taosThreadMutexLock(&queue->mutex);
 
-  empty = queue->head == NULL;
-  if (!empty) {
-    memset(qall, 0, sizeof(STaosQall));
-    qall->current = queue->head;
-    qall->start = queue->head;
-    qall->numOfItems = queue->numOfItems;
-    numOfItems = qall->numOfItems;
-
-    queue->head = NULL;
-    queue->tail = NULL;
-    queue->numOfItems = 0;
-    queue->memOfItems = 0;
-    uTrace("read %d items from queue:%p, items:%d mem:%" PRId64, numOfItems, queue, queue->numOfItems,
-           queue->memOfItems);
-    if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, qall->numOfItems);
+  int32_t numOfItems = taosQueuePopAll(queue, qall);
+  if (numOfItems > 0) {
+    atomic_sub_fetch_32(&queue->numOfItems, numOfItems);
+    uTrace("read %d items from queue:%p, items:%d mem:%" PRId64, numOfItems, queue, atomic_load_32(&queue->numOfItems),
+           atomic_load_64(&queue->memOfItems));
+    if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, numOfItems);
   }
 
   taosThreadMutexUnlock(&queue->mutex);
 
   // if source queue is empty, we set destination qall to empty too.
-  if (empty) {
+  if (numOfItems == 0) {
     qall->current = NULL;
     qall->start = NULL;
     qall->numOfItems = 0;
@@ -272,6 +406,7 @@ STaosQset *taosOpenQset() {
 
   taosThreadMutexInit(&qset->mutex, NULL);
   tsem_init(&qset->sem, 0, 0);
+  qset->spinLimit = QSET_MIN_SPIN;
 
   uDebug("qset:%p is opened", qset);
   return qset;
@@ -286,7 +421,11 @@ void taosCloseQset(STaosQset *qset) {
     STaosQueue *queue = qset->head;
     qset->head = qset->head->next;
 
-    queue->qset = NULL;
+    taosThreadMutexLock(&queue->mutex);
+    taosQueueBlockWriters(queue);
+    atomic_store_ptr(&queue->qset, NULL);
+    taosQueueUnblockWriters(queue);
+    taosThreadMutexUnlock(&queue->mutex);
     queue->next = NULL;
   }
   taosThreadMutexUnlock(&qset->mutex);
@@ -297,11 +436,11 @@ void taosCloseQset(STaosQset *qset) {
   uDebug("qset:%p is closed", qset);
 }
 
-// tsem_post 'qset->sem', so that reader threads waiting for it
-// resumes execution and return, should only be used to signal the
-// thread to exit.
+// ask one reader thread of 'qset' to return once it finds no item,
+// should only be used to signal the thread to exit.
 void taosQsetThreadResume(STaosQset *qset) {
   uDebug("qset:%p, it will exit", qset);
+  atomic_add_fetch_32(&qset->numOfExits, 1);
   tsem_post(&qset->sem);
 }
 
@@ -316,12 +455,20 @@ int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle) {
   qset->numOfQueues++;
 
   taosThreadMutexLock(&queue->mutex);
-  atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
-  queue->qset = qset;
+  taosQueueBlockWriters(queue);
+  atomic_add_fetch_32(&qset->numOfItems, atomic_load_32(&queue->numOfItems));
+  atomic_store_ptr(&queue->qset, qset);
+  taosQueueUnblockWriters(queue);
   taosThreadMutexUnlock(&queue->mutex);
 
   taosThreadMutexUnlock(&qset->mutex);
 
+  // items written before joining were not counted by readers of qset
+  if (taosQueueMayHaveItems(queue)) {
+    atomic_add_fetch_64(&qset->seq, 1);
+    tsem_post(&qset->sem);
+  }
+
   uTrace("queue:%p is added into qset:%p", queue, qset);
   return 0;
 }
@@ -354,8 +501,10 @@ void taosRemoveFromQset(STaosQset *qset, STaosQueue *queue) {
       qset->numOfQueues--;
 
       taosThreadMutexLock(&queue->mutex);
-      atomic_sub_fetch_32(&qset->numOfItems, queue->numOfItems);
-      queue->qset = NULL;
+      taosQueueBlockWriters(queue);
+      atomic_sub_fetch_32(&qset->numOfItems, atomic_load_32(&queue->numOfItems));
+      atomic_store_ptr(&queue->qset, NULL);
+      taosQueueUnblockWriters(queue);
       queue->next = NULL;
       taosThreadMutexUnlock(&queue->mutex);
     }
@@ -366,12 +515,44 @@ void taosRemoveFromQset(STaosQset *qset, STaosQueue *queue) {
   uDebug("queue:%p is removed from qset:%p", queue, qset);
 }
 
-int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo) {
+static bool taosQsetClaimExit(STaosQset *qset) {
+  int32_t numOfExits = atomic_load_32(&qset->numOfExits);
+  while (numOfExits > 0) {
+    int32_t old = atomic_val_compare_exchange_32(&qset->numOfExits, numOfExits, numOfExits - 1);
+    if (old == numOfExits) return true;
+    numOfExits = old;
+  }
+  return false;
+}
+
+// wait for a write after 'seq' was read and qset was found empty. spin a bounded while before parking on sem, and
+// adapt the bound to whether spinning pays off. return false if the reader shall exit.
+static bool taosQsetWait(STaosQset *qset, int64_t seq) {
+  if (taosQsetClaimExit(qset)) return false;
+
+  int32_t spinLimit = atomic_load_32(&qset->spinLimit);
+  for (int32_t i = 0; i < spinLimit; ++i) {
+    if (atomic_load_64(&qset->seq) != seq) {
+      if (spinLimit < QSET_MAX_SPIN) atomic_store_32(&qset->spinLimit, spinLimit << 1);
+      return true;
+    }
+    taosQsetSpinPause();
+  }
+  if (spinLimit > QSET_MIN_SPIN) atomic_store_32(&qset->spinLimit, spinLimit >> 1);
+
+  // a writer bumps seq before checking the waiters, so one of the two sides sees the other
+  atomic_add_fetch_32(&qset->numOfWaiters, 1);
+  if (atomic_load_64(&qset->seq) == seq && atomic_load_32(&qset->numOfExits) == 0) {
+    tsem_wait(&qset->sem);
+  }
+  atomic_sub_fetch_32(&qset->numOfWaiters, 1);
+  return true;
+}
+
+static int32_t taosReadQitemFromQsetOnce(STaosQset *qset, void **ppItem, SQueueInfo *qinfo) {
   STaosQnode *pNode = NULL;
   int32_t     code = 0;
 
-  tsem_wait(&qset->sem);
-
   taosThreadMutexLock(&qset->mutex);
 
   for (int32_t i = 0; i < qset->numOfQueues; ++i) {
@@ -379,26 +560,23 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
     STaosQueue *queue = qset->current;
     if (queue) qset->current = queue->next;
     if (queue == NULL) break;
-    if (queue->head == NULL) continue;
+    if (!taosQueueMayHaveItems(queue)) continue;
 
     taosThreadMutexLock(&queue->mutex);
 
-    if (queue->head) {
-      pNode = queue->head;
+    pNode = taosQueuePop(queue);
+    if (pNode) {
       *ppItem = pNode->item;
       qinfo->ahandle = queue->ahandle;
       qinfo->fp = queue->itemFp;
       qinfo->queue = queue;
       qinfo->timestamp = pNode->timestamp;
 
-      queue->head = pNode->next;
-      if (queue->head == NULL) queue->tail = NULL;
-      // queue->numOfItems--;
-      queue->memOfItems -= pNode->size;
+      // queue->numOfItems is decreased by taosUpdateItemSize after the item is processed
       atomic_sub_fetch_32(&qset->numOfItems, 1);
       code = 1;
-      uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, queue->numOfItems - 1,
-             queue->memOfItems);
+      uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue,
+             atomic_load_32(&queue->numOfItems) - 1, atomic_load_64(&queue->memOfItems));
     }
 
     taosThreadMutexUnlock(&queue->mutex);
@@ -410,11 +588,19 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
   return code;
 }
 
-int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
+int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo) {
+  while (1) {
+    int64_t seq = atomic_load_64(&qset->seq);
+    int32_t code = taosReadQitemFromQsetOnce(qset, ppItem, qinfo);
+    if (code != 0) return code;
+    if (!taosQsetWait(qset, seq)) return 0;
+  }
+}
+
+static int32_t taosReadAllQitemsFromQsetOnce(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
   STaosQueue *queue;
   int32_t     code = 0;
 
-  tsem_wait(&qset->sem);
   taosThreadMutexLock(&qset->mutex);
 
   for (int32_t i = 0; i < qset->numOfQueues; ++i) {
@@ -422,29 +608,19 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
     queue = qset->current;
     if (queue) qset->current = queue->next;
     if (queue == NULL) break;
-    if (queue->head == NULL) continue;
+    if (!taosQueueMayHaveItems(queue)) continue;
 
     taosThreadMutexLock(&queue->mutex);
 
-    if (queue->head) {
-      qall->current = queue->head;
-      qall->start = queue->head;
-      qall->numOfItems = queue->numOfItems;
-      code = qall->numOfItems;
+    code = taosQueuePopAll(queue, qall);
+    if (code > 0) {
       qinfo->ahandle = queue->ahandle;
       qinfo->fp = queue->itemsFp;
       qinfo->queue = queue;
 
-      queue->head = NULL;
-      queue->tail = NULL;
-      // queue->numOfItems = 0;
-      queue->memOfItems = 0;
-      uTrace("read %d items from queue:%p, items:0 mem:%" PRId64, code, queue, queue->memOfItems);
-
-      atomic_sub_fetch_32(&qset->numOfItems, qall->numOfItems);
-      for (int32_t j = 1; j < qall->numOfItems; ++j) {
-        tsem_wait(&qset->sem);
-      }
+      // queue->numOfItems is decreased by taosUpdateItemSize after the items are processed
+      uTrace("read %d items from queue:%p, items:0 mem:%" PRId64, code, queue, atomic_load_64(&queue->memOfItems));
+      atomic_sub_fetch_32(&qset->numOfItems, code);
     }
 
     taosThreadMutexUnlock(&queue->mutex);
@@ -456,6 +632,15 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
   return code;
 }
 
+int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
+  while (1) {
+    int64_t seq = atomic_load_64(&qset->seq);
+    int32_t code = taosReadAllQitemsFromQsetOnce(qset, qall, qinfo);
+    if (code != 0) return code;
+    if (!taosQsetWait(qset, seq)) return 0;
+  }
+}
+
 int32_t taosQallItemSize(STaosQall *qall) { return qall->numOfItems; }
 void    taosResetQitems(STaosQall *qall) { qall->current = qall->start; }
 int32_t taosGetQueueNumber(STaosQset *qset) { return qset->numOfQueues; }
@@ -411,7 +411,10 @@ int32_t tSingleWorkerInit(SSingleWorker *pWorker, const SSingleWorkerCfg *pCfg)
   if (tQWorkerInit(pPool) != 0) return -1;
 
   pWorker->queue = tQWorkerAllocQueue(pPool, pCfg->param, pCfg->fp);
-  if (pWorker->queue == NULL) return -1;
+  if (pWorker->queue == NULL) {
+    tQWorkerCleanup(pPool);
+    return -1;
+  }
 
   pWorker->name = pCfg->name;
   return 0;
@@ -426,6 +429,7 @@ void tSingleWorkerCleanup(SSingleWorker *pWorker) {
 
   tQWorkerCleanup(&pWorker->pool);
   tQWorkerFreeQueue(&pWorker->pool, pWorker->queue);
+  pWorker->queue = NULL;
 }
 
 int32_t tMultiWorkerInit(SMultiWorker *pWorker, const SMultiWorkerCfg *pCfg) {
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Compares the decompression throughput of each codec with the scalar and the SIMD kernels, and of the frame of
+// reference codec for the integer types.
+
+#include "tcompression.h"
+#include "ttypes.h"
+
+static int8_t benchTypes[] = {TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_SMALLINT,  TSDB_DATA_TYPE_INT,
+                              TSDB_DATA_TYPE_BIGINT,  TSDB_DATA_TYPE_BOOL,      TSDB_DATA_TYPE_TIMESTAMP,
+                              TSDB_DATA_TYPE_FLOAT,   TSDB_DATA_TYPE_DOUBLE};
+
+static void benchFillData(int8_t type, char *pData, int32_t nEle) {
+  int64_t value = 0;
+  for (int32_t i = 0; i < nEle; i++) {
+    value += taosRand() % 16 - 4;
+    switch (type) {
+      case TSDB_DATA_TYPE_BOOL:
+        pData[i] = taosRand() % 2;
+        break;
+      case TSDB_DATA_TYPE_TINYINT:
+        ((int8_t *)pData)[i] = (int8_t)value;
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        ((int16_t *)pData)[i] = (int16_t)value;
+        break;
+      case TSDB_DATA_TYPE_INT:
+        ((int32_t *)pData)[i] = (int32_t)value;
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        ((int64_t *)pData)[i] = value;
+        break;
+      case TSDB_DATA_TYPE_TIMESTAMP:
+        ((int64_t *)pData)[i] = 1672502400000 + i * 1000 + taosRand() % 3;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        ((float *)pData)[i] = value / 100.0f;
+        break;
+      case TSDB_DATA_TYPE_DOUBLE:
+        ((double *)pData)[i] = value / 100.0;
+        break;
+    }
+  }
+}
+
+static double benchDecompress(tDataTypeDescriptor *pType, char *pCmpr, int32_t nCmpr, char *pOut, int32_t nOut, int32_t nEle,
+                              int32_t loops) {
+  int64_t start = taosGetTimestampUs();
+  for (int32_t i = 0; i < loops; i++) {
+    pType->decompFunc(pCmpr, nCmpr, nEle, pOut, nOut, ONE_STAGE_COMP, NULL, 0);
+  }
+  double usedTime = (taosGetTimestampUs() - start) / 1000000.0;
+
+  return (double)nOut * loops / usedTime / (1024 * 1024);
+}
+
+static double benchDecompressFOR(tDataTypeDescriptor *pType, bool delta, char *pCmpr, int32_t nCmpr, char *pOut,
+                                 int32_t nOut, int32_t nEle, int32_t loops) {
+  int64_t start = taosGetTimestampUs();
+  for (int32_t i = 0; i < loops; i++) {
+    tsDecompressFOR(pCmpr, nCmpr, nEle, pType->bytes, delta, pOut, nOut);
+  }
+  double usedTime = (taosGetTimestampUs() - start) / 1000000.0;
+
+  return (double)nOut * loops / usedTime / (1024 * 1024);
+}
+
+int main(int argc, char *argv[]) {
+  int32_t nEle = 4096;
+  int32_t loops = 10000;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      nEle = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0 && i < argc - 1) {
+      loops = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-n rows]: number of values in one block, default is:%d\n", nEle);
+      printf("  [-l loops]: number of decompressions of each codec, default is:%d\n", loops);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  char sse42 = 0, avx = 0, fma = 0;
+  taosGetCpuInstructions(&sse42, &avx, &tsAVX2Enable, &fma);
+  printf("AVX2:%s\n\n", tsAVX2Enable ? "yes" : "no");
+  printf("%-10s %8s %14s %14s\n", "codec", "ratio", "scalar(MB/s)", "simd(MB/s)");
+
+  for (int32_t i = 0; i < sizeof(benchTypes) / sizeof(benchTypes[0]); i++) {
+    tDataTypeDescriptor *pType = &tDataTypes[benchTypes[i]];
+    int32_t              nBytes = nEle * pType->bytes;
+    char                *pData = taosMemoryMalloc(nBytes);
+    char                *pCmpr = taosMemoryMalloc(nBytes + COMP_OVERFLOW_BYTES + 64);
+    char                *pOut = taosMemoryMalloc(nBytes + 64);
+
+    benchFillData(pType->type, pData, nEle);
+    int32_t nCmpr = pType->compFunc(pData, nBytes, nEle, pCmpr, nBytes + COMP_OVERFLOW_BYTES + 64, ONE_STAGE_COMP,
+                                     NULL, 0);
+
+    tsSIMDBuiltins = 0;
+    double scalar = benchDecompress(pType, pCmpr, nCmpr, pOut, nBytes, nEle, loops);
+    tsSIMDBuiltins = 1;
+    double simd = benchDecompress(pType, pCmpr, nCmpr, pOut, nBytes, nEle, loops);
+
+    printf("%-10s %8.2f %14.1f %14.1f%s\n", pType->name, (double)nBytes / nCmpr, scalar, simd,
+           memcmp(pData, pOut, nBytes) ? " mismatch" : "");
+
+    if (IS_INTEGER_TYPE(pType->type) || pType->type == TSDB_DATA_TYPE_TIMESTAMP) {
+      int32_t szFOR, szDeltaFOR;
+      tsCompressFORSize(pData, nEle, pType->bytes, &szFOR, &szDeltaFOR);
+      bool delta = szDeltaFOR < szFOR;
+
+      nCmpr = delta ? szDeltaFOR : szFOR;
+      pCmpr = taosMemoryRealloc(pCmpr, nCmpr);
+      tsCompressFOR(pData, nEle, pType->bytes, delta, pCmpr, nCmpr);
+
+      tsSIMDBuiltins = 0;
+      scalar = benchDecompressFOR(pType, delta, pCmpr, nCmpr, pOut, nBytes, nEle, loops);
+      tsSIMDBuiltins = 1;
+      simd = benchDecompressFOR(pType, delta, pCmpr, nCmpr, pOut, nBytes, nEle, loops);
+
+      printf("%-10s %8.2f %14.1f %14.1f%s\n", delta ? "  delta-for" : "  for", (double)nBytes / nCmpr, scalar, simd,
+             memcmp(pData, pOut, nBytes) ? " mismatch" : "");
+    }
+
+    taosMemoryFree(pData);
+    taosMemoryFree(pCmpr);
+    taosMemoryFree(pOut);
+  }
+
+  return 0;
+}
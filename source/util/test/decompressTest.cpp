@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "tcompression.h"
+
+namespace {
+
+// decompress with the scalar and the SIMD kernels, both must reproduce the original data
+void checkDecompress(int32_t (*decompress)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t),
+                     const char *pOrigin, int32_t nEle, int32_t nBytes, char *pCmpr, int32_t nCmpr) {
+  std::vector<char> scalar(nBytes + 64);
+  std::vector<char> simd(nBytes + 64);
+  char              avx2 = tsAVX2Enable;
+  char              builtins = tsSIMDBuiltins;
+  char              sse42 = 0, avx = 0, fma = 0;
+
+  tsAVX2Enable = 0;
+  tsSIMDBuiltins = 0;
+  decompress(pCmpr, nCmpr, nEle, scalar.data(), nBytes, ONE_STAGE_COMP, NULL, 0);
+
+  taosGetCpuInstructions(&sse42, &avx, &tsAVX2Enable, &fma);
+  tsSIMDBuiltins = 1;
+  decompress(pCmpr, nCmpr, nEle, simd.data(), nBytes, ONE_STAGE_COMP, NULL, 0);
+  tsAVX2Enable = avx2;
+  tsSIMDBuiltins = builtins;
+
+  ASSERT_EQ(memcmp(scalar.data(), pOrigin, nBytes), 0);
+  ASSERT_EQ(memcmp(simd.data(), pOrigin, nBytes), 0);
+}
+
+template <typename T>
+void checkInteger(int32_t (*compress)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t),
+                  int32_t (*decompress)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t)) {
+  const int32_t  nEle = 4099;
+  std::vector<T> data(nEle);
+  std::vector<char> cmpr(nEle * sizeof(T) + 64);
+
+  // deltas of different widths select different simple8b selectors, including the runs of 0/1 selectors
+  for (int32_t width : {0, 1, 3, 7, 12, 20, 30}) {
+    int64_t value = 0;
+    for (int32_t i = 0; i < nEle; i++) {
+      int64_t delta = (i % 512 < 64) ? 0 : (taosRand() % ((1LL << width) + 1)) - (1LL << width) / 2;
+      value += delta;
+      data[i] = (T)value;
+    }
+
+    int32_t nCmpr = compress(data.data(), nEle * sizeof(T), nEle, cmpr.data(), cmpr.size(), ONE_STAGE_COMP, NULL, 0);
+    ASSERT_GT(nCmpr, 0);
+    checkDecompress(decompress, (const char *)data.data(), nEle, nEle * sizeof(T), cmpr.data(), nCmpr);
+  }
+}
+
+}  // namespace
+
+TEST(TD_UTIL_COMPRESSION_TEST, decompress_integer) {
+  checkInteger<int8_t>(tsCompressTinyint, tsDecompressTinyint);
+  checkInteger<int16_t>(tsCompressSmallint, tsDecompressSmallint);
+  checkInteger<int32_t>(tsCompressInt, tsDecompressInt);
+  checkInteger<int64_t>(tsCompressBigint, tsDecompressBigint);
+}
+
+TEST(TD_UTIL_COMPRESSION_TEST, decompress_bool) {
+  for (int32_t nEle : {1, 31, 32, 33, 1000, 4097}) {
+    std::vector<char> data(nEle);
+    std::vector<char> cmpr(nEle + 64);
+
+    for (int32_t i = 0; i < nEle; i++) {
+      int32_t r = taosRand() % 3;
+      data[i] = (r == 2) ? TSDB_DATA_BOOL_NULL : r;
+    }
+
+    int32_t nCmpr = tsCompressBool(data.data(), nEle, nEle, cmpr.data(), cmpr.size(), ONE_STAGE_COMP, NULL, 0);
+    ASSERT_GT(nCmpr, 0);
+    checkDecompress(tsDecompressBool, data.data(), nEle, nEle, cmpr.data(), nCmpr);
+  }
+}
+
+namespace {
+
+template <typename T>
+void checkFOR(bool delta) {
+  for (int32_t nEle : {1, 2, 127, 128, 129, 1000, 4096}) {
+    for (int32_t width = 0; width <= 64; width += (width < 36 ? 1 : 7)) {
+      std::vector<T> data(nEle);
+      int64_t        value = taosRand();
+      for (int32_t i = 0; i < nEle; i++) {
+        uint64_t r = ((uint64_t)taosRand() << 32 | taosRand()) & ((width == 64) ? UINT64_MAX : ((1ULL << width) - 1));
+        value = delta ? (int64_t)((uint64_t)value + r) : (int64_t)r - 1000;
+        data[i] = (T)value;
+      }
+
+      int32_t szFOR = 0, szDeltaFOR = 0;
+      tsCompressFORSize(data.data(), nEle, sizeof(T), &szFOR, &szDeltaFOR);
+      int32_t size = delta ? szDeltaFOR : szFOR;
+      std::vector<char> cmpr(size);
+      ASSERT_EQ(tsCompressFOR(data.data(), nEle, sizeof(T), delta, cmpr.data(), size), size);
+
+      std::vector<T> scalar(nEle);
+      std::vector<T> simd(nEle);
+      char           avx2 = tsAVX2Enable;
+      char           builtins = tsSIMDBuiltins;
+      char           sse42 = 0, avx = 0, fma = 0;
+
+      tsAVX2Enable = 0;
+      tsSIMDBuiltins = 0;
+      ASSERT_EQ(tsDecompressFOR(cmpr.data(), size, nEle, sizeof(T), delta, scalar.data(), nEle * sizeof(T)),
+                nEle * sizeof(T));
+
+      taosGetCpuInstructions(&sse42, &avx, &tsAVX2Enable, &fma);
+      tsSIMDBuiltins = 1;
+      ASSERT_EQ(tsDecompressFOR(cmpr.data(), size, nEle, sizeof(T), delta, simd.data(), nEle * sizeof(T)),
+                nEle * sizeof(T));
+      tsAVX2Enable = avx2;
+      tsSIMDBuiltins = builtins;
+
+      ASSERT_EQ(scalar, data);
+      ASSERT_EQ(simd, data);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(TD_UTIL_COMPRESSION_TEST, frame_of_reference) {
+  for (bool delta : {false, true}) {
+    checkFOR<int8_t>(delta);
+    checkFOR<int16_t>(delta);
+    checkFOR<int32_t>(delta);
+    checkFOR<int64_t>(delta);
+  }
+}
+
+TEST(TD_UTIL_COMPRESSION_TEST, frame_of_reference_counter) {
+  // a monotonic counter packs into 128 * 2 bits per block in delta mode
+  const int32_t        nEle = 4096;
+  std::vector<int64_t> data(nEle);
+  for (int32_t i = 0; i < nEle; i++) {
+    data[i] = 1000000000000LL + i * 10 + taosRand() % 4;
+  }
+
+  int32_t szFOR = 0, size = 0;
+  tsCompressFORSize(data.data(), nEle, sizeof(int64_t), &szFOR, &size);
+  ASSERT_LE(size, sizeof(int64_t) + nEle / 128 * (1 + sizeof(int64_t) + 128 * 3 / 8));
+
+  std::vector<char> cmpr(size);
+  ASSERT_EQ(tsCompressFOR(data.data(), nEle, sizeof(int64_t), true, cmpr.data(), size), size);
+
+  std::vector<int64_t> out(nEle);
+  ASSERT_EQ(tsDecompressFOR(cmpr.data(), size, nEle, sizeof(int64_t), true, out.data(), nEle * sizeof(int64_t)),
+            nEle * sizeof(int64_t));
+  ASSERT_EQ(out, data);
+}
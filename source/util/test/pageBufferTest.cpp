@@ -157,6 +157,60 @@ void recyclePageTest() {
 
   destroyDiskbasedBuf(pBuf);
 }
+
+// pages evicted are compressed and written in background, and loaded back while being written or after
+void compressPageTest() {
+  ASSERT_EQ(initBufPageWritePool(), 0);
+
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        ret = createDiskbasedBuf(&pBuf, 4096, 4 * 4096, "2", TD_TMP_DIR_PATH);
+  ASSERT_EQ(ret, 0);
+  setBufPageCompressOnDisk(pBuf, true);
+
+  const int32_t numOfPages = 200;
+  const int32_t numOfVals = 4096 / sizeof(int32_t) - 1;
+
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    int32_t    pageId = 0;
+    SFilePage* pPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pPage != NULL);
+    ASSERT_EQ(pageId, i);
+
+    int32_t* pVals = (int32_t*)pPage;
+    for (int32_t j = 0; j < numOfVals; ++j) {
+      // half of the pages are not compressible
+      pVals[j] = (i % 2 == 0) ? i : (int32_t)taosRand();
+    }
+    pVals[0] = i;
+
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pBuf, pPage);
+  }
+
+  for (int32_t n = 0; n < 2; ++n) {
+    for (int32_t i = 0; i < numOfPages; ++i) {
+      int32_t* pVals = static_cast<int32_t*>(getBufPage(pBuf, i));
+      ASSERT_TRUE(pVals != NULL);
+      ASSERT_EQ(pVals[0], i);
+      if (i % 2 == 0) {
+        ASSERT_EQ(pVals[numOfVals - 1], i);
+      }
+
+      // written again with the same size
+      if (n == 0 && i % 4 == 0) {
+        setBufPageDirty(pVals, true);
+      }
+      releaseBufPage(pBuf, pVals);
+    }
+  }
+
+  SDiskbasedBufStatis statis = getDBufStatis(pBuf);
+  ASSERT_GT(statis.flushPages, numOfPages - 4);
+  ASSERT_LT(statis.flushBytes, statis.rawFlushBytes);
+
+  destroyDiskbasedBuf(pBuf);
+  cleanupBufPageWritePool();
+}
 }  // namespace
 
 TEST(testCase, resultBufferTest) {
@@ -164,6 +218,7 @@ TEST(testCase, resultBufferTest) {
   simpleTest();
   writeDownTest();
   recyclePageTest();
+  compressPageTest();
 }
 
 #pragma GCC diagnostic pop
\ No newline at end of file
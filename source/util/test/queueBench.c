@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures the throughput of a worker pool fed by many writer threads, one queue per writer, with a growing number of
+// writers, and prints the distribution of the time items wait in the queues before a worker picks them up.
+
+#include "tqueue.h"
+#include "tworker.h"
+
+typedef struct {
+  int32_t     nItem;
+  STaosQueue *queue;
+  TdThread    thread;
+} SBenchInfo;
+
+static volatile int64_t benchDone = 0;
+
+static void *benchWriteFp(void *param) {
+  SBenchInfo *pInfo = (SBenchInfo *)param;
+
+  for (int32_t i = 0; i < pInfo->nItem; i++) {
+    int64_t *pItem = taosAllocateQitem(sizeof(int64_t), DEF_QITEM, 0);
+    if (pItem == NULL) break;
+    *pItem = i;
+    taosWriteQitem(pInfo->queue, pItem);
+  }
+
+  return NULL;
+}
+
+static void benchProcessFp(SQueueInfo *pInfo, void *pItem) {
+  taosFreeQitem(pItem);
+  atomic_add_fetch_64(&benchDone, 1);
+}
+
+static void benchProcessAllFp(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfItems) {
+  void *pItem = NULL;
+  for (int32_t i = 0; i < numOfItems; i++) {
+    taosGetQitem(qall, &pItem);
+    taosFreeQitem(pItem);
+  }
+  atomic_add_fetch_64(&benchDone, numOfItems);
+}
+
+static int32_t benchRun(bool writeWorker, int32_t nWorker, int32_t nWriter, int32_t nItem) {
+  SQWorkerPool qpool = {.name = "bench", .min = nWorker, .max = nWorker};
+  SWWorkerPool wpool = {.name = "bench", .max = nWorker};
+  int32_t      code = writeWorker ? tWWorkerInit(&wpool) : tQWorkerInit(&qpool);
+  if (code != 0) return -1;
+
+  SBenchInfo *aInfo = taosMemoryCalloc(nWriter, sizeof(SBenchInfo));
+  for (int32_t i = 0; i < nWriter; i++) {
+    aInfo[i].nItem = nItem;
+    aInfo[i].queue = writeWorker ? tWWorkerAllocQueue(&wpool, NULL, benchProcessAllFp)
+                                 : tQWorkerAllocQueue(&qpool, NULL, benchProcessFp);
+    if (aInfo[i].queue == NULL) code = -1;
+  }
+
+  atomic_store_64(&benchDone, 0);
+  int64_t start = taosGetTimestampUs();
+
+  if (code == 0) {
+    for (int32_t i = 0; i < nWriter; i++) {
+      taosThreadCreate(&aInfo[i].thread, NULL, benchWriteFp, &aInfo[i]);
+    }
+    for (int32_t i = 0; i < nWriter; i++) {
+      taosThreadJoin(aInfo[i].thread, NULL);
+    }
+    while (atomic_load_64(&benchDone) < (int64_t)nWriter * nItem) {
+      taosUsleep(100);
+    }
+  }
+
+  double  usedTime = (taosGetTimestampUs() - start) / 1000000.0;
+  int64_t latency[QUEUE_LATENCY_BUCKETS] = {0};
+  for (int32_t i = 0; i < nWriter; i++) {
+    if (aInfo[i].queue == NULL) continue;
+    int64_t queueLatency[QUEUE_LATENCY_BUCKETS];
+    taosQueueLatency(aInfo[i].queue, queueLatency);
+    for (int32_t b = 0; b < QUEUE_LATENCY_BUCKETS; b++) latency[b] += queueLatency[b];
+  }
+
+  printf("%s workers:%d writers:%d items:%" PRId64 " used:%.3fs items/sec:%.0f%s\n", writeWorker ? "write" : "query",
+         nWorker, nWriter, benchDone, usedTime, benchDone / usedTime, code ? " failed" : "");
+  printf("  wait(us):");
+  for (int32_t b = 0; b < QUEUE_LATENCY_BUCKETS; b++) {
+    if (latency[b] > 0) printf(" <%" PRId64 ":%" PRId64, (int64_t)1 << b, latency[b]);
+  }
+  printf("\n");
+
+  for (int32_t i = 0; i < nWriter; i++) {
+    if (aInfo[i].queue == NULL) continue;
+    if (writeWorker) {
+      tWWorkerFreeQueue(&wpool, aInfo[i].queue);
+    } else {
+      tQWorkerFreeQueue(&qpool, aInfo[i].queue);
+    }
+  }
+  if (writeWorker) {
+    tWWorkerCleanup(&wpool);
+  } else {
+    tQWorkerCleanup(&qpool);
+  }
+
+  taosMemoryFree(aInfo);
+  return code;
+}
+
+int main(int argc, char *argv[]) {
+  int32_t nWorker = 4;
+  int32_t maxWriters = 16;
+  int32_t nItem = 100000;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-w") == 0 && i < argc - 1) {
+      nWorker = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      maxWriters = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      nItem = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-w workers]: number of worker threads, default is:%d\n", nWorker);
+      printf("  [-t threads]: max number of writer threads, default is:%d\n", maxWriters);
+      printf("  [-n items]: number of items written by each writer, default is:%d\n", nItem);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  for (int32_t nWriter = 1; nWriter <= maxWriters; nWriter <<= 1) {
+    if (benchRun(false, nWorker, nWriter, nItem) < 0) break;
+    if (benchRun(true, nWorker, nWriter, nItem) < 0) break;
+  }
+
+  return 0;
+}
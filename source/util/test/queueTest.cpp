@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "tqueue.h"
+
+using namespace std;
+
+namespace {
+
+typedef struct {
+  int32_t writer;
+  int32_t seq;
+} SQueueTestItem;
+
+void writeItem(STaosQueue *queue, int32_t writer, int32_t seq) {
+  SQueueTestItem *pItem = (SQueueTestItem *)taosAllocateQitem(sizeof(SQueueTestItem), DEF_QITEM, 0);
+  ASSERT_NE(pItem, nullptr);
+  pItem->writer = writer;
+  pItem->seq = seq;
+  taosWriteQitem(queue, pItem);
+}
+
+}  // namespace
+
+// items of each writer are read in the order they were written, whichever queue of the qset they went to
+TEST(queueTest, multiWriterFifo) {
+  const int32_t numOfWriters = 8;
+  const int32_t numOfQueues = 2;
+  const int32_t numOfItems = 20000;
+
+  STaosQset  *qset = taosOpenQset();
+  STaosQueue *queues[numOfQueues];
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    queues[i] = taosOpenQueue();
+    ASSERT_EQ(taosAddIntoQset(qset, queues[i], NULL), 0);
+  }
+
+  vector<thread> writers;
+  for (int32_t w = 0; w < numOfWriters; ++w) {
+    writers.emplace_back([&, w]() {
+      for (int32_t i = 0; i < numOfItems; ++i) {
+        writeItem(queues[w % numOfQueues], w, i);
+      }
+    });
+  }
+
+  vector<int32_t> next(numOfWriters, 0);
+  int32_t         numOfRead = 0;
+  while (numOfRead < numOfWriters * numOfItems) {
+    SQueueTestItem *pItem = NULL;
+    SQueueInfo      qinfo = {0};
+    ASSERT_EQ(taosReadQitemFromQset(qset, (void **)&pItem, &qinfo), 1);
+    ASSERT_EQ(pItem->seq, next[pItem->writer]);
+    next[pItem->writer]++;
+    numOfRead++;
+    taosFreeQitem(pItem);
+    taosUpdateItemSize((STaosQueue *)qinfo.queue, 1);
+  }
+
+  for (auto &t : writers) t.join();
+  for (int32_t w = 0; w < numOfWriters; ++w) {
+    ASSERT_EQ(next[w], numOfItems);
+  }
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    ASSERT_TRUE(taosQueueEmpty(queues[i]));
+    ASSERT_EQ(taosQueueItemSize(queues[i]), 0);
+  }
+  ASSERT_EQ(atomic_load_32(&qset->numOfItems), 0);
+
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    taosCloseQueue(queues[i]);
+  }
+  taosCloseQset(qset);
+}
+
+// the same through the batch reads
+TEST(queueTest, multiWriterFifoReadAll) {
+  const int32_t numOfWriters = 4;
+  const int32_t numOfItems = 50000;
+
+  STaosQset  *qset = taosOpenQset();
+  STaosQueue *queue = taosOpenQueue();
+  ASSERT_EQ(taosAddIntoQset(qset, queue, NULL), 0);
+
+  vector<thread> writers;
+  for (int32_t w = 0; w < numOfWriters; ++w) {
+    writers.emplace_back([&, w]() {
+      for (int32_t i = 0; i < numOfItems; ++i) {
+        writeItem(queue, w, i);
+      }
+    });
+  }
+
+  STaosQall      *qall = taosAllocateQall();
+  vector<int32_t> next(numOfWriters, 0);
+  int32_t         numOfRead = 0;
+  while (numOfRead < numOfWriters * numOfItems) {
+    SQueueInfo qinfo = {0};
+    int32_t    num = taosReadAllQitemsFromQset(qset, qall, &qinfo);
+    ASSERT_GT(num, 0);
+    for (int32_t i = 0; i < num; ++i) {
+      SQueueTestItem *pItem = NULL;
+      ASSERT_EQ(taosGetQitem(qall, (void **)&pItem), 1);
+      ASSERT_EQ(pItem->seq, next[pItem->writer]);
+      next[pItem->writer]++;
+      taosFreeQitem(pItem);
+    }
+    numOfRead += num;
+    taosUpdateItemSize((STaosQueue *)qinfo.queue, num);
+  }
+
+  for (auto &t : writers) t.join();
+  ASSERT_TRUE(taosQueueEmpty(queue));
+  ASSERT_EQ(atomic_load_32(&qset->numOfItems), 0);
+
+  taosFreeQall(qall);
+  taosCloseQueue(queue);
+  taosCloseQset(qset);
+}
+
+// every exit request makes exactly one reader return, and only once no item is left
+TEST(queueTest, exitClaims) {
+  const int32_t numOfReaders = 6;
+  const int32_t numOfItems = 10000;
+
+  STaosQset  *qset = taosOpenQset();
+  STaosQueue *queue = taosOpenQueue();
+  ASSERT_EQ(taosAddIntoQset(qset, queue, NULL), 0);
+
+  atomic<int32_t> numOfRead(0);
+  atomic<int32_t> numOfExited(0);
+  vector<thread>  readers;
+  for (int32_t r = 0; r < numOfReaders; ++r) {
+    readers.emplace_back([&]() {
+      while (1) {
+        void      *pItem = NULL;
+        SQueueInfo qinfo = {0};
+        if (taosReadQitemFromQset(qset, &pItem, &qinfo) == 0) break;
+        taosFreeQitem(pItem);
+        taosUpdateItemSize((STaosQueue *)qinfo.queue, 1);
+        numOfRead++;
+      }
+      numOfExited++;
+    });
+  }
+
+  for (int32_t i = 0; i < numOfItems; ++i) {
+    writeItem(queue, 0, i);
+  }
+
+  // the readers asked to exit first finish the items
+  for (int32_t r = 0; r < numOfReaders - 1; ++r) {
+    taosQsetThreadResume(qset);
+  }
+  while (numOfExited.load() < numOfReaders - 1) {
+    taosMsleep(1);
+  }
+  taosMsleep(50);
+  ASSERT_EQ(numOfExited.load(), numOfReaders - 1);
+  ASSERT_EQ(numOfRead.load(), numOfItems);
+
+  // the last reader still reads what is written
+  writeItem(queue, 0, numOfItems);
+  while (numOfRead.load() < numOfItems + 1) {
+    taosMsleep(1);
+  }
+
+  taosQsetThreadResume(qset);
+  for (auto &t : readers) t.join();
+  ASSERT_EQ(numOfExited.load(), numOfReaders);
+  ASSERT_EQ(atomic_load_32(&qset->numOfExits), 0);
+
+  taosCloseQueue(queue);
+  taosCloseQset(qset);
+}
+
+// Two threads pass an item back and forth through two qsets, so each one parks right after the other wrote. A
+// wakeup lost between the empty check and the park would stop the ping-pong.
+TEST(queueTest, noLostWakeup) {
+  const int32_t numOfRounds = 100000;
+
+  STaosQset  *qsets[2];
+  STaosQueue *queues[2];
+  for (int32_t i = 0; i < 2; ++i) {
+    qsets[i] = taosOpenQset();
+    queues[i] = taosOpenQueue();
+    ASSERT_EQ(taosAddIntoQset(qsets[i], queues[i], NULL), 0);
+  }
+
+  atomic<int32_t> rounds[2] = {{0}, {0}};
+  auto            player = [&](int32_t me) {
+    while (1) {
+      SQueueTestItem *pItem = NULL;
+      SQueueInfo      qinfo = {0};
+      if (taosReadQitemFromQset(qsets[me], (void **)&pItem, &qinfo) == 0) break;
+      int32_t seq = pItem->seq;
+      taosFreeQitem(pItem);
+      taosUpdateItemSize((STaosQueue *)qinfo.queue, 1);
+      rounds[me]++;
+      if (seq < numOfRounds) writeItem(queues[1 - me], me, seq + 1);
+    }
+  };
+
+  thread players[2] = {thread(player, 0), thread(player, 1)};
+  writeItem(queues[0], 1, 0);
+
+  int64_t start = taosGetTimestampMs();
+  while (rounds[0].load() + rounds[1].load() < numOfRounds + 1) {
+    ASSERT_LT(taosGetTimestampMs() - start, 60 * 1000) << "rounds:" << rounds[0].load() + rounds[1].load();
+    taosMsleep(1);
+  }
+
+  for (int32_t i = 0; i < 2; ++i) {
+    taosQsetThreadResume(qsets[i]);
+  }
+  for (auto &t : players) t.join();
+
+  for (int32_t i = 0; i < 2; ++i) {
+    taosCloseQueue(queues[i]);
+    taosCloseQset(qsets[i]);
+  }
+}
+
+// items written while the queue joins a qset are neither lost for the readers nor counted twice
+TEST(queueTest, writeWhileJoining) {
+  const int32_t numOfLoops = 200;
+  const int32_t numOfItems = 1000;
+
+  for (int32_t l = 0; l < numOfLoops; ++l) {
+    STaosQset  *qset = taosOpenQset();
+    STaosQueue *queue = taosOpenQueue();
+
+    thread writer([&]() {
+      for (int32_t i = 0; i < numOfItems; ++i) {
+        writeItem(queue, 0, i);
+      }
+    });
+    ASSERT_EQ(taosAddIntoQset(qset, queue, NULL), 0);
+
+    for (int32_t i = 0; i < numOfItems; ++i) {
+      SQueueTestItem *pItem = NULL;
+      SQueueInfo      qinfo = {0};
+      ASSERT_EQ(taosReadQitemFromQset(qset, (void **)&pItem, &qinfo), 1);
+      ASSERT_EQ(pItem->seq, i);
+      taosFreeQitem(pItem);
+      taosUpdateItemSize((STaosQueue *)qinfo.queue, 1);
+    }
+    writer.join();
+    ASSERT_EQ(atomic_load_32(&qset->numOfItems), 0);
+
+    taosRemoveFromQset(qset, queue);
+    taosCloseQueue(queue);
+    taosCloseQset(qset);
+  }
+}
+
+// the lock-free writes keep the item counter of the qset in step while the queue moves between qsets
+TEST(queueTest, writeWhileSwitching) {
+  const int32_t numOfWriters = 4;
+  const int32_t numOfItems = 50000;
+
+  STaosQset  *qsets[2] = {taosOpenQset(), taosOpenQset()};
+  STaosQueue *queue = taosOpenQueue();
+  ASSERT_EQ(taosAddIntoQset(qsets[0], queue, NULL), 0);
+
+  atomic<int32_t> numOfDone(0);
+  vector<thread>  writers;
+  for (int32_t w = 0; w < numOfWriters; ++w) {
+    writers.emplace_back([&, w]() {
+      for (int32_t i = 0; i < numOfItems; ++i) {
+        writeItem(queue, w, i);
+      }
+      numOfDone++;
+    });
+  }
+
+  int32_t current = 0;
+  while (numOfDone.load() < numOfWriters) {
+    taosRemoveFromQset(qsets[current], queue);
+    ASSERT_EQ(atomic_load_32(&qsets[current]->numOfItems), 0);
+    current = 1 - current;
+    ASSERT_EQ(taosAddIntoQset(qsets[current], queue, NULL), 0);
+  }
+  for (auto &t : writers) t.join();
+
+  ASSERT_EQ(atomic_load_32(&qsets[current]->numOfItems), numOfWriters * numOfItems);
+  ASSERT_EQ(atomic_load_32(&qsets[1 - current]->numOfItems), 0);
+
+  vector<int32_t> next(numOfWriters, 0);
+  for (int32_t i = 0; i < numOfWriters * numOfItems; ++i) {
+    SQueueTestItem *pItem = NULL;
+    SQueueInfo      qinfo = {0};
+    ASSERT_EQ(taosReadQitemFromQset(qsets[current], (void **)&pItem, &qinfo), 1);
+    ASSERT_EQ(pItem->seq, next[pItem->writer]);
+    next[pItem->writer]++;
+    taosFreeQitem(pItem);
+    taosUpdateItemSize((STaosQueue *)qinfo.queue, 1);
+  }
+  ASSERT_EQ(atomic_load_32(&qsets[current]->numOfItems), 0);
+  ASSERT_TRUE(taosQueueEmpty(queue));
+
+  taosCloseQueue(queue);
+  taosCloseQset(qsets[0]);
+  taosCloseQset(qsets[1]);
+}
@@ -0,0 +1,79 @@
+from util.log import *
+from util.sql import *
+from util.cases import *
+
+# With numOfVnodeInsertThreads > 1, the tables of one submit request are inserted into the memtable by several
+# threads. Write requests of many tables each, into a small write buffer so that the memtable is committed and
+# switched while the inserts go on, then check every table against the rows written, before and after a flush.
+class TDTestCase:
+    updatecfgDict = {'numOfVnodeInsertThreads': 4}
+
+    ctbNum       = 200
+    rounds       = 30
+    rowsPerRound = 20
+    startTs      = 1640966400000
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor())
+
+    def value(self, tb, ts, rnd):
+        return tb * 1000003 + ts * 7 + rnd
+
+    def insertRound(self, dbName, rnd, tsBase):
+        # the tables of the first round are created by the insert itself
+        parts = []
+        for tb in range(self.ctbNum):
+            values = " ".join(f"({self.startTs + tsBase + k}, {self.value(tb, tsBase + k, rnd)}, 'r{rnd}')"
+                              for k in range(self.rowsPerRound))
+            if rnd == 0:
+                parts.append(f"{dbName}.ctb{tb} using {dbName}.stb tags ({tb % 7}) values {values}")
+            else:
+                parts.append(f"{dbName}.ctb{tb} values {values}")
+        tdSql.execute("insert into " + " ".join(parts))
+
+    def check(self, dbName, expected):
+        tdSql.query(f"select tbname, count(*), sum(c1) from {dbName}.stb partition by tbname")
+        tdSql.checkRows(self.ctbNum)
+        for row in tdSql.queryResult:
+            tb = int(row[0][len("ctb"):])
+            rows = expected[tb]
+            if row[1] != len(rows) or row[2] != sum(rows.values()):
+                tdLog.exit(f"ctb{tb}: {row[1]} rows sum {row[2]}, expected {len(rows)} rows sum {sum(rows.values())}")
+
+        tdSql.query(f"select count(*) from {dbName}.stb where c2 = 'r{self.rounds}'")
+        tdSql.checkData(0, 0, self.ctbNum * self.rowsPerRound)
+
+    def run(self):
+        dbName = "pinsert"
+        tdSql.execute(f"drop database if exists {dbName}")
+        tdSql.execute(f"create database {dbName} vgroups 2 buffer 3")
+        tdSql.execute(f"create stable {dbName}.stb (ts timestamp, c1 bigint, c2 binary(8)) tags (t1 int)")
+
+        expected = [dict() for _ in range(self.ctbNum)]
+        for rnd in range(self.rounds):
+            tsBase = rnd * self.rowsPerRound
+            self.insertRound(dbName, rnd, tsBase)
+            for tb in range(self.ctbNum):
+                for k in range(self.rowsPerRound):
+                    expected[tb][tsBase + k] = self.value(tb, tsBase + k, rnd)
+
+        # overwrite rows of an earlier round, the later version wins
+        rnd = self.rounds
+        tsBase = 5 * self.rowsPerRound
+        self.insertRound(dbName, rnd, tsBase)
+        for tb in range(self.ctbNum):
+            for k in range(self.rowsPerRound):
+                expected[tb][tsBase + k] = self.value(tb, tsBase + k, rnd)
+
+        self.check(dbName, expected)
+        tdSql.execute(f"flush database {dbName}")
+        self.check(dbName, expected)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
@@ -0,0 +1,87 @@
+import taos
+from taos import *
+from util.log import *
+from util.sql import *
+from util.cases import *
+
+# A stmt insert into several subtables keeps the blocks of the subtables it has sent, and binds them again in the next
+# execs. Bind the subtables over several execs, leave some of them out of an exec, bind them again after that, and
+# check that every subtable holds exactly the rows bound to it.
+class TDTestCase:
+    ctbNum      = 6
+    execNum     = 8
+    rowsPerBind = 5
+    startTs     = 1626861392589
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor())
+        self.conn = conn
+
+    def bindRows(self, stmt, ctb, exec, expect):
+        params = new_multi_binds(4)
+        ts, c1, c2, c3 = [], [], [], []
+        for k in range(self.rowsPerBind):
+            seq = exec * self.rowsPerBind + k
+            ts.append(self.startTs + seq)
+            # nulls in some binds only, all nulls in others, to vary the flags a kept block starts the next exec from
+            c1.append(None if (ctb + exec) % 3 == 0 and k % 2 == 0 else ctb * 1000 + seq)
+            c2.append(None if ctb == exec % self.ctbNum else seq * 0.5)
+            c3.append(None if k == 0 else f"c{ctb}_{seq}")
+        params[0].timestamp(ts)
+        params[1].int(c1)
+        params[2].double(c2)
+        params[3].binary(c3)
+        stmt.bind_param_batch(params)
+        expect[ctb].extend(zip(ts, c1, c2, c3))
+
+    def run(self):
+        dbName = "stmt_multi_ctb"
+        tdSql.execute(f"drop database if exists {dbName}")
+        tdSql.execute(f"create database {dbName} vgroups 2")
+        tdSql.execute(f"create stable {dbName}.stb (ts timestamp, c1 int, c2 double, c3 binary(16)) tags (t1 int)")
+        for i in range(self.ctbNum):
+            tdSql.execute(f"create table {dbName}.ctb{i} using {dbName}.stb tags ({i})")
+
+        self.conn.select_db(dbName)
+        stmt = self.conn.statement("insert into ? values (?, ?, ?, ?)")
+        expect = [[] for _ in range(self.ctbNum)]
+        for exec in range(self.execNum):
+            # exec 2 binds only the first half of the subtables, exec 3 only the second half, exec 5 only one
+            if exec == 2:
+                ctbs = range(self.ctbNum // 2)
+            elif exec == 3:
+                ctbs = range(self.ctbNum // 2, self.ctbNum)
+            elif exec == 5:
+                ctbs = [1]
+            else:
+                ctbs = range(self.ctbNum) if exec % 2 == 0 else reversed(range(self.ctbNum))
+
+            numOfRows = 0
+            for ctb in ctbs:
+                stmt.set_tbname(f"ctb{ctb}")
+                self.bindRows(stmt, ctb, exec, expect)
+                stmt.add_batch()
+                numOfRows += self.rowsPerBind
+            stmt.execute()
+            if stmt.affected_rows != numOfRows:
+                tdLog.exit(f"exec {exec}: {stmt.affected_rows} rows inserted, {numOfRows} rows bound")
+        stmt.close()
+
+        for ctb in range(self.ctbNum):
+            tdSql.query(f"select ts, c1, c2, c3 from {dbName}.ctb{ctb} order by ts")
+            rows = [(round(r[0].timestamp() * 1000), r[1], r[2], r[3]) for r in tdSql.queryResult]
+            if rows != expect[ctb]:
+                diff = [(i, a, b) for i, (a, b) in enumerate(zip(rows, expect[ctb])) if a != b][:1]
+                tdLog.exit(f"ctb{ctb}: {len(rows)} rows, {len(expect[ctb])} rows bound, first diff (row, read, bound): {diff}")
+
+        tdSql.query(f"select count(*) from {dbName}.stb")
+        tdSql.checkData(0, 0, sum(len(e) for e in expect))
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
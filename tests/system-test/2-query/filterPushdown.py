@@ -0,0 +1,158 @@
+from util.log import *
+from util.sql import *
+from util.cases import *
+
+# The table scan pushes its filter down to the tsdb reader, which evaluates it on the filter columns of a file block
+# before loading the others, and drops the block if no row qualifies. Check the rows of filtered scans against the
+# rows of the unfiltered scan filtered here, i.e. without the pushdown: on blocks where some, none or all rows
+# qualify, with null values, in both orders, for the plain, grouped and merged scans, and with the rows in the buffer,
+# in file blocks, or in file blocks overlapped by newer rows.
+class TDTestCase:
+    rowNum  = 8000
+    ctbNum  = 4
+    blkRows = 200
+    startTs = 1640966400000
+
+    cols = ["c_int", "c_big", "c_dbl", "c_bin", "c_bool", "c_pad"]
+
+    conds = [
+        # the same value in a whole block, the other blocks have no row
+        ("c_int = 7", lambda r: r["c_int"] == 7),
+        ("c_int = 7 and c_dbl > 500", lambda r: r["c_int"] == 7 and r["c_dbl"] is not None and r["c_dbl"] > 500),
+        ("c_int > 100", lambda r: r["c_int"] is not None and r["c_int"] > 100),
+        ("c_int in (1, 2) and c_bool = true", lambda r: r["c_int"] in (1, 2) and r["c_bool"] is True),
+        # nulls, whole blocks of them in c_dbl
+        ("c_dbl is null", lambda r: r["c_dbl"] is None),
+        ("c_dbl is not null and c_int < 3", lambda r: r["c_dbl"] is not None and r["c_int"] is not None and r["c_int"] < 3),
+        ("c_dbl < 0", lambda r: r["c_dbl"] is not None and r["c_dbl"] < 0),
+        ("c_bin = 'b5'", lambda r: r["c_bin"] == "b5"),
+        ("c_bin is null or c_int = 9", lambda r: r["c_bin"] is None or r["c_int"] == 9),
+        ("c_int is null", lambda r: r["c_int"] is None),
+        # evaluated by the scalar functions
+        ("c_big % 2 = 0 and c_int >= 35", lambda r: r["c_big"] % 2 == 0 and r["c_int"] is not None and r["c_int"] >= 35),
+        # every block has qualifying rows, the reader stops the pushdown
+        ("c_big >= 0", lambda r: r["c_big"] >= 0),
+        # all the columns
+        ("c_int = 7 and c_big >= 0 and c_dbl >= 0 and c_bin is not null and c_bool is not null and c_pad >= 0",
+         lambda r: r["c_int"] == 7 and r["c_dbl"] is not None and r["c_dbl"] >= 0 and r["c_bin"] is not None and
+         r["c_bool"] is not None),
+    ]
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor())
+
+    def row(self, i, ver=0):
+        blk = i // self.blkRows
+        return {
+            "c_int": None if blk % 13 == 6 else (blk + ver) % 40,
+            "c_big": (i * 7 + ver) % 1000,
+            "c_dbl": None if blk % 9 == 4 or i % 10 == 3 else (i + ver) / 3,
+            "c_bin": None if i % 11 == 0 else f"b{(i + ver) % 13}",
+            "c_bool": None if i % 7 == 0 else (i + ver) % 2 == 0,
+            "c_pad": i * 10 + ver,
+        }
+
+    def sqlValue(self, val):
+        if val is None:
+            return "NULL"
+        if isinstance(val, bool):
+            return "true" if val else "false"
+        if isinstance(val, str):
+            return f"'{val}'"
+        return str(val)
+
+    def insert(self, tbName, offsets, ver=0):
+        values = [f"({self.startTs + i}, " + ", ".join(self.sqlValue(self.row(i, ver)[c]) for c in self.cols) + ")"
+                  for i in offsets]
+        for start in range(0, len(values), 500):
+            tdSql.execute(f"insert into {tbName} values " + " ".join(values[start:start + 500]))
+
+    def scanAll(self, tbName):
+        # the unfiltered scan, no filter pushed down
+        tdSql.query(f"select tbname, cast(ts as bigint), {', '.join(self.cols)} from {tbName}")
+        rows = []
+        for row in tdSql.queryResult:
+            r = dict(zip(["tbname", "ts"] + self.cols, row))
+            r["c_bool"] = None if r["c_bool"] is None else bool(r["c_bool"])
+            rows.append(r)
+        return rows
+
+    def key(self, r):
+        return (r["tbname"], r["ts"], r["c_pad"])
+
+    def checkCond(self, tbName, allRows, cond, pred):
+        expected = [r for r in allRows if pred(r)]
+        expKeys = sorted(self.key(r) for r in expected)
+
+        tdSql.query(f"select tbname, cast(ts as bigint), c_pad from {tbName} where {cond}")
+        res = sorted(tuple(row) for row in tdSql.queryResult)
+        if res != expKeys:
+            tdLog.exit(f"{tbName} where {cond}: {len(res)} rows, expected {len(expKeys)}")
+
+        # in time order, merged over the tables of the super table, whose keys do not overlap
+        for order in ("asc", "desc"):
+            tdSql.query(f"select cast(ts as bigint), c_pad from {tbName} where {cond} order by ts {order}")
+            res = [tuple(row) for row in tdSql.queryResult]
+            exp = sorted(((r["ts"], r["c_pad"]) for r in expected), reverse=(order == "desc"))
+            if res != exp:
+                tdLog.exit(f"{tbName} where {cond} order by ts {order}: {len(res)} rows, expected {len(exp)}")
+
+        counts = {}
+        for r in expected:
+            counts[r["tbname"]] = counts.get(r["tbname"], 0) + 1
+        tdSql.query(f"select tbname, count(*) from {tbName} where {cond} partition by tbname")
+        res = {row[0]: row[1] for row in tdSql.queryResult}
+        if res != counts:
+            tdLog.exit(f"{tbName} where {cond} partition by tbname: {res}, expected {counts}")
+
+        tdSql.query(f"select count(*), sum(c_pad) from {tbName} where {cond}")
+        count = tdSql.queryResult[0][0] if tdSql.queryRows > 0 else 0
+        if count != len(expected):
+            tdLog.exit(f"{tbName} count where {cond}: {count}, expected {len(expected)}")
+        if count > 0 and tdSql.queryResult[0][1] != sum(r["c_pad"] for r in expected):
+            tdLog.exit(f"{tbName} sum where {cond}: {tdSql.queryResult[0][1]}")
+
+    def check(self, dbName, step):
+        for tbName in (f"{dbName}.ntb", f"{dbName}.stb"):
+            allRows = self.scanAll(tbName)
+            if len(allRows) != self.expectedRows[tbName]:
+                tdLog.exit(f"{tbName} {step}: {len(allRows)} rows, expected {self.expectedRows[tbName]}")
+            for cond, pred in self.conds:
+                self.checkCond(tbName, allRows, cond, pred)
+        tdLog.info(f"{dbName} {step}: {len(self.conds)} filters checked")
+
+    def run(self):
+        dbName = "fpush"
+        tdSql.execute(f"drop database if exists {dbName}")
+        # blocks of blkRows rows once flushed
+        tdSql.execute(f"create database {dbName} vgroups 1 minrows 10 maxrows {self.blkRows}")
+        columns = "(ts timestamp, c_int int, c_big bigint, c_dbl double, c_bin binary(16), c_bool bool, c_pad bigint)"
+        tdSql.execute(f"create table {dbName}.ntb {columns}")
+        tdSql.execute(f"create stable {dbName}.stb {columns} tags (t1 int)")
+
+        self.insert(f"{dbName}.ntb", range(self.rowNum))
+        perCtb = self.rowNum // self.ctbNum
+        for c in range(self.ctbNum):
+            tdSql.execute(f"create table {dbName}.ctb{c} using {dbName}.stb tags ({c})")
+            self.insert(f"{dbName}.ctb{c}", range(c * perCtb, (c + 1) * perCtb))
+        self.expectedRows = {f"{dbName}.ntb": self.rowNum, f"{dbName}.stb": self.rowNum}
+
+        self.check(dbName, "in the buffer")
+        tdSql.execute(f"flush database {dbName}")
+        self.check(dbName, "in file blocks")
+
+        # newer versions of some rows in the buffer, the blocks they overlap are merged with them
+        self.insert(f"{dbName}.ntb", range(1000, 1400, 3), 1)
+        self.insert(f"{dbName}.ctb1", range(perCtb + 500, perCtb + 700, 2), 1)
+        self.check(dbName, "overlapped by the buffer")
+        tdSql.execute(f"flush database {dbName}")
+        self.check(dbName, "flushed again")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
@@ -0,0 +1,138 @@
+from util.log import *
+from util.sql import *
+from util.cases import *
+
+# The hash group by resolves the keys of a whole block at once. When the keys of a block are unsorted, its rows are
+# gathered by group before the aggregation, otherwise the aggregation runs on each run of rows of the same group.
+# Check both against the aggregates computed here row by row, and against partition by, for high cardinality
+# unsorted keys, several key columns, null keys, var-length keys, and groups spanning many blocks.
+class TDTestCase:
+    rowNum   = 20000
+    ctbNum   = 4
+    batch    = 500
+    startTs  = 1640966400000
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor())
+
+    def row(self, i):
+        # about as many groups as rows in a block, the rows aggregated run by run
+        kHi  = None if i % 13 == 0 else (i * 7919) % 6007
+        # fewer groups in unsorted rows, the rows gathered by group
+        kMid = None if i % 17 == 0 else (i * 7919) % 257
+        kLo  = None if i % 11 == 0 else (i * 31) % 5
+        kBin = None if i % 19 == 0 else "k" + "x" * (i % 7) + str((i * 17) % 13)
+        # sorted, the rows aggregated run by run
+        kRun = i // 150
+        v    = None if i % 29 == 0 else i * 3 - 50000
+        return {"k_hi": kHi, "k_mid": kMid, "k_lo": kLo, "k_bin": kBin, "k_run": kRun, "v": v}
+
+    def sqlValue(self, val):
+        if val is None:
+            return "NULL"
+        if isinstance(val, str):
+            return f"'{val}'"
+        return str(val)
+
+    def insert(self, tbName, rows):
+        cols = ["k_hi", "k_mid", "k_lo", "k_bin", "k_run", "v"]
+        for start in range(0, len(rows), self.batch):
+            values = " ".join(f"({self.startTs + i}, " + ", ".join(self.sqlValue(r[c]) for c in cols) + ")"
+                              for i, r in rows[start:start + self.batch])
+            tdSql.execute(f"insert into {tbName} values {values}")
+
+    def expected(self, rows, keys):
+        groups = {}
+        for _, r in rows:
+            key = tuple(r[k] for k in keys)
+            agg = groups.setdefault(key, [0, 0, None, None, None])
+            agg[0] += 1
+            v = r["v"]
+            if v is None:
+                continue
+            agg[1] += 1
+            agg[2] = v if agg[2] is None else agg[2] + v
+            agg[3] = v if agg[3] is None else min(agg[3], v)
+            agg[4] = v if agg[4] is None else max(agg[4], v)
+        return {key: tuple(agg) for key, agg in groups.items()}
+
+    def queryGroups(self, sql, numOfKeys):
+        tdSql.query(sql)
+        res = {}
+        for row in tdSql.queryResult:
+            key = tuple(row[:numOfKeys])
+            if key in res:
+                tdLog.exit(f"{sql}: group {key} returned twice")
+            res[key] = tuple(row[numOfKeys:])
+        return res
+
+    def checkGroups(self, tbName, rows, keys):
+        expected = self.expected(rows, keys)
+        keyList = ", ".join(keys)
+        aggList = "count(*), count(v), sum(v), min(v), max(v)"
+        for clause in ("group by", "partition by"):
+            sql = f"select {keyList}, {aggList} from {tbName} {clause} {keyList}"
+            res = self.queryGroups(sql, len(keys))
+            if len(res) != len(expected):
+                tdLog.exit(f"{sql}: {len(res)} groups, expected {len(expected)}")
+            for key, agg in expected.items():
+                if res.get(key) != agg:
+                    tdLog.exit(f"{sql}: group {key} is {res.get(key)}, expected {agg}")
+        tdLog.info(f"{tbName} group by {keyList}: {len(expected)} groups checked")
+
+    def checkExprGroups(self, tbName, rows):
+        # the key is computed before the aggregation
+        expected = {}
+        for _, r in rows:
+            key = None if r["k_hi"] is None else r["k_hi"] % 100
+            expected[key] = expected.get(key, 0) + 1
+
+        res = self.queryGroups(f"select k_hi % 100, count(*) from {tbName} group by k_hi % 100", 1)
+        if len(res) != len(expected):
+            tdLog.exit(f"{tbName} group by k_hi % 100: {len(res)} groups, expected {len(expected)}")
+        for key, cnt in expected.items():
+            resKey = None if key is None else float(key)
+            if res.get((resKey,)) != (cnt,):
+                tdLog.exit(f"{tbName} group by k_hi % 100: group {key} is {res.get((resKey,))}, expected {cnt}")
+
+    def check(self, dbName, ntbRows, stbRows):
+        keySets = [["k_hi"], ["k_mid"], ["k_lo"], ["k_bin"], ["k_run"], ["k_lo", "k_bin"], ["k_mid", "k_lo", "k_bin"],
+                   ["k_run", "k_lo"]]
+        for keys in keySets:
+            self.checkGroups(f"{dbName}.ntb", ntbRows, keys)
+            self.checkGroups(f"{dbName}.stb", stbRows, keys)
+        self.checkExprGroups(f"{dbName}.ntb", ntbRows)
+
+    def run(self):
+        dbName = "gbatch"
+        tdSql.execute(f"drop database if exists {dbName}")
+        # small file blocks, so that each group spans many blocks once flushed
+        tdSql.execute(f"create database {dbName} vgroups 1 minrows 10 maxrows 200")
+        columns = "(ts timestamp, k_hi int, k_mid int, k_lo tinyint, k_bin varchar(16), k_run int, v bigint)"
+        tdSql.execute(f"create table {dbName}.ntb {columns}")
+        tdSql.execute(f"create stable {dbName}.stb {columns} tags (t1 int)")
+
+        ntbRows = [(i, self.row(i)) for i in range(self.rowNum)]
+        self.insert(f"{dbName}.ntb", ntbRows)
+
+        stbRows = []
+        perCtb = self.rowNum // self.ctbNum
+        for c in range(self.ctbNum):
+            tdSql.execute(f"create table {dbName}.ctb{c} using {dbName}.stb tags ({c})")
+            # the rows of the child tables interleave, the same key in several tables
+            rows = [(i, self.row(i * self.ctbNum + c)) for i in range(perCtb)]
+            self.insert(f"{dbName}.ctb{c}", rows)
+            stbRows.extend(rows)
+
+        self.check(dbName, ntbRows, stbRows)
+        tdSql.execute(f"flush database {dbName}")
+        self.check(dbName, ntbRows, stbRows)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
@@ -0,0 +1,101 @@
+from util.log import *
+from util.sql import *
+from util.cases import *
+
+# A table scan below a hash aggregate reads the file sets of a vnode with queryParallelScan readers. Run the same
+# queries serially and in parallel, and check that the results are the same, including the queries whose plan must
+# keep the scan serial: ordered output, last/last_row, limit and interval.
+class TDTestCase:
+    ctbNum     = 20
+    rowsPerTbl = 3000
+    days       = 30
+    startTs    = 1640966400000
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor())
+
+    def prepareData(self, dbName):
+        # one file set per day, so the scan of a vnode is split into many windows
+        tdSql.execute(f"drop database if exists {dbName}")
+        tdSql.execute(f"create database {dbName} vgroups 2 duration 1d keep 3650")
+        tdSql.execute(f"create stable {dbName}.stb (ts timestamp, c1 int, c2 bigint, c3 binary(16), c4 double) tags (t1 int)")
+        for i in range(self.ctbNum):
+            tdSql.execute(f"create table {dbName}.ctb{i} using {dbName}.stb tags ({i % 5})")
+
+        step = self.days * 86400000 // self.rowsPerTbl
+        for i in range(self.ctbNum):
+            for j in range(0, self.rowsPerTbl, 500):
+                values = " ".join(f"({self.startTs + k * step + i}, {k % 1000 - 500}, {i * 100000 + k}, 'v{k % 37}', {k * 0.5})"
+                                  for k in range(j, j + 500))
+                tdSql.execute(f"insert into {dbName}.ctb{i} values {values}")
+        tdSql.execute(f"flush database {dbName}")
+
+        # rows in the memtable as well, over the file data
+        for i in range(0, self.ctbNum, 3):
+            tdSql.execute(f"insert into {dbName}.ctb{i} values ({self.startTs + self.days * 86400000}, 1, 2, 'mem', 0.25)")
+
+    def queries(self, dbName):
+        return [
+            # hash aggregates, the parallel scan applies
+            (f"select count(*), sum(c1), min(c2), max(c2), spread(c1) from {dbName}.stb", False),
+            (f"select count(c3), avg(c1) from {dbName}.stb where c1 > 0", False),
+            (f"select tbname, count(*), sum(c2), max(c1) from {dbName}.stb partition by tbname", True),
+            (f"select t1, count(*), sum(c1), min(c1) from {dbName}.stb group by t1", True),
+            (f"select c3, count(*), sum(c2) from {dbName}.stb group by c3", True),
+            (f"select c1 % 7, count(*) from {dbName}.stb where ts >= {self.startTs + 86400000 * 3} group by c1 % 7", True),
+            (f"select count(*), sum(c1) from {dbName}.ctb7", False),
+            # ordered output
+            (f"select tbname, count(*) from {dbName}.stb partition by tbname order by tbname", False),
+            (f"select c3, sum(c1) from {dbName}.stb group by c3 order by c3 desc", False),
+            (f"select * from {dbName}.ctb3 order by ts desc", False),
+            (f"select ts, c1, c3 from {dbName}.stb where c1 = 7 order by ts, c2", False),
+            # last and last_row
+            (f"select last(c1), last(c3), last_row(c2) from {dbName}.stb", False),
+            (f"select first(ts), first(c2), last(ts) from {dbName}.stb", False),
+            (f"select tbname, last(c2), last_row(c4) from {dbName}.stb partition by tbname order by tbname", False),
+            # limit
+            (f"select ts, c2 from {dbName}.stb order by ts limit 50 offset 10", False),
+            (f"select count(*) from {dbName}.stb partition by tbname order by count(*), tbname limit 5", False),
+            (f"select c1 from {dbName}.ctb5 limit 20", False),
+            # interval
+            (f"select _wstart, count(*), sum(c1), max(c2) from {dbName}.stb interval(1d)", False),
+            (f"select _wstart, count(*), last(c1) from {dbName}.stb partition by t1 interval(3d) order by t1, _wstart", False),
+            (f"select _wstart, avg(c1) from {dbName}.ctb11 interval(12h) sliding(6h)", False),
+        ]
+
+    def runQueries(self, dbName, parallelScan):
+        tdSql.execute(f"alter local 'queryParallelScan' '{parallelScan}'")
+        results = []
+        for sql, unordered in self.queries(dbName):
+            tdSql.query(sql)
+            rows = [tuple(r) for r in tdSql.queryResult]
+            results.append(sorted(rows) if unordered else rows)
+        return results
+
+    def run(self):
+        dbName = "pscan"
+        self.prepareData(dbName)
+
+        serial = self.runQueries(dbName, 0)
+        for parallelScan in [2, 4, 16]:
+            parallel = self.runQueries(dbName, parallelScan)
+            for (sql, _), s, p in zip(self.queries(dbName), serial, parallel):
+                if s != p:
+                    diff = [(i, a, b) for i, (a, b) in enumerate(zip(s, p)) if a != b][:1]
+                    tdLog.exit(f"queryParallelScan {parallelScan}: {len(p)} rows of {sql}, serially {len(s)} rows, "
+                               f"first diff (row, serial, parallel): {diff}")
+            tdLog.info(f"queryParallelScan {parallelScan}: {len(serial)} queries return the same results as serially")
+
+        tdSql.query(f"select count(*) from {dbName}.stb")
+        tdSql.checkData(0, 0, self.ctbNum * self.rowsPerTbl + (self.ctbNum + 2) // 3)
+
+        tdSql.execute("alter local 'queryParallelScan' '0'")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
@@ -0,0 +1,138 @@
+from util.log import *
+from util.sql import *
+from util.cases import *
+
+# The reader skips the stt blocks whose column zone maps rule out the filter of the scan. Put the rows of small tables
+# in stt files, and check the rows of filtered scans against the rows written, for blocks skipped and not, in both
+# orders. Then rewrite rows, so that the same keys are in the data file, several stt files and the buffer with values
+# on either side of the filters, where no block holding a key of the table elsewhere may be skipped.
+class TDTestCase:
+    ctbNum  = 80
+    rowNum  = 50
+    bigNum  = 600
+    startTs = 1640966400000
+
+    conds = [
+        ("v between 5000 and 5049", lambda v, f, s: v is not None and 5000 <= v <= 5049),
+        ("v < 0", lambda v, f, s: v is not None and v < 0),
+        ("v >= 0", lambda v, f, s: v is not None and v >= 0),
+        ("v >= 30000 and f <= 15010", lambda v, f, s: v is not None and v >= 30000 and f <= 15010),
+        ("v is null", lambda v, f, s: v is None),
+        ("v is not null and v < 3000", lambda v, f, s: v is not None and v < 3000),
+        ("v = 42042", lambda v, f, s: v == 42042),
+        ("v < 1000 or v > 1000590", lambda v, f, s: v is not None and (v < 1000 or v > 1000590)),
+        ("s = 's1' and v > 60000", lambda v, f, s: s == "s1" and v is not None and v > 60000),
+    ]
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor())
+
+    def sqlValue(self, val):
+        if val is None:
+            return "NULL"
+        if isinstance(val, str):
+            return f"'{val}'"
+        return str(val)
+
+    def write(self, dbName, tbName, rows):
+        # rows: {ts offset: v}, f and s follow v
+        values = []
+        for off, v in sorted(rows.items()):
+            f = None if v is None else v / 2
+            s = "s" + str(abs(v) % 4) if v is not None else None
+            self.expected.setdefault(tbName, {})[off] = (v, f, s)
+            values.append(f"({self.startTs + off}, {self.sqlValue(v)}, {self.sqlValue(f)}, {self.sqlValue(s)})")
+        for i in range(0, len(values), 500):
+            tdSql.execute(f"insert into {dbName}.{tbName} values " + " ".join(values[i:i + 500]))
+
+    def expectedRows(self, pred, tbName=None):
+        res = []
+        for tb, rows in self.expected.items():
+            if tbName is not None and tb != tbName:
+                continue
+            for off, (v, f, s) in rows.items():
+                if pred(v, f, s):
+                    res.append((tb, self.startTs + off, v))
+        return sorted(res)
+
+    def checkCond(self, dbName, cond, pred):
+        tdSql.query(f"select tbname, cast(ts as bigint), v from {dbName}.stb where {cond}")
+        res = sorted(tuple(row) for row in tdSql.queryResult)
+        expected = self.expectedRows(pred)
+        if res != expected:
+            tdLog.exit(f"{dbName} where {cond}: {len(res)} rows, expected {len(expected)} rows, "
+                       f"first difference {[r for r in res if r not in expected][:3]} / "
+                       f"{[r for r in expected if r not in res][:3]}")
+
+        tdSql.query(f"select count(*) from {dbName}.stb where {cond}")
+        count = tdSql.queryResult[0][0] if tdSql.queryRows > 0 else 0
+        if count != len(expected):
+            tdLog.exit(f"{dbName} count where {cond}: {count}, expected {len(expected)}")
+
+        # a single table in either order, the stt blocks gone through backward in descending order
+        for tbName in ("ctb3", "ctb5", "ctb7", "ctb9", "ctb42", "big"):
+            expected = [(ts, v) for _, ts, v in self.expectedRows(pred, tbName)]
+            for order in ("asc", "desc"):
+                tdSql.query(f"select cast(ts as bigint), v from {dbName}.{tbName} where {cond} order by ts {order}")
+                res = [tuple(row) for row in tdSql.queryResult]
+                exp = expected if order == "asc" else expected[::-1]
+                if res != exp:
+                    tdLog.exit(f"{dbName}.{tbName} where {cond} order by ts {order}: {len(res)} rows, "
+                               f"expected {len(exp)} rows")
+
+    def check(self, dbName, step):
+        for cond, pred in self.conds:
+            self.checkCond(dbName, cond, pred)
+        tdLog.info(f"{dbName} {step}: {len(self.conds)} filters checked")
+
+    def runWithSttTrigger(self, sttTrigger):
+        dbName = f"sttflt{sttTrigger}"
+        self.expected = {}
+        tdSql.execute(f"drop database if exists {dbName}")
+        # the rows of a table fewer than minrows go to the stt files, in blocks of at most maxrows rows of several tables
+        tdSql.execute(f"create database {dbName} vgroups 1 minrows 100 maxrows 200 stt_trigger {sttTrigger}")
+        tdSql.execute(f"create stable {dbName}.stb (ts timestamp, v bigint, f double, s binary(8)) tags (t1 int)")
+        for tb in range(self.ctbNum):
+            tdSql.execute(f"create table {dbName}.ctb{tb} using {dbName}.stb tags ({tb})")
+        tdSql.execute(f"create table {dbName}.big using {dbName}.stb tags ({self.ctbNum})")
+
+        # the zone maps of the stt blocks hardly overlap, each filter rules out most of them
+        for tb in range(self.ctbNum):
+            self.write(dbName, f"ctb{tb}", {i: None if tb % 3 == 0 and i % 17 == 5 else tb * 1000 + i
+                                            for i in range(self.rowNum)})
+        self.write(dbName, "big", {i: 1000000 + i for i in range(self.bigNum)})
+        tdSql.execute(f"flush database {dbName}")
+        self.check(dbName, "stt files")
+
+        # the same keys in the data file and a stt file, or in two stt files, the new values on the other side of
+        # the filters
+        self.write(dbName, "big", {i: i for i in range(100, 120)})
+        self.write(dbName, "ctb3", {i: -1 - i for i in range(10, 20)})
+        self.write(dbName, "ctb5", {i: 42042 if i == 7 else 5000 + i + 100 for i in range(0, 50, 2)})
+        tdSql.execute(f"flush database {dbName}")
+        self.check(dbName, "rewritten keys in stt files")
+
+        # and in the buffer
+        self.write(dbName, "ctb7", {i: 99999900 + i for i in range(10)})
+        self.write(dbName, "ctb9", {i: None for i in range(20, 30)})
+        self.write(dbName, "ctb42", {i: 5000 + i for i in range(0, 50, 5)})
+        self.write(dbName, "ctb42", {i: 42000 + i for i in range(50, 55)})
+        self.write(dbName, "big", {i: 7 for i in range(300, 310)})
+        self.check(dbName, "rewritten keys in the buffer")
+
+        tdSql.execute(f"flush database {dbName}")
+        self.check(dbName, "flushed")
+
+    def run(self):
+        # every flush merges the stt file, or adds one to the file set
+        self.runWithSttTrigger(1)
+        self.runWithSttTrigger(4)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
@@ -0,0 +1,145 @@
+import taos
+import sys
+import time
+import threading
+from taos.tmq import Consumer
+
+from util.log import *
+from util.sql import *
+from util.cases import *
+from util.dnodes import *
+
+# The subscriptions of a vnode share the submit msgs they decode through the decode cache. Consume the same data
+# with the cache off and on, by several consumer groups at once, and check that every consumer gets the same rows.
+class TDTestCase:
+    ctbNum     = 10
+    rowsPerTbl = 2000
+    batchNum   = 100
+    consumers  = 3
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor())
+
+    def restartWithCacheSize(self, size):
+        tdDnodes.stop(1)
+        tdDnodes.cfg(1, "tqDecodeCacheSize", size)
+        tdDnodes.start(1)
+        time.sleep(2)
+
+    def prepareData(self, dbName):
+        tdSql.execute(f"drop database if exists {dbName}")
+        tdSql.execute(f"create database {dbName} vgroups 1 wal_retention_period 3600")
+        tdSql.execute(f"create stable {dbName}.stb (ts timestamp, c1 int, c2 bigint, c3 binary(16)) tags (t1 int)")
+        for i in range(self.ctbNum):
+            tdSql.execute(f"create table {dbName}.ctb{i} using {dbName}.stb tags ({i})")
+
+        startTs = 1640966400000
+        for i in range(self.ctbNum):
+            for j in range(0, self.rowsPerTbl, self.batchNum):
+                values = " ".join(f"({startTs + k}, {i * 100000 + k}, {k * k}, 'v{k % 97}')"
+                                  for k in range(j, j + self.batchNum))
+                tdSql.execute(f"insert into {dbName}.ctb{i} values {values}")
+
+    def consume(self, groupId, topics, rows):
+        consumer = Consumer(
+            {
+                "group.id": groupId,
+                "td.connect.user": "root",
+                "td.connect.pass": "taosdata",
+                "auto.offset.reset": "earliest",
+                "enable.auto.commit": "true",
+                "experimental.snapshot.enable": "false",
+            }
+        )
+        consumer.subscribe(topics)
+
+        try:
+            emptyPolls = 0
+            while emptyPolls < 5:
+                res = consumer.poll(2)
+                if not res:
+                    emptyPolls += 1
+                    continue
+                err = res.error()
+                if err is not None:
+                    raise err
+                emptyPolls = 0
+                topic = res.topic()
+                for block in res.value():
+                    for row in block.fetchall():
+                        rows[topic].append(tuple(row))
+        finally:
+            consumer.unsubscribe()
+            consumer.close()
+
+    # returns the sorted rows of each topic, one list per consumer
+    def consumeAll(self, dbName):
+        colTopic = f"{dbName}_col"
+        stbTopic = f"{dbName}_stb"
+        tdSql.execute(f"create topic {colTopic} as select ts, c1, c2, c3 from {dbName}.stb where c1 % 3 != 1")
+        tdSql.execute(f"create topic {stbTopic} as stable {dbName}.stb")
+
+        results = []
+        threads = []
+        for i in range(self.consumers):
+            rows = {colTopic: [], stbTopic: []}
+            results.append(rows)
+            t = threading.Thread(target=self.consume, args=(f"{dbName}_g{i}", [colTopic, stbTopic], rows))
+            threads.append(t)
+            t.start()
+        for t in threads:
+            t.join()
+
+        tdSql.execute(f"drop topic {colTopic}")
+        tdSql.execute(f"drop topic {stbTopic}")
+        return [{"col": sorted(r[colTopic]), "stb": sorted(r[stbTopic])} for r in results]
+
+    def decodeCacheStats(self, dbName):
+        # the vnode load reaches the mnode with the next status msg
+        time.sleep(3)
+        tdSql.query(f"select decodecachehit, decodecachemiss from information_schema.ins_vgroups where db_name = '{dbName}'")
+        tdSql.checkRows(1)
+        return tdSql.queryResult[0][0], tdSql.queryResult[0][1]
+
+    def checkRun(self, cacheSize):
+        dbName = f"dc{cacheSize}"
+        self.restartWithCacheSize(cacheSize)
+        self.prepareData(dbName)
+        results = self.consumeAll(dbName)
+
+        tdSql.query(f"select ts, c1, c2, c3 from {dbName}.stb where c1 % 3 != 1")
+        expectCol = sorted(tuple(r) for r in tdSql.queryResult)
+        tdSql.query(f"select count(*) from {dbName}.stb")
+        expectStb = tdSql.queryResult[0][0]
+
+        for i, r in enumerate(results):
+            if r["col"] != expectCol:
+                tdLog.exit(f"cache size {cacheSize}, consumer {i}: {len(r['col'])} rows from the column topic, expect {len(expectCol)}")
+            if len(r["stb"]) != expectStb:
+                tdLog.exit(f"cache size {cacheSize}, consumer {i}: {len(r['stb'])} rows from the stable topic, expect {expectStb}")
+            if r != results[0]:
+                tdLog.exit(f"cache size {cacheSize}, consumer {i} got other rows than consumer 0")
+
+        hit, miss = self.decodeCacheStats(dbName)
+        tdLog.info(f"cache size {cacheSize}, decode cache hit:{hit} miss:{miss}")
+        if cacheSize == 0 and (hit != 0 or miss != 0):
+            tdLog.exit(f"decode cache disabled, but hit:{hit} miss:{miss}")
+        if cacheSize > 0 and miss == 0:
+            tdLog.exit(f"decode cache of {cacheSize}MB not used by {self.consumers} consumers")
+
+        return results[0]
+
+    def run(self):
+        withoutCache = self.checkRun(0)
+        withCache = self.checkRun(16)
+        if withoutCache != withCache:
+            tdLog.exit("consumed other rows with the decode cache than without it")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())